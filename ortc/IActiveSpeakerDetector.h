@@ -0,0 +1,160 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/types.h>
+#include <ortc/IRTPTypes.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetectorTypes
+  #pragma mark
+  
+  interaction IActiveSpeakerDetectorTypes : public IRTPTypes
+  {
+    ZS_DECLARE_STRUCT_PTR(Speaker)
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IActiveSpeakerDetectorTypes::Speaker
+    #pragma mark
+
+    struct Speaker
+    {
+      IRTPReceiverPtr mReceiver;
+      SSRCType        mSSRC {};
+      BYTE            mAudioLevel {127};      // smoothed level in -dBov (0 = loudest, 127 = silence)
+
+      Speaker() {}
+      Speaker(const Speaker &op2) {(*this) = op2;}
+
+      ElementPtr toDebug() const;
+    };
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetector
+  #pragma mark
+
+  interaction IActiveSpeakerDetector : public IActiveSpeakerDetectorTypes
+  {
+    static ElementPtr toDebug(IActiveSpeakerDetectorPtr detector);
+
+    //-------------------------------------------------------------------------
+    // PURPOSE: track which remote audio stream is the dominant speaker using
+    //          the RFC 6464 client-to-mixer audio level header extension
+    //          carried in received RTP packets (no audio decoding is needed).
+    // NOTES:   Audio receivers must negotiate the
+    //          "urn:ietf:params:rtp-hdrext:ssrc-audio-level" header extension
+    //          in their receive() parameters for levels to be reported.
+    static IActiveSpeakerDetectorPtr create(IActiveSpeakerDetectorDelegatePtr delegate);
+
+    virtual PUID getID() const = 0;
+
+    virtual IActiveSpeakerDetectorSubscriptionPtr subscribe(IActiveSpeakerDetectorDelegatePtr delegate) = 0;
+
+    //-------------------------------------------------------------------------
+    // PURPOSE: monitor the audio levels of all streams received by an audio
+    //          receiver
+    // THROWS:  InvalidParameters - if the receiver is null or not an audio
+    //                              receiver
+    //          InvalidStateError - if the detector is stopped
+    virtual void addReceiver(IRTPReceiverPtr receiver) throw (
+                                                              InvalidParameters,
+                                                              InvalidStateError
+                                                              ) = 0;
+
+    virtual void removeReceiver(IRTPReceiverPtr receiver) = 0;
+
+    // returns null if no stream has been detected as speaking yet
+    virtual SpeakerPtr getDominantSpeaker() const = 0;
+
+    virtual void stop() = 0;
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetectorDelegate
+  #pragma mark
+
+  interaction IActiveSpeakerDetectorDelegate
+  {
+    // speaker is null when the previous dominant speaker's stream went away
+    // and no other stream is speaking
+    virtual void onActiveSpeakerDetectorDominantSpeakerChanged(
+                                                               IActiveSpeakerDetectorPtr detector,
+                                                               IActiveSpeakerDetectorTypes::SpeakerPtr speaker
+                                                               ) = 0;
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetectorSubscription
+  #pragma mark
+
+  interaction IActiveSpeakerDetectorSubscription
+  {
+    virtual PUID getID() const = 0;
+
+    virtual void cancel() = 0;
+
+    virtual void background() = 0;
+  };
+}
+
+
+ZS_DECLARE_PROXY_BEGIN(ortc::IActiveSpeakerDetectorDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IActiveSpeakerDetectorPtr, IActiveSpeakerDetectorPtr)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IActiveSpeakerDetectorTypes::SpeakerPtr, SpeakerPtr)
+ZS_DECLARE_PROXY_METHOD_2(onActiveSpeakerDetectorDominantSpeakerChanged, IActiveSpeakerDetectorPtr, SpeakerPtr)
+ZS_DECLARE_PROXY_END()
+
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_BEGIN(ortc::IActiveSpeakerDetectorDelegate, ortc::IActiveSpeakerDetectorSubscription)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_TYPEDEF(ortc::IActiveSpeakerDetectorPtr, IActiveSpeakerDetectorPtr)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_TYPEDEF(ortc::IActiveSpeakerDetectorTypes::SpeakerPtr, SpeakerPtr)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_METHOD_2(onActiveSpeakerDetectorDominantSpeakerChanged, IActiveSpeakerDetectorPtr, SpeakerPtr)
+ZS_DECLARE_PROXY_SUBSCRIPTIONS_END()
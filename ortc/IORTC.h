@@ -32,6 +32,7 @@
 #pragma once
 
 #include <ortc/types.h>
+#include <ortc/IStatsProvider.h>
 
 namespace ortc
 {
@@ -68,6 +69,10 @@ namespace ortc
     static bool saveMediaTrace(String host, int port);
     static bool isMRPInstalled();
 
+    // process wide stats (e.g. IStatsReportTypes::StatsType_MessageQueue or
+    // StatsType_MediaChannel) which do not belong to any one stats provider
+    static IStatsProvider::PromiseWithStatsReportPtr getStats(const IStatsProvider::StatsTypeSet &stats);
+
     virtual ~IORTC() {} // make polymorphic
   };
 }
@@ -0,0 +1,92 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/types.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPCapture
+  #pragma mark
+
+  interaction IRTPCapture
+  {
+    enum Formats
+    {
+      Format_First,
+
+      Format_RTPDump = Format_First,  // rtptools "#!rtpplay1.0" format
+      Format_PCAPNG,                  // pcapng with synthesized IPv4/UDP headers
+
+      Format_Last = Format_PCAPNG,
+    };
+
+    static const char *toString(Formats format);
+    static Formats toFormat(const char *format) throw (InvalidParameters);
+
+    enum Directions
+    {
+      Direction_First,
+
+      Direction_Incoming = Direction_First,
+      Direction_Outgoing,
+      Direction_Both,
+
+      Direction_Last = Direction_Both,
+    };
+
+    static const char *toString(Directions direction);
+    static Directions toDirection(const char *direction) throw (InvalidParameters);
+
+    //-------------------------------------------------------------------------
+    // PURPOSE: dump the decrypted RTP/RTCP packets currently held in the
+    //          capture ring of an RTP transport (i.e. an IDTLSTransport or an
+    //          ISRTPSDESTransport).
+    // NOTES:   Capturing is opt-in and is enabled by setting
+    //          "ortc/srtp/capture-buffer-size-in-bytes" to a non zero value
+    //          before the transport is created. Only the RTP headers and
+    //          the first "ortc/srtp/capture-rtp-payload-bytes" of each RTP
+    //          payload are kept.
+    // RETURNS: the captured packets (oldest first) in the requested format
+    //          or null if the transport is not capturing.
+    static SecureByteBlockPtr dump(
+                                   IRTPTransportPtr transport,
+                                   Formats format,
+                                   Directions direction = Direction_Both
+                                   );
+  };
+}
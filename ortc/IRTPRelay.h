@@ -0,0 +1,114 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/types.h>
+#include <ortc/IRTPTypes.h>
+
+namespace ortc
+{
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPRelayTypes
+  #pragma mark
+  
+  interaction IRTPRelayTypes : public IRTPTypes
+  {
+    ZS_DECLARE_STRUCT_PTR(Options)
+
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayTypes::Options
+    #pragma mark
+
+    struct Options
+    {
+      EncodingID      mEncodingID;            // receiver encoding to forward (empty = first encoding)
+      Optional<BYTE>  mMaxTemporalLayerID;    // drop temporal layers above this id (when the codec exposes it)
+      bool            mRequestKeyFrameOnSwitch {true};
+
+      Options() {}
+      Options(const Options &op2) {(*this) = op2;}
+
+      ElementPtr toDebug() const;
+      String hash() const;
+    };
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPRelay
+  #pragma mark
+
+  interaction IRTPRelay : public IRTPRelayTypes
+  {
+    static ElementPtr toDebug(IRTPRelayPtr relay);
+
+    //-------------------------------------------------------------------------
+    // PURPOSE: forward the RTP packets received by an RTPReceiver (after
+    //          listener routing and SRTP decryption) to one or more
+    //          RTPSenders without decoding the media.
+    // NOTES:   Senders should be created without a media stream track and
+    //          must have their send() parameters set with an SSRC for the
+    //          forwarded stream. SSRC, sequence number, timestamp, payload
+    //          type and header extension identifiers are rewritten to match
+    //          each sender's parameters.
+    static IRTPRelayPtr create(IRTPReceiverPtr receiver);
+
+    virtual PUID getID() const = 0;
+
+    virtual IRTPReceiverPtr receiver() const = 0;
+
+    //-------------------------------------------------------------------------
+    // PURPOSE: add a sender to the relay (or change the options of a sender
+    //          already being relayed to, e.g. to switch simulcast layer)
+    // THROWS:  InvalidParameters - if the sender is null
+    //          InvalidStateError - if the relay is stopped
+    virtual void addSender(
+                           IRTPSenderPtr sender,
+                           const Options &options = Options()
+                           ) throw (
+                                    InvalidParameters,
+                                    InvalidStateError
+                                    ) = 0;
+
+    virtual void removeSender(IRTPSenderPtr sender) = 0;
+
+    virtual void stop() = 0;
+  };
+}
@@ -34,7 +34,9 @@
 #include <ortc/types.h>
 #include <ortc/IStatsReport.h>
 
+#include <map>
 #include <set>
+#include <vector>
 
 namespace ortc
 {
@@ -50,6 +52,60 @@ namespace ortc
   {
     ZS_DECLARE_TYPEDEF_PTR(PromiseWith<IStatsReport>, PromiseWithStatsReport);
     ZS_DECLARE_TYPEDEF_PTR(IStatsReport::StatsTypeSet, StatsTypeSet);
+
+    typedef IStatsReportTypes::StatsTypes StatsTypes;
+    typedef std::map<StatsTypes, Milliseconds> SamplingIntervalMap;
+
+    ZS_DECLARE_STRUCT_PTR(StatsDelta);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsProviderTypes::StatsDelta
+    #pragma mark
+
+    // A flat list of the numeric counters which changed since the previous
+    // delta. Each counter (i.e. a stat id + counter name pair) is assigned a
+    // compact key which is described exactly once in "new counters" the first
+    // time the counter is reported; afterwards only the key and value are
+    // delivered.
+    struct StatsDelta
+    {
+      typedef DWORD CounterKey;
+
+      struct CounterInfo
+      {
+        CounterKey            mKey {};
+        Optional<StatsTypes>  mStatsType;
+        String                mStatID;
+        String                mCounterName;
+
+        ElementPtr toDebug() const;
+      };
+
+      struct Counter
+      {
+        CounterKey  mKey {};
+        double      mValue {};
+      };
+
+      typedef std::vector<CounterInfo> CounterInfoList;
+      typedef std::vector<Counter> CounterList;
+      typedef std::vector<CounterKey> CounterKeyList;
+
+      Time            mTimestamp;
+      DWORD           mSequenceNumber {};
+
+      CounterInfoList mNewCounters;
+      CounterList     mChangedCounters;
+      CounterKeyList  mRemovedCounters;
+
+      bool isEmpty() const { return (mNewCounters.size() < 1) && (mChangedCounters.size() < 1) && (mRemovedCounters.size() < 1); }
+
+      ElementPtr toDebug() const;
+    };
   };
 
   //---------------------------------------------------------------------------
@@ -65,4 +121,59 @@ namespace ortc
     virtual PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats = StatsTypeSet()) const = 0;
   };
 
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsSubscription
+  #pragma mark
+
+  interaction IStatsSubscription : public IStatsProviderTypes
+  {
+    static ElementPtr toDebug(IStatsSubscriptionPtr subscription);
+
+    // Periodically samples the provider and delivers only the counters which
+    // changed since the previous sample. Stats types not present in the
+    // interval map are not sampled; an empty map samples every stats type at
+    // the default interval.
+    static IStatsSubscriptionPtr create(
+                                        IStatsSubscriptionDelegatePtr delegate,
+                                        IStatsProviderPtr provider,
+                                        const SamplingIntervalMap &intervals = SamplingIntervalMap()
+                                        );
+
+    virtual PUID getID() const = 0;
+
+    // Milliseconds() stops sampling the stats type.
+    virtual void setSamplingInterval(
+                                     StatsTypes statsType,
+                                     Milliseconds interval
+                                     ) = 0;
+
+    virtual void cancel() = 0;
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsSubscriptionDelegate
+  #pragma mark
+
+  interaction IStatsSubscriptionDelegate
+  {
+    virtual void onStatsSubscriptionDelta(
+                                          IStatsSubscriptionPtr subscription,
+                                          IStatsProviderTypes::StatsDeltaPtr delta
+                                          ) = 0;
+  };
+
 }
+
+ZS_DECLARE_PROXY_BEGIN(ortc::IStatsSubscriptionDelegate)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IStatsSubscriptionPtr, IStatsSubscriptionPtr)
+ZS_DECLARE_PROXY_TYPEDEF(ortc::IStatsProviderTypes::StatsDeltaPtr, StatsDeltaPtr)
+ZS_DECLARE_PROXY_METHOD_2(onStatsSubscriptionDelta, IStatsSubscriptionPtr, StatsDeltaPtr)
+ZS_DECLARE_PROXY_END()
@@ -53,6 +53,8 @@ namespace ortc
     typedef IRTPTypes::PayloadType PayloadType;
     typedef IICETypes::CandidateTypes StatsICECandidateTypes;
     typedef std::list<String> StringList;
+    typedef std::pair<const char *, double> FlatCounter;
+    typedef std::vector<FlatCounter> FlatCounterList;
 
     ZS_DECLARE_STRUCT_PTR(StatsTypeSet);
 
@@ -72,6 +74,9 @@ namespace ortc
     ZS_DECLARE_STRUCT_PTR(ICECandidateAttributes);
     ZS_DECLARE_STRUCT_PTR(ICECandidatePairStats);
     ZS_DECLARE_STRUCT_PTR(CertificateStats);
+    ZS_DECLARE_STRUCT_PTR(PacketPipelineStats);
+    ZS_DECLARE_STRUCT_PTR(MessageQueueStats);
+    ZS_DECLARE_STRUCT_PTR(MediaChannelStats);
     ZS_DECLARE_TYPEDEF_PTR(std::list<String>, IDList);
 
     //-------------------------------------------------------------------------
@@ -102,8 +107,11 @@ namespace ortc
       StatsType_CandidatePair,
       StatsType_LocalCandidate,
       StatsType_RemoteCandidate,
+      StatsType_PacketPipeline,
+      StatsType_MessageQueue,
+      StatsType_MediaChannel,
 
-      StatsType_Last = StatsType_RemoteCandidate
+      StatsType_Last = StatsType_MediaChannel
     };
 
     static Optional<StatsTypes> toStatsType(const char *type);
@@ -132,6 +140,27 @@ namespace ortc
     static Optional<StatsICECandidatePairStates> toCandidatePairState(const char *type);
     static const char *toString(StatsICECandidatePairStates type);
 
+    // each hop measures the time from the previous hop being reached (or
+    // from the socket read for the first hop) until the named stage is
+    // entered; the two queue hops measure enqueue to dequeue
+    enum PacketPipelineHops
+    {
+      PacketPipelineHop_First,
+
+      PacketPipelineHop_ICEGatherer = PacketPipelineHop_First,  // socket read -> ICE transport
+      PacketPipelineHop_ICETransport,                           // ICE transport -> DTLS transport
+      PacketPipelineHop_DTLSTransport,                          // DTLS transport -> SRTP transport
+      PacketPipelineHop_SRTPTransport,                          // SRTP transport (decrypt) -> RTP listener
+      PacketPipelineHop_RTPListener,                            // RTP listener (parse/route) -> receiver channel
+      PacketPipelineHop_ReceiverChannelQueue,                   // receiver channel queue
+      PacketPipelineHop_MediaEngineQueue,                       // media engine packet queue
+      PacketPipelineHop_EndToEnd,                               // socket read -> media engine
+
+      PacketPipelineHop_Last = PacketPipelineHop_EndToEnd,
+    };
+
+    static const char *toString(PacketPipelineHops hop);
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -162,6 +191,8 @@ namespace ortc
       virtual ElementPtr toDebug() const;
       virtual String hash() const;
 
+      virtual void flatten(FlatCounterList &outCounters) const {}
+
       virtual void eventTrace() const;
 
       Stats &operator=(const Stats &op2) = delete;
@@ -204,6 +235,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       RTPStreamStats &operator=(const RTPStreamStats &op2) = delete;
 
@@ -239,6 +271,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       Codec &operator=(const Codec &op2) = delete;
 
@@ -275,6 +308,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       InboundRTPStreamStats &operator=(const InboundRTPStreamStats &op2) = delete;
 
@@ -294,6 +328,8 @@ namespace ortc
     {
       unsigned long       mPacketsSent {};
       unsigned long long  mBytesSent {};
+      unsigned long       mRetransmittedPacketsSent {};
+      unsigned long long  mRetransmittedBytesSent {};
       double              mTargetBitrate {};
       double              mRoundTripTime {};
 
@@ -309,6 +345,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       OutboundRTPStreamStats &operator=(const OutboundRTPStreamStats &op2) = delete;
 
@@ -341,6 +378,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       SCTPTransportStats &operator=(const SCTPTransportStats &op2) = delete;
 
@@ -417,6 +455,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       MediaStreamTrackStats &operator=(const MediaStreamStats &op2) = delete;
 
@@ -455,6 +494,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       DataChannelStats &operator=(const DataChannelStats &op2) = delete;
 
@@ -488,6 +528,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       ICEGathererStats &operator=(const ICEGathererStats &op2) = delete;
 
@@ -524,6 +565,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       ICETransportStats &operator=(const ICETransportStats &op2) = delete;
 
@@ -665,6 +707,7 @@ namespace ortc
 
       virtual ElementPtr toDebug() const override;
       virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
 
       ICECandidatePairStats &operator=(const ICECandidatePairStats &op2) = delete;
 
@@ -706,6 +749,145 @@ namespace ortc
       virtual void eventTrace(double timestamp) const override;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsReportTypes::PacketPipelineStats
+    #pragma mark
+
+    struct PacketPipelineStats : public Stats
+    {
+      struct HopLatency
+      {
+        unsigned long long  mCount {};
+        double              mAverage {};  // milliseconds
+        double              mP50 {};      // milliseconds
+        double              mP90 {};      // milliseconds
+        double              mP99 {};      // milliseconds
+        double              mP999 {};     // milliseconds
+        double              mMax {};      // milliseconds
+      };
+
+      HopLatency mHops[PacketPipelineHop_Last + 1];
+
+      PacketPipelineStats() { mStatsType = IStatsReportTypes::StatsType_PacketPipeline; }
+      PacketPipelineStats(const PacketPipelineStats &op2);
+      PacketPipelineStats(ElementPtr rootEl);
+
+      static PacketPipelineStatsPtr create(ElementPtr rootEl);
+
+      static PacketPipelineStatsPtr convert(AnyPtr any);
+
+      virtual ElementPtr createElement(const char *objectName = "packetpipeline") const override;
+
+      virtual ElementPtr toDebug() const override;
+      virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
+
+      PacketPipelineStats &operator=(const PacketPipelineStats &op2) = delete;
+
+    protected:
+      virtual void eventTrace(double timestamp) const override;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsReportTypes::MessageQueueStats
+    #pragma mark
+
+    // one per ORTC message queue (e.g. "ortc", "packet"); queues handed out
+    // as several threads or thread pool strands are reported together
+    struct MessageQueueStats : public Stats
+    {
+      typedef PacketPipelineStats::HopLatency Latency;
+
+      struct MethodUsage
+      {
+        String              mDelegateName;
+        String              mMethodName;
+        unsigned long long  mCount {};
+        double              mTotal {};    // milliseconds
+        double              mAverage {};  // milliseconds
+        double              mMax {};      // milliseconds
+      };
+      typedef std::list<MethodUsage> MethodUsageList;
+
+      String              mQueueName;
+      unsigned long long  mPosted {};
+      unsigned long long  mProcessed {};
+      unsigned long       mCurrentDepth {};
+      unsigned long       mPeakDepth {};
+      Latency             mDwell;         // enqueue to execute
+      MethodUsageList     mTopMethods;    // most total execution time first
+
+      MessageQueueStats() { mStatsType = IStatsReportTypes::StatsType_MessageQueue; }
+      MessageQueueStats(const MessageQueueStats &op2);
+      MessageQueueStats(ElementPtr rootEl);
+
+      static MessageQueueStatsPtr create(ElementPtr rootEl);
+
+      static MessageQueueStatsPtr convert(AnyPtr any);
+
+      virtual ElementPtr createElement(const char *objectName = "messagequeue") const override;
+
+      virtual ElementPtr toDebug() const override;
+      virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
+
+      MessageQueueStats &operator=(const MessageQueueStats &op2) = delete;
+
+    protected:
+      virtual void eventTrace(double timestamp) const override;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsReportTypes::MediaChannelStats
+    #pragma mark
+
+    // process wide media channel setup / shutdown counters; latency is
+    // measured from the request until the channel is ready (or failed, or
+    // shut down) and includes time spent waiting for a media channel thread
+    struct MediaChannelStats : public Stats
+    {
+      typedef PacketPipelineStats::HopLatency Latency;
+
+      unsigned long long  mSetupsRequested {};
+      unsigned long long  mSetupsSucceeded {};
+      unsigned long long  mSetupsFailed {};
+      unsigned long       mSetupsPending {};
+      unsigned long long  mShutdowns {};
+      Latency             mSetupLatency;
+      Latency             mShutdownLatency;
+
+      MediaChannelStats() { mStatsType = IStatsReportTypes::StatsType_MediaChannel; }
+      MediaChannelStats(const MediaChannelStats &op2);
+      MediaChannelStats(ElementPtr rootEl);
+
+      static MediaChannelStatsPtr create(ElementPtr rootEl);
+
+      static MediaChannelStatsPtr convert(AnyPtr any);
+
+      virtual ElementPtr createElement(const char *objectName = "mediachannel") const override;
+
+      virtual ElementPtr toDebug() const override;
+      virtual String hash() const override;
+      virtual void flatten(FlatCounterList &outCounters) const override;
+
+      MediaChannelStats &operator=(const MediaChannelStats &op2) = delete;
+
+    protected:
+      virtual void eventTrace(double timestamp) const override;
+    };
+
   };
   
   //---------------------------------------------------------------------------
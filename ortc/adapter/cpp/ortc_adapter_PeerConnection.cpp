@@ -31,8 +31,10 @@
 
 #include <ortc/adapter/internal/ortc_adapter_PeerConnection.h>
 #include <ortc/adapter/internal/ortc_adapter_MediaStream.h>
+#include <ortc/adapter/internal/ortc_adapter_SessionDescription.h>
 
 #include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_ICEGathererPool.h>
 #include <ortc/internal/ortc_RTPTypes.h>
 
 #include <ortc/IRTPSender.h>
@@ -83,6 +85,9 @@ namespace ortc
         UseServicesHelper::debugAppend(resultEl, "ice gatherer", mGatherer ? mGatherer->getID() : 0);
         UseServicesHelper::debugAppend(resultEl, "ice transort", mTransport ? mTransport->getID() : 0);
         UseServicesHelper::debugAppend(resultEl, "end of candidates", mRTPEndOfCandidates);
+        UseServicesHelper::debugAppend(resultEl, "pooled gatherer", mPooledGatherer);
+        UseServicesHelper::debugAppend(resultEl, "gather started", mGatherStarted);
+        UseServicesHelper::debugAppend(resultEl, "first candidate reported", mFirstCandidateReported);
         UseServicesHelper::debugAppend(resultEl, "dtls transport", mDTLSTransport ? mDTLSTransport->getID() : 0);
         UseServicesHelper::debugAppend(resultEl, "srtp/sdes transport", mSRTPSDESTransport ? mSRTPSDESTransport->getID() : 0);
 
@@ -305,6 +310,21 @@ namespace ortc
         return resultEl;
       }
 
+      //-----------------------------------------------------------------------
+      ElementPtr PeerConnection::RemoteDescriptionDiff::toDebug() const
+      {
+        ElementPtr resultEl = Element::create("ortc::adapter::PeerConnection::RemoteDescriptionDiff");
+
+        UseServicesHelper::debugAppend(resultEl, "transports", mTransports.size());
+        UseServicesHelper::debugAppend(resultEl, "rtp media lines", mRTPMediaLines.size());
+        UseServicesHelper::debugAppend(resultEl, "sctp media lines", mSCTPMediaLines.size());
+        UseServicesHelper::debugAppend(resultEl, "senders", mSenders.size());
+        UseServicesHelper::debugAppend(resultEl, "removed senders", mRemovedSenders.size());
+        UseServicesHelper::debugAppend(resultEl, "total hashed", mTotalHashed);
+
+        return resultEl;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1069,7 +1089,8 @@ namespace ortc
               }
             }
           }
-          if (stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP)) {
+          if ((stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP)) ||
+              (stats.hasStatType(IStatsReportTypes::StatsType_PacketPipeline))) {
             if (info.mReceiver) {
               promises.push_back(info.mReceiver->getStats(stats));
             }
@@ -1082,6 +1103,11 @@ namespace ortc
           }
         }
 
+        if ((stats.hasStatType(IStatsReportTypes::StatsType_MessageQueue)) ||
+            (stats.hasStatType(IStatsReportTypes::StatsType_MediaChannel))) {
+          promises.push_back(IORTC::getStats(stats));
+        }
+
         if (promises.size() < 1) {
           promise->resolve(UseStatsReport::create(UseStatsReport::StatMap()));
           return;
@@ -1124,6 +1150,8 @@ namespace ortc
 
         AutoRecursiveLock lock(*this);
 
+        notifyFirstCandidate(gatherer);
+
         for (auto iter = mTransports.begin(); iter != mTransports.end(); ++iter) {
           auto &transportInfo = (*iter).second;
           if ((transportInfo->mRTP.mGatherer) &&
@@ -1620,6 +1648,7 @@ namespace ortc
         UseServicesHelper::debugAppend(resultEl, "pending remote candidates", mPendingRemoteCandidates.size());
 
         UseServicesHelper::debugAppend(resultEl, "pending transport pool", mTransportPool.size());
+        UseServicesHelper::debugAppend(resultEl, "pending first candidates", mPendingFirstCandidates.size());
 
         UseServicesHelper::debugAppend(resultEl, "existing ids", mExistingIDs.size());
 
@@ -1725,6 +1754,7 @@ namespace ortc
 
         mRemoteDescription.reset();
         mPendingRemoteDescription.reset();
+        mRemoteHashes = RemoteDescriptionHashes();
 
         mPendingMethods.clear();
         mAddedPendingAddTracks.clear();
@@ -1742,6 +1772,7 @@ namespace ortc
         mPendingRemoteCandidates.clear();
 
         mTransportPool.clear();
+        mPendingFirstCandidates.clear();
 
         mExistingIDs.clear();
 
@@ -1943,16 +1974,30 @@ namespace ortc
           case IPeerConnectionTypes::SignalingState_Closed:               break;  // will not happen
         }
 
+        // only what was added, removed or changed since the last applied
+        // remote description is processed (hashed before processing as the
+        // steps adjust the description, e.g. the DTLS role)
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        {
+          auto sessionDescription = SessionDescription::convert(pending->mSessionDescription);
+          calculateRemoteDiff(*description, sessionDescription ? sessionDescription->sdp() : ISDPTypes::SDPPtr(), mRemoteHashes, hashes, diff);
+        }
+
+        ZS_LOG_DEBUG(log("remote description changes") + diff.toDebug());
+
         bool result = true;
 
-        result = stepProcessRemoteTransport(description) && (result);
-        result = stepProcessRemoteRTPMediaLines(description) && (result);
-        result = stepProcessRemoteRTPSenders(description) && (result);
-        result = stepProcessRemoteSCTPTransport(description) && (result);
+        result = stepProcessRemoteTransport(description, diff) && (result);
+        result = stepProcessRemoteRTPMediaLines(description, diff) && (result);
+        result = stepProcessRemoteRTPSenders(description, diff) && (result);
+        result = stepProcessRemoteSCTPTransport(description, diff) && (result);
+        result = stepProcessRemoteRemovedSenders(diff) && (result);
 
         ZS_LOG_DETAIL(log("processed remote description") + pending->toDebug());
 
         mRemoteDescription = pending->mSessionDescription;
+        mRemoteHashes = hashes;
         flushRemotePending(pending->mSessionDescription);
         setState(nextSignalingState);
 
@@ -1967,13 +2012,26 @@ namespace ortc
       }
 
       //-----------------------------------------------------------------------
-      bool PeerConnection::stepProcessRemoteTransport(ISessionDescriptionTypes::DescriptionPtr description)
+      bool PeerConnection::stepProcessRemoteTransport(
+                                                      ISessionDescriptionTypes::DescriptionPtr description,
+                                                      RemoteDescriptionDiff &ioDiff
+                                                      )
       {
         for (auto iter = description->mTransports.begin(); iter != description->mTransports.end(); ++iter) {
           auto &transport = *(*iter);
 
           TransportInfoPtr transportInfo;
 
+          if (ioDiff.mTransports.end() == ioDiff.mTransports.find(transport.mID)) {
+            auto found = mTransports.find(transport.mID);
+            if ((found != mTransports.end()) &&
+                (isSettled(*((*found).second)))) {
+              ZS_LOG_TRACE(log("remote transport is unchanged") + ZS_PARAM("transport id", transport.mID));
+              continue;
+            }
+            ioDiff.mTransports.insert(transport.mID);
+          }
+
           {
             // find the transport
             {
@@ -2197,7 +2255,10 @@ namespace ortc
       }
 
       //-----------------------------------------------------------------------
-      bool PeerConnection::stepProcessRemoteRTPMediaLines(ISessionDescriptionTypes::DescriptionPtr description)
+      bool PeerConnection::stepProcessRemoteRTPMediaLines(
+                                                          ISessionDescriptionTypes::DescriptionPtr description,
+                                                          RemoteDescriptionDiff &ioDiff
+                                                          )
       {
         for (auto iter = description->mRTPMediaLines.begin(); iter != description->mRTPMediaLines.end(); ++iter)
         {
@@ -2205,6 +2266,22 @@ namespace ortc
 
           RTPMediaLineInfoPtr mediaLineInfo;
 
+          if ((mediaLine.mID.hasData()) &&
+              (ioDiff.mRTPMediaLines.end() == ioDiff.mRTPMediaLines.find(mediaLine.mID))) {
+            String privateTransportID = mediaLine.mDetails ? mediaLine.mDetails->mPrivateTransportID : String();
+            bool transportChanged = (ioDiff.mTransports.end() != ioDiff.mTransports.find(mediaLine.mTransportID)) ||
+                                    ((privateTransportID.hasData()) && (ioDiff.mTransports.end() != ioDiff.mTransports.find(privateTransportID)));
+
+            auto found = mRTPMedias.find(mediaLine.mID);
+            if ((!transportChanged) &&
+                (found != mRTPMedias.end()) &&
+                (isSettled(*((*found).second)))) {
+              ZS_LOG_TRACE(log("remote rtp media line is unchanged") + ZS_PARAM("media line id", mediaLine.mID));
+              continue;
+            }
+            ioDiff.mRTPMediaLines.insert(mediaLine.mID);
+          }
+
           // scope prepare media line
           {
             // scope: find the media line
@@ -2311,7 +2388,10 @@ namespace ortc
       }
 
       //-----------------------------------------------------------------------
-      bool PeerConnection::stepProcessRemoteRTPSenders(ISessionDescriptionTypes::DescriptionPtr description)
+      bool PeerConnection::stepProcessRemoteRTPSenders(
+                                                       ISessionDescriptionTypes::DescriptionPtr description,
+                                                       RemoteDescriptionDiff &ioDiff
+                                                       )
       {
         for (auto iter = description->mRTPSenders.begin(); iter != description->mRTPSenders.end(); ++iter) {
           auto &sender = *(*iter);
@@ -2319,6 +2399,18 @@ namespace ortc
           ReceiverInfoPtr receiverInfo;
           bool eventReceiver = false;
 
+          if ((sender.mID.hasData()) &&
+              (ioDiff.mSenders.end() == ioDiff.mSenders.find(sender.mID))) {
+            auto found = mReceivers.find(sender.mID);
+            if ((found != mReceivers.end()) &&
+                (ioDiff.mRTPMediaLines.end() == ioDiff.mRTPMediaLines.find((*found).second->mMediaLineID)) &&
+                (isSettled(*((*found).second)))) {
+              ZS_LOG_TRACE(log("remote sender is unchanged") + ZS_PARAM("sender id", sender.mID));
+              continue;
+            }
+            ioDiff.mSenders.insert(sender.mID);
+          }
+
           // prepare receivers
           {
             // scope: find receiver
@@ -2518,7 +2610,10 @@ namespace ortc
       }
 
       //-----------------------------------------------------------------------
-      bool PeerConnection::stepProcessRemoteSCTPTransport(ISessionDescriptionTypes::DescriptionPtr description)
+      bool PeerConnection::stepProcessRemoteSCTPTransport(
+                                                          ISessionDescriptionTypes::DescriptionPtr description,
+                                                          RemoteDescriptionDiff &ioDiff
+                                                          )
       {
         for (auto iter = description->mSCTPMediaLines.begin(); iter != description->mSCTPMediaLines.end(); ++iter)
         {
@@ -2526,6 +2621,22 @@ namespace ortc
 
           SCTPMediaLineInfoPtr mediaLineInfo;
 
+          if ((mediaLine.mID.hasData()) &&
+              (ioDiff.mSCTPMediaLines.end() == ioDiff.mSCTPMediaLines.find(mediaLine.mID))) {
+            String privateTransportID = mediaLine.mDetails ? mediaLine.mDetails->mPrivateTransportID : String();
+            bool transportChanged = (ioDiff.mTransports.end() != ioDiff.mTransports.find(mediaLine.mTransportID)) ||
+                                    ((privateTransportID.hasData()) && (ioDiff.mTransports.end() != ioDiff.mTransports.find(privateTransportID)));
+
+            auto found = mSCTPMedias.find(mediaLine.mID);
+            if ((!transportChanged) &&
+                (found != mSCTPMedias.end()) &&
+                (isSettled(*((*found).second)))) {
+              ZS_LOG_TRACE(log("remote sctp media line is unchanged") + ZS_PARAM("media line id", mediaLine.mID));
+              continue;
+            }
+            ioDiff.mSCTPMediaLines.insert(mediaLine.mID);
+          }
+
           // scope prepare media line
           {
             // scope: find the media line
@@ -2645,6 +2756,25 @@ namespace ortc
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      bool PeerConnection::stepProcessRemoteRemovedSenders(const RemoteDescriptionDiff &diff)
+      {
+        for (auto iter = diff.mRemovedSenders.begin(); iter != diff.mRemovedSenders.end(); ++iter) {
+          auto &senderID = (*iter);
+
+          auto found = mReceivers.find(senderID);
+          if (found == mReceivers.end()) continue;
+
+          auto &receiverInfo = *((*found).second);
+          if (NegotiationState_Rejected == receiverInfo.mNegotiationState) continue;
+
+          ZS_LOG_DEBUG(log("remote sender was removed (thus closing receiver)") + receiverInfo.toDebug());
+          close(receiverInfo);
+        }
+
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       bool PeerConnection::stepProcessLocal()
       {
@@ -4203,9 +4333,10 @@ namespace ortc
         TransportInfoPtr info(make_shared<TransportInfo>());
 
         IICEGatherer::Options emptyOptions;
-        info->mRTP.mGatherer = IICEGatherer::create(mThisWeak.lock(), mConfiguration.mGatherOptions ? (*(mConfiguration.mGatherOptions)) : emptyOptions);
-        info->mRTP.mGatherer->gather();
+        info->mRTP.mGatherStarted = zsLib::now();
+        info->mRTP.mGatherer = ortc::internal::ICEGathererPool::acquire(mThisWeak.lock(), mConfiguration.mGatherOptions ? (*(mConfiguration.mGatherOptions)) : emptyOptions, info->mRTP.mGathererSubscription, info->mRTP.mPooledGatherer);
         info->mRTP.mTransport = IICETransport::create(mThisWeak.lock(), info->mRTP.mGatherer);
+        mPendingFirstCandidates[info->mRTP.mGatherer->getID()] = info;
 
         if (IPeerConnectionTypes::RTCPMuxPolicy_Negotiated == mConfiguration.mRTCPMuxPolicy) {
           info->mRTCP.mGatherer = info->mRTP.mGatherer->createAssociatedGatherer(mThisWeak.lock());
@@ -4219,6 +4350,25 @@ namespace ortc
         mTransportPool.push_back(info);
       }
 
+      //-----------------------------------------------------------------------
+      void PeerConnection::notifyFirstCandidate(IICEGathererPtr gatherer)
+      {
+        auto foundPending = mPendingFirstCandidates.find(gatherer->getID());
+        if (foundPending == mPendingFirstCandidates.end()) return;
+
+        TransportInfoPtr found = (*foundPending).second;
+        mPendingFirstCandidates.erase(foundPending);
+
+        auto &details = found->mRTP;
+        if (details.mFirstCandidateReported) return;
+        details.mFirstCandidateReported = true;
+
+        auto elapsed = zsLib::toMilliseconds(zsLib::now() - details.mGatherStarted);
+        ZS_LOG_DEBUG(log("first local candidate") + ZS_PARAM("gatherer id", gatherer->getID()) + ZS_PARAM("pooled", details.mPooledGatherer) + ZS_PARAM("elapsed", elapsed))
+
+        ortc::internal::ICEGathererPool::notifyFirstCandidate(details.mPooledGatherer, elapsed);
+      }
+
       //-----------------------------------------------------------------------
       String PeerConnection::registerNewID(size_t length)
       {
@@ -4348,7 +4498,12 @@ namespace ortc
           details.mTransport->stop();
           details.mTransport.reset();
         }
+        if (details.mGathererSubscription) {
+          details.mGathererSubscription->cancel();
+          details.mGathererSubscription.reset();
+        }
         if (details.mGatherer) {
+          mPendingFirstCandidates.erase(details.mGatherer->getID());
           details.mGatherer->close();
           details.mGatherer.reset();
         }
@@ -4734,6 +4889,245 @@ namespace ortc
         }
       }
 
+      //-----------------------------------------------------------------------
+      void PeerConnection::calculateRemoteDiff(
+                                               const ISessionDescriptionTypes::Description &description,
+                                               ISDPTypes::SDPPtr sdp,
+                                               const RemoteDescriptionHashes &existingHashes,
+                                               RemoteDescriptionHashes &outHashes,
+                                               RemoteDescriptionDiff &outDiff
+                                               )
+      {
+        typedef RemoteDescriptionHashes::Entry Entry;
+        typedef RemoteDescriptionHashes::HashMap HashMap;
+        typedef RemoteDescriptionDiff::IDSet IDSet;
+        typedef std::vector<QWORD> DigestList;
+        typedef std::map<String, size_t> IndexMap;
+
+        outHashes = RemoteDescriptionHashes();
+        outDiff = RemoteDescriptionDiff();
+
+        // an entry parsed from an sdp section whose raw text (and linkage to
+        // other sections) is unchanged keeps its previous hash; only new or
+        // edited sections (or descriptions not parsed from sdp) are hashed
+        DigestList sectionDigests;
+        if (sdp) {
+          sectionDigests.reserve(sdp->mMLines.size());
+          for (auto iter = sdp->mMLines.begin(); iter != sdp->mMLines.end(); ++iter) {
+            sectionDigests.push_back((*iter)->mSectionDigest);
+          }
+        }
+
+        struct Compare
+        {
+          static QWORD digest(
+                              const DigestList &digests,
+                              const Optional<size_t> &index
+                              )
+          {
+            if (!index.hasValue()) return 0;
+            if (index.value() >= digests.size()) return 0;
+            return digests[index.value()];
+          }
+
+          static bool reuse(
+                            const HashMap &existing,
+                            const String &id,
+                            Entry &ioEntry
+                            )
+          {
+            if (0 == ioEntry.mSectionDigest) return false;
+
+            auto found = existing.find(id);
+            if (found == existing.end()) return false;
+
+            auto &previous = (*found).second;
+            if (previous.mSectionDigest != ioEntry.mSectionDigest) return false;
+            if (previous.mLinkage != ioEntry.mLinkage) return false;
+
+            ioEntry.mHash = previous.mHash;
+            return true;
+          }
+
+          static void changed(
+                              const HashMap &existing,
+                              const String &id,
+                              const Entry &entry,
+                              HashMap &outHashes,
+                              IDSet &outChanged
+                              )
+          {
+            outHashes[id] = entry;
+
+            auto found = existing.find(id);
+            if (found == existing.end()) {
+              outChanged.insert(id);
+              return;
+            }
+            if ((*found).second.mHash != entry.mHash) outChanged.insert(id);
+          }
+        };
+
+        IndexMap mediaLineIndexes;
+
+        for (auto iter = description.mRTPMediaLines.begin(); iter != description.mRTPMediaLines.end(); ++iter) {
+          auto &mediaLine = *(*iter);
+          if (mediaLine.mID.isEmpty()) continue;
+
+          Optional<size_t> index = mediaLine.mDetails ? mediaLine.mDetails->mInternalIndex : Optional<size_t>();
+          if (index.hasValue()) mediaLineIndexes[mediaLine.mID] = index.value();
+
+          Entry entry;
+          entry.mSectionDigest = Compare::digest(sectionDigests, index);
+          entry.mLinkage = mediaLine.mTransportID + "/" + (mediaLine.mDetails ? mediaLine.mDetails->mPrivateTransportID : String());
+          if (!Compare::reuse(existingHashes.mRTPMediaLines, mediaLine.mID, entry)) {
+            entry.mHash = mediaLine.hash();
+            ++outDiff.mTotalHashed;
+          }
+          Compare::changed(existingHashes.mRTPMediaLines, mediaLine.mID, entry, outHashes.mRTPMediaLines, outDiff.mRTPMediaLines);
+        }
+        for (auto iter = description.mSCTPMediaLines.begin(); iter != description.mSCTPMediaLines.end(); ++iter) {
+          auto &mediaLine = *(*iter);
+          if (mediaLine.mID.isEmpty()) continue;
+
+          Optional<size_t> index = mediaLine.mDetails ? mediaLine.mDetails->mInternalIndex : Optional<size_t>();
+          if (index.hasValue()) mediaLineIndexes[mediaLine.mID] = index.value();
+
+          Entry entry;
+          entry.mSectionDigest = Compare::digest(sectionDigests, index);
+          entry.mLinkage = mediaLine.mTransportID + "/" + (mediaLine.mDetails ? mediaLine.mDetails->mPrivateTransportID : String());
+          if (!Compare::reuse(existingHashes.mSCTPMediaLines, mediaLine.mID, entry)) {
+            entry.mHash = mediaLine.hash();
+            ++outDiff.mTotalHashed;
+          }
+          Compare::changed(existingHashes.mSCTPMediaLines, mediaLine.mID, entry, outHashes.mSCTPMediaLines, outDiff.mSCTPMediaLines);
+        }
+        for (auto iter = description.mTransports.begin(); iter != description.mTransports.end(); ++iter) {
+          auto &transport = *(*iter);
+          if (transport.mID.isEmpty()) continue;
+
+          // a transport is parsed from the m= section sharing its id (mid)
+          Optional<size_t> index;
+          {
+            auto found = mediaLineIndexes.find(transport.mID);
+            if (found != mediaLineIndexes.end()) index = (*found).second;
+          }
+
+          Entry entry;
+          entry.mSectionDigest = Compare::digest(sectionDigests, index);
+          if (!Compare::reuse(existingHashes.mTransports, transport.mID, entry)) {
+            entry.mHash = transport.hash();
+            ++outDiff.mTotalHashed;
+          }
+          Compare::changed(existingHashes.mTransports, transport.mID, entry, outHashes.mTransports, outDiff.mTransports);
+        }
+        for (auto iter = description.mRTPSenders.begin(); iter != description.mRTPSenders.end(); ++iter) {
+          auto &sender = *(*iter);
+          if (sender.mID.isEmpty()) continue;
+
+          Entry entry;
+          entry.mSectionDigest = Compare::digest(sectionDigests, sender.mDetails ? sender.mDetails->mInternalRTPMediaLineIndex : Optional<size_t>());
+          entry.mLinkage = sender.mRTPMediaLineID;
+          if (!Compare::reuse(existingHashes.mSenders, sender.mID, entry)) {
+            entry.mHash = sender.hash();
+            ++outDiff.mTotalHashed;
+          }
+          Compare::changed(existingHashes.mSenders, sender.mID, entry, outHashes.mSenders, outDiff.mSenders);
+        }
+
+        // transports and media lines are never removed from a description
+        // (they are rejected in place) but remote senders can go away
+        for (auto iter = existingHashes.mSenders.begin(); iter != existingHashes.mSenders.end(); ++iter) {
+          auto &id = (*iter).first;
+          if (outHashes.mSenders.end() != outHashes.mSenders.find(id)) continue;
+          outDiff.mRemovedSenders.insert(id);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      bool PeerConnection::isSettled(NegotiationStates state)
+      {
+        switch (state) {
+          case NegotiationState_PendingOffer:   return false;
+          case NegotiationState_LocalOffered:   return false;
+          case NegotiationState_RemoteOffered:  return false;
+          case NegotiationState_Agreed:         return true;
+          case NegotiationState_Rejected:       return true;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      bool PeerConnection::isSettled(const TransportInfo &transportInfo) const
+      {
+        if (NegotiationState_Rejected == transportInfo.mNegotiationState) return true;
+        if (!isSettled(transportInfo.mNegotiationState)) return false;
+
+        // an agreed transport is only left alone while what it set up is
+        // still usable (otherwise the unchanged remote side is re-applied)
+        auto &rtp = transportInfo.mRTP;
+        if (!rtp.mGatherer) return false;
+        if (IICEGathererTypes::State_Closed == rtp.mGatherer->state()) return false;
+        if (!rtp.mTransport) return false;
+
+        switch (rtp.mTransport->state()) {
+          case IICETransportTypes::State_New:
+          case IICETransportTypes::State_Checking:
+          case IICETransportTypes::State_Connected:
+          case IICETransportTypes::State_Completed:
+          case IICETransportTypes::State_Disconnected:  break;
+          case IICETransportTypes::State_Failed:
+          case IICETransportTypes::State_Closed:        return false;
+        }
+
+        if (rtp.mDTLSTransport) {
+          switch (rtp.mDTLSTransport->state()) {
+            case IDTLSTransportTypes::State_New:
+            case IDTLSTransportTypes::State_Connecting:
+            case IDTLSTransportTypes::State_Connected:  break;
+            case IDTLSTransportTypes::State_Closed:
+            case IDTLSTransportTypes::State_Failed:     return false;
+          }
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool PeerConnection::isSettled(const MediaLineInfo &mediaLineInfo) const
+      {
+        if (NegotiationState_Rejected == mediaLineInfo.mNegotiationState) return true;
+        if (!isSettled(mediaLineInfo.mNegotiationState)) return false;
+
+        // an agreed media line is only settled while its transport is
+        const String &transportID = mediaLineInfo.mPrivateTransportID.hasData() ? mediaLineInfo.mPrivateTransportID : mediaLineInfo.mBundledTransportID;
+        if (transportID.isEmpty()) return true;
+
+        auto found = mTransports.find(transportID);
+        if (found == mTransports.end()) return false;
+
+        auto &transportInfo = *((*found).second);
+        if (NegotiationState_Agreed != transportInfo.mNegotiationState) return false;
+        return isSettled(transportInfo);
+      }
+
+      //-----------------------------------------------------------------------
+      bool PeerConnection::isSettled(const ReceiverInfo &receiverInfo) const
+      {
+        if (NegotiationState_Rejected == receiverInfo.mNegotiationState) return true;
+        if (!isSettled(receiverInfo.mNegotiationState)) return false;
+
+        // an agreed receiver is only settled while it exists and its media
+        // line is still agreed
+        if (!receiverInfo.mReceiver) return false;
+
+        auto found = mRTPMedias.find(receiverInfo.mMediaLineID);
+        if (found == mRTPMedias.end()) return false;
+
+        auto &mediaLineInfo = *((*found).second);
+        if (NegotiationState_Agreed != mediaLineInfo.mNegotiationState) return false;
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       IDTLSTransportTypes::ParametersPtr PeerConnection::getDTLSParameters(
                                                                            const TransportInfo &transportInfo,
@@ -284,11 +284,21 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::Attributes ISDPTypes::toAttribute(const char *attribute)
       {
-        String str(attribute);
-        for (Attributes index = Attribute_First; index <= Attribute_Last; index = static_cast<Attributes>(static_cast<std::underlying_type<Attributes>::type>(index) + 1)) {
-          if (0 == str.compare(toString(index))) return index;
-        }
+        if (!attribute) return Attribute_Unknown;
+        return toAttribute(attribute, strlen(attribute));
+      }
+
+      //-----------------------------------------------------------------------
+      ISDPTypes::Attributes ISDPTypes::toAttribute(
+                                                   const char *attribute,
+                                                   size_t length
+                                                   )
+      {
+        // Attribute_Unknown (the first value) has no name and is never stored
+        static const ortc::internal::EnumStringTable<Attributes> table(static_cast<Attributes>(Attribute_Unknown + 1), Attribute_Last, ISDPTypes::toString);
 
+        Attributes result {};
+        if (table.find(attribute, length, result)) return result;
         return Attribute_Unknown;
       }
 
@@ -428,10 +438,10 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::Locations ISDPTypes::toLocation(const char *location)
       {
-        String str(location);
-        for (Locations index = Location_First; index <= Location_Last; index = static_cast<Locations>(static_cast<std::underlying_type<Locations>::type>(index) + 1)) {
-          if (0 == str.compare(toString(index))) return index;
-        }
+        static const ortc::internal::EnumStringTable<Locations> table(Location_First, Location_Last, ISDPTypes::toString);
+
+        Locations result {};
+        if (table.find(location, result)) return result;
         ORTC_THROW_NOT_SUPPORTED_ERRROR("unknown location");
       }
 
@@ -452,22 +462,14 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::Directions ISDPTypes::toDirection(const char *direction)
       {
-        static Directions check[] =
-        {
-          Direction_Send,
-          Direction_Receive,
-          Direction_SendReceive,
-          Direction_None
-        };
+        if ((!direction) || ('\0' == *direction)) return Direction_None;
 
-        String str(direction);
-        if (str.isEmpty()) return Direction_None;
+        static const ortc::internal::EnumStringTable<Directions> table(Direction_None, Direction_SendReceive, ISDPTypes::toString, false);
 
-        for (size_t index = 0; index <= (sizeof(check)/sizeof(check[0])); ++index) {
-          if (0 == str.compareNoCase(toString(check[index]))) return check[index];
-        }
+        Directions result {};
+        if (table.find(direction, result)) return result;
 
-        ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str);
+        ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(direction));
       }
 
       //-----------------------------------------------------------------------
@@ -505,20 +507,12 @@ namespace ortc
       //-----------------------------------------------------------------------
       ISDPTypes::ActorRoles ISDPTypes::toActorRole(const char *actor)
       {
-        static ActorRoles check[] =
-        {
-          ActorRole_Sender,
-          ActorRole_Receiver,
-          ActorRole_Transceiver
-        };
-
-        String str(actor);
+        static const ortc::internal::EnumStringTable<ActorRoles> table(ActorRole_Sender, ActorRole_Transceiver, ISDPTypes::toString, false);
 
-        for (size_t index = 0; index <= (sizeof(check) / sizeof(check[0])); ++index) {
-          if (0 == str.compareNoCase(toString(check[index]))) return check[index];
-        }
+        ActorRoles result {};
+        if (table.find(actor, result)) return result;
 
-        ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str);
+        ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(actor));
       }
 
       //-----------------------------------------------------------------------
@@ -1695,6 +1689,39 @@ namespace ortc
       }
 
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ISDPTypes::LineArena
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void *ISDPTypes::LineArena::allocate(
+                                           size_t size,
+                                           size_t alignment
+                                           )
+      {
+        size_t padding = (alignment - (reinterpret_cast<uintptr_t>(mPos) % alignment)) % alignment;
+
+        if ((!mPos) ||
+            (size + padding > mAvailable)) {
+          // blocks come from operator new[] which is suitably aligned for any
+          // line struct
+          size_t blockSize = (size > Size_Block ? size : static_cast<size_t>(Size_Block));
+          mBlocks.push_back(Block(new BYTE[blockSize]));
+          mPos = mBlocks.back().get();
+          mAvailable = blockSize;
+          padding = 0;
+        }
+
+        BYTE *result = mPos + padding;
+        mPos = result + size;
+        mAvailable -= (size + padding);
+        return result;
+      }
+
     }  // namespace internal
   } // namespace adapter
 } // namespace ortc
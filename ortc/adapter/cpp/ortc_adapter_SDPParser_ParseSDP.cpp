@@ -73,6 +73,41 @@ namespace ortc
         return Log::Params(message, "ortc::adapter::SDPParser");
       }
 
+      //-----------------------------------------------------------------------
+      static QWORD digestLine(const ISDPTypes::LineTypeInfo &info)
+      {
+        // FNV-1a over the line type and raw value
+        QWORD digest = 14695981039346656037ULL;
+        digest = (digest ^ static_cast<QWORD>(info.mLineType)) * 1099511628211ULL;
+        for (const char *pos = info.mValue; (pos) && ('\0' != *pos); ++pos) {
+          digest = (digest ^ static_cast<QWORD>(static_cast<BYTE>(*pos))) * 1099511628211ULL;
+        }
+        return digest;
+      }
+
+      //-----------------------------------------------------------------------
+      static QWORD combineDigest(
+                                 QWORD digest,
+                                 QWORD lineDigest
+                                 )
+      {
+        return (digest ^ lineDigest) * 1099511628211ULL;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool isSectionDependency(const ISDPTypes::LineTypeInfo &info)
+      {
+        if (ISDPTypes::LineType_o_Origin == info.mLineType) return false;
+        if (ISDPTypes::LineType_a_Attributes != info.mLineType) return true;
+
+        switch (info.mAttribute) {
+          case ISDPTypes::Attribute_Group:          return false;
+          case ISDPTypes::Attribute_MSIDSemantic:   return false;
+          default:                                  break;
+        }
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -82,795 +117,764 @@ namespace ortc
       #pragma mark
 
       //-----------------------------------------------------------------------
-      void SDPParser::parseLines(SDP &sdp)
+      bool SDPParser::parseLine(
+                                char * &ioPos,
+                                LineTypeInfo &outInfo
+                                )
       {
-        char *pos = sdp.mRawBuffer.get();
-
-        bool lastWasEOL = true;
+        char *pos = ioPos;
 
         while ('\0' != *pos)
         {
-          if (('\r' == *pos) ||
-              ('\n' == *pos)) {
+          char *lineStart = pos;
+
+          // terminate the line in place (a value is a borrowed pointer into
+          // the SDP's raw buffer)
+          pos += strcspn(pos, "\r\n");
+          while (('\r' == *pos) ||
+                 ('\n' == *pos)) {
             *pos = '\0';
             ++pos;
-            lastWasEOL = true;
-            continue;
           }
 
-          if (!lastWasEOL) {
-            ++pos;
-            continue;
-          }
+          auto lineType = toLineType(*lineStart);
+          if (LineType_Unknown == lineType) continue;
+          if ('=' != lineStart[1]) continue;
 
-          lastWasEOL = false;
+          outInfo = LineTypeInfo();
+          outInfo.mLineType = lineType;
+          outInfo.mValue = lineStart + 2;
 
-          auto lineType = toLineType(*pos);
-          if (LineType_Unknown == lineType) {
-            ++pos;
-            continue;
-          }
-
-          ++pos;
-          if ('=' != *pos) {
-            ++pos;
-            continue;
-          }
-          ++pos;
-
-          LineTypeInfo info;
-          info.mLineType = lineType;
-          info.mValue = pos;
-          sdp.mLineInfos.push_back(info);
-          ++pos;
+          ioPos = pos;
+          return true;
         }
+
+        ioPos = pos;
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::parseAttributes(SDP &sdp)
+      void SDPParser::parseAttribute(LineTypeInfo &info)
       {
-        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
-        {
-          auto &info = (*iter);
-          if (LineType_a_Attributes != info.mLineType) continue;
-
-          char *pos = const_cast<char *>(info.mValue);
+        char *pos = const_cast<char *>(info.mValue);
 
-          char *attributeName = pos;
-          const char *attributeValue {};
+        char *attributeName = pos;
+        char *attributeNameEnd {};
+        const char *attributeValue {};
 
-          while ('\0' != *pos)
-          {
-            // when the ':' is reached the value must start
-            if (':' != *pos) {
-              // continue skipping while not hitting white space
-              if (!isspace(*pos)) {
-                ++pos;
-                continue;
-              }
-
-              // value name ends at white space
-              *pos = '\0';
+        while ('\0' != *pos)
+        {
+          // when the ':' is reached the value must start
+          if (':' != *pos) {
+            // continue skipping while not hitting white space
+            if (!isspace(*pos)) {
               ++pos;
-
-              // be friendly do bad white space infront of a ':' by skipping it....
-              while ('\0' != *pos) {
-                if (!isspace(*pos)) break;
-                ++pos;
-              }
-              // if hit nul character, there is no value 
-              if ('\0' == *pos) continue;
-
-              // otherwise a ':' MUST be hit
-              ORTC_THROW_INVALID_PARAMETERS_IF(':' != *pos);
               continue;
             }
 
-            // break value at the point of the colon
+            // value name ends at white space
+            if (!attributeNameEnd) attributeNameEnd = pos;
             *pos = '\0';
             ++pos;
 
-            // skip over white space before any value
-            while ('\0' != *pos)
-            {
+            // be friendly do bad white space infront of a ':' by skipping it....
+            while ('\0' != *pos) {
               if (!isspace(*pos)) break;
               ++pos;
             }
+            // if hit nul character, there is no value 
+            if ('\0' == *pos) continue;
 
-            if ('\0' != *pos) {
-              // if there was some kind of non-white space before nul
-              /// character then a value must exist
-              attributeValue = pos;
-            }
-            break;
+            // otherwise a ':' MUST be hit
+            ORTC_THROW_INVALID_PARAMETERS_IF(':' != *pos);
+            continue;
           }
 
-          info.mAttribute = toAttribute(attributeName);
-          info.mValue = attributeValue;
-          if (Attribute_Unknown == info.mAttribute) {
-            ZS_LOG_WARNING(Trace, slog("attribute is not understood") + ZS_PARAM("attribute name", attributeName) + ZS_PARAM("attribute value", attributeValue))
-            continue;
+          // break value at the point of the colon
+          if (!attributeNameEnd) attributeNameEnd = pos;
+          *pos = '\0';
+          ++pos;
+
+          // skip over white space before any value
+          while ('\0' != *pos)
+          {
+            if (!isspace(*pos)) break;
+            ++pos;
           }
 
-          // make sure the value is either present or missing depending on the
-          // attribute type
-          if (info.mValue) {
-            ORTC_THROW_INVALID_PARAMETERS_IF(requiresEmptyValue(info.mAttribute));
-          } else {
-            ORTC_THROW_INVALID_PARAMETERS_IF(requiresValue(info.mAttribute));
+          if ('\0' != *pos) {
+            // if there was some kind of non-white space before nul
+            /// character then a value must exist
+            attributeValue = pos;
           }
+          break;
+        }
+
+        if (!attributeNameEnd) attributeNameEnd = pos;
+
+        info.mAttribute = toAttribute(attributeName, static_cast<size_t>(attributeNameEnd - attributeName));
+        info.mValue = attributeValue;
+        if (Attribute_Unknown == info.mAttribute) {
+          ZS_LOG_WARNING(Trace, slog("attribute is not understood") + ZS_PARAM("attribute name", attributeName) + ZS_PARAM("attribute value", attributeValue))
+          return;
+        }
+
+        // make sure the value is either present or missing depending on the
+        // attribute type
+        if (info.mValue) {
+          ORTC_THROW_INVALID_PARAMETERS_IF(requiresEmptyValue(info.mAttribute));
+        } else {
+          ORTC_THROW_INVALID_PARAMETERS_IF(requiresValue(info.mAttribute));
         }
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::validateAttributeLevels(SDP &sdp)
+      void SDPParser::validateAttributeLevel(
+                                             LineTypeInfo &info,
+                                             AttributeLevels &currentLevel
+                                             )
       {
-        auto currentLevel = AttributeLevel_Session;
+        if (LineType_Unknown == info.mLineType) return;
 
-        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
-        {
-          auto &info = (*iter);
+        if (LineType_m_MediaLine == info.mLineType) {
+          // immediately switch to the session level (so that media level is legal)
+          currentLevel = AttributeLevel_Session;
+        }
+
+        if (LineType_a_Attributes == info.mLineType) {
+          if (Attribute_Unknown == info.mAttribute) return; // skip any unknown attributes
+        }
 
-          if (LineType_Unknown == info.mLineType) continue;
+        if (AttributeLevel_Source == currentLevel) {
 
-          if (LineType_m_MediaLine == info.mLineType) {
-            // immediately switch to the session level (so that media level is legal)
-            currentLevel = AttributeLevel_Session;
-          }
+          AttributeLevels allowedLevels = AttributeLevel_None;
 
           if (LineType_a_Attributes == info.mLineType) {
-            if (Attribute_Unknown == info.mAttribute) continue; // skip any unknown attributes
+            allowedLevels = getAttributeLevel(info.mAttribute);
+          } else {
+            allowedLevels = getAttributeLevel(info.mLineType);
           }
 
-          if (AttributeLevel_Source == currentLevel) {
-
-            AttributeLevels allowedLevels = AttributeLevel_None;
-
-            if (LineType_a_Attributes == info.mLineType) {
-              allowedLevels = getAttributeLevel(info.mAttribute);
-            } else {
-              allowedLevels = getAttributeLevel(info.mLineType);
-            }
-
-            if (0 == (AttributeLevel_Source & allowedLevels)) {
-              // line/attribute is not legal at source level (but maybe switching back to a media level attribute)
-              if (0 != (AttributeLevel_Media & allowedLevels)) {
-                // this line/attribute is moving out of source level back to media level
-                currentLevel = AttributeLevel_Media;
-              }
+          if (0 == (AttributeLevel_Source & allowedLevels)) {
+            // line/attribute is not legal at source level (but maybe switching back to a media level attribute)
+            if (0 != (AttributeLevel_Media & allowedLevels)) {
+              // this line/attribute is moving out of source level back to media level
+              currentLevel = AttributeLevel_Media;
             }
           }
+        }
 
-          ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mLineType));
-          if (LineType_a_Attributes == info.mLineType) {
-            // throw an exception if this attribute is not legal at this level
-            ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mAttribute));
-          }
+        ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mLineType));
+        if (LineType_a_Attributes == info.mLineType) {
+          // throw an exception if this attribute is not legal at this level
+          ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mAttribute));
+        }
 
-          info.mAttributeLevel = currentLevel;  // record the attribute's level
+        info.mAttributeLevel = currentLevel;  // record the attribute's level
 
-          // switch to new level if line/attribute causes a level switch
-          switch (info.mLineType)
-          {
-            case LineType_Unknown:                break;
-
-            case LineType_v_Version:              break;
-            case LineType_o_Origin:               break;
-            case LineType_s_SessionName:          break;
-            case LineType_b_Bandwidth:            break;
-            case LineType_t_Timing:               break;
-            case LineType_a_Attributes:           {
-              if (Attribute_SSRC == info.mAttribute) {
-                currentLevel = AttributeLevel_Source;
-                break;
-              }
-              break;
-            }
-            case LineType_m_MediaLine:            {
-              currentLevel = AttributeLevel_Media;
+        // switch to new level if line/attribute causes a level switch
+        switch (info.mLineType)
+        {
+          case LineType_Unknown:                break;
+
+          case LineType_v_Version:              break;
+          case LineType_o_Origin:               break;
+          case LineType_s_SessionName:          break;
+          case LineType_b_Bandwidth:            break;
+          case LineType_t_Timing:               break;
+          case LineType_a_Attributes:           {
+            if (Attribute_SSRC == info.mAttribute) {
+              currentLevel = AttributeLevel_Source;
               break;
             }
-            case LineType_c_ConnectionDataLine:   break;
+            break;
+          }
+          case LineType_m_MediaLine:            {
+            currentLevel = AttributeLevel_Media;
+            break;
           }
+          case LineType_c_ConnectionDataLine:   break;
         }
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::parseLinesDetails(SDP &sdp)
+      void SDPParser::parseLineDetails(
+                                       SDP &sdp,
+                                       LineTypeInfo &info,
+                                       MLinePtr &currentMLine,
+                                       ASSRCLinePtr &currentSourceLine
+                                       )
       {
-        AttributeLevels currentLevel = AttributeLevel_Session;
-
-        MLinePtr currentMLine;
-        ASSRCLinePtr currentSourceLine;
+        if (AttributeLevel_Session == info.mAttributeLevel) {
+          currentMLine.reset();
+          currentSourceLine.reset();
+        }
+        if (AttributeLevel_Media == info.mAttributeLevel) {
+          currentSourceLine.reset();
+        }
 
-        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
+        switch (info.mLineType)
         {
-          auto &info = (*iter);
-
-          if (AttributeLevel_Session == info.mAttributeLevel) {
-            currentMLine.reset();
-            currentSourceLine.reset();
+          case LineType_Unknown:                return;  // will not happen
+
+          case LineType_v_Version:              info.mLineValue = createLine<VLine>(sdp, info.mValue); break;
+          case LineType_o_Origin:               info.mLineValue = createLine<OLine>(sdp, info.mValue); break;
+          case LineType_s_SessionName:          info.mLineValue = createLine<SLine>(sdp, info.mValue); break;
+          case LineType_b_Bandwidth:            {
+            if (AttributeLevel_Session == info.mAttributeLevel) {
+              // https://tools.ietf.org/html/draft-ietf-rtcweb-jsep-14
+              // Section 5.2.1 - ignore b= for session level
+              info.mLineType = LineType_Unknown;  // make sure this line type is ignored in the future
+              return;
+            }
+            info.mLineValue = createLine<BLine>(sdp, currentMLine, info.mValue); break;
+            break;
+          }
+          case LineType_t_Timing:               info.mLineValue = createLine<TLine>(sdp, info.mValue); break;
+          case LineType_a_Attributes:           {
+            break;
           }
-          if (AttributeLevel_Media == info.mAttributeLevel) {
-            currentSourceLine.reset();
+          case LineType_m_MediaLine:            {
+            currentMLine = createLine<MLine>(sdp, info.mValue);
+            info.mLineValue = currentMLine;
+            break;
           }
+          case LineType_c_ConnectionDataLine:   info.mLineValue = createLine<CLine>(sdp, currentMLine, info.mValue); break;
+        }
 
-          switch (info.mLineType)
-          {
-            case LineType_Unknown:                continue;  // will not happen
+        if (LineType_a_Attributes != info.mLineType) return;  // special handling for attributes
 
-            case LineType_v_Version:              info.mLineValue = make_shared<VLine>(info.mValue); break;
-            case LineType_o_Origin:               info.mLineValue = make_shared<OLine>(info.mValue); break;
-            case LineType_s_SessionName:          info.mLineValue = make_shared<SLine>(info.mValue); break;
-            case LineType_b_Bandwidth:            {
-              if (AttributeLevel_Session == info.mAttributeLevel) {
-                // https://tools.ietf.org/html/draft-ietf-rtcweb-jsep-14
-                // Section 5.2.1 - ignore b= for session level
-                info.mLineType = LineType_Unknown;  // make sure this line type is ignored in the future
-                continue;
-              }
-              info.mLineValue = make_shared<BLine>(currentMLine, info.mValue); break;
-              break;
-            }
-            case LineType_t_Timing:               info.mLineValue = make_shared<TLine>(info.mValue); break;
-            case LineType_a_Attributes:           {
-              break;
+        switch (info.mAttribute)
+        {
+          case Attribute_Unknown:           break;
+
+          case Attribute_Group:             info.mLineValue = createLine<AGroupLine>(sdp, info.mValue); break;
+          case Attribute_BundleOnly:        info.mLineValue = createLine<AMediaFlagLine>(sdp, currentMLine); break;
+          case Attribute_MSID:              info.mLineValue = createLine<AMSIDLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_MSIDSemantic:      info.mLineValue = createLine<AMSIDSemanticLine>(sdp, info.mValue); break;
+          case Attribute_ICEUFrag:          info.mLineValue = createLine<AICEUFragLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_ICEPwd:            info.mLineValue = createLine<AICEPwdLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_ICEOptions:        info.mLineValue = createLine<AICEOptionsLine>(sdp, info.mValue); break;
+          case Attribute_ICELite:           break;  // session level flag; struct not needed
+          case Attribute_Candidate:         info.mLineValue = createLine<ACandidateLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_EndOfCandidates:   info.mLineValue = createLine<AMediaFlagLine>(sdp, currentMLine); break;
+          case Attribute_Fingerprint:       info.mLineValue = createLine<AFingerprintLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_Crypto:            info.mLineValue = createLine<ACryptoLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_Setup:             info.mLineValue = createLine<ASetupLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_MID:               info.mLineValue = createLine<AMIDLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_Extmap:            info.mLineValue = createLine<AExtmapLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_SendRecv:          info.mLineValue = createLine<AMediaDirectionLine>(sdp, currentMLine, toString(info.mAttribute)); break;
+          case Attribute_SendOnly:          info.mLineValue = createLine<AMediaDirectionLine>(sdp, currentMLine, toString(info.mAttribute)); break;
+          case Attribute_RecvOnly:          info.mLineValue = createLine<AMediaDirectionLine>(sdp, currentMLine, toString(info.mAttribute)); break;
+          case Attribute_Inactive:          info.mLineValue = createLine<AMediaDirectionLine>(sdp, currentMLine, toString(info.mAttribute)); break;
+          case Attribute_RTPMap:            info.mLineValue = createLine<ARTPMapLine>(sdp, currentMLine, info.mValue); break;
+          case Attirbute_FMTP:              info.mLineValue = createLine<AFMTPLine>(sdp, currentMLine, currentSourceLine, info.mValue); break;
+          case Attribute_RTCP:              info.mLineValue = createLine<ARTCPLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_RTCPMux:           info.mLineValue = createLine<AMediaFlagLine>(sdp, currentMLine); break;
+          case Attribute_RTCPFB:            info.mLineValue = createLine<ARTCPFBLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_RTCPRSize:         info.mLineValue = createLine<AMediaFlagLine>(sdp, currentMLine); break;
+          case Attribute_PTime:             info.mLineValue = createLine<APTimeLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_MaxPTime:          info.mLineValue = createLine<AMaxPTimeLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_SSRC:              info.mLineValue = createLine<ASSRCLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_SSRCGroup:         info.mLineValue = createLine<ASSRCGroupLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_Simulcast:         info.mLineValue = createLine<ASimulcastLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_RID:               info.mLineValue = createLine<ARIDLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_SCTPPort:          info.mLineValue = createLine<ASCTPPortLine>(sdp, currentMLine, info.mValue); break;
+          case Attribute_MaxMessageSize:    info.mLineValue = createLine<AMaxMessageSizeLine>(sdp, currentMLine, info.mValue); break;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      bool SDPParser::processFlagAttribute(
+                                           SDP &sdp,
+                                           LineTypeInfo &info
+                                           )
+      {
+        if (LineType_a_Attributes != info.mLineType) return false;
+
+        if (!requiresEmptyValue(info.mAttribute)) return false;
+
+        {
+          // this is a "flag" attribute
+          switch (info.mAttribute)
+          {
+            case Attribute_Unknown:           return false;
+
+            case Attribute_Group:             return false;
+            case Attribute_BundleOnly:        break;
+            case Attribute_MSID:              return false;
+            case Attribute_MSIDSemantic:      return false;
+            case Attribute_ICEUFrag:          return false;
+            case Attribute_ICEPwd:            return false;
+            case Attribute_ICEOptions:        return false;
+            case Attribute_ICELite: {
+              sdp.mICELite = true;
+              return false;
             }
-            case LineType_m_MediaLine:            {
-              currentMLine = make_shared<MLine>(info.mValue);
-              info.mLineValue = currentMLine;
-              break;
+            case Attribute_Candidate:         return false;
+            case Attribute_EndOfCandidates:   break;
+            case Attribute_Fingerprint:       return false;
+            case Attribute_Crypto:            return false;
+            case Attribute_Setup:             return false;
+            case Attribute_MID:               return false;
+            case Attribute_Extmap:            return false;
+            case Attribute_SendRecv:          
+            case Attribute_SendOnly:          
+            case Attribute_RecvOnly:          
+            case Attribute_Inactive: {
+              auto direction = ZS_DYNAMIC_PTR_CAST(AMediaDirectionLine, info.mLineValue);
+              ZS_THROW_INVALID_ASSUMPTION_IF(!direction);
+              if (direction->mMLine) {
+                ORTC_THROW_INVALID_PARAMETERS_IF(direction->mMLine->mMediaDirection.hasValue());
+                direction->mMLine->mMediaDirection = direction->mDirection;
+              } else {
+                ORTC_THROW_INVALID_PARAMETERS_IF(sdp.mMediaDirection.hasValue());
+                sdp.mMediaDirection = direction->mDirection;
+              }
+              return true;
             }
-            case LineType_c_ConnectionDataLine:   info.mLineValue = make_shared<CLine>(currentMLine, info.mValue); break;
+            case Attribute_RTPMap:            return false;
+            case Attirbute_FMTP:              return false;
+            case Attribute_RTCP:              return false;
+            case Attribute_RTCPMux:           break;
+            case Attribute_RTCPFB:            return false;
+            case Attribute_RTCPRSize:         break;
+            case Attribute_PTime:             return false;
+            case Attribute_MaxPTime:          return false;
+            case Attribute_SSRC:              return false;
+            case Attribute_SSRCGroup:         return false;
+            case Attribute_Simulcast:         return false;
+            case Attribute_RID:               return false;
+            case Attribute_SCTPPort:          return false;
+            case Attribute_MaxMessageSize:    return false;
           }
 
-          if (LineType_a_Attributes != info.mLineType) continue;  // special handling for attributes
+          auto flag = ZS_DYNAMIC_PTR_CAST(AMediaFlagLine, info.mLineValue);
+          ZS_THROW_INVALID_ASSUMPTION_IF(!flag);
+
+          ORTC_THROW_INVALID_PARAMETERS_IF(!flag->mMLine);
 
           switch (info.mAttribute)
           {
-            case Attribute_Unknown:           break;
-
-            case Attribute_Group:             info.mLineValue = make_shared<AGroupLine>(info.mValue); break;
-            case Attribute_BundleOnly:        info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
-            case Attribute_MSID:              info.mLineValue = make_shared<AMSIDLine>(currentMLine, info.mValue); break;
-            case Attribute_MSIDSemantic:      info.mLineValue = make_shared<AMSIDSemanticLine>(info.mValue); break;
-            case Attribute_ICEUFrag:          info.mLineValue = make_shared<AICEUFragLine>(currentMLine, info.mValue); break;
-            case Attribute_ICEPwd:            info.mLineValue = make_shared<AICEPwdLine>(currentMLine, info.mValue); break;
-            case Attribute_ICEOptions:        info.mLineValue = make_shared<AICEOptionsLine>(info.mValue); break;
-            case Attribute_ICELite:           break;  // session level flag; struct not needed
-            case Attribute_Candidate:         info.mLineValue = make_shared<ACandidateLine>(currentMLine, info.mValue); break;
-            case Attribute_EndOfCandidates:   info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
-            case Attribute_Fingerprint:       info.mLineValue = make_shared<AFingerprintLine>(currentMLine, info.mValue); break;
-            case Attribute_Crypto:            info.mLineValue = make_shared<ACryptoLine>(currentMLine, info.mValue); break;
-            case Attribute_Setup:             info.mLineValue = make_shared<ASetupLine>(currentMLine, info.mValue); break;
-            case Attribute_MID:               info.mLineValue = make_shared<AMIDLine>(currentMLine, info.mValue); break;
-            case Attribute_Extmap:            info.mLineValue = make_shared<AExtmapLine>(currentMLine, info.mValue); break;
-            case Attribute_SendRecv:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
-            case Attribute_SendOnly:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
-            case Attribute_RecvOnly:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
-            case Attribute_Inactive:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
-            case Attribute_RTPMap:            info.mLineValue = make_shared<ARTPMapLine>(currentMLine, info.mValue); break;
-            case Attirbute_FMTP:              info.mLineValue = make_shared<AFMTPLine>(currentMLine, currentSourceLine, info.mValue); break;
-            case Attribute_RTCP:              info.mLineValue = make_shared<ARTCPLine>(currentMLine, info.mValue); break;
-            case Attribute_RTCPMux:           info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
-            case Attribute_RTCPFB:            info.mLineValue = make_shared<ARTCPFBLine>(currentMLine, info.mValue); break;
-            case Attribute_RTCPRSize:         info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
-            case Attribute_PTime:             info.mLineValue = make_shared<APTimeLine>(currentMLine, info.mValue); break;
-            case Attribute_MaxPTime:          info.mLineValue = make_shared<AMaxPTimeLine>(currentMLine, info.mValue); break;
-            case Attribute_SSRC:              info.mLineValue = make_shared<ASSRCLine>(currentMLine, info.mValue); break;
-            case Attribute_SSRCGroup:         info.mLineValue = make_shared<ASSRCGroupLine>(currentMLine, info.mValue); break;
-            case Attribute_Simulcast:         info.mLineValue = make_shared<ASimulcastLine>(currentMLine, info.mValue); break;
-            case Attribute_RID:               info.mLineValue = make_shared<ARIDLine>(currentMLine, info.mValue); break;
-            case Attribute_SCTPPort:          info.mLineValue = make_shared<ASCTPPortLine>(currentMLine, info.mValue); break;
-            case Attribute_MaxMessageSize:    info.mLineValue = make_shared<AMaxMessageSizeLine>(currentMLine, info.mValue); break;
+            case Attribute_BundleOnly:        flag->mMLine->mBundleOnly = true; return true;
+            case Attribute_EndOfCandidates:   flag->mMLine->mEndOfCandidates = true; return true;
+            case Attribute_RTCPMux:           flag->mMLine->mRTCPMux = true; return true;
+            case Attribute_RTCPRSize:         flag->mMLine->mRTCPRSize = true; return true;
+            default:                          break;
           }
         }
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::processFlagAttributes(SDP &sdp)
+      bool SDPParser::processSessionLevelValue(
+                                               SDP &sdp,
+                                               LineTypeInfo &info
+                                               )
       {
-        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        if (AttributeLevel_Session != info.mAttributeLevel) return false;
+
+        switch (info.mLineType)
         {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
+          case LineType_Unknown:        return true;
 
-          auto &info = (*current);
-          if (LineType_a_Attributes != info.mLineType) continue;
+          case LineType_v_Version: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mVLine);
+            sdp.mVLine = ZS_DYNAMIC_PTR_CAST(VLine, info.mLineValue);
+            return true;
+          }
+          case LineType_o_Origin: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mOLine);
+            sdp.mOLine = ZS_DYNAMIC_PTR_CAST(OLine, info.mLineValue);
+            return true;
+          }
+          case LineType_s_SessionName: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mSLine);
+            sdp.mSLine = ZS_DYNAMIC_PTR_CAST(SLine, info.mLineValue);
+            return true;
+          }
+          case LineType_b_Bandwidth:    return true;
+          case LineType_t_Timing: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mTLine);
+            sdp.mTLine = ZS_DYNAMIC_PTR_CAST(TLine, info.mLineValue);
+            return true;
+          }
+          case LineType_a_Attributes:   break;
+          case LineType_m_MediaLine: {
+            sdp.mMLines.push_back(ZS_DYNAMIC_PTR_CAST(MLine, info.mLineValue));
+            return true;
+          }
+          case LineType_c_ConnectionDataLine: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mCLine);
+            sdp.mCLine = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
+            return true;
+          }
+        }
 
-          if (!requiresEmptyValue(info.mAttribute)) continue;
+        switch (info.mAttribute)
+        {
+          case Attribute_Unknown:           return true;
 
-          {
-            // this is a "flag" attribute
-            switch (info.mAttribute)
-            {
-              case Attribute_Unknown:           continue;
-
-              case Attribute_Group:             continue;
-              case Attribute_BundleOnly:        break;
-              case Attribute_MSID:              continue;
-              case Attribute_MSIDSemantic:      continue;
-              case Attribute_ICEUFrag:          continue;
-              case Attribute_ICEPwd:            continue;
-              case Attribute_ICEOptions:        continue;
-              case Attribute_ICELite: {
-                sdp.mICELite = true;
-                continue;
-              }
-              case Attribute_Candidate:         continue;
-              case Attribute_EndOfCandidates:   break;
-              case Attribute_Fingerprint:       continue;
-              case Attribute_Crypto:            continue;
-              case Attribute_Setup:             continue;
-              case Attribute_MID:               continue;
-              case Attribute_Extmap:            continue;
-              case Attribute_SendRecv:          
-              case Attribute_SendOnly:          
-              case Attribute_RecvOnly:          
-              case Attribute_Inactive: {
-                auto direction = ZS_DYNAMIC_PTR_CAST(AMediaDirectionLine, info.mLineValue);
-                ZS_THROW_INVALID_ASSUMPTION_IF(!direction);
-                if (direction->mMLine) {
-                  ORTC_THROW_INVALID_PARAMETERS_IF(direction->mMLine->mMediaDirection.hasValue());
-                  direction->mMLine->mMediaDirection = direction->mDirection;
-                } else {
-                  ORTC_THROW_INVALID_PARAMETERS_IF(sdp.mMediaDirection.hasValue());
-                  sdp.mMediaDirection = direction->mDirection;
-                }
-                goto remove_line;;
-              }
-              case Attribute_RTPMap:            continue;
-              case Attirbute_FMTP:              continue;
-              case Attribute_RTCP:              continue;
-              case Attribute_RTCPMux:           break;
-              case Attribute_RTCPFB:            continue;
-              case Attribute_RTCPRSize:         break;
-              case Attribute_PTime:             continue;
-              case Attribute_MaxPTime:          continue;
-              case Attribute_SSRC:              continue;
-              case Attribute_SSRCGroup:         continue;
-              case Attribute_Simulcast:         continue;
-              case Attribute_RID:               continue;
-              case Attribute_SCTPPort:          continue;
-              case Attribute_MaxMessageSize:    continue;
-            }
-
-            auto flag = ZS_DYNAMIC_PTR_CAST(AMediaFlagLine, info.mLineValue);
-            ZS_THROW_INVALID_ASSUMPTION_IF(!flag);
-
-            ORTC_THROW_INVALID_PARAMETERS_IF(!flag->mMLine);
-
-            switch (info.mAttribute)
-            {
-              case Attribute_BundleOnly:        flag->mMLine->mBundleOnly = true; goto remove_line;
-              case Attribute_EndOfCandidates:   flag->mMLine->mEndOfCandidates = true; goto remove_line;
-              case Attribute_RTCPMux:           flag->mMLine->mRTCPMux = true; goto remove_line;
-              case Attribute_RTCPRSize:         flag->mMLine->mRTCPRSize = true; goto remove_line;
-              default:                          break;
-            }
-          }
-          continue;
-
-        remove_line:
-          {
-            // no longer need to process this line
-            sdp.mLineInfos.erase(current);
+          case Attribute_Group: {
+            sdp.mAGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(AGroupLine, info.mLineValue));
+            return true;
+          }
+          case Attribute_BundleOnly:        return false;
+          case Attribute_MSID:              return false;
+          case Attribute_MSIDSemantic: {
+            sdp.mAMSIDSemanticLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDSemanticLine, info.mLineValue));
+            return true;
           }
+          case Attribute_ICEUFrag: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEUFragLine);
+            sdp.mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
+            return true;
+          }
+          case Attribute_ICEPwd: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEPwdLine);
+            sdp.mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
+            return true;
+          }
+          case Attribute_ICEOptions: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEOptionsLine);
+            sdp.mAICEOptionsLine = ZS_DYNAMIC_PTR_CAST(AICEOptionsLine, info.mLineValue);
+            return true;
+          }
+          case Attribute_ICELite:           return false;
+          case Attribute_Candidate:         return false;
+          case Attribute_EndOfCandidates:   return false;
+          case Attribute_Fingerprint: {
+            sdp.mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
+            return true;
+          }
+          case Attribute_Crypto:            return false;
+          case Attribute_Setup: {
+            ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mASetupLine);
+            sdp.mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
+            return true;
+          }
+          case Attribute_MID:               return false;
+          case Attribute_Extmap: {
+            sdp.mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
+            return true;
+          }
+          case Attribute_SendRecv:          return false;
+          case Attribute_SendOnly:          return false;
+          case Attribute_RecvOnly:          return false;
+          case Attribute_Inactive:          return false;
+          case Attribute_RTPMap:            return false;
+          case Attirbute_FMTP:              return false;
+          case Attribute_RTCP:              return false;
+          case Attribute_RTCPMux:           return false;
+          case Attribute_RTCPFB:            return false;
+          case Attribute_RTCPRSize:         return false;
+          case Attribute_PTime:             return false;
+          case Attribute_MaxPTime:          return false;
+          case Attribute_SSRC:              return false;
+          case Attribute_SSRCGroup:         return false;
+          case Attribute_Simulcast:         return false;
+          case Attribute_RID:               return false;
+          case Attribute_SCTPPort:          return false;
+          case Attribute_MaxMessageSize:    return false;
         }
+
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::processSessionLevelValues(SDP &sdp)
+      bool SDPParser::processMediaLevelValue(
+                                             SDP &sdp,
+                                             LineTypeInfo &info
+                                             )
       {
-        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        if (AttributeLevel_Media != info.mAttributeLevel) return false;
+
+        // scope: process line
         {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
+          switch (info.mLineType)
+          {
+            case LineType_Unknown:                return true;
 
-          auto &info = (*current);
+            case LineType_v_Version:              return false;
+            case LineType_o_Origin:               return false;
+            case LineType_s_SessionName:          return false;
+            case LineType_b_Bandwidth:            {
+              auto bline = ZS_DYNAMIC_PTR_CAST(BLine, info.mLineValue);
+              ORTC_THROW_INVALID_PARAMETERS_IF(!bline->mMLine);
+              bline->mMLine->mBLines.push_back(bline);
+              bline->mMLine.reset();  // no longer point back to mline
+              return true;
+            }
+            case LineType_t_Timing:               return false;
+            case LineType_a_Attributes:           break;
+            case LineType_m_MediaLine:            return false;
+            case LineType_c_ConnectionDataLine:   {
+              auto cline = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
+              ORTC_THROW_INVALID_PARAMETERS_IF(!cline->mMLine);
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)cline->mMLine->mCLine);
+              cline->mMLine->mCLine = cline;
+              cline->mMLine.reset();  // no longer point back to mline
+              return true;
+            }
+          }
 
-          if (AttributeLevel_Session != info.mAttributeLevel) continue;
+          auto mediaLine = ZS_DYNAMIC_PTR_CAST(AMediaLine, info.mLineValue);
+          ZS_THROW_INVALID_ASSUMPTION_IF(!mediaLine);
 
-          switch (info.mLineType)
+          MLinePtr mline = mediaLine->mMLine;
+          mediaLine->mMLine.reset();
+
+          ORTC_THROW_INVALID_PARAMETERS_IF(!mline);
+
+          switch (info.mAttribute)
           {
-            case LineType_Unknown:        goto remove_line;
+            case Attribute_Unknown:           break;
 
-            case LineType_v_Version: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mVLine);
-              sdp.mVLine = ZS_DYNAMIC_PTR_CAST(VLine, info.mLineValue);
-              goto remove_line;
+            case Attribute_Group:             return false;
+            case Attribute_BundleOnly:        return false;
+            case Attribute_MSID:              {
+              mline->mAMSIDLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDLine, info.mLineValue));
+              return true;
             }
-            case LineType_o_Origin: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mOLine);
-              sdp.mOLine = ZS_DYNAMIC_PTR_CAST(OLine, info.mLineValue);
-              goto remove_line;
+            case Attribute_MSIDSemantic:      return false;
+            case Attribute_ICEUFrag:          {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEUFragLine);
+              mline->mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
+              return true;
             }
-            case LineType_s_SessionName: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mSLine);
-              sdp.mSLine = ZS_DYNAMIC_PTR_CAST(SLine, info.mLineValue);
-              goto remove_line;
+            case Attribute_ICEPwd:            {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEPwdLine);
+              mline->mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
+              return true;
             }
-            case LineType_b_Bandwidth:    goto remove_line;
-            case LineType_t_Timing: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mTLine);
-              sdp.mTLine = ZS_DYNAMIC_PTR_CAST(TLine, info.mLineValue);
-              goto remove_line;
+            case Attribute_ICEOptions:        return false;
+            case Attribute_ICELite:           return false;
+            case Attribute_Candidate:         {
+              mline->mACandidateLines.push_back(ZS_DYNAMIC_PTR_CAST(ACandidateLine, info.mLineValue));
+              return true;
             }
-            case LineType_a_Attributes:   break;
-            case LineType_m_MediaLine: {
-              sdp.mMLines.push_back(ZS_DYNAMIC_PTR_CAST(MLine, info.mLineValue));
-              goto remove_line;
+            case Attribute_EndOfCandidates:   return false;
+            case Attribute_Fingerprint:       {
+              mline->mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
+              return true;
             }
-            case LineType_c_ConnectionDataLine: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mCLine);
-              sdp.mCLine = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
-              goto remove_line;
+            case Attribute_Crypto:            {
+              mline->mACryptoLines.push_back(ZS_DYNAMIC_PTR_CAST(ACryptoLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_Setup:             {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASetupLine);
+              mline->mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_MID:               {
+              // NOTE: While technically a=mid is allowed multiple times, within
+              // the context of the jsep draft it's only every used once and
+              // mid would get confused if more than value was present thus
+              // make it illegal.
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMIDLine);
+              mline->mAMIDLine = ZS_DYNAMIC_PTR_CAST(AMIDLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_Extmap:            {
+              mline->mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_SendRecv:          return false;
+            case Attribute_SendOnly:          return false;
+            case Attribute_RecvOnly:          return false;
+            case Attribute_Inactive:          return false;
+            case Attribute_RTPMap:            {
+              mline->mARTPMapLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTPMapLine, info.mLineValue));
+              return true;
+            }
+            case Attirbute_FMTP:              {
+              mline->mAFMTPLines.push_back(ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_RTCP:              {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mARTCPLine);
+              mline->mARTCPLine = ZS_DYNAMIC_PTR_CAST(ARTCPLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_RTCPMux:           return false;
+            case Attribute_RTCPFB:            {
+              mline->mARTCPFBLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTCPFBLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_RTCPRSize:         return false;
+            case Attribute_PTime:             {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAPTimeLine);
+              mline->mAPTimeLine = ZS_DYNAMIC_PTR_CAST(APTimeLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_MaxPTime:          {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxPTimeLine);
+              mline->mAMaxPTimeLine = ZS_DYNAMIC_PTR_CAST(AMaxPTimeLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_SSRC:              {
+              mline->mASSRCLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_SSRCGroup:         {
+              mline->mASSRCGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCGroupLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_Simulcast:         {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASimulcastLine);
+              mline->mASimulcastLine = ZS_DYNAMIC_PTR_CAST(ASimulcastLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_RID:               {
+              mline->mARIDLines.push_back(ZS_DYNAMIC_PTR_CAST(ARIDLine, info.mLineValue));
+              return true;
+            }
+            case Attribute_SCTPPort:          {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASCTPPortLine);
+              mline->mASCTPPortLine = ZS_DYNAMIC_PTR_CAST(ASCTPPortLine, info.mLineValue);
+              return true;
+            }
+            case Attribute_MaxMessageSize: {
+              ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxMessageSize);
+              mline->mAMaxMessageSize = ZS_DYNAMIC_PTR_CAST(AMaxMessageSizeLine, info.mLineValue);
+              return true;
             }
-          }
-
-          switch (info.mAttribute)
-          {
-            case Attribute_Unknown:           goto remove_line;
-
-            case Attribute_Group: {
-              sdp.mAGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(AGroupLine, info.mLineValue));
-              goto remove_line;
-            }
-            case Attribute_BundleOnly:        continue;
-            case Attribute_MSID:              continue;
-            case Attribute_MSIDSemantic: {
-              sdp.mAMSIDSemanticLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDSemanticLine, info.mLineValue));
-              goto remove_line;
-            }
-            case Attribute_ICEUFrag: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEUFragLine);
-              sdp.mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
-              goto remove_line;
-            }
-            case Attribute_ICEPwd: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEPwdLine);
-              sdp.mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
-              goto remove_line;
-            }
-            case Attribute_ICEOptions: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEOptionsLine);
-              sdp.mAICEOptionsLine = ZS_DYNAMIC_PTR_CAST(AICEOptionsLine, info.mLineValue);
-              goto remove_line;
-            }
-            case Attribute_ICELite:           continue;
-            case Attribute_Candidate:         continue;
-            case Attribute_EndOfCandidates:   continue;
-            case Attribute_Fingerprint: {
-              sdp.mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
-              goto remove_line;
-            }
-            case Attribute_Crypto:            continue;
-            case Attribute_Setup: {
-              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mASetupLine);
-              sdp.mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
-              goto remove_line;
-            }
-            case Attribute_MID:               continue;
-            case Attribute_Extmap: {
-              sdp.mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
-              goto remove_line;
-            }
-            case Attribute_SendRecv:          continue;
-            case Attribute_SendOnly:          continue;
-            case Attribute_RecvOnly:          continue;
-            case Attribute_Inactive:          continue;
-            case Attribute_RTPMap:            continue;
-            case Attirbute_FMTP:              continue;
-            case Attribute_RTCP:              continue;
-            case Attribute_RTCPMux:           continue;
-            case Attribute_RTCPFB:            continue;
-            case Attribute_RTCPRSize:         continue;
-            case Attribute_PTime:             continue;
-            case Attribute_MaxPTime:          continue;
-            case Attribute_SSRC:              continue;
-            case Attribute_SSRCGroup:         continue;
-            case Attribute_Simulcast:         continue;
-            case Attribute_RID:               continue;
-            case Attribute_SCTPPort:          continue;
-            case Attribute_MaxMessageSize:    continue;
-          }
-
-          continue;
-
-        remove_line:
-          {
-            // no longer need to process this line
-            sdp.mLineInfos.erase(current);
           }
         }
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::processMediaLevelValues(SDP &sdp)
+      bool SDPParser::processSourceLevelValue(
+                                              SDP &sdp,
+                                              LineTypeInfo &info
+                                              )
       {
-        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
-        {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
-
-          auto &info = (*current);
+        if (AttributeLevel_Source != info.mAttributeLevel) return false;
 
-          if (AttributeLevel_Media != info.mAttributeLevel) continue;
-
-          // scope: process line
+        // scope: process line
+        {
+          switch (info.mLineType)
           {
-            switch (info.mLineType)
-            {
-              case LineType_Unknown:                goto remove_line;
-
-              case LineType_v_Version:              continue;
-              case LineType_o_Origin:               continue;
-              case LineType_s_SessionName:          continue;
-              case LineType_b_Bandwidth:            {
-                auto bline = ZS_DYNAMIC_PTR_CAST(BLine, info.mLineValue);
-                ORTC_THROW_INVALID_PARAMETERS_IF(!bline->mMLine);
-                bline->mMLine->mBLines.push_back(bline);
-                bline->mMLine.reset();  // no longer point back to mline
-                goto remove_line;
-              }
-              case LineType_t_Timing:               continue;
-              case LineType_a_Attributes:           break;
-              case LineType_m_MediaLine:            continue;
-              case LineType_c_ConnectionDataLine:   {
-                auto cline = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
-                ORTC_THROW_INVALID_PARAMETERS_IF(!cline->mMLine);
-                ORTC_THROW_INVALID_PARAMETERS_IF((bool)cline->mMLine->mCLine);
-                cline->mMLine->mCLine = cline;
-                cline->mMLine.reset();  // no longer point back to mline
-                goto remove_line;
-              }
-            }
-
-            auto mediaLine = ZS_DYNAMIC_PTR_CAST(AMediaLine, info.mLineValue);
-            ZS_THROW_INVALID_ASSUMPTION_IF(!mediaLine);
-
-            MLinePtr mline = mediaLine->mMLine;
-            mediaLine->mMLine.reset();
-
-            ORTC_THROW_INVALID_PARAMETERS_IF(!mline);
-
-            switch (info.mAttribute)
-            {
-              case Attribute_Unknown:           break;
-
-              case Attribute_Group:             continue;
-              case Attribute_BundleOnly:        continue;
-              case Attribute_MSID:              {
-                mline->mAMSIDLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_MSIDSemantic:      continue;
-              case Attribute_ICEUFrag:          {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEUFragLine);
-                mline->mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_ICEPwd:            {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEPwdLine);
-                mline->mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_ICEOptions:        continue;
-              case Attribute_ICELite:           continue;
-              case Attribute_Candidate:         {
-                mline->mACandidateLines.push_back(ZS_DYNAMIC_PTR_CAST(ACandidateLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_EndOfCandidates:   continue;
-              case Attribute_Fingerprint:       {
-                mline->mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_Crypto:            {
-                mline->mACryptoLines.push_back(ZS_DYNAMIC_PTR_CAST(ACryptoLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_Setup:             {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASetupLine);
-                mline->mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_MID:               {
-                // NOTE: While technically a=mid is allowed multiple times, within
-                // the context of the jsep draft it's only every used once and
-                // mid would get confused if more than value was present thus
-                // make it illegal.
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMIDLine);
-                mline->mAMIDLine = ZS_DYNAMIC_PTR_CAST(AMIDLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_Extmap:            {
-                mline->mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_SendRecv:          continue;
-              case Attribute_SendOnly:          continue;
-              case Attribute_RecvOnly:          continue;
-              case Attribute_Inactive:          continue;
-              case Attribute_RTPMap:            {
-                mline->mARTPMapLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTPMapLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attirbute_FMTP:              {
-                mline->mAFMTPLines.push_back(ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_RTCP:              {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mARTCPLine);
-                mline->mARTCPLine = ZS_DYNAMIC_PTR_CAST(ARTCPLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_RTCPMux:           continue;
-              case Attribute_RTCPFB:            {
-                mline->mARTCPFBLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTCPFBLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_RTCPRSize:         continue;
-              case Attribute_PTime:             {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAPTimeLine);
-                mline->mAPTimeLine = ZS_DYNAMIC_PTR_CAST(APTimeLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_MaxPTime:          {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxPTimeLine);
-                mline->mAMaxPTimeLine = ZS_DYNAMIC_PTR_CAST(AMaxPTimeLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_SSRC:              {
-                mline->mASSRCLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_SSRCGroup:         {
-                mline->mASSRCGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCGroupLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_Simulcast:         {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASimulcastLine);
-                mline->mASimulcastLine = ZS_DYNAMIC_PTR_CAST(ASimulcastLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_RID:               {
-                mline->mARIDLines.push_back(ZS_DYNAMIC_PTR_CAST(ARIDLine, info.mLineValue));
-                goto remove_line;
-              }
-              case Attribute_SCTPPort:          {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASCTPPortLine);
-                mline->mASCTPPortLine = ZS_DYNAMIC_PTR_CAST(ASCTPPortLine, info.mLineValue);
-                goto remove_line;
-              }
-              case Attribute_MaxMessageSize: {
-                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxMessageSize);
-                mline->mAMaxMessageSize = ZS_DYNAMIC_PTR_CAST(AMaxMessageSizeLine, info.mLineValue);
-                goto remove_line;
-              }
-            }
+            case LineType_Unknown:                return true;
+
+            case LineType_v_Version:              return false;
+            case LineType_o_Origin:               return false;
+            case LineType_s_SessionName:          return false;
+            case LineType_b_Bandwidth:            return false;
+            case LineType_t_Timing:               return false;
+            case LineType_a_Attributes:           break;
+            case LineType_m_MediaLine:            return false;
+            case LineType_c_ConnectionDataLine:   return false;
           }
-          continue;
 
-        remove_line:
+          switch (info.mAttribute)
           {
-            // no longer need to process this line
-            sdp.mLineInfos.erase(current);
+            case Attribute_Unknown:           break;
+
+            case Attribute_Group:             return false;
+            case Attribute_BundleOnly:        return false;
+            case Attribute_MSID:              return false;
+            case Attribute_MSIDSemantic:      return false;
+            case Attribute_ICEUFrag:          return false;
+            case Attribute_ICEPwd:            return false;
+            case Attribute_ICEOptions:        return false;
+            case Attribute_ICELite:           return false;
+            case Attribute_Candidate:         return false;
+            case Attribute_EndOfCandidates:   return false;
+            case Attribute_Fingerprint:       return false;
+            case Attribute_Crypto:            return false;
+            case Attribute_Setup:             return false;
+            case Attribute_MID:               return false;
+            case Attribute_Extmap:            return false;
+            case Attribute_SendRecv:          return false;
+            case Attribute_SendOnly:          return false;
+            case Attribute_RecvOnly:          return false;
+            case Attribute_Inactive:          return false;
+            case Attribute_RTPMap:            return false;
+            case Attirbute_FMTP:              {
+              auto fmtpLine = ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue);
+              ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mMLine);
+              ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mSourceLine);
+              fmtpLine->mSourceLine->mAFMTPLines.push_back(fmtpLine);
+
+              // no longer point back to mline or source line
+              fmtpLine->mMLine.reset();
+              fmtpLine->mSourceLine.reset();
+              return true;
+            }
+            case Attribute_RTCP:              return false;
+            case Attribute_RTCPMux:           return false;
+            case Attribute_RTCPFB:            return false;
+            case Attribute_RTCPRSize:         return false;
+            case Attribute_PTime:             return false;
+            case Attribute_MaxPTime:          return false;
+            case Attribute_SSRC:              return false;
+            case Attribute_SSRCGroup:         return false;
+            case Attribute_Simulcast:         return false;
+            case Attribute_RID:               return false;
+            case Attribute_SCTPPort:          return false;
+            case Attribute_MaxMessageSize:    return false;
           }
         }
+
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void SDPParser::processSourceLevelValues(SDP &sdp)
+      ISDPTypes::SDPPtr SDPParser::parse(const char *blob)
       {
-        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
-        {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
+        if (!blob) return SDPPtr();
 
-          auto &info = (*current);
+        SDPPtr sdp(make_shared<SDP>());
 
-          if (AttributeLevel_Source != info.mAttributeLevel) continue;
+        // the blob is copied exactly once; lines and attribute names are
+        // terminated in place and every line value points into this buffer
+        size_t length = strlen(blob);
+        sdp->mRawBuffer = std::unique_ptr<char[]>(new char[length+1]);
+        memcpy(sdp->mRawBuffer.get(), blob, sizeof(char)*(length+1));
 
-          // scope: process line
-          {
-            switch (info.mLineType)
-            {
-              case LineType_Unknown:                goto remove_line;
-
-              case LineType_v_Version:              continue;
-              case LineType_o_Origin:               continue;
-              case LineType_s_SessionName:          continue;
-              case LineType_b_Bandwidth:            continue;
-              case LineType_t_Timing:               continue;
-              case LineType_a_Attributes:           break;
-              case LineType_m_MediaLine:            continue;
-              case LineType_c_ConnectionDataLine:   continue;
-            }
-
-            switch (info.mAttribute)
-            {
-              case Attribute_Unknown:           break;
-
-              case Attribute_Group:             continue;
-              case Attribute_BundleOnly:        continue;
-              case Attribute_MSID:              continue;
-              case Attribute_MSIDSemantic:      continue;
-              case Attribute_ICEUFrag:          continue;
-              case Attribute_ICEPwd:            continue;
-              case Attribute_ICEOptions:        continue;
-              case Attribute_ICELite:           continue;
-              case Attribute_Candidate:         continue;
-              case Attribute_EndOfCandidates:   continue;
-              case Attribute_Fingerprint:       continue;
-              case Attribute_Crypto:            continue;
-              case Attribute_Setup:             continue;
-              case Attribute_MID:               continue;
-              case Attribute_Extmap:            continue;
-              case Attribute_SendRecv:          continue;
-              case Attribute_SendOnly:          continue;
-              case Attribute_RecvOnly:          continue;
-              case Attribute_Inactive:          continue;
-              case Attribute_RTPMap:            continue;
-              case Attirbute_FMTP:              {
-                auto fmtpLine = ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue);
-                ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mMLine);
-                ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mSourceLine);
-                fmtpLine->mSourceLine->mAFMTPLines.push_back(fmtpLine);
-
-                // no longer point back to mline or source line
-                fmtpLine->mMLine.reset();
-                fmtpLine->mSourceLine.reset();
-                goto remove_line;
-              }
-              case Attribute_RTCP:              continue;
-              case Attribute_RTCPMux:           continue;
-              case Attribute_RTCPFB:            continue;
-              case Attribute_RTCPRSize:         continue;
-              case Attribute_PTime:             continue;
-              case Attribute_MaxPTime:          continue;
-              case Attribute_SSRC:              continue;
-              case Attribute_SSRCGroup:         continue;
-              case Attribute_Simulcast:         continue;
-              case Attribute_RID:               continue;
-              case Attribute_SCTPPort:          continue;
-              case Attribute_MaxMessageSize:    continue;
-            }
-          }
+        sdp->mLineArena = make_shared<LineArena>();
 
-          continue;
+        try {
+          AttributeLevels currentLevel = AttributeLevel_Session;
+          MLinePtr currentMLine;
+          ASSRCLinePtr currentSourceLine;
 
-        remove_line:
+          char *pos = sdp->mRawBuffer.get();
+
+          // single pass: each line is tokenized, validated, parsed and then
+          // attached to its session, media or source owner before the next
+          // line is looked at
+          QWORD sessionDigest {};
+
+          LineTypeInfo info;
+          while (parseLine(pos, info))
           {
-            // no longer need to process this line
-            sdp.mLineInfos.erase(current);
-          }
-        }
-      }
+            // digested before attribute parsing terminates tokens in place
+            QWORD lineDigest = digestLine(info);
 
-      //-----------------------------------------------------------------------
-      ISDPTypes::SDPPtr SDPParser::parse(const char *blob)
-      {
-        if (!blob) return SDPPtr();
+            if (LineType_a_Attributes == info.mLineType) parseAttribute(info);
 
-        SDPPtr sdp(make_shared<SDP>());
+            validateAttributeLevel(info, currentLevel);
+            parseLineDetails(*sdp, info, currentMLine, currentSourceLine);
 
-        sdp->mOriginal = String(blob);
-        std::unique_ptr<char[]> rawBuffer(new char[sdp->mOriginal.length()+1]);
-        sdp->mRawBuffer = std::move(rawBuffer);
+            if (LineType_m_MediaLine == info.mLineType) {
+              currentMLine->mSectionDigest = combineDigest(sessionDigest, lineDigest);
+            } else if (currentMLine) {
+              currentMLine->mSectionDigest = combineDigest(currentMLine->mSectionDigest, lineDigest);
+            } else if (isSectionDependency(info)) {
+              sessionDigest = combineDigest(sessionDigest, lineDigest);
+            }
 
-        memset(sdp->mRawBuffer.get(), 0, sizeof(char)*(sdp->mOriginal.length()+1));
-        memcpy(sdp->mRawBuffer.get(), blob, sizeof(char)*(sdp->mOriginal.length()));
+            if (processFlagAttribute(*sdp, info)) continue;
+            if (processSessionLevelValue(*sdp, info)) continue;
+            if (processMediaLevelValue(*sdp, info)) continue;
+            if (processSourceLevelValue(*sdp, info)) continue;
 
-        try {
-          parseLines(*sdp);
-          parseAttributes(*sdp);
-          validateAttributeLevels(*sdp);
-          parseLinesDetails(*sdp);
-          processFlagAttributes(*sdp);
-          processSessionLevelValues(*sdp);
-          processMediaLevelValues(*sdp);
-          processSourceLevelValues(*sdp);
+            sdp->mLineInfos.push_back(info);
+          }
         } catch (const SafeIntException &e) {
           ORTC_THROW_INVALID_PARAMETERS("value found out of legal value range" + string(e.m_code));
         }
@@ -220,6 +220,23 @@ namespace ortc
         return mFormattedString;
       }
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SessionDescription => (for PeerConnection)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      ISDPTypes::SDPPtr SessionDescription::sdp() const
+      {
+        description();
+
+        AutoRecursiveLock lock(*this);
+        return mSDP;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -33,6 +33,7 @@
 
 
 #include <ortc/adapter/internal/types.h>
+#include <ortc/adapter/internal/ortc_adapter_SDPParser.h>
 
 #include <ortc/internal/ortc_StatsReport.h>
 
@@ -184,9 +185,14 @@ namespace ortc
           struct Details
           {
             IICEGathererPtr mGatherer;
+            IICEGathererSubscriptionPtr mGathererSubscription;
             IICETransportPtr mTransport;
             bool mRTPEndOfCandidates {false};
 
+            bool mPooledGatherer {false};
+            Time mGatherStarted;
+            bool mFirstCandidateReported {false};
+
             IDTLSTransportPtr mDTLSTransport;
             ISRTPSDESTransportPtr mSRTPSDESTransport;
             ISRTPSDESTransportTypes::ParametersPtr mSRTPSDESParameters;
@@ -321,8 +327,44 @@ namespace ortc
           ElementPtr toDebug() const;
         };
 
+        struct RemoteDescriptionHashes
+        {
+          struct Entry
+          {
+            QWORD mSectionDigest {};  // 0 = not parsed from an sdp section
+            String mLinkage;          // ids referenced outside its section
+            String mHash;
+          };
+
+          typedef std::map<String, Entry> HashMap;
+
+          HashMap mTransports;
+          HashMap mRTPMediaLines;
+          HashMap mSCTPMediaLines;
+          HashMap mSenders;
+        };
+
+        struct RemoteDescriptionDiff
+        {
+          typedef std::set<String> IDSet;
+
+          // added or changed since the last applied remote description (the
+          // steps also add anything they re-process so dependants follow)
+          IDSet mTransports;
+          IDSet mRTPMediaLines;
+          IDSet mSCTPMediaLines;
+          IDSet mSenders;
+
+          IDSet mRemovedSenders;
+
+          size_t mTotalHashed {};   // entries whose section had to be hashed
+
+          ElementPtr toDebug() const;
+        };
+
         typedef std::map<TransportID, TransportInfoPtr> TransportInfoMap;
         typedef std::list<TransportInfoPtr> TransportList;
+        typedef std::map<PUID, TransportInfoPtr> GathererTransportMap;
         typedef std::map<MediaLineID, RTPMediaLineInfoPtr> RTPMediaLineInfoMap;
         typedef std::map<MediaLineID, SCTPMediaLineInfoPtr> SCTPMediaLineInfoMap;
         typedef std::map<SenderID, SenderInfoPtr> SenderInfoMap;
@@ -631,10 +673,23 @@ namespace ortc
         void step();
         bool stepCertificates();
         bool stepProcessRemote();
-        bool stepProcessRemoteTransport(ISessionDescriptionTypes::DescriptionPtr description);
-        bool stepProcessRemoteRTPMediaLines(ISessionDescriptionTypes::DescriptionPtr description);
-        bool stepProcessRemoteRTPSenders(ISessionDescriptionTypes::DescriptionPtr description);
-        bool stepProcessRemoteSCTPTransport(ISessionDescriptionTypes::DescriptionPtr description);
+        bool stepProcessRemoteTransport(
+                                        ISessionDescriptionTypes::DescriptionPtr description,
+                                        RemoteDescriptionDiff &ioDiff
+                                        );
+        bool stepProcessRemoteRTPMediaLines(
+                                            ISessionDescriptionTypes::DescriptionPtr description,
+                                            RemoteDescriptionDiff &ioDiff
+                                            );
+        bool stepProcessRemoteRTPSenders(
+                                         ISessionDescriptionTypes::DescriptionPtr description,
+                                         RemoteDescriptionDiff &ioDiff
+                                         );
+        bool stepProcessRemoteSCTPTransport(
+                                            ISessionDescriptionTypes::DescriptionPtr description,
+                                            RemoteDescriptionDiff &ioDiff
+                                            );
+        bool stepProcessRemoteRemovedSenders(const RemoteDescriptionDiff &diff);
         bool stepProcessLocal();
         bool stepProcessLocalTransport(ISessionDescriptionTypes::DescriptionPtr description);
         bool stepProcessLocalRTPMediaLines(ISessionDescriptionTypes::DescriptionPtr description);
@@ -662,6 +717,7 @@ namespace ortc
 
         TransportInfoPtr getTransportFromPool(const char *useID = NULL);
         void addToTransportPool();
+        void notifyFirstCandidate(IICEGathererPtr gatherer);
 
         String registerNewID(size_t length = 3);
         String registerIDUsage(const char *idStr);
@@ -705,6 +761,17 @@ namespace ortc
                                    MediaStreamSet &outAdded,
                                    MediaStreamSet &outRemoved
                                    );
+        static void calculateRemoteDiff(
+                                        const ISessionDescriptionTypes::Description &description,
+                                        ISDPTypes::SDPPtr sdp,
+                                        const RemoteDescriptionHashes &existingHashes,
+                                        RemoteDescriptionHashes &outHashes,
+                                        RemoteDescriptionDiff &outDiff
+                                        );
+        static bool isSettled(NegotiationStates state);
+        bool isSettled(const TransportInfo &transportInfo) const;
+        bool isSettled(const MediaLineInfo &mediaLineInfo) const;
+        bool isSettled(const ReceiverInfo &receiverInfo) const;
 
         static IDTLSTransportTypes::ParametersPtr getDTLSParameters(
                                                                     const TransportInfo &transportInfo,
@@ -743,6 +810,7 @@ namespace ortc
 
         ISessionDescriptionPtr mRemoteDescription;
         ISessionDescriptionPtr mPendingRemoteDescription;
+        RemoteDescriptionHashes mRemoteHashes;
 
         PendingMethodList mPendingMethods;
         PendingAddTrackList mAddedPendingAddTracks;
@@ -760,6 +828,7 @@ namespace ortc
         CandidateList mPendingRemoteCandidates;
 
         TransportList mTransportPool;
+        GathererTransportMap mPendingFirstCandidates;   // by RTP gatherer until its first candidate
 
         IDMap mExistingIDs;
         PortSet mExistingLocalPorts;
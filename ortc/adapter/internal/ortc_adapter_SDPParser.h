@@ -68,6 +68,7 @@ namespace ortc
         ZS_DECLARE_TYPEDEF_PTR(std::list<String>, StringList);
 
         ZS_DECLARE_STRUCT_PTR(LineTypeInfo);
+        ZS_DECLARE_CLASS_PTR(LineArena);
         ZS_DECLARE_STRUCT_PTR(SDP);
         ZS_DECLARE_STRUCT_PTR(LineValue);
         ZS_DECLARE_STRUCT_PTR(MediaLine);
@@ -186,6 +187,10 @@ namespace ortc
 
         static const char *toString(Attributes attribute);
         static Attributes toAttribute(const char *attribute);
+        static Attributes toAttribute(
+                                      const char *attribute,
+                                      size_t length
+                                      );
 
         static bool requiresValue(Attributes attribute);
         static bool requiresEmptyValue(Attributes attribute);
@@ -384,6 +389,12 @@ namespace ortc
           ASCTPPortLinePtr mASCTPPortLine;
           AMaxMessageSizeLinePtr mAMaxMessageSize;
 
+          // digest of the raw m= section text seeded with the session level
+          // lines it inherits (excluding o=, a=group and a=msid-semantic
+          // which change whenever any section is added or removed); 0 when
+          // not parsed from text
+          QWORD mSectionDigest {};
+
           BLineList mBLines;
           AMSIDLineList mAMSIDLines;
           ACandidateLineList mACandidateLines;
@@ -793,10 +804,58 @@ namespace ortc
           ElementPtr toDebug();
         };
 
+        //---------------------------------------------------------------------
+        // Bump allocator backing the line structs created while parsing one
+        // SDP. Memory is never returned individually; the arena is released
+        // once the last line allocated from it is destroyed.
+        class LineArena
+        {
+        public:
+          enum Sizes
+          {
+            Size_Block = 16 * 1024,
+          };
+
+        public:
+          void *allocate(
+                         size_t size,
+                         size_t alignment
+                         );
+
+        protected:
+          typedef std::unique_ptr<BYTE[]> Block;
+          typedef std::list<Block> BlockList;
+
+          BlockList mBlocks;
+          BYTE *mPos {};
+          size_t mAvailable {};
+        };
+
+        //---------------------------------------------------------------------
+        template <typename T>
+        struct LineAllocator
+        {
+          typedef T value_type;
+
+          LineArenaPtr mArena;
+
+          LineAllocator(LineArenaPtr arena) : mArena(arena) {}
+          template <typename U>
+          LineAllocator(const LineAllocator<U> &other) : mArena(other.mArena) {}
+
+          T *allocate(size_t total) { return static_cast<T *>(mArena->allocate(sizeof(T) * total, alignof(T))); }
+          void deallocate(T *, size_t) {}
+
+          template <typename U>
+          bool operator==(const LineAllocator<U> &other) const { return mArena == other.mArena; }
+          template <typename U>
+          bool operator!=(const LineAllocator<U> &other) const { return mArena != other.mArena; }
+        };
+
         struct SDP
         {
-          String mOriginal;
           std::unique_ptr<char[]> mRawBuffer;
+          LineArenaPtr mLineArena;
 
           // attribute values
           Optional<Directions> mMediaDirection;
@@ -843,14 +902,46 @@ namespace ortc
         };
 
       protected:
-        static void parseLines(SDP &sdp);
-        static void parseAttributes(SDP &sdp);
-        static void validateAttributeLevels(SDP &sdp);
-        static void parseLinesDetails(SDP &sdp);
-        static void processFlagAttributes(SDP &sdp);
-        static void processSessionLevelValues(SDP &sdp);
-        static void processMediaLevelValues(SDP &sdp);
-        static void processSourceLevelValues(SDP &sdp);
+        template <typename LineType, typename... Args>
+        static std::shared_ptr<LineType> createLine(
+                                                    SDP &sdp,
+                                                    Args&&... args
+                                                    )
+        {
+          return std::allocate_shared<LineType>(LineAllocator<LineType>(sdp.mLineArena), std::forward<Args>(args)...);
+        }
+
+        static bool parseLine(
+                              char * &ioPos,
+                              LineTypeInfo &outInfo
+                              );
+        static void parseAttribute(LineTypeInfo &info);
+        static void validateAttributeLevel(
+                                           LineTypeInfo &info,
+                                           AttributeLevels &currentLevel
+                                           );
+        static void parseLineDetails(
+                                     SDP &sdp,
+                                     LineTypeInfo &info,
+                                     MLinePtr &currentMLine,
+                                     ASSRCLinePtr &currentSourceLine
+                                     );
+        static bool processFlagAttribute(
+                                         SDP &sdp,
+                                         LineTypeInfo &info
+                                         );
+        static bool processSessionLevelValue(
+                                             SDP &sdp,
+                                             LineTypeInfo &info
+                                             );
+        static bool processMediaLevelValue(
+                                           SDP &sdp,
+                                           LineTypeInfo &info
+                                           );
+        static bool processSourceLevelValue(
+                                            SDP &sdp,
+                                            LineTypeInfo &info
+                                            );
 
         static void createDescriptionDetails(
                                              const SDP &sdp,
@@ -93,6 +93,13 @@ namespace ortc
         virtual DescriptionPtr description() const override;
         virtual SignalingDescription formattedDescription() const override;
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark SessionDescription => (for PeerConnection)
+        #pragma mark
+
+        ISDPTypes::SDPPtr sdp() const;
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
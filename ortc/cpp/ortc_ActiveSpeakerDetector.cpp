@@ -0,0 +1,780 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_ActiveSpeakerDetector.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpreceiver) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ActiveSpeakerDetectorSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetectorSettingsDefaults
+    #pragma mark
+
+    class ActiveSpeakerDetectorSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~ActiveSpeakerDetectorSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static ActiveSpeakerDetectorSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<ActiveSpeakerDetectorSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static ActiveSpeakerDetectorSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<ActiveSpeakerDetectorSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_EVALUATION_INTERVAL_IN_MILLISECONDS, 200);
+        ISettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SILENCE_LEVEL, 70);
+        ISettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SWITCH_MARGIN, 6);
+        ISettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_MIN_HOLD_IN_MILLISECONDS, 1000);
+        ISettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_STREAM_TIMEOUT_IN_MILLISECONDS, 2000);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installActiveSpeakerDetectorSettingsDefaults()
+    {
+      ActiveSpeakerDetectorSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static BYTE toLoudness(BYTE level)
+    {
+      // RFC 6464 levels are expressed in -dBov (0 = loudest, 127 = silence)
+      if (level > 127) level = 127;
+      return static_cast<BYTE>(127 - level);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IActiveSpeakerDetectorForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IActiveSpeakerDetectorForRTPReceiver::toDebug(ForRTPReceiverPtr detector)
+    {
+      if (!detector) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(ActiveSpeakerDetector, detector)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector::StreamInfo
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetector::StreamInfo::StreamInfo()
+    {
+      memset(&(mLoudness[0]), 0, sizeof(mLoudness));
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::StreamInfo::add(BYTE loudness)
+    {
+      if (mFilled < kLevelHistory) {
+        ++mFilled;
+      } else {
+        mSum -= mLoudness[mNext];
+      }
+
+      mLoudness[mNext] = loudness;
+      mSum += loudness;
+      mNext = (mNext + 1) % kLevelHistory;
+    }
+
+    //-------------------------------------------------------------------------
+    BYTE ActiveSpeakerDetector::StreamInfo::average() const
+    {
+      if (0 == mFilled) return 0;
+      return static_cast<BYTE>(mSum / static_cast<DWORD>(mFilled));
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ActiveSpeakerDetector::StreamInfo::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ActiveSpeakerDetector::StreamInfo");
+
+      IHelper::debugAppend(resultEl, "receiver", mKey.first);
+      IHelper::debugAppend(resultEl, "ssrc", mKey.second);
+      IHelper::debugAppend(resultEl, "slot", mSlot);
+      IHelper::debugAppend(resultEl, "last received", mLastReceived);
+      IHelper::debugAppend(resultEl, "history", mFilled);
+      IHelper::debugAppend(resultEl, "average loudness", static_cast<int>(average()));
+      IHelper::debugAppend(resultEl, "total packets", mTotalPackets);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetector::ActiveSpeakerDetector(
+                                                 const make_private &,
+                                                 IMessageQueuePtr queue,
+                                                 IActiveSpeakerDetectorDelegatePtr originalDelegate
+                                                 ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mEvaluationInterval(ISettings::getUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_EVALUATION_INTERVAL_IN_MILLISECONDS)),
+      mSwitchMargin(static_cast<BYTE>(std::min<ULONG>(ISettings::getUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SWITCH_MARGIN), 127))),
+      mMinHold(ISettings::getUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_MIN_HOLD_IN_MILLISECONDS)),
+      mStreamTimeout(ISettings::getUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_STREAM_TIMEOUT_IN_MILLISECONDS))
+    {
+      ZS_LOG_DETAIL(debug("created"))
+
+      mSilenceLoudness = toLoudness(static_cast<BYTE>(std::min<ULONG>(ISettings::getUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SILENCE_LEVEL), 127)));
+
+      if (mEvaluationInterval < Milliseconds(10)) mEvaluationInterval = Milliseconds(10);
+
+      if (originalDelegate) {
+        mDefaultSubscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::init()
+    {
+      AutoRecursiveLock lock(*this);
+      mEvaluationTimer = ITimer::create(mThisWeak.lock(), mEvaluationInterval);
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetector::~ActiveSpeakerDetector()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetectorPtr ActiveSpeakerDetector::convert(IActiveSpeakerDetectorPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(ActiveSpeakerDetector, object);
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetectorPtr ActiveSpeakerDetector::convert(ForRTPReceiverPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(ActiveSpeakerDetector, object);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector => IActiveSpeakerDetector
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ActiveSpeakerDetector::toDebug(ActiveSpeakerDetectorPtr detector)
+    {
+      if (!detector) return ElementPtr();
+      return detector->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetectorPtr ActiveSpeakerDetector::create(IActiveSpeakerDetectorDelegatePtr delegate)
+    {
+      ActiveSpeakerDetectorPtr pThis(make_shared<ActiveSpeakerDetector>(make_private {}, IORTCForInternal::queueORTC(), delegate));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    IActiveSpeakerDetectorSubscriptionPtr ActiveSpeakerDetector::subscribe(IActiveSpeakerDetectorDelegatePtr originalDelegate)
+    {
+      ZS_LOG_DETAIL(log("subscribing to active speaker detector"));
+
+      AutoRecursiveLock lock(*this);
+      if (!originalDelegate) return mDefaultSubscription;
+
+      IActiveSpeakerDetectorSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
+
+      IActiveSpeakerDetectorDelegatePtr delegate = mSubscriptions.delegate(subscription, true);
+
+      if (delegate) {
+        ActiveSpeakerDetectorPtr pThis = mThisWeak.lock();
+
+        if (mDominant.hasValue()) {
+          auto found = mStreams.find(mDominant.value());
+          if (found != mStreams.end()) {
+            delegate->onActiveSpeakerDetectorDominantSpeakerChanged(pThis, createSpeaker(*((*found).second)));
+          }
+        }
+      }
+
+      if (mShutdown) {
+        mSubscriptions.clear();
+      }
+
+      return subscription;
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::addReceiver(IRTPReceiverPtr receiver) throw (
+                                                                             InvalidParameters,
+                                                                             InvalidStateError
+                                                                             )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!receiver)
+
+      UseReceiverPtr useReceiver = RTPReceiver::convert(receiver);
+      ORTC_THROW_INVALID_PARAMETERS_IF(!useReceiver)
+
+      {
+        AutoRecursiveLock lock(*this);
+        ORTC_THROW_INVALID_STATE_IF(mShutdown)
+
+        if (mReceivers.end() != mReceivers.find(useReceiver->getID())) {
+          ZS_LOG_DEBUG(log("receiver is already being monitored") + ZS_PARAM("receiver", useReceiver->getID()))
+          return;
+        }
+      }
+
+      // NOTE: registration is done outside the lock as the receiver notifies
+      //       the detector after releasing its own lock
+      bool registered = useReceiver->registerActiveSpeakerDetector(mThisWeak.lock());
+      ORTC_THROW_INVALID_PARAMETERS_IF(!registered)
+
+      AutoRecursiveLock lock(*this);
+      if (mShutdown) {
+        useReceiver->unregisterActiveSpeakerDetector(mID);
+        ORTC_THROW_INVALID_STATE("active speaker detector was stopped")
+      }
+
+      mReceivers[useReceiver->getID()] = useReceiver;
+
+      ZS_LOG_DEBUG(log("added monitored receiver") + ZS_PARAM("receiver", useReceiver->getID()))
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::removeReceiver(IRTPReceiverPtr receiver)
+    {
+      if (!receiver) return;
+
+      UseReceiverPtr useReceiver;
+      PUID receiverID = receiver->getID();
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mReceivers.find(receiverID);
+        if (found == mReceivers.end()) {
+          ZS_LOG_WARNING(Debug, log("receiver is not being monitored") + ZS_PARAM("receiver", receiverID))
+          return;
+        }
+
+        useReceiver = (*found).second.lock();
+        mReceivers.erase(found);
+
+        for (auto iter_doNotUse = mStreams.begin(); iter_doNotUse != mStreams.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          if ((*current).first.first != receiverID) continue;
+          releaseSlot((*current).second->mSlot);
+          mStreams.erase(current);
+        }
+
+        ZS_LOG_DEBUG(log("removed monitored receiver") + ZS_PARAM("receiver", receiverID))
+      }
+
+      if (useReceiver) useReceiver->unregisterActiveSpeakerDetector(mID);
+    }
+
+    //-------------------------------------------------------------------------
+    IActiveSpeakerDetectorTypes::SpeakerPtr ActiveSpeakerDetector::getDominantSpeaker() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      if (!mDominant.hasValue()) return SpeakerPtr();
+
+      auto found = mStreams.find(mDominant.value());
+      if (found == mStreams.end()) return SpeakerPtr();
+
+      return createSpeaker(*((*found).second));
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::stop()
+    {
+      ZS_LOG_DEBUG(log("stop called"))
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector => IActiveSpeakerDetectorForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::notifyAudioLevel(
+                                                 PUID receiverID,
+                                                 SSRCType ssrc,
+                                                 BYTE level,
+                                                 const Optional<bool> &voiceActivity
+                                                 )
+    {
+      // NOTE: called for every audio packet of every monitored stream so
+      //       only the stream's slot totals are updated here (without the
+      //       detector lock); the totals are drained and the dominant speaker
+      //       is re-evaluated on a timer
+      BYTE loudness = ((voiceActivity.hasValue()) && (!voiceActivity.value())) ? 0 : toLoudness(level);
+
+      StreamSlot *slot = findSlot(receiverID, ssrc);
+      if (!slot) {
+        ZS_LOG_TRACE(log("no free stream slot (audio level ignored)") + ZS_PARAM("receiver", receiverID) + ZS_PARAM("ssrc", ssrc))
+        return;
+      }
+
+      slot->mTotals.fetch_add((static_cast<QWORD>(1) << 32) | static_cast<QWORD>(loudness), std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_TRACE(log("timer") + ZS_PARAM("timer id", timer->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      if (timer != mEvaluationTimer) {
+        ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+        return;
+      }
+
+      evaluate();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ActiveSpeakerDetector::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::ActiveSpeakerDetector");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ActiveSpeakerDetector::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ActiveSpeakerDetector::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::ActiveSpeakerDetector");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "subscribers", mSubscriptions.size());
+      IHelper::debugAppend(resultEl, "default subscription", (bool)mDefaultSubscription);
+
+      IHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+      IHelper::debugAppend(resultEl, "receivers", mReceivers.size());
+      IHelper::debugAppend(resultEl, "streams", mStreams.size());
+
+      IHelper::debugAppend(resultEl, "evaluation timer", mEvaluationTimer ? mEvaluationTimer->getID() : 0);
+      IHelper::debugAppend(resultEl, "evaluation interval", mEvaluationInterval);
+      IHelper::debugAppend(resultEl, "silence loudness", static_cast<int>(mSilenceLoudness));
+      IHelper::debugAppend(resultEl, "switch margin", static_cast<int>(mSwitchMargin));
+      IHelper::debugAppend(resultEl, "min hold", mMinHold);
+      IHelper::debugAppend(resultEl, "stream timeout", mStreamTimeout);
+
+      IHelper::debugAppend(resultEl, "dominant receiver", mDominant.hasValue() ? mDominant.value().first : 0);
+      IHelper::debugAppend(resultEl, "dominant ssrc", mDominant.hasValue() ? mDominant.value().second : 0);
+      IHelper::debugAppend(resultEl, "dominant since", mDominantSince);
+      IHelper::debugAppend(resultEl, "total switches", mTotalSwitches);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::cancel()
+    {
+      ReceiverWeakMap receivers;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) return;
+        mShutdown = true;
+
+        if (mEvaluationTimer) {
+          mEvaluationTimer->cancel();
+          mEvaluationTimer.reset();
+        }
+
+        receivers = mReceivers;
+
+        mReceivers.clear();
+        mStreams.clear();
+        for (size_t index = 0; index < kMaxStreamSlots; ++index) {
+          releaseSlot(index);
+        }
+        mDominant = Optional<StreamKey>();
+
+        mSubscriptions.clear();
+
+        if (mDefaultSubscription) {
+          mDefaultSubscription->cancel();
+          mDefaultSubscription.reset();
+        }
+      }
+
+      for (auto iter = receivers.begin(); iter != receivers.end(); ++iter) {
+        auto receiver = (*iter).second.lock();
+        if (!receiver) continue;
+        receiver->unregisterActiveSpeakerDetector(mID);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetector::StreamSlot *ActiveSpeakerDetector::findSlot(
+                                                                       PUID receiverID,
+                                                                       SSRCType ssrc
+                                                                       )
+    {
+      size_t start = static_cast<size_t>((receiverID * 31) + static_cast<PUID>(ssrc)) % kMaxStreamSlots;
+
+      // released slots leave holes in the probe sequence so every slot is
+      // checked before deciding the stream is new
+      for (size_t probe = 0; probe < kMaxStreamSlots; ++probe) {
+        auto &slot = mSlots[(start + probe) % kMaxStreamSlots];
+        if (SlotState_Active != slot.mState.load(std::memory_order_acquire)) continue;
+        if (slot.mReceiverID.load(std::memory_order_relaxed) != receiverID) continue;
+        if (slot.mSSRC.load(std::memory_order_relaxed) != ssrc) continue;
+        return &slot;
+      }
+
+      for (size_t probe = 0; probe < kMaxStreamSlots; ++probe) {
+        auto &slot = mSlots[(start + probe) % kMaxStreamSlots];
+
+        DWORD expected = SlotState_Free;
+        if (!slot.mState.compare_exchange_strong(expected, SlotState_Claiming, std::memory_order_acq_rel)) continue;
+
+        slot.mReceiverID.store(receiverID, std::memory_order_relaxed);
+        slot.mSSRC.store(ssrc, std::memory_order_relaxed);
+        slot.mTotals.store(0, std::memory_order_relaxed);
+        slot.mState.store(SlotState_Active, std::memory_order_release);
+        return &slot;
+      }
+
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::releaseSlot(size_t index)
+    {
+      auto &slot = mSlots[index];
+
+      // NOTE: a receiver already past the lookup can still add a single
+      //       packet's level which the next stream claiming the slot inherits
+      slot.mTotals.store(0, std::memory_order_relaxed);
+      slot.mState.store(SlotState_Free, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::collectSlots(const Time &tick)
+    {
+      for (size_t index = 0; index < kMaxStreamSlots; ++index) {
+        auto &slot = mSlots[index];
+        if (SlotState_Active != slot.mState.load(std::memory_order_acquire)) continue;
+
+        StreamKey key(slot.mReceiverID.load(std::memory_order_relaxed), slot.mSSRC.load(std::memory_order_relaxed));
+        QWORD totals = slot.mTotals.exchange(0, std::memory_order_relaxed);
+
+        StreamInfoPtr info;
+
+        auto found = mStreams.find(key);
+        if (found == mStreams.end()) {
+          if (mReceivers.end() == mReceivers.find(key.first)) {
+            releaseSlot(index);
+            continue;
+          }
+
+          info = make_shared<StreamInfo>();
+          info->mKey = key;
+          info->mSlot = index;
+          info->mLastReceived = tick;
+          mStreams[key] = info;
+
+          ZS_LOG_DEBUG(log("monitoring new audio stream") + ZS_PARAM("receiver", key.first) + ZS_PARAM("ssrc", key.second) + ZS_PARAM("slot", index))
+        } else {
+          info = (*found).second;
+        }
+
+        DWORD packets = static_cast<DWORD>(totals >> 32);
+        if (0 != packets) {
+          info->mLastReceived = tick;
+          info->add(static_cast<BYTE>(static_cast<DWORD>(totals & 0xFFFFFFFF) / packets));
+          info->mTotalPackets += packets;
+        }
+
+        // two packets of a new stream can race to claim different slots;
+        // once one is released every later packet finds the one kept
+        if (info->mSlot != index) releaseSlot(index);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ActiveSpeakerDetector::evaluate()
+    {
+      Time tick = zsLib::now();
+
+      collectSlots(tick);
+
+      StreamInfo *loudest = NULL;
+      BYTE loudestValue = mSilenceLoudness;
+
+      for (auto iter_doNotUse = mStreams.begin(); iter_doNotUse != mStreams.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto &info = *((*current).second);
+
+        if (info.mLastReceived + mStreamTimeout < tick) {
+          ZS_LOG_DEBUG(log("audio stream expired") + info.toDebug())
+          releaseSlot(info.mSlot);
+          mStreams.erase(current);
+          continue;
+        }
+
+        BYTE value = info.average();
+        if (value <= loudestValue) continue;
+
+        loudest = &info;
+        loudestValue = value;
+      }
+
+      StreamInfo *dominant = NULL;
+      if (mDominant.hasValue()) {
+        auto found = mStreams.find(mDominant.value());
+        if (found != mStreams.end()) dominant = (*found).second.get();
+      }
+
+      if (!loudest) {
+        if ((dominant) || (!mDominant.hasValue())) return;  // keep the last speaker while everyone is silent
+
+        ZS_LOG_DEBUG(log("dominant speaker stream went away"))
+        mDominant = Optional<StreamKey>();
+        mDominantSince = tick;
+        ++mTotalSwitches;
+        mSubscriptions.delegate()->onActiveSpeakerDetectorDominantSpeakerChanged(mThisWeak.lock(), SpeakerPtr());
+        return;
+      }
+
+      if (loudest == dominant) return;
+
+      if (dominant) {
+        // hysteresis: a challenger must be clearly louder and the current
+        // speaker must have held the floor for a minimum time
+        if (static_cast<DWORD>(loudestValue) < static_cast<DWORD>(dominant->average()) + static_cast<DWORD>(mSwitchMargin)) return;
+        if (mDominantSince + mMinHold > tick) return;
+      }
+
+      mDominant = loudest->mKey;
+      mDominantSince = tick;
+      ++mTotalSwitches;
+
+      ZS_LOG_DEBUG(log("dominant speaker changed") + loudest->toDebug())
+
+      mSubscriptions.delegate()->onActiveSpeakerDetectorDominantSpeakerChanged(mThisWeak.lock(), createSpeaker(*loudest));
+    }
+
+    //-------------------------------------------------------------------------
+    IActiveSpeakerDetectorTypes::SpeakerPtr ActiveSpeakerDetector::createSpeaker(const StreamInfo &info) const
+    {
+      auto speaker = make_shared<Speaker>();
+
+      auto found = mReceivers.find(info.mKey.first);
+      if (found != mReceivers.end()) {
+        speaker->mReceiver = RTPReceiver::convert((*found).second.lock());
+      }
+      speaker->mSSRC = info.mKey.second;
+      speaker->mAudioLevel = static_cast<BYTE>(127 - info.average());
+
+      return speaker;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IActiveSpeakerDetectorFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IActiveSpeakerDetectorFactory &IActiveSpeakerDetectorFactory::singleton()
+    {
+      return ActiveSpeakerDetectorFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    ActiveSpeakerDetectorPtr IActiveSpeakerDetectorFactory::create(IActiveSpeakerDetectorDelegatePtr delegate)
+    {
+      if (this) {}
+      return internal::ActiveSpeakerDetector::create(delegate);
+    }
+
+  } // internal namespace
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetectorTypes::Speaker
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IActiveSpeakerDetectorTypes::Speaker::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IActiveSpeakerDetectorTypes::Speaker");
+
+    IHelper::debugAppend(resultEl, "receiver", mReceiver ? mReceiver->getID() : 0);
+    IHelper::debugAppend(resultEl, "ssrc", mSSRC);
+    IHelper::debugAppend(resultEl, "audio level", static_cast<int>(mAudioLevel));
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IActiveSpeakerDetector
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IActiveSpeakerDetector::toDebug(IActiveSpeakerDetectorPtr detector)
+  {
+    return internal::ActiveSpeakerDetector::toDebug(internal::ActiveSpeakerDetector::convert(detector));
+  }
+
+  //---------------------------------------------------------------------------
+  IActiveSpeakerDetectorPtr IActiveSpeakerDetector::create(IActiveSpeakerDetectorDelegatePtr delegate)
+  {
+    return internal::IActiveSpeakerDetectorFactory::singleton().create(delegate);
+  }
+
+}
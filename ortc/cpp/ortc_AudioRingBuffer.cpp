@@ -0,0 +1,169 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_AudioRingBuffer.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <cstring>
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpmediaengine) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark AudioRingBuffer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    AudioRingBuffer::AudioRingBuffer(size_t minCapacityInSamples)
+    {
+      size_t capacity = 1;
+      while (capacity < minCapacityInSamples) capacity <<= 1;
+
+      mBuffer = new int16_t[capacity];
+      mMask = capacity - 1;
+    }
+
+    //-------------------------------------------------------------------------
+    AudioRingBuffer::~AudioRingBuffer()
+    {
+      delete [] mBuffer;
+      mBuffer = NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t AudioRingBuffer::available() const
+    {
+      // positions only ever increase (wrapping is harmless as the capacity
+      // is a power of two)
+      return mWritePosition.load(std::memory_order_acquire) - mReadPosition.load(std::memory_order_acquire);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t AudioRingBuffer::space() const
+    {
+      return capacity() - available();
+    }
+
+    //-------------------------------------------------------------------------
+    size_t AudioRingBuffer::write(
+                                  const int16_t *samples,
+                                  size_t count
+                                  )
+    {
+      if ((NULL == samples) || (0 == count)) return 0;
+
+      size_t writePos = mWritePosition.load(std::memory_order_relaxed);
+      size_t readPos = mReadPosition.load(std::memory_order_acquire);
+
+      if (count > capacity() - (writePos - readPos)) return 0;
+
+      size_t offset = (writePos & mMask);
+      size_t first = capacity() - offset;
+      if (first > count) first = count;
+
+      memcpy(&(mBuffer[offset]), samples, first * sizeof(int16_t));
+      if (first < count) {
+        memcpy(&(mBuffer[0]), &(samples[first]), (count - first) * sizeof(int16_t));
+      }
+
+      mWritePosition.store(writePos + count, std::memory_order_release);
+      return count;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t AudioRingBuffer::read(
+                                 int16_t *outSamples,
+                                 size_t count
+                                 )
+    {
+      if ((NULL == outSamples) || (0 == count)) return 0;
+
+      size_t readPos = mReadPosition.load(std::memory_order_relaxed);
+      size_t writePos = mWritePosition.load(std::memory_order_acquire);
+
+      size_t total = writePos - readPos;
+      if (count > total) count = total;
+      if (0 == count) return 0;
+
+      size_t offset = (readPos & mMask);
+      size_t first = capacity() - offset;
+      if (first > count) first = count;
+
+      memcpy(outSamples, &(mBuffer[offset]), first * sizeof(int16_t));
+      if (first < count) {
+        memcpy(&(outSamples[first]), &(mBuffer[0]), (count - first) * sizeof(int16_t));
+      }
+
+      mReadPosition.store(readPos + count, std::memory_order_release);
+      return count;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t AudioRingBuffer::skip(size_t count)
+    {
+      size_t readPos = mReadPosition.load(std::memory_order_relaxed);
+      size_t writePos = mWritePosition.load(std::memory_order_acquire);
+
+      size_t total = writePos - readPos;
+      if (count > total) count = total;
+
+      mReadPosition.store(readPos + count, std::memory_order_release);
+      return count;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr AudioRingBuffer::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::AudioRingBuffer");
+
+      IHelper::debugAppend(resultEl, "capacity", capacity());
+      IHelper::debugAppend(resultEl, "available", available());
+      IHelper::debugAppend(resultEl, "written", static_cast<size_t>(mWritePosition.load()));
+      IHelper::debugAppend(resultEl, "read", static_cast<size_t>(mReadPosition.load()));
+
+      return resultEl;
+    }
+
+  } // internal namespace
+}
@@ -34,9 +34,11 @@
 #include <ortc/internal/ortc_Certificate.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_SRTPTransport.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/ISRTPSDESTransport.h>
@@ -428,7 +430,7 @@ namespace ortc
 
       // scope: setup generator
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         switch (mComponent) {
           case IICETypes::Component_RTP: {
@@ -559,6 +561,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(DTLSTransport, object);
     }
 
+    //-------------------------------------------------------------------------
+    DTLSTransportPtr DTLSTransport::convert(ForRTPCapturePtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(DTLSTransport, object);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -620,7 +628,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       IDTLSTransportSubscriptionPtr subscription = mSubscriptions.subscribe(IDTLSTransportDelegateProxy::create(IORTCForInternal::queueDelegate(), originalDelegate));
@@ -645,7 +653,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     DTLSTransport::CertificateListPtr DTLSTransport::certificates() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       CertificateListPtr result(make_shared<CertificateList>());
 
       for (auto iter = mCertificates.begin(); iter != mCertificates.end(); ++iter) {
@@ -660,21 +668,21 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETransportPtr DTLSTransport::transport() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return ICETransport::convert(mICETransport);
     }
 
     //-------------------------------------------------------------------------
     IDTLSTransportTypes::States DTLSTransport::state() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mCurrentState;
     }
 
     //-------------------------------------------------------------------------
     IDTLSTransportTypes::ParametersPtr DTLSTransport::getLocalParameters() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ParametersPtr result(make_shared<Parameters>(mLocalParams));
       return result;
@@ -683,7 +691,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IDTLSTransportTypes::ParametersPtr DTLSTransport::getRemoteParameters() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ParametersPtr result(make_shared<Parameters>(mRemoteParams));
       return result;
@@ -692,7 +700,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IDTLSTransportTypes::SecureByteBlockListPtr DTLSTransport::getRemoteCertificates() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 #define TODO_COMPLETE_ONCE_ORTC_SPEC_DEFINES_THIS_PROPERLY 1
 #define TODO_COMPLETE_ONCE_ORTC_SPEC_DEFINES_THIS_PROPERLY 2
       return SecureByteBlockListPtr();
@@ -711,7 +719,7 @@ namespace ortc
                     size_t, remoteFingerprints, remoteParameters.mFingerprints.size()
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShuttingDown()) ||
           (isShutdown())) {
@@ -734,7 +742,7 @@ namespace ortc
       ZS_EVENTING_1(x, i, Detail, DtlsTransportStop, ol, DtlsTransport, Stop, puid, id, mID);
       ZS_LOG_DEBUG(log("stop called"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -776,7 +784,7 @@ namespace ortc
       UseSRTPTransportPtr transport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         if (!mSRTPTransport) {
           ZS_LOG_WARNING(Debug, log("srtp transport is not ready"))
           return false;
@@ -805,7 +813,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETransportPtr DTLSTransport::getICETransport() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return ICETransport::convert(mICETransport);
     }
 
@@ -833,6 +841,8 @@ namespace ortc
                                              size_t bufferLengthInBytes
                                              )
     {
+      PacketPipelineLatency::markHop(IStatsReportTypes::PacketPipelineHop_ICETransport);
+
       bool isDTLSPacket = isDtlsPacket(buffer, bufferLengthInBytes);
 
       StreamResult streamResult {};
@@ -856,7 +866,7 @@ namespace ortc
 
       // scope: pre-validation check
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if ((isShutdown())) {
           ZS_LOG_WARNING(Debug, log("received packet after already shutdown (thus discarding)") + ZS_PARAM("buffer length", bufferLengthInBytes))
@@ -1036,7 +1046,7 @@ namespace ortc
       ZS_LOG_TRACE(log("handle receive STUN packet") + packet->toDebug())
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       }
 
       // WARNING: Forward packet to data channel or RTP listener outside of object lock
@@ -1061,7 +1071,7 @@ namespace ortc
       UseICETransportPtr transport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if ((isShuttingDown()) ||
             (isShutdown())) {
@@ -1100,7 +1110,7 @@ namespace ortc
                                                       )
     {
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if ((isShuttingDown()) ||
             (isShutdown())) {
@@ -1138,6 +1148,22 @@ namespace ortc
       return RTPListener::convert(mRTPListener);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark DTLSTransport => ISecureTransportForRTPCapture
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPCaptureRingPtr DTLSTransport::getCaptureRing() const
+    {
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+      if (!mSRTPTransport) return RTPCaptureRingPtr();
+      return mSRTPTransport->getCaptureRing();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1151,7 +1177,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to secure transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ISecureTransportSubscriptionPtr subscription = mSecureTransportSubscriptions.subscribe(ISecureTransportDelegateProxy::create(IORTCForInternal::queueDelegate(), originalDelegate));
 
@@ -1181,7 +1207,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool DTLSTransport::isClientRole() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (!mAdapter) return false;
 
@@ -1216,7 +1242,7 @@ namespace ortc
       ZS_LOG_TRACE(log("sending data packet") + ZS_PARAM("length", bufferLengthInBytes))
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         if (!mICETransport) {
           ZS_LOG_WARNING(Debug, log("no ice transport is attached"))
           return false;
@@ -1284,7 +1310,7 @@ namespace ortc
     {
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1306,7 +1332,7 @@ namespace ortc
                     );
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()));
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       mAdapter->onTimer(timer);
 
       wakeUpIfNeeded();
@@ -1329,7 +1355,7 @@ namespace ortc
       PacketQueue packets;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         if (!mICETransport) {
           ZS_LOG_WARNING(Debug, log("no ice transport is attached"))
           return;
@@ -1421,7 +1447,7 @@ namespace ortc
       IICETypes::Components viaTransport = component();
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if ((isShuttingDown()) ||
             (isShutdown())) {
@@ -1459,7 +1485,7 @@ namespace ortc
       }
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         if (mPendingIncomingRTP.size() > 0) {
           // some more packets were put into queue after deliverying these packets, try again...
           IDTLSTransportAsyncDelegateProxy::create(mThisWeak.lock())->onDeliverPendingIncomingRTP();
@@ -1493,7 +1519,7 @@ namespace ortc
                     );
       ZS_LOG_DEBUG(log("on ice transport state changed"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1568,7 +1594,7 @@ namespace ortc
     {
       if (NULL != read) *read = 0;
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!mAdapter) {
         if (error) *error = SSL_ERROR_ZERO_RETURN;
         return SR_ERROR;
@@ -1587,7 +1613,7 @@ namespace ortc
     {
       if (NULL != written) *written = 0;
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!mAdapter) {
         if (error) *error = SSL_ERROR_ZERO_RETURN;
         return SR_ERROR;
@@ -1660,7 +1686,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr DTLSTransport::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::DTLSTransport");
 
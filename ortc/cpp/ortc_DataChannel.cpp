@@ -34,6 +34,7 @@
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/services/IHelper.h>
@@ -300,7 +301,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void DataChannel::init()
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       auto transport = mDataTransport.lock();
       if (transport) {
         mDataTransportSubscription = transport->subscribe(mThisWeak.lock());
@@ -389,7 +390,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       IDataChannelSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -434,7 +435,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IDataChannelTypes::ParametersPtr DataChannel::parameters() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       auto params = make_shared<Parameters>();
       if (mParameters) *params = *mParameters;
       return params;
@@ -443,28 +444,28 @@ namespace ortc
     //-------------------------------------------------------------------------
     IDataChannelTypes::States DataChannel::readyState() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mCurrentState;
     }
 
     //-------------------------------------------------------------------------
     size_t DataChannel::bufferedAmount() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mOutgoingBufferFillSize;
     }
 
     //-------------------------------------------------------------------------
     size_t DataChannel::bufferedAmountLowThreshold() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mBufferedAmountLowThreshold;
     }
 
     //-------------------------------------------------------------------------
     void DataChannel::bufferedAmountLowThreshold(size_t value)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ZS_EVENTING_5(
                     x, i, Trace, DataChannelBufferedAmountLowThresholdChanged, ol, DataChannel, Event,
@@ -485,14 +486,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     String DataChannel::binaryType() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mBinaryType;
     }
 
     //-------------------------------------------------------------------------
     void DataChannel::binaryType(const char *str)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       mBinaryType = String(str);
     }
 
@@ -502,7 +503,7 @@ namespace ortc
       ZS_EVENTING_1(x, i, Trace, DataChannelClose, ol, DataChannel, Close, puid, id, mID);
 
       ZS_LOG_DEBUG(log("close called"))
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -511,7 +512,7 @@ namespace ortc
     {
       ZS_EVENTING_2(x, i, Trace, DataChannelSendString, ol, DataChannel, Send, puid, id, mID, string, data, data);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (data.isEmpty()) {
         send(SCTP_PPID_STRING_LAST, NULL, 0);
         return;
@@ -529,7 +530,7 @@ namespace ortc
                     size, size, data.SizeInBytes()
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       send(SCTP_PPID_BINARY_LAST, data.BytePtr(), data.SizeInBytes());
     }
 
@@ -547,7 +548,7 @@ namespace ortc
                     );
       ORTC_THROW_INVALID_PARAMETERS_IF((NULL == buffer) && (0 != bufferSizeInBytes))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       send(SCTP_PPID_BINARY_LAST, buffer, bufferSizeInBytes);
     }
 
@@ -608,7 +609,7 @@ namespace ortc
 
       // scope: obtain whatever data is required inside lock to process SCTP packet
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         {
           if (isShutdown()) {
@@ -710,7 +711,7 @@ namespace ortc
       ZS_EVENTING_1(x, i, Trace, DataChannelSCTPTransportStateChanged, ol, DataChannel, InternalEvent, puid, id, mID);
 
       ZS_LOG_TRACE(log("on sctp transport state changed"))
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -727,7 +728,7 @@ namespace ortc
     {
       ZS_LOG_TRACE(log("on request shutdown"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -736,7 +737,7 @@ namespace ortc
     {
       ZS_LOG_TRACE(log("on notified closed"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       mNotifiedClosed = true;
       cancel();
     }
@@ -754,7 +755,7 @@ namespace ortc
     {
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -773,7 +774,7 @@ namespace ortc
 
       ZS_LOG_TRACE(log("on promise settled"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mSendReady) {
         if (mSendReady->isRejected()) {
@@ -834,7 +835,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr DataChannel::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::DataChannel");
 
@@ -31,9 +31,11 @@
 
 #include <ortc/internal/ortc_ICEGatherer.h>
 #include <ortc/internal/ortc_ICETransport.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -398,6 +400,9 @@ namespace ortc
 
         ISettings::setUInt(ORTC_SETTING_GATHERER_RECHECK_IP_ADDRESSES_IN_SECONDS, 60);
 
+        ISettings::setBool(ORTC_SETTING_GATHERER_LOOPBACK_ONLY, false);
+        ISettings::setString(ORTC_SETTING_GATHERER_LOOPBACK_INTERFACE_NAME, "lo0");
+
         {
           zsLib::RangeSelection<WORD> range;
 #ifdef _WIN32
@@ -587,6 +592,8 @@ namespace ortc
       mUsernameFrag(options.mUsernameFragment.hasData() ? options.mUsernameFragment : IHelper::randomString(ISettings::getUInt(ORTC_SETTING_GATHERER_USERNAME_FRAG_LENGTH))),
       mPassword(options.mPassword.hasData() ? options.mPassword : IHelper::randomString(ISettings::getUInt(ORTC_SETTING_GATHERER_PASSWORD_LENGTH))),
       mCreateTCPCandidates(ISettings::getBool(ORTC_SETTING_GATHERER_CREATE_TCP_CANDIDATES)),
+      mLoopbackOnly(ISettings::getBool(ORTC_SETTING_GATHERER_LOOPBACK_ONLY)),
+      mLoopbackInterfaceName(ISettings::getString(ORTC_SETTING_GATHERER_LOOPBACK_INTERFACE_NAME)),
       mOptions(options.mOptions),
       mComponent(options.mComponent),
       mRTPGatherer(options.mRTPGatherer),
@@ -597,6 +604,7 @@ namespace ortc
       mMaxTCPBufferingSizePendingConnection(ISettings::getUInt(ORTC_SETTING_GATHERER_MAX_PENDING_OUTGOING_TCP_SOCKET_BUFFERING_IN_BYTES)),
       mMaxTCPBufferingSizeConnected(ISettings::getUInt(ORTC_SETTING_GATHERER_MAX_CONNECTED_TCP_SOCKET_BUFFERING_IN_BYTES)),
       mGatherPassiveTCP(ISettings::getBool(ORTC_SETTING_GATHERER_GATHER_PASSIVE_TCP_CANDIDATES)),
+      mImpairment(NetworkImpairment::create(NetworkImpairment::Parameters::createFromSettings())),
       mPortRestriction(RangeSelection::createFromSetting(ORTC_SETTING_GATHERER_PORT_RESTRICTIONS))
     {
       mSTUNPacketParseOptions = STUNPacket::ParseOptions(STUNPacket::RFC_AllowAll, false, "ortc::ICEGatherer", mID);
@@ -671,7 +679,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("created"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto cleanInSeconds = ISettings::getUInt(ORTC_SETTING_GATHERER_CLEAN_UNUSED_ROUTES_NOT_USED_IN_SECONDS);
       if (0 != cleanInSeconds) {
@@ -706,6 +714,47 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(ICEGatherer, object);
     }
 
+    //-------------------------------------------------------------------------
+    NetworkImpairment::Stats ICEGatherer::getImpairmentStats() const
+    {
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+      if (!mImpairment) return NetworkImpairment::Stats();
+      return mImpairment->stats();
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGatherer::ResourceCounts ICEGatherer::getResourceCounts() const
+    {
+      ResourceCounts result;
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      result.mTimers = mReflexiveInactivityTimers.size() + mRelayInactivityTimers.size();
+      if (mRecheckIPsTimer) ++result.mTimers;
+      if (mWarmUpAterNewInterfaceBindingTimer) ++result.mTimers;
+      if (mCleanUpBufferingTimer) ++result.mTimers;
+      if (mImpairmentTimer) ++result.mTimers;
+      if (mCleanUnusedRoutesTimer) ++result.mTimers;
+
+      for (auto iter = mHostPorts.begin(); iter != mHostPorts.end(); ++iter) {
+        auto hostPort = (*iter).second;
+        if (hostPort->mBindUDPBackOffTimer) ++result.mTimers;
+        if (hostPort->mBindTCPBackOffTimer) ++result.mTimers;
+        if (hostPort->mBoundUDPSocket) ++result.mSockets;
+        if (hostPort->mBoundTCPSocket) ++result.mSockets;
+      }
+
+      result.mSockets += mTCPPorts.size();
+      result.mSTUNDiscoveries = mSTUNDiscoveries.size();
+      result.mTURNSockets = mTURNSockets.size() + mShutdownTURNSockets.size();
+      result.mLocalCandidates = mLocalCandidates.size();
+      result.mRoutes = mRoutes.size();
+      result.mInstalledTransports = mInstalledTransports.size();
+      result.mBufferedPackets = mBufferedPackets.size() + mImpairedPackets.size();
+
+      return result;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -722,7 +771,7 @@ namespace ortc
         return PromiseWithStatsReport::createRejected(IORTCForInternal::queueDelegate());
       }
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if ((isShutdown()) ||
           (isShuttingDown())) {
         ZS_LOG_WARNING(Debug, log("cannot collect stats while shutdown / shutting down"));
@@ -769,7 +818,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICEGathererSubscriptionPtr ICEGatherer::subscribe(IICEGathererDelegatePtr originalDelegate)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       auto subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -824,7 +873,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICEGatherer::States ICEGatherer::state() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       auto state = toState(mCurrentState);
       ZS_LOG_TRACE(log("get current state") + ZS_PARAM("internal state", toString(mCurrentState)) + ZS_PARAM("state", IICEGathererTypes::toString(state)))
       return state;
@@ -843,7 +892,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICEGathererTypes::CandidateListPtr ICEGatherer::getLocalCandidates() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       CandidateListPtr candidates(make_shared<CandidateList>());
 
@@ -863,7 +912,7 @@ namespace ortc
       ICEGathererPtr pThis;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         ORTC_THROW_INVALID_STATE_IF(mRTCPGatherer.lock())
 
@@ -890,7 +939,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::gather(const Optional<Options> &options)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (options.hasValue()) {
         mOptions = options.value();
@@ -936,7 +985,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("close called"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -964,7 +1013,7 @@ namespace ortc
                     string, remoteUFrag, remoteUFrag
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShuttingDown()) ||
           (isShutdown())) {
@@ -1057,7 +1106,7 @@ namespace ortc
                     );
 
       ZS_LOG_TRACE(log("notified transport state changed") + ZS_PARAM("transport id", transport->getID()))
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       mTransportsChanged = true;
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
@@ -1076,7 +1125,7 @@ namespace ortc
 
       ZS_LOG_TRACE(log("removing transport") + ZS_PARAM("transport id", transport.getID()))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       removeAllRelatedRoutes(transport.getID(), UseICETransportPtr());
 
       for (auto iter_doNotUse = mInstalledTransports.begin(); iter_doNotUse != mInstalledTransports.end(); ) {
@@ -1123,14 +1172,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     ICEGatherer::ForICETransportPtr ICEGatherer::getRTCPGatherer() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mRTCPGatherer.lock();
     }
 
     //-------------------------------------------------------------------------
     bool ICEGatherer::isContinousGathering() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mOptions.mContinuousGathering;
     }
 
@@ -1143,7 +1192,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::removeRoute(RouterRoutePtr routerRoute)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto found = mRoutes.find(routerRoute->mID);
       if (found == mRoutes.end()) {
@@ -1198,7 +1247,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("removing all related routes") + ZS_PARAMIZE(transportID))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       removeAllRelatedRoutes(transportID, UseICETransportPtr());
     }
 
@@ -1226,7 +1275,7 @@ namespace ortc
       RoutePtr route;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         {
           auto found = mRoutes.find(routerRoute->mID);
@@ -1331,7 +1380,7 @@ namespace ortc
                     );
 
       if (!turn->sendPacket(route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes)) {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         ZS_LOG_WARNING(Debug, log("turn socket not able to send packet at this time") + route->toDebug() + ZS_PARAM("buffer size", bufferSizeInBytes));
         goto send_failed;
       }
@@ -1353,7 +1402,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto found = mRoutes.find(routerRoute->mID);
       if (found == mRoutes.end()) {
@@ -1418,7 +1467,7 @@ namespace ortc
 
       // check though buffer to see if there are any other packets fitting this criteria that can now be delivered
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         auto found = mRoutes.find(routerRouteID);
         if (found == mRoutes.end()) {
@@ -1485,7 +1534,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (isShutdown()) {
         ZS_LOG_WARNING(Detail, log("requesting stats after shutdown"))
@@ -1511,7 +1560,7 @@ namespace ortc
     {
       ZS_EVENTING_1(x, i, Trace, IceGathererInternalWakeEvent, ol, IceGatherer, InternalEvent, puid, id, mID);
       ZS_LOG_TRACE(log("on wake"))
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1529,7 +1578,7 @@ namespace ortc
       ZS_EVENTING_2(x, i, Debug, IceGathererInternalDnsLoookupCompleteEvent, ol, IceGatherer, InternalEvent, puid, id, mID, puid, dnsQueryId, query->getID());
 
       ZS_LOG_TRACE(log("on lookup complete") + ZS_PARAM("query", query->getID()))
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1554,7 +1603,7 @@ namespace ortc
       Time now = zsLib::now();
 
       ZS_LOG_TRACE(log("on timer fired") + ZS_PARAM("timer", timer->getID()));
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mWarmUpAterNewInterfaceBindingTimer == timer) {
         ZS_EVENTING_3(
@@ -1594,6 +1643,19 @@ namespace ortc
         return;
       }
 
+      if (mImpairmentTimer == timer) {
+        ZS_EVENTING_3(
+                      x, i, Trace, IceGathererInternalTimerEvent, ol, IceGatherer, InternalEvent,
+                      puid, id, mID,
+                      string, timerType, "impairment timer",
+                      puid, relatedObjectId, 0
+                      );
+
+        mImpairmentTimer.reset();
+        sendDueImpairedPackets();
+        return;
+      }
+
       if (mCleanUpBufferingTimer == timer) {
         ZS_EVENTING_3(
                       x, i, Trace, IceGathererInternalTimerEvent, ol, IceGatherer, InternalEvent,
@@ -1786,7 +1848,7 @@ namespace ortc
 
       // scope: figure out which host port fired the event
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // first check host ports
         {
@@ -1851,7 +1913,7 @@ namespace ortc
 
       // scope: figure out which host port fired the event
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // first check host ports
         {
@@ -1899,7 +1961,7 @@ namespace ortc
 
       // scope: figure out which host port fired the event
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // first check host ports
         {
@@ -1974,7 +2036,7 @@ namespace ortc
                     puid, backOffTimerId, timer->getID(),
                     string, state, IBackOffTimer::toString(state)
                     );
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_TRACE(log("back off timer attempt again now fired") + UseBackOffTimer::toDebug(timer));
       step();
     }
@@ -2007,7 +2069,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("stun discovery needs to send packet") + UseSTUNDiscovery::toDebug(discovery) + ZS_PARAM("destination", destination.string()) + ZS_PARAM("packet length", packet->SizeInBytes()))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto found = mSTUNDiscoveries.find(discovery);
       if (found == mSTUNDiscoveries.end()) {
@@ -2031,7 +2093,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::onSTUNDiscoveryCompleted(ISTUNDiscoveryPtr discovery)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_DEBUG(log("stun discovery complete notification") + UseSTUNDiscovery::toDebug(discovery))
 
       auto found = mSTUNDiscoveries.find(discovery);
@@ -2077,7 +2139,7 @@ namespace ortc
                     string, state, ITURNSocket::toString(state)
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_DEBUG(log("turn state changed notification") + UseTURNSocket::toDebug(socket) + ZS_PARAM("state", UseTURNSocket::toString(state)))
 
       HostPortPtr hostPort;
@@ -2134,7 +2196,7 @@ namespace ortc
       CandidatePtr localCandidate;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         ZS_LOG_DEBUG(log("turn received incoming packet") + UseTURNSocket::toDebug(socket) + ZS_PARAM("packet length", packetLengthInBytes))
 
         HostPortPtr hostPort;
@@ -2237,7 +2299,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("turn socket needs to send packet") + UseTURNSocket::toDebug(socket) + ZS_PARAM("destination", destination.string()) + ZS_PARAM("packet length", packetLengthInBytes));
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       HostPortPtr hostPort;
 
@@ -2313,7 +2375,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr ICEGatherer::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::ICEGatherer");
 
@@ -2341,6 +2403,8 @@ namespace ortc
 
       IHelper::debugAppend(resultEl, "interface mappings", mInterfaceMappings.size());
       IHelper::debugAppend(resultEl, "create tcp candidates", mCreateTCPCandidates);
+      IHelper::debugAppend(resultEl, "loopback only", mLoopbackOnly);
+      IHelper::debugAppend(resultEl, "loopback interface name", mLoopbackInterfaceName);
 
       IHelper::debugAppend(resultEl, "get local ips now", mGetLocalIPsNow);
       IHelper::debugAppend(resultEl, "recheck ips duration", mRecheckIPsDuration);
@@ -2399,6 +2463,10 @@ namespace ortc
       IHelper::debugAppend(resultEl, "max total buffers", mMaxTotalBuffers);
       IHelper::debugAppend(resultEl, "buffered packets", mBufferedPackets.size());
 
+      IHelper::debugAppend(resultEl, "impairment", mImpairment ? mImpairment->toDebug() : ElementPtr());
+      IHelper::debugAppend(resultEl, "impaired packets", mImpairedPackets.size());
+      IHelper::debugAppend(resultEl, "impairment timer", mImpairmentTimer ? mImpairmentTimer->getID() : 0);
+
       IHelper::debugAppend(resultEl, "quick search routes", mQuickSearchRoutes.size());
       IHelper::debugAppend(resultEl, "routes", mRoutes.size());
       IHelper::debugAppend(resultEl, "clean unused routes timer", mCleanUnusedRoutesTimer ? mCleanUnusedRoutesTimer->getID() : 0);
@@ -2412,21 +2480,21 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool ICEGatherer::isComplete() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return State_Complete == toState(mCurrentState);
     }
 
     //-------------------------------------------------------------------------
     bool ICEGatherer::isShuttingDown() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return InternalState_ShuttingDown == mCurrentState;
     }
 
     //-------------------------------------------------------------------------
     bool ICEGatherer::isShutdown() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return InternalState_Shutdown == mCurrentState;
     }
 
@@ -2705,9 +2773,13 @@ namespace ortc
 
       mResolvedHostIPs.clear();
 
-      stepGetHostIPs_WinRT();
-      stepGetHostIPs_Win32();
-      stepGetHostIPs_ifaddr();
+      if (mLoopbackOnly) {
+        stepGetHostIPs_Loopback();
+      } else {
+        stepGetHostIPs_WinRT();
+        stepGetHostIPs_Win32();
+        stepGetHostIPs_ifaddr();
+      }
 
       if (mPendingHostIPs.size() > 0) {
         ZS_LOG_TRACE(log("not all host IPs resolved") + ZS_PARAM("pending size", mPendingHostIPs.size()))
@@ -3086,6 +3158,24 @@ namespace ortc
 #endif //HAVE_GETIFADDRS
     }
 
+    //-------------------------------------------------------------------------
+    void ICEGatherer::stepGetHostIPs_Loopback()
+    {
+      // loopback addresses are filtered out of every platform enumeration
+      // so the loopback hosts are added directly (and only they are added);
+      // the interface mappings and filter policies apply as for any other
+      // host (e.g. FilterPolicy_NoIPv6Host drops ::1)
+      static const char *loopbackIPs[] = {"127.0.0.1", "::1"};
+
+      for (size_t index = 0; index < (sizeof(loopbackIPs) / sizeof(loopbackIPs[0])); ++index) {
+        IPAddress ip(String(loopbackIPs[index]));
+
+        ZS_LOG_TRACE(log("using loopback host IP") + ZS_PARAM("ip", ip.string()) + ZS_PARAM("interface", mLoopbackInterfaceName))
+
+        mResolvedHostIPs.push_back(HostIPSorter::prepare(mLoopbackInterfaceName.c_str(), ip, mInterfaceMappings, mOptions));
+      }
+    }
+
     //-------------------------------------------------------------------------
     bool ICEGatherer::stepCalculateHostsHash()
     {
@@ -4363,6 +4453,12 @@ namespace ortc
       }
       mBufferedPackets.clear();
 
+      if (mImpairmentTimer) {
+        mImpairmentTimer->cancel();
+        mImpairmentTimer.reset();
+      }
+      mImpairedPackets.clear();
+
       mQuickSearchRoutes.clear();
       mRoutes.clear();
       if (mCleanUnusedRoutesTimer) {
@@ -5387,7 +5483,7 @@ namespace ortc
       CandidatePtr localCandidate;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (hostPort->mBoundUDPSocket == socket) {
           bool wouldBlock = false;
@@ -5542,7 +5638,7 @@ namespace ortc
           ZS_LOG_INSANE(log("handling incoming stun packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
           auto response = handleIncomingPacket(localCandidate, fromIP, stunPacket);
           if (response) {
-            AutoRecursiveLock lock(*this);
+            ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
             if (hostPort->mBoundUDPSocket) {
               auto result = sendUDPPacket(socket, hostPort->mBoundUDPIP, fromIP, *response, response->SizeInBytes());
@@ -5573,7 +5669,7 @@ namespace ortc
       IPAddress fromIP;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         while (true)
         {
@@ -5666,7 +5762,7 @@ namespace ortc
 
             auto response = handleIncomingPacket(localCandidate, fromIP, packet->mSTUNPacket);
             if (response) {
-              AutoRecursiveLock lock(*this);
+              ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
               if (tcpPort.mSocket) {
                 ZS_LOG_TRACE(log("sending packet response by putting into TCP send queue") + tcpPort.toDebug())
                 // put the buffer at the end of the queue
@@ -5699,7 +5795,7 @@ namespace ortc
                             SocketPtr socket
                             )
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (hostPort.mBoundUDPSocket == socket) {
         for (auto iter = hostPort.mRelayPorts.begin(); iter != hostPort.mRelayPorts.end(); ++iter) {
@@ -5804,7 +5900,7 @@ namespace ortc
                             )
     {
       ZS_THROW_INVALID_ARGUMENT_IF(!hostPort)
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((hostPort->mBoundUDPSocket != socket) &&
           (hostPort->mBoundTCPSocket != socket)) {
@@ -5868,7 +5964,7 @@ namespace ortc
       ZS_THROW_INVALID_ARGUMENT_IF(!tcpPort)
       ZS_THROW_INVALID_ARGUMENT_IF(!ownerHostPort)
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_DEBUG(log("tcp port is closing") + tcpPort->toDebug())
       shutdown(tcpPort, ownerHostPort);
     }
@@ -5886,7 +5982,7 @@ namespace ortc
       String rFrag;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // scope: check binding request
         {
@@ -6010,7 +6106,7 @@ namespace ortc
           return SecureByteBlockPtr();
         }
 
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         BufferedPacketPtr packet(make_shared<BufferedPacket>());
         packet->mTimestamp = zsLib::now();
@@ -6043,12 +6139,14 @@ namespace ortc
                                            size_t bufferSizeInBytes
                                            )
     {
+      PacketPipelineLatency::IngressScope ingressScope;
+
       RoutePtr route;
       RouterRoutePtr routerRoute;
       UseICETransportPtr transport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // scope: search for existing route
         {
@@ -6091,7 +6189,7 @@ namespace ortc
           return;
         }
 
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         BufferedPacketPtr packet(make_shared<BufferedPacket>());
         packet->mTimestamp = zsLib::now();
@@ -6125,7 +6223,7 @@ namespace ortc
       auto routerCandidate = routerRoute->mLocalCandidate;
       String routerCandidateHash = routerRoute->mLocalCandidate->hash();
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       // NOTE: The candidates pointers from the routerer are not the same as
       //       candidate pointer used by the ice gatherer. As such, we need
@@ -6542,6 +6640,20 @@ namespace ortc
       if (!buffer) return true;
       if (0 == bufferSizeInBytes) return true;
 
+      if (mImpairment) return sendImpairedUDPPacket(socket, boundIP, remoteIP, buffer, bufferSizeInBytes);
+
+      return writeUDPPacket(socket, boundIP, remoteIP, buffer, bufferSizeInBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::writeUDPPacket(
+                                     SocketPtr socket,
+                                     const IPAddress &boundIP,
+                                     const IPAddress &remoteIP,
+                                     const BYTE *buffer,
+                                     size_t bufferSizeInBytes
+                                     )
+    {
       try {
         bool wouldBlock = false;
 
@@ -6568,6 +6680,84 @@ namespace ortc
       return false;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::sendImpairedUDPPacket(
+                                            SocketPtr socket,
+                                            const IPAddress &boundIP,
+                                            const IPAddress &remoteIP,
+                                            const BYTE *buffer,
+                                            size_t bufferSizeInBytes
+                                            )
+    {
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      Time now = zsLib::now();
+      Time sendAt[NetworkImpairment::ScheduleLimit_MaxCopies] {};
+
+      auto copies = mImpairment->schedule(now, bufferSizeInBytes, sendAt);
+
+      // a lost packet still counts as sent; the loss happened "on the wire"
+      if (0 == copies) {
+        ZS_LOG_INSANE(log("impairment lost packet") + ZS_PARAM("to", remoteIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
+        return true;
+      }
+
+      SecureByteBlockPtr copy;
+
+      for (size_t index = 0; index < copies; ++index) {
+        if ((sendAt[index] <= now) &&
+            (mImpairedPackets.empty())) {
+          writeUDPPacket(socket, boundIP, remoteIP, buffer, bufferSizeInBytes);
+          continue;
+        }
+
+        if (!copy) copy = make_shared<SecureByteBlock>(buffer, bufferSizeInBytes);
+
+        auto packet = make_shared<ImpairedPacket>();
+        packet->mSocket = socket;
+        packet->mBoundIP = boundIP;
+        packet->mRemoteIP = remoteIP;
+        packet->mBuffer = copy;
+
+        mImpairedPackets.insert(ImpairedPacketMap::value_type(sendAt[index], packet));
+      }
+
+      sendDueImpairedPackets();
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::sendDueImpairedPackets()
+    {
+      Time now = zsLib::now();
+
+      while (mImpairedPackets.size() > 0) {
+        auto current = mImpairedPackets.begin();
+        if ((*current).first > now) break;
+
+        auto packet = (*current).second;
+        mImpairedPackets.erase(current);
+
+        writeUDPPacket(packet->mSocket, packet->mBoundIP, packet->mRemoteIP, packet->mBuffer->BytePtr(), packet->mBuffer->SizeInBytes());
+      }
+
+      if (mImpairedPackets.empty()) return;
+      if (isShutdown()) return;
+
+      auto fireAt = (*mImpairedPackets.begin()).first;
+
+      if (mImpairmentTimer) {
+        // a packet that must go out sooner than the timer was queued (e.g.
+        // behind a packet being held back for reordering)
+        if (mImpairmentTimerFireAt <= fireAt) return;
+        mImpairmentTimer->cancel();
+        mImpairmentTimer.reset();
+      }
+
+      mImpairmentTimerFireAt = fireAt;
+      mImpairmentTimer = ITimer::create(mThisWeak.lock(), fireAt);
+    }
+
     //-------------------------------------------------------------------------
     bool ICEGatherer::shouldKeepWarm() const
     {
@@ -0,0 +1,752 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_ICEGathererPool.h>
+#include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_icegatherer) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  using zsLib::SingletonManager;
+  using zsLib::Log;
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(ICEGathererPoolSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPoolSettingsDefaults
+    #pragma mark
+
+    class ICEGathererPoolSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~ICEGathererPoolSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static ICEGathererPoolSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<ICEGathererPoolSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static ICEGathererPoolSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<ICEGathererPoolSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        // pooling is disabled unless an application opts in
+        ISettings::setUInt(ORTC_SETTING_GATHERER_POOL_SIZE, 0);
+        ISettings::setUInt(ORTC_SETTING_GATHERER_POOL_MAX_AGE_IN_SECONDS, 10*60);
+        ISettings::setUInt(ORTC_SETTING_GATHERER_POOL_IDLE_TIMEOUT_IN_SECONDS, 5*60);
+        ISettings::setUInt(ORTC_SETTING_GATHERER_POOL_MAINTENANCE_INTERVAL_IN_SECONDS, 15);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installICEGathererPoolSettingsDefaults()
+    {
+      ICEGathererPoolSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool::Stats
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    double ICEGathererPool::Stats::hitRate() const
+    {
+      size_t total = mHits + mMisses;
+      if (0 == total) return 0.0;
+      return static_cast<double>(mHits) / static_cast<double>(total);
+    }
+
+    //-------------------------------------------------------------------------
+    Milliseconds ICEGathererPool::Stats::averagePooledFirstCandidate() const
+    {
+      if (0 == mPooledFirstCandidates) return Milliseconds();
+      return Milliseconds(mPooledFirstCandidateTotal.count() / static_cast<Milliseconds::rep>(mPooledFirstCandidates));
+    }
+
+    //-------------------------------------------------------------------------
+    Milliseconds ICEGathererPool::Stats::averageUnpooledFirstCandidate() const
+    {
+      if (0 == mUnpooledFirstCandidates) return Milliseconds();
+      return Milliseconds(mUnpooledFirstCandidateTotal.count() / static_cast<Milliseconds::rep>(mUnpooledFirstCandidates));
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererPool::Stats::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGathererPool::Stats");
+
+      IHelper::debugAppend(resultEl, "hits", mHits);
+      IHelper::debugAppend(resultEl, "misses", mMisses);
+      IHelper::debugAppend(resultEl, "hit rate", hitRate());
+      IHelper::debugAppend(resultEl, "pooled", mPooled);
+      IHelper::debugAppend(resultEl, "expired", mExpired);
+
+      IHelper::debugAppend(resultEl, "pooled first candidates", mPooledFirstCandidates);
+      IHelper::debugAppend(resultEl, "pooled average first candidate", averagePooledFirstCandidate());
+      IHelper::debugAppend(resultEl, "unpooled first candidates", mUnpooledFirstCandidates);
+      IHelper::debugAppend(resultEl, "unpooled average first candidate", averageUnpooledFirstCandidate());
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool::PooledGatherer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererPool::PooledGatherer::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGathererPool::PooledGatherer");
+
+      IHelper::debugAppend(resultEl, "gatherer", mGatherer ? mGatherer->getID() : 0);
+      IHelper::debugAppend(resultEl, "subscription", (bool)mSubscription);
+      IHelper::debugAppend(resultEl, "created", mCreated);
+      IHelper::debugAppend(resultEl, "complete", mComplete);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool::OptionsPool
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererPool::OptionsPool::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGathererPool::OptionsPool");
+
+      IHelper::debugAppend(resultEl, "hash", mHash);
+      IHelper::debugAppend(resultEl, "last requested", mLastRequested);
+
+      ElementPtr gatherersEl = Element::create("gatherers");
+      for (auto iter = mGatherers.begin(); iter != mGatherers.end(); ++iter) {
+        IHelper::debugAppend(gatherersEl, (*iter)->toDebug());
+      }
+      IHelper::debugAppend(resultEl, gatherersEl);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGathererPool::ICEGathererPool(
+                                     const make_private &,
+                                     IMessageQueuePtr queue
+                                     ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mPoolSize(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_SIZE)),
+      mMaxAge(Seconds(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_MAX_AGE_IN_SECONDS))),
+      mIdleTimeout(Seconds(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_IDLE_TIMEOUT_IN_SECONDS)))
+    {
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    ICEGathererPool::~ICEGathererPool()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererPoolPtr ICEGathererPool::create()
+    {
+      ICEGathererPoolPtr pThis(make_shared<ICEGathererPool>(make_private {}, IORTCForInternal::queueORTC()));
+      pThis->mThisWeak = pThis;
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererPoolPtr ICEGathererPool::singleton()
+    {
+      AutoRecursiveLock lock(*IHelper::getGlobalLock());
+      static SingletonLazySharedPtr<ICEGathererPool> singleton(create());
+      ICEGathererPoolPtr result = singleton.singleton();
+
+      static SingletonManager::Register registerSingleton("org.ortc.ICEGathererPool", result);
+
+      if (!result) {
+        ZS_LOG_WARNING(Detail, slog("singleton gone"))
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool => (for peer connection)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IICEGathererPtr ICEGathererPool::acquire(
+                                             IICEGathererDelegatePtr delegate,
+                                             const Options &options,
+                                             IICEGathererSubscriptionPtr &outSubscription,
+                                             bool &outPooled
+                                             )
+    {
+      outSubscription.reset();
+      outPooled = false;
+
+      auto pThis = singleton();
+      if (pThis) {
+        AutoRecursiveLock lock(*pThis);
+        auto gatherer = pThis->take(delegate, options, outSubscription);
+        if (gatherer) {
+          outPooled = true;
+          return gatherer;
+        }
+      }
+
+      auto gatherer = IICEGatherer::create(delegate, options);
+      gatherer->gather();
+      return gatherer;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::notifyFirstCandidate(
+                                               bool pooled,
+                                               Milliseconds timeToFirstCandidate
+                                               )
+    {
+      auto pThis = singleton();
+      if (!pThis) return;
+
+      AutoRecursiveLock lock(*pThis);
+      pThis->record(pooled, timeToFirstCandidate);
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererPool::Stats ICEGathererPool::getStats()
+    {
+      auto pThis = singleton();
+      if (!pThis) return Stats();
+
+      AutoRecursiveLock lock(*pThis);
+      return pThis->mStats;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererPool::singletonToDebug()
+    {
+      auto pThis = singleton();
+      if (!pThis) return ElementPtr();
+
+      AutoRecursiveLock lock(*pThis);
+      return pThis->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool => IICEGathererDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onICEGathererStateChange(
+                                                   IICEGathererPtr gatherer,
+                                                   IICEGathererTypes::States state
+                                                   )
+    {
+      ZS_LOG_TRACE(log("gatherer state change") + ZS_PARAM("gatherer", gatherer->getID()) + ZS_PARAM("state", IICEGathererTypes::toString(state)))
+
+      AutoRecursiveLock lock(*this);
+
+      switch (state) {
+        case IICEGathererTypes::State_Complete: {
+          for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+            auto &pool = *((*iter).second);
+            for (auto iterGatherer = pool.mGatherers.begin(); iterGatherer != pool.mGatherers.end(); ++iterGatherer) {
+              auto &pooled = *(*iterGatherer);
+              if (pooled.mGatherer != gatherer) continue;
+              pooled.mComplete = true;
+            }
+          }
+          break;
+        }
+        case IICEGathererTypes::State_Closed: {
+          remove(gatherer);
+          break;
+        }
+        default: break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onICEGathererLocalCandidate(
+                                                      IICEGathererPtr gatherer,
+                                                      CandidatePtr candidate
+                                                      )
+    {
+      // candidates are replayed to whoever adopts the gatherer
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onICEGathererLocalCandidateComplete(
+                                                              IICEGathererPtr gatherer,
+                                                              CandidateCompletePtr candidate
+                                                              )
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onICEGathererLocalCandidateGone(
+                                                          IICEGathererPtr gatherer,
+                                                          CandidatePtr candidate
+                                                          )
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onICEGathererError(
+                                             IICEGathererPtr gatherer,
+                                             ErrorEventPtr errorEvent
+                                             )
+    {
+      ZS_LOG_WARNING(Debug, log("pooled gatherer reported error") + ZS_PARAM("gatherer", gatherer->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      // a warm gatherer that hit an error (e.g. a failed TURN refresh) is not
+      // worth handing out; a fresh one is gathered on the next refill
+      remove(gatherer);
+      refill();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_TRACE(log("on timer") + ZS_PARAM("timer", timer->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      if (timer != mTimer) return;
+
+      readSettings();
+
+      auto now = zsLib::now();
+
+      for (auto iter_doNotUse = mPools.begin(); iter_doNotUse != mPools.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto &pool = *((*current).second);
+
+        if (pool.mLastRequested + mIdleTimeout < now) {
+          ZS_LOG_DEBUG(log("options no longer in demand") + ZS_PARAM("hash", pool.mHash))
+          for (auto iterGatherer = pool.mGatherers.begin(); iterGatherer != pool.mGatherers.end(); ++iterGatherer) {
+            close(*(*iterGatherer));
+          }
+          mPools.erase(current);
+          continue;
+        }
+
+        expire(pool);
+      }
+
+      if (mPools.size() < 1) {
+        ZS_LOG_DEBUG(log("no options in demand (stopping maintenance timer)"))
+        mTimer->cancel();
+        mTimer.reset();
+        return;
+      }
+
+      refill();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool => ISingletonManagerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::notifySingletonCleanup()
+    {
+      ZS_LOG_DEBUG(log("notify singleton cleanup"))
+
+      AutoRecursiveLock lock(*this);
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererPool::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::ICEGathererPool");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererPool::slog(const char *message)
+    {
+      ElementPtr objectEl = Element::create("ortc::ICEGathererPool");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICEGathererPool::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGathererPool::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::ICEGathererPool");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+      IHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+      IHelper::debugAppend(resultEl, "pool size", mPoolSize);
+      IHelper::debugAppend(resultEl, "max age", mMaxAge);
+      IHelper::debugAppend(resultEl, "idle timeout", mIdleTimeout);
+
+      ElementPtr poolsEl = Element::create("pools");
+      for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+        IHelper::debugAppend(poolsEl, (*iter).second->toDebug());
+      }
+      IHelper::debugAppend(resultEl, poolsEl);
+
+      IHelper::debugAppend(resultEl, mStats.toDebug());
+
+      IHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    IICEGathererPtr ICEGathererPool::take(
+                                          IICEGathererDelegatePtr delegate,
+                                          const Options &options,
+                                          IICEGathererSubscriptionPtr &outSubscription
+                                          )
+    {
+      if (isShutdown()) {
+        ++mStats.mMisses;
+        return IICEGathererPtr();
+      }
+
+      // the pool can be enabled (or resized) after the singleton was created
+      readSettings();
+
+      if (0 == mPoolSize) {
+        ++mStats.mMisses;
+        return IICEGathererPtr();
+      }
+
+      auto hash = options.hash();
+
+      OptionsPoolPtr pool;
+
+      auto found = mPools.find(hash);
+      if (found == mPools.end()) {
+        pool = make_shared<OptionsPool>();
+        pool->mHash = hash;
+        pool->mOptions = options;
+        mPools[hash] = pool;
+        ZS_LOG_DEBUG(log("options now in demand") + ZS_PARAM("hash", hash))
+
+        startTimer();
+      } else {
+        pool = (*found).second;
+      }
+
+      pool->mLastRequested = zsLib::now();
+
+      IICEGathererPtr result;
+
+      while (pool->mGatherers.size() > 0) {
+        auto pooled = pool->mGatherers.front();
+        pool->mGatherers.pop_front();
+
+        if (IICEGathererTypes::State_Closed == pooled->mGatherer->state()) {
+          close(*pooled);
+          continue;
+        }
+
+        if (pooled->mSubscription) {
+          pooled->mSubscription->cancel();
+          pooled->mSubscription.reset();
+        }
+
+        // subscribing replays the state and the already gathered candidates
+        outSubscription = pooled->mGatherer->subscribe(delegate);
+        result = pooled->mGatherer;
+        break;
+      }
+
+      if (result) {
+        ++mStats.mHits;
+        ZS_LOG_DEBUG(log("handing out pooled gatherer") + ZS_PARAM("gatherer", result->getID()))
+      } else {
+        ++mStats.mMisses;
+        ZS_LOG_DEBUG(log("no pooled gatherer available") + ZS_PARAM("hash", hash))
+      }
+
+      refill(*pool);
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::readSettings()
+    {
+      mPoolSize = ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_SIZE);
+      mMaxAge = Seconds(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_MAX_AGE_IN_SECONDS));
+      mIdleTimeout = Seconds(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_IDLE_TIMEOUT_IN_SECONDS));
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::startTimer()
+    {
+      if (mTimer) return;
+
+      Seconds interval(ISettings::getUInt(ORTC_SETTING_GATHERER_POOL_MAINTENANCE_INTERVAL_IN_SECONDS));
+      if (0 == interval.count()) interval = Seconds(15);
+
+      mTimer = ITimer::create(mThisWeak.lock(), interval);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::record(
+                                 bool pooled,
+                                 Milliseconds timeToFirstCandidate
+                                 )
+    {
+      if (pooled) {
+        ++mStats.mPooledFirstCandidates;
+        mStats.mPooledFirstCandidateTotal += timeToFirstCandidate;
+        return;
+      }
+
+      ++mStats.mUnpooledFirstCandidates;
+      mStats.mUnpooledFirstCandidateTotal += timeToFirstCandidate;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::refill()
+    {
+      for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+        refill(*((*iter).second));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::refill(OptionsPool &pool)
+    {
+      if (isShutdown()) return;
+
+      auto pThis = mThisWeak.lock();
+      if (!pThis) return;
+
+      while (pool.mGatherers.size() < mPoolSize) {
+        auto pooled = make_shared<PooledGatherer>();
+        pooled->mCreated = zsLib::now();
+        pooled->mGatherer = createGatherer(pool.mOptions);
+        pooled->mSubscription = pooled->mGatherer->subscribe(pThis);
+        pooled->mGatherer->gather();
+
+        ZS_LOG_DEBUG(log("pre-gathering") + ZS_PARAM("gatherer", pooled->mGatherer->getID()) + ZS_PARAM("hash", pool.mHash))
+
+        pool.mGatherers.push_back(pooled);
+        ++mStats.mPooled;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    IICEGathererPtr ICEGathererPool::createGatherer(const Options &options)
+    {
+      return IICEGatherer::create(IICEGathererDelegatePtr(), options);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::expire(OptionsPool &pool)
+    {
+      auto now = zsLib::now();
+
+      for (auto iter_doNotUse = pool.mGatherers.begin(); iter_doNotUse != pool.mGatherers.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto &pooled = *(*current);
+        if (pooled.mCreated + mMaxAge > now) continue;
+
+        ZS_LOG_DEBUG(log("rotating out aged gatherer") + ZS_PARAM("gatherer", pooled.mGatherer->getID()))
+
+        close(pooled);
+        pool.mGatherers.erase(current);
+        ++mStats.mExpired;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::remove(IICEGathererPtr gatherer)
+    {
+      for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+        auto &pool = *((*iter).second);
+        for (auto iterGatherer = pool.mGatherers.begin(); iterGatherer != pool.mGatherers.end(); ++iterGatherer) {
+          auto pooled = (*iterGatherer);
+          if (pooled->mGatherer != gatherer) continue;
+
+          ZS_LOG_DEBUG(log("removing pooled gatherer") + ZS_PARAM("gatherer", gatherer->getID()))
+
+          pool.mGatherers.erase(iterGatherer);
+          close(*pooled);
+          return;
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::close(PooledGatherer &pooled)
+    {
+      if (pooled.mSubscription) {
+        pooled.mSubscription->cancel();
+        pooled.mSubscription.reset();
+      }
+      if (pooled.mGatherer) {
+        pooled.mGatherer->close();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererPool::cancel()
+    {
+      if (isShutdown()) return;
+
+      mShutdown = true;
+
+      if (mTimer) {
+        mTimer->cancel();
+        mTimer.reset();
+      }
+
+      for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+        auto &pool = *((*iter).second);
+        for (auto iterGatherer = pool.mGatherers.begin(); iterGatherer != pool.mGatherers.end(); ++iterGatherer) {
+          close(*(*iterGatherer));
+        }
+      }
+      mPools.clear();
+    }
+
+  }
+}
@@ -33,9 +33,11 @@
 #include <ortc/internal/ortc_ICEGatherer.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_ICETransportController.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -265,7 +267,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::init()
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mGatherer) {
         auto pThis = mThisWeak.lock();
@@ -334,6 +336,30 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(ICETransport, object);
     }
 
+    //-------------------------------------------------------------------------
+    ICETransport::ResourceCounts ICETransport::getResourceCounts() const
+    {
+      ResourceCounts result;
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      result.mTimers = mNextKeepWarmTimers.size();
+      if (mActivationTimer) ++result.mTimers;
+      if (mLastReceivedPacketTimer) ++result.mTimers;
+      if (mExpireRouteTimer) ++result.mTimers;
+
+      result.mSTUNRequesters = mOutgoingChecks.size();
+      if (mUseCandidateRequest) ++result.mSTUNRequesters;
+
+      result.mLegalRoutes = mLegalRoutes.size();
+      result.mWarmRoutes = mWarmRoutes.size();
+      result.mFrozenRoutes = mFrozen.size();
+      result.mPendingActivation = mPendingActivation.size();
+      result.mBufferedPackets = mBufferedPackets.size();
+
+      return result;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -352,7 +378,7 @@ namespace ortc
         return PromiseWithStatsReport::createRejected(IORTCForInternal::queueDelegate());
       }
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto pThis = mThisWeak.lock();
 
@@ -406,7 +432,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       IICETransportSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -445,7 +471,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICEGathererPtr ICETransport::iceGatherer() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_TRACE(log("get gatherer") + ZS_PARAM("gatherer", mGatherer ? mGatherer->getID() : 0))
       return ICEGatherer::convert(mGatherer);
     }
@@ -453,7 +479,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETransportTypes::Roles ICETransport::role() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_TRACE(log("get role") + ZS_PARAM("role", IICETypes::toString(mOptions.mRole)))
       return mOptions.mRole;
     }
@@ -468,7 +494,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETransportTypes::States ICETransport::state() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_TRACE(log("get state") + ZS_PARAM("state", IICETransport::toString(mCurrentState)))
       return mCurrentState;
     }
@@ -476,7 +502,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETypes::CandidateListPtr ICETransport::getRemoteCandidates() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       CandidateListPtr result(make_shared<CandidateList>());
       for (auto iter = mRemoteCandidates.begin(); iter != mRemoteCandidates.end(); ++iter) {
@@ -490,7 +516,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETransportTypes::CandidatePairPtr ICETransport::getSelectedCandidatePair() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (!mActiveRoute) return CandidatePairPtr();
 
@@ -522,7 +548,7 @@ namespace ortc
 
       ZS_LOG_DETAIL(log("start called") + UseICEGatherer::toDebug(gatherer) + remoteParameters.toDebug() + (options.hasValue() ? options.mType.toDebug() : ElementPtr()))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ORTC_THROW_INVALID_STATE_IF(isShuttingDown() || isShutdown())
 
@@ -601,14 +627,14 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("stop called"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
     //-------------------------------------------------------------------------
     IICETransportTypes::ParametersPtr ICETransport::getRemoteParameters() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mRemoteParameters.mUsernameFragment.isEmpty()) {
         ZS_LOG_WARNING(Debug, log("remote parameters have not been set"))
@@ -629,7 +655,7 @@ namespace ortc
       UseSecureTransportPtr secureTransport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         UseICEGathererPtr rtcpGatherer;
 
@@ -667,7 +693,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::addRemoteCandidate(const GatherCandidate &remoteCandidate) throw (InvalidStateError, InvalidParameters)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ORTC_THROW_INVALID_STATE_IF(isShuttingDown() || isShutdown());
 
@@ -749,7 +775,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::setRemoteCandidates(const CandidateList &remoteCandidates) throw (InvalidStateError, InvalidParameters)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ORTC_THROW_INVALID_STATE_IF(isShuttingDown() || isShutdown())
 
@@ -853,7 +879,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::removeRemoteCandidate(const GatherCandidate &remoteCandidate) throw (InvalidStateError, InvalidParameters)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ORTC_THROW_INVALID_STATE_IF(isShuttingDown() || isShutdown())
 
@@ -932,7 +958,7 @@ namespace ortc
                                 bool keepWarm
                                 ) throw (InvalidStateError)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ORTC_THROW_INVALID_STATE_IF(isShuttingDown() || isShutdown())
 
@@ -1014,7 +1040,7 @@ namespace ortc
       packet->trace(__func__);
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (!mGatherer) {
           ZS_LOG_WARNING(Debug, log("notify packet but no gatherer is attached") + routerRoute->toDebug() + packet->toDebug())
@@ -1167,6 +1193,8 @@ namespace ortc
                                     size_t bufferSizeInBytes
                                     )
     {
+      PacketPipelineLatency::markHop(IStatsReportTypes::PacketPipelineHop_ICEGatherer);
+
       ZS_EVENTING_4(
                     x, i, Trace, IceTransportReceivedPacketFromGatherer, ol, IceTransport, Receive,
                     puid, id, mID,
@@ -1178,7 +1206,7 @@ namespace ortc
       UseSecureTransportPtr transport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         auto found = mGathererRoutes.find(routerRoute->mID);
         if (found == mGathererRoutes.end()) {
@@ -1260,7 +1288,7 @@ namespace ortc
     forward_old_transport:
       {
         {
-          AutoRecursiveLock lock(*this);
+          ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
           transport = mSecureTransportOld.lock();
           if (!transport) {
             ZS_LOG_WARNING(Debug, log("no older transport available to send packet") + routerRoute->toDebug() + ZS_PARAMIZE(bufferSizeInBytes))
@@ -1277,7 +1305,7 @@ namespace ortc
                       );
         bool handled = transport->handleReceivedPacket(mComponent, buffer, bufferSizeInBytes);
         if (!handled) {
-          AutoRecursiveLock lock(*this);
+          ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
           auto oldTransportID = transport->getID();
 
@@ -1315,7 +1343,7 @@ namespace ortc
                     puid, iceTransportControllerId, controller->getID()
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       mTransportController = controller;
       wakeUp();
@@ -1326,7 +1354,7 @@ namespace ortc
     {
       UseICETransportController &controller = inController;
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ZS_THROW_INVALID_ASSUMPTION_IF(IICETypes::Component_RTCP == mComponent)
 
@@ -1369,7 +1397,7 @@ namespace ortc
                                                   PromisePtr promise
                                                   )
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShuttingDown()) || (isShutdown())) {
         ZS_LOG_WARNING(Detail, log("cannot attach promise to foundation when shutting down/shutdown"))
@@ -1457,7 +1485,7 @@ namespace ortc
 
       ZS_LOG_DETAIL(log("notify attached") + ZS_PARAM("secure transport id", secureTransportID))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto pThis = mThisWeak.lock();
 
@@ -1491,7 +1519,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IICETypes::Roles ICETransport::getRole() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mOptions.mRole;
     }
 
@@ -1510,7 +1538,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ICETransport::UseSecureTransportPtr ICETransport::getSecureTransport() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mSecureTransport.lock();
     }
 
@@ -1531,7 +1559,7 @@ namespace ortc
       RouterRoutePtr routerRoute;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (!installGathererRoute(mActiveRoute)) {
           ZS_LOG_WARNING(Trace, log("cannot install a gatherer route") + (mActiveRoute ? mActiveRoute->toDebug() : ElementPtr()) + ZS_PARAM("buffer size", bufferSizeInBytes))
@@ -1580,7 +1608,7 @@ namespace ortc
       RouterRoutePtr routerRoute;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (!mGathererRouter) {
           ZS_LOG_WARNING(Detail, log("cannot handle packet as no gather is attached") + localCandidate->toDebug() + ZS_PARAM("remote ip", remoteIP.string()) + stunPacket->toDebug())
@@ -1615,7 +1643,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("warm routes changed event fired"));
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       mWarmRoutesChanged = -1;  // by setting negative this route will be considered handled (unless set positive again)
 
       step();
@@ -1634,7 +1662,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("notify detached") + ZS_PARAM("secure transport id", secureTransportID))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (secureTransportID != mSecureTransportID) {
         ZS_LOG_WARNING(Detail, log("secure transport is not attached") + ZS_PARAM("secure transport id", secureTransportID))
@@ -1662,7 +1690,7 @@ namespace ortc
       PacketQueue packets;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         transport = mSecureTransport.lock();
         if (!transport) {
@@ -1695,7 +1723,7 @@ namespace ortc
       forward_old_transport:
         {
           if (firstTimeOldTransport) {
-            AutoRecursiveLock lock(*this);
+            ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
             oldTransport = mSecureTransportOld.lock();
           }
 
@@ -1714,7 +1742,7 @@ namespace ortc
 
           bool handled = oldTransport->handleReceivedPacket(mComponent, deliverPacket->BytePtr(), deliverPacket->SizeInBytes());
           if (!handled) {
-            AutoRecursiveLock lock(*this);
+            ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
             auto oldTransportID = transport->getID();
 
@@ -1731,7 +1759,7 @@ namespace ortc
 
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         if (mBufferedPackets.size() > 0) {
           auto pThis = mThisWeak.lock();
           if (pThis) {
@@ -1760,7 +1788,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       mWakeUp = false;
       step();
     }
@@ -1785,7 +1813,7 @@ namespace ortc
 
       ZS_LOG_TRACE(log("timer fired") + ZS_PARAM("timer id", timer->getID()))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (timer == mExpireRouteTimer) {
         ZS_EVENTING_3(
@@ -1861,7 +1889,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::onPromiseSettled(PromisePtr promise)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto found = mFrozen.find(promise);
       if (found == mFrozen.end()) {
@@ -1925,7 +1953,7 @@ namespace ortc
                     string, state, IICEGatherer::toString(state)
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       ZS_LOG_TRACE(log("ice gatherer state changed") + ZS_PARAM("gather id", gatherer->getID()) + ZS_PARAM("state", IICEGatherer::toString(state)))
       wakeUp();
     }
@@ -1956,7 +1984,7 @@ namespace ortc
                      word, relatedPort, candidate->mRelatedPort
                      );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (gatherer != mGatherer) {
         ZS_LOG_WARNING(Debug, log("notified about candidate on non-associated gatherer") + ZS_PARAM("gatherer", gatherer->getID()) + candidate->toDebug())
@@ -2013,7 +2041,7 @@ namespace ortc
 
       ZS_THROW_INVALID_ASSUMPTION_IF(candidate->mComponent != mComponent);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (gatherer != mGatherer) {
         ZS_LOG_WARNING(Debug, log("notified about candidate on non-associated gatherer") + ZS_PARAM("gatherer", gatherer->getID()) + candidate->toDebug())
@@ -2059,7 +2087,7 @@ namespace ortc
                      word, relatedPort, candidate->mRelatedPort
                      );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (gatherer != mGatherer) {
         ZS_LOG_WARNING(Debug, log("notified about candidate on non-associated gatherer") + ZS_PARAM("gatherer", gatherer->getID()) + candidate->toDebug())
@@ -2090,7 +2118,7 @@ namespace ortc
     {
       UseICEGathererPtr gatherer = ICEGatherer::convert(inGatherer);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (gatherer != mGatherer) {
         ZS_LOG_WARNING(Debug, log("notified about error on non-associated gatherer") + ZS_PARAM("gatherer", gatherer->getID()) + errorEvent->toDebug())
@@ -2130,7 +2158,7 @@ namespace ortc
       UseICEGathererPtr gatherer;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (!mGatherer) {
           ZS_LOG_WARNING(Trace, log("no gatherer attached thus cannot send stun request") + ZS_PARAM("stun requester", requester->getID()) + ZS_PARAM("destination ip", destination.string()) + ZS_PARAM("packet size", packet->SizeInBytes()))
@@ -2194,7 +2222,7 @@ namespace ortc
                     );
       response->trace(__func__);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (!mGatherer) {
         ZS_LOG_WARNING(Debug, log("cannot handle stun response when no gatherer is associated"))
@@ -2343,7 +2371,7 @@ namespace ortc
                     puid, stunRequesterId, requester->getID()
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mUseCandidateRequest == requester) {
         ZS_LOG_WARNING(Detail, log("failed to select route to use") + (mUseCandidateRoute ? mUseCandidateRoute->toDebug() : ElementPtr()))
@@ -2397,7 +2425,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr ICETransport::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::ICETransport");
 
@@ -2619,7 +2647,7 @@ namespace ortc
 
         // scope: process legal pairs
         {
-          AutoRecursiveLock lock(*pThis);
+          ORTC_AUTO_RECURSIVE_LOCK(lock, *pThis);
 
           // scope: check if computing pairs has changed since pairs were being computed
           {
@@ -4978,7 +5006,7 @@ namespace ortc
       UseSecureTransportPtr transport;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         auto found = mGathererRoutes.find(routerRoute->mID);
         if (found == mGathererRoutes.end()) {
           ZS_LOG_WARNING(Detail, log("route was not found") + routerRoute->toDebug() + packet->toDebug())
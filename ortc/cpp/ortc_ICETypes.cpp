@@ -81,12 +81,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IICETypes::Roles IICETypes::toRole(const char *role) throw (InvalidParameters)
   {
-    String str(role);
-    for (IICETypes::Roles index = IICETypes::Role_First; index <= IICETypes::Role_Last; index = static_cast<IICETypes::Roles>(static_cast<std::underlying_type<IICETypes::Roles>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IICETypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IICETypes::Roles> table(IICETypes::Role_First, IICETypes::Role_Last, IICETypes::toString, false);
+
+    IICETypes::Roles result {};
+    if (table.find(role, result)) return result;
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(role))
     return Role_First;
   }
 
@@ -111,12 +111,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IICETypes::Components IICETypes::toComponent(const char *component) throw (InvalidParameters)
   {
-    String str(component);
-    for (IICETypes::Components index = IICETypes::Component_First; index <= IICETypes::Component_Last; index = static_cast<IICETypes::Components>(static_cast<std::underlying_type<IICETypes::Components>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IICETypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IICETypes::Components> table(IICETypes::Component_First, IICETypes::Component_Last, IICETypes::toString, false);
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    IICETypes::Components result {};
+    if (table.find(component, result)) return result;
+
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(component))
     return Component_First;
   }
 
@@ -141,12 +141,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IICETypes::Protocols IICETypes::toProtocol(const char *protocol) throw (InvalidParameters)
   {
-    String str(protocol);
-    for (IICETypes::Protocols index = IICETypes::Protocol_First; index <= IICETypes::Protocol_Last; index = static_cast<IICETypes::Protocols>(static_cast<std::underlying_type<IICETypes::Protocols>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IICETypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IICETypes::Protocols> table(IICETypes::Protocol_First, IICETypes::Protocol_Last, IICETypes::toString, false);
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    IICETypes::Protocols result {};
+    if (table.find(protocol, result)) return result;
+
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(protocol))
     return Protocol_First;
   }
 
@@ -173,12 +173,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IICETypes::CandidateTypes IICETypes::toCandidateType(const char *candidateType) throw (InvalidParameters)
   {
-    String str(candidateType);
-    for (IICETypes::CandidateTypes index = IICETypes::CandidateType_First; index <= IICETypes::CandidateType_Last; index = static_cast<IICETypes::CandidateTypes>(static_cast<std::underlying_type<IICETypes::CandidateTypes>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IICETypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IICETypes::CandidateTypes> table(IICETypes::CandidateType_First, IICETypes::CandidateType_Last, IICETypes::toString, false);
+
+    IICETypes::CandidateTypes result {};
+    if (table.find(candidateType, result)) return result;
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(candidateType))
     return CandidateType_First;
   }
 
@@ -204,12 +204,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IICETypes::TCPCandidateTypes IICETypes::toTCPCandidateType(const char *tcpCandidateType) throw (InvalidParameters)
   {
-    String str(tcpCandidateType);
-    for (IICETypes::TCPCandidateTypes index = IICETypes::TCPCandidateType_First; index <= IICETypes::TCPCandidateType_Last; index = static_cast<IICETypes::TCPCandidateTypes>(static_cast<std::underlying_type<IICETypes::TCPCandidateTypes>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IICETypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IICETypes::TCPCandidateTypes> table(IICETypes::TCPCandidateType_First, IICETypes::TCPCandidateType_Last, IICETypes::toString, false);
+
+    IICETypes::TCPCandidateTypes result {};
+    if (table.find(tcpCandidateType, result)) return result;
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(tcpCandidateType))
     return TCPCandidateType_First;
   }
 
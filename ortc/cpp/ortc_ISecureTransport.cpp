@@ -397,6 +397,38 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(ForRTPListener, transport);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ISecureTransportForRTPCapture
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr ISecureTransportForRTPCapture::toDebug(ForRTPCapturePtr transport)
+    {
+      if (!transport) return ElementPtr();
+
+      {
+        auto pThis = DTLSTransport::convert(transport);
+        if (pThis) return DTLSTransport::toDebug(pThis);
+      }
+
+      {
+        auto pThis = SRTPSDESTransport::convert(transport);
+        if (pThis) return SRTPSDESTransport::toDebug(pThis);
+      }
+      return ElementPtr();
+    }
+
+    //-------------------------------------------------------------------------
+    ISecureTransportForRTPCapture::ForRTPCapturePtr ISecureTransportForRTPCapture::convert(IRTPTransportPtr transport)
+    {
+      if (!transport) return ForRTPCapturePtr();
+      return ZS_DYNAMIC_PTR_CAST(ForRTPCapture, transport);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
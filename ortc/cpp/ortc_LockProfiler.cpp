@@ -0,0 +1,323 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_LockProfiler.h>
+#include <ortc/internal/platform.h>
+
+#include <zsLib/Log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LockProfiler
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    const char *LockProfiler::toString(Metrics metric)
+    {
+      switch (metric) {
+        case Metric_WaitTime:     return "wait time";
+        case Metric_HoldTime:     return "hold time";
+        case Metric_Contentions:  return "contentions";
+      }
+      return "UNDEFINED";
+    }
+
+    //-------------------------------------------------------------------------
+    bool LockProfiler::isEnabled()
+    {
+#ifdef ORTC_LOCK_PROFILING
+      return true;
+#else
+      return false;
+#endif //ORTC_LOCK_PROFILING
+    }
+
+    //-------------------------------------------------------------------------
+    String LockProfiler::toReport(Metrics sortBy)
+    {
+      std::vector<const Site *> all;
+      for (const Site *site = sites().load(std::memory_order_acquire); NULL != site; site = site->mNext) {
+        if (0 == site->mAcquired.load(std::memory_order_relaxed)) continue;
+        all.push_back(site);
+      }
+
+      std::stable_sort(all.begin(), all.end(), [sortBy](const Site *op1, const Site *op2) -> bool {
+        return value(*op1, sortBy) > value(*op2, sortBy);
+      });
+
+      std::stringstream output;
+      output << "lock profile (sorted by " << toString(sortBy) << ", times in milliseconds)\n";
+      output << std::setw(12) << "acquired" << std::setw(12) << "contended"
+             << std::setw(14) << "wait total" << std::setw(12) << "wait max"
+             << std::setw(14) << "hold total" << std::setw(12) << "hold max"
+             << "  lock class / site\n";
+
+      output << std::fixed << std::setprecision(3);
+
+      for (auto iter = all.begin(); iter != all.end(); ++iter) {
+        const Site &site = *(*iter);
+        output << std::setw(12) << site.mAcquired.load(std::memory_order_relaxed)
+               << std::setw(12) << site.mContended.load(std::memory_order_relaxed)
+               << std::setw(14) << (static_cast<double>(site.mTotalWait.load(std::memory_order_relaxed)) / 1000000.0)
+               << std::setw(12) << (static_cast<double>(site.mMaxWait.load(std::memory_order_relaxed)) / 1000000.0)
+               << std::setw(14) << (static_cast<double>(site.mTotalHold.load(std::memory_order_relaxed)) / 1000000.0)
+               << std::setw(12) << (static_cast<double>(site.mMaxHold.load(std::memory_order_relaxed)) / 1000000.0)
+               << "  " << lockClass(site.mFunction) << " " << functionName(site.mFunction) << " (" << site.mFile << ":" << site.mLine << ")\n";
+      }
+
+      return String(output.str());
+    }
+
+    //-------------------------------------------------------------------------
+    String LockProfiler::toFlameGraph(Metrics metric)
+    {
+      std::stringstream output;
+
+      for (const Site *site = sites().load(std::memory_order_acquire); NULL != site; site = site->mNext) {
+        QWORD result = value(*site, metric);
+        if (Metric_Contentions != metric) result /= 1000;  // microseconds
+        if (0 == result) continue;
+
+        // flamegraph.pl uses ';' to split frames and the last space to
+        // find the value so neither may appear inside a frame name
+        String file(site->mFile);
+        file.replaceAll(";", "_");
+        file.replaceAll(" ", "_");
+
+        output << lockClass(site->mFunction) << ";" << functionName(site->mFunction) << ";" << file << ":" << site->mLine << " " << result << "\n";
+      }
+
+      return String(output.str());
+    }
+
+    //-------------------------------------------------------------------------
+    void LockProfiler::reset()
+    {
+      for (Site *site = sites().load(std::memory_order_acquire); NULL != site; site = site->mNext) {
+        site->mAcquired.store(0, std::memory_order_relaxed);
+        site->mContended.store(0, std::memory_order_relaxed);
+        site->mTotalWait.store(0, std::memory_order_relaxed);
+        site->mMaxWait.store(0, std::memory_order_relaxed);
+        site->mTotalHold.store(0, std::memory_order_relaxed);
+        site->mMaxHold.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LockProfiler => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    QWORD LockProfiler::now()
+    {
+      return static_cast<QWORD>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    std::atomic<LockProfiler::Site *> &LockProfiler::sites()
+    {
+      static std::atomic<Site *> head {};
+      return head;
+    }
+
+    //-------------------------------------------------------------------------
+    void LockProfiler::updateMax(
+                                 std::atomic<QWORD> &max,
+                                 QWORD value
+                                 )
+    {
+      QWORD currentMax = max.load(std::memory_order_relaxed);
+      while (value > currentMax) {
+        if (max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD LockProfiler::value(
+                              const Site &site,
+                              Metrics metric
+                              )
+    {
+      switch (metric) {
+        case Metric_WaitTime:     return site.mTotalWait.load(std::memory_order_relaxed);
+        case Metric_HoldTime:     return site.mTotalHold.load(std::memory_order_relaxed);
+        case Metric_Contentions:  return site.mContended.load(std::memory_order_relaxed);
+      }
+      return 0;
+    }
+
+    //-------------------------------------------------------------------------
+    String LockProfiler::lockClass(const char *function)
+    {
+      // e.g. "virtual bool ortc::internal::DTLSTransport::sendPacket(...)"
+      // (gcc/clang) or "ortc::internal::DTLSTransport::sendPacket" (msvc)
+      String name(functionName(function));
+      String qualified(function ? function : "");
+
+      auto paren = qualified.find('(');
+      if (String::npos != paren) qualified = qualified.substr(0, paren);
+      auto space = qualified.rfind(' ');
+      if (String::npos != space) qualified = qualified.substr(space + 1);
+
+      if (qualified.length() <= name.length() + 2) return String("(global)");
+      qualified = qualified.substr(0, qualified.length() - name.length() - 2);
+
+      static const char *prefixes[] = {"ortc::internal::", "ortc::adapter::internal::", "ortc::"};
+      for (size_t index = 0; index < (sizeof(prefixes) / sizeof(prefixes[0])); ++index) {
+        String prefix(prefixes[index]);
+        if (0 == qualified.compare(0, prefix.length(), prefix)) return String(qualified.substr(prefix.length()));
+      }
+      return qualified;
+    }
+
+    //-------------------------------------------------------------------------
+    String LockProfiler::functionName(const char *function)
+    {
+      String qualified(function ? function : "");
+
+      auto paren = qualified.find('(');
+      if (String::npos != paren) qualified = qualified.substr(0, paren);
+
+      auto separator = qualified.rfind("::");
+      if (String::npos != separator) return String(qualified.substr(separator + 2));
+
+      auto space = qualified.rfind(' ');
+      if (String::npos != space) return String(qualified.substr(space + 1));
+      return qualified;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LockProfiler::Site
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    LockProfiler::Site::Site(
+                             const char *file,
+                             ULONG line,
+                             const char *function
+                             ) :
+      mFile(file),
+      mLine(line),
+      mFunction(function)
+    {
+      auto &head = sites();
+      Site *next = head.load(std::memory_order_relaxed);
+      do {
+        mNext = next;
+      } while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    //-------------------------------------------------------------------------
+    void LockProfiler::Site::record(
+                                    bool contended,
+                                    QWORD waitInNanoseconds,
+                                    QWORD holdInNanoseconds
+                                    )
+    {
+      mAcquired.fetch_add(1, std::memory_order_relaxed);
+      if (contended) {
+        mContended.fetch_add(1, std::memory_order_relaxed);
+        mTotalWait.fetch_add(waitInNanoseconds, std::memory_order_relaxed);
+        updateMax(mMaxWait, waitInNanoseconds);
+      }
+      mTotalHold.fetch_add(holdInNanoseconds, std::memory_order_relaxed);
+      updateMax(mMaxHold, holdInNanoseconds);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LockProfiler::ProfiledAutoRecursiveLock
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    LockProfiler::ProfiledAutoRecursiveLock::ProfiledAutoRecursiveLock(
+                                                                       RecursiveLock &lock,
+                                                                       Site &site
+                                                                       ) :
+      mLock(lock),
+      mSite(site)
+    {
+      if (mLock.try_lock()) {
+        mAcquiredAt = now();
+        return;
+      }
+
+      QWORD start = now();
+      mLock.lock();
+      mAcquiredAt = now();
+      mContended = true;
+      mWait = mAcquiredAt - start;
+    }
+
+    //-------------------------------------------------------------------------
+    LockProfiler::ProfiledAutoRecursiveLock::~ProfiledAutoRecursiveLock()
+    {
+      QWORD hold = now() - mAcquiredAt;
+      mLock.unlock();
+      mSite.record(mContended, mWait, hold);
+    }
+
+  }
+}
@@ -0,0 +1,484 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_MessageQueueMonitor.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/SafeInt.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  namespace internal
+  {
+    ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    namespace
+    {
+      //-----------------------------------------------------------------------
+      // Lock free free list of preallocated message wrappers. Wrappers are
+      // usually created on the posting thread and destroyed on the queue's
+      // thread so a single shared list is used; the tag kept in the upper
+      // half of the head guards against ABA.
+      class MonitoredMessagePool
+      {
+      public:
+        typedef MessageQueueMonitor::MonitoredMessage MonitoredMessage;
+        typedef std::aligned_storage<sizeof(MonitoredMessage), alignof(MonitoredMessage)>::type Slot;
+
+        enum Constants
+        {
+          kSize = MessageQueueMonitor::kMessagePoolSize,
+        };
+
+        //---------------------------------------------------------------------
+        MonitoredMessagePool()
+        {
+          for (size_t index = 0; index < kSize; ++index) {
+            mNext[index].store(static_cast<DWORD>(index + 1 < kSize ? index + 2 : 0), std::memory_order_relaxed);
+          }
+          mHead.store(1, std::memory_order_release);
+        }
+
+        //---------------------------------------------------------------------
+        static MonitoredMessagePool &singleton()
+        {
+          static MonitoredMessagePool pool;
+          return pool;
+        }
+
+        //---------------------------------------------------------------------
+        void *pop()
+        {
+          QWORD head = mHead.load(std::memory_order_acquire);
+          while (true) {
+            DWORD first = static_cast<DWORD>(head & 0xFFFFFFFF);
+            if (0 == first) return NULL;
+
+            QWORD next = ((static_cast<QWORD>((head >> 32) + 1)) << 32) | static_cast<QWORD>(mNext[first - 1].load(std::memory_order_relaxed));
+            if (mHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire)) return &(mSlots[first - 1]);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        bool push(void *ptr)
+        {
+          uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+          uintptr_t begin = reinterpret_cast<uintptr_t>(&(mSlots[0]));
+          if ((address < begin) || (address >= begin + sizeof(mSlots))) return false;
+
+          DWORD index = static_cast<DWORD>((address - begin) / sizeof(Slot)) + 1;
+
+          QWORD head = mHead.load(std::memory_order_relaxed);
+          while (true) {
+            mNext[index - 1].store(static_cast<DWORD>(head & 0xFFFFFFFF), std::memory_order_relaxed);
+
+            QWORD next = ((static_cast<QWORD>((head >> 32) + 1)) << 32) | static_cast<QWORD>(index);
+            if (mHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed)) return true;
+          }
+        }
+
+      protected:
+        Slot mSlots[kSize];
+        std::atomic<DWORD> mNext[kSize];    // index + 1 of the next free slot (0 = none)
+        std::atomic<QWORD> mHead {};        // tag (upper 32 bits) | index + 1 of the first free slot
+      };
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    const char *MessageQueueMonitor::toString(Queues queue)
+    {
+      switch (queue) {
+        case Queue_ORTC:                    return "ortc";
+        case Queue_ORTCPipeline:            return "ortcPipeline";
+        case Queue_Packet:                  return "packet";
+        case Queue_BlockingMediaStartStop:  return "blockingMediaStartStop";
+        case Queue_MediaChannelStartStop:   return "mediaChannelStartStop";
+        case Queue_CertificateGeneration:   return "certificateGeneration";
+      }
+      return "UNDEFINED";
+    }
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MessageQueueMonitor()
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr MessageQueueMonitor::monitor(
+                                                  Queues queue,
+                                                  IMessageQueuePtr original
+                                                  )
+    {
+      if (!original) return original;
+      if (!ISettings::getBool(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_ENABLED)) return original;
+
+      return make_shared<MonitoredQueue>(monitors()[queue], original);
+    }
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::PromiseWithStatsReportPtr MessageQueueMonitor::getStats(const StatsTypeSet &stats)
+    {
+      if (!stats.hasStatType(IStatsReportTypes::StatsType_MessageQueue)) {
+        return PromiseWithStatsReport::createRejected(IORTCForInternal::queueDelegate());
+      }
+
+      size_t totalTopMethods = SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_TOP_METHODS));
+
+      UseStatsReport::StatMap allStats;
+      for (size_t index = Queue_First; index <= Queue_Last; ++index) {
+        auto result = monitors()[index].createStats(static_cast<Queues>(index), totalTopMethods);
+        allStats[result->mID] = result;
+      }
+
+      auto promise = PromiseWithStatsReport::create(IORTCForInternal::queueDelegate());
+      promise->resolve(UseStatsReport::create(allStats));
+      return promise;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor *MessageQueueMonitor::monitors()
+    {
+      static MessageQueueMonitor all[Queue_Last + 1];
+      return all;
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::notifyPosted()
+    {
+      QWORD posted = mPosted.fetch_add(1, std::memory_order_relaxed) + 1;
+      QWORD processed = mProcessed.load(std::memory_order_relaxed);
+      if (posted > processed) updateMax(mPeakDepth, posted - processed);
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::notifyDequeued(QWORD dwellInMicroseconds)
+    {
+      mProcessed.fetch_add(1, std::memory_order_relaxed);
+      mDwell.record(dwellInMicroseconds);
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::notifyDiscarded()
+    {
+      mProcessed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::notifyExecuted(
+                                             const char *delegateName,
+                                             const char *methodName,
+                                             QWORD executionInMicroseconds
+                                             )
+    {
+      auto &usage = findMethod(delegateName, methodName);
+      usage.mCount.fetch_add(1, std::memory_order_relaxed);
+      usage.mTotal.fetch_add(executionInMicroseconds, std::memory_order_relaxed);
+      updateMax(usage.mMax, executionInMicroseconds);
+    }
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MethodUsage &MessageQueueMonitor::findMethod(
+                                                                      const char *delegateName,
+                                                                      const char *methodName
+                                                                      )
+    {
+      // proxy names have static storage so their addresses identify the
+      // method without touching the strings; the same name living at
+      // different addresses (e.g. literals from different modules) is
+      // merged when the stats are created
+      size_t hash = (static_cast<size_t>(reinterpret_cast<uintptr_t>(delegateName)) * 31) ^ static_cast<size_t>(reinterpret_cast<uintptr_t>(methodName));
+      hash ^= (hash >> 7) ^ (hash >> 17);
+
+      for (size_t probe = 0; probe < kMaxMethods; ++probe) {
+        auto &usage = mMethods[(hash + probe) % kMaxMethods];
+
+        int state = usage.mState.load(std::memory_order_acquire);
+        if (MethodUsage::State_Empty == state) {
+          if (usage.mState.compare_exchange_strong(state, MethodUsage::State_Claiming, std::memory_order_acq_rel)) {
+            usage.mDelegateName = delegateName;
+            usage.mMethodName = methodName;
+            usage.mState.store(MethodUsage::State_Ready, std::memory_order_release);
+            return usage;
+          }
+        }
+
+        // another thread is filling in this entry (only ever momentarily)
+        while (MethodUsage::State_Claiming == state) {
+          std::this_thread::yield();
+          state = usage.mState.load(std::memory_order_acquire);
+        }
+
+        if ((usage.mDelegateName == delegateName) &&
+            (usage.mMethodName == methodName)) return usage;
+      }
+
+      return mOtherMethods;
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::MessageQueueStatsPtr MessageQueueMonitor::createStats(
+                                                                             Queues queue,
+                                                                             size_t totalTopMethods
+                                                                             ) const
+    {
+      typedef IStatsReportTypes::MessageQueueStats::MethodUsage StatsMethodUsage;
+
+      auto result = make_shared<IStatsReportTypes::MessageQueueStats>();
+      result->mID = String(IStatsReportTypes::toString(IStatsReportTypes::StatsType_MessageQueue)) + "_" + toString(queue);
+      result->mTimestamp = zsLib::now();
+
+      QWORD posted = mPosted.load(std::memory_order_relaxed);
+      QWORD processed = mProcessed.load(std::memory_order_relaxed);
+
+      result->mQueueName = toString(queue);
+      result->mPosted = posted;
+      result->mProcessed = processed;
+      result->mCurrentDepth = SafeInt<unsigned long>(posted > processed ? posted - processed : 0);
+      result->mPeakDepth = SafeInt<unsigned long>(mPeakDepth.load(std::memory_order_relaxed));
+      mDwell.snapshot(result->mDwell);
+
+      std::vector<StatsMethodUsage> methods;
+
+      auto addMethod = [&methods](const MethodUsage &usage, const char *delegateName, const char *methodName) {
+        QWORD count = usage.mCount.load(std::memory_order_relaxed);
+        if (0 == count) return;
+
+        delegateName = delegateName ? delegateName : "";
+        methodName = methodName ? methodName : "";
+
+        for (auto iter = methods.begin(); iter != methods.end(); ++iter) {
+          auto &existing = (*iter);
+          if ((existing.mDelegateName != delegateName) ||
+              (existing.mMethodName != methodName)) continue;
+
+          existing.mCount += count;
+          existing.mTotal += static_cast<double>(usage.mTotal.load(std::memory_order_relaxed)) / 1000.0;
+          existing.mAverage = existing.mTotal / static_cast<double>(existing.mCount);
+          existing.mMax = std::max(existing.mMax, static_cast<double>(usage.mMax.load(std::memory_order_relaxed)) / 1000.0);
+          return;
+        }
+
+        StatsMethodUsage info;
+        info.mDelegateName = delegateName;
+        info.mMethodName = methodName;
+        info.mCount = count;
+        info.mTotal = static_cast<double>(usage.mTotal.load(std::memory_order_relaxed)) / 1000.0;
+        info.mAverage = info.mTotal / static_cast<double>(count);
+        info.mMax = static_cast<double>(usage.mMax.load(std::memory_order_relaxed)) / 1000.0;
+        methods.push_back(info);
+      };
+
+      for (size_t index = 0; index < kMaxMethods; ++index) {
+        auto &usage = mMethods[index];
+        if (MethodUsage::State_Ready != usage.mState.load(std::memory_order_acquire)) continue;
+        addMethod(usage, usage.mDelegateName, usage.mMethodName);
+      }
+      addMethod(mOtherMethods, "(other)", "(other)");
+
+      size_t total = std::min(totalTopMethods, methods.size());
+      std::partial_sort(methods.begin(), methods.begin() + total, methods.end(), [](const StatsMethodUsage &op1, const StatsMethodUsage &op2) -> bool {
+        return op1.mTotal > op2.mTotal;
+      });
+
+      for (size_t index = 0; index < total; ++index) {
+        result->mTopMethods.push_back(methods[index]);
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::updateMax(
+                                        std::atomic<QWORD> &max,
+                                        QWORD value
+                                        )
+    {
+      QWORD currentMax = max.load(std::memory_order_relaxed);
+      while (value > currentMax) {
+        if (max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor::MonitoredQueue
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MonitoredQueue::MonitoredQueue(
+                                                        MessageQueueMonitor &monitor,
+                                                        IMessageQueuePtr queue
+                                                        ) :
+      mMonitor(monitor),
+      mQueue(queue)
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF(!queue);
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::MonitoredQueue::post(IMessageQueueMessageUPtr message)
+    {
+      if (!message) return;
+
+      IMessageQueueMessageUPtr monitored(new MonitoredMessage(mMonitor, std::move(message)));
+      mMonitor.notifyPosted();
+      mQueue->post(std::move(monitored));
+    }
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MonitoredQueue::size_type MessageQueueMonitor::MonitoredQueue::getTotalUnprocessedMessages() const
+    {
+      return mQueue->getTotalUnprocessedMessages();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor::MonitoredMessage
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MonitoredMessage::MonitoredMessage(
+                                                            MessageQueueMonitor &monitor,
+                                                            IMessageQueueMessageUPtr message
+                                                            ) :
+      mMonitor(monitor),
+      mMessage(std::move(message)),
+      mPostedAt(PacketPipelineLatency::now())
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    MessageQueueMonitor::MonitoredMessage::~MonitoredMessage()
+    {
+      // a queue shutting down can destroy messages without processing them
+      if (!mDequeued) mMonitor.notifyDiscarded();
+    }
+
+    //-------------------------------------------------------------------------
+    const char *MessageQueueMonitor::MonitoredMessage::getDelegateName() const
+    {
+      return mMessage->getDelegateName();
+    }
+
+    //-------------------------------------------------------------------------
+    const char *MessageQueueMonitor::MonitoredMessage::getMethodName() const
+    {
+      return mMessage->getMethodName();
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::MonitoredMessage::processMessage()
+    {
+      QWORD start = PacketPipelineLatency::now();
+
+      if (!mDequeued) {
+        mDequeued = true;
+        mMonitor.notifyDequeued(start - mPostedAt);
+      }
+
+      mMessage->processMessage();
+
+      mMonitor.notifyExecuted(mMessage->getDelegateName(), mMessage->getMethodName(), PacketPipelineLatency::now() - start);
+    }
+
+    //-------------------------------------------------------------------------
+    void *MessageQueueMonitor::MonitoredMessage::operator new(size_t size)
+    {
+      if (sizeof(MonitoredMessage) == size) {
+        void *result = MonitoredMessagePool::singleton().pop();
+        if (result) return result;
+      }
+      return ::operator new(size);
+    }
+
+    //-------------------------------------------------------------------------
+    void MessageQueueMonitor::MonitoredMessage::operator delete(void *ptr)
+    {
+      if (!ptr) return;
+      if (MonitoredMessagePool::singleton().push(ptr)) return;
+      ::operator delete(ptr);
+    }
+
+  }
+}
@@ -0,0 +1,340 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_NetworkImpairment.h>
+#include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/SafeInt.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(NetworkImpairmentSettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairmentSettingsDefaults
+    #pragma mark
+
+    class NetworkImpairmentSettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~NetworkImpairmentSettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static NetworkImpairmentSettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<NetworkImpairmentSettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static NetworkImpairmentSettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<NetworkImpairmentSettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        // impairment is for testing only and is never enabled by default
+        ISettings::setBool(ORTC_SETTING_NETWORK_IMPAIRMENT_ENABLED, false);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_SEED, 1);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_LOSS_PER_MILLE, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BURST_LOSS_PER_MILLE, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DELAY_IN_MILLISECONDS, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_JITTER_IN_MILLISECONDS, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_PER_MILLE, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_DELAY_IN_MILLISECONDS, 10);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DUPLICATE_PER_MILLE, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BANDWIDTH_IN_KBITS_PER_SECOND, 0);
+        ISettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_QUEUE_SIZE_IN_BYTES, 64*1024);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installNetworkImpairmentSettingsDefaults()
+    {
+      NetworkImpairmentSettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairment::Parameters
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    NetworkImpairment::Parameters NetworkImpairment::Parameters::createFromSettings()
+    {
+      Parameters result;
+
+      result.mEnabled = ISettings::getBool(ORTC_SETTING_NETWORK_IMPAIRMENT_ENABLED);
+      if (!result.mEnabled) return result;
+
+      result.mSeed = ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_SEED);
+      result.mLossPerMille = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_LOSS_PER_MILLE));
+      result.mBurstLossPerMille = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BURST_LOSS_PER_MILLE));
+      result.mDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DELAY_IN_MILLISECONDS));
+      result.mJitter = Milliseconds(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_JITTER_IN_MILLISECONDS));
+      result.mReorderPerMille = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_PER_MILLE));
+      result.mReorderDelay = Milliseconds(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_DELAY_IN_MILLISECONDS));
+      result.mDuplicatePerMille = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DUPLICATE_PER_MILLE));
+      result.mBandwidthInKbitsPerSecond = SafeInt<ULONG>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BANDWIDTH_IN_KBITS_PER_SECOND));
+      result.mQueueSizeInBytes = SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_QUEUE_SIZE_IN_BYTES));
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr NetworkImpairment::Parameters::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::NetworkImpairment::Parameters");
+
+      IHelper::debugAppend(resultEl, "enabled", mEnabled);
+      IHelper::debugAppend(resultEl, "seed", mSeed);
+      IHelper::debugAppend(resultEl, "loss (per mille)", mLossPerMille);
+      IHelper::debugAppend(resultEl, "burst loss (per mille)", mBurstLossPerMille);
+      IHelper::debugAppend(resultEl, "delay", mDelay);
+      IHelper::debugAppend(resultEl, "jitter", mJitter);
+      IHelper::debugAppend(resultEl, "reorder (per mille)", mReorderPerMille);
+      IHelper::debugAppend(resultEl, "reorder delay", mReorderDelay);
+      IHelper::debugAppend(resultEl, "duplicate (per mille)", mDuplicatePerMille);
+      IHelper::debugAppend(resultEl, "bandwidth (kbits per second)", mBandwidthInKbitsPerSecond);
+      IHelper::debugAppend(resultEl, "queue size (bytes)", mQueueSizeInBytes);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairment::Stats
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr NetworkImpairment::Stats::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::NetworkImpairment::Stats");
+
+      IHelper::debugAppend(resultEl, "packets submitted", mPacketsSubmitted);
+      IHelper::debugAppend(resultEl, "bytes submitted", mBytesSubmitted);
+      IHelper::debugAppend(resultEl, "packets scheduled", mPacketsScheduled);
+      IHelper::debugAppend(resultEl, "bytes scheduled", mBytesScheduled);
+      IHelper::debugAppend(resultEl, "packets lost", mPacketsLost);
+      IHelper::debugAppend(resultEl, "packets dropped", mPacketsDropped);
+      IHelper::debugAppend(resultEl, "packets duplicated", mPacketsDuplicated);
+      IHelper::debugAppend(resultEl, "packets reordered", mPacketsReordered);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairment
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    NetworkImpairment::NetworkImpairment(const Parameters &params) :
+      mParams(params)
+    {
+      // splitmix64 spreads small seeds (1, 2, 3...) across the whole state;
+      // xorshift must never start from 0
+      QWORD seed = params.mSeed + 0x9E3779B97F4A7C15ULL;
+      seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+      seed = seed ^ (seed >> 31);
+
+      mRandomState = (0 != seed ? seed : 0x9E3779B97F4A7C15ULL);
+    }
+
+    //-------------------------------------------------------------------------
+    NetworkImpairmentPtr NetworkImpairment::create(const Parameters &params)
+    {
+      if (!params.mEnabled) return NetworkImpairmentPtr();
+      return make_shared<NetworkImpairment>(params);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t NetworkImpairment::schedule(
+                                       const Time &now,
+                                       size_t packetSizeInBytes,
+                                       Time (&outSendAt)[ScheduleLimit_MaxCopies]
+                                       )
+    {
+      // the same number of draws is made for every packet so changing one
+      // parameter does not shift the decisions made for all the others
+      bool lost = ((mInLossBurst) && (0 != mParams.mBurstLossPerMille) ? chance(mParams.mBurstLossPerMille) : chance(mParams.mLossPerMille));
+      bool duplicate = chance(mParams.mDuplicatePerMille);
+      bool reorder = chance(mParams.mReorderPerMille);
+      Microseconds jitter = randomJitter();
+
+      ++mStats.mPacketsSubmitted;
+      mStats.mBytesSubmitted += packetSizeInBytes;
+
+      mInLossBurst = lost;
+      if (lost) {
+        ++mStats.mPacketsLost;
+        return 0;
+      }
+
+      Time departAt = now;
+
+      if (0 != mParams.mBandwidthInKbitsPerSecond) {
+        if (mLinkFreeAt < now) mLinkFreeAt = now;
+
+        QWORD backlogInBytes = static_cast<QWORD>(zsLib::toMicroseconds(mLinkFreeAt - now).count()) * mParams.mBandwidthInKbitsPerSecond / 8000;
+        if ((0 != backlogInBytes) &&
+            (backlogInBytes + packetSizeInBytes > mParams.mQueueSizeInBytes)) {
+          ++mStats.mPacketsDropped;
+          return 0;
+        }
+
+        mLinkFreeAt += Microseconds(static_cast<QWORD>(packetSizeInBytes) * 8000 / mParams.mBandwidthInKbitsPerSecond);
+        departAt = mLinkFreeAt;
+      }
+
+      Time sendAt = departAt + mParams.mDelay + jitter;
+      if (sendAt < departAt) sendAt = departAt;
+
+      if (reorder) {
+        // held back so the packets after it overtake; does not move the in
+        // order watermark
+        sendAt += mParams.mReorderDelay;
+        ++mStats.mPacketsReordered;
+      } else {
+        if (sendAt < mLastInOrderAt) sendAt = mLastInOrderAt;
+        mLastInOrderAt = sendAt;
+      }
+
+      size_t copies = 0;
+      outSendAt[copies++] = sendAt;
+      if (duplicate) {
+        outSendAt[copies++] = sendAt;
+        ++mStats.mPacketsDuplicated;
+      }
+
+      mStats.mPacketsScheduled += copies;
+      mStats.mBytesScheduled += (packetSizeInBytes * copies);
+
+      return copies;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr NetworkImpairment::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::NetworkImpairment");
+
+      IHelper::debugAppend(resultEl, mParams.toDebug());
+      IHelper::debugAppend(resultEl, mStats.toDebug());
+      IHelper::debugAppend(resultEl, "in loss burst", mInLossBurst);
+      IHelper::debugAppend(resultEl, "link free at", mLinkFreeAt);
+      IHelper::debugAppend(resultEl, "last in order at", mLastInOrderAt);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairment => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    QWORD NetworkImpairment::random()
+    {
+      // xorshift64*
+      QWORD value = mRandomState;
+      value ^= value >> 12;
+      value ^= value << 25;
+      value ^= value >> 27;
+      mRandomState = value;
+      return value * 0x2545F4914F6CDD1DULL;
+    }
+
+    //-------------------------------------------------------------------------
+    bool NetworkImpairment::chance(ULONG perMille)
+    {
+      QWORD value = random() % 1000;
+      return value < static_cast<QWORD>(perMille);
+    }
+
+    //-------------------------------------------------------------------------
+    Microseconds NetworkImpairment::randomJitter()
+    {
+      QWORD value = random();
+
+      auto range = zsLib::toMicroseconds(mParams.mJitter).count();
+      if (range <= 0) return Microseconds();
+
+      // uniform in [-jitter, +jitter]
+      auto offset = static_cast<decltype(range)>(value % static_cast<QWORD>((range * 2) + 1));
+      return Microseconds(offset - range);
+    }
+
+  }
+}
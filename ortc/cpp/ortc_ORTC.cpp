@@ -33,7 +33,9 @@
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
 #include <ortc/internal/ortc.stats.events.h>
+#include <ortc/internal/ortc_MessageQueueMonitor.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
+#include <ortc/internal/ortc_StatsReport.h>
 
 #include <ortc/services/IHelper.h>
 #include <ortc/services/ILogger.h>
@@ -59,21 +61,25 @@ namespace ortc
 
     void initSubsystems();
     void installORTCSettingsDefaults();
+    void installActiveSpeakerDetectorSettingsDefaults();
     void installCertificateSettingsDefaults();
     void installDataChannelSettingsDefaults();
     void installDTMFSenderSettingsDefaults();
     void installDTLSTransportSettingsDefaults();
     void installICEGathererSettingsDefaults();
+    void installICEGathererPoolSettingsDefaults();
     void installICETransportSettingsDefaults();
     void installIdentitySettingsDefaults();
     void installMediaDevicesSettingsDefaults();
     void installMediaStreamTrackSettingsDefaults();
+    void installNetworkImpairmentSettingsDefaults();
     void installRTPListenerSettingsDefaults();
     void installRTPMediaEngineSettingsDefaults();
     void installRTPReceiverSettingsDefaults();
     void installRTPReceiverChannelAudioSettingsDefaults();
     void installRTPReceiverChannelSettingsDefaults();
     void installRTPReceiverChannelVideoSettingsDefaults();
+    void installRTPRelaySettingsDefaults();
     void installRTPSenderSettingsDefaults();
     void installRTPSenderChannelSettingsDefaults();
     void installRTPSenderChannelAudioSettingsDefaults();
@@ -88,21 +94,25 @@ namespace ortc
     static void installAllDefaults()
     {
       installORTCSettingsDefaults();
+      installActiveSpeakerDetectorSettingsDefaults();
       installCertificateSettingsDefaults();
       installDataChannelSettingsDefaults();
       installDTMFSenderSettingsDefaults();
       installDTLSTransportSettingsDefaults();
       installICEGathererSettingsDefaults();
+      installICEGathererPoolSettingsDefaults();
       installICETransportSettingsDefaults();
       installIdentitySettingsDefaults();
       installMediaDevicesSettingsDefaults();
       installMediaStreamTrackSettingsDefaults();
+      installNetworkImpairmentSettingsDefaults();
       installRTPListenerSettingsDefaults();
       installRTPMediaEngineSettingsDefaults();
       installRTPReceiverSettingsDefaults();
       installRTPReceiverChannelAudioSettingsDefaults();
       installRTPReceiverChannelSettingsDefaults();
       installRTPReceiverChannelVideoSettingsDefaults();
+      installRTPRelaySettingsDefaults();
       installRTPSenderSettingsDefaults();
       installRTPSenderChannelSettingsDefaults();
       installRTPSenderChannelAudioSettingsDefaults();
@@ -153,6 +163,9 @@ namespace ortc
         ISettings::setString(ZSLIB_SETTING_SOCKET_MONITOR_THREAD_PRIORITY, zsLib::toString(zsLib::ThreadPriority_HighPriority));
         ISettings::setString(ORTC_QUEUE_THREAD_MAIN_PRIORITY, zsLib::toString(zsLib::ThreadPriority_NormalPriority));
         ISettings::setString(ORTC_QUEUE_THREAD_PIPELINE_PRIORITY, zsLib::toString(zsLib::ThreadPriority_HighPriority));
+
+        ISettings::setBool(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_ENABLED, true);
+        ISettings::setUInt(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_TOP_METHODS, 10);
       }
       
     };
@@ -207,6 +220,12 @@ namespace ortc
       return (ORTC::singleton())->queueBlockingMediaStartStopThread();
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr IORTCForInternal::queueMediaChannelStartStop()
+    {
+      return (ORTC::singleton())->queueMediaChannelStartStop();
+    }
+
     //-------------------------------------------------------------------------
     IMessageQueuePtr IORTCForInternal::queueCertificateGeneration()
     {
@@ -441,7 +460,10 @@ namespace ortc
         }
       };
       static Once once;
-      return UseMessageQueueManager::getThreadPoolQueue(ORTC_QUEUE_MAIN_THREAD_NAME);
+
+      // every object gets its own strand; the monitor reports all strands
+      // of the pool together
+      return MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_ORTC, UseMessageQueueManager::getThreadPoolQueue(ORTC_QUEUE_MAIN_THREAD_NAME));
     }
 
     //-------------------------------------------------------------------------
@@ -455,7 +477,7 @@ namespace ortc
         }
       };
       static Once once;
-      return UseMessageQueueManager::getThreadPoolQueue(ORTC_QUEUE_PIPELINE_THREAD_NAME);
+      return MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_ORTCPipeline, UseMessageQueueManager::getThreadPoolQueue(ORTC_QUEUE_PIPELINE_THREAD_NAME));
     }
 
     //-------------------------------------------------------------------------
@@ -466,7 +488,7 @@ namespace ortc
       size_t index = mNextPacketQueueThread % ORTC_QUEUE_TOTAL_PACKET_THREADS;
 
       if (!mPacketQueues[index]) {
-        mPacketQueues[index] = UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_PACKET_THREAD_NAME) + string(index)).c_str());
+        mPacketQueues[index] = MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_Packet, UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_PACKET_THREAD_NAME) + string(index)).c_str()));
       }
 
       ++mNextPacketQueueThread;
@@ -478,17 +500,32 @@ namespace ortc
     {
       AutoRecursiveLock lock(*this);
       if (!mBlockingMediaStartStopThread) {
-        mBlockingMediaStartStopThread = UseMessageQueueManager::getMessageQueue(ORTC_QUEUE_BLOCKING_MEDIA_STARTUP_THREAD_NAME);
+        mBlockingMediaStartStopThread = MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_BlockingMediaStartStop, UseMessageQueueManager::getMessageQueue(ORTC_QUEUE_BLOCKING_MEDIA_STARTUP_THREAD_NAME));
       }
       return mBlockingMediaStartStopThread;
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr ORTC::queueMediaChannelStartStop() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      size_t index = mNextMediaChannelQueueThread % ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS;
+
+      if (!mMediaChannelQueues[index]) {
+        mMediaChannelQueues[index] = MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_MediaChannelStartStop, UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_MEDIA_CHANNEL_THREAD_NAME) + string(index)).c_str()));
+      }
+
+      ++mNextMediaChannelQueueThread;
+      return mMediaChannelQueues[index];
+    }
+
     //-------------------------------------------------------------------------
     IMessageQueuePtr ORTC::queueCertificateGeneration() const
     {
       AutoRecursiveLock lock(*this);
       if (!mCertificateGeneration) {
-        mCertificateGeneration = UseMessageQueueManager::getMessageQueue(ORTC_QUEUE_CERTIFICATE_GENERATION_NAME);
+        mCertificateGeneration = MessageQueueMonitor::monitor(MessageQueueMonitor::Queue_CertificateGeneration, UseMessageQueueManager::getMessageQueue(ORTC_QUEUE_CERTIFICATE_GENERATION_NAME));
       }
       return mCertificateGeneration;
     }
@@ -654,4 +691,34 @@ namespace ortc
     return singleton->isMRPInstalled();
   }
 
+  //-------------------------------------------------------------------------
+  IStatsProvider::PromiseWithStatsReportPtr IORTC::getStats(const IStatsProvider::StatsTypeSet &stats)
+  {
+    typedef internal::IStatsReportForInternal UseStatsReport;
+
+    UseStatsReport::PromiseWithStatsReportList promises;
+
+    if (stats.hasStatType(IStatsReportTypes::StatsType_MessageQueue)) {
+      promises.push_back(internal::MessageQueueMonitor::getStats(stats));
+    }
+
+    if (stats.hasStatType(IStatsReportTypes::StatsType_MediaChannel)) {
+      auto result = internal::MediaChannelLatency::createStats();
+
+      UseStatsReport::StatMap allStats;
+      allStats[result->mID] = result;
+
+      auto promise = IStatsProvider::PromiseWithStatsReport::create(internal::IORTCForInternal::queueDelegate());
+      promise->resolve(UseStatsReport::create(allStats));
+      promises.push_back(promise);
+    }
+
+    if (promises.size() < 1) {
+      return IStatsProvider::PromiseWithStatsReport::createRejected(internal::IORTCForInternal::queueDelegate());
+    }
+    if (1 == promises.size()) return promises.front();
+
+    return UseStatsReport::collectReports(promises);
+  }
+
 }
@@ -344,6 +344,7 @@ namespace ortc
             case TransportLayerFeedbackMessage::GenericNACK::kFmt:  return "GenericNACK";
             case TransportLayerFeedbackMessage::TMMBR::kFmt:        return "TMMBR";
             case TransportLayerFeedbackMessage::TMMBN::kFmt:        return "TMMBN";
+            case TransportLayerFeedbackMessage::TransportCC::kFmt:  return "TransportCC";
             default:                                                break;
           }
           break;
@@ -418,6 +419,149 @@ namespace ortc
       return &(mFirstTMMBN[index]);
     }
 
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC *RTCPPacket::TransportLayerFeedbackMessage::transportCC() const
+    {
+      if (TransportCC::kFmt != fmt()) return NULL;
+      if (!mHasTransportCC) return NULL;
+      return const_cast<TransportCC *>(&mTransportCC);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC::RunLength
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::RunLength::RunLength(PacketChunk chunk) :
+      mStatusSymbol(static_cast<BYTE>(RTCP_GET_BITS(chunk, 0x3, 13))),
+      mRunLength(static_cast<WORD>(RTCP_GET_BITS(chunk, 0x1FFF, 0)))
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC::StatusVector
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::StatusVector::StatusVector(PacketChunk chunk) :
+      mSymbolSize(static_cast<BYTE>(RTCP_GET_BITS(chunk, 0x1, 14))),
+      mSymbolList(static_cast<WORD>(RTCP_GET_BITS(chunk, 0x3FFF, 0)))
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTCPPacket::TransportLayerFeedbackMessage::TransportCC::StatusVector::symbolCount() const
+    {
+      if (0 != mSymbolSize) return kTwoBitSymbolsPerVector;
+      return kOneBitSymbolsPerVector;
+    }
+
+    //-------------------------------------------------------------------------
+    BYTE RTCPPacket::TransportLayerFeedbackMessage::TransportCC::StatusVector::symbolAtIndex(size_t index) const
+    {
+      ASSERT(index < symbolCount())
+
+      if (0 != mSymbolSize) {
+        return static_cast<BYTE>(RTCP_GET_BITS(mSymbolList, 0x3, (12 - (index * 2))));
+      }
+      return static_cast<BYTE>(RTCP_GET_BITS(mSymbolList, 0x1, (13 - index)));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::PacketChunk RTCPPacket::TransportLayerFeedbackMessage::TransportCC::packetChunkAtIndex(size_t index) const
+    {
+      ASSERT(index < mPacketChunkCount)
+      return mPacketChunks[index];
+    }
+
+    //-------------------------------------------------------------------------
+    LONG RTCPPacket::TransportLayerFeedbackMessage::TransportCC::recvDeltaAtIndex(size_t index) const
+    {
+      ASSERT(index < mRecvDeltaCount)
+      return mRecvDeltas[index];
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::TransportLayerFeedbackMessage::TransportCC::isRunLengthChunk(PacketChunk chunk)
+    {
+      return 0 == RTCP_GET_BITS(chunk, 0x1, 15);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::TransportLayerFeedbackMessage::TransportCC::isStatusVectorChunk(PacketChunk chunk)
+    {
+      return 1 == RTCP_GET_BITS(chunk, 0x1, 15);
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::PacketChunk RTCPPacket::TransportLayerFeedbackMessage::TransportCC::createRunLengthChunk(
+                                                                                                                                                   BYTE statusSymbol,
+                                                                                                                                                   size_t runLength
+                                                                                                                                                   )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(statusSymbol > kStatusSymbolReserved)
+      ORTC_THROW_INVALID_PARAMETERS_IF(runLength > kMaxRunLength)
+
+      return static_cast<PacketChunk>(RTCP_PACK_BITS(static_cast<WORD>(statusSymbol), 0x3, 13) |
+                                      RTCP_PACK_BITS(static_cast<WORD>(runLength), 0x1FFF, 0));
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::PacketChunk RTCPPacket::TransportLayerFeedbackMessage::TransportCC::createStatusVectorChunk(
+                                                                                                                                                      const BYTE *statusSymbols,
+                                                                                                                                                      size_t symbolCount,
+                                                                                                                                                      bool twoBitSymbols
+                                                                                                                                                      )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(NULL == statusSymbols)
+      size_t maxSymbols = kOneBitSymbolsPerVector;
+      if (twoBitSymbols) maxSymbols = kTwoBitSymbolsPerVector;
+
+      ORTC_THROW_INVALID_PARAMETERS_IF(symbolCount > maxSymbols)
+
+      WORD result = RTCP_PACK_BITS(static_cast<WORD>(1), 0x1, 15) | RTCP_PACK_BITS(static_cast<WORD>(twoBitSymbols ? 1 : 0), 0x1, 14);
+
+      for (size_t index = 0; index < symbolCount; ++index) {
+        BYTE symbol = statusSymbols[index];
+        if (twoBitSymbols) {
+          ORTC_THROW_INVALID_PARAMETERS_IF(symbol > kStatusSymbolReserved)
+          result |= RTCP_PACK_BITS(static_cast<WORD>(symbol), 0x3, (12 - (index * 2)));
+        } else {
+          ORTC_THROW_INVALID_PARAMETERS_IF(symbol > kStatusSymbolReceivedSmallDelta)
+          result |= RTCP_PACK_BITS(static_cast<WORD>(symbol), 0x1, (13 - index));
+        }
+      }
+
+      return static_cast<PacketChunk>(result);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTCPPacket::TransportLayerFeedbackMessage::TransportCC::getRecvDeltaSize(BYTE statusSymbol)
+    {
+      switch (statusSymbol) {
+        case kStatusSymbolReceivedSmallDelta:           return sizeof(BYTE);
+        case kStatusSymbolReceivedLargeOrNegativeDelta: return sizeof(WORD);
+        default:                                        break;
+      }
+      return 0;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -814,6 +958,56 @@ namespace ortc
       return RTCP_IS_FLAG_SET(chunk, 15);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacket::FeedbackEvent
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    const char *RTCPPacket::FeedbackEvent::toString(Types type)
+    {
+      switch (type) {
+        case Type_GenericNACK:  return "generic nack";
+        case Type_PLI:          return "pli";
+        case Type_FIR:          return "fir";
+        case Type_REMB:         return "remb";
+      }
+      return "UNDEFINED";
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTCPPacket::FeedbackEvent::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTCPPacket::FeedbackEvent");
+
+      UseServicesHelper::debugAppend(resultEl, "type", toString(mType));
+      UseServicesHelper::debugAppend(resultEl, "ssrc of packet sender", mSSRCOfPacketSender);
+      UseServicesHelper::debugAppend(resultEl, "ssrc", mSSRC);
+
+      switch (mType) {
+        case Type_GenericNACK: {
+          UseServicesHelper::debugAppend(resultEl, "pid", mPID);
+          UseServicesHelper::debugAppend(resultEl, "blp", mBLP);
+          break;
+        }
+        case Type_PLI:  break;
+        case Type_FIR: {
+          UseServicesHelper::debugAppend(resultEl, "seq nr", mSeqNr);
+          break;
+        }
+        case Type_REMB: {
+          UseServicesHelper::debugAppend(resultEl, "br exp", mBRExp);
+          UseServicesHelper::debugAppend(resultEl, "br mantissa", mBRMantissa);
+          break;
+        }
+      }
+
+      return resultEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -884,6 +1078,148 @@ namespace ortc
       return temp;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::isReducedSize(
+                                   const BYTE *buffer,
+                                   size_t bufferLengthInBytes
+                                   )
+    {
+      if ((!buffer) ||
+          (bufferLengthInBytes < kMinRtcpPacketLen)) return false;
+
+      return ((SenderReport::kPayloadType != buffer[1]) &&
+              (ReceiverReport::kPayloadType != buffer[1]));
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTCPPacket::convertToCompound(
+                                                     const BYTE *buffer,
+                                                     size_t bufferLengthInBytes,
+                                                     const char *cname
+                                                     )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!buffer)
+      ORTC_THROW_INVALID_PARAMETERS_IF(bufferLengthInBytes < kMinRtcpPacketLen)
+
+      if (!isReducedSize(buffer, bufferLengthInBytes)) return SecureByteBlockPtr();
+
+      // RFC 3550 section 6.1 - a compound packet must contain a CNAME thus
+      // the packet cannot be made compound without one
+      size_t cnameLength = (NULL != cname ? strlen(cname) : 0);
+      if ((0 == cnameLength) ||
+          (cnameLength > 0xFF)) {
+        ZS_LOG_TRACE(packet_slog("cannot convert to compound RTCP (as no valid CNAME is available)") + ZS_PARAM("cname length", cnameLength))
+        return SecureByteBlockPtr();
+      }
+
+      // V=2, P=0, RC=0, PT=RR, length=1 (i.e. header + sender SSRC only)
+      const size_t emptyReportSize = sizeof(DWORD) * 2;
+
+      // header + SSRC + CNAME item (type, length, text) + at least one null
+      // octet ending the item list, padded to a 32-bit boundary
+      size_t sdesSize = (sizeof(DWORD) * 2) + (sizeof(BYTE) * 2) + cnameLength + 1;
+      sdesSize = ((sdesSize + (sizeof(DWORD) - 1)) / sizeof(DWORD)) * sizeof(DWORD);
+
+      DWORD ssrc = 0;
+      if (bufferLengthInBytes >= emptyReportSize) ssrc = RTPUtils::getBE32(&(buffer[sizeof(DWORD)]));
+
+      SecureByteBlockPtr result(make_shared<SecureByteBlock>(emptyReportSize + sdesSize + bufferLengthInBytes));
+      BYTE *pos = result->BytePtr();
+
+      pos[0] = static_cast<BYTE>(kRtpVersion << 6);
+      pos[1] = ReceiverReport::kPayloadType;
+      RTPUtils::setBE16(&(pos[2]), 1);
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+
+      pos += emptyReportSize;
+
+      // V=2, P=0, SC=1, PT=SDES
+      memset(pos, 0, sdesSize);  // end of items and padding octets
+      pos[0] = static_cast<BYTE>((kRtpVersion << 6) | 1);
+      pos[1] = SDES::kPayloadType;
+      RTPUtils::setBE16(&(pos[2]), static_cast<WORD>((sdesSize / sizeof(DWORD)) - 1));
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+      pos[8] = SDES::Chunk::CName::kItemType;
+      pos[9] = static_cast<BYTE>(cnameLength);
+      memcpy(&(pos[10]), cname, cnameLength);
+
+      pos += sdesSize;
+
+      memcpy(pos, buffer, bufferLengthInBytes);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::extractFeedback(
+                                     const BYTE *buffer,
+                                     size_t bufferLengthInBytes,
+                                     FeedbackEventList &outEvents,
+                                     bool &outFeedbackOnly
+                                     )
+    {
+      outEvents.clear();
+      outFeedbackOnly = false;
+
+      if ((!buffer) ||
+          (bufferLengthInBytes < kMinRtcpPacketLen)) return false;
+
+      bool feedbackOnly = true;
+      bool foundPaddingBit = false;
+
+      size_t remaining = bufferLengthInBytes;
+      const BYTE *pos = buffer;
+
+      // NOTE: mirrors the validation performed by the sizing pass in parse()
+      //       but only touches the headers and FCI of feedback messages
+      while (remaining >= kMinRtcpPacketLen) {
+        auto version = RTCP_GET_BITS(*pos, 0x3, 6);
+        if (kRtpVersion != version) goto illegal_packet;
+
+        {
+          size_t length = sizeof(DWORD) + (static_cast<size_t>(RTPUtils::getBE16(&(pos[2]))) * sizeof(DWORD));
+
+          size_t padding = 0;
+
+          if (RTCP_IS_FLAG_SET(*pos, 5)) {
+            if (foundPaddingBit) goto illegal_packet;
+            foundPaddingBit = true;
+
+            padding = buffer[bufferLengthInBytes-1];
+          }
+
+          if ((sizeof(DWORD) + padding) > length) goto illegal_packet;
+
+          length -= padding;
+
+          if (remaining < length) goto illegal_packet;
+
+          BYTE fmt = RTCP_GET_BITS(*pos, 0x1F, 0);
+          BYTE pt = pos[1];
+
+          advancePos(pos, remaining, sizeof(DWORD));
+
+          if (!extractFeedback(pt, fmt, pos, static_cast<size_t>(length - sizeof(DWORD)), outEvents)) feedbackOnly = false;
+
+          advancePos(pos, remaining, length - sizeof(DWORD));
+
+          if (0 != padding) {
+            if (remaining < padding) goto illegal_packet;
+            advancePos(pos, remaining, padding);
+          }
+        }
+      }
+
+      outFeedbackOnly = feedbackOnly;
+      return true;
+
+    illegal_packet:
+      {
+        ZS_LOG_TRACE(packet_slog("unable to extract feedback from malformed RTCP packet") + ZS_PARAM("pos", reinterpret_cast<PTRNUMBER>(pos) - reinterpret_cast<PTRNUMBER>(buffer)) + ZS_PARAM("remaining", remaining))
+      }
+      outEvents.clear();
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     const BYTE *RTCPPacket::ptr() const
     {
@@ -1358,6 +1694,56 @@ namespace ortc
         }
       }
 
+      {
+        auto format = fm->transportCC();
+        if (NULL != format) {
+          typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+          ElementPtr formatEl = Element::create("TransportCC");
+
+          UseServicesHelper::debugAppend(formatEl, "base sequence number", format->baseSequenceNumber());
+          UseServicesHelper::debugAppend(formatEl, "packet status count", format->packetStatusCount());
+          UseServicesHelper::debugAppend(formatEl, "reference time", format->referenceTime());
+          UseServicesHelper::debugAppend(formatEl, "fb pkt count", format->fbPktCount());
+
+          auto count = format->packetChunkCount();
+          if (count > 0) {
+            ElementPtr chunksEl = Element::create("chunks");
+
+            for (size_t index = 0; index < count; ++index) {
+              auto chunk = format->packetChunkAtIndex(index);
+
+              ElementPtr chunkEl;
+
+              if (TransportCC::isRunLengthChunk(chunk)) {
+                chunkEl = Element::create("run length");
+
+                TransportCC::RunLength rl(chunk);
+                UseServicesHelper::debugAppend(chunkEl, "status symbol", string(rl.statusSymbol()));
+                UseServicesHelper::debugAppend(chunkEl, "run length", rl.runLength());
+              } else {
+                chunkEl = Element::create("status vector");
+
+                String symbols;
+                TransportCC::StatusVector sv(chunk);
+                for (size_t symbolIndex = 0; symbolIndex < sv.symbolCount(); ++symbolIndex) {
+                  symbols += string(sv.symbolAtIndex(symbolIndex));
+                }
+                UseServicesHelper::debugAppend(chunkEl, "symbol size", sv.symbolSizeInBits());
+                UseServicesHelper::debugAppend(chunkEl, "symbols", symbols);
+              }
+
+              UseServicesHelper::debugAppend(chunksEl, chunkEl);
+            }
+            UseServicesHelper::debugAppend(formatEl, chunksEl);
+          }
+
+          UseServicesHelper::debugAppend(formatEl, "recv delta count", format->recvDeltaCount());
+
+          UseServicesHelper::debugAppend(subEl, formatEl);
+        }
+      }
+
       UseServicesHelper::debugAppend(subEl, "unknown", NULL != fm->unknown());
 
       UseServicesHelper::debugAppend(subEl, "next transport layer feedback message", (NULL != fm->nextTransportLayerFeedbackMessage()));
@@ -1898,6 +2284,98 @@ namespace ortc
       return Log::Params(message, toDebug());
     }
 
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::extractFeedback(
+                                     BYTE pt,
+                                     BYTE fmt,
+                                     const BYTE *contents,
+                                     size_t contentSize,
+                                     FeedbackEventList &ioEvents
+                                     )
+    {
+      typedef TransportLayerFeedbackMessage::GenericNACK GenericNACK;
+      typedef PayloadSpecificFeedbackMessage::PLI PLI;
+      typedef PayloadSpecificFeedbackMessage::FIR FIR;
+      typedef PayloadSpecificFeedbackMessage::REMB REMB;
+
+      if ((TransportLayerFeedbackMessage::kPayloadType != pt) &&
+          (PayloadSpecificFeedbackMessage::kPayloadType != pt)) return false;
+
+      if (contentSize < (sizeof(DWORD)*2)) return false;
+
+      const BYTE *pos = contents;
+      size_t remaining = contentSize;
+
+      FeedbackEvent event;
+      event.mSSRCOfPacketSender = RTPUtils::getBE32(&(pos[0]));
+      event.mSSRC = RTPUtils::getBE32(&(pos[4]));
+
+      advancePos(pos, remaining, sizeof(DWORD)*2);
+
+      if (TransportLayerFeedbackMessage::kPayloadType == pt) {
+        if (GenericNACK::kFmt != fmt) return false;
+        if ((0 == remaining) ||
+            (0 != (remaining % sizeof(DWORD)))) return false;
+
+        event.mType = FeedbackEvent::Type_GenericNACK;
+
+        while (remaining >= sizeof(DWORD)) {
+          event.mPID = RTPUtils::getBE16(&(pos[0]));
+          event.mBLP = RTPUtils::getBE16(&(pos[2]));
+          ioEvents.push_back(event);
+          advancePos(pos, remaining, sizeof(DWORD));
+        }
+        return true;
+      }
+
+      switch (fmt) {
+        case PLI::kFmt: {
+          event.mType = FeedbackEvent::Type_PLI;
+          ioEvents.push_back(event);
+          return true;
+        }
+        case FIR::kFmt: {
+          if ((0 == remaining) ||
+              (0 != (remaining % (sizeof(DWORD)*2)))) return false;
+
+          // https://tools.ietf.org/html/rfc5104#section-4.3.1.1 - the media
+          // source is specified per FCI entry rather than in the header
+          event.mType = FeedbackEvent::Type_FIR;
+
+          while (remaining >= (sizeof(DWORD)*2)) {
+            event.mSSRC = RTPUtils::getBE32(&(pos[0]));
+            event.mSeqNr = pos[4];
+            ioEvents.push_back(event);
+            advancePos(pos, remaining, sizeof(DWORD)*2);
+          }
+          return true;
+        }
+        case REMB::kFmt: {
+          if (remaining < (sizeof(DWORD)*2)) return false;
+          if (0 != memcmp(pos, reinterpret_cast<const BYTE *>("REMB"), sizeof(DWORD))) return false;
+
+          size_t numSSRC = static_cast<size_t>(pos[4]);
+          if ((remaining - (sizeof(DWORD)*2)) < (numSSRC * sizeof(DWORD))) return false;
+
+          event.mType = FeedbackEvent::Type_REMB;
+          event.mBRExp = RTCP_GET_BITS(pos[5], 0x3F, 2);
+          event.mBRMantissa = RTCP_GET_BITS(RTPUtils::getBE32(&(pos[4])), 0x3FFFF, 0);
+
+          advancePos(pos, remaining, sizeof(DWORD)*2);
+
+          for (size_t index = 0; index < numSSRC; ++index) {
+            event.mSSRC = RTPUtils::getBE32(pos);
+            ioEvents.push_back(event);
+            advancePos(pos, remaining, sizeof(DWORD));
+          }
+          return true;
+        }
+        default:  break;
+      }
+
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     bool RTCPPacket::parse()
     {
@@ -2359,6 +2837,7 @@ namespace ortc
         case TransportLayerFeedbackMessage::GenericNACK::kFmt:  result = getTransportLayerFeedbackMessageGenericNACKAllocationSize(reportSpecific, pos, remaining); break;
         case TransportLayerFeedbackMessage::TMMBR::kFmt:        result = getTransportLayerFeedbackMessageTMMBRAllocationSize(reportSpecific, pos, remaining); break;
         case TransportLayerFeedbackMessage::TMMBN::kFmt:        result = getTransportLayerFeedbackMessageTMMBNAllocationSize(reportSpecific, pos, remaining); break;
+        case TransportLayerFeedbackMessage::TransportCC::kFmt:  result = getTransportLayerFeedbackMessageTransportCCAllocationSize(reportSpecific, pos, remaining); break;
         default: {
           break;
         }
@@ -2570,6 +3049,31 @@ namespace ortc
       mAllocationSize += (alignedSize(sizeof(TransportLayerFeedbackMessage::TMMBN)) * possibleTMMBNs);
       return true;
     }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::getTransportLayerFeedbackMessageTransportCCAllocationSize(
+                                                                               BYTE fmt,
+                                                                               const BYTE *contents,
+                                                                               size_t contentSize
+                                                                               )
+    {
+      size_t packetChunkCount = 0;
+      size_t recvDeltaCount = 0;
+      size_t recvDeltaSize = 0;
+
+      if (!getTransportCCSizes(contents, contentSize, packetChunkCount, recvDeltaCount, recvDeltaSize)) {
+        ZS_LOG_WARNING(Trace, debug("malformed transport-cc transport layer feedback message") + ZS_PARAM("remaining", contentSize))
+        return false;
+      }
+
+      if (0 != packetChunkCount) {
+        mAllocationSize += alignedSize(sizeof(TransportLayerFeedbackMessage::TransportCC::PacketChunk) * packetChunkCount);
+      }
+      if (0 != recvDeltaCount) {
+        mAllocationSize += alignedSize(sizeof(LONG) * recvDeltaCount);
+      }
+      return true;
+    }
     
     //-------------------------------------------------------------------------
     bool RTCPPacket::getPayloadSpecificFeedbackMessagePLIAllocationSize(
@@ -3522,6 +4026,7 @@ namespace ortc
           case TransportLayerFeedbackMessage::GenericNACK::kFmt:  result = parseGenericNACK(report); break;
           case TransportLayerFeedbackMessage::TMMBR::kFmt:        result = parseTMMBR(report); break;
           case TransportLayerFeedbackMessage::TMMBN::kFmt:        result = parseTMMBN(report); break;
+          case TransportLayerFeedbackMessage::TransportCC::kFmt:  result = parseTransportCC(report); break;
           default: {
             result = parseUnknown(report);
             break;
@@ -3977,6 +4482,163 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::parseTransportCC(TransportLayerFeedbackMessage *report)
+    {
+      typedef TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      const BYTE *pos = report->fci();
+      size_t remaining = report->fciSize();
+
+      size_t packetChunkCount = 0;
+      size_t recvDeltaCount = 0;
+      size_t recvDeltaSize = 0;
+
+      if (!getTransportCCSizes(pos, remaining, packetChunkCount, recvDeltaCount, recvDeltaSize)) {
+        ZS_LOG_WARNING(Trace, debug("malformed transport-cc transport layer feedback message") + ZS_PARAM("remaining", remaining))
+        return parseUnknown(report);
+      }
+
+      TransportCC &cc = report->mTransportCC;
+
+      report->mHasTransportCC = true;
+
+      cc.mBaseSequenceNumber = RTPUtils::getBE16(&(pos[0]));
+      cc.mPacketStatusCount = RTPUtils::getBE16(&(pos[2]));
+
+      DWORD referenceTime = RTCP_GET_BITS(RTPUtils::getBE32(&(pos[4])), 0xFFFFFF, 8);
+      if (0 != (referenceTime & 0x800000)) {
+        cc.mReferenceTime = static_cast<LONG>(referenceTime) - static_cast<LONG>(0x1000000);
+      } else {
+        cc.mReferenceTime = static_cast<LONG>(referenceTime);
+      }
+      cc.mFBPktCount = pos[7];
+
+      advancePos(pos, remaining, sizeof(DWORD)*2);
+
+      if (0 != packetChunkCount) {
+        cc.mPacketChunks = new (allocateBuffer(alignedSize(sizeof(TransportCC::PacketChunk) * packetChunkCount))) TransportCC::PacketChunk[packetChunkCount];
+      }
+      if (0 != recvDeltaCount) {
+        cc.mRecvDeltas = new (allocateBuffer(alignedSize(sizeof(LONG) * recvDeltaCount))) LONG[recvDeltaCount];
+      }
+
+      size_t statusRemaining = static_cast<size_t>(cc.mPacketStatusCount);
+
+      // scope: read the packet chunks, consuming all packet statuses
+      {
+        for (; cc.mPacketChunkCount < packetChunkCount; ++(cc.mPacketChunkCount)) {
+          cc.mPacketChunks[cc.mPacketChunkCount] = RTPUtils::getBE16(pos);
+          advancePos(pos, remaining, sizeof(WORD));
+        }
+      }
+
+      // scope: read the receive deltas in the order the status symbols appear
+      {
+        for (size_t index = 0; index < packetChunkCount; ++index) {
+          auto chunk = cc.mPacketChunks[index];
+
+          if (TransportCC::isRunLengthChunk(chunk)) {
+            TransportCC::RunLength rl(chunk);
+            size_t length = (rl.runLength() > statusRemaining ? statusRemaining : rl.runLength());
+            size_t deltaSize = TransportCC::getRecvDeltaSize(rl.statusSymbol());
+
+            for (size_t loop = 0; (loop < length) && (0 != deltaSize); ++loop) {
+              ASSERT(cc.mRecvDeltaCount < recvDeltaCount)
+              cc.mRecvDeltas[cc.mRecvDeltaCount] = (sizeof(BYTE) == deltaSize ? static_cast<LONG>(pos[0]) : static_cast<LONG>(static_cast<short>(RTPUtils::getBE16(pos))));
+              advancePos(pos, remaining, deltaSize);
+              ++(cc.mRecvDeltaCount);
+            }
+            statusRemaining -= length;
+            continue;
+          }
+
+          TransportCC::StatusVector sv(chunk);
+          size_t length = (sv.symbolCount() > statusRemaining ? statusRemaining : sv.symbolCount());
+
+          for (size_t symbolIndex = 0; symbolIndex < length; ++symbolIndex) {
+            size_t deltaSize = TransportCC::getRecvDeltaSize(sv.symbolAtIndex(symbolIndex));
+            if (0 == deltaSize) continue;
+
+            ASSERT(cc.mRecvDeltaCount < recvDeltaCount)
+            cc.mRecvDeltas[cc.mRecvDeltaCount] = (sizeof(BYTE) == deltaSize ? static_cast<LONG>(pos[0]) : static_cast<LONG>(static_cast<short>(RTPUtils::getBE16(pos))));
+            advancePos(pos, remaining, deltaSize);
+            ++(cc.mRecvDeltaCount);
+          }
+          statusRemaining -= length;
+        }
+      }
+
+      ASSERT(0 == statusRemaining)
+      ASSERT(recvDeltaCount == cc.mRecvDeltaCount)
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::getTransportCCSizes(
+                                         const BYTE *contents,
+                                         size_t contentSize,
+                                         size_t &outPacketChunkCount,
+                                         size_t &outRecvDeltaCount,
+                                         size_t &outRecvDeltaSize
+                                         )
+    {
+      typedef TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      outPacketChunkCount = 0;
+      outRecvDeltaCount = 0;
+      outRecvDeltaSize = 0;
+
+      const BYTE *pos = contents;
+      size_t remaining = contentSize;
+
+      if (remaining < (sizeof(DWORD)*2)) return false;
+
+      size_t statusRemaining = static_cast<size_t>(RTPUtils::getBE16(&(pos[2])));
+
+      advancePos(pos, remaining, sizeof(DWORD)*2);
+
+      while (statusRemaining > 0) {
+        if (remaining < sizeof(WORD)) return false;
+
+        auto chunk = RTPUtils::getBE16(pos);
+        advancePos(pos, remaining, sizeof(WORD));
+        ++outPacketChunkCount;
+
+        if (TransportCC::isRunLengthChunk(chunk)) {
+          TransportCC::RunLength rl(chunk);
+          if (TransportCC::kStatusSymbolReserved == rl.statusSymbol()) return false;
+
+          size_t length = (rl.runLength() > statusRemaining ? statusRemaining : rl.runLength());
+          size_t deltaSize = TransportCC::getRecvDeltaSize(rl.statusSymbol());
+          if (0 != deltaSize) {
+            outRecvDeltaCount += length;
+            outRecvDeltaSize += (deltaSize * length);
+          }
+          statusRemaining -= length;
+          continue;
+        }
+
+        TransportCC::StatusVector sv(chunk);
+        size_t length = (sv.symbolCount() > statusRemaining ? statusRemaining : sv.symbolCount());
+
+        for (size_t index = 0; index < length; ++index) {
+          BYTE symbol = sv.symbolAtIndex(index);
+          if (TransportCC::kStatusSymbolReserved == symbol) return false;
+
+          size_t deltaSize = TransportCC::getRecvDeltaSize(symbol);
+          if (0 == deltaSize) continue;
+          ++outRecvDeltaCount;
+          outRecvDeltaSize += deltaSize;
+        }
+        statusRemaining -= length;
+      }
+
+      if (remaining < outRecvDeltaSize) return false;
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     bool RTCPPacket::parseUnknown(TransportLayerFeedbackMessage *report)
     {
@@ -4739,6 +5401,46 @@ namespace ortc
       return boundarySize(result);
     }
     
+    //-------------------------------------------------------------------------
+    static size_t getTransportCCRecvDeltaSize(const RTCPPacket::TransportLayerFeedbackMessage::TransportCC *cc)
+    {
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      size_t result = 0;
+      size_t deltaCount = 0;
+      size_t statusRemaining = static_cast<size_t>(cc->packetStatusCount());
+
+      for (size_t index = 0; (index < cc->packetChunkCount()) && (statusRemaining > 0); ++index) {
+        auto chunk = cc->packetChunkAtIndex(index);
+
+        if (TransportCC::isRunLengthChunk(chunk)) {
+          TransportCC::RunLength rl(chunk);
+          size_t length = (rl.runLength() > statusRemaining ? statusRemaining : rl.runLength());
+          size_t deltaSize = TransportCC::getRecvDeltaSize(rl.statusSymbol());
+          if (0 != deltaSize) {
+            deltaCount += length;
+            result += (deltaSize * length);
+          }
+          statusRemaining -= length;
+          continue;
+        }
+
+        TransportCC::StatusVector sv(chunk);
+        size_t length = (sv.symbolCount() > statusRemaining ? statusRemaining : sv.symbolCount());
+        for (size_t symbolIndex = 0; symbolIndex < length; ++symbolIndex) {
+          size_t deltaSize = TransportCC::getRecvDeltaSize(sv.symbolAtIndex(symbolIndex));
+          if (0 == deltaSize) continue;
+          ++deltaCount;
+          result += deltaSize;
+        }
+        statusRemaining -= length;
+      }
+
+      ORTC_THROW_INVALID_PARAMETERS_IF(0 != statusRemaining)
+      ORTC_THROW_INVALID_PARAMETERS_IF(deltaCount != cc->recvDeltaCount())
+      return result;
+    }
+
     //-------------------------------------------------------------------------
     static size_t getPacketSizeTransportLayerFeedbackMessage(const RTCPPacket::TransportLayerFeedbackMessage *fm)
     {
@@ -4746,6 +5448,7 @@ namespace ortc
       typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
       size_t result = (sizeof(DWORD)*3);
 
@@ -4770,17 +5473,35 @@ namespace ortc
           result += ((sizeof(DWORD)*2)*(count));
           break;
         }
-        default:
+        case TransportCC::kFmt:
         {
-          auto fciSize = fm->fciSize();
-          if (0 != fciSize) {
-            ORTC_THROW_INVALID_PARAMETERS_IF(NULL == fm->fci())
-            result += fciSize;
+          auto cc = fm->transportCC();
+          if (NULL != cc) {
+            result += (sizeof(DWORD)*2);
+            result += (sizeof(TransportCC::PacketChunk)*(cc->packetChunkCount()));
+            result += getTransportCCRecvDeltaSize(cc);
+            break;
           }
-          break;
+          goto unknown_fmt;
+        }
+        default:
+        {
+          goto unknown_fmt;
         }
       }
 
+      goto done;
+
+    unknown_fmt:
+      {
+        auto fciSize = fm->fciSize();
+        if (0 != fciSize) {
+          ORTC_THROW_INVALID_PARAMETERS_IF(NULL == fm->fci())
+          result += fciSize;
+        }
+      }
+
+    done:
       ZS_LOG_INSANE(packet_slog("getting transport layer feedback message packet size") + ZS_PARAM("fmt", fm->fmtToString()) + ZS_PARAM("fmt (number)", fm->reportSpecific()) + ZS_PARAM("size", result))
 
       return boundarySize(result);
@@ -5417,6 +6138,7 @@ namespace ortc
       typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
       pos[1] = TransportLayerFeedbackMessage::kPayloadType;
 
@@ -5477,17 +6199,74 @@ namespace ortc
           }
           break;
         }
-        default:
+        case TransportCC::kFmt:
         {
-          auto fciSize = report->fciSize();
-          if (0 != fciSize) {
-            memcpy(pos, report->fci(), report->fciSize());
-            advancePos(pos, remaining, report->fciSize());
+          auto cc = report->transportCC();
+          if (NULL == cc) goto unknown_fmt;
+
+          RTPUtils::setBE16(&(pos[0]), cc->baseSequenceNumber());
+          RTPUtils::setBE16(&(pos[2]), cc->packetStatusCount());
+          ASSERT((cc->referenceTime() >= -0x800000) && (cc->referenceTime() <= 0x7FFFFF))
+          RTPUtils::setBE32(&(pos[4]), RTCP_PACK_BITS(static_cast<DWORD>(cc->referenceTime()), 0xFFFFFF, 8));
+          pos[7] = cc->fbPktCount();
+
+          advancePos(pos, remaining, sizeof(DWORD)*2);
+
+          for (size_t index = 0; index < cc->packetChunkCount(); ++index) {
+            RTPUtils::setBE16(pos, cc->packetChunkAtIndex(index));
+            advancePos(pos, remaining, sizeof(WORD));
+          }
+
+          size_t deltaIndex = 0;
+          size_t statusRemaining = static_cast<size_t>(cc->packetStatusCount());
+
+          for (size_t index = 0; (index < cc->packetChunkCount()) && (statusRemaining > 0); ++index) {
+            auto chunk = cc->packetChunkAtIndex(index);
+
+            bool isRunLength = TransportCC::isRunLengthChunk(chunk);
+            TransportCC::RunLength rl(chunk);
+            TransportCC::StatusVector sv(chunk);
+
+            size_t symbolCount = (isRunLength ? rl.runLength() : sv.symbolCount());
+            if (symbolCount > statusRemaining) symbolCount = statusRemaining;
+
+            for (size_t symbolIndex = 0; symbolIndex < symbolCount; ++symbolIndex) {
+              size_t deltaSize = TransportCC::getRecvDeltaSize(isRunLength ? rl.statusSymbol() : sv.symbolAtIndex(symbolIndex));
+              if (0 == deltaSize) continue;
+
+              LONG delta = cc->recvDeltaAtIndex(deltaIndex);
+              if (sizeof(BYTE) == deltaSize) {
+                ASSERT((delta >= 0) && (delta <= 0xFF))
+                pos[0] = static_cast<BYTE>(delta);
+              } else {
+                ASSERT((delta >= -0x8000) && (delta <= 0x7FFF))
+                RTPUtils::setBE16(pos, static_cast<WORD>(static_cast<short>(delta)));
+              }
+              advancePos(pos, remaining, deltaSize);
+              ++deltaIndex;
+            }
+            statusRemaining -= symbolCount;
           }
           break;
         }
+        default:
+        {
+          goto unknown_fmt;
+        }
+      }
+
+      goto done;
+
+    unknown_fmt:
+      {
+        auto fciSize = report->fciSize();
+        if (0 != fciSize) {
+          memcpy(pos, report->fci(), report->fciSize());
+          advancePos(pos, remaining, report->fciSize());
+        }
       }
 
+    done:
       ZS_LOG_INSANE(packet_slog("writing transport layer feedback message") + ZS_PARAM("fmt", report->fmtToString()) + ZS_PARAM("fmt (number)", report->reportSpecific()))
     }
     
@@ -0,0 +1,528 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_RTPCapture.h>
+#include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/SafeInt.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_srtp) }
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static void setLE16(BYTE *memory, WORD value)
+    {
+      memory[0] = static_cast<BYTE>(value >> 0);
+      memory[1] = static_cast<BYTE>(value >> 8);
+    }
+
+    //-------------------------------------------------------------------------
+    static void setLE32(BYTE *memory, DWORD value)
+    {
+      memory[0] = static_cast<BYTE>(value >> 0);
+      memory[1] = static_cast<BYTE>(value >> 8);
+      memory[2] = static_cast<BYTE>(value >> 16);
+      memory[3] = static_cast<BYTE>(value >> 24);
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t padTo32Bits(size_t length)
+    {
+      return (length + 3) & ~(static_cast<size_t>(3));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPCaptureRing
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPCaptureRing::RTPCaptureRing(
+                                   size_t bufferSizeInBytes,
+                                   size_t snapLengthInBytes,
+                                   size_t rtpPayloadBytes
+                                   ) :
+      mSnapLength(snapLengthInBytes),
+      mRTPPayloadBytes(rtpPayloadBytes)
+    {
+      // the minimum RTP header plus enough to see an RTCP header; the upper
+      // bound keeps the captured length inside a rtpdump record
+      if (mSnapLength < 16) mSnapLength = 16;
+      if (mSnapLength > 0xFFF0) mSnapLength = 0xFFF0;
+
+      mTotalSlots = bufferSizeInBytes / (mSnapLength + sizeof(Slot));
+      if (mTotalSlots < 1) mTotalSlots = 1;
+
+      mSlots = new Slot[mTotalSlots];
+      mData = new BYTE[mTotalSlots * mSnapLength];
+    }
+
+    //-------------------------------------------------------------------------
+    RTPCaptureRing::~RTPCaptureRing()
+    {
+      delete [] mSlots;
+      mSlots = NULL;
+      delete [] mData;
+      mData = NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPCaptureRingPtr RTPCaptureRing::create(
+                                             size_t bufferSizeInBytes,
+                                             size_t snapLengthInBytes,
+                                             size_t rtpPayloadBytes
+                                             )
+    {
+      if (0 == bufferSizeInBytes) return RTPCaptureRingPtr();
+      return make_shared<RTPCaptureRing>(bufferSizeInBytes, snapLengthInBytes, rtpPayloadBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPCaptureRing::capture(
+                                 Directions direction,
+                                 IICETypes::Components packetType,
+                                 const BYTE *buffer,
+                                 size_t bufferLengthInBytes
+                                 )
+    {
+      if ((!buffer) ||
+          (0 == bufferLengthInBytes)) return;
+
+      ASSERT(IRTPCapture::Direction_Both != direction);
+
+      size_t capturedLength = captureLength(packetType, buffer, bufferLengthInBytes);
+
+      QWORD sequence = mNextSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+      size_t index = static_cast<size_t>((sequence - 1) % mTotalSlots);
+
+      Slot &slot = mSlots[index];
+
+      // claim the slot before touching its contents; two writers can only
+      // meet on a slot after the ring wrapped so losing the race (or being
+      // overtaken by a newer packet) drops this packet instead of tearing
+      QWORD previous = slot.mSequence.load(std::memory_order_relaxed);
+      do {
+        if ((kSlotWriting == previous) ||
+            (previous >= sequence)) {
+          mTotalDropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+      } while (!slot.mSequence.compare_exchange_weak(previous, kSlotWriting, std::memory_order_relaxed, std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_release);
+
+      slot.mTimestamp = static_cast<QWORD>(zsLib::timeSinceEpoch<Microseconds>(zsLib::now()).count());
+      slot.mOriginalLength = static_cast<DWORD>(bufferLengthInBytes > 0xFFFFFFFF ? 0xFFFFFFFF : bufferLengthInBytes);
+      slot.mCapturedLength = static_cast<WORD>(capturedLength);
+      slot.mDirection = static_cast<BYTE>(direction);
+      slot.mPacketType = static_cast<BYTE>(packetType);
+      memcpy(&(mData[index * mSnapLength]), buffer, capturedLength);
+
+      slot.mSequence.store(sequence, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPCaptureRing::dump(
+                                            Formats format,
+                                            Directions direction
+                                            ) const
+    {
+      PacketList packets;
+      SecureByteBlock data;
+
+      snapshot(direction, packets, data);
+
+      switch (format) {
+        case IRTPCapture::Format_RTPDump:   return toRTPDump(packets, data);
+        case IRTPCapture::Format_PCAPNG:    return toPCAPNG(packets, data);
+      }
+      return SecureByteBlockPtr();
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPCaptureRing::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPCaptureRing");
+
+      IHelper::debugAppend(resultEl, "snap length", mSnapLength);
+      IHelper::debugAppend(resultEl, "rtp payload bytes", mRTPPayloadBytes);
+      IHelper::debugAppend(resultEl, "total slots", mTotalSlots);
+      IHelper::debugAppend(resultEl, "packets captured", mNextSequence.load(std::memory_order_relaxed));
+      IHelper::debugAppend(resultEl, "packets dropped", mTotalDropped.load(std::memory_order_relaxed));
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPCaptureRing => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    size_t RTPCaptureRing::captureLength(
+                                         IICETypes::Components packetType,
+                                         const BYTE *buffer,
+                                         size_t bufferLengthInBytes
+                                         ) const
+    {
+      size_t length = bufferLengthInBytes;
+
+      if ((IICETypes::Component_RTP == packetType) &&
+          (length >= 12)) {
+        // keep the fixed header, CSRCs and header extensions
+        size_t headerLength = 12 + (static_cast<size_t>(buffer[0] & 0x0F) * sizeof(DWORD));
+        if ((0 != (buffer[0] & 0x10)) &&
+            (length >= headerLength + sizeof(DWORD))) {
+          headerLength += sizeof(DWORD) + (static_cast<size_t>(RTPUtils::getBE16(&(buffer[headerLength + 2]))) * sizeof(DWORD));
+        }
+        if (length > headerLength + mRTPPayloadBytes) length = headerLength + mRTPPayloadBytes;
+      }
+
+      return length > mSnapLength ? mSnapLength : length;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPCaptureRing::snapshot(
+                                  Directions direction,
+                                  PacketList &outPackets,
+                                  SecureByteBlock &outData
+                                  ) const
+    {
+      QWORD lastSequence = mNextSequence.load(std::memory_order_acquire);
+      if (0 == lastSequence) return;
+
+      QWORD firstSequence = (lastSequence > mTotalSlots ? lastSequence - mTotalSlots + 1 : 1);
+
+      outData.CleanNew(static_cast<size_t>(lastSequence - firstSequence + 1) * mSnapLength);
+
+      size_t offset = 0;
+
+      for (QWORD sequence = firstSequence; sequence <= lastSequence; ++sequence) {
+        size_t index = static_cast<size_t>((sequence - 1) % mTotalSlots);
+        const Slot &slot = mSlots[index];
+
+        if (sequence != slot.mSequence.load(std::memory_order_acquire)) continue;  // overwritten or still being written
+
+        Packet packet;
+        packet.mTimestamp = slot.mTimestamp;
+        packet.mOriginalLength = slot.mOriginalLength;
+        packet.mDirection = static_cast<Directions>(slot.mDirection);
+        packet.mPacketType = static_cast<IICETypes::Components>(slot.mPacketType);
+        packet.mOffset = offset;
+        packet.mCapturedLength = slot.mCapturedLength;
+        if (packet.mCapturedLength > mSnapLength) packet.mCapturedLength = mSnapLength;
+
+        memcpy(outData.BytePtr() + offset, &(mData[index * mSnapLength]), packet.mCapturedLength);
+
+        // discard the copy if a writer reused the slot while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence != slot.mSequence.load(std::memory_order_relaxed)) continue;
+
+        if ((IRTPCapture::Direction_Both != direction) &&
+            (direction != packet.mDirection)) continue;
+
+        offset += packet.mCapturedLength;
+        outPackets.push_back(packet);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPCaptureRing::toRTPDump(
+                                                 const PacketList &packets,
+                                                 const SecureByteBlock &data
+                                                 )
+    {
+      // see rtptools "rtpdump" format: a text line, a RD_hdr_t and then an
+      // RD_packet_t (8 bytes) before each packet, all in network byte order
+      static const char *fileHeader = "#!rtpplay1.0 0.0.0.0/0\n";
+      const size_t fileHeaderLength = strlen(fileHeader);
+      const size_t rdHeaderLength = 16;
+      const size_t packetHeaderLength = 8;
+
+      size_t totalLength = fileHeaderLength + rdHeaderLength;
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        totalLength += packetHeaderLength + (*iter).mCapturedLength;
+      }
+
+      SecureByteBlockPtr result(make_shared<SecureByteBlock>(totalLength));
+      BYTE *pos = result->BytePtr();
+
+      memcpy(pos, fileHeader, fileHeaderLength);
+      pos += fileHeaderLength;
+
+      QWORD startTime = (packets.size() > 0 ? packets.front().mTimestamp : static_cast<QWORD>(zsLib::timeSinceEpoch<Microseconds>(zsLib::now()).count()));
+
+      RTPUtils::setBE32(pos, static_cast<DWORD>(startTime / 1000000));    // start seconds
+      RTPUtils::setBE32(pos + 4, static_cast<DWORD>(startTime % 1000000)); // start microseconds
+      RTPUtils::setBE32(pos + 8, 0);                                       // source address
+      RTPUtils::setBE16(pos + 12, 0);                                      // source port
+      RTPUtils::setBE16(pos + 14, 0);                                      // padding
+      pos += rdHeaderLength;
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+
+        QWORD offsetInMilliseconds = (packet.mTimestamp > startTime ? (packet.mTimestamp - startTime) / 1000 : 0);
+        DWORD originalLength = (IICETypes::Component_RTP == packet.mPacketType ? packet.mOriginalLength : 0); // 0 = RTCP
+        if (originalLength > 0xFFFF) originalLength = 0xFFFF;
+
+        RTPUtils::setBE16(pos, static_cast<WORD>(packetHeaderLength + packet.mCapturedLength));
+        RTPUtils::setBE16(pos + 2, static_cast<WORD>(originalLength));
+        RTPUtils::setBE32(pos + 4, static_cast<DWORD>(offsetInMilliseconds));
+        pos += packetHeaderLength;
+
+        memcpy(pos, data.BytePtr() + packet.mOffset, packet.mCapturedLength);
+        pos += packet.mCapturedLength;
+      }
+
+      ASSERT(pos == result->BytePtr() + totalLength);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPCaptureRing::toPCAPNG(
+                                                const PacketList &packets,
+                                                const SecureByteBlock &data
+                                                )
+    {
+      // a section header block, one raw IPv4 interface (microsecond
+      // resolution) and an enhanced packet block per packet; each packet is
+      // wrapped in a synthesized IPv4/UDP header so that dissectors can
+      // decode it as RTP/RTCP ("decode as" on the UDP ports)
+      const size_t sectionHeaderLength = 28;
+      const size_t interfaceLength = 32;
+      const size_t packetBlockOverhead = 28 + 12 + 4;  // header + options + trailing length
+      const size_t ipUDPHeaderLength = 20 + 8;
+
+      const DWORD localAddress = 0x0A000001;       // 10.0.0.1
+      const DWORD remoteAddress = 0x0A000002;      // 10.0.0.2
+      const WORD rtpPort = 5000;
+      const WORD rtcpPort = 5001;
+
+      size_t totalLength = sectionHeaderLength + interfaceLength;
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        totalLength += packetBlockOverhead + padTo32Bits(ipUDPHeaderLength + (*iter).mCapturedLength);
+      }
+
+      SecureByteBlockPtr result(make_shared<SecureByteBlock>(totalLength));
+      BYTE *pos = result->BytePtr();
+      memset(pos, 0, totalLength);
+
+      // section header block
+      setLE32(pos, 0x0A0D0D0A);
+      setLE32(pos + 4, static_cast<DWORD>(sectionHeaderLength));
+      setLE32(pos + 8, 0x1A2B3C4D);                // byte order magic
+      setLE16(pos + 12, 1);                        // major version
+      setLE16(pos + 14, 0);                        // minor version
+      setLE32(pos + 16, 0xFFFFFFFF);               // section length (unspecified)
+      setLE32(pos + 20, 0xFFFFFFFF);
+      setLE32(pos + 24, static_cast<DWORD>(sectionHeaderLength));
+      pos += sectionHeaderLength;
+
+      // interface description block
+      setLE32(pos, 0x00000001);
+      setLE32(pos + 4, static_cast<DWORD>(interfaceLength));
+      setLE16(pos + 8, 101);                       // LINKTYPE_RAW
+      setLE16(pos + 10, 0);
+      setLE32(pos + 12, 0);                        // snap length (unlimited)
+      setLE16(pos + 16, 9);                        // if_tsresol
+      setLE16(pos + 18, 1);
+      pos[20] = 6;                                 // 10^-6 (microseconds)
+      setLE16(pos + 24, 0);                        // opt_endofopt
+      setLE16(pos + 26, 0);
+      setLE32(pos + 28, static_cast<DWORD>(interfaceLength));
+      pos += interfaceLength;
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+
+        bool incoming = (IRTPCapture::Direction_Incoming == packet.mDirection);
+        WORD port = (IICETypes::Component_RTP == packet.mPacketType ? rtpPort : rtcpPort);
+
+        size_t capturedLength = ipUDPHeaderLength + packet.mCapturedLength;
+        size_t paddedLength = padTo32Bits(capturedLength);
+        size_t blockLength = packetBlockOverhead + paddedLength;
+
+        size_t originalLength = ipUDPHeaderLength + packet.mOriginalLength;
+        WORD ipLength = static_cast<WORD>(originalLength > 0xFFFF ? 0xFFFF : originalLength);
+        WORD udpLength = static_cast<WORD>(originalLength - 20 > 0xFFFF ? 0xFFFF : originalLength - 20);
+
+        setLE32(pos, 0x00000006);
+        setLE32(pos + 4, static_cast<DWORD>(blockLength));
+        setLE32(pos + 8, 0);                       // interface ID
+        setLE32(pos + 12, static_cast<DWORD>(packet.mTimestamp >> 32));
+        setLE32(pos + 16, static_cast<DWORD>(packet.mTimestamp & 0xFFFFFFFF));
+        setLE32(pos + 20, static_cast<DWORD>(capturedLength));
+        setLE32(pos + 24, static_cast<DWORD>(originalLength > 0xFFFFFFFF ? 0xFFFFFFFF : originalLength));
+
+        BYTE *ip = pos + 28;
+        ip[0] = 0x45;                              // IPv4, 20 byte header
+        RTPUtils::setBE16(ip + 2, ipLength);
+        RTPUtils::setBE16(ip + 6, 0x4000);         // don't fragment
+        ip[8] = 64;                                // TTL
+        ip[9] = 17;                                // UDP
+        RTPUtils::setBE32(ip + 12, incoming ? remoteAddress : localAddress);
+        RTPUtils::setBE32(ip + 16, incoming ? localAddress : remoteAddress);
+
+        DWORD checksum = 0;
+        for (size_t loop = 0; loop < 20; loop += 2) {
+          checksum += RTPUtils::getBE16(ip + loop);
+        }
+        while (0 != (checksum >> 16)) {
+          checksum = (checksum & 0xFFFF) + (checksum >> 16);
+        }
+        RTPUtils::setBE16(ip + 10, static_cast<WORD>(~checksum));
+
+        BYTE *udp = ip + 20;
+        RTPUtils::setBE16(udp, port);
+        RTPUtils::setBE16(udp + 2, port);
+        RTPUtils::setBE16(udp + 4, udpLength);     // checksum left as 0 (none)
+
+        memcpy(udp + 8, data.BytePtr() + packet.mOffset, packet.mCapturedLength);
+
+        BYTE *options = pos + 28 + paddedLength;
+        setLE16(options, 2);                       // epb_flags
+        setLE16(options + 2, 4);
+        setLE32(options + 4, incoming ? 1 : 2);    // inbound / outbound
+        setLE16(options + 8, 0);                   // opt_endofopt
+        setLE16(options + 10, 0);
+
+        setLE32(pos + blockLength - 4, static_cast<DWORD>(blockLength));
+        pos += blockLength;
+      }
+
+      ASSERT(pos == result->BytePtr() + totalLength);
+      return result;
+    }
+
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPCapture
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  const char *IRTPCapture::toString(Formats format)
+  {
+    switch (format) {
+      case Format_RTPDump:      return "rtpdump";
+      case Format_PCAPNG:       return "pcapng";
+    }
+    return "UNDEFINED";
+  }
+
+  //---------------------------------------------------------------------------
+  IRTPCapture::Formats IRTPCapture::toFormat(const char *format) throw (InvalidParameters)
+  {
+    static const internal::EnumStringTable<Formats> table(Format_First, Format_Last, IRTPCapture::toString, false);
+
+    Formats result {};
+    if (table.find(format, result)) return result;
+
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(format))
+    return Format_First;
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IRTPCapture::toString(Directions direction)
+  {
+    switch (direction) {
+      case Direction_Incoming:  return "incoming";
+      case Direction_Outgoing:  return "outgoing";
+      case Direction_Both:      return "both";
+    }
+    return "UNDEFINED";
+  }
+
+  //---------------------------------------------------------------------------
+  IRTPCapture::Directions IRTPCapture::toDirection(const char *direction) throw (InvalidParameters)
+  {
+    static const internal::EnumStringTable<Directions> table(Direction_First, Direction_Last, IRTPCapture::toString, false);
+
+    Directions result {};
+    if (table.find(direction, result)) return result;
+
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(direction))
+    return Direction_First;
+  }
+
+  //---------------------------------------------------------------------------
+  SecureByteBlockPtr IRTPCapture::dump(
+                                       IRTPTransportPtr transport,
+                                       Formats format,
+                                       Directions direction
+                                       )
+  {
+    auto secureTransport = internal::ISecureTransportForRTPCapture::convert(transport);
+    if (!secureTransport) return SecureByteBlockPtr();
+
+    auto ring = secureTransport->getCaptureRing();
+    if (!ring) return SecureByteBlockPtr();
+
+    return ring->dump(format, direction);
+  }
+}
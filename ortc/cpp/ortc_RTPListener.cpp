@@ -37,8 +37,10 @@
 #include <ortc/internal/ortc_RTCPPacket.h>
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -433,6 +435,7 @@ namespace ortc
       mMaxRTCPPacketAge(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTCP_PACKETS_IN_SECONDS)),
       mReceivers(make_shared<ReceiverObjectMap>()),
       mSenders(make_shared<SenderObjectMap>()),
+      mSenderSSRCs(make_shared<SenderSSRCMap>()),
       mAmbiguousPayloadMappingMinDifference(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS)),
       mSSRCTableExpires(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_SSRC_TIMEOUT_IN_SECONDS)),
       mUnhandledEventsExpires(ISettings::getUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS))
@@ -459,7 +462,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPListener::init()
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
 
       if (mSSRCTableExpires < Seconds(1)) {
@@ -565,7 +568,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       IRTPListenerSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -598,7 +601,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPListener::setHeaderExtensions(const HeaderExtensionParametersList &headerExtensions)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       // unregister previous header extensions
       unregisterAllHeaderExtensionReferences(kAPIReference);
@@ -657,6 +660,8 @@ namespace ortc
                                       size_t bufferLengthInBytes
                                       )
     {
+      PacketPipelineLatency::markHop(IStatsReportTypes::PacketPipelineHop_SRTPTransport);
+
       ZS_EVENTING_5(
                     x, i, Trace, RtpListenerReceivedIncomingPacket, ol, RtpListener, Receive,
                     puid, id, mID,
@@ -678,6 +683,18 @@ namespace ortc
 
       // parse packet outside of a lock
       if (IICETypes::Component_RTCP == packetType) {
+        // scope: fast path for feedback-only RTCP targeting local senders
+        {
+          FeedbackEventList events;
+          bool feedbackOnly = false;
+
+          if ((RTCPPacket::extractFeedback(buffer, bufferLengthInBytes, events, feedbackOnly)) &&
+              (feedbackOnly) &&
+              (events.size() > 0)) {
+            if (routeFeedback(viaComponent, buffer, bufferLengthInBytes, events, result)) return result;
+          }
+        }
+
         rtcpPacket = RTCPPacket::create(buffer, bufferLengthInBytes);
         if (!rtcpPacket) {
           ZS_LOG_WARNING(Trace, log("invalid rtcp packet received (thus dropping)"))
@@ -690,10 +707,12 @@ namespace ortc
           ZS_LOG_WARNING(Trace, log("invalid RTP packet received (thus dropping)"))
           return false;
         }
+
+        rtpPacket->mIngressTime = PacketPipelineLatency::ingressTime();
       }
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (isShutdown()) {
           ZS_LOG_WARNING(Trace, log("ingoring incomign packet (already shutdown)"))
@@ -770,8 +789,8 @@ namespace ortc
                       puid, id, mID,
                       enum, viaComponenet, zsLib::to_underlying(viaComponent),
                       enum, packetType, zsLib::to_underlying(packetType),
-                      buffer, packet, rtpPacket->buffer()->BytePtr(),
-                      size, size, rtpPacket->buffer()->SizeInBytes()
+                      buffer, packet, rtpPacket->ptr(),
+                      size, size, rtpPacket->size()
                       );
 
         return receiver->handlePacket(viaComponent, rtpPacket);
@@ -796,8 +815,8 @@ namespace ortc
                         puid, id, mID,
                         enum, viaComponenet, zsLib::to_underlying(viaComponent),
                         enum, packetType, zsLib::to_underlying(packetType),
-                        buffer, packet, rtcpPacket->buffer()->BytePtr(),
-                        size, size, rtcpPacket->buffer()->SizeInBytes()
+                        buffer, packet, rtcpPacket->ptr(),
+                        size, size, rtcpPacket->size()
                         );
 
           auto success = receiver->handlePacket(viaComponent, rtcpPacket);
@@ -819,8 +838,8 @@ namespace ortc
                         puid, id, mID,
                         enum, viaComponenet, zsLib::to_underlying(viaComponent),
                         enum, packetType, zsLib::to_underlying(packetType),
-                        buffer, packet, rtcpPacket->buffer()->BytePtr(),
-                        size, size, rtcpPacket->buffer()->SizeInBytes()
+                        buffer, packet, rtcpPacket->ptr(),
+                        size, size, rtcpPacket->size()
                         );
 
           auto success = sender->handlePacket(viaComponent, rtcpPacket);
@@ -853,7 +872,7 @@ namespace ortc
         outPacketList->clear();
       }
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShutdown()) ||
           (isShuttingDown())) {
@@ -973,7 +992,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPListener::unregisterReceiver(UseReceiver &inReceiver)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ReceiverID receiverID = inReceiver.getID();
 
@@ -1061,7 +1080,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPListener::getPackets(RTCPPacketList &outPacketList)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       expireRTCPPackets();
 
@@ -1082,7 +1101,7 @@ namespace ortc
     {
       ZS_LOG_TRACE(log("notified that a receiver did not handle a delivered packet") + ZS_PARAM("ssrc", ssrc) + ZS_PARAM("payload", payloadType))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       processUnhandled(muxID, rid, ssrc, payloadType, zsLib::now());
     }
 
@@ -1111,7 +1130,7 @@ namespace ortc
 
       outPacketList.clear();
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShutdown()) ||
           (isShuttingDown())) {
@@ -1123,6 +1142,8 @@ namespace ortc
       (*senders)[inSender->getID()] = inSender;
       mSenders = senders;
 
+      setSenderSSRCs(inSender->getID(), &inParams);
+
       expireRTCPPackets();
 
       for (auto iter = mBufferedRTCPPackets.begin(); iter != mBufferedRTCPPackets.end(); ++iter)
@@ -1141,7 +1162,7 @@ namespace ortc
                     puid, senderId, inSender.getID()
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       SenderID senderID = inSender.getID();
 
@@ -1168,6 +1189,8 @@ namespace ortc
 
           mSenders = senders;
         }
+
+        setSenderSSRCs(senderID, NULL);
       }
       
     }
@@ -1187,7 +1210,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1211,7 +1234,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (timer == mSSRCTableTimer) {
         ZS_EVENTING_3(
@@ -1318,8 +1341,8 @@ namespace ortc
                     puid, id, mID,
                     enum, viaComponenet, zsLib::to_underlying(viaComponent),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
       receiver->handlePacket(viaComponent, packet);
     }
@@ -1357,7 +1380,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr RTPListener::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::RTPListener");
 
@@ -1509,6 +1532,7 @@ namespace ortc
 
       mReceivers = make_shared<ReceiverObjectMap>();
       mSenders = make_shared<SenderObjectMap>();
+      mSenderSSRCs = make_shared<SenderSSRCMap>();
 
       mSSRCTable.clear();
       mMuxIDTable.clear();
@@ -1596,8 +1620,8 @@ namespace ortc
                         x, i, Debug, RtpListenerDisposeBufferedIncomingPacket, ol, RtpListener, Dispose,
                         puid, id, mID,
                         enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                        buffer, packet, packet->buffer()->BytePtr(),
-                        size, size, packet->buffer()->SizeInBytes()
+                        buffer, packet, packet->ptr(),
+                        size, size, packet->size()
                         );
 
           ZS_LOG_TRACE(log("expiring buffered rtp packet") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", packetTime) + ZS_PARAM("total", mBufferedRTPPackets.size()))
@@ -1629,8 +1653,8 @@ namespace ortc
                         x, i, Debug, RtpListenerDisposeBufferedIncomingPacket, ol, RtpListener, Dispose,
                         puid, id, mID,
                         enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                        buffer, packet, packet->buffer()->BytePtr(),
-                        size, size, packet->buffer()->SizeInBytes()
+                        buffer, packet, packet->ptr(),
+                        size, size, packet->size()
                         );
 
           ZS_LOG_TRACE(log("expiring buffered rtcp packet") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", packetTime) + ZS_PARAM("total", mBufferedRTCPPackets.size()))
@@ -1744,8 +1768,8 @@ namespace ortc
                     x, i, Trace, RtpListenerFindMapping, ol, RtpListener, Info,
                     puid, id, mID,
                     string, muxId, outMuxID,
-                    buffer, packet, rtpPacket.buffer()->BytePtr(),
-                    size, size, rtpPacket.buffer()->SizeInBytes()
+                    buffer, packet, rtpPacket.ptr(),
+                    size, size, rtpPacket.size()
                     );
 
       {
@@ -2377,6 +2401,122 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPListener::routeFeedback(
+                                    IICETypes::Components viaComponent,
+                                    const BYTE *buffer,
+                                    size_t bufferLengthInBytes,
+                                    const FeedbackEventList &events,
+                                    bool &outResult
+                                    )
+    {
+      outResult = false;
+
+      SenderObjectMapPtr senders;
+      SenderSSRCMapPtr senderSSRCs;
+
+      {
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+        if (isShutdown()) return false;
+
+        senders = mSenders;
+        senderSSRCs = mSenderSSRCs;
+      }
+
+      if (senderSSRCs->size() < 1) return false;
+
+      SenderFeedbackMap routes;
+
+      for (auto iter = events.begin(); iter != events.end(); ++iter) {
+        auto &event = (*iter);
+
+        auto found = senderSSRCs->find(event.mSSRC);
+        if (found == senderSSRCs->end()) {
+          ZS_LOG_INSANE(log("feedback targets SSRC not owned by any sender (thus using full RTCP path)") + event.toDebug())
+          return false;
+        }
+
+        routes[(*found).second].push_back(event);
+      }
+
+      // parsed once and shared by every sender the feedback is routed to
+      auto rtcpPacket = RTCPPacket::create(buffer, bufferLengthInBytes);
+      if (!rtcpPacket) {
+        ZS_LOG_WARNING(Trace, log("invalid rtcp feedback packet (thus dropping)"))
+        return true;
+      }
+
+      for (auto iter = routes.begin(); iter != routes.end(); ++iter) {
+        SenderID senderID = (*iter).first;
+        auto &senderEvents = (*iter).second;
+
+        auto found = senders->find(senderID);
+        if (found == senders->end()) {
+          ZS_LOG_WARNING(Trace, log("sender is not registered") + ZS_PARAM("sender ID", senderID))
+          continue;
+        }
+
+        auto sender = (*found).second.lock();
+        if (!sender) {
+          ZS_LOG_WARNING(Trace, log("sender is gone") + ZS_PARAM("sender ID", senderID))
+          continue;
+        }
+
+        ZS_LOG_TRACE(log("forwarding RTCP feedback to sender") + ZS_PARAM("sender id", senderID) + ZS_PARAM("events", senderEvents.size()));
+        ZS_EVENTING_5(
+                      x, i, Trace, RtpListenerForwardIncomingPacket, ol, RtpListener, Deliver,
+                      puid, id, mID,
+                      enum, viaComponenet, zsLib::to_underlying(viaComponent),
+                      enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
+                      buffer, packet, rtcpPacket->ptr(),
+                      size, size, rtcpPacket->size()
+                      );
+
+        auto success = sender->handleFeedback(viaComponent, rtcpPacket, senderEvents);
+        outResult = outResult || success;
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::setSenderSSRCs(
+                                     SenderID senderID,
+                                     const Parameters *params
+                                     )
+    {
+      SenderSSRCMapPtr senderSSRCs(make_shared<SenderSSRCMap>(*mSenderSSRCs));
+
+      for (auto iter_doNotUse = senderSSRCs->begin(); iter_doNotUse != senderSSRCs->end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        if (senderID != (*current).second) continue;
+        senderSSRCs->erase(current);
+      }
+
+      if (params) {
+        for (auto iter = params->mEncodings.begin(); iter != params->mEncodings.end(); ++iter) {
+          auto &encoding = (*iter);
+
+          if (encoding.mSSRC.hasValue()) {
+            (*senderSSRCs)[encoding.mSSRC.value()] = senderID;
+          }
+          if ((encoding.mRTX.hasValue()) &&
+              (encoding.mRTX.value().mSSRC.hasValue())) {
+            (*senderSSRCs)[encoding.mRTX.value().mSSRC.value()] = senderID;
+          }
+          if ((encoding.mFEC.hasValue()) &&
+              (encoding.mFEC.value().mSSRC.hasValue())) {
+            (*senderSSRCs)[encoding.mFEC.value().mSSRC.value()] = senderID;
+          }
+        }
+      }
+
+      mSenderSSRCs = senderSSRCs;
+    }
+
     //-------------------------------------------------------------------------
     void RTPListener::handleDeltaChanges(
                                          ReceiverInfoPtr replacementInfo,
@@ -37,6 +37,7 @@
 #include <ortc/internal/ortc_RTPSenderChannelVideo.h>
 #include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc.events.h>
@@ -70,6 +71,9 @@
 #include <webrtc/voice_engine/include/voe_hardware.h>
 #include <webrtc/system_wrappers/include/cpu_info.h>
 #include <webrtc/voice_engine/include/voe_audio_processing.h>
+#include <webrtc/voice_engine/include/voe_base.h>
+#include <webrtc/voice_engine/include/voe_external_media.h>
+#include <webrtc/modules/include/module_common_types.h>
 #include <webrtc/modules/video_capture/video_capture_factory.h>
 #include <webrtc/modules/audio_coding/codecs/builtin_audio_decoder_factory.h>
 #ifdef WINRT
@@ -145,6 +149,8 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setBool(ORTC_SETTING_RTP_MEDIA_ENGINE_SHARE_VIDEO_ENCODERS, false);
+        ISettings::setUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_SHARED_VIDEO_ENCODER_MIN_KEY_FRAME_INTERVAL_IN_MILLISECONDS, 300);
       }
       
     };
@@ -815,6 +821,7 @@ namespace ortc
       // WARNING - DO NOT ENTER A LOCK!
 
       auto setup = make_shared<IRTPMediaEngineAsyncDelegate::SetupReceiverChannel>();
+      setup->mRequestedAt = MediaChannelLatency::now();
       setup->mRegistration = mRegistration.lock();
       setup->mPromise = PromiseWithRTPMediaEngineChannelResource::create(IORTCForInternal::queueORTC());
       setup->mChannel = channel;
@@ -873,6 +880,7 @@ namespace ortc
       // WARNING - DO NOT ENTER A LOCK!
 
       auto setup = make_shared<IRTPMediaEngineAsyncDelegate::SetupSenderChannel>();
+      setup->mRequestedAt = MediaChannelLatency::now();
       setup->mRegistration = mRegistration.lock();
       setup->mPromise = PromiseWithRTPMediaEngineChannelResource::create(IORTCForInternal::queueORTC());
       setup->mChannel = channel;
@@ -1049,6 +1057,7 @@ namespace ortc
                                                                            setup->mDTMFDelegate
                                                                            );
           resource->registerPromise(setup->mPromise);
+          resource->notifySetupRequested(setup->mRequestedAt);
           mChannelResources[resource->getID()] = resource;
           mPendingSetupChannelResources.push_back(resource);
         } else if (ZS_DYNAMIC_PTR_CAST(IRTPSenderChannelVideoForRTPMediaEngine, setup->mChannel)) {
@@ -1059,6 +1068,7 @@ namespace ortc
                                                                            setup->mParameters
                                                                            );
           resource->registerPromise(setup->mPromise);
+          resource->notifySetupRequested(setup->mRequestedAt);
           mChannelResources[resource->getID()] = resource;
           mPendingSetupChannelResources.push_back(resource);
         }
@@ -1083,6 +1093,7 @@ namespace ortc
                                                                                           setup->mPacket
                                                                                           );
           resource->registerPromise(setup->mPromise);
+          resource->notifySetupRequested(setup->mRequestedAt);
           mChannelResources[resource->getID()] = resource;
           mPendingSetupChannelResources.push_back(resource);
         } else if (ZS_DYNAMIC_PTR_CAST(IRTPReceiverChannelVideoForRTPMediaEngine, setup->mChannel)) {
@@ -1094,6 +1105,7 @@ namespace ortc
                                                                                           setup->mPacket
                                                                                           );
           resource->registerPromise(setup->mPromise);
+          resource->notifySetupRequested(setup->mRequestedAt);
           mChannelResources[resource->getID()] = resource;
           mPendingSetupChannelResources.push_back(resource);
         }
@@ -1194,6 +1206,84 @@ namespace ortc
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
     }
 
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::notifyChannelResourceCancelled()
+    {
+      AutoRecursiveLock lock(*this);
+
+      ZS_LOG_TRACE(log("channel resource cancelled") + ZS_PARAM("pending", mPendingCancelledChannelResources))
+
+      if (mPendingCancelledChannelResources > 0) --mPendingCancelledChannelResources;
+      if (0 != mPendingCancelledChannelResources) return;
+
+      IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine => (friend VideoSenderChannelResource)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::SharedVideoEncoderPtr RTPMediaEngine::attachSharedVideoEncoder(
+                                                                                   const String &key,
+                                                                                   VideoSenderChannelResourcePtr resource,
+                                                                                   TransportPtr transport,
+                                                                                   const SSRCList &ssrcs,
+                                                                                   int redPayloadType,
+                                                                                   int ulpfecPayloadType,
+                                                                                   ULONG clockRate,
+                                                                                   int maxFramerate,
+                                                                                   bool &outProducer
+                                                                                   )
+    {
+      AutoRecursiveLock lock(*this);
+
+      SharedVideoEncoderPtr encoder;
+
+      for (auto iter_doNotUse = mSharedVideoEncoders.begin(); iter_doNotUse != mSharedVideoEncoders.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto existing = (*current).second.lock();
+        if (!existing) {
+          mSharedVideoEncoders.erase(current);
+          continue;
+        }
+        if ((*current).first == key) encoder = existing;
+      }
+
+      if (!encoder) {
+        encoder = SharedVideoEncoder::create(
+                                             key,
+                                             redPayloadType,
+                                             ulpfecPayloadType,
+                                             Milliseconds(ISettings::getUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_SHARED_VIDEO_ENCODER_MIN_KEY_FRAME_INTERVAL_IN_MILLISECONDS)),
+                                             clockRate,
+                                             maxFramerate
+                                             );
+        mSharedVideoEncoders[key] = encoder;
+      }
+
+      outProducer = encoder->attach(resource, transport, ssrcs);
+
+      ZS_LOG_DEBUG(log("attached to shared video encoder") + ZS_PARAM("resource", resource->getID()) + ZS_PARAM("producer", outProducer) + ZS_PARAM("key", key))
+      return encoder;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::resetupChannelResource(ChannelResourcePtr channelResource)
+    {
+      AutoRecursiveLock lock(*this);
+
+      mPendingSetupChannelResources.push_back(channelResource);
+
+      IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1245,6 +1335,8 @@ namespace ortc
       IHelper::debugAppend(resultEl, "pending setup channel resources", mPendingSetupChannelResources.size());
       IHelper::debugAppend(resultEl, "pending close channel resources", mPendingCloseChannelResources.size());
 
+      IHelper::debugAppend(resultEl, "shared video encoders", mSharedVideoEncoders.size());
+
       return resultEl;
     }
 
@@ -1513,10 +1605,12 @@ namespace ortc
       if (!isMRPInstalled())
         return true;
 
+      // each channel resource is set up on its own media channel queue so
+      // slow setups do not hold up the engine (or each other)
       while (pendingSetupChannelResources.size() > 0) {
         auto channelResource = pendingSetupChannelResources.front();
 
-        channelResource->stepSetup();
+        IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(channelResource)->onStepSetup();
 
         pendingSetupChannelResources.pop_front();
       }
@@ -1540,8 +1634,8 @@ namespace ortc
       while (pendingCloseChannelResources.size() > 0) {
         auto channelResource = pendingCloseChannelResources.front();
 
-        channelResource->stepShutdown();
-        
+        IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(channelResource)->onStepShutdown();
+
         pendingCloseChannelResources.pop_front();
       }
 
@@ -1573,9 +1667,10 @@ namespace ortc
         // perform any graceful asynchronous shutdown processes needed and
         // re-attempt shutdown again later if needed.
 
-#define TODO_IMPLEMENT_MEDIA_GRACEFUL_SHUTDOWN 1
-#define TODO_IMPLEMENT_MEDIA_GRACEFUL_SHUTDOWN 2
-//        return;
+        if (mPendingCancelledChannelResources > 0) {
+          ZS_LOG_TRACE(log("waiting for channel resources to shutdown") + ZS_PARAM("pending", mPendingCancelledChannelResources))
+          return;
+        }
       }
 
       //.......................................................................
@@ -1608,29 +1703,37 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPMediaEngine::stepCancel()
     {
-      ChannelResourceList pendingCloseChannelResources;
-      ChannelResourceWeakMap channelResources;
+      ChannelResourceList cancelledChannelResources;
       {
         AutoRecursiveLock lock(*this);
-        pendingCloseChannelResources = mPendingCloseChannelResources;
+        cancelledChannelResources = mPendingCloseChannelResources;
         mPendingCloseChannelResources.clear();
-        channelResources = mChannelResources;
+
+        for (auto iter = mChannelResources.begin(); iter != mChannelResources.end(); ++iter)
+        {
+          auto channelResource = (*iter).second.lock();
+          if (channelResource) cancelledChannelResources.push_back(channelResource);
+        }
         mChannelResources.clear();
-      }
 
-      while (pendingCloseChannelResources.size() > 0) {
-        auto channelResource = pendingCloseChannelResources.front();
+        // the graceful shutdown reference is held until all of these report back
+        mPendingCancelledChannelResources += cancelledChannelResources.size();
+      }
 
-        channelResource->stepShutdown();
+      // shutdown on the resources' own queues so any setup still queued
+      // there finishes first
+      auto pThis = mThisWeak.lock();
+      QWORD requestedAt = MediaChannelLatency::now();
+      while (cancelledChannelResources.size() > 0) {
+        auto channelResource = cancelledChannelResources.front();
 
-        pendingCloseChannelResources.pop_front();
-      }
+        channelResource->notifyShutdownRequested(requestedAt);
+        channelResource->postClosure([pThis, channelResource] {
+          channelResource->onStepShutdown();
+          pThis->notifyChannelResourceCancelled();
+        });
 
-      for (auto iter = channelResources.begin(); iter != channelResources.end(); ++iter)
-      {
-        auto channelResource = (*iter).second.lock();
-        if (channelResource)
-          channelResource->stepShutdown();
+        cancelledChannelResources.pop_front();
       }
 
       {
@@ -1764,10 +1867,11 @@ namespace ortc
     RTPMediaEngine::BaseResource::BaseResource(
                                                const make_private &,
                                                IRTPMediaEngineRegistrationPtr registration,
-                                               RTPMediaEnginePtr engine
+                                               RTPMediaEnginePtr engine,
+                                               IMessageQueuePtr queue
                                                ) :
       SharedRecursiveLock(engine ? SharedRecursiveLock(engine->getSharedLock()) : SharedRecursiveLock::create()),
-      MessageQueueAssociator(engine ? engine->getAssociatedMessageQueue() : IORTCForInternal::queueBlockingMediaStartStopThread()),
+      MessageQueueAssociator(queue ? queue : (engine ? engine->getAssociatedMessageQueue() : IORTCForInternal::queueBlockingMediaStartStopThread())),
       mMediaEngine(engine),
       mRegistration(registration)
     {
@@ -1786,6 +1890,7 @@ namespace ortc
         AutoRecursiveLock lock(*this);
         mNotifiedReady = true;
       }
+      promisesSettled(true);
       internalFixState();
     }
 
@@ -1796,6 +1901,7 @@ namespace ortc
         AutoRecursiveLock lock(*this);
         mNotifiedRejected = true;
       }
+      promisesSettled(false);
       internalFixState();
     }
 
@@ -2693,7 +2799,7 @@ namespace ortc
                                                      const make_private &priv,
                                                      IRTPMediaEngineRegistrationPtr registration
                                                      ) : 
-      BaseResource(priv, registration, registration ? registration->getRTPEngine() : RTPMediaEnginePtr()),
+      BaseResource(priv, registration, registration ? registration->getRTPEngine() : RTPMediaEnginePtr(), IORTCForInternal::queueMediaChannelStartStop()),
       mHandlePacketQueue(IORTCForInternal::queuePacket()),
       mClock(webrtc::Clock::GetRealTimeClock()),
       mRemb(mClock),
@@ -2722,6 +2828,22 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::promisesSettled(bool resolved)
+    {
+      QWORD requestedAt {};
+
+      {
+        AutoRecursiveLock lock(*this);
+        requestedAt = mSetupRequestedAt;
+        mSetupRequestedAt = 0;
+      }
+
+      // only the first settle is counted, a re-setup (e.g. a shared video
+      // encoder changing) or a later rejection is not
+      MediaChannelLatency::recordSetup(requestedAt, resolved);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2742,13 +2864,14 @@ namespace ortc
         if (mShuttingDown) return promise;
 
         mShuttingDown = true;
+        mShutdownRequestedAt = MediaChannelLatency::now();
       }
 
       auto outer = mMediaEngine.lock();
       if (outer) {
         outer->shutdownChannelResource(ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock()));
       } else {
-        stepShutdown();
+        onStepShutdown();
       }
       return promise;
     }
@@ -2774,6 +2897,62 @@ namespace ortc
       IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onProvideStats(promise, stats);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource => IRTPMediaEngineChannelResourceAsyncDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::onStepSetup()
+    {
+      stepSetup();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::onStepShutdown()
+    {
+      stepShutdown();
+
+      QWORD requestedAt {};
+
+      {
+        AutoRecursiveLock lock(*this);
+        requestedAt = mShutdownRequestedAt;
+        mShutdownRequestedAt = 0;
+      }
+
+      MediaChannelLatency::recordShutdown(requestedAt);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource => (friend RTPMediaEngine)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::notifySetupRequested(QWORD requestedAt)
+    {
+      {
+        AutoRecursiveLock lock(*this);
+        mSetupRequestedAt = requestedAt;
+      }
+      MediaChannelLatency::notifySetupRequested();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::notifyShutdownRequested(QWORD requestedAt)
+    {
+      AutoRecursiveLock lock(*this);
+      if (0 != mShutdownRequestedAt) return;  // shutdown() already stamped it
+      mShutdownRequestedAt = requestedAt;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2901,6 +3080,9 @@ namespace ortc
       auto voiceEngine = engine->getVoiceEngine();
       if (!voiceEngine) return;
 
+      // see stepSetup()
+      AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
       ParametersPtr parameters;
       IRTPTypes::EncodingParametersList encodings;
       ISecureTransport::States previousState;
@@ -2935,6 +3117,9 @@ namespace ortc
       auto voiceEngine = engine->getVoiceEngine();
       if (!voiceEngine) return;
 
+      // see stepSetup()
+      AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
       bool previousActive = false;
       bool currentActive = false;
       {
@@ -3033,7 +3218,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::AudioReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer(), packet.ingressTime(), PacketPipelineLatency::now());
       return true;
     }
 
@@ -3044,6 +3229,54 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::AudioReceiverChannelResource::getAudioFrame(
+                                                                     const uint32_t samplesPerSecond,
+                                                                     int16_t *outSamples,
+                                                                     const size_t maxSamples,
+                                                                     size_t &outSamplesPerChannel,
+                                                                     size_t &outNumberOfChannels
+                                                                     )
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      outSamplesPerChannel = 0;
+      outNumberOfChannels = 0;
+
+      if (mDenyNonLockedAccess) return false;
+
+      auto engine = mMediaEngine.lock();
+      if (!engine) return false;
+
+      auto voiceEngine = engine->getVoiceEngine();
+      if (!voiceEngine) return false;
+
+      auto externalMedia = webrtc::VoEExternalMedia::GetInterface(voiceEngine);
+      if (!externalMedia) return false;
+
+      if (!mExternalMixing.exchange(true)) {
+        // the application is now pulling the decoded audio so stop the
+        // output mixer from also consuming (and playing out) this channel
+        externalMedia->SetExternalMixing(getChannel(), true);
+      }
+
+      webrtc::AudioFrame frame;
+      int result = externalMedia->GetAudioFrame(getChannel(), static_cast<int>(samplesPerSecond), &frame);
+      externalMedia->Release();
+
+      if (0 != result) return false;
+
+      size_t total = frame.samples_per_channel_ * frame.num_channels_;
+      if ((0 == total) ||
+          (total > maxSamples)) return false;
+
+      memcpy(outSamples, frame.data_, total * sizeof(int16_t));
+
+      outSamplesPerChannel = frame.samples_per_channel_;
+      outNumberOfChannels = frame.num_channels_;
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -3053,8 +3286,16 @@ namespace ortc
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTPPacket(
+                                                                         DWORD timestamp,
+                                                                         SecureByteBlockPtr buffer,
+                                                                         QWORD ingressTime,
+                                                                         QWORD queuedAt
+                                                                         )
     {
+      PacketPipelineLatency::recordSince(IStatsReportTypes::PacketPipelineHop_MediaEngineQueue, queuedAt);
+      PacketPipelineLatency::recordSince(IStatsReportTypes::PacketPipelineHop_EndToEnd, ingressTime);
+
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
       if (mDenyNonLockedAccess) return;
@@ -3188,56 +3429,63 @@ namespace ortc
 
       callStats->RegisterStatsObserver(congestionController.get());
 
-      channel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
-
       bool audioCodecSet = false;
       webrtc::CodecInst codec;
-      for (auto codecIter = parameters->mCodecs.begin(); codecIter != parameters->mCodecs.end(); codecIter++) {
-        auto supportedCodec = IRTPTypes::toSupportedCodec(codecIter->mName);
-        if (IRTPTypes::getCodecKind(supportedCodec) == IRTPTypes::CodecKind_Audio && audioCodecSet)
-          continue;
-        codec = getAudioCodec(voiceEngine, codecIter->mName);
-        codec.pltype = codecIter->mPayloadType;
-        if (codecIter->mPTime != Milliseconds::zero())
-          codec.pacsize = (int)((codec.plfreq / 1000) * codecIter->mPTime.count());
-        if (codecIter->mNumChannels.hasValue())
-          codec.channels = codecIter->mNumChannels;
-        switch (supportedCodec) {
-          case IRTPTypes::SupportedCodec_Opus:
-          {
-            auto opusParameters = IRTPTypes::OpusCodecParameters::convert(codecIter->mParameters);
-            if (opusParameters->mStereo.hasValue())
-              if (opusParameters->mStereo)
-                codec.channels = 2;
-              else
-                codec.channels = 1;
-            if (codec.channels == 1)
-              codec.pacsize /= 2;
-            codec.rate = 32000 * codec.channels;
-            webrtc::VoECodec::GetInterface(voiceEngine)->SetRecPayloadType(channel, codec);
-            goto set_rtcp_feedback;
+
+      {
+        // the voice engine (and its audio state) is shared by every audio
+        // channel resource; only hold its lock while calling into it
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
+        channel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
+
+        for (auto codecIter = parameters->mCodecs.begin(); codecIter != parameters->mCodecs.end(); codecIter++) {
+          auto supportedCodec = IRTPTypes::toSupportedCodec(codecIter->mName);
+          if (IRTPTypes::getCodecKind(supportedCodec) == IRTPTypes::CodecKind_Audio && audioCodecSet)
+            continue;
+          codec = getAudioCodec(voiceEngine, codecIter->mName);
+          codec.pltype = codecIter->mPayloadType;
+          if (codecIter->mPTime != Milliseconds::zero())
+            codec.pacsize = (int)((codec.plfreq / 1000) * codecIter->mPTime.count());
+          if (codecIter->mNumChannels.hasValue())
+            codec.channels = codecIter->mNumChannels;
+          switch (supportedCodec) {
+            case IRTPTypes::SupportedCodec_Opus:
+            {
+              auto opusParameters = IRTPTypes::OpusCodecParameters::convert(codecIter->mParameters);
+              if (opusParameters->mStereo.hasValue())
+                if (opusParameters->mStereo)
+                  codec.channels = 2;
+                else
+                  codec.channels = 1;
+              if (codec.channels == 1)
+                codec.pacsize /= 2;
+              codec.rate = 32000 * codec.channels;
+              webrtc::VoECodec::GetInterface(voiceEngine)->SetRecPayloadType(channel, codec);
+              goto set_rtcp_feedback;
+            }
+            case IRTPTypes::SupportedCodec_Isac:
+            case IRTPTypes::SupportedCodec_G722:
+            case IRTPTypes::SupportedCodec_ILBC:
+            case IRTPTypes::SupportedCodec_PCMU:
+            case IRTPTypes::SupportedCodec_PCMA:
+              webrtc::VoECodec::GetInterface(voiceEngine)->SetRecPayloadType(channel, codec);
+              goto set_rtcp_feedback;
+            case IRTPTypes::SupportedCodec_RED:
+              break;
           }
-          case IRTPTypes::SupportedCodec_Isac:
-          case IRTPTypes::SupportedCodec_G722:
-          case IRTPTypes::SupportedCodec_ILBC:
-          case IRTPTypes::SupportedCodec_PCMU:
-          case IRTPTypes::SupportedCodec_PCMA:
-            webrtc::VoECodec::GetInterface(voiceEngine)->SetRecPayloadType(channel, codec);
-            goto set_rtcp_feedback;
-          case IRTPTypes::SupportedCodec_RED:
-            break;
-        }
-        continue;
+          continue;
 
-      set_rtcp_feedback:
-        for (auto rtcpFeedbackIter = codecIter->mRTCPFeedback.begin(); rtcpFeedbackIter != codecIter->mRTCPFeedback.end(); rtcpFeedbackIter++) {
-          IRTPTypes::KnownFeedbackTypes feedbackType = IRTPTypes::toKnownFeedbackType(rtcpFeedbackIter->mType);
-          IRTPTypes::KnownFeedbackParameters feedbackParameter = IRTPTypes::toKnownFeedbackParameter(rtcpFeedbackIter->mParameter);
-          if (IRTPTypes::KnownFeedbackType_NACK == feedbackType && IRTPTypes::KnownFeedbackParameter_Unknown == feedbackParameter) {
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetNACKStatus(channel, true, 250);
+        set_rtcp_feedback:
+          for (auto rtcpFeedbackIter = codecIter->mRTCPFeedback.begin(); rtcpFeedbackIter != codecIter->mRTCPFeedback.end(); rtcpFeedbackIter++) {
+            IRTPTypes::KnownFeedbackTypes feedbackType = IRTPTypes::toKnownFeedbackType(rtcpFeedbackIter->mType);
+            IRTPTypes::KnownFeedbackParameters feedbackParameter = IRTPTypes::toKnownFeedbackParameter(rtcpFeedbackIter->mParameter);
+            if (IRTPTypes::KnownFeedbackType_NACK == feedbackType && IRTPTypes::KnownFeedbackParameter_Unknown == feedbackParameter) {
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetNACKStatus(channel, true, 250);
+            }
           }
+          audioCodecSet = true;
         }
-        audioCodecSet = true;
       }
 
       codecPayloadName = codec.plname;
@@ -3271,28 +3519,32 @@ namespace ortc
         mInitPacket.reset();
       }
 
-      for (auto headerExtensionIter = parameters->mHeaderExtensions.begin(); headerExtensionIter != parameters->mHeaderExtensions.end(); headerExtensionIter++) {
-        IRTPTypes::HeaderExtensionURIs headerExtensionURI = IRTPTypes::toHeaderExtensionURI(headerExtensionIter->mURI);
-        switch (headerExtensionURI) {
-          case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetReceiveAudioLevelIndicationStatus(channel, true, (BYTE)headerExtensionIter->mID);
-            config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
-            break;
-          case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_AbsoluteSendTime:
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetReceiveAbsoluteSenderTimeStatus(channel, true, (BYTE)headerExtensionIter->mID);
-            config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
-            break;
-          default:
-            break;
+      {
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
+        for (auto headerExtensionIter = parameters->mHeaderExtensions.begin(); headerExtensionIter != parameters->mHeaderExtensions.end(); headerExtensionIter++) {
+          IRTPTypes::HeaderExtensionURIs headerExtensionURI = IRTPTypes::toHeaderExtensionURI(headerExtensionIter->mURI);
+          switch (headerExtensionURI) {
+            case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetReceiveAudioLevelIndicationStatus(channel, true, (BYTE)headerExtensionIter->mID);
+              config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
+              break;
+            case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_AbsoluteSendTime:
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetReceiveAbsoluteSenderTimeStatus(channel, true, (BYTE)headerExtensionIter->mID);
+              config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
+              break;
+            default:
+              break;
+          }
         }
-      }
 
-      uint32_t localSSRC = mParameters->mRTCP.mSSRC;
-      if (localSSRC == 0)
-        localSSRC = 1;
-      webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetLocalSSRC(channel, localSSRC);
-      config.rtp.local_ssrc = localSSRC;
-      config.rtcp_send_transport = mTransport.get();
+        uint32_t localSSRC = mParameters->mRTCP.mSSRC;
+        if (localSSRC == 0)
+          localSSRC = 1;
+        webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetLocalSSRC(channel, localSSRC);
+        config.rtp.local_ssrc = localSSRC;
+        config.rtcp_send_transport = mTransport.get();
+      }
 
       {
         AutoRecursiveLock lock(*this);
@@ -3314,25 +3566,29 @@ namespace ortc
       mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
       mPacerThread->Start();
 
-      webrtc::internal::AudioReceiveStream *receiveStream =
-        new webrtc::internal::AudioReceiveStream(
-                                                 mCongestionController.get(),
-                                                 config,
-                                                 audioState,
-                                                 mEventLog.get()
-                                                 );
-
       {
-        AutoRecursiveLock lock(*this);
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
 
-        mReceiveStream = receiveStream;
-      }
+        webrtc::internal::AudioReceiveStream *receiveStream =
+          new webrtc::internal::AudioReceiveStream(
+                                                   mCongestionController.get(),
+                                                   config,
+                                                   audioState,
+                                                   mEventLog.get()
+                                                   );
+
+        {
+          AutoRecursiveLock lock(*this);
 
-      webrtc::VoENetwork::GetInterface(voiceEngine)->RegisterExternalTransport(channel, *mTransport);
+          mReceiveStream = receiveStream;
+        }
 
-      if (mTransportState == ISecureTransport::State_Connected) {
-        webrtc::VoEBase::GetInterface(voiceEngine)->StartReceive(channel);
-        webrtc::VoEBase::GetInterface(voiceEngine)->StartPlayout(channel);
+        webrtc::VoENetwork::GetInterface(voiceEngine)->RegisterExternalTransport(channel, *mTransport);
+
+        if (mTransportState == ISecureTransport::State_Connected) {
+          webrtc::VoEBase::GetInterface(voiceEngine)->StartReceive(channel);
+          webrtc::VoEBase::GetInterface(voiceEngine)->StartPlayout(channel);
+        }
       }
 
       notifyPromisesResolve();
@@ -3360,6 +3616,9 @@ namespace ortc
       auto outer = mMediaEngine.lock();
 
       if (outer) {
+        // see stepSetup()
+        AutoRecursiveLock voiceLock(outer->getVoiceEngineLock());
+
         auto voiceEngine = outer->getVoiceEngine();
         if (voiceEngine) {
           if (mTransportState == ISecureTransport::State_Connected) {
@@ -3518,6 +3777,9 @@ namespace ortc
       auto voiceEngine = engine->getVoiceEngine();
       if (!voiceEngine) return;
 
+      // see stepSetup()
+      AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
       ParametersPtr parameters;
       IRTPTypes::EncodingParametersList encodings;
       ISecureTransport::States previousState;
@@ -3550,6 +3812,9 @@ namespace ortc
       auto voiceEngine = engine->getVoiceEngine();
       if (!voiceEngine) return;
 
+      // see stepSetup()
+      AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
       bool previousActive = false;
       bool currentActive = false;
       {
@@ -3727,6 +3992,38 @@ namespace ortc
       return mDTMFInterToneGap;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::AudioSenderChannelResource::sendAudioFrame(
+                                                                    const int16_t *samples,
+                                                                    const size_t samplesPerChannel,
+                                                                    const size_t numberOfChannels,
+                                                                    const uint32_t samplesPerSecond
+                                                                    )
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      if (mDenyNonLockedAccess) return false;
+
+      auto engine = mMediaEngine.lock();
+      if (!engine) return false;
+
+      auto voiceEngine = engine->getVoiceEngine();
+      if (!voiceEngine) return false;
+
+      auto base = webrtc::VoEBase::GetInterface(voiceEngine);
+      if (!base) return false;
+
+      // bypasses the audio device module entirely; the voice engine runs
+      // the frame through the normal capture processing and encoder
+      auto transport = base->audio_transport();
+      if (transport) {
+        transport->PushCaptureData(mChannel, samples, 16, static_cast<int>(samplesPerSecond), numberOfChannels, samplesPerChannel);
+      }
+      base->Release();
+
+      return NULL != transport;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -3877,64 +4174,71 @@ namespace ortc
 
       callStats->RegisterStatsObserver(congestionController.get());
 
-      channel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
-
       bool audioCodecSet = false;
       webrtc::CodecInst codec;
-      for (auto codecIter = parameters->mCodecs.begin(); codecIter != parameters->mCodecs.end(); codecIter++) {
-        auto supportedCodec = IRTPTypes::toSupportedCodec(codecIter->mName);
-        if (IRTPTypes::getCodecKind(supportedCodec) == IRTPTypes::CodecKind_Audio && audioCodecSet)
-          continue;
-        codec = getAudioCodec(voiceEngine, codecIter->mName);
-        codec.pltype = codecIter->mPayloadType;
-        if (codecIter->mPTime != Milliseconds::zero())
-          codec.pacsize = (int)((codec.plfreq / 1000) * codecIter->mPTime.count());
-        if (codecIter->mNumChannels.hasValue())
-          codec.channels = codecIter->mNumChannels;
-        switch (supportedCodec) {
-          case IRTPTypes::SupportedCodec_Opus:
-          {
-            auto parameters = IRTPTypes::OpusCodecParameters::convert(codecIter->mParameters);
-            if (parameters->mStereo.hasValue())
-              if (parameters->mStereo)
-                codec.channels = 2;
-              else
-                codec.channels = 1;
-            if (codec.channels == 1)
-              codec.pacsize /= 2;
-            codec.rate = 32000 * codec.channels;
-            webrtc::VoECodec::GetInterface(voiceEngine)->SetSendCodec(channel, codec);
-            if (parameters->mUseInbandFEC.hasValue())
-              webrtc::VoECodec::GetInterface(voiceEngine)->SetFECStatus(channel, parameters->mUseInbandFEC);
-            if (parameters->mUseDTX.hasValue())
-              webrtc::VoECodec::GetInterface(voiceEngine)->SetOpusDtx(channel, parameters->mUseDTX);
-            webrtc::VoECodec::GetInterface(voiceEngine)->SetOpusMaxPlaybackRate(channel, 48000);
-            goto set_rtcp_feedback;
+
+      {
+        // the voice engine (and its audio state) is shared by every audio
+        // channel resource; only hold its lock while calling into it
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
+        channel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
+
+        for (auto codecIter = parameters->mCodecs.begin(); codecIter != parameters->mCodecs.end(); codecIter++) {
+          auto supportedCodec = IRTPTypes::toSupportedCodec(codecIter->mName);
+          if (IRTPTypes::getCodecKind(supportedCodec) == IRTPTypes::CodecKind_Audio && audioCodecSet)
+            continue;
+          codec = getAudioCodec(voiceEngine, codecIter->mName);
+          codec.pltype = codecIter->mPayloadType;
+          if (codecIter->mPTime != Milliseconds::zero())
+            codec.pacsize = (int)((codec.plfreq / 1000) * codecIter->mPTime.count());
+          if (codecIter->mNumChannels.hasValue())
+            codec.channels = codecIter->mNumChannels;
+          switch (supportedCodec) {
+            case IRTPTypes::SupportedCodec_Opus:
+            {
+              auto parameters = IRTPTypes::OpusCodecParameters::convert(codecIter->mParameters);
+              if (parameters->mStereo.hasValue())
+                if (parameters->mStereo)
+                  codec.channels = 2;
+                else
+                  codec.channels = 1;
+              if (codec.channels == 1)
+                codec.pacsize /= 2;
+              codec.rate = 32000 * codec.channels;
+              webrtc::VoECodec::GetInterface(voiceEngine)->SetSendCodec(channel, codec);
+              if (parameters->mUseInbandFEC.hasValue())
+                webrtc::VoECodec::GetInterface(voiceEngine)->SetFECStatus(channel, parameters->mUseInbandFEC);
+              if (parameters->mUseDTX.hasValue())
+                webrtc::VoECodec::GetInterface(voiceEngine)->SetOpusDtx(channel, parameters->mUseDTX);
+              webrtc::VoECodec::GetInterface(voiceEngine)->SetOpusMaxPlaybackRate(channel, 48000);
+              goto set_rtcp_feedback;
+            }
+            case IRTPTypes::SupportedCodec_Isac:
+            case IRTPTypes::SupportedCodec_G722:
+            case IRTPTypes::SupportedCodec_ILBC:
+            case IRTPTypes::SupportedCodec_PCMU:
+            case IRTPTypes::SupportedCodec_PCMA:
+              webrtc::VoECodec::GetInterface(voiceEngine)->SetSendCodec(channel, codec);
+              goto set_rtcp_feedback;
+            case IRTPTypes::SupportedCodec_RED:
+              break;
+            case IRTPTypes::SupportedCodec_TelephoneEvent:
+              dtmfPayloadType = codecIter->mPayloadType;
+              break;
           }
-          case IRTPTypes::SupportedCodec_Isac:
-          case IRTPTypes::SupportedCodec_G722:
-          case IRTPTypes::SupportedCodec_ILBC:
-          case IRTPTypes::SupportedCodec_PCMU:
-          case IRTPTypes::SupportedCodec_PCMA:
-            webrtc::VoECodec::GetInterface(voiceEngine)->SetSendCodec(channel, codec);
-            goto set_rtcp_feedback;
-          case IRTPTypes::SupportedCodec_RED:
-            break;
-          case IRTPTypes::SupportedCodec_TelephoneEvent:
-            dtmfPayloadType = codecIter->mPayloadType;
-            break;
-        }
-        continue;
+          continue;
 
-      set_rtcp_feedback:
-        for (auto rtcpFeedbackIter = codecIter->mRTCPFeedback.begin(); rtcpFeedbackIter != codecIter->mRTCPFeedback.end(); rtcpFeedbackIter++) {
-          IRTPTypes::KnownFeedbackTypes feedbackType = IRTPTypes::toKnownFeedbackType(rtcpFeedbackIter->mType);
-          IRTPTypes::KnownFeedbackParameters feedbackParameter = IRTPTypes::toKnownFeedbackParameter(rtcpFeedbackIter->mParameter);
-          if (IRTPTypes::KnownFeedbackType_NACK == feedbackType && IRTPTypes::KnownFeedbackParameter_Unknown == feedbackParameter) {
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetNACKStatus(channel, true, 250);
+        set_rtcp_feedback:
+          for (auto rtcpFeedbackIter = codecIter->mRTCPFeedback.begin(); rtcpFeedbackIter != codecIter->mRTCPFeedback.end(); rtcpFeedbackIter++) {
+            IRTPTypes::KnownFeedbackTypes feedbackType = IRTPTypes::toKnownFeedbackType(rtcpFeedbackIter->mType);
+            IRTPTypes::KnownFeedbackParameters feedbackParameter = IRTPTypes::toKnownFeedbackParameter(rtcpFeedbackIter->mParameter);
+            if (IRTPTypes::KnownFeedbackType_NACK == feedbackType && IRTPTypes::KnownFeedbackParameter_Unknown == feedbackParameter) {
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetNACKStatus(channel, true, 250);
+            }
           }
+          audioCodecSet = true;
         }
-        audioCodecSet = true;
       }
 
       codecPayloadName = codec.plname;
@@ -3942,53 +4246,57 @@ namespace ortc
 
       config.voe_channel_id = mChannel;
 
-      for (auto encodingParamIter = parameters->mEncodings.begin(); encodingParamIter != parameters->mEncodings.end(); encodingParamIter++) {
+      {
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
 
-        IRTPTypes::PayloadType codecPayloadType{};
-        if (encodingParamIter->mCodecPayloadType.hasValue())
-          codecPayloadType = encodingParamIter->mCodecPayloadType;
-        else
-          codecPayloadType = (BYTE)codec.pltype;
+        for (auto encodingParamIter = parameters->mEncodings.begin(); encodingParamIter != parameters->mEncodings.end(); encodingParamIter++) {
 
-        if (codecPayloadType == codec.pltype) {
-          uint32_t ssrc = 0;
-          if (encodingParamIter->mSSRC.hasValue()) {
-            ssrc = encodingParamIter->mSSRC;
-          }
-          if (encodingParamIter->mFEC.hasValue()) {
-            IRTPTypes::FECParameters fec = encodingParamIter->mFEC;
-            if (fec.mSSRC.hasValue()) {
-              ssrc = fec.mSSRC;
+          IRTPTypes::PayloadType codecPayloadType{};
+          if (encodingParamIter->mCodecPayloadType.hasValue())
+            codecPayloadType = encodingParamIter->mCodecPayloadType;
+          else
+            codecPayloadType = (BYTE)codec.pltype;
+
+          if (codecPayloadType == codec.pltype) {
+            uint32_t ssrc = 0;
+            if (encodingParamIter->mSSRC.hasValue()) {
+              ssrc = encodingParamIter->mSSRC;
             }
+            if (encodingParamIter->mFEC.hasValue()) {
+              IRTPTypes::FECParameters fec = encodingParamIter->mFEC;
+              if (fec.mSSRC.hasValue()) {
+                ssrc = fec.mSSRC;
+              }
+            }
+            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetLocalSSRC(channel, ssrc);
+            config.rtp.ssrc = ssrc;
           }
+        }
+        if (config.rtp.ssrc == 0) {
+          uint32_t ssrc = SafeInt<uint32_t>(ortc::services::IHelper::random(1, 0xFFFFFFFF));
           webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetLocalSSRC(channel, ssrc);
           config.rtp.ssrc = ssrc;
         }
-      }
-      if (config.rtp.ssrc == 0) {
-        uint32_t ssrc = SafeInt<uint32_t>(ortc::services::IHelper::random(1, 0xFFFFFFFF));
-        webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetLocalSSRC(channel, ssrc);
-        config.rtp.ssrc = ssrc;
-      }
 
-      for (auto headerExtensionIter = parameters->mHeaderExtensions.begin(); headerExtensionIter != parameters->mHeaderExtensions.end(); headerExtensionIter++) {
-        IRTPTypes::HeaderExtensionURIs headerExtensionURI = IRTPTypes::toHeaderExtensionURI(headerExtensionIter->mURI);
-        switch (headerExtensionURI) {
-          case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetSendAudioLevelIndicationStatus(channel, true, (BYTE)headerExtensionIter->mID);
-            config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
-            break;
-          case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_AbsoluteSendTime:
-            webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetSendAbsoluteSenderTimeStatus(channel, true, (BYTE)headerExtensionIter->mID);
-            config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
-            break;
-          default:
-            break;
+        for (auto headerExtensionIter = parameters->mHeaderExtensions.begin(); headerExtensionIter != parameters->mHeaderExtensions.end(); headerExtensionIter++) {
+          IRTPTypes::HeaderExtensionURIs headerExtensionURI = IRTPTypes::toHeaderExtensionURI(headerExtensionIter->mURI);
+          switch (headerExtensionURI) {
+            case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetSendAudioLevelIndicationStatus(channel, true, (BYTE)headerExtensionIter->mID);
+              config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
+              break;
+            case IRTPTypes::HeaderExtensionURIs::HeaderExtensionURI_AbsoluteSendTime:
+              webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetSendAbsoluteSenderTimeStatus(channel, true, (BYTE)headerExtensionIter->mID);
+              config.rtp.extensions.push_back(webrtc::RtpExtension(headerExtensionIter->mURI, headerExtensionIter->mID));
+              break;
+            default:
+              break;
+          }
         }
-      }
 
-      webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCPStatus(channel, true);
-      webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCP_CNAME(channel, parameters->mRTCP.mCName);
+        webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCPStatus(channel, true);
+        webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCP_CNAME(channel, parameters->mRTCP.mCName);
+      }
 
       {
         AutoRecursiveLock lock(*this);
@@ -4013,25 +4321,29 @@ namespace ortc
       mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
       mPacerThread->Start();
 
-      webrtc::internal::AudioSendStream *sendStream =
-        new webrtc::internal::AudioSendStream(
-                                              config,
-                                              audioState,
-                                              &mWorkerQueue,
-                                              mCongestionController.get(),
-                                              mBitrateAllocator.get()
-                                              );
-
       {
-        AutoRecursiveLock lock(*this);
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
 
-        mSendStream = sendStream;
-      }
+        webrtc::internal::AudioSendStream *sendStream =
+          new webrtc::internal::AudioSendStream(
+                                                config,
+                                                audioState,
+                                                &mWorkerQueue,
+                                                mCongestionController.get(),
+                                                mBitrateAllocator.get()
+                                                );
 
-      webrtc::VoENetwork::GetInterface(voiceEngine)->RegisterExternalTransport(channel, *mTransport);
+        {
+          AutoRecursiveLock lock(*this);
 
-      if (mTransportState == ISecureTransport::State_Connected)
-        webrtc::VoEBase::GetInterface(voiceEngine)->StartSend(channel);
+          mSendStream = sendStream;
+        }
+
+        webrtc::VoENetwork::GetInterface(voiceEngine)->RegisterExternalTransport(channel, *mTransport);
+
+        if (mTransportState == ISecureTransport::State_Connected)
+          webrtc::VoEBase::GetInterface(voiceEngine)->StartSend(channel);
+      }
 
       notifyPromisesResolve();
     }
@@ -4057,6 +4369,9 @@ namespace ortc
 
       auto engine = mMediaEngine.lock();
       if (engine) {
+        // see stepSetup()
+        AutoRecursiveLock voiceLock(engine->getVoiceEngineLock());
+
         auto voiceEngine = engine->getVoiceEngine();
         if (voiceEngine) {
           if (mTransportState == ISecureTransport::State_Connected)
@@ -4370,7 +4685,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::VideoReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer(), packet.ingressTime(), PacketPipelineLatency::now());
       return true;
     }
 
@@ -4390,8 +4705,16 @@ namespace ortc
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTPPacket(
+                                                                         DWORD timestamp,
+                                                                         SecureByteBlockPtr buffer,
+                                                                         QWORD ingressTime,
+                                                                         QWORD queuedAt
+                                                                         )
     {
+      PacketPipelineLatency::recordSince(IStatsReportTypes::PacketPipelineHop_MediaEngineQueue, queuedAt);
+      PacketPipelineLatency::recordSince(IStatsReportTypes::PacketPipelineHop_EndToEnd, ingressTime);
+
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
       if (mDenyNonLockedAccess) return;
@@ -4830,31 +5153,21 @@ namespace ortc
     {
       if (state == mTransportState) return;
 
-      if (!mSendStream) return;
-
-      ParametersPtr parameters;
-      IRTPTypes::EncodingParametersList encodings;
-      webrtc::VideoSendStream *sendStream;
-      ISecureTransport::States previousState;
-      {
-        AutoRecursiveLock lock(*this);
-
-        sendStream = mSendStream;
+      mTransportState = state;
 
-        parameters = mParameters;
-        if (parameters)
-          encodings = mParameters->mEncodings;
-        previousState = mTransportState;
-        mTransportState = state;
+      if (mSharedConsumer) {
+        // consumers of a shared encoder send without a stream of their own
+        // but the producer's stream may need to start (or stop) for them
+        SharedVideoEncoderPtr sharedEncoder;
+        {
+          AutoRecursiveLock lock(*this);
+          sharedEncoder = mSharedEncoder;
+        }
+        if (sharedEncoder) sharedEncoder->notifyConsumerStateChanged();
+        return;
       }
 
-      if (parameters && sendStream && (encodings.size() == 0 ||
-        encodings.size() > 0 && encodings.begin()->mActive)) {
-        if (state == ISecureTransport::State_Connected)
-          sendStream->Start();
-        else if (previousState == ISecureTransport::State_Connected)
-          sendStream->Stop();
-      }
+      updateSendStream();
     }
 
     //-------------------------------------------------------------------------
@@ -4885,14 +5198,22 @@ namespace ortc
           (params->mEncodings.size() > 0 && params->mEncodings.begin()->mActive)) {
           currentActive = true;
         }
+        mEncodingActive = currentActive;
       }
 
-      if (mTransportState == ISecureTransport::State_Connected && sendStream) {
-        if (!previousActive && currentActive)
-          sendStream->Start();
-        else if (previousActive && !currentActive)
-          sendStream->Stop();
+      if (previousActive == currentActive) return;
+
+      if (mSharedConsumer) {
+        SharedVideoEncoderPtr sharedEncoder;
+        {
+          AutoRecursiveLock lock(*this);
+          sharedEncoder = mSharedEncoder;
+        }
+        if (sharedEncoder) sharedEncoder->notifyConsumerStateChanged();
+        return;
       }
+
+      if (sendStream) updateSendStream();
     }
 
     //-------------------------------------------------------------------------
@@ -4904,6 +5225,11 @@ namespace ortc
         return;
       }
 
+      if (mSharedConsumer) {
+        provideSharedStats(promise, stats);
+        return;
+      }
+
       AutoRecursiveLock lock(*this);
 
       if (!mSendStream) {
@@ -4976,6 +5302,8 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPMediaEngine::VideoSenderChannelResource::sendVideoFrame(VideoFramePtr videoFrame)
     {
+      if (mSharedConsumer) return;  // the shared encoder's producer encodes the frame for everyone
+
       IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoSenderChannelResource>())->onSendVideoFrame(videoFrame);
     }
 
@@ -4994,6 +5322,31 @@ namespace ortc
 
       if (mDenyNonLockedAccess) return;
 
+      if (mSharedConsumer) {
+        SharedVideoEncoderPtr sharedEncoder;
+        {
+          AutoRecursiveLock lock(*this);
+          sharedEncoder = mSharedEncoder;
+        }
+        if (!sharedEncoder) return;
+
+        // only keyframe requests matter to a consumer; everything else in
+        // the report describes a stream that is encoded elsewhere
+        RTCPPacket::FeedbackEventList events;
+        bool feedbackOnly = false;
+        if (!RTCPPacket::extractFeedback(buffer->BytePtr(), buffer->SizeInBytes(), events, feedbackOnly)) return;
+
+        for (auto iter = events.begin(); iter != events.end(); ++iter) {
+          auto &event = (*iter);
+          switch (event.mType) {
+            case RTCPPacket::FeedbackEvent::Type_PLI:
+            case RTCPPacket::FeedbackEvent::Type_FIR:   sharedEncoder->requestKeyFrame(getID(), event.mSSRC, event.mSSRCOfPacketSender); break;
+            default:                                    break;
+          }
+        }
+        return;
+      }
+
       auto stream = reinterpret_cast<webrtc::internal::VideoSendStream*>(mSendStream);
       if (NULL == stream) return;
 
@@ -5057,6 +5410,46 @@ namespace ortc
       mCongestionController->SetAllocatedSendBitrateLimits(min_send_bitrate_bps, max_padding_bitrate_bps);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::VideoSenderChannelResource => friend SharedVideoEncoder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::VideoSenderChannelResource::isSharedSendActive() const
+    {
+      return (ISecureTransport::State_Connected == mTransportState) && (mEncodingActive);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::VideoSenderChannelResource::deliverSharedRTCP(
+                                                                       const BYTE *buffer,
+                                                                       size_t bufferLengthInBytes
+                                                                       )
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      if (mDenyNonLockedAccess) return;
+
+      auto stream = reinterpret_cast<webrtc::internal::VideoSendStream*>(mSendStream);
+      if (NULL == stream) return;
+
+      stream->DeliverRtcp(buffer, bufferLengthInBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::VideoSenderChannelResource::notifySharedSendStateChanged()
+    {
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
+
+      if (mDenyNonLockedAccess) return;
+
+      updateSendStream();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -5087,15 +5480,21 @@ namespace ortc
       std::unique_ptr<webrtc::CongestionController> congestionController;
       String codecPayloadName;
       BYTE codecPayloadType;
+      ULONG codecClockRate {90000};
+      bool promoted {};
 
       {
         AutoRecursiveLock lock(*this);
 
         parameters = mParameters;
+
+        // a shared encoder consumer set up again as the producer already
+        // settled its setup promises the first time around
+        promoted = (bool)mSharedEncoder;
       }
 
       if (!parameters) {
-        notifyPromisesReject();
+        if (!promoted) notifyPromisesReject();
         return;
       }
 
@@ -5221,6 +5620,7 @@ namespace ortc
             config.rtp.nack.rtp_history_ms = 1000;
           }
         }
+        if (codecIter->mClockRate.hasValue()) codecClockRate = codecIter->mClockRate.value();
         videoCodecSet = true;
       }
 
@@ -5382,6 +5782,62 @@ namespace ortc
 
       config.rtp.c_name = parameters->mRTCP.mCName;
 
+      mEncodingActive = isActive(*parameters);
+
+      {
+        SharedVideoEncoderPtr sharedEncoder;
+        SSRCList sharedSSRCs;
+        {
+          AutoRecursiveLock lock(*this);
+          sharedEncoder = mSharedEncoder;
+          sharedSSRCs = mSharedSSRCs;
+        }
+
+        if (sharedEncoder) {
+          // a consumer was promoted after the previous producer went away;
+          // keep the SSRCs its remote party already knows
+          if (sharedSSRCs.size() == config.rtp.ssrcs.size()) config.rtp.ssrcs = sharedSSRCs;
+          config.send_transport = sharedEncoder.get();
+          mSharedConsumer = false;
+        } else if (ISettings::getBool(ORTC_SETTING_RTP_MEDIA_ENGINE_SHARE_VIDEO_ENCODERS)) {
+          auto engine = mMediaEngine.lock();
+          if (engine) {
+            bool producer = false;
+            sharedEncoder = engine->attachSharedVideoEncoder(
+                                                             sharedEncoderKey(track->id(), *parameters, config, encoderConfig),
+                                                             getThis<VideoSenderChannelResource>(),
+                                                             mTransport,
+                                                             config.rtp.ssrcs,
+                                                             config.rtp.fec.red_payload_type,
+                                                             config.rtp.fec.ulpfec_payload_type,
+                                                             codecClockRate,
+                                                             sourceMaxFramerate,
+                                                             producer
+                                                             );
+            {
+              AutoRecursiveLock lock(*this);
+              mSharedEncoder = sharedEncoder;
+              mSharedSSRCs = config.rtp.ssrcs;
+              mCodecPayloadName = codecPayloadName;
+              mCodecPayloadType = codecPayloadType;
+            }
+
+            if (!producer) {
+              delete config.encoder_settings.encoder;
+              config.encoder_settings.encoder = NULL;
+
+              mSharedConsumer = true;
+              sharedEncoder->requestKeyFrames(getID());
+              sharedEncoder->notifyConsumerStateChanged();
+              notifyPromisesResolve();
+              return;
+            }
+
+            config.send_transport = sharedEncoder.get();
+          }
+        }
+      }
+
       {
         AutoRecursiveLock lock(*this);
 
@@ -5426,10 +5882,9 @@ namespace ortc
         mSendStream = sendStream;
       }
 
-      if (mTransportState == ISecureTransport::State_Connected)
-        sendStream->Start();
+      updateSendStream();
 
-      notifyPromisesResolve();
+      if (!promoted) notifyPromisesResolve();
     }
 
     //-------------------------------------------------------------------------
@@ -5444,6 +5899,23 @@ namespace ortc
         std::this_thread::yield();
       }
 
+      if (mSharedConsumer) {
+        SharedVideoEncoderPtr sharedEncoder;
+        {
+          AutoRecursiveLock lock(*this);
+          sharedEncoder = mSharedEncoder;
+          mSharedEncoder.reset();
+        }
+        mSharedConsumer = false;
+        if (sharedEncoder) {
+          sharedEncoder->detach(getID());
+          sharedEncoder->notifyConsumerStateChanged();
+        }
+
+        notifyPromisesShutdown();
+        return;
+      }
+
       webrtc::VideoSendStream *sendStream;
       {
         AutoRecursiveLock lock(*this);
@@ -5452,8 +5924,11 @@ namespace ortc
       }
 
       if (sendStream) {
-        if (mTransportState == ISecureTransport::State_Connected)
-          sendStream->Stop();
+        {
+          AutoLock lock(mSendStreamStateLock);
+          if (mSendStreamStarted) sendStream->Stop();
+          mSendStreamStarted = false;
+        }
         reinterpret_cast<webrtc::internal::VideoSendStream*>(sendStream)->StopPermanentlyAndGetRtpStates();
       }
 
@@ -5480,10 +5955,652 @@ namespace ortc
         mModuleProcessThread.reset();
         mPacerThread.reset();
       }
+
+      SharedVideoEncoderPtr sharedEncoder;
+      {
+        AutoRecursiveLock lock(*this);
+        sharedEncoder = mSharedEncoder;
+        mSharedEncoder.reset();
+      }
+
+      if (sharedEncoder) {
+        // the send stream is gone so nothing can reach the shared transport
+        // any longer; hand encoding over to one of the remaining consumers
+        auto promoted = sharedEncoder->detach(getID());
+        auto engine = mMediaEngine.lock();
+        if ((promoted) && (engine)) {
+          ZS_LOG_DEBUG(log("promoting shared video encoder consumer") + ZS_PARAM("consumer", promoted->getID()))
+          engine->resetupChannelResource(promoted);
+        }
+      }
       
       notifyPromisesShutdown();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::VideoSenderChannelResource => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::VideoSenderChannelResource::isActive(const Parameters &params)
+    {
+      if (params.mEncodings.size() < 1) return true;
+      return params.mEncodings.front().mActive;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::VideoSenderChannelResource::updateSendStream()
+    {
+      webrtc::VideoSendStream *sendStream {};
+      SharedVideoEncoderPtr sharedEncoder;
+      {
+        AutoRecursiveLock lock(*this);
+        sendStream = mSendStream;
+        sharedEncoder = mSharedEncoder;
+      }
+      if (!sendStream) return;
+
+      // a shared encoder's producer also encodes for its consumers
+      bool send = isSharedSendActive();
+      if ((!send) && (sharedEncoder)) send = sharedEncoder->hasActiveConsumer();
+
+      AutoLock lock(mSendStreamStateLock);
+      if (send == mSendStreamStarted) return;
+      mSendStreamStarted = send;
+
+      if (send) {
+        sendStream->Start();
+      } else {
+        sendStream->Stop();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    String RTPMediaEngine::VideoSenderChannelResource::sharedEncoderKey(
+                                                                        const String &trackID,
+                                                                        const Parameters &params,
+                                                                        const webrtc::VideoSendStream::Config &config,
+                                                                        const webrtc::VideoEncoderConfig &encoderConfig
+                                                                        )
+    {
+      // everything that changes the produced RTP (other than SSRC, sequence
+      // number and timestamp) must be part of the key
+      String result = trackID;
+
+      result += ":" + String(config.encoder_settings.payload_name) + "/" + string(config.encoder_settings.payload_type);
+      result += ":rtx=" + string(config.rtp.rtx.payload_type);
+      result += ":red=" + string(config.rtp.fec.red_payload_type);
+      result += ":ulpfec=" + string(config.rtp.fec.ulpfec_payload_type);
+      result += ":nack=" + string(config.rtp.nack.rtp_history_ms);
+
+      for (auto iter = encoderConfig.streams.begin(); iter != encoderConfig.streams.end(); ++iter) {
+        auto &stream = (*iter);
+        result += ":" + string(stream.width) + "x" + string(stream.height) + "@" + string(stream.max_framerate) + "/" + string(stream.max_bitrate_bps) + "/" + string(stream.temporal_layer_thresholds_bps.size());
+      }
+
+      for (auto iter = config.rtp.extensions.begin(); iter != config.rtp.extensions.end(); ++iter) {
+        auto &extension = (*iter);
+        result += ":" + String(extension.uri) + "=" + string(extension.id);
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::VideoSenderChannelResource::provideSharedStats(
+                                                                        PromiseWithStatsReportPtr promise,
+                                                                        const IStatsReportTypes::StatsTypeSet &stats
+                                                                        )
+    {
+      auto track = mTrack.lock();
+
+      SharedVideoEncoderPtr sharedEncoder;
+      String codecPayloadName;
+      BYTE codecPayloadType {};
+      {
+        AutoRecursiveLock lock(*this);
+        sharedEncoder = mSharedEncoder;
+        codecPayloadName = mCodecPayloadName;
+        codecPayloadType = mCodecPayloadType;
+      }
+
+      SharedVideoEncoder::LayerList layers;
+      if ((!track) ||
+          (!sharedEncoder) ||
+          (!sharedEncoder->getConsumerLayers(getID(), layers))) {
+        notifyPromisesReject();
+        return;
+      }
+
+      UseStatsReport::StatMap reportStats;
+
+      if (stats.hasStatType(IStatsReportTypes::StatsTypes::StatsType_OutboundRTP)) {
+        for (auto iter = layers.begin(); iter != layers.end(); ++iter) {
+          auto &layer = (*iter);
+
+          auto report = make_shared<IStatsReport::OutboundRTPStreamStats>();
+
+          report->mID = string(layer.mSSRC) + "_send";
+
+          report->mSSRC = layer.mSSRC;
+          report->mIsRemote = false;
+          report->mMediaType = "video";
+          report->mMediaTrackID = track->id();
+          report->mCodecID = codecPayloadName;
+          report->mPacketsSent = layer.mPacketsSent;
+          report->mBytesSent = layer.mBytesSent;
+
+          reportStats[report->mID] = report;
+        }
+      }
+
+      if ((stats.hasStatType(IStatsReportTypes::StatsTypes::StatsType_Codec)) &&
+          (layers.size() > 0)) {
+        auto report = make_shared<IStatsReport::Codec>();
+
+        report->mID = string(layers.front().mSSRC) + "_send_codec";
+
+        report->mPayloadType = codecPayloadType;
+        report->mCodec = codecPayloadName;
+        report->mClockRate = 0;
+        report->mChannels = 0;
+
+        reportStats[report->mID] = report;
+      }
+
+      promise->resolve(UseStatsReport::create(reportStats));
+    }
+
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::SharedVideoEncoder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::SharedVideoEncoder::SharedVideoEncoder(
+                                                           const make_private &,
+                                                           const String &key,
+                                                           int redPayloadType,
+                                                           int ulpfecPayloadType,
+                                                           Milliseconds minKeyFrameInterval,
+                                                           DWORD frameTimestampStep
+                                                           ) :
+      mKey(key),
+      mREDPayloadType(redPayloadType),
+      mULPFECPayloadType(ulpfecPayloadType),
+      mMinKeyFrameInterval(minKeyFrameInterval),
+      mFrameTimestampStep(frameTimestampStep)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::SharedVideoEncoder::~SharedVideoEncoder()
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::SharedVideoEncoderPtr RTPMediaEngine::SharedVideoEncoder::create(
+                                                                                     const String &key,
+                                                                                     int redPayloadType,
+                                                                                     int ulpfecPayloadType,
+                                                                                     Milliseconds minKeyFrameInterval,
+                                                                                     ULONG clockRate,
+                                                                                     int maxFramerate
+                                                                                     )
+    {
+      return make_shared<SharedVideoEncoder>(make_private{}, key, redPayloadType, ulpfecPayloadType, minKeyFrameInterval, frameTimestampStep(clockRate, maxFramerate));
+    }
+
+    //-------------------------------------------------------------------------
+    DWORD RTPMediaEngine::SharedVideoEncoder::frameTimestampStep(
+                                                                 ULONG clockRate,
+                                                                 int maxFramerate
+                                                                 )
+    {
+      if (0 == clockRate) clockRate = 90000;   // RFC 3551 video clock
+      if (maxFramerate < 1) maxFramerate = 30;
+      DWORD step = static_cast<DWORD>(clockRate / static_cast<ULONG>(maxFramerate));
+      return (0 == step ? 1 : step);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::SharedVideoEncoder::rewrite(
+                                                     Layer &ioLayer,
+                                                     WORD sequenceNumber,
+                                                     DWORD timestamp,
+                                                     DWORD frameTimestampStep,
+                                                     WORD &outSequenceNumber,
+                                                     DWORD &outTimestamp
+                                                     )
+    {
+      if (ioLayer.mResync) {
+        // continue one packet and one frame interval after the last packet
+        // this layer sent (or after its random starting point)
+        ioLayer.mSequenceNumberDelta = static_cast<WORD>(ioLayer.mLastSequenceNumber + 1 - sequenceNumber);
+        ioLayer.mTimestampDelta = ioLayer.mLastTimestamp + frameTimestampStep - timestamp;
+        ioLayer.mResync = false;
+      }
+
+      outSequenceNumber = static_cast<WORD>(sequenceNumber + ioLayer.mSequenceNumberDelta);
+      outTimestamp = timestamp + ioLayer.mTimestampDelta;
+
+      if (static_cast<short>(outSequenceNumber - ioLayer.mLastSequenceNumber) > 0) {
+        ioLayer.mLastSequenceNumber = outSequenceNumber;
+        ioLayer.mLastTimestamp = outTimestamp;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::SharedVideoEncoder => (for VideoSenderChannelResource)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::attach(
+                                                    VideoSenderChannelResourcePtr resource,
+                                                    TransportPtr transport,
+                                                    const SSRCList &ssrcs
+                                                    )
+    {
+      AutoLock lock(mLock);
+
+      if ((0 == mProducerID) ||
+          (!mProducer.lock())) {
+        mProducerID = resource->getID();
+        mProducer = resource;
+        mProducerTransport = transport;
+        mProducerSSRCs = ssrcs;
+        mLastKeyFrameRequests.assign(ssrcs.size(), Time());
+        return true;
+      }
+
+      auto consumer = make_shared<Consumer>();
+      consumer->mID = resource->getID();
+      consumer->mResource = resource;
+      consumer->mTransport = transport;
+
+      for (auto iter = ssrcs.begin(); iter != ssrcs.end(); ++iter) {
+        Layer layer;
+        layer.mSSRC = (*iter);
+        // the first packet is rewritten to follow these random starting points
+        layer.mLastSequenceNumber = static_cast<WORD>(ortc::services::IHelper::random(0, 0xFFFF));
+        layer.mLastTimestamp = static_cast<DWORD>(ortc::services::IHelper::random(0, 0xFFFFFFFF));
+        consumer->mLayers.push_back(layer);
+      }
+
+      mConsumers[consumer->mID] = consumer;
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::VideoSenderChannelResourcePtr RTPMediaEngine::SharedVideoEncoder::detach(PUID resourceID)
+    {
+      AutoLock lock(mLock);
+
+      if (resourceID != mProducerID) {
+        mConsumers.erase(resourceID);
+        return VideoSenderChannelResourcePtr();
+      }
+
+      mProducerID = 0;
+      mProducer.reset();
+      mProducerTransport.reset();
+      mProducerSSRCs.clear();
+      mLastKeyFrameRequests.clear();
+
+      while (mConsumers.size() > 0) {
+        auto consumer = (*(mConsumers.begin())).second;
+        mConsumers.erase(mConsumers.begin());
+
+        auto resource = consumer->mResource.lock();
+        if (!resource) continue;
+
+        mProducerID = consumer->mID;
+        mProducer = resource;
+        mProducerTransport = consumer->mTransport;
+        for (auto iter = consumer->mLayers.begin(); iter != consumer->mLayers.end(); ++iter) {
+          mProducerSSRCs.push_back((*iter).mSSRC);
+        }
+        mLastKeyFrameRequests.assign(mProducerSSRCs.size(), Time());
+
+        // the new producer numbers its packets differently; continue each
+        // remaining consumer's sequence from where it left off
+        for (auto iterConsumer = mConsumers.begin(); iterConsumer != mConsumers.end(); ++iterConsumer) {
+          auto &layers = (*iterConsumer).second->mLayers;
+          for (auto iterLayer = layers.begin(); iterLayer != layers.end(); ++iterLayer) {
+            (*iterLayer).mResync = true;
+          }
+        }
+        return resource;
+      }
+
+      return VideoSenderChannelResourcePtr();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::SharedVideoEncoder::requestKeyFrame(
+                                                             PUID consumerID,
+                                                             uint32_t mediaSSRC,
+                                                             uint32_t senderSSRC
+                                                             )
+    {
+      VideoSenderChannelResourcePtr producer;
+      uint32_t producerSSRC {};
+
+      {
+        AutoLock lock(mLock);
+
+        ++mKeyFrameRequests;
+
+        auto found = mConsumers.find(consumerID);
+        if (found == mConsumers.end()) return;
+
+        auto &layers = (*found).second->mLayers;
+
+        size_t index = 0;
+        for (; index < layers.size(); ++index) {
+          if (layers[index].mSSRC == mediaSSRC) break;
+        }
+        if (index >= layers.size()) index = 0;
+        if (index >= mProducerSSRCs.size()) return;
+
+        auto now = zsLib::now();
+        if (mLastKeyFrameRequests[index] + mMinKeyFrameInterval > now) return;  // a recent request already covers this one
+
+        mLastKeyFrameRequests[index] = now;
+        ++mKeyFrameRequestsForwarded;
+
+        producer = mProducer.lock();
+        producerSSRC = mProducerSSRCs[index];
+      }
+
+      if (!producer) return;
+
+      // RFC 4585 picture loss indication aimed at the producer's layer
+      BYTE pli[12] {};
+      pli[0] = 0x81;
+      pli[1] = 206;
+      RTPUtils::setBE16(&(pli[2]), 2);
+      RTPUtils::setBE32(&(pli[4]), senderSSRC);
+      RTPUtils::setBE32(&(pli[8]), producerSSRC);
+
+      producer->deliverSharedRTCP(pli, sizeof(pli));
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::SharedVideoEncoder::requestKeyFrames(PUID consumerID)
+    {
+      LayerList layers;
+      if (!getConsumerLayers(consumerID, layers)) return;
+
+      for (auto iter = layers.begin(); iter != layers.end(); ++iter) {
+        requestKeyFrame(consumerID, (*iter).mSSRC, 0);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::getConsumerLayers(
+                                                               PUID consumerID,
+                                                               LayerList &outLayers
+                                                               ) const
+    {
+      AutoLock lock(mLock);
+
+      auto found = mConsumers.find(consumerID);
+      if (found == mConsumers.end()) return false;
+
+      outLayers = (*found).second->mLayers;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::hasActiveConsumer() const
+    {
+      ConsumerList consumers;
+      {
+        AutoLock lock(mLock);
+        for (auto iter = mConsumers.begin(); iter != mConsumers.end(); ++iter) {
+          consumers.push_back((*iter).second);
+        }
+      }
+
+      for (auto iter = consumers.begin(); iter != consumers.end(); ++iter) {
+        auto resource = (*iter)->mResource.lock();
+        if (!resource) continue;
+        if (resource->isSharedSendActive()) return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::SharedVideoEncoder::notifyConsumerStateChanged()
+    {
+      VideoSenderChannelResourcePtr producer;
+      {
+        AutoLock lock(mLock);
+        producer = mProducer.lock();
+      }
+      if (!producer) return;
+
+      producer->notifySharedSendStateChanged();
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPMediaEngine::SharedVideoEncoder::toDebug() const
+    {
+      AutoLock lock(mLock);
+
+      ElementPtr resultEl = Element::create("ortc::RTPMediaEngine::SharedVideoEncoder");
+
+      IHelper::debugAppend(resultEl, "key", mKey);
+      IHelper::debugAppend(resultEl, "red payload type", mREDPayloadType);
+      IHelper::debugAppend(resultEl, "ulpfec payload type", mULPFECPayloadType);
+      IHelper::debugAppend(resultEl, "min key frame interval", mMinKeyFrameInterval);
+      IHelper::debugAppend(resultEl, "frame timestamp step", mFrameTimestampStep);
+
+      IHelper::debugAppend(resultEl, "producer", mProducerID);
+      IHelper::debugAppend(resultEl, "producer ssrcs", mProducerSSRCs.size());
+      IHelper::debugAppend(resultEl, "consumers", mConsumers.size());
+
+      IHelper::debugAppend(resultEl, "packets fanned out", mPacketsFannedOut);
+      IHelper::debugAppend(resultEl, "key frame requests", mKeyFrameRequests);
+      IHelper::debugAppend(resultEl, "key frame requests forwarded", mKeyFrameRequestsForwarded);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::SharedVideoEncoder => webrtc::Transport
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::SendRtp(
+                                                     const uint8_t* packet,
+                                                     size_t length,
+                                                     const webrtc::PacketOptions& options
+                                                     )
+    {
+      struct Send
+      {
+        ConsumerPtr mConsumer;
+        TransportPtr mTransport;
+        size_t mLayerIndex {};
+        WORD mSequenceNumber {};
+        DWORD mTimestamp {};
+        uint32_t mSSRC {};
+      };
+      typedef std::list<Send> SendList;
+
+      // NOTE: called on the producer's pacer thread; only the consumer list
+      //       is copied under mLock, the fan out happens without it
+      VideoSenderChannelResourcePtr producer;
+      TransportPtr producerTransport;
+      ConsumerList consumers;
+      size_t index = 0;
+      bool fanOut = false;
+
+      {
+        AutoLock lock(mLock);
+
+        producer = mProducer.lock();
+        producerTransport = mProducerTransport;
+        if (!producerTransport) return false;
+
+        if ((mConsumers.size() > 0) &&
+            (length >= 12)) {
+          // retransmissions on an RTX SSRC and FEC are only meaningful to
+          // the producer's own remote party (their payload refers to the
+          // producer's sequence numbers and timestamps)
+          auto ssrc = RTPUtils::getBE32(&(packet[8]));
+          for (; index < mProducerSSRCs.size(); ++index) {
+            if (mProducerSSRCs[index] == ssrc) break;
+          }
+          fanOut = (index < mProducerSSRCs.size()) && (!isFECPacket(packet, length));
+
+          if (fanOut) {
+            for (auto iter = mConsumers.begin(); iter != mConsumers.end(); ++iter) {
+              consumers.push_back((*iter).second);
+            }
+          }
+        }
+      }
+
+      // the stream may be running only for the consumers' sake
+      bool result = false;
+      if ((producer) && (producer->isSharedSendActive())) {
+        result = producerTransport->SendRtp(packet, length, options);
+      }
+
+      if (!fanOut) return result;
+
+      WORD sequenceNumber = RTPUtils::getBE16(&(packet[2]));
+      DWORD timestamp = RTPUtils::getBE32(&(packet[4]));
+
+      SendList sends;
+
+      for (auto iter = consumers.begin(); iter != consumers.end(); ++iter) {
+        auto &consumer = (*iter);
+        if (index >= consumer->mLayers.size()) continue;
+
+        auto resource = consumer->mResource.lock();
+        if (!resource) continue;
+        if (!resource->isSharedSendActive()) continue;
+
+        Send send;
+        send.mConsumer = consumer;
+        send.mTransport = consumer->mTransport;
+        send.mLayerIndex = index;
+        sends.push_back(send);
+      }
+
+      if (sends.size() < 1) return result;
+
+      {
+        AutoLock lock(mLock);
+        for (auto iter = sends.begin(); iter != sends.end(); ++iter) {
+          auto &send = (*iter);
+          auto &layer = send.mConsumer->mLayers[send.mLayerIndex];
+          rewrite(layer, sequenceNumber, timestamp, mFrameTimestampStep, send.mSequenceNumber, send.mTimestamp);
+          send.mSSRC = layer.mSSRC;
+        }
+      }
+
+      size_t packetsSent = 0;
+
+      {
+        AutoLock lock(mSendLock);
+
+        if (mScratch.SizeInBytes() < length) mScratch.CleanNew(length);
+        memcpy(mScratch.BytePtr(), packet, length);
+
+        BYTE *rewritten = mScratch.BytePtr();
+
+        for (auto iter = sends.begin(); iter != sends.end(); ++iter) {
+          auto &send = (*iter);
+
+          RTPUtils::setBE16(&(rewritten[2]), send.mSequenceNumber);
+          RTPUtils::setBE32(&(rewritten[4]), send.mTimestamp);
+          RTPUtils::setBE32(&(rewritten[8]), send.mSSRC);
+
+          if (!send.mTransport->SendRtp(rewritten, length, options)) {
+            send.mConsumer.reset();
+            continue;
+          }
+          ++packetsSent;
+        }
+      }
+
+      if (packetsSent < 1) return result;
+
+      {
+        AutoLock lock(mLock);
+        for (auto iter = sends.begin(); iter != sends.end(); ++iter) {
+          auto &send = (*iter);
+          if (!send.mConsumer) continue;
+
+          auto &layer = send.mConsumer->mLayers[send.mLayerIndex];
+          ++layer.mPacketsSent;
+          layer.mBytesSent += length;
+        }
+        mPacketsFannedOut += packetsSent;
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::SendRtcp(const uint8_t* packet, size_t length)
+    {
+      TransportPtr transport;
+      {
+        AutoLock lock(mLock);
+        transport = mProducerTransport;
+      }
+      if (!transport) return false;
+
+      // sender reports describe the producer's stream only
+      return transport->SendRtcp(packet, length);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::SharedVideoEncoder => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::SharedVideoEncoder::isFECPacket(const uint8_t *packet, size_t length) const
+    {
+      if ((mREDPayloadType < 0) && (mULPFECPayloadType < 0)) return false;
+
+      int payloadType = (packet[1] & 0x7F);
+      if (payloadType == mULPFECPayloadType) return true;
+      if (payloadType != mREDPayloadType) return false;
+
+      size_t headerLength = RTPUtils::getRtpHeaderLen(packet, length);
+      if ((0 == headerLength) || (headerLength >= length)) return false;
+
+      // the first RED block header names the encapsulated payload type
+      return ((packet[headerLength] & 0x7F) == mULPFECPayloadType);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -698,6 +698,7 @@ namespace ortc
     {
       RTPPacketPtr pThis(make_shared<RTPPacket>(make_private{}));
       pThis->generate(packet);
+      pThis->mIngressTime = packet.mIngressTime;
       return pThis;
     }
 
@@ -717,6 +718,27 @@ namespace ortc
       return RTPPacket::create(UseServicesHelper::convertToBuffer(buffer, bufferLengthInBytes));
     }
 
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacket::create(
+                                   const BYTE *buffer,
+                                   size_t bufferLengthInBytes,
+                                   size_t headroomInBytes
+                                   )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!buffer)
+      ORTC_THROW_INVALID_PARAMETERS_IF(0 == bufferLengthInBytes)
+
+      RTPPacketPtr pThis(make_shared<RTPPacket>(make_private{}));
+      pThis->mBuffer = make_shared<SecureByteBlock>(headroomInBytes + bufferLengthInBytes);
+      pThis->mHeadroom = headroomInBytes;
+      memcpy(pThis->mBuffer->BytePtr() + headroomInBytes, buffer, bufferLengthInBytes);
+      if (!pThis->parse()) {
+        ZS_LOG_WARNING(Debug, pThis->log("packet could not be parsed"))
+        return RTPPacketPtr();
+      }
+      return pThis;
+    }
+
     //-------------------------------------------------------------------------
     RTPPacketPtr RTPPacket::create(const SecureByteBlock &buffer)
     {
@@ -738,19 +760,20 @@ namespace ortc
     //-------------------------------------------------------------------------
     const BYTE *RTPPacket::ptr() const
     {
-      return mBuffer->BytePtr();
+      return mBuffer->BytePtr() + mHeadroom;
     }
 
     //-------------------------------------------------------------------------
     size_t RTPPacket::size() const
     {
-      return mBuffer->SizeInBytes();
+      return mBuffer->SizeInBytes() - mHeadroom;
     }
 
     //-------------------------------------------------------------------------
     SecureByteBlockPtr RTPPacket::buffer() const
     {
-      return mBuffer;
+      if (0 == mHeadroom) return mBuffer;
+      return UseServicesHelper::convertToBuffer(ptr(), size());
     }
 
     //-------------------------------------------------------------------------
@@ -781,6 +804,7 @@ namespace ortc
       ElementPtr objectEl = Element::create("ortc::RTPPacket");
 
       UseServicesHelper::debugAppend(objectEl, "buffer", mBuffer ? mBuffer->SizeInBytes() : 0);
+      UseServicesHelper::debugAppend(objectEl, "headroom", mHeadroom);
 
       UseServicesHelper::debugAppend(objectEl, "version", mVersion);
       UseServicesHelper::debugAppend(objectEl, "padding", mPadding);
@@ -870,7 +894,7 @@ namespace ortc
       if (!requiresExtension) {
         // going to strip the extension header out entirely
 
-        if (RTP_HEADER_EXTENSION(buffer)) {
+        if (!RTP_HEADER_EXTENSION(buffer)) {
           ZS_LOG_INSANE(log("no extension present (thus no need to strip extension from RTP packet)"))
           return;
         }
@@ -893,6 +917,7 @@ namespace ortc
         newBuffer[0] = newBuffer[0] & (0xFF ^ RTP_HEADER_EXTENSION_BIT);
 
         mBuffer = tempBuffer;
+        mHeadroom = 0;
 
         mHeaderExtensionSize = 0;
 
@@ -919,6 +944,7 @@ namespace ortc
       SecureByteBlockPtr oldBuffer = mBuffer; // temporary to keep previous allocation alive during swap
 
       mBuffer = make_shared<SecureByteBlock>(newSize);
+      mHeadroom = 0;
 
       BYTE *newBuffer = mBuffer->BytePtr();
 
@@ -933,6 +959,116 @@ namespace ortc
       ZS_LOG_INSANE(debug("header extension changed"))
     }
 
+    //-------------------------------------------------------------------------
+    void RTPPacket::setHeaderExtension(const HeaderExtension &extension)
+    {
+      typedef std::vector<HeaderExtension> HeaderExtensionList;
+
+      ORTC_THROW_INVALID_PARAMETERS_IF(0 == extension.mID)
+      ORTC_THROW_INVALID_PARAMETERS_IF((0 != extension.mDataSizeInBytes) && (NULL == extension.mData))
+
+      const BYTE *buffer = ptr();
+
+      bool hasExtension = RTP_HEADER_EXTENSION(buffer);
+      bool twoByteHeader = (hasExtension) && (!((0xBE == buffer[mHeaderSize]) && (0xDE == buffer[mHeaderSize+1])));
+      bool fitsOneByteHeader = (extension.mID < 0xF) &&
+                               (0 != extension.mDataSizeInBytes) &&
+                               (extension.mDataSizeInBytes <= 0x10);
+
+      if (!hasExtension) twoByteHeader = !fitsOneByteHeader;
+
+      bool replaceExisting = false;
+
+      for (HeaderExtension *current = mHeaderExtensions; NULL != current; current = current->mNext) {
+        if (current->mID != extension.mID) continue;
+
+        if ((current->mDataSizeInBytes == extension.mDataSizeInBytes) &&
+            (0 != extension.mDataSizeInBytes)) {
+          memcpy(const_cast<BYTE *>(current->mData), extension.mData, extension.mDataSizeInBytes);
+          ZS_LOG_INSANE(debug("header extension replaced in place") + ZS_PARAM("id", extension.mID))
+          return;
+        }
+        replaceExisting = true;
+        break;
+      }
+
+      if ((replaceExisting) ||
+          ((!twoByteHeader) && (!fitsOneByteHeader))) {
+        // existing block layout cannot be extended in place
+        HeaderExtensionList extensions;
+        extensions.reserve(mTotalHeaderExtensions + 1);
+
+        extensions.push_back(extension);
+        extensions.back().mPostPaddingSize = 0;
+        for (HeaderExtension *current = mHeaderExtensions; NULL != current; current = current->mNext) {
+          if (current->mID == extension.mID) continue;
+          extensions.push_back(*current);
+        }
+        for (size_t index = 0; index < extensions.size(); ++index) {
+          extensions[index].mNext = (index + 1 < extensions.size() ? &(extensions[index + 1]) : NULL);
+        }
+
+        ZS_LOG_TRACE(log("header extension requires rewriting extension block") + ZS_PARAM("id", extension.mID))
+        changeHeaderExtensions(&(extensions[0]));
+        return;
+      }
+
+      // https://tools.ietf.org/html/rfc5285#section-4
+      size_t elementSize = (twoByteHeader ? sizeof(WORD) : sizeof(BYTE)) + extension.mDataSizeInBytes;
+      size_t elementGrowth = ((elementSize + (sizeof(DWORD) - 1)) / sizeof(DWORD)) * sizeof(DWORD);
+      size_t growth = elementGrowth + (hasExtension ? 0 : sizeof(DWORD));
+
+      reserveHeadroom(growth);
+
+      BYTE *oldStart = mBuffer->BytePtr() + mHeadroom;
+      BYTE *newStart = oldStart - growth;
+
+      // only the fixed header (and existing profile header) needs to move
+      memmove(newStart, oldStart, mHeaderSize + (hasExtension ? sizeof(DWORD) : 0));
+      mHeadroom -= growth;
+
+      BYTE *profilePos = &(newStart[mHeaderSize]);
+
+      if (!hasExtension) {
+        newStart[0] = newStart[0] | RTP_HEADER_EXTENSION_BIT;
+        if (twoByteHeader) {
+          profilePos[0] = 0x10;
+          profilePos[1] = 0x00;
+        } else {
+          profilePos[0] = 0xBE;
+          profilePos[1] = 0xDE;
+        }
+        RTPUtils::setBE16(&(profilePos[2]), 0);
+      }
+
+      WORD totalDWORDsLength = static_cast<WORD>(RTPUtils::getBE16(&(profilePos[2])) + (elementGrowth / sizeof(DWORD)));
+      RTPUtils::setBE16(&(profilePos[2]), totalDWORDsLength);
+
+      BYTE *pos = &(profilePos[sizeof(DWORD)]);
+      if (twoByteHeader) {
+        pos[0] = extension.mID;
+        pos[1] = static_cast<BYTE>(extension.mDataSizeInBytes);
+      } else {
+        pos[0] = ((extension.mID) << 4) | ((extension.mDataSizeInBytes - 1) & 0xF);
+      }
+      pos += (elementSize - extension.mDataSizeInBytes);
+
+      if (0 != extension.mDataSizeInBytes) {
+        memcpy(pos, extension.mData, extension.mDataSizeInBytes);
+        pos += extension.mDataSizeInBytes;
+      }
+      if (elementGrowth > elementSize) {
+        memset(pos, 0, elementGrowth - elementSize);  // padding bytes
+      }
+
+      if (!parse()) {
+        ZS_LOG_ERROR(Debug, log("packet could not be parsed after inserting header extension") + ZS_PARAM("id", extension.mID))
+        return;
+      }
+
+      ZS_LOG_INSANE(debug("header extension inserted in place") + ZS_PARAM("id", extension.mID))
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -964,8 +1100,21 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPPacket::parse()
     {
-      const BYTE *buffer = mBuffer->BytePtr();
-      size_t size = mBuffer->SizeInBytes();
+      const BYTE *buffer = ptr();
+      size_t size = mBuffer->SizeInBytes() - mHeadroom;
+
+      // packet may be parsed again after an in-place change
+      mPadding = 0;
+      mHeaderExtensionSize = 0;
+      mTotalHeaderExtensions = 0;
+      if (mHeaderExtensions) {
+        delete [] mHeaderExtensions;
+        mHeaderExtensions = NULL;
+      }
+      mHeaderExtensionAppBits = 0;
+      mHeaderExtensionPrepaddedSize = 0;
+      mHeaderExtensionParseStoppedPos = NULL;
+      mHeaderExtensionParseStoppedSize = 0;
 
       if (size < kMinRtpPacketLen) {
         ZS_LOG_WARNING(Trace, log("packet length is too short") + ZS_PARAM("length", size))
@@ -1179,6 +1328,23 @@ namespace ortc
       return true;
     }
     
+    //-------------------------------------------------------------------------
+    void RTPPacket::reserveHeadroom(size_t headroomInBytes)
+    {
+      if (mHeadroom >= headroomInBytes) return;
+
+      size_t newHeadroom = headroomInBytes + kDefaultHeaderExtensionHeadroom;
+      size_t packetSize = size();
+
+      ZS_LOG_TRACE(log("reallocating packet to reserve headroom") + ZS_PARAM("headroom", mHeadroom) + ZS_PARAM("required", headroomInBytes))
+
+      SecureByteBlockPtr oldBuffer = mBuffer; // temporary to keep previous allocation alive during swap
+
+      mBuffer = make_shared<SecureByteBlock>(newHeadroom + packetSize);
+      memcpy(mBuffer->BytePtr() + newHeadroom, oldBuffer->BytePtr() + mHeadroom, packetSize);
+      mHeadroom = newHeadroom;
+    }
+
     //-------------------------------------------------------------------------
     void RTPPacket::writeHeaderExtensions(
                                           HeaderExtension *firstExtension,
@@ -1196,7 +1362,7 @@ namespace ortc
       ASSERT(0 != mHeaderExtensionSize)
 
 
-      BYTE *newBuffer = mBuffer->BytePtr();
+      BYTE *newBuffer = mBuffer->BytePtr() + mHeadroom;
 
       // set the extension bit
       newBuffer[0] = newBuffer[0] | RTP_HEADER_EXTENSION_BIT;
@@ -1357,6 +1523,7 @@ namespace ortc
       size_t newSize = mHeaderSize + mHeaderExtensionSize + postHeaderExtensionSize;
 
       mBuffer = make_shared<SecureByteBlock>(newSize);
+      mHeadroom = 0;
 
       BYTE *newBuffer = mBuffer->BytePtr();
 
@@ -30,9 +30,11 @@
  */
 
 #include <ortc/internal/ortc_RTPReceiver.h>
+#include <ortc/internal/ortc_ActiveSpeakerDetector.h>
 #include <ortc/internal/ortc_RTPReceiverChannel.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
+#include <ortc/internal/ortc_RTPRelay.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
 #include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_RTPPacket.h>
@@ -42,6 +44,7 @@
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -207,6 +210,36 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPReceiverForRTPRelay::toDebug(ForRTPRelayPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForActiveSpeakerDetector
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPReceiverForActiveSpeakerDetector::toDebug(ForActiveSpeakerDetectorPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -521,6 +554,8 @@ namespace ortc
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mKind(kind),
       mChannels(make_shared<ChannelWeakMap>()),
+      mRelays(make_shared<RelayWeakMap>()),
+      mActiveSpeakerDetectors(make_shared<ActiveSpeakerDetectorWeakMap>()),
       mMaxBufferedRTPPackets(SafeInt<decltype(mMaxBufferedRTPPackets)>(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_IN_BUFFER))),
       mMaxRTPPacketAge(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_AGE_RTP_PACKETS_IN_SECONDS)),
       mLockAfterSwitchTime(ISettings::getUInt(ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS)),
@@ -563,7 +598,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiver::init()
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (mSSRCTableExpires < Seconds(1)) {
         mSSRCTableExpires = Seconds(1);
@@ -617,6 +652,18 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPReceiverPtr RTPReceiver::convert(ForRTPRelayPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPReceiverPtr RTPReceiver::convert(ForActiveSpeakerDetectorPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -629,7 +676,13 @@ namespace ortc
     //-------------------------------------------------------------------------
     IStatsProvider::PromiseWithStatsReportPtr RTPReceiver::getStats(const StatsTypeSet &stats) const
     {
-      if (!stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP)) {
+      StatsTypeSet channelStats;
+      bool includePipeline = RTPStreamCounters::excludeStatsType(stats, IStatsReportTypes::StatsType_PacketPipeline, channelStats);
+      bool includeChannels = stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP);
+      if (!includePipeline) channelStats = stats;
+
+      if ((!includePipeline) &&
+          (!includeChannels)) {
         return PromiseWithStatsReport::createRejected(IORTCForInternal::queueDelegate());
       }
 
@@ -638,22 +691,83 @@ namespace ortc
       UseStatsReport::PromiseWithStatsReportList promises;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+        channels = mChannels; // obtain pointer to COW list while inside a lock
+      }
+
+      if (includePipeline) {
+        // the pipeline latency is process wide (every receiver reports the
+        // same stats ID so collected reports contain it only once)
+        UseStatsReport::StatMap pipelineStats;
+        auto pipeline = PacketPipelineLatency::createStats();
+        pipelineStats[pipeline->mID] = pipeline;
+
+        auto pipelinePromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+        pipelinePromise->resolve(UseStatsReport::create(pipelineStats));
+        promises.push_back(pipelinePromise);
+      }
+
+      if (includeChannels) {
+        for (auto iter = channels->begin(); iter != channels->end(); ++iter)
+        {
+          auto channel = (*iter).second.lock();
+          if (!channel) continue;
+
+          auto channelPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+          channel->requestStats(channelPromise, channelStats);
+          promises.push_back(channelPromise);
+        }
+      }
+
+      return UseStatsReport::collectReports(promises);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver => IStatsProviderForStatsSubscription
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::sampleStats(
+                                  const StatsTypeSet &stats,
+                                  StatsList &outStats
+                                  ) const
+    {
+#ifdef WINRT
+      // the end-to-end delay is only measured by the media engine (which
+      // cannot be sampled synchronously)
+      if (stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP)) return false;
+#endif //WINRT
+
+      // inbound RTP stream and packet pipeline stats are the only stats with
+      // changing counters (codec stats are static and only available through
+      // getStats())
+      if (stats.hasStatType(IStatsReportTypes::StatsType_PacketPipeline)) {
+        outStats.push_back(PacketPipelineLatency::createStats());
+      }
+
+      if (!stats.hasStatType(IStatsReportTypes::StatsType_InboundRTP)) return true;
+
+      ChannelWeakMapPtr channels;
+
+      {
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
       }
 
-      bool result = false;
       for (auto iter = channels->begin(); iter != channels->end(); ++iter)
       {
         auto channel = (*iter).second.lock();
         if (!channel) continue;
 
-        auto channelPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
-        channel->requestStats(channelPromise, stats);
-        promises.push_back(channelPromise);
+        auto report = channel->sampleStats();
+        if (report) outStats.push_back(report);
       }
 
-      return UseStatsReport::collectReports(promises);
+      return true;
     }
 
     //-------------------------------------------------------------------------
@@ -690,7 +804,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to receiver"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       IRTPReceiverSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -718,7 +832,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IRTPTransportPtr RTPReceiver::transport() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!mRTPTransport) return IRTPTransportPtr();
 
       {
@@ -736,7 +850,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     IRTCPTransportPtr RTPReceiver::rtcpTransport() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!mRTCPTransport) return IRTCPTransportPtr();
 
       {
@@ -762,7 +876,7 @@ namespace ortc
     {
       typedef std::set<PUID> PUIDSet;
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       UseListenerPtr listener = UseListener::getListener(transport);
       ORTC_THROW_INVALID_PARAMETERS_IF(!listener)
@@ -1316,7 +1430,7 @@ namespace ortc
 
       auto parameters = make_shared<Parameters>(inParameters);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       Optional<IMediaStreamTrack::Kinds> foundKind;
 
@@ -1567,7 +1681,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("stop called"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -1576,7 +1690,7 @@ namespace ortc
     {
       ContributingSourceList result;
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       for (auto iter = mContributingSources.begin(); iter != mContributingSources.end(); ++iter) {
         auto &source = (*iter).second;
@@ -1612,17 +1726,23 @@ namespace ortc
                     puid, id, mID,
                     enum, viaTransport, zsLib::to_underlying(viaTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
 
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug())
 
       ChannelHolderPtr channelHolder;
+      RelayWeakMapPtr relays;
+      ParametersPtr relayParams;
+      String relayEncodingID;
+      ActiveSpeakerDetectorWeakMapPtr detectors;
+      BYTE audioLevel {};
+      Optional<bool> voiceActivity;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (isShutdown()) {
           ZS_LOG_WARNING(Debug, log("ignoring packet (already shutdown)"))
@@ -1632,6 +1752,16 @@ namespace ortc
         String rid;
         if (findMapping(*packet, channelHolder, rid)) {
           postFindMappingProcessPacket(*packet, channelHolder);
+          if (mRelays->size() > 0) {
+            relays = mRelays; // obtain pointer to COW list while inside a lock
+            relayParams = mParameters;
+            relayEncodingID = getRelayEncodingID(channelHolder);
+          }
+          if (mActiveSpeakerDetectors->size() > 0) {
+            if (extractAudioLevel(*packet, audioLevel, voiceActivity)) {
+              detectors = mActiveSpeakerDetectors; // obtain pointer to COW list while inside a lock
+            }
+          }
           goto process_rtp;
         }
 
@@ -1662,10 +1792,26 @@ namespace ortc
                       puid, channelObjectId, channelHolder->getID(),
                       enum, viaTransport, zsLib::to_underlying(viaTransport),
                       enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                      buffer, packet, packet->buffer()->BytePtr(),
-                      size, size, packet->buffer()->SizeInBytes()
+                      buffer, packet, packet->ptr(),
+                      size, size, packet->size()
                       );
 
+        if (relays) {
+          for (auto iter = relays->begin(); iter != relays->end(); ++iter) {
+            auto relay = (*iter).second.lock();
+            if (!relay) continue;
+            relay->notifyReceivedPacket(relayParams, relayEncodingID, packet);
+          }
+        }
+
+        if (detectors) {
+          for (auto iter = detectors->begin(); iter != detectors->end(); ++iter) {
+            auto detector = (*iter).second.lock();
+            if (!detector) continue;
+            detector->notifyAudioLevel(mID, packet->ssrc(), audioLevel, voiceActivity);
+          }
+        }
+
         return channelHolder->handle(packet);
       }
 
@@ -1683,8 +1829,8 @@ namespace ortc
                     puid, id, mID,
                     enum, viaTransport, zsLib::to_underlying(viaTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug());
@@ -1692,7 +1838,7 @@ namespace ortc
       ChannelWeakMapPtr channels;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
 
         processByes(*packet);
@@ -1715,8 +1861,8 @@ namespace ortc
                       puid, channelObjectId, channelHolder->getID(),
                       enum, viaTransport, zsLib::to_underlying(viaTransport),
                       enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                      buffer, packet, packet->buffer()->BytePtr(),
-                      size, size, packet->buffer()->SizeInBytes()
+                      buffer, packet, packet->ptr(),
+                      size, size, packet->size()
                       );
 
         auto channelResult = channelHolder->handle(packet);
@@ -1724,7 +1870,7 @@ namespace ortc
       }
 
       if (clean) {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         cleanChannels();
       }
 
@@ -1743,9 +1889,11 @@ namespace ortc
     bool RTPReceiver::sendPacket(RTCPPacketPtr packet)
     {
       UseSecureTransportPtr rtcpTransport;
+      bool reducedSize = false;
+      String cname;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (isShutdown()) {
           ZS_LOG_WARNING(Debug, log("cannot send packet while shutdown"))
@@ -1753,6 +1901,10 @@ namespace ortc
         }
 
         rtcpTransport = mRTCPTransport;
+        if (mParameters) {
+          reducedSize = mParameters->mRTCP.mReducedSize;
+          cname = mParameters->mRTCP.mCName;
+        }
       }
 
       if (!rtcpTransport) {
@@ -1760,18 +1912,31 @@ namespace ortc
         return false;
       }
 
-      ZS_LOG_TRACE(log("sending rtcp packet over secure transport") + ZS_PARAM("size", packet->size()));
+      const BYTE *buffer = packet->ptr();
+      size_t size = packet->size();
+
+      SecureByteBlockPtr compound;
+      if (!reducedSize) {
+        // rtcp-rsize was not negotiated thus must be sent as compound
+        compound = RTCPPacket::convertToCompound(buffer, size, cname);
+        if (compound) {
+          buffer = compound->BytePtr();
+          size = compound->SizeInBytes();
+        }
+      }
+
+      ZS_LOG_TRACE(log("sending rtcp packet over secure transport") + ZS_PARAM("size", size));
 
       ZS_EVENTING_5(
                     x, i, Debug, RtpReceiverSendOutgoingPacket, ol, RtpReceiver, Info,
                     puid, id, mID,
                     enum, sendOverTransport, zsLib::to_underlying(mSendRTCPOverTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP), 
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, buffer,
+                    size, size, size
                     );
 
-      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, buffer, size);
     }
 
     //-------------------------------------------------------------------------
@@ -1782,6 +1947,92 @@ namespace ortc
     #pragma mark RTPReceiver => IRTPReceiverForRTPReceiverChannel
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver => IRTPReceiverForRTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::registerRelay(UseRelayPtr relay)
+    {
+      ZS_LOG_DEBUG(log("register relay") + ZS_PARAM("relay", relay->getID()))
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot register relay while shutdown") + ZS_PARAM("relay", relay->getID()))
+        return;
+      }
+
+      RelayWeakMapPtr replacementRelays = make_shared<RelayWeakMap>(*mRelays);
+      (*replacementRelays)[relay->getID()] = relay;
+      mRelays = replacementRelays;  // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::unregisterRelay(PUID relayID)
+    {
+      ZS_LOG_DEBUG(log("unregister relay") + ZS_PARAM("relay", relayID))
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      auto found = mRelays->find(relayID);
+      if (found == mRelays->end()) return;
+
+      RelayWeakMapPtr replacementRelays = make_shared<RelayWeakMap>(*mRelays);
+      replacementRelays->erase(relayID);
+      mRelays = replacementRelays;  // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver => IRTPReceiverForActiveSpeakerDetector
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::registerActiveSpeakerDetector(UseActiveSpeakerDetectorPtr detector)
+    {
+      ZS_LOG_DEBUG(log("register active speaker detector") + ZS_PARAM("detector", detector->getID()))
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      if (IMediaStreamTrackTypes::Kind_Audio != mKind) {
+        ZS_LOG_WARNING(Debug, log("active speaker detection requires an audio receiver") + ZS_PARAM("detector", detector->getID()) + ZS_PARAM("kind", IMediaStreamTrackTypes::toString(mKind)))
+        return false;
+      }
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot register active speaker detector while shutdown") + ZS_PARAM("detector", detector->getID()))
+        return false;
+      }
+
+      ActiveSpeakerDetectorWeakMapPtr replacementDetectors = make_shared<ActiveSpeakerDetectorWeakMap>(*mActiveSpeakerDetectors);
+      (*replacementDetectors)[detector->getID()] = detector;
+      mActiveSpeakerDetectors = replacementDetectors;  // COW replacement
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::unregisterActiveSpeakerDetector(PUID detectorID)
+    {
+      ZS_LOG_DEBUG(log("unregister active speaker detector") + ZS_PARAM("detector", detectorID))
+
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      auto found = mActiveSpeakerDetectors->find(detectorID);
+      if (found == mActiveSpeakerDetectors->end()) return;
+
+      ActiveSpeakerDetectorWeakMapPtr replacementDetectors = make_shared<ActiveSpeakerDetectorWeakMap>(*mActiveSpeakerDetectors);
+      replacementDetectors->erase(detectorID);
+      mActiveSpeakerDetectors = replacementDetectors;  // COW replacement
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1804,7 +2055,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("on secure transport state changed") + ZS_PARAM("secure transport", transport->getID()) + ZS_PARAM("state", ISecureTransportTypes::toString(state)));
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       notifyChannelsOfTransportState();
     }
 
@@ -1824,7 +2075,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1843,7 +2094,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()));
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (timer == mSSRCTableTimer) {
 
@@ -1934,7 +2185,7 @@ namespace ortc
     {
       ZS_EVENTING_1(x, i, Trace, RtpReceiverInternalChannelGoneEvent, ol, RtpReceiver, InternalEvent, puid, id, mID);
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cleanChannels();
     }
 
@@ -1963,7 +2214,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr RTPReceiver::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::RTPReceiver");
 
@@ -1998,6 +2249,8 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "params grouped into channels", mParametersGroupedIntoChannels.size());
 
       UseServicesHelper::debugAppend(resultEl, "channels", mChannels->size());
+      UseServicesHelper::debugAppend(resultEl, "relays", mRelays->size());
+      UseServicesHelper::debugAppend(resultEl, "active speaker detectors", mActiveSpeakerDetectors->size());
       UseServicesHelper::debugAppend(resultEl, "clean channels", mCleanChannels);
 
       UseServicesHelper::debugAppend(resultEl, "channel infos", mChannelInfos.size());
@@ -2093,6 +2346,9 @@ namespace ortc
 
       size_t beforeSize = 0;
 
+      RelayRTPPacketListPtr relayPackets;
+      if (mRelays->size() > 0) relayPackets = make_shared<RelayRTPPacketList>();
+
       do
       {
         beforeSize = mBufferedRTPPackets.size();
@@ -2111,6 +2367,8 @@ namespace ortc
           ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("channel", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
           channelHolder->notify(packet);
 
+          if (relayPackets) relayPackets->push_back(EncodingIDRTPPacketPair(getRelayEncodingID(channelHolder), packet));
+
           mBufferedRTPPackets.erase(current);
         }
 
@@ -2120,6 +2378,8 @@ namespace ortc
       } while ((beforeSize != mBufferedRTPPackets.size()) &&
                (0 != mBufferedRTPPackets.size()));
 
+      postRelayPackets(relayPackets);
+
       return true;
     }
 
@@ -2197,6 +2457,9 @@ namespace ortc
       ChannelWeakMapPtr channels = ChannelWeakMapPtr(make_shared<ChannelWeakMap>());
       mChannels = channels;
 
+      mRelays = make_shared<RelayWeakMap>();
+      mActiveSpeakerDetectors = make_shared<ActiveSpeakerDetectorWeakMap>();
+
       if (mParameters) {
         mListener->unregisterReceiver(*this);
       }
@@ -2877,8 +3140,8 @@ namespace ortc
                     x, i, Trace, RtpReceiverFindMapping, ol, RtpReceiver, Info,
                     puid, id, mID,
                     string, rid, outRID,
-                    buffer, packet, rtpPacket.buffer()->BytePtr(),
-                    size, size, rtpPacket.buffer()->SizeInBytes()
+                    buffer, packet, rtpPacket.ptr(),
+                    size, size, rtpPacket.size()
                     );
 
       {
@@ -3946,6 +4209,29 @@ namespace ortc
       }
     }
     
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::extractAudioLevel(
+                                        const RTPPacket &rtpPacket,
+                                        BYTE &outLevel,
+                                        Optional<bool> &outVoiceActivity
+                                        ) const
+    {
+      for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
+        LocalID localID = static_cast<LocalID>(ext->mID);
+        auto found = mRegisteredExtensions.find(localID);
+        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
+
+        const RegisteredHeaderExtension &headerInfo = (*found).second;
+        if (IRTPTypes::HeaderExtensionURI_ClienttoMixerAudioLevelIndication != headerInfo.mHeaderExtensionURI) continue;
+
+        RTPPacket::ClientToMixerExtension levelExt(*ext);
+        outLevel = levelExt.level();
+        outVoiceActivity = levelExt.voiceActivity();
+        return true;
+      }
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     void RTPReceiver::setContributingSource(
                                             SSRCType csrc,
@@ -4028,6 +4314,43 @@ namespace ortc
       mTrack->notifyActiveReceiverChannel(RTPReceiverChannel::convert(channelHolder->mChannel));
     }
 
+    //-------------------------------------------------------------------------
+    String RTPReceiver::getRelayEncodingID(ChannelHolderPtr channelHolder) const
+    {
+      if (!channelHolder) return String();
+
+      auto &channelInfo = channelHolder->mChannelInfo;
+      if (!channelInfo) return String();
+      if (!channelInfo->mFilledParameters) return String();
+      if (channelInfo->mFilledParameters->mEncodings.size() < 1) return String();
+
+      return channelInfo->mFilledParameters->mEncodings.front().mEncodingID;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::postRelayPackets(RelayRTPPacketListPtr packets)
+    {
+      if (!packets) return;
+      if (packets->size() < 1) return;
+
+      // relays must be notified outside the receiver's lock (the step
+      // is always called from within the lock thus deliver asynchronously)
+      auto relays = mRelays;  // obtain pointer to COW list while inside a lock
+      auto relayParams = mParameters;
+
+      ZS_LOG_TRACE(log("posting buffered RTP packets to relays") + ZS_PARAM("relays", relays->size()) + ZS_PARAM("packets", packets->size()))
+
+      postClosure([relays, relayParams, packets] {
+        for (auto iter = relays->begin(); iter != relays->end(); ++iter) {
+          auto relay = (*iter).second.lock();
+          if (!relay) continue;
+          for (auto iterPacket = packets->begin(); iterPacket != packets->end(); ++iterPacket) {
+            relay->notifyReceivedPacket(relayParams, (*iterPacket).first, (*iterPacket).second);
+          }
+        }
+      });
+    }
+
     //-------------------------------------------------------------------------
     void RTPReceiver::resetActiveReceiverChannel()
     {
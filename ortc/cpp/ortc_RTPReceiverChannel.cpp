@@ -216,6 +216,8 @@ namespace ortc
       ZS_LOG_DETAIL(debug("created"));
 
       ORTC_THROW_INVALID_PARAMETERS_IF(!receiver);
+
+      mCounters.updateParameters(params);
     }
 
     //-------------------------------------------------------------------------
@@ -343,8 +345,10 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiverChannel::notifyPacket(RTPPacketPtr packet)
     {
+      PacketPipelineLatency::markHop(IStatsReportTypes::PacketPipelineHop_RTPListener);
+
       // do NOT lock this object here, instead notify self asynchronously
-      IRTPReceiverChannelAsyncDelegateProxy::create(mThisWeak.lock())->onNotifyPacket(packet);
+      IRTPReceiverChannelAsyncDelegateProxy::create(mThisWeak.lock())->onNotifyPacket(packet, PacketPipelineLatency::now());
     }
 
     //-------------------------------------------------------------------------
@@ -371,10 +375,12 @@ namespace ortc
                     puid, id, mID,
                     puid, mediaBaseId, mMediaBase->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
+      mCounters.notifyReceived(*packet);
+
       return mMediaBase->handlePacket(packet);
     }
 
@@ -386,8 +392,8 @@ namespace ortc
                     puid, id, mID,
                     puid, mediaBaseId, mMediaBase->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
       return mMediaBase->handlePacket(packet);
     }
@@ -395,7 +401,63 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiverChannel::requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats)
     {
-      return mMediaBase->requestStats(promise, stats);
+      StatsTypeSet mediaStats;
+      if (!RTPStreamCounters::excludeStatsType(stats, IStatsReportTypes::StatsType_InboundRTP, mediaStats)) {
+        mMediaBase->requestStats(promise, stats);
+        return;
+      }
+
+      // inbound RTP stream stats come from the channel's own counters (which
+      // never contends with packet processing); only the remaining stats
+      // types need the media engine
+      UseStatsReport::StatMap countersStats;
+
+      auto inboundStats = createInboundRTPStreamStats();
+      if (inboundStats) countersStats[inboundStats->mID] = inboundStats;
+
+#ifdef WINRT
+      // only the media engine can measure the end-to-end delay so its
+      // inbound RTP report is still requested (see mergeStats)
+      mediaStats.insert(IStatsReportTypes::StatsType_InboundRTP);
+#endif //WINRT
+
+      if (mediaStats.size() < 1) {
+        promise->resolve(UseStatsReport::create(countersStats));
+        return;
+      }
+
+      auto mediaPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        PendingStats pending;
+        pending.mResolvePromise = promise;
+        pending.mMediaPromise = mediaPromise;
+        pending.mCountersStats = countersStats;
+
+        mPendingStats[mediaPromise->getID()] = pending;
+      }
+
+      mediaPromise->thenWeak(mThisWeak.lock());
+      mMediaBase->requestStats(mediaPromise, mediaStats);
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::InboundRTPStreamStatsPtr RTPReceiverChannel::sampleStats() const
+    {
+      RTPStreamCounters::Snapshot snapshot;
+      mCounters.snapshot(snapshot);
+
+      if ((0 == snapshot.mPackets) || (0 == snapshot.mSSRC)) return IStatsReportTypes::InboundRTPStreamStatsPtr();
+
+      auto report = make_shared<IStatsReportTypes::InboundRTPStreamStats>();
+
+      report->mID = string(snapshot.mSSRC) + "_recv";
+      report->mIsRemote = true;
+
+      snapshot.applyTo(*report);
+      return report;
     }
 
 
@@ -428,10 +490,12 @@ namespace ortc
                     puid, id, mID,
                     puid, receiverId, receiver->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
+      mCounters.notifyFeedbackSent(*packet);
+
       return receiver->sendPacket(packet);
     }
 
@@ -463,6 +527,7 @@ namespace ortc
     int32_t RTPReceiverChannel::getAudioSamples(
                                                 const size_t numberOfSamples,
                                                 const uint8_t numberOfChannels,
+                                                const uint32_t samplesPerSecond,
                                                 void *audioSamples,
                                                 size_t& numberOfSamplesOut
                                                 )
@@ -473,7 +538,7 @@ namespace ortc
 #define TODO_VERIFY_RETURN_RESULT 2
       if (!mAudio) return 0;
       
-      return mAudio->getAudioSamples(numberOfSamples, numberOfChannels, audioSamples, numberOfSamplesOut);
+      return mAudio->getAudioSamples(numberOfSamples, numberOfChannels, samplesPerSecond, audioSamples, numberOfSamplesOut);
     }
 
     //-------------------------------------------------------------------------
@@ -510,6 +575,39 @@ namespace ortc
       // NOTE: ADD IF NEEDED...
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiverChannel => IPromiseSettledDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPReceiverChannel::onPromiseSettled(PromisePtr promise)
+    {
+      if (!promise) return;
+
+      PendingStats pending;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mPendingStats.find(promise->getID());
+        if (found == mPendingStats.end()) return;
+
+        pending = (*found).second;
+        mPendingStats.erase(found);
+      }
+
+      ZS_LOG_TRACE(log("media stats settled") + ZS_PARAM("promise", promise->getID()) + ZS_PARAM("resolved", pending.mMediaPromise->isResolved()))
+
+      IStatsReportPtr mediaReport;
+      if (pending.mMediaPromise->isResolved()) mediaReport = pending.mMediaPromise->value();
+
+      pending.mResolvePromise->resolve(UseStatsReport::create(mergeStats(mediaReport, pending.mCountersStats)));
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -538,8 +636,13 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    void RTPReceiverChannel::onNotifyPacket(RTPPacketPtr packet)
+    void RTPReceiverChannel::onNotifyPacket(
+                                            RTPPacketPtr packet,
+                                            QWORD queuedAt
+                                            )
     {
+      PacketPipelineLatency::recordSince(IStatsReportTypes::PacketPipelineHop_ReceiverChannelQueue, queuedAt);
+
       ZS_LOG_TRACE(log("notified rtcp packets") + ZS_PARAM("packet", packet->ssrc()))
       handlePacket(packet);
     }
@@ -572,6 +675,8 @@ namespace ortc
         mParameters = params;
         mediaBase = mMediaBase;
 
+        mCounters.updateParameters(*mParameters);
+
         Optional<IMediaStreamTrackTypes::Kinds> kind = RTPTypesHelper::getCodecsKind(*mParameters);
         
         bool found = false;
@@ -701,6 +806,12 @@ namespace ortc
 
       setState(State_Shutdown);
 
+      for (auto iter = mPendingStats.begin(); iter != mPendingStats.end(); ++iter) {
+        auto &pending = (*iter).second;
+        pending.mResolvePromise->resolve(UseStatsReport::create(pending.mCountersStats));
+      }
+      mPendingStats.clear();
+
       // make sure to cleanup any final reference to self
       mGracefulShutdownReference.reset();
     }
@@ -739,6 +850,85 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::InboundRTPStreamStatsPtr RTPReceiverChannel::createInboundRTPStreamStats()
+    {
+      RTPStreamCounters::Snapshot snapshot;
+      mCounters.snapshot(snapshot);
+
+      if ((0 == snapshot.mPackets) || (0 == snapshot.mSSRC)) return IStatsReportTypes::InboundRTPStreamStatsPtr();
+
+      auto report = make_shared<IStatsReportTypes::InboundRTPStreamStats>();
+
+      report->mID = string(snapshot.mSSRC) + "_recv";
+      report->mIsRemote = true;
+      report->mMediaType = (mAudio ? "audio" : "video");
+
+      snapshot.applyTo(*report);
+
+      AutoRecursiveLock lock(*this);
+
+      auto track = MediaStreamTrack::convert(mTrack);
+      if (track) report->mMediaTrackID = IMediaStreamTrackPtr(track)->id();
+
+      if (mParameters) {
+        RTPTypesHelper::FindCodecOptions options;
+        options.mPayloadType = snapshot.mPayloadType;
+        auto codec = RTPTypesHelper::findCodec(*mParameters, options);
+        if (codec) report->mCodecID = codec->mName;
+      }
+
+      return report;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPReceiverChannel::UseStatsReport::StatMap RTPReceiverChannel::mergeStats(
+                                                                               IStatsReportPtr mediaReport,
+                                                                               const UseStatsReport::StatMap &countersStats
+                                                                               )
+    {
+      UseStatsReport::StatMap result;
+
+      bool hasCountersInbound = false;
+      for (auto iter = countersStats.begin(); iter != countersStats.end(); ++iter) {
+        if (!ZS_DYNAMIC_PTR_CAST(IStatsReportTypes::InboundRTPStreamStats, (*iter).second)) continue;
+        hasCountersInbound = true;
+        break;
+      }
+
+      if (mediaReport) {
+        auto ids = mediaReport->getStatesIDs();
+        if (ids) {
+          for (auto iter = ids->begin(); iter != ids->end(); ++iter) {
+            auto &id = (*iter);
+            auto stat = mediaReport->getStats(id);
+            if (!stat) continue;
+
+            auto mediaInbound = ZS_DYNAMIC_PTR_CAST(IStatsReportTypes::InboundRTPStreamStats, stat);
+            if (mediaInbound) {
+#ifdef WINRT
+              auto found = countersStats.find(id);
+              if (found != countersStats.end()) {
+                auto countersInbound = ZS_DYNAMIC_PTR_CAST(IStatsReportTypes::InboundRTPStreamStats, (*found).second);
+                if (countersInbound) countersInbound->mEndToEndDelay = mediaInbound->mEndToEndDelay;
+              }
+#endif //WINRT
+              // the counters are authoritative for the inbound RTP stream
+              if (hasCountersInbound) continue;
+            }
+
+            result[id] = stat;
+          }
+        }
+      }
+
+      for (auto iter = countersStats.begin(); iter != countersStats.end(); ++iter) {
+        result[(*iter).first] = (*iter).second;
+      }
+
+      return result;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -30,6 +30,7 @@
  */
 
 #include <ortc/internal/ortc_RTPReceiverChannelAudio.h>
+#include <ortc/internal/ortc_AudioRingBuffer.h>
 #include <ortc/internal/ortc_RTPReceiverChannel.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
 #include <ortc/internal/ortc_RTPPacket.h>
@@ -51,6 +52,8 @@
 
 #include <webrtc/voice_engine/include/voe_network.h>
 
+#include <cstring>
+
 #ifdef _DEBUG
 #define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
 #else
@@ -77,7 +80,51 @@ namespace ortc
     #pragma mark (helpers)
     #pragma mark
 
+    // external audio is produced in 10ms frames paced by the wall clock but
+    // allow catching up if the timer was late
+    static const size_t kMaxExternalAudioFramesPerTimer {5};
+
+    static const uint32_t kMinExternalAudioSamplesPerSecond {8000};
+    static const uint32_t kMaxExternalAudioSamplesPerSecond {48000};
+    static const uint8_t kMaxExternalAudioChannels {2};
+
+    //-------------------------------------------------------------------------
+    static size_t externalAudioBufferSizeInSamples(const char *setting)
+    {
+      size_t milliseconds = ISettings::getUInt(setting);
+      if (milliseconds < 10) milliseconds = 10;
+      return (kMaxExternalAudioSamplesPerSecond * kMaxExternalAudioChannels * milliseconds) / 1000;
+    }
+
+    //-------------------------------------------------------------------------
+    static void remixExternalAudio(
+                                   const int16_t *source,
+                                   size_t samplesPerChannel,
+                                   size_t sourceChannels,
+                                   int16_t *destination,
+                                   size_t destinationChannels
+                                   )
+    {
+      if (1 == sourceChannels) {
+        // mono -> stereo (duplicate)
+        for (size_t index = 0; index < samplesPerChannel; ++index) {
+          destination[index * 2] = source[index];
+          destination[(index * 2) + 1] = source[index];
+        }
+        return;
+      }
+
+      // stereo -> mono (average)
+      for (size_t index = 0; index < samplesPerChannel; ++index) {
+        int32_t sum = static_cast<int32_t>(source[index * 2]) + static_cast<int32_t>(source[(index * 2) + 1]);
+        destination[index] = static_cast<int16_t>(sum / 2);
+      }
+    }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -113,7 +160,7 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
-        //      UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_CHANNEL_AUDIO_, 0);
+        ISettings::setUInt(ORTC_SETTING_RTP_RECEIVER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS, 100);
       }
       
     };
@@ -197,7 +244,8 @@ namespace ortc
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mReceiverChannel(receiverChannel),
       mTrack(track),
-      mParameters(make_shared<Parameters>(params))
+      mParameters(make_shared<Parameters>(params)),
+      mExternalAudio(make_shared<AudioRingBuffer>(externalAudioBufferSizeInSamples(ORTC_SETTING_RTP_RECEIVER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS)))
     {
       ZS_LOG_DETAIL(debug("created"))
 
@@ -361,12 +409,56 @@ namespace ortc
     int32_t RTPReceiverChannelAudio::getAudioSamples(
                                                      const size_t numberOfSamples,
                                                      const uint8_t numberOfChannels,
+                                                     const uint32_t samplesPerSecond,
                                                      void *audioSamples,
                                                      size_t& numberOfSamplesOut
                                                      )
     {
-#define TODO_IMPLEMENT_THIS 1
-#define TODO_IMPLEMENT_THIS 2
+      // NOTE: called on the application's playout thread; must never block
+
+      numberOfSamplesOut = 0;
+
+      if ((NULL == audioSamples) ||
+          (0 == numberOfSamples)) return 0;
+
+      if ((numberOfChannels < 1) ||
+          (numberOfChannels > kMaxExternalAudioChannels) ||
+          (samplesPerSecond < kMinExternalAudioSamplesPerSecond) ||
+          (samplesPerSecond > kMaxExternalAudioSamplesPerSecond)) {
+        ZS_LOG_WARNING(Trace, log("external audio format is not supported") + ZS_PARAM("channels", static_cast<size_t>(numberOfChannels)) + ZS_PARAM("samples per second", samplesPerSecond))
+        return -1;
+      }
+
+      DWORD format = (static_cast<DWORD>(samplesPerSecond) << 8) | static_cast<DWORD>(numberOfChannels);
+      if (format != mExternalAudioConsumerFormat) {
+        if (0 != mExternalAudioConsumerFormat) {
+          // anything buffered is in the old format
+          mExternalAudio->skip(mExternalAudio->available());
+        }
+        mExternalAudioConsumerFormat = format;
+        mExternalAudioFormat = format;
+      }
+
+      int16_t *output = static_cast<int16_t *>(audioSamples);
+      size_t totalSamples = numberOfSamples * numberOfChannels;
+
+      size_t available = mExternalAudio->available();
+      available -= (available % numberOfChannels);
+
+      size_t read = mExternalAudio->read(output, available < totalSamples ? available : totalSamples);
+      if (read < totalSamples) {
+        memset(&(output[read]), 0, (totalSamples - read) * sizeof(int16_t));
+      }
+
+      numberOfSamplesOut = numberOfSamples;
+
+      if (!mExternalAudioStarted.exchange(true)) {
+        auto pThis = mThisWeak.lock();
+        if (pThis) IWakeDelegateProxy::create(pThis)->onWake();
+        return 0;
+      }
+
+      if (read < totalSamples) mExternalAudioUnderrunSamples += (totalSamples - read);
       return 0;
     }
     
@@ -414,11 +506,24 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiverChannelAudio::onTimer(ITimerPtr timer)
     {
-      ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
+      ZS_LOG_INSANE(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
-      AutoRecursiveLock lock(*this);
-#define TODO 1
-#define TODO 2
+      UseChannelResourcePtr channelResource;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mExternalAudioTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+          return;
+        }
+
+        channelResource = mChannelResource;
+      }
+
+      if (!channelResource) return;
+
+      pumpExternalAudio(channelResource);
     }
 
     //-------------------------------------------------------------------------
@@ -626,6 +731,13 @@ namespace ortc
       auto receiverChannel = mReceiverChannel.lock();
       IHelper::debugAppend(resultEl, "receiver channel", receiverChannel ? receiverChannel->getID() : 0);
 
+      IHelper::debugAppend(resultEl, "external audio", mExternalAudio ? mExternalAudio->toDebug() : ElementPtr());
+      IHelper::debugAppend(resultEl, "external audio format", static_cast<DWORD>(mExternalAudioFormat));
+      IHelper::debugAppend(resultEl, "external audio started", static_cast<bool>(mExternalAudioStarted));
+      IHelper::debugAppend(resultEl, "external audio underrun samples", static_cast<size_t>(mExternalAudioUnderrunSamples));
+      IHelper::debugAppend(resultEl, "external audio dropped samples", static_cast<size_t>(mExternalAudioDroppedSamples));
+      IHelper::debugAppend(resultEl, "external audio timer", mExternalAudioTimer ? mExternalAudioTimer->getID() : 0);
+
       return resultEl;
     }
 
@@ -656,6 +768,7 @@ namespace ortc
       // ... other steps here ...
       if (!stepChannelPromise()) goto not_ready;
       if (!stepSetupChannel()) goto not_ready;
+      if (!stepExternalAudio()) goto not_ready;
       // ... other steps here ...
 
       goto ready;
@@ -737,6 +850,25 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPReceiverChannelAudio::stepExternalAudio()
+    {
+      if (mExternalAudioTimer) {
+        ZS_LOG_TRACE(log("already pumping external audio"))
+        return true;
+      }
+
+      if (!mExternalAudioStarted) {
+        ZS_LOG_TRACE(log("no external audio is being extracted"))
+        return true;
+      }
+
+      mExternalAudioTimer = ITimer::create(mThisWeak.lock(), Milliseconds(10));
+
+      ZS_LOG_DEBUG(log("started pumping external audio") + ZS_PARAM("timer id", mExternalAudioTimer->getID()))
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     void RTPReceiverChannelAudio::cancel()
     {
@@ -750,6 +882,11 @@ namespace ortc
       mQueuedRTP = RTPPacketQueue();
       mQueuedRTCP = RTCPPacketQueue();
 
+      if (mExternalAudioTimer) {
+        mExternalAudioTimer->cancel();
+        mExternalAudioTimer.reset();
+      }
+
       if (!mGracefulShutdownReference) mGracefulShutdownReference = mThisWeak.lock();
 
       if (!mCloseChannelPromise) {
@@ -816,6 +953,58 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    void RTPReceiverChannelAudio::pumpExternalAudio(UseChannelResourcePtr channelResource)
+    {
+      DWORD format = mExternalAudioFormat;
+      if (0 == format) return;
+
+      uint32_t samplesPerSecond = static_cast<uint32_t>(format >> 8);
+      size_t channels = static_cast<size_t>(format & 0xFF);
+
+      size_t maxFrameSamples = (kMaxExternalAudioSamplesPerSecond / 100) * kMaxExternalAudioChannels;
+      if (mExternalAudioFrame.size() < maxFrameSamples) mExternalAudioFrame.resize(maxFrameSamples);
+      if (mExternalAudioRemixed.size() < maxFrameSamples) mExternalAudioRemixed.resize(maxFrameSamples);
+
+      // pace by the clock rather than by timer events so that timer jitter
+      // does not turn into underruns
+      Time now = zsLib::now();
+      if (Time() == mExternalAudioNextFrame) mExternalAudioNextFrame = now;
+
+      for (size_t frames = 0; frames < kMaxExternalAudioFramesPerTimer; ++frames) {
+        if (mExternalAudioNextFrame > now) break;
+        mExternalAudioNextFrame += Milliseconds(10);
+
+        size_t samplesPerChannel {};
+        size_t frameChannels {};
+
+        // the voice engine resamples the decoded audio to the requested rate
+        if (!channelResource->getAudioFrame(samplesPerSecond, &(mExternalAudioFrame[0]), mExternalAudioFrame.size(), samplesPerChannel, frameChannels)) {
+          ZS_LOG_TRACE(log("no external audio frame available"))
+          continue;
+        }
+
+        const int16_t *samples = &(mExternalAudioFrame[0]);
+        if (frameChannels != channels) {
+          if ((frameChannels < 1) ||
+              (frameChannels > kMaxExternalAudioChannels)) continue;
+          remixExternalAudio(samples, samplesPerChannel, frameChannels, &(mExternalAudioRemixed[0]), channels);
+          samples = &(mExternalAudioRemixed[0]);
+        }
+
+        size_t totalSamples = samplesPerChannel * channels;
+        if (0 == mExternalAudio->write(samples, totalSamples)) {
+          // application is not pulling fast enough
+          mExternalAudioDroppedSamples += totalSamples;
+        }
+      }
+
+      if (mExternalAudioNextFrame < now) {
+        ZS_LOG_TRACE(log("external audio fell behind (resynchronizing)"))
+        mExternalAudioNextFrame = now;
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
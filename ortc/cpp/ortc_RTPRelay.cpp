@@ -0,0 +1,1132 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#include <ortc/internal/ortc_RTPRelay.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+#include <ortc/internal/ortc_RTPSender.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/platform.h>
+
+#include <ortc/IHelper.h>
+
+#include <zsLib/eventing/IHasher.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+#include <zsLib/Log.h>
+#include <zsLib/XML.h>
+
+#ifdef _DEBUG
+#define ASSERT(x) ZS_THROW_BAD_STATE_IF(!(x))
+#else
+#define ASSERT(x)
+#endif //_DEBUG
+
+
+namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtpsender) }
+
+namespace ortc
+{
+  ZS_DECLARE_USING_PTR(zsLib, ISettings);
+  ZS_DECLARE_USING_PTR(zsLib::eventing, IHasher);
+
+  namespace internal
+  {
+    ZS_DECLARE_CLASS_PTR(RTPRelaySettingsDefaults);
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelaySettingsDefaults
+    #pragma mark
+
+    class RTPRelaySettingsDefaults : public ISettingsApplyDefaultsDelegate
+    {
+    public:
+      //-----------------------------------------------------------------------
+      ~RTPRelaySettingsDefaults()
+      {
+        ISettings::removeDefaults(*this);
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPRelaySettingsDefaultsPtr singleton()
+      {
+        static SingletonLazySharedPtr<RTPRelaySettingsDefaults> singleton(create());
+        return singleton.singleton();
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPRelaySettingsDefaultsPtr create()
+      {
+        auto pThis(make_shared<RTPRelaySettingsDefaults>());
+        ISettings::installDefaults(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      virtual void notifySettingsApplyDefaults() override
+      {
+        ISettings::setUInt(ORTC_SETTING_RTP_RELAY_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS, 300);
+      }
+      
+    };
+
+    //-------------------------------------------------------------------------
+    void installRTPRelaySettingsDefaults()
+    {
+      RTPRelaySettingsDefaults::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark (helpers)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static const IRTPTypes::CodecParameters *findCodec(
+                                                       const IRTPTypes::Parameters &params,
+                                                       IRTPTypes::PayloadType payloadType
+                                                       )
+    {
+      for (auto iter = params.mCodecs.begin(); iter != params.mCodecs.end(); ++iter) {
+        auto &codec = (*iter);
+        if (codec.mPayloadType == payloadType) return &codec;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    static bool isNewerSequenceNumber(
+                                      WORD sequenceNumber,
+                                      WORD previousSequenceNumber
+                                      )
+    {
+      return (sequenceNumber != previousSequenceNumber) &&
+             (static_cast<WORD>(sequenceNumber - previousSequenceNumber) < 0x8000);
+    }
+
+    //-------------------------------------------------------------------------
+    static void parseVideoPayload(
+                                  IRTPTypes::SupportedCodecs codec,
+                                  const BYTE *payload,
+                                  size_t size,
+                                  bool &outKeyFrame,
+                                  Optional<BYTE> &outTemporalLayerID
+                                  )
+    {
+      // codecs whose payload is not understood are always considered
+      // switchable and are never filtered by temporal layer
+      outKeyFrame = true;
+      outTemporalLayerID = Optional<BYTE>();
+
+      if ((NULL == payload) || (0 == size)) return;
+
+      switch (codec) {
+        case IRTPTypes::SupportedCodec_VP8: {
+          // see https://tools.ietf.org/html/rfc7741#section-4.2
+          outKeyFrame = false;
+
+          size_t pos = 0;
+          BYTE descriptor = payload[pos++];
+          bool startOfPartition = (0 != (descriptor & 0x10));
+          BYTE partitionIndex = (descriptor & 0x07);
+
+          if (0 != (descriptor & 0x80)) {
+            if (pos >= size) return;
+            BYTE extension = payload[pos++];
+            if (0 != (extension & 0x80)) {
+              if (pos >= size) return;
+              pos += (0 != (payload[pos] & 0x80) ? 2 : 1);
+            }
+            if (0 != (extension & 0x40)) ++pos;
+            if (0 != (extension & 0x30)) {
+              if (pos >= size) return;
+              if (0 != (extension & 0x20)) outTemporalLayerID = static_cast<BYTE>((payload[pos] >> 6) & 0x03);
+              ++pos;
+            }
+          }
+          if (pos >= size) return;
+
+          outKeyFrame = (startOfPartition) && (0 == partitionIndex) && (0 == (payload[pos] & 0x01));
+          break;
+        }
+        case IRTPTypes::SupportedCodec_VP9: {
+          // see https://tools.ietf.org/html/draft-ietf-payload-vp9-02#section-4.2
+          BYTE descriptor = payload[0];
+          outKeyFrame = (0 == (descriptor & 0x40)) && (0 != (descriptor & 0x08));
+
+          if (0 == (descriptor & 0x20)) return;
+
+          size_t pos = 1;
+          if (0 != (descriptor & 0x80)) {
+            if (pos >= size) return;
+            pos += (0 != (payload[pos] & 0x80) ? 2 : 1);
+          }
+          if (pos >= size) return;
+          outTemporalLayerID = static_cast<BYTE>((payload[pos] >> 5) & 0x07);
+          break;
+        }
+        case IRTPTypes::SupportedCodec_H264: {
+          // see https://tools.ietf.org/html/rfc6184#section-5.2
+          BYTE nalType = (payload[0] & 0x1F);
+          switch (nalType) {
+            case 24: {
+              // STAP-A (first aggregated NAL unit)
+              if (size < 4) {
+                outKeyFrame = false;
+                return;
+              }
+              nalType = (payload[3] & 0x1F);
+              break;
+            }
+            case 28: {
+              // FU-A (only the start fragment can begin a key frame)
+              if ((size < 2) ||
+                  (0 == (payload[1] & 0x80))) {
+                outKeyFrame = false;
+                return;
+              }
+              nalType = (payload[1] & 0x1F);
+              break;
+            }
+            default: break;
+          }
+          outKeyFrame = (5 == nalType) || (7 == nalType);
+          break;
+        }
+        default: break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPRelayForRTPReceiver::toDebug(ForRTPReceiverPtr relay)
+    {
+      if (!relay) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPRelay, relay)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPRelayForRTPSender::toDebug(ForRTPSenderPtr relay)
+    {
+      if (!relay) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPRelay, relay)->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay::SenderInfo
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPRelay::SenderInfo::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPRelay::SenderInfo");
+
+      IHelper::debugAppend(resultEl, "sender", mSender ? mSender->getID() : 0);
+      IHelper::debugAppend(resultEl, "options", mOptions.toDebug());
+      IHelper::debugAppend(resultEl, "parameters", (bool)mParameters);
+      IHelper::debugAppend(resultEl, "mapped receiver parameters", (bool)mMappedReceiverParameters);
+
+      IHelper::debugAppend(resultEl, "ssrc", mSSRC.hasValue() ? mSSRC.value() : 0);
+      IHelper::debugAppend(resultEl, "mux id", mMuxID);
+      IHelper::debugAppend(resultEl, "rid", mRID);
+      IHelper::debugAppend(resultEl, "payload types", mPayloadTypes.size());
+      IHelper::debugAppend(resultEl, "header extensions", mHeaderExtensions.size());
+      IHelper::debugAppend(resultEl, "mux id header extension id", mMuxIDHeaderExtensionID.hasValue() ? static_cast<int>(mMuxIDHeaderExtensionID.value()) : 0);
+      IHelper::debugAppend(resultEl, "rid header extension id", mRIDHeaderExtensionID.hasValue() ? static_cast<int>(mRIDHeaderExtensionID.value()) : 0);
+
+      IHelper::debugAppend(resultEl, "active encoding id", mActiveEncodingID);
+
+      IHelper::debugAppend(resultEl, "started", mStarted);
+      IHelper::debugAppend(resultEl, "source ssrc", mSourceSSRC.hasValue() ? mSourceSSRC.value() : 0);
+      IHelper::debugAppend(resultEl, "sequence number offset", mSequenceNumberOffset);
+      IHelper::debugAppend(resultEl, "timestamp offset", mTimestampOffset);
+      IHelper::debugAppend(resultEl, "last sequence number", mLastSequenceNumber);
+      IHelper::debugAppend(resultEl, "last timestamp", mLastTimestamp);
+      IHelper::debugAppend(resultEl, "last sent", mLastSent);
+
+      IHelper::debugAppend(resultEl, "total forwarded", mTotalForwarded);
+      IHelper::debugAppend(resultEl, "total dropped", mTotalDropped);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPRelay::RTPRelay(
+                       const make_private &,
+                       UseReceiverPtr receiver
+                       ) :
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mReceiver(receiver),
+      mMinKeyFrameRequestInterval(ISettings::getUInt(ORTC_SETTING_RTP_RELAY_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS))
+    {
+      ZS_LOG_DETAIL(debug("created"))
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::init()
+    {
+      mReceiver->registerRelay(mThisWeak.lock());
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelay::~RTPRelay()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DETAIL(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelayPtr RTPRelay::convert(IRTPRelayPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPRelay, object);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelayPtr RTPRelay::convert(ForRTPReceiverPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPRelay, object);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelayPtr RTPRelay::convert(ForRTPSenderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPRelay, object);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay => IRTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPRelay::toDebug(RTPRelayPtr relay)
+    {
+      if (!relay) return ElementPtr();
+      return relay->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelayPtr RTPRelay::create(IRTPReceiverPtr receiver)
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!receiver)
+
+      UseReceiverPtr useReceiver = RTPReceiver::convert(receiver);
+      ORTC_THROW_INVALID_PARAMETERS_IF(!useReceiver)
+
+      RTPRelayPtr pThis(make_shared<RTPRelay>(make_private {}, useReceiver));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    IRTPReceiverPtr RTPRelay::receiver() const
+    {
+      return RTPReceiver::convert(mReceiver);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::addSender(
+                             IRTPSenderPtr sender,
+                             const Options &options
+                             ) throw (
+                                      InvalidParameters,
+                                      InvalidStateError
+                                      )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!sender)
+
+      UseSenderPtr useSender = RTPSender::convert(sender);
+      ORTC_THROW_INVALID_PARAMETERS_IF(!useSender)
+
+      {
+        AutoRecursiveLock lock(*this);
+        ORTC_THROW_INVALID_STATE_IF(mShutdown)
+
+        auto found = mSenders.find(useSender->getID());
+        if (found != mSenders.end()) {
+          auto &info = *((*found).second);
+
+          ZS_LOG_DEBUG(log("updating relayed sender options") + ZS_PARAM("sender", useSender->getID()) + options.toDebug())
+
+          // switching encoding happens on the next key frame of the new
+          // encoding (see notifyReceivedPacket)
+          info.mOptions = options;
+          return;
+        }
+      }
+
+      // NOTE: registration is done outside the lock as the sender will
+      //       call back into the relay while holding its own lock
+      auto params = useSender->registerRelay(mThisWeak.lock());
+
+      AutoRecursiveLock lock(*this);
+      if (mShutdown) {
+        useSender->unregisterRelay(mID);
+        ORTC_THROW_INVALID_STATE("relay was stopped")
+      }
+
+      auto info = make_shared<SenderInfo>();
+      info->mSender = useSender;
+      info->mOptions = options;
+      info->mParameters = params;
+
+      mSenders[useSender->getID()] = info;
+
+      ZS_LOG_DEBUG(log("added relayed sender") + info->toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::removeSender(IRTPSenderPtr sender)
+    {
+      if (!sender) return;
+
+      UseSenderPtr useSender;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mSenders.find(sender->getID());
+        if (found == mSenders.end()) {
+          ZS_LOG_WARNING(Debug, log("sender is not being relayed to") + ZS_PARAM("sender", sender->getID()))
+          return;
+        }
+
+        useSender = (*found).second->mSender;
+        ZS_LOG_DEBUG(log("removed relayed sender") + (*found).second->toDebug())
+
+        mSenders.erase(found);
+      }
+
+      useSender->unregisterRelay(mID);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::stop()
+    {
+      ZS_LOG_DEBUG(log("stop called"))
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay => IRTPRelayForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::notifyReceivedPacket(
+                                        ParametersPtr receiverParams,
+                                        const String &encodingID,
+                                        RTPPacketPtr packet
+                                        )
+    {
+      if (!receiverParams) return;
+
+      // scope: figure out if the payload can be forwarded
+      auto codec = findCodec(*receiverParams, packet->pt());
+      if (!codec) {
+        ZS_LOG_TRACE(log("no codec found for relayed packet") + ZS_PARAM("ssrc", packet->ssrc()) + ZS_PARAM("payload type", packet->pt()))
+        return;
+      }
+
+      auto supportedCodec = IRTPTypes::toSupportedCodec(codec->mName);
+      auto mediaCodec = codec;
+      const BYTE *mediaPayload = packet->payload();
+      size_t mediaPayloadSize = packet->payloadSize();
+      bool red = false;
+      bool forwardable = true;
+
+      switch (IRTPTypes::getCodecKind(supportedCodec)) {
+        case IRTPTypes::CodecKind_Audio:
+        case IRTPTypes::CodecKind_Video:
+        case IRTPTypes::CodecKind_AV:
+        case IRTPTypes::CodecKind_AudioSupplemental:  break;
+        case IRTPTypes::CodecKind_RTX:                return; // retransmissions arrive on their own SSRC and are never relayed
+        case IRTPTypes::CodecKind_FEC: {
+          // only single block RED (as produced by webrtc) carrying a media
+          // payload can be rewritten; ULPFEC / FlexFEC cannot be relayed
+          // since the protected packets were rewritten
+          forwardable = false;
+          if (IRTPTypes::SupportedCodec_RED != supportedCodec) break;
+          if ((mediaPayloadSize < 1) || (0 != (mediaPayload[0] & 0x80))) break;
+
+          mediaCodec = findCodec(*receiverParams, static_cast<PayloadType>(mediaPayload[0] & 0x7F));
+          if (!mediaCodec) break;
+
+          switch (IRTPTypes::getCodecKind(IRTPTypes::toSupportedCodec(mediaCodec->mName))) {
+            case IRTPTypes::CodecKind_Audio:
+            case IRTPTypes::CodecKind_Video:
+            case IRTPTypes::CodecKind_AV:     forwardable = true; break;
+            default:                          break;
+          }
+          ++mediaPayload;
+          --mediaPayloadSize;
+          red = true;
+          break;
+        }
+        default: {
+          ZS_LOG_TRACE(log("codec kind is not relayed") + ZS_PARAM("codec", codec->mName))
+          return;
+        }
+      }
+
+      bool keyFrame = true;
+      Optional<BYTE> temporalLayerID;
+      if (forwardable) {
+        parseVideoPayload(IRTPTypes::toSupportedCodec(mediaCodec->mName), mediaPayload, mediaPayloadSize, keyFrame, temporalLayerID);
+      }
+
+      ULONG clockRate = mediaCodec->mClockRate.hasValue() ? mediaCodec->mClockRate.value() : 0;
+
+      SenderPacketList sendPackets;
+      typedef std::set<EncodingID> EncodingIDSet;
+      EncodingIDSet keyFrameEncodings;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) return;
+
+        mReceiverParameters = receiverParams;
+        if (forwardable) mEncodingSSRCs[encodingID] = packet->ssrc();
+
+        for (auto iter = mSenders.begin(); iter != mSenders.end(); ++iter) {
+          auto &info = *((*iter).second);
+
+          if (info.mMappedReceiverParameters != receiverParams) updateMappings(info, receiverParams);
+
+          auto targetEncodingID = resolveEncodingID(info.mOptions, *receiverParams);
+
+          if ((!info.mStarted) ||
+              (targetEncodingID != info.mActiveEncodingID)) {
+            // only (re)start forwarding a stream on a key frame
+            if (targetEncodingID == encodingID) {
+              if ((forwardable) && (keyFrame)) {
+                ZS_LOG_DEBUG(log("switching relayed encoding") + ZS_PARAM("sender", info.mSender->getID()) + ZS_PARAM("from", info.mActiveEncodingID) + ZS_PARAM("to", targetEncodingID))
+                info.mActiveEncodingID = targetEncodingID;
+                info.mSourceSSRC = Optional<SSRCType>();  // forces resync of sequence numbers and timestamps
+              } else if (info.mOptions.mRequestKeyFrameOnSwitch) {
+                keyFrameEncodings.insert(targetEncodingID);
+              }
+            }
+          }
+
+          if (info.mActiveEncodingID != encodingID) continue;
+          if ((!info.mStarted) && (!keyFrame)) continue;
+
+          Optional<PayloadType> senderPayloadType;
+          Optional<PayloadType> senderRedPayloadType;
+
+          if (forwardable) {
+            auto found = info.mPayloadTypes.find(packet->pt());
+            if (found != info.mPayloadTypes.end()) senderPayloadType = (*found).second;
+            if (red) {
+              senderRedPayloadType = senderPayloadType;
+              senderPayloadType = Optional<PayloadType>();
+              auto foundMedia = info.mPayloadTypes.find(mediaCodec->mPayloadType);
+              if (foundMedia != info.mPayloadTypes.end()) senderPayloadType = (*foundMedia).second;
+            }
+          }
+
+          bool drop = (!forwardable) ||
+                      (!senderPayloadType.hasValue()) ||
+                      ((red) && (!senderRedPayloadType.hasValue()));
+
+          if ((!drop) &&
+              (info.mOptions.mMaxTemporalLayerID.hasValue()) &&
+              (temporalLayerID.hasValue())) {
+            drop = (temporalLayerID.value() > info.mOptions.mMaxTemporalLayerID.value());
+          }
+
+          if (drop) {
+            // keep the outgoing sequence numbers contiguous; a late arrival
+            // maps behind what was already sent so its number was never
+            // handed out and the offset must stay as is
+            if ((info.mStarted) &&
+                (info.mSourceSSRC.hasValue()) &&
+                (info.mSourceSSRC.value() == packet->ssrc()) &&
+                (isNewerSequenceNumber(static_cast<WORD>(packet->sequenceNumber() + info.mSequenceNumberOffset), info.mLastSequenceNumber))) {
+              --info.mSequenceNumberOffset;
+            }
+            ++info.mTotalDropped;
+            continue;
+          }
+
+          RTPPacketPtr outPacket;
+          if (red) {
+            outPacket = rewrite(info, *packet, senderRedPayloadType.value(), senderPayloadType, clockRate);
+          } else {
+            outPacket = rewrite(info, *packet, senderPayloadType.value(), Optional<PayloadType>(), clockRate);
+          }
+          if (!outPacket) {
+            ++info.mTotalDropped;
+            continue;
+          }
+
+          ++info.mTotalForwarded;
+          sendPackets.push_back(SenderPacketPair(info.mSender, outPacket));
+        }
+
+        for (auto iter = keyFrameEncodings.begin(); iter != keyFrameEncodings.end(); ++iter) {
+          auto keyFrameRequest = prepareKeyFrameRequest(*iter);
+          if (!keyFrameRequest) continue;
+          mPendingKeyFrameRequests.push_back(keyFrameRequest);
+        }
+      }
+
+      for (auto iter = sendPackets.begin(); iter != sendPackets.end(); ++iter) {
+        auto &sender = (*iter).first;
+        auto &outPacket = (*iter).second;
+        sender->sendRelayedPacket(outPacket);
+      }
+
+      sendKeyFrameRequests();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay => IRTPRelayForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::notifySenderParameters(
+                                          PUID senderID,
+                                          ParametersPtr params
+                                          )
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto found = mSenders.find(senderID);
+      if (found == mSenders.end()) return;
+
+      auto &info = *((*found).second);
+
+      ZS_LOG_DEBUG(log("relayed sender parameters changed") + ZS_PARAM("sender", senderID))
+
+      info.mParameters = params;
+      info.mMappedReceiverParameters.reset(); // forces the mappings to be recalculated
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPRelay::notifySenderFeedback(
+                                        PUID senderID,
+                                        const FeedbackEventList &events
+                                        )
+    {
+      bool forwarded = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) return false;
+
+        auto found = mSenders.find(senderID);
+        if (found == mSenders.end()) return false;
+
+        auto &info = *((*found).second);
+
+        for (auto iter = events.begin(); iter != events.end(); ++iter) {
+          auto &event = (*iter);
+          switch (event.mType) {
+            case RTCPPacket::FeedbackEvent::Type_PLI:
+            case RTCPPacket::FeedbackEvent::Type_FIR: {
+              if (!info.mStarted) break;
+              auto keyFrameRequest = prepareKeyFrameRequest(info.mActiveEncodingID);
+              if (!keyFrameRequest) break;
+              mPendingKeyFrameRequests.push_back(keyFrameRequest);
+              forwarded = true;
+              break;
+            }
+            default: {
+              // NACK / REMB are not translated upstream; the sender answers
+              // NACKs itself from the relayed packets it retained
+              ZS_LOG_TRACE(log("ignoring relayed sender feedback") + ZS_PARAM("sender", senderID) + ZS_PARAM("ssrc", event.mSSRC))
+              break;
+            }
+          }
+        }
+      }
+
+      sendKeyFrameRequests();
+      return forwarded;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPRelay::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPRelay");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPRelay::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPRelay::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::RTPRelay");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "receiver", mReceiver ? mReceiver->getID() : 0);
+      IHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+      IHelper::debugAppend(resultEl, "receiver parameters", (bool)mReceiverParameters);
+
+      if (mSenders.size() > 0) {
+        ElementPtr sendersEl = Element::create("senders");
+        for (auto iter = mSenders.begin(); iter != mSenders.end(); ++iter) {
+          IHelper::debugAppend(sendersEl, (*iter).second->toDebug());
+        }
+        IHelper::debugAppend(resultEl, sendersEl);
+      }
+
+      IHelper::debugAppend(resultEl, "encoding ssrcs", mEncodingSSRCs.size());
+      IHelper::debugAppend(resultEl, "last key frame requests", mLastKeyFrameRequests.size());
+      IHelper::debugAppend(resultEl, "pending key frame requests", mPendingKeyFrameRequests.size());
+      IHelper::debugAppend(resultEl, "min key frame request interval", mMinKeyFrameRequestInterval);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::cancel()
+    {
+      UseReceiverPtr receiver;
+      SenderInfoMap senders;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) return;
+        mShutdown = true;
+
+        receiver = mReceiver;
+        senders = mSenders;
+
+        mSenders.clear();
+        mEncodingSSRCs.clear();
+        mLastKeyFrameRequests.clear();
+        mPendingKeyFrameRequests.clear();
+        mReceiverParameters.reset();
+      }
+
+      if (receiver) receiver->unregisterRelay(mID);
+
+      for (auto iter = senders.begin(); iter != senders.end(); ++iter) {
+        auto &info = *((*iter).second);
+        info.mSender->unregisterRelay(mID);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::updateMappings(
+                                  SenderInfo &info,
+                                  ParametersPtr receiverParams
+                                  )
+    {
+      info.mMappedReceiverParameters = receiverParams;
+
+      info.mSSRC = Optional<SSRCType>();
+      info.mMuxID.clear();
+      info.mRID.clear();
+      info.mPayloadTypes.clear();
+      info.mHeaderExtensions.clear();
+      info.mMuxIDHeaderExtensionID = Optional<BYTE>();
+      info.mRIDHeaderExtensionID = Optional<BYTE>();
+
+      if (!info.mParameters) {
+        ZS_LOG_WARNING(Debug, log("relayed sender has no parameters (packets will be dropped)") + ZS_PARAM("sender", info.mSender->getID()))
+        return;
+      }
+
+      auto &senderParams = *(info.mParameters);
+
+      if (senderParams.mEncodings.size() > 0) {
+        auto &encoding = senderParams.mEncodings.front();
+        info.mSSRC = encoding.mSSRC;
+        info.mRID = encoding.mEncodingID;
+      }
+      if (!info.mSSRC.hasValue()) {
+        ZS_LOG_WARNING(Debug, log("relayed sender has no ssrc (source ssrc will be used)") + ZS_PARAM("sender", info.mSender->getID()))
+      }
+
+      info.mMuxID = senderParams.mMuxID;
+
+      for (auto iter = receiverParams->mCodecs.begin(); iter != receiverParams->mCodecs.end(); ++iter) {
+        auto &receiverCodec = (*iter);
+        if (IRTPTypes::CodecKind_RTX == IRTPTypes::getCodecKind(IRTPTypes::toSupportedCodec(receiverCodec.mName))) continue;
+
+        for (auto iterSender = senderParams.mCodecs.begin(); iterSender != senderParams.mCodecs.end(); ++iterSender) {
+          auto &senderCodec = (*iterSender);
+          if (0 != receiverCodec.mName.compareNoCase(senderCodec.mName)) continue;
+          if ((receiverCodec.mClockRate.hasValue()) &&
+              (senderCodec.mClockRate.hasValue()) &&
+              (receiverCodec.mClockRate.value() != senderCodec.mClockRate.value())) continue;
+
+          info.mPayloadTypes[receiverCodec.mPayloadType] = senderCodec.mPayloadType;
+          break;
+        }
+      }
+
+      for (auto iter = senderParams.mHeaderExtensions.begin(); iter != senderParams.mHeaderExtensions.end(); ++iter) {
+        auto &senderExtension = (*iter);
+        switch (IRTPTypes::toHeaderExtensionURI(senderExtension.mURI)) {
+          case IRTPTypes::HeaderExtensionURI_MuxID: info.mMuxIDHeaderExtensionID = static_cast<BYTE>(senderExtension.mID); break;
+          case IRTPTypes::HeaderExtensionURI_RID:   info.mRIDHeaderExtensionID = static_cast<BYTE>(senderExtension.mID); break;
+          default: {
+            for (auto iterReceiver = receiverParams->mHeaderExtensions.begin(); iterReceiver != receiverParams->mHeaderExtensions.end(); ++iterReceiver) {
+              auto &receiverExtension = (*iterReceiver);
+              if (receiverExtension.mURI != senderExtension.mURI) continue;
+              info.mHeaderExtensions[static_cast<BYTE>(receiverExtension.mID)] = static_cast<BYTE>(senderExtension.mID);
+              break;
+            }
+            break;
+          }
+        }
+      }
+
+      ZS_LOG_DEBUG(log("updated relayed sender mappings") + info.toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelay::EncodingID RTPRelay::resolveEncodingID(
+                                                     const Options &options,
+                                                     const Parameters &receiverParams
+                                                     ) const
+    {
+      if (options.mEncodingID.hasData()) return options.mEncodingID;
+      if (receiverParams.mEncodings.size() < 1) return EncodingID();
+      return receiverParams.mEncodings.front().mEncodingID;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPRelay::rewrite(
+                                   SenderInfo &info,
+                                   const RTPPacket &packet,
+                                   PayloadType senderPayloadType,
+                                   Optional<PayloadType> senderRedPrimaryPayloadType,
+                                   ULONG clockRate
+                                   )
+    {
+      Time tick = zsLib::now();
+
+      if ((!info.mSourceSSRC.hasValue()) ||
+          (info.mSourceSSRC.value() != packet.ssrc())) {
+        if (info.mStarted) {
+          // continue the outgoing stream from where it left off
+          auto elapsed = zsLib::toMilliseconds(tick - info.mLastSent).count();
+          DWORD advance = (0 != clockRate ? static_cast<DWORD>((elapsed * static_cast<decltype(elapsed)>(clockRate)) / 1000) : 0);
+          if (0 == advance) advance = 1;
+
+          info.mSequenceNumberOffset = static_cast<WORD>(static_cast<WORD>(info.mLastSequenceNumber + 1) - packet.sequenceNumber());
+          info.mTimestampOffset = static_cast<DWORD>((info.mLastTimestamp + advance) - packet.timestamp());
+        } else {
+          info.mSequenceNumberOffset = 0;
+          info.mTimestampOffset = 0;
+        }
+        info.mSourceSSRC = packet.ssrc();
+      }
+
+      WORD sequenceNumber = static_cast<WORD>(packet.sequenceNumber() + info.mSequenceNumberOffset);
+      DWORD timestamp = static_cast<DWORD>(packet.timestamp() + info.mTimestampOffset);
+
+      // scope: translate header extensions
+      typedef std::vector<RTPPacket::HeaderExtension> HeaderExtensionList;
+      typedef std::vector<RTPPacket::HeaderExtension *> HeaderExtensionPtrList;
+
+      HeaderExtensionList extensions;
+      HeaderExtensionPtrList orderedExtensions;
+      extensions.reserve(packet.totalHeaderExtensions());
+
+      for (auto extension = packet.firstHeaderExtension(); NULL != extension; extension = extension->mNext) {
+        auto found = info.mHeaderExtensions.find(extension->mID);
+        if (found == info.mHeaderExtensions.end()) continue;
+
+        RTPPacket::HeaderExtension translated;
+        translated.mID = (*found).second;
+        translated.mData = extension->mData;
+        translated.mDataSizeInBytes = extension->mDataSizeInBytes;
+        extensions.push_back(translated);
+      }
+      for (auto iter = extensions.begin(); iter != extensions.end(); ++iter) {
+        orderedExtensions.push_back(&(*iter));
+      }
+
+      RTPPacket::MidHeaderExtension midExtension(info.mMuxIDHeaderExtensionID.hasValue() ? info.mMuxIDHeaderExtensionID.value() : 0, info.mMuxID.c_str());
+      RTPPacket::RidHeaderExtension ridExtension(info.mRIDHeaderExtensionID.hasValue() ? info.mRIDHeaderExtensionID.value() : 0, info.mRID.c_str());
+
+      if ((info.mMuxIDHeaderExtensionID.hasValue()) && (info.mMuxID.hasData())) orderedExtensions.push_back(&midExtension);
+      if ((info.mRIDHeaderExtensionID.hasValue()) && (info.mRID.hasData())) orderedExtensions.push_back(&ridExtension);
+
+      for (size_t index = 0; index < orderedExtensions.size(); ++index) {
+        orderedExtensions[index]->mNext = (index + 1 < orderedExtensions.size() ? orderedExtensions[index + 1] : NULL);
+      }
+
+      std::vector<DWORD> csrcs;
+      for (size_t index = 0; index < packet.cc(); ++index) {
+        csrcs.push_back(packet.getCSRC(index));
+      }
+
+      SecureByteBlock redPayload;
+      const BYTE *payload = packet.payload();
+      size_t payloadSize = packet.payloadSize();
+
+      if (senderRedPrimaryPayloadType.hasValue()) {
+        if (payloadSize < 1) return RTPPacketPtr();
+        redPayload.Assign(payload, payloadSize);
+        redPayload.BytePtr()[0] = (senderRedPrimaryPayloadType.value() & 0x7F);  // single block (F bit clear)
+        payload = redPayload.BytePtr();
+      }
+
+      RTPPacket::CreationParams params;
+      params.mPadding = packet.padding();
+      params.mM = packet.m();
+      params.mPT = senderPayloadType;
+      params.mSequenceNumber = sequenceNumber;
+      params.mTimestamp = timestamp;
+      params.mSSRC = (info.mSSRC.hasValue() ? info.mSSRC.value() : packet.ssrc());
+      params.mCC = csrcs.size();
+      params.mCSRCList = (csrcs.size() > 0 ? &(csrcs[0]) : NULL);
+      params.mPayload = (payloadSize > 0 ? payload : NULL);
+      params.mPayloadSize = payloadSize;
+      params.mFirstHeaderExtension = (orderedExtensions.size() > 0 ? orderedExtensions.front() : NULL);
+      params.mHeaderExtensionAppBits = packet.headerExtensionAppBits();
+
+      RTPPacketPtr result = RTPPacket::create(params);
+
+      if ((!info.mStarted) ||
+          (isNewerSequenceNumber(sequenceNumber, info.mLastSequenceNumber))) {
+        info.mLastSequenceNumber = sequenceNumber;
+        info.mLastTimestamp = timestamp;
+        info.mLastSent = tick;
+      }
+      info.mStarted = true;
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacketPtr RTPRelay::prepareKeyFrameRequest(const EncodingID &encodingID)
+    {
+      auto foundSSRC = mEncodingSSRCs.find(encodingID);
+      if (foundSSRC == mEncodingSSRCs.end()) {
+        ZS_LOG_TRACE(log("cannot request key frame for encoding not yet received") + ZS_PARAM("encoding id", encodingID))
+        return RTCPPacketPtr();
+      }
+
+      Time tick = zsLib::now();
+
+      auto foundLast = mLastKeyFrameRequests.find(encodingID);
+      if (foundLast != mLastKeyFrameRequests.end()) {
+        if (tick < (*foundLast).second + mMinKeyFrameRequestInterval) return RTCPPacketPtr();
+      }
+      mLastKeyFrameRequests[encodingID] = tick;
+
+      SSRCType senderSSRC = (mReceiverParameters ? mReceiverParameters->mRTCP.mSSRC : 0);
+
+      // see https://tools.ietf.org/html/rfc4585#section-6.3.1
+      BYTE pli[12] {};
+      pli[0] = 0x81;  // version 2, FMT 1 (PLI)
+      pli[1] = 206;   // PSFB
+      RTPUtils::setBE16(&(pli[2]), 2);
+      RTPUtils::setBE32(&(pli[4]), senderSSRC);
+      RTPUtils::setBE32(&(pli[8]), (*foundSSRC).second);
+
+      ZS_LOG_DEBUG(log("requesting key frame from relayed source") + ZS_PARAM("encoding id", encodingID) + ZS_PARAM("ssrc", (*foundSSRC).second))
+
+      return RTCPPacket::create(pli, sizeof(pli));
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPRelay::sendKeyFrameRequests()
+    {
+      UseReceiverPtr receiver;
+      RTCPPacketList requests;
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (mPendingKeyFrameRequests.size() < 1) return;
+
+        receiver = mReceiver;
+        requests = mPendingKeyFrameRequests;
+        mPendingKeyFrameRequests.clear();
+      }
+
+      for (auto iter = requests.begin(); iter != requests.end(); ++iter) {
+        receiver->sendPacket(*iter);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRTPRelayFactory &IRTPRelayFactory::singleton()
+    {
+      return RTPRelayFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPRelayPtr IRTPRelayFactory::create(IRTPReceiverPtr receiver)
+    {
+      if (this) {}
+      return internal::RTPRelay::create(receiver);
+    }
+
+  } // internal namespace
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPRelayTypes::Options
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IRTPRelayTypes::Options::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IRTPRelayTypes::Options");
+
+    IHelper::debugAppend(resultEl, "encoding id", mEncodingID);
+    IHelper::debugAppend(resultEl, "max temporal layer id", mMaxTemporalLayerID.hasValue() ? static_cast<int>(mMaxTemporalLayerID.value()) : -1);
+    IHelper::debugAppend(resultEl, "request key frame on switch", mRequestKeyFrameOnSwitch);
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  String IRTPRelayTypes::Options::hash() const
+  {
+    auto hasher = IHasher::sha1();
+
+    hasher->update("ortc::IRTPRelayTypes::Options:");
+
+    hasher->update(mEncodingID);
+    hasher->update(":");
+    hasher->update(mMaxTemporalLayerID);
+    hasher->update(":");
+    hasher->update(mRequestKeyFrameOnSwitch);
+
+    return hasher->finalizeAsString();
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IRTPRelay
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IRTPRelay::toDebug(IRTPRelayPtr relay)
+  {
+    return internal::RTPRelay::toDebug(internal::RTPRelay::convert(relay));
+  }
+
+  //---------------------------------------------------------------------------
+  IRTPRelayPtr IRTPRelay::create(IRTPReceiverPtr receiver)
+  {
+    return internal::IRTPRelayFactory::singleton().create(receiver);
+  }
+
+}
@@ -34,10 +34,12 @@
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
+#include <ortc/internal/ortc_RTPRelay.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_RTPTypes.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
@@ -91,6 +93,41 @@ namespace ortc
     #pragma mark (helpers)
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    static bool hasSSRC(
+                        const IRTPTypes::Parameters &params,
+                        IRTPTypes::SSRCType ssrc
+                        )
+    {
+      for (auto iter = params.mEncodings.begin(); iter != params.mEncodings.end(); ++iter) {
+        auto &encoding = (*iter);
+
+        if (encoding.mSSRC.hasValue()) {
+          if (ssrc == encoding.mSSRC.value()) return true;
+        }
+        if (encoding.mRTX.hasValue()) {
+          if (encoding.mRTX.value().mSSRC.hasValue()) {
+            if (ssrc == encoding.mRTX.value().mSSRC.value()) return true;
+          }
+        }
+        if (encoding.mFEC.hasValue()) {
+          if (encoding.mFEC.value().mSSRC.hasValue()) {
+            if (ssrc == encoding.mFEC.value().mSSRC.value()) return true;
+          }
+        }
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    static bool isNewerSequenceNumber(
+                                      WORD sequenceNumber,
+                                      WORD previousSequenceNumber
+                                      )
+    {
+      return (sequenceNumber != previousSequenceNumber) &&
+             (static_cast<WORD>(sequenceNumber - previousSequenceNumber) < 0x8000);
+    }
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -127,6 +164,10 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_PACKETS, 1024);
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_BYTES, 1024*1024);
+
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_MIN_INTERVAL_IN_MILLISECONDS, 10);
       }
       
     };
@@ -196,6 +237,21 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPSenderForRTPRelay::toDebug(ForRTPRelayPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -280,6 +336,12 @@ namespace ortc
       mChannel->requestStats(promise, stats);
     }
 
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::OutboundRTPStreamStatsPtr RTPSender::ChannelHolder::sampleStats() const
+    {
+      return mChannel->sampleStats();
+    }
+
     //-------------------------------------------------------------------------
     void RTPSender::ChannelHolder::insertDTMF(
                                               const char *tones,
@@ -320,6 +382,147 @@ namespace ortc
       return resultEl;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender::RetransmissionHistory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPSender::RetransmissionHistory::RetransmissionHistory(
+                                                            IRTPTypes::SSRCType ssrc,
+                                                            size_t maxPackets,
+                                                            size_t maxBytes
+                                                            ) :
+      mSSRC(ssrc),
+      mEntries(maxPackets),
+      mMaxBytes(maxBytes),
+      mRTXSequenceNumber(static_cast<WORD>(IHelper::random(0, 0xFFFF)))
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::RetransmissionHistory::store(RTPPacketPtr packet)
+    {
+      if (mEntries.size() < 1) return;
+
+      size_t capacity = mEntries.size();
+      WORD sequenceNumber = packet->sequenceNumber();
+
+      ++mPacketsSent;
+      mBytesSent += packet->size();
+
+      if (!mHasPackets) {
+        mHasPackets = true;
+        mOldestSequenceNumber = sequenceNumber;
+        mNewestSequenceNumber = sequenceNumber;
+      } else if (isNewerSequenceNumber(sequenceNumber, mNewestSequenceNumber)) {
+        if (static_cast<WORD>(sequenceNumber - mNewestSequenceNumber) >= capacity) {
+          // jumped beyond everything remembered
+          clear();
+          mHasPackets = true;
+          mOldestSequenceNumber = sequenceNumber;
+        }
+        mNewestSequenceNumber = sequenceNumber;
+
+        while (static_cast<WORD>(mNewestSequenceNumber - mOldestSequenceNumber) >= capacity) {
+          evictOldest();
+        }
+      } else {
+        // late packets outside the remembered window are not kept
+        if (static_cast<WORD>(mNewestSequenceNumber - sequenceNumber) >= capacity) return;
+        if (isNewerSequenceNumber(mOldestSequenceNumber, sequenceNumber)) mOldestSequenceNumber = sequenceNumber;
+      }
+
+      auto &entry = mEntries[sequenceNumber % capacity];
+      if (entry.mPacket) {
+        mTotalBytes -= entry.mPacket->size();
+        entry.mPacket.reset();
+      }
+
+      // enforce the per stream memory cap by dropping the oldest packets
+      while ((0 != mTotalBytes) &&
+             (mTotalBytes + packet->size() > mMaxBytes)) {
+        evictOldest();
+      }
+      if (isNewerSequenceNumber(mOldestSequenceNumber, sequenceNumber)) mOldestSequenceNumber = sequenceNumber;
+
+      entry.mPacket = packet;
+      entry.mLastRetransmitted = Time();
+      mTotalBytes += packet->size();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPSender::RetransmissionHistory::Entry *RTPSender::RetransmissionHistory::find(WORD sequenceNumber)
+    {
+      if ((!mHasPackets) ||
+          (mEntries.size() < 1)) return NULL;
+
+      if (isNewerSequenceNumber(sequenceNumber, mNewestSequenceNumber)) return NULL;
+      if (isNewerSequenceNumber(mOldestSequenceNumber, sequenceNumber)) return NULL;
+
+      auto &entry = mEntries[sequenceNumber % mEntries.size()];
+      if (!entry.mPacket) return NULL;
+      if (entry.mPacket->sequenceNumber() != sequenceNumber) return NULL;
+
+      return &entry;
+    }
+
+    //-------------------------------------------------------------------------
+    double RTPSender::RetransmissionHistory::retransmissionRate() const
+    {
+      if (0 == mPacketsSent) return 0.0;
+      return static_cast<double>(mRetransmittedPacketsSent) / static_cast<double>(mPacketsSent);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPSender::RetransmissionHistory::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPSender::RetransmissionHistory");
+
+      IHelper::debugAppend(resultEl, "ssrc", mSSRC);
+      IHelper::debugAppend(resultEl, "capacity", mEntries.size());
+      IHelper::debugAppend(resultEl, "total bytes", mTotalBytes);
+      IHelper::debugAppend(resultEl, "max bytes", mMaxBytes);
+      IHelper::debugAppend(resultEl, "oldest sequence number", mHasPackets ? mOldestSequenceNumber : 0);
+      IHelper::debugAppend(resultEl, "newest sequence number", mHasPackets ? mNewestSequenceNumber : 0);
+      IHelper::debugAppend(resultEl, "rtx sequence number", mRTXSequenceNumber);
+      IHelper::debugAppend(resultEl, "packets sent", mPacketsSent);
+      IHelper::debugAppend(resultEl, "bytes sent", mBytesSent);
+      IHelper::debugAppend(resultEl, "nack count", mNACKCount);
+      IHelper::debugAppend(resultEl, "packets requested", mPacketsRequested);
+      IHelper::debugAppend(resultEl, "packets missing", mPacketsMissing);
+      IHelper::debugAppend(resultEl, "retransmitted packets sent", mRetransmittedPacketsSent);
+      IHelper::debugAppend(resultEl, "retransmitted bytes sent", mRetransmittedBytesSent);
+      IHelper::debugAppend(resultEl, "retransmission rate", retransmissionRate());
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::RetransmissionHistory::evictOldest()
+    {
+      auto &entry = mEntries[mOldestSequenceNumber % mEntries.size()];
+      if (entry.mPacket) {
+        mTotalBytes -= entry.mPacket->size();
+        entry.mPacket.reset();
+      }
+      ++mOldestSequenceNumber;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::RetransmissionHistory::clear()
+    {
+      for (auto iter = mEntries.begin(); iter != mEntries.end(); ++iter) {
+        auto &entry = (*iter);
+        entry.mPacket.reset();
+        entry.mLastRetransmitted = Time();
+      }
+      mTotalBytes = 0;
+      mHasPackets = false;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -352,10 +555,23 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mChannels(make_shared<ParametersToChannelHolderMap>()),
-      mTrack(MediaStreamTrack::convert(track))
+      mRelays(make_shared<RelayWeakMap>()),
+      mTrack(MediaStreamTrack::convert(track)),
+      mRetransmissionHistoryMaxBytes(ISettings::getUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_BYTES)),
+      mRetransmissionMinInterval(ISettings::getUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_MIN_INTERVAL_IN_MILLISECONDS))
     {
       ZS_LOG_DETAIL(debug("created"))
 
+      // ring is indexed by sequence number so its size must divide 2^16
+      size_t maxPackets = ISettings::getUInt(ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_PACKETS);
+      if (0 != maxPackets) {
+        mRetransmissionHistoryMaxPackets = 1;
+        while ((mRetransmissionHistoryMaxPackets < maxPackets) &&
+               (mRetransmissionHistoryMaxPackets < 0x8000)) {
+          mRetransmissionHistoryMaxPackets <<= 1;
+        }
+      }
+
       mListener = UseListener::getListener(transport);
       ORTC_THROW_INVALID_STATE_IF(!mListener)
 
@@ -428,6 +644,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPSenderPtr RTPSender::convert(ForRTPRelayPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -447,10 +669,23 @@ namespace ortc
       ParametersToChannelHolderMapPtr channels;
 
       UseStatsReport::PromiseWithStatsReportList promises;
+      UseStatsReport::StatMap relayedStats;
 
       {
         AutoRecursiveLock lock(*this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
+
+        StatsList historyStats;
+        appendRetransmissionHistoryStats(historyStats);
+        for (auto iter = historyStats.begin(); iter != historyStats.end(); ++iter) {
+          relayedStats[(*iter)->mID] = (*iter);
+        }
+      }
+
+      if (relayedStats.size() > 0) {
+        auto relayedPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+        relayedPromise->resolve(UseStatsReport::create(relayedStats));
+        promises.push_back(relayedPromise);
       }
 
       bool result = false;
@@ -466,6 +701,42 @@ namespace ortc
       return UseStatsReport::collectReports(promises);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => IStatsProviderForStatsSubscription
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::sampleStats(
+                                const StatsTypeSet &stats,
+                                StatsList &outStats
+                                ) const
+    {
+      // outbound RTP stream stats are the only stats with changing counters
+      // (codec stats are static and only available through getStats())
+      if (!stats.hasStatType(IStatsReportTypes::StatsType_OutboundRTP)) return true;
+
+      ParametersToChannelHolderMapPtr channels;
+
+      {
+        AutoRecursiveLock lock(*this);
+        channels = mChannels; // obtain pointer to COW list while inside a lock
+
+        appendRetransmissionHistoryStats(outStats);
+      }
+
+      for (auto iter = channels->begin(); iter != channels->end(); ++iter)
+      {
+        auto report = (*iter).second->sampleStats();
+        if (report) outStats.push_back(report);
+      }
+
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -839,6 +1110,21 @@ namespace ortc
       RTCPPacketList historicalRTCPPackets;
       mListener->registerSender(mThisWeak.lock(), *mParameters, historicalRTCPPackets);
 
+      // forget retransmission history of streams no longer being sent
+      for (auto iter_doNotUse = mRetransmissionHistories.begin(); iter_doNotUse != mRetransmissionHistories.end();) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        if (hasSSRC(*mParameters, (*current).first)) continue;
+        mRetransmissionHistories.erase(current);
+      }
+
+      for (auto iter = mRelays->begin(); iter != mRelays->end(); ++iter) {
+        auto relay = (*iter).second.lock();
+        if (!relay) continue;
+        relay->notifySenderParameters(mID, mParameters);
+      }
+
       promise->resolve();
       return promise;
     }
@@ -873,8 +1159,8 @@ namespace ortc
                     puid, id, mID,
                     enum, viaTransport, zsLib::to_underlying(viaTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug())
@@ -896,14 +1182,81 @@ namespace ortc
                       puid, id, mID,
                       enum, viaTransport, zsLib::to_underlying(viaTransport),
                       enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                      buffer, packet, packet->buffer()->BytePtr(),
-                      size, size, packet->buffer()->SizeInBytes()
+                      buffer, packet, packet->ptr(),
+                      size, size, packet->size()
+                      );
+
+        auto channelResult = channel->handle(packet);
+        result = result || channelResult;
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::handleFeedback(
+                                   IICETypes::Components viaTransport,
+                                   RTCPPacketPtr packet,
+                                   const FeedbackEventList &events
+                                   )
+    {
+      ZS_LOG_TRACE(log("received feedback") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("events", events.size()))
+
+      ParametersToChannelHolderMapPtr channels;
+      RelayWeakMapPtr relays;
+
+      {
+        AutoRecursiveLock lock(*this);
+        channels = mChannels; // obtain pointer to COW list while inside a lock
+        relays = mRelays;
+      }
+
+      bool result = handleRetransmissionRequests(events);
+      bool delivered = false;
+
+      // relays forward key frame requests to the original media source
+      for (auto iter = relays->begin(); iter != relays->end(); ++iter) {
+        auto relay = (*iter).second.lock();
+        if (!relay) continue;
+        if (relay->notifySenderFeedback(mID, events)) result = true;
+      }
+
+      // only deliver to the channel(s) owning the targeted SSRCs
+      for (auto iter = channels->begin(); iter != channels->end(); ++iter)
+      {
+        auto params = (*iter).first;
+        auto channel = (*iter).second;
+
+        bool owned = false;
+        for (auto iterEvent = events.begin(); iterEvent != events.end(); ++iterEvent) {
+          if (hasSSRC(*params, (*iterEvent).mSSRC)) {
+            owned = true;
+            break;
+          }
+        }
+
+        if (!owned) continue;
+
+        ZS_EVENTING_5(
+                      x, i, Trace, RtpSenderDeliverIncomingPacketToChannel, ol, RtpSender, Deliver,
+                      puid, id, mID,
+                      enum, viaTransport, zsLib::to_underlying(viaTransport),
+                      enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
+                      buffer, packet, packet->ptr(),
+                      size, size, packet->size()
                       );
 
+        delivered = true;
         auto channelResult = channel->handle(packet);
         result = result || channelResult;
       }
 
+      if ((!delivered) &&
+          (channels->size() > 0)) {
+        // channel SSRCs were not yet resolved; fallback to all channels
+        return handlePacket(viaTransport, packet) || result;
+      }
+
       return result;
     }
 
@@ -943,8 +1296,8 @@ namespace ortc
                     puid, id, mID,
                     enum, sendOverTransport, zsLib::to_underlying(mSendRTPOverTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
       return rtpTransport->sendPacket(mSendRTPOverTransport, IICETypes::Component_RTP, packet->ptr(), packet->size());
@@ -954,6 +1307,8 @@ namespace ortc
     bool RTPSender::sendPacket(RTCPPacketPtr packet)
     {
       UseSecureTransportPtr rtcpTransport;
+      bool reducedSize = false;
+      String cname;
 
       {
         AutoRecursiveLock lock(*this);
@@ -964,6 +1319,10 @@ namespace ortc
         }
 
         rtcpTransport = mRTCPTransport;
+        if (mParameters) {
+          reducedSize = mParameters->mRTCP.mReducedSize;
+          cname = mParameters->mRTCP.mCName;
+        }
       }
 
       if (!rtcpTransport) {
@@ -971,18 +1330,31 @@ namespace ortc
         return false;
       }
 
-      ZS_LOG_TRACE(log("sending rtcp packet over secure transport") + ZS_PARAM("size", packet->size()));
+      const BYTE *buffer = packet->ptr();
+      size_t size = packet->size();
+
+      SecureByteBlockPtr compound;
+      if (!reducedSize) {
+        // rtcp-rsize was not negotiated thus must be sent as compound
+        compound = RTCPPacket::convertToCompound(buffer, size, cname);
+        if (compound) {
+          buffer = compound->BytePtr();
+          size = compound->SizeInBytes();
+        }
+      }
+
+      ZS_LOG_TRACE(log("sending rtcp packet over secure transport") + ZS_PARAM("size", size));
 
       ZS_EVENTING_5(
                     x, i, Trace, RtpSenderSendOutgoingPacket, ol, RtpSender, Send,
                     puid, id, mID,
                     enum, sendOverTransport, zsLib::to_underlying(mSendRTPOverTransport),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, buffer,
+                    size, size, size
                     );
 
-      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, buffer, size);
     }
 
     //-------------------------------------------------------------------------
@@ -1042,6 +1414,73 @@ namespace ortc
     #pragma mark RTPSender => IRTPSenderForMediaStreamTrack
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => IRTPSenderForRTPRelay
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPSender::ParametersPtr RTPSender::registerRelay(UseRelayPtr relay)
+    {
+      ZS_LOG_DEBUG(log("register relay") + ZS_PARAM("relay", relay->getID()))
+
+      AutoRecursiveLock lock(*this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot register relay while shutdown") + ZS_PARAM("relay", relay->getID()))
+        return ParametersPtr();
+      }
+
+      RelayWeakMapPtr replacementRelays = make_shared<RelayWeakMap>(*mRelays);
+      (*replacementRelays)[relay->getID()] = relay;
+      mRelays = replacementRelays;  // COW replacement
+
+      return mParameters;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::unregisterRelay(PUID relayID)
+    {
+      ZS_LOG_DEBUG(log("unregister relay") + ZS_PARAM("relay", relayID))
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mRelays->find(relayID);
+      if (found == mRelays->end()) return;
+
+      RelayWeakMapPtr replacementRelays = make_shared<RelayWeakMap>(*mRelays);
+      replacementRelays->erase(relayID);
+      mRelays = replacementRelays;  // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::sendRelayedPacket(RTPPacketPtr packet)
+    {
+      {
+        AutoRecursiveLock lock(*this);
+
+        if ((!isShutdown()) &&
+            (0 != mRetransmissionHistoryMaxPackets)) {
+          RetransmissionHistoryPtr history;
+
+          auto found = mRetransmissionHistories.find(packet->ssrc());
+          if (found == mRetransmissionHistories.end()) {
+            history = make_shared<RetransmissionHistory>(packet->ssrc(), mRetransmissionHistoryMaxPackets, mRetransmissionHistoryMaxBytes);
+            mRetransmissionHistories[packet->ssrc()] = history;
+          } else {
+            history = (*found).second;
+          }
+
+          history->store(packet);
+        }
+      }
+
+      return sendPacket(packet);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1416,6 +1855,19 @@ namespace ortc
       IHelper::debugAppend(resultEl, "track", mTrack ? mTrack->getID() : 0);
 
       IHelper::debugAppend(resultEl, "channels", mChannels->size());
+      IHelper::debugAppend(resultEl, "relays", mRelays->size());
+
+      IHelper::debugAppend(resultEl, "retransmission history max packets", mRetransmissionHistoryMaxPackets);
+      IHelper::debugAppend(resultEl, "retransmission history max bytes", mRetransmissionHistoryMaxBytes);
+      IHelper::debugAppend(resultEl, "retransmission min interval", mRetransmissionMinInterval);
+
+      if (mRetransmissionHistories.size() > 0) {
+        ElementPtr historiesEl = Element::create("retransmission histories");
+        for (auto iter = mRetransmissionHistories.begin(); iter != mRetransmissionHistories.end(); ++iter) {
+          IHelper::debugAppend(historiesEl, (*iter).second->toDebug());
+        }
+        IHelper::debugAppend(resultEl, historiesEl);
+      }
 
       IHelper::debugAppend(resultEl, "conflicts", mConflicts.size());
 
@@ -1489,6 +1941,10 @@ namespace ortc
       ParametersToChannelHolderMapPtr channels = ParametersToChannelHolderMapPtr(make_shared<ParametersToChannelHolderMap>());
       mChannels = channels;
 
+      mRelays = make_shared<RelayWeakMap>();
+
+      mRetransmissionHistories.clear();
+
       mSubscriptions.clear();
 
       if (mDefaultSubscription) {
@@ -1650,6 +2106,170 @@ namespace ortc
       return (*found).second;
     }
 
+    //-------------------------------------------------------------------------
+    void RTPSender::appendRetransmissionHistoryStats(StatsList &outStats) const
+    {
+      for (auto iter = mRetransmissionHistories.begin(); iter != mRetransmissionHistories.end(); ++iter) {
+        auto &history = *((*iter).second);
+
+        auto report = make_shared<IStatsReport::OutboundRTPStreamStats>();
+
+        report->mID = string(history.mSSRC) + "_send";
+
+        report->mSSRC = history.mSSRC;
+        report->mIsRemote = false;
+        report->mMediaType = mKind.hasValue() ? String(IMediaStreamTrackTypes::toString(mKind.value())) : String();
+        report->mNACKCount = history.mNACKCount;
+        report->mPacketsSent = history.mPacketsSent + history.mRetransmittedPacketsSent;
+        report->mBytesSent = history.mBytesSent + history.mRetransmittedBytesSent;
+        report->mRetransmittedPacketsSent = history.mRetransmittedPacketsSent;
+        report->mRetransmittedBytesSent = history.mRetransmittedBytesSent;
+
+        outStats.push_back(report);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::handleRetransmissionRequests(const FeedbackEventList &events)
+    {
+      typedef RTCPPacket::FeedbackEvent FeedbackEvent;
+
+      RTPPacketList retransmissions;
+      UseSecureTransportPtr rtpTransport;
+      bool handled = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mRetransmissionHistories.size() < 1) return false;
+
+        rtpTransport = mRTPTransport;
+
+        Time tick = zsLib::now();
+
+        for (auto iter = events.begin(); iter != events.end(); ++iter) {
+          auto &event = (*iter);
+          if (FeedbackEvent::Type_GenericNACK != event.mType) continue;
+
+          auto found = mRetransmissionHistories.find(event.mSSRC);
+          if (found == mRetransmissionHistories.end()) continue;
+
+          auto &history = *((*found).second);
+
+          handled = true;
+          ++history.mNACKCount;
+
+          // PID is always lost, each BLP bit marks PID + (bit + 1) as lost
+          for (size_t index = 0; index <= 16; ++index) {
+            if ((0 != index) &&
+                (0 == (event.mBLP & (1 << (index - 1))))) continue;
+
+            WORD sequenceNumber = static_cast<WORD>(event.mPID + index);
+
+            ++history.mPacketsRequested;
+
+            auto entry = history.find(sequenceNumber);
+            if (!entry) {
+              ++history.mPacketsMissing;
+              continue;
+            }
+
+            if (tick < entry->mLastRetransmitted + mRetransmissionMinInterval) continue;
+
+            auto retransmission = createRetransmission(history, entry->mPacket);
+            if (!retransmission) continue;
+
+            entry->mLastRetransmitted = tick;
+
+            ++history.mRetransmittedPacketsSent;
+            history.mRetransmittedBytesSent += retransmission->size();
+
+            retransmissions.push_back(retransmission);
+          }
+        }
+      }
+
+      if (retransmissions.size() < 1) return handled;
+
+      if (!rtpTransport) {
+        ZS_LOG_WARNING(Debug, log("no rtp transport is currently attached (thus discarding retransmissions)") + ZS_PARAM("total", retransmissions.size()))
+        return handled;
+      }
+
+      ZS_LOG_TRACE(log("retransmitting packets from history") + ZS_PARAM("total", retransmissions.size()))
+
+      for (auto iter = retransmissions.begin(); iter != retransmissions.end(); ++iter) {
+        auto &packet = (*iter);
+        rtpTransport->sendPacket(mSendRTPOverTransport, IICETypes::Component_RTP, packet->ptr(), packet->size());
+      }
+
+      return handled;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPSender::createRetransmission(
+                                                 RetransmissionHistory &history,
+                                                 RTPPacketPtr packet
+                                                 )
+    {
+      Optional<IRTPTypes::SSRCType> rtxSSRC;
+      Optional<IRTPTypes::PayloadType> rtxPayloadType;
+
+      if (mParameters) {
+        for (auto iter = mParameters->mEncodings.begin(); iter != mParameters->mEncodings.end(); ++iter) {
+          auto &encoding = (*iter);
+          if (!encoding.mSSRC.hasValue()) continue;
+          if (history.mSSRC != encoding.mSSRC.value()) continue;
+          if (!encoding.mRTX.hasValue()) continue;
+          if (!encoding.mRTX.value().mSSRC.hasValue()) continue;
+
+          rtxSSRC = encoding.mRTX.value().mSSRC.value();
+          break;
+        }
+
+        for (auto iter = mParameters->mCodecs.begin(); (rtxSSRC.hasValue()) && (iter != mParameters->mCodecs.end()); ++iter) {
+          auto &codec = (*iter);
+          if (IRTPTypes::SupportedCodec_RTX != IRTPTypes::toSupportedCodec(codec.mName)) continue;
+
+          auto rtxParams = IRTPTypes::RTXCodecParameters::convert(codec.mParameters);
+          if (!rtxParams) continue;
+          if (rtxParams->mApt != packet->pt()) continue;
+
+          rtxPayloadType = codec.mPayloadType;
+          break;
+        }
+      }
+
+      if ((!rtxSSRC.hasValue()) ||
+          (!rtxPayloadType.hasValue())) {
+        // without a negotiated RTX stream the original packet is resent as is
+        return packet;
+      }
+
+      // https://tools.ietf.org/html/rfc4588#section-4
+      size_t headerSize = static_cast<size_t>(packet->payload() - packet->ptr());
+      size_t payloadSize = packet->payloadSize();
+
+      SecureByteBlock buffer(headerSize + sizeof(WORD) + payloadSize);
+      BYTE *dest = buffer.BytePtr();
+
+      memcpy(dest, packet->ptr(), headerSize);
+
+      dest[0] = (dest[0] & 0xDF);                                   // padding is not retransmitted
+      dest[1] = (dest[1] & 0x80) | (rtxPayloadType.value() & 0x7F); // keep marker bit
+      RTPUtils::setBE16(&(dest[2]), history.mRTXSequenceNumber);
+      RTPUtils::setBE32(&(dest[8]), rtxSSRC.value());
+
+      RTPUtils::setBE16(&(dest[headerSize]), packet->sequenceNumber());  // original sequence number
+      if (0 != payloadSize) {
+        memcpy(&(dest[headerSize + sizeof(WORD)]), packet->payload(), payloadSize);
+      }
+
+      ++history.mRTXSequenceNumber;
+
+      return RTPPacket::create(buffer.BytePtr(), buffer.SizeInBytes());
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -216,6 +216,8 @@ namespace ortc
 
       setupTagging();
 
+      mCounters.updateParameters(params);
+
       ZS_EVENTING_3(
                     x, i, Detail, RtpSenderChannelCreate, ol, RtpSender, Start,
                     puid, id, mID,
@@ -390,7 +392,53 @@ namespace ortc
         mediaBase = mMediaBase;
       }
 
-      mediaBase->requestStats(promise, stats);
+      StatsTypeSet mediaStats;
+      if (!RTPStreamCounters::excludeStatsType(stats, IStatsReportTypes::StatsType_OutboundRTP, mediaStats)) {
+        mediaBase->requestStats(promise, stats);
+        return;
+      }
+
+      // outbound RTP stream stats come from the channel's own counters (which
+      // never contends with packet processing); only the remaining stats
+      // types need the media engine
+      UseStatsReport::StatMap countersStats;
+
+      auto outboundStats = createOutboundRTPStreamStats();
+      if (outboundStats) countersStats[outboundStats->mID] = outboundStats;
+
+      if (mediaStats.size() < 1) {
+        promise->resolve(UseStatsReport::create(countersStats));
+        return;
+      }
+
+      auto countersPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+      auto mediaPromise = PromiseWithStatsReport::create(IORTCForInternal::queueORTC());
+
+      UseStatsReport::PromiseWithStatsReportList promises;
+      promises.push_back(mediaPromise);
+      promises.push_back(countersPromise);
+
+      UseStatsReport::collectReports(promises, promise);
+
+      countersPromise->resolve(UseStatsReport::create(countersStats));
+      mediaBase->requestStats(mediaPromise, mediaStats);
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::OutboundRTPStreamStatsPtr RTPSenderChannel::sampleStats() const
+    {
+      RTPStreamCounters::Snapshot snapshot;
+      mCounters.snapshot(snapshot);
+
+      if ((0 == snapshot.mPackets) || (0 == snapshot.mSSRC)) return IStatsReportTypes::OutboundRTPStreamStatsPtr();
+
+      auto report = make_shared<IStatsReportTypes::OutboundRTPStreamStats>();
+
+      report->mID = string(snapshot.mSSRC) + "_send";
+      report->mIsRemote = false;
+
+      snapshot.applyTo(*report);
+      return report;
     }
 
     //-------------------------------------------------------------------------
@@ -401,10 +449,12 @@ namespace ortc
                     puid, id, mID,
                     puid, mediaBaseId, mMediaBase->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
+      mCounters.notifyIncomingRTCP(*packet);
+
       if (mIsTagging)
       {
         for (auto rr = packet->firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport())
@@ -512,35 +562,18 @@ namespace ortc
         if (!tagInfo->mReceiverAck) {
           tagInfo->mSequenceNumberLast = packet->sequenceNumber();
 
-          auto oldHeaderExtensions = packet->mHeaderExtensions; // remember old pointer temporarily
-
-          RTPPacket::StringHeaderExtension muxHeader(mMuxHeader ? mMuxHeader->mID : 0, mMuxID.c_str());
-          RTPPacket::StringHeaderExtension ridHeader(mRIDHeader ? mRIDHeader->mID : 0, mRID.c_str());
-
-          // Re-point extenion headers in RTP packet to first point to MuxID or
-          // RID or both.
-          if (mMuxID.hasData()) {
-            if (mRID.hasData()) {
-              muxHeader.mNext = &ridHeader;
-              ridHeader.mNext = oldHeaderExtensions;
-              packet->mHeaderExtensions = &muxHeader;
-            } else {
-              muxHeader.mNext = oldHeaderExtensions;
-              packet->mHeaderExtensions = &muxHeader;
-            }
-          } else {
-            ridHeader.mNext = oldHeaderExtensions;
-            packet->mHeaderExtensions = &ridHeader;
+          // MID ends up first as each extension is inserted at the front of
+          // the extension block (using the packet's reserved headroom)
+          if ((mRIDHeader) &&
+              (mRID.hasData())) {
+            RTPPacket::StringHeaderExtension ridHeader(mRIDHeader->mID, mRID.c_str());
+            packet->setHeaderExtension(ridHeader);
+          }
+          if ((mMuxHeader) &&
+              (mMuxID.hasData())) {
+            RTPPacket::StringHeaderExtension muxHeader(mMuxHeader->mID, mMuxID.c_str());
+            packet->setHeaderExtension(muxHeader);
           }
-
-          RTPPacketPtr newPacket = RTPPacket::create(*packet);
-
-          // Put back old pointer to prevent crash during free of old packet.
-          packet->mHeaderExtensions = oldHeaderExtensions;
-
-          // Replace old packet with new packet that will have additional
-          // extension headers.
-          packet = newPacket;
         }
       }
 
@@ -549,10 +582,12 @@ namespace ortc
                     puid, id, mID,
                     puid, senderId, sender->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
+      mCounters.notifySent(*packet);
+
       return sender->sendPacket(packet);
     }
 
@@ -567,8 +602,8 @@ namespace ortc
                     puid, id, mID,
                     puid, senderId, sender->getID(),
                     enum, packetType, zsLib::to_underlying(IICETypes::Component_RTCP),
-                    buffer, packet, packet->buffer()->BytePtr(),
-                    size, size, packet->buffer()->SizeInBytes()
+                    buffer, packet, packet->ptr(),
+                    size, size, packet->size()
                     );
 
       if ((mIsTagging) &&
@@ -629,6 +664,8 @@ namespace ortc
         packet = newPacket;
       }
 
+      mCounters.notifySenderReportsSent(*packet);
+
       return sender->sendPacket(packet);
     }
 
@@ -672,13 +709,14 @@ namespace ortc
     int32_t RTPSenderChannel::sendAudioSamples(
                                                const void* audioSamples,
                                                const size_t numberOfSamples,
-                                               const uint8_t numberOfChannels
+                                               const uint8_t numberOfChannels,
+                                               const uint32_t samplesPerSecond
                                                )
     {
 #define TODO_VERIFY_RESULT 1
 #define TODO_VERIFY_RESULT 2
       if (!mAudio) return 0;
-      return mAudio->sendAudioSamples(audioSamples, numberOfSamples, numberOfChannels);
+      return mAudio->sendAudioSamples(audioSamples, numberOfSamples, numberOfChannels, samplesPerSecond);
     }
 
     //-------------------------------------------------------------------------
@@ -797,6 +835,8 @@ namespace ortc
         mParameters = params;
         mediaBase = mMediaBase;
 
+        mCounters.updateParameters(*mParameters);
+
         Optional<IMediaStreamTrackTypes::Kinds> kind = RTPTypesHelper::getCodecsKind(*mParameters);
         
         bool found = false;
@@ -964,6 +1004,37 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::OutboundRTPStreamStatsPtr RTPSenderChannel::createOutboundRTPStreamStats()
+    {
+      RTPStreamCounters::Snapshot snapshot;
+      mCounters.snapshot(snapshot);
+
+      if ((0 == snapshot.mPackets) || (0 == snapshot.mSSRC)) return IStatsReportTypes::OutboundRTPStreamStatsPtr();
+
+      auto report = make_shared<IStatsReportTypes::OutboundRTPStreamStats>();
+
+      report->mID = string(snapshot.mSSRC) + "_send";
+      report->mIsRemote = false;
+      report->mMediaType = (mAudio ? "audio" : "video");
+
+      snapshot.applyTo(*report);
+
+      AutoRecursiveLock lock(*this);
+
+      auto track = MediaStreamTrack::convert(mTrack);
+      if (track) report->mMediaTrackID = IMediaStreamTrackPtr(track)->id();
+
+      if (mParameters) {
+        RTPTypesHelper::FindCodecOptions options;
+        options.mPayloadType = snapshot.mPayloadType;
+        auto codec = RTPTypesHelper::findCodec(*mParameters, options);
+        if (codec) report->mCodecID = codec->mName;
+      }
+
+      return report;
+    }
+
     //-------------------------------------------------------------------------
     void RTPSenderChannel::setupTagging()
     {
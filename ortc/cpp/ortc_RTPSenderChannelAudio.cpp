@@ -30,6 +30,7 @@
  */
 
 #include <ortc/internal/ortc_RTPSenderChannelAudio.h>
+#include <ortc/internal/ortc_AudioRingBuffer.h>
 #include <ortc/internal/ortc_RTPSenderChannel.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
 #include <ortc/internal/ortc_RTPPacket.h>
@@ -78,8 +79,26 @@ namespace ortc
     #pragma mark (helpers)
     #pragma mark
 
+    // external audio is pumped every 10ms but allow catching up if the
+    // timer was late
+    static const size_t kMaxExternalAudioFramesPerTimer {5};
 
-    
+    static const uint32_t kMinExternalAudioSamplesPerSecond {8000};
+    static const uint32_t kMaxExternalAudioSamplesPerSecond {48000};
+    static const uint8_t kMaxExternalAudioChannels {2};
+
+    //-------------------------------------------------------------------------
+    static size_t externalAudioBufferSizeInSamples(const char *setting)
+    {
+      size_t milliseconds = ISettings::getUInt(setting);
+      if (milliseconds < 10) milliseconds = 10;
+      return (kMaxExternalAudioSamplesPerSecond * kMaxExternalAudioChannels * milliseconds) / 1000;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -115,6 +134,7 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setUInt(ORTC_SETTING_RTP_SENDER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS, 200);
       }
       
     };
@@ -195,7 +215,8 @@ namespace ortc
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mSenderChannel(senderChannel),
       mTrack(track),
-      mParameters(make_shared<Parameters>(params))
+      mParameters(make_shared<Parameters>(params)),
+      mExternalAudio(make_shared<AudioRingBuffer>(externalAudioBufferSizeInSamples(ORTC_SETTING_RTP_SENDER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS)))
     {
       ZS_LOG_DETAIL(debug("created"))
 
@@ -432,11 +453,35 @@ namespace ortc
     int32_t RTPSenderChannelAudio::sendAudioSamples(
                                                     const void* audioSamples,
                                                     const size_t numberOfSamples,
-                                                    const uint8_t numberOfChannels
+                                                    const uint8_t numberOfChannels,
+                                                    const uint32_t samplesPerSecond
                                                     )
     {
-#define TODO_IMPLEMENT_THIS 1
-#define TODO_IMPLEMENT_THIS 2
+      // NOTE: called on the application's capture thread; must never block
+
+      if ((NULL == audioSamples) ||
+          (0 == numberOfSamples)) return 0;
+
+      if ((numberOfChannels < 1) ||
+          (numberOfChannels > kMaxExternalAudioChannels) ||
+          (samplesPerSecond < kMinExternalAudioSamplesPerSecond) ||
+          (samplesPerSecond > kMaxExternalAudioSamplesPerSecond)) {
+        ZS_LOG_WARNING(Trace, log("external audio format is not supported") + ZS_PARAM("channels", static_cast<size_t>(numberOfChannels)) + ZS_PARAM("samples per second", samplesPerSecond))
+        return -1;
+      }
+
+      // the consumer drops anything buffered in the old format
+      mExternalAudioFormat = (static_cast<DWORD>(samplesPerSecond) << 8) | static_cast<DWORD>(numberOfChannels);
+
+      size_t totalSamples = numberOfSamples * numberOfChannels;
+      if (0 == mExternalAudio->write(static_cast<const int16_t *>(audioSamples), totalSamples)) {
+        mExternalAudioDroppedSamples += totalSamples;
+      }
+
+      if (!mExternalAudioStarted.exchange(true)) {
+        auto pThis = mThisWeak.lock();
+        if (pThis) IWakeDelegateProxy::create(pThis)->onWake();
+      }
       return 0;
     }
 
@@ -555,11 +600,26 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPSenderChannelAudio::onTimer(ITimerPtr timer)
     {
-      ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
+      ZS_LOG_INSANE(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
-      AutoRecursiveLock lock(*this);
-#define TODO 1
-#define TODO 2
+      UseChannelResourcePtr channelResource;
+      uint32_t sendSamplesPerSecond {};
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mExternalAudioTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+          return;
+        }
+
+        channelResource = mChannelResource;
+        sendSamplesPerSecond = getSendSamplesPerSecond();
+      }
+
+      if (!channelResource) return;
+
+      pumpExternalAudio(channelResource, sendSamplesPerSecond);
     }
 
     //-------------------------------------------------------------------------
@@ -636,7 +696,7 @@ namespace ortc
     {
       auto channel = mSenderChannel.lock();
       if (!channel) return false;
-      return channel->sendPacket(RTPPacket::create(packet, length));
+      return channel->sendPacket(RTPPacket::create(packet, length, RTPPacket::kDefaultHeaderExtensionHeadroom));
     }
     
     //-------------------------------------------------------------------------
@@ -753,6 +813,12 @@ namespace ortc
       auto senderChannel = mSenderChannel.lock();
       IHelper::debugAppend(resultEl, "sender channel", senderChannel ? senderChannel->getID() : 0);
 
+      IHelper::debugAppend(resultEl, "external audio", mExternalAudio ? mExternalAudio->toDebug() : ElementPtr());
+      IHelper::debugAppend(resultEl, "external audio format", static_cast<DWORD>(mExternalAudioFormat));
+      IHelper::debugAppend(resultEl, "external audio started", static_cast<bool>(mExternalAudioStarted));
+      IHelper::debugAppend(resultEl, "external audio dropped samples", static_cast<size_t>(mExternalAudioDroppedSamples));
+      IHelper::debugAppend(resultEl, "external audio timer", mExternalAudioTimer ? mExternalAudioTimer->getID() : 0);
+
       return resultEl;
     }
 
@@ -782,6 +848,7 @@ namespace ortc
 
       // ... other steps here ...
       if (!stepSetupChannel()) goto not_ready;
+      if (!stepExternalAudio()) goto not_ready;
       // ... other steps here ...
 
       goto ready;
@@ -833,6 +900,25 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPSenderChannelAudio::stepExternalAudio()
+    {
+      if (mExternalAudioTimer) {
+        ZS_LOG_TRACE(log("already pumping external audio"))
+        return true;
+      }
+
+      if (!mExternalAudioStarted) {
+        ZS_LOG_TRACE(log("no external audio is being injected"))
+        return true;
+      }
+
+      mExternalAudioTimer = ITimer::create(mThisWeak.lock(), Milliseconds(10));
+
+      ZS_LOG_DEBUG(log("started pumping external audio") + ZS_PARAM("timer id", mExternalAudioTimer->getID()))
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     void RTPSenderChannelAudio::cancel()
     {
@@ -843,6 +929,11 @@ namespace ortc
 
       setState(State_ShuttingDown);
 
+      if (mExternalAudioTimer) {
+        mExternalAudioTimer->cancel();
+        mExternalAudioTimer.reset();
+      }
+
       if (!mGracefulShutdownReference) mGracefulShutdownReference = mThisWeak.lock();
 
       if (!mCloseChannelPromise) {
@@ -909,6 +1000,87 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    uint32_t RTPSenderChannelAudio::getSendSamplesPerSecond() const
+    {
+      uint32_t result = kMaxExternalAudioSamplesPerSecond;
+
+      if (mParameters) {
+        for (auto iter = mParameters->mCodecs.begin(); iter != mParameters->mCodecs.end(); ++iter) {
+          auto &codec = (*iter);
+          auto supportedCodec = IRTPTypes::toSupportedCodec(codec.mName);
+          if (IRTPTypes::CodecKind_Audio != IRTPTypes::getCodecKind(supportedCodec)) continue;
+
+          if (IRTPTypes::SupportedCodec_G722 == supportedCodec) {
+            // RTP clock rate is 8000 for historic reasons (RFC 3551) but the
+            // codec samples at 16000
+            result = 16000;
+            break;
+          }
+          if (codec.mClockRate.hasValue()) result = static_cast<uint32_t>(codec.mClockRate.value());
+          break;
+        }
+      }
+
+      if (result < kMinExternalAudioSamplesPerSecond) result = kMinExternalAudioSamplesPerSecond;
+      if (result > kMaxExternalAudioSamplesPerSecond) result = kMaxExternalAudioSamplesPerSecond;
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSenderChannelAudio::pumpExternalAudio(
+                                                  UseChannelResourcePtr channelResource,
+                                                  uint32_t sendSamplesPerSecond
+                                                  )
+    {
+      DWORD format = mExternalAudioFormat;
+      if (0 == format) return;
+
+      if (format != mExternalAudioConsumerFormat) {
+        if (0 != mExternalAudioConsumerFormat) {
+          size_t flushed = mExternalAudio->skip(mExternalAudio->available());
+          ZS_LOG_DEBUG(log("external audio format changed (dropping buffered audio)") + ZS_PARAM("flushed samples", flushed))
+        }
+        mExternalAudioConsumerFormat = format;
+      }
+
+      uint32_t samplesPerSecond = static_cast<uint32_t>(format >> 8);
+      size_t channels = static_cast<size_t>(format & 0xFF);
+
+      // always pump complete 10ms frames
+      size_t inSamplesPerChannel = samplesPerSecond / 100;
+      size_t inTotal = inSamplesPerChannel * channels;
+      size_t outSamplesPerChannel = sendSamplesPerSecond / 100;
+      size_t outTotal = outSamplesPerChannel * channels;
+
+      if (mExternalAudioFrame.size() < inTotal) mExternalAudioFrame.resize(inTotal);
+      if (mExternalAudioResampled.size() < outTotal) mExternalAudioResampled.resize(outTotal);
+
+      for (size_t frames = 0; frames < kMaxExternalAudioFramesPerTimer; ++frames) {
+        if (mExternalAudio->available() < inTotal) break;
+
+        mExternalAudio->read(&(mExternalAudioFrame[0]), inTotal);
+
+        if (samplesPerSecond == sendSamplesPerSecond) {
+          channelResource->sendAudioFrame(&(mExternalAudioFrame[0]), inSamplesPerChannel, channels, samplesPerSecond);
+          continue;
+        }
+
+        if (0 != mExternalAudioResampler.InitializeIfNeeded(static_cast<int>(samplesPerSecond), static_cast<int>(sendSamplesPerSecond), channels)) {
+          ZS_LOG_WARNING(Debug, log("unable to initialize external audio resampler") + ZS_PARAM("from", samplesPerSecond) + ZS_PARAM("to", sendSamplesPerSecond) + ZS_PARAM("channels", channels))
+          return;
+        }
+
+        int resampled = mExternalAudioResampler.Resample(&(mExternalAudioFrame[0]), inTotal, &(mExternalAudioResampled[0]), outTotal);
+        if (resampled != static_cast<int>(outTotal)) {
+          ZS_LOG_WARNING(Debug, log("failed to resample external audio") + ZS_PARAM("result", resampled) + ZS_PARAM("expecting", outTotal))
+          return;
+        }
+
+        channelResource->sendAudioFrame(&(mExternalAudioResampled[0]), outSamplesPerChannel, channels, sendSamplesPerSecond);
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
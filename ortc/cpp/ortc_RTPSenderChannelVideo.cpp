@@ -460,7 +460,7 @@ namespace ortc
     {
       auto channel = mSenderChannel.lock();
       if (!channel) return false;
-      return channel->sendPacket(RTPPacket::create(packet, length));
+      return channel->sendPacket(RTPPacket::create(packet, length, RTPPacket::kDefaultHeaderExtensionHeadroom));
     }
 
     //-------------------------------------------------------------------------
@@ -1970,12 +1970,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::DegradationPreferences IRTPTypes::toDegredationPreference(const char *preference) throw (InvalidParameters)
   {
-    String str(preference);
-    for (IRTPTypes::DegradationPreferences index = IRTPTypes::DegradationPreference_First; index <= IRTPTypes::DegradationPreference_Last; index = static_cast<IRTPTypes::DegradationPreferences>(static_cast<std::underlying_type<IRTPTypes::DegradationPreferences>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IRTPTypes::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<IRTPTypes::DegradationPreferences> table(IRTPTypes::DegradationPreference_First, IRTPTypes::DegradationPreference_Last, IRTPTypes::toString, false);
+
+    IRTPTypes::DegradationPreferences result {};
+    if (table.find(preference, result)) return result;
 
-    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + str)
+    ORTC_THROW_INVALID_PARAMETERS("Invalid parameter value: " + String(preference))
     return DegradationPreference_First;
   }
 
@@ -2500,12 +2500,12 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::OpusCodecParameters::Signals IRTPTypes::OpusCodecCapabilityOptions::toSignal(const char *signal)
   {
-    String signalStr(signal);
-    if (signalStr.isEmpty()) return Signal_Auto;
+    if ((!signal) || ('\0' == *signal)) return Signal_Auto;
 
-    for (Signals index = Signal_First; index <= Signal_Last; index = static_cast<Signals>(static_cast<std::underlying_type<Signals>::type>(index) + 1)) {
-      if (0 == signalStr.compareNoCase(IRTPTypes::OpusCodecCapabilityOptions::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<Signals> table(Signal_First, Signal_Last, IRTPTypes::OpusCodecCapabilityOptions::toString, false);
+
+    Signals result {};
+    if (table.find(signal, result)) return result;
 
     ORTC_THROW_INVALID_PARAMETERS((String("unknown signal: ") + signal).c_str())
   }
@@ -2525,14 +2525,14 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::OpusCodecParameters::Applications IRTPTypes::OpusCodecCapabilityOptions::toApplication(const char *application)
   {
-    String applicationStr(application);
-    if (applicationStr.isEmpty()) return Application_VoIP;
+    if ((!application) || ('\0' == *application)) return Application_VoIP;
 
-    for (Applications index = Application_First; index <= Application_Last; index = static_cast<Applications>(static_cast<std::underlying_type<Applications>::type>(index) + 1)) {
-      if (0 == applicationStr.compareNoCase(IRTPTypes::OpusCodecCapabilityOptions::toString(index))) return index;
-    }
+    static const internal::EnumStringTable<Applications> table(Application_First, Application_Last, IRTPTypes::OpusCodecCapabilityOptions::toString, false);
+
+    Applications result {};
+    if (table.find(application, result)) return result;
 
-    ORTC_THROW_INVALID_PARAMETERS((String("unknown application: ") + applicationStr).c_str())
+    ORTC_THROW_INVALID_PARAMETERS((String("unknown application: ") + application).c_str())
   }
 
   //---------------------------------------------------------------------------
@@ -3021,11 +3021,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::FlexFECCodecCapabilityParameters::ToPs IRTPTypes::FlexFECCodecCapabilityParameters::toToP(const char *top)
   {
-    String topStr(top);
+    static const internal::EnumStringTable<ToPs> table(ToP_First, ToP_Last, IRTPTypes::FlexFECCodecCapabilityParameters::toString);
 
-    for (ToPs index = ToP_First; index <= ToP_Last; index = static_cast<ToPs>(static_cast<std::underlying_type<ToPs>::type>(index) + 1)) {
-      if (topStr == IRTPTypes::FlexFECCodecCapabilityParameters::toString(index)) return index;
-    }
+    ToPs result {};
+    if (table.find(top, result)) return result;
 
     return ToP_Reserved;
   }
@@ -4119,11 +4118,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::PriorityTypes IRTPTypes::toPriorityType(const char *type)
   {
-    String typeStr(type);
+    static const internal::EnumStringTable<PriorityTypes> table(PriorityType_First, PriorityType_Last, IRTPTypes::toString);
 
-    for (PriorityTypes index = PriorityType_First; index <= PriorityType_Last; index = static_cast<PriorityTypes>(static_cast<std::underlying_type<PriorityTypes>::type>(index) + 1)) {
-      if (typeStr == IRTPTypes::toString(index)) return index;
-    }
+    PriorityTypes result {};
+    if (table.find(type, result)) return result;
 
     return PriorityType_Unknown;
   }
@@ -4307,11 +4305,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::CodecKinds IRTPTypes::toCodecKind(const char *kind)
   {
-    String kindStr(kind);
+    static const internal::EnumStringTable<CodecKinds> table(CodecKind_First, CodecKind_Last, IRTPTypes::toString);
 
-    for (CodecKinds index = CodecKind_First; index <= CodecKind_Last; index = static_cast<CodecKinds>(static_cast<std::underlying_type<CodecKinds>::type>(index) + 1)) {
-      if (kindStr == IRTPTypes::toString(index)) return index;
-    }
+    CodecKinds result {};
+    if (table.find(kind, result)) return result;
 
     return CodecKind_Unknown;
   }
@@ -4358,11 +4355,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::SupportedCodecs IRTPTypes::toSupportedCodec(const char *codec)
   {
-    String codecStr(codec);
+    static const internal::EnumStringTable<SupportedCodecs> table(SupportedCodec_First, SupportedCodec_Last, IRTPTypes::toString, false);
 
-    for (SupportedCodecs index = SupportedCodec_First; index <= SupportedCodec_Last; index = static_cast<SupportedCodecs>(static_cast<std::underlying_type<SupportedCodecs>::type>(index) + 1)) {
-      if (0 == codecStr.compareNoCase(IRTPTypes::toString(index))) return index;
-    }
+    SupportedCodecs result {};
+    if (table.find(codec, result)) return result;
 
     return SupportedCodec_Unknown;
   }
@@ -4933,11 +4929,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::HeaderExtensionURIs IRTPTypes::toHeaderExtensionURI(const char *uri)
   {
-    String uriStr(uri);
+    static const internal::EnumStringTable<HeaderExtensionURIs> table(HeaderExtensionURI_First, HeaderExtensionURI_Last, IRTPTypes::toString);
 
-    for (HeaderExtensionURIs index = HeaderExtensionURI_First; index <= HeaderExtensionURI_Last; index = static_cast<HeaderExtensionURIs>(static_cast<std::underlying_type<HeaderExtensionURIs>::type>(index) + 1)) {
-      if (uriStr == IRTPTypes::toString(index)) return index;
-    }
+    HeaderExtensionURIs result {};
+    if (table.find(uri, result)) return result;
 
     return HeaderExtensionURI_Unknown;
   }
@@ -4987,11 +4982,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::KnownFECMechanisms IRTPTypes::toKnownFECMechanism(const char *mechanism)
   {
-    String mechanismStr(mechanism);
+    static const internal::EnumStringTable<KnownFECMechanisms> table(KnownFECMechanism_First, KnownFECMechanism_Last, IRTPTypes::toString);
 
-    for (KnownFECMechanisms index = KnownFECMechanism_First; index <= KnownFECMechanism_Last; index = static_cast<KnownFECMechanisms>(static_cast<std::underlying_type<KnownFECMechanisms>::type>(index) + 1)) {
-      if (mechanismStr == IRTPTypes::toString(index)) return index;
-    }
+    KnownFECMechanisms result {};
+    if (table.find(mechanism, result)) return result;
 
     return KnownFECMechanism_Unknown;
   }
@@ -5028,11 +5022,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::KnownFeedbackTypes IRTPTypes::toKnownFeedbackType(const char *type)
   {
-    String typeStr(type);
+    static const internal::EnumStringTable<KnownFeedbackTypes> table(KnownFeedbackType_First, KnownFeedbackType_Last, IRTPTypes::toString, false);
 
-    for (KnownFeedbackTypes index = KnownFeedbackType_First; index <= KnownFeedbackType_Last; index = static_cast<KnownFeedbackTypes>(static_cast<std::underlying_type<KnownFeedbackTypes>::type>(index) + 1)) {
-      if (0 == typeStr.compareNoCase(IRTPTypes::toString(index))) return index;
-    }
+    KnownFeedbackTypes result {};
+    if (table.find(type, result)) return result;
 
     return KnownFeedbackType_Unknown;
   }
@@ -5071,11 +5064,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::KnownFeedbackParameters IRTPTypes::toKnownFeedbackParameter(const char *mechanism)
   {
-    String mechanismStr(mechanism);
+    static const internal::EnumStringTable<KnownFeedbackParameters> table(KnownFeedbackParameter_First, KnownFeedbackParameter_Last, IRTPTypes::toString, false);
 
-    for (KnownFeedbackParameters index = KnownFeedbackParameter_First; index <= KnownFeedbackParameter_Last; index = static_cast<KnownFeedbackParameters>(static_cast<std::underlying_type<KnownFeedbackParameters>::type>(index) + 1)) {
-      if (0 == mechanismStr.compareNoCase(IRTPTypes::toString(index))) return index;
-    }
+    KnownFeedbackParameters result {};
+    if (table.find(mechanism, result)) return result;
 
     return KnownFeedbackParameter_Unknown;
   }
@@ -5141,11 +5133,10 @@ namespace ortc
   //---------------------------------------------------------------------------
   IRTPTypes::SupportedRTCPMechanisms IRTPTypes::toSupportedRTCPMechanism(const char *mechanism)
   {
-    String mechanismStr(mechanism);
+    static const internal::EnumStringTable<SupportedRTCPMechanisms> table(SupportedRTCPMechanism_First, SupportedRTCPMechanism_Last, IRTPTypes::toString, false);
 
-    for (SupportedRTCPMechanisms index = SupportedRTCPMechanism_First; index <= SupportedRTCPMechanism_Last; index = static_cast<SupportedRTCPMechanisms>(static_cast<std::underlying_type<SupportedRTCPMechanisms>::type>(index) + 1)) {
-      if (0 == mechanismStr.compareNoCase(IRTPTypes::toString(index))) return index;
-    }
+    SupportedRTCPMechanisms result {};
+    if (table.find(mechanism, result)) return result;
 
     return SupportedRTCPMechanism_Unknown;
   }
@@ -37,6 +37,7 @@
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -738,7 +739,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void SCTPTransport::init()
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       //IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
 
       ZS_LOG_DETAIL(debug("SCTP init"))
@@ -871,7 +872,7 @@ namespace ortc
       tearAwayData->mListener = listener;
       tearAwayData->mDelegate = delegate;
 
-      AutoRecursiveLock lock(*pThis);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *pThis);
       pThis->mTearAway = tearAway;
       pThis->mLocalPort = inLocalPort;
       pThis->mAllocatedLocalPort = allocatedLocalPort;
@@ -882,7 +883,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ISCTPTransportTypes::States SCTPTransport::state() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       return mLastReportedState;
     }
 
@@ -915,7 +916,7 @@ namespace ortc
     {
       auto promise = PromiseWithSocketOptions::create(IORTCForInternal::queueDelegate());
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if ((isShuttingDown()) ||
           (isShutdown())) {
         promise->reject(ErrorAny::create(UseHTTP::HTTPStatusCode_Gone, "transport is closing or closed"));
@@ -943,7 +944,7 @@ namespace ortc
     {
       auto promise = Promise::create(IORTCForInternal::queueDelegate());
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if ((isShuttingDown()) ||
           (isShutdown())) {
@@ -986,7 +987,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("start called") + remoteCapabilities.toDebug());
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if ((isShuttingDown()) ||
           (isShutdown())) {
         ORTC_THROW_INVALID_STATE("already shutting down");
@@ -1055,7 +1056,7 @@ namespace ortc
       ZS_EVENTING_1(x, i, Detail, SctpTransportStop, ol, SctpTransport, Stop, puid, id, mID);
       ZS_LOG_DEBUG(log("stop called"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -1064,7 +1065,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ISCTPTransportSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
 
@@ -1106,7 +1107,7 @@ namespace ortc
                                                WORD &ioSessionID
                                                )
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       UseDataChannelPtr dataChannel = ioDataChannel;
       WORD sessionID = ioSessionID;
@@ -1214,7 +1215,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("datachannel subscribing to SCTP Transport"))
       
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       
       ISCTPTransportForDataChannelSubscriptionPtr subscription = mDataChannelSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueORTC());
       
@@ -1250,7 +1251,7 @@ namespace ortc
       ZS_THROW_INVALID_ARGUMENT_IF(!dataChannel)
       ZS_THROW_INVALID_ARGUMENT_IF(!params)
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       auto found = mSessions.find(params->mID.value());
       if (found == mSessions.end()) {
@@ -1294,7 +1295,7 @@ namespace ortc
 
       ZS_DECLARE_TYPEDEF_PTR(ISCTPTransportForDataChannel::RejectReason, RejectReason)
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if ((isShuttingDown()) ||
             (isShutdown())) {
@@ -1349,7 +1350,7 @@ namespace ortc
                     word, sessionId, sessionID
                     );
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (isShutdown()) {
         ZS_LOG_WARNING(Trace, log("already shutdown transport"))
@@ -1459,7 +1460,7 @@ namespace ortc
       }
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         {
           if (isShutdown()) {
@@ -1553,7 +1554,7 @@ namespace ortc
       ZS_EVENTING_1(x, i, Detail, SctpTransportInternalWakeEvent, ol, SctpTransport, InternalEvent, puid, id, mID);
       ZS_LOG_DEBUG(log("wake"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1608,7 +1609,7 @@ namespace ortc
         const sctp_notification &notification = reinterpret_cast<const sctp_notification&>(*(packet->mBuffer->BytePtr()));
         ZS_THROW_INVALID_ASSUMPTION_IF(notification.sn_header.sn_length != packet->mBuffer->SizeInBytes())
 
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
         handleNotificationPacket(notification);
         return;
       }
@@ -1616,7 +1617,7 @@ namespace ortc
       UseDataChannelPtr dataChannel;
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         // scope: check active sessions
         {
@@ -1688,7 +1689,7 @@ namespace ortc
     {
       ZS_LOG_TRACE(log("on notified to shutdown"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       cancel();
     }
 
@@ -1715,7 +1716,7 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("secure transport state changed") + ZS_PARAM("secure transport id", transport->getID()) + ZS_PARAM("state", ISecureTransportTypes::toString(state)))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       step();
     }
 
@@ -1751,7 +1752,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr SCTPTransport::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::SCTPTransport");
 
@@ -2743,7 +2744,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool SCTPTransport::internalGetOptions(SocketOptions &ioOptions) const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (!mSocket) return false;
 
@@ -2918,7 +2919,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool SCTPTransport::internalSetOptions(const SocketOptions &inOptions)
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       if (!mSocket) return false;
 
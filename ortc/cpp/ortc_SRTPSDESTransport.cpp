@@ -227,6 +227,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(SRTPSDESTransport, object);
     }
 
+    //-------------------------------------------------------------------------
+    SRTPSDESTransportPtr SRTPSDESTransport::convert(ForRTPCapturePtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(SRTPSDESTransport, object);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -502,6 +508,22 @@ namespace ortc
       return RTPListener::convert(mRTPListener);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPSDESTransport => ISecureTransportForRTPCapture
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPCaptureRingPtr SRTPSDESTransport::getCaptureRing() const
+    {
+      AutoRecursiveLock lock(*this);
+      if (!mSRTPTransport) return RTPCaptureRingPtr();
+      return mSRTPTransport->getCaptureRing();
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
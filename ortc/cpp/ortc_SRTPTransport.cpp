@@ -31,10 +31,14 @@
 
 #include <ortc/internal/ortc_SRTPTransport.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
+#include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPCapture.h>
 #include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.events.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/platform.h>
 
 #include <ortc/IHelper.h>
@@ -124,6 +128,49 @@ namespace ortc
       // still small amount of lifetime remaining
       return 1;
     }
+
+    //-------------------------------------------------------------------------
+    static bool classifyRTCP(
+                             const BYTE *buffer,
+                             size_t bufferLengthInBytes,
+                             bool &outCompound,
+                             bool &outFeedback,
+                             bool &outPadding
+                             )
+    {
+      outCompound = false;
+      outFeedback = false;
+      outPadding = false;
+
+      const BYTE *pos = buffer;
+      size_t remaining = bufferLengthInBytes;
+
+      if (remaining < sizeof(DWORD)) return false;
+
+      // RFC 3550 section 6.1 - compound packets must start with SR / RR
+      outCompound = ((RTCPPacket::SenderReport::kPayloadType == pos[1]) ||
+                     (RTCPPacket::ReceiverReport::kPayloadType == pos[1]));
+
+      while (remaining >= sizeof(DWORD)) {
+        if (2 != ((pos[0] >> 6) & 0x3)) return false;
+
+        size_t length = sizeof(DWORD) + (static_cast<size_t>(RTPUtils::getBE16(&(pos[2]))) * sizeof(DWORD));
+        if (length > remaining) return false;
+
+        if (0 != (pos[0] & 0x20)) outPadding = true;
+
+        switch (pos[1]) {
+          case RTCPPacket::TransportLayerFeedbackMessage::kPayloadType:
+          case RTCPPacket::PayloadSpecificFeedbackMessage::kPayloadType:  outFeedback = true; break;
+          default:                                                        break;
+        }
+
+        pos += length;
+        remaining -= length;
+      }
+
+      return (0 == remaining);
+    }
     
 
     //-------------------------------------------------------------------------
@@ -161,6 +208,12 @@ namespace ortc
       //-----------------------------------------------------------------------
       virtual void notifySettingsApplyDefaults() override
       {
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_WINDOW_IN_MILLISECONDS, 0);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_RTCP_COMPOUND_PACKET_SIZE, 1200);
+
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_BUFFER_SIZE_IN_BYTES, 0);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_SNAP_LENGTH_IN_BYTES, 256);
+        ISettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_RTP_PAYLOAD_BYTES, 16);
       }
       
     };
@@ -419,7 +472,14 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mSecureTransport(secureTransport),
-      mSRTPInit(SRTPInit::singleton())
+      mRTCPAggregationWindow(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_WINDOW_IN_MILLISECONDS)),
+      mMaxRTCPCompoundPacketSize(SafeInt<decltype(mMaxRTCPCompoundPacketSize)>(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_RTCP_COMPOUND_PACKET_SIZE))),
+      mSRTPInit(SRTPInit::singleton()),
+      mCaptureRing(RTPCaptureRing::create(
+                                          SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_BUFFER_SIZE_IN_BYTES)),
+                                          SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_SNAP_LENGTH_IN_BYTES)),
+                                          SafeInt<size_t>(ISettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_RTP_PAYLOAD_BYTES))
+                                          ))
     {
       ZS_EVENTING_2(
                     x, i, Detail, SrtpTransportCreate, ol, SrtpTransport, Start,
@@ -638,7 +698,7 @@ namespace ortc
     {
       ZS_LOG_DETAIL(log("subscribing to transport state"))
 
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
       if (!originalDelegate) return mDefaultSubscription;
 
       ISRTPTransportSubscriptionPtr subscription = mSubscriptions.subscribe(originalDelegate, IORTCForInternal::queueDelegate());
@@ -664,6 +724,8 @@ namespace ortc
                                              size_t bufferLengthInBytes
                                              )
     {
+      PacketPipelineLatency::markHop(IStatsReportTypes::PacketPipelineHop_DTLSTransport);
+
       UseSecureTransportPtr transport;
       SecureByteBlockPtr decryptedBuffer;
       IICETypes::Components component = (RTPUtils::isRTCPPacketType(buffer, bufferLengthInBytes) ? IICETypes::Component_RTCP : IICETypes::Component_RTP);
@@ -717,7 +779,7 @@ namespace ortc
       // log a warning and abort out of the decoding process IMMEDIATELY.
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (0 == mLastRemainingOverallPercentageReported) {
           ZS_LOG_WARNING(Detail, log("cannot decrypt packet as packet lifetime is exhausted (and continuing to decrypt would violate security principles)"))
@@ -844,7 +906,7 @@ namespace ortc
 
       // need to update the usage of the key (depending on which key was acutally used for decrypting)
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (usedKeys[decryptedWithKey]->mTotalPackets[component] + 1 > usedKeys[decryptedWithKey]->mLifetime) {
           ZS_LOG_WARNING(Debug, log("cannot use keying material as it's lifetime is exhausted") + usedKeys[decryptedWithKey]->toDebug())
@@ -878,6 +940,9 @@ namespace ortc
                     buffer, packet, decryptedBuffer->BytePtr(),
                     size, size, out_len
                     );
+
+      if (mCaptureRing) mCaptureRing->capture(IRTPCapture::Direction_Incoming, component, decryptedBuffer->BytePtr(), SafeInt<size_t>(out_len));
+
       return transport->handleReceivedDecryptedPacket(viaTransport, component, decryptedBuffer->BytePtr(), SafeInt<size_t>(out_len));
     }
 
@@ -888,6 +953,97 @@ namespace ortc
                                    const BYTE *buffer,
                                    size_t bufferLengthInBytes
                                    )
+    {
+      if (IICETypes::Component_RTCP != packetType) return protectAndSendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
+
+      // aggregation window is fixed at construction thus no lock is needed
+      if (0 == mRTCPAggregationWindow.count()) return protectAndSendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
+
+      // NOTE: no lock is held while sending; RTCP sent from different threads
+      //       may be reordered which the SRTCP replay window tolerates
+      FlushedRTCPList flushed;
+      bool queued = queueRTCP(sendOverICETransport, buffer, bufferLengthInBytes, flushed);
+
+      // any previously pending RTCP must go out before this packet
+      bool result = sendFlushedRTCP(flushed);
+      if (queued) return result;
+
+      return protectAndSendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => IWakeDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void SRTPTransport::onWake()
+    {
+      // NOT USED
+      // ZS_LOG_DEBUG(log("wake"))
+      // AutoRecursiveLock lock(*this);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void SRTPTransport::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_TRACE(log("timer") + ZS_PARAM("timer id", timer->getID()))
+
+      FlushedRTCPList flushed;
+
+      {
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+        if (timer != mRTCPAggregationTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer (thus ignoring)") + ZS_PARAM("timer id", timer->getID()))
+          return;
+        }
+
+        mRTCPAggregationTimer.reset();
+
+        for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+          flushRTCP(static_cast<IICETypes::Components>(loop), flushed);
+        }
+      }
+
+      sendFlushedRTCP(flushed);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => ISRTPTransportAsyncDelegate
+    #pragma mark
+
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool SRTPTransport::protectAndSendPacket(
+                                             IICETypes::Components sendOverICETransport,
+                                             IICETypes::Components packetType,  // is packet RTP or RTCP
+                                             const BYTE *buffer,
+                                             size_t bufferLengthInBytes
+                                             )
     {
       ZS_EVENTING_5(
                     x, i, Trace, SrtpTransportSendOutgoingPacketAndEncrypt, ol, SrtpTransport, Send,
@@ -898,6 +1054,8 @@ namespace ortc
                     size, size, bufferLengthInBytes
                     );
 
+      if (mCaptureRing) mCaptureRing->capture(IRTPCapture::Direction_Outgoing, packetType, buffer, bufferLengthInBytes);
+
       UseSecureTransportPtr transport;
       KeyingMaterialPtr keyingMaterial;
 
@@ -911,7 +1069,7 @@ namespace ortc
       packetType == IICETypes::Component_RTP ? (authenticationTagLength = material.mAuthenticationTagLength[packetType]) : (authenticationTagLength = material.mAuthenticationTagLength[packetType] + 4);
 
       {
-        AutoRecursiveLock lock(*this);
+        ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
         if (0 == mLastRemainingOverallPercentageReported) {
           ZS_LOG_WARNING(Detail, log("cannot encrypt packet as packet lifetime is exhausted"))
@@ -1010,53 +1168,96 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => IWakeDelegate
-    #pragma mark
-
-    //-------------------------------------------------------------------------
-    void SRTPTransport::onWake()
+    bool SRTPTransport::queueRTCP(
+                                  IICETypes::Components sendOverICETransport,
+                                  const BYTE *buffer,
+                                  size_t bufferLengthInBytes,
+                                  FlushedRTCPList &outFlushed
+                                  )
     {
-      // NOT USED
-      // ZS_LOG_DEBUG(log("wake"))
-      // AutoRecursiveLock lock(*this);
-    }
+      bool compound = false;
+      bool feedback = false;
+      bool padding = false;
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => ITimerDelegate
-    #pragma mark
+      bool valid = classifyRTCP(buffer, bufferLengthInBytes, compound, feedback, padding);
 
-    //-------------------------------------------------------------------------
-    void SRTPTransport::onTimer(ITimerPtr timer)
-    {
-      // NOT USED
-      // ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
-      // AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
+
+      PendingRTCP &pending = mPendingRTCP[sendOverICETransport];
+
+      if ((!valid) ||
+          (bufferLengthInBytes > mMaxRTCPCompoundPacketSize)) {
+        ZS_LOG_TRACE(log("rtcp packet cannot be aggregated") + ZS_PARAM("valid", valid) + ZS_PARAM("size", bufferLengthInBytes))
+        flushRTCP(sendOverICETransport, outFlushed);
+        return false;
+      }
+
+      // feedback (reduced-size or compound) and padded packets cannot wait and
+      // a padded packet must be last in any compound packet
+      bool sendNow = ((feedback) || (padding) || (!compound));
+
+      if ((pending.mSize + bufferLengthInBytes) > mMaxRTCPCompoundPacketSize) {
+        flushRTCP(sendOverICETransport, outFlushed);
+      }
+
+      if (0 == pending.mSize) {
+        // RFC 5506 reduced-size RTCP cannot lead a compound packet
+        if (sendNow) return false;
+      }
+
+      if (!pending.mBuffer) {
+        pending.mBuffer = make_shared<SecureByteBlock>(mMaxRTCPCompoundPacketSize);
+      }
+
+      memcpy(&((pending.mBuffer->BytePtr())[pending.mSize]), buffer, bufferLengthInBytes);
+      pending.mSize += bufferLengthInBytes;
+      ++(pending.mTotalPackets);
+
+      if (sendNow) {
+        flushRTCP(sendOverICETransport, outFlushed);
+        return true;
+      }
+
+      if (!mRTCPAggregationTimer) {
+        mRTCPAggregationTimer = ITimer::create(mThisWeak.lock(), mRTCPAggregationWindow, false);
+      }
+      return true;
     }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => ISRTPTransportAsyncDelegate
-    #pragma mark
+    void SRTPTransport::flushRTCP(
+                                  IICETypes::Components sendOverICETransport,
+                                  FlushedRTCPList &outFlushed
+                                  )
+    {
+      PendingRTCP &pending = mPendingRTCP[sendOverICETransport];
+      if (0 == pending.mSize) return;
 
+      ZS_LOG_TRACE(log("flushing aggregated rtcp") + ZS_PARAM("send over", IICETypes::toString(sendOverICETransport)) + pending.toDebug())
+
+      FlushedRTCP flushed;
+      flushed.mSendOver = sendOverICETransport;
+      flushed.mBuffer = pending.mBuffer;
+      flushed.mSize = pending.mSize;
+      outFlushed.push_back(flushed);
+
+      // buffer ownership passed to flushed list; next packet allocates again
+      pending.mBuffer.reset();
+      pending.mSize = 0;
+      pending.mTotalPackets = 0;
+    }
 
     //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark SRTPTransport => (internal)
-    #pragma mark
+    bool SRTPTransport::sendFlushedRTCP(const FlushedRTCPList &flushed)
+    {
+      bool result = true;
+      for (auto iter = flushed.begin(); iter != flushed.end(); ++iter) {
+        auto &info = (*iter);
+        auto success = protectAndSendPacket(info.mSendOver, IICETypes::Component_RTCP, info.mBuffer->BytePtr(), info.mSize);
+        result = result && success;
+      }
+      return result;
+    }
 
     //-------------------------------------------------------------------------
     Log::Params SRTPTransport::log(const char *message) const
@@ -1082,7 +1283,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     ElementPtr SRTPTransport::toDebug() const
     {
-      AutoRecursiveLock lock(*this);
+      ORTC_AUTO_RECURSIVE_LOCK(lock, *this);
 
       ElementPtr resultEl = Element::create("ortc::SRTPTransport");
 
@@ -1100,6 +1301,14 @@ namespace ortc
       IHelper::debugAppend(resultEl, "last remaining least key percentage reported", mLastRemainingLeastKeyPercentageReported);
       IHelper::debugAppend(resultEl, "last remaining overall percentage reported", mLastRemainingOverallPercentageReported);
 
+      IHelper::debugAppend(resultEl, "rtcp aggregation window", mRTCPAggregationWindow);
+      IHelper::debugAppend(resultEl, "max rtcp compound packet size", mMaxRTCPCompoundPacketSize);
+      IHelper::debugAppend(resultEl, "pending rtcp (rtp)", mPendingRTCP[IICETypes::Component_RTP].toDebug());
+      IHelper::debugAppend(resultEl, "pending rtcp (rtcp)", mPendingRTCP[IICETypes::Component_RTCP].toDebug());
+      IHelper::debugAppend(resultEl, "rtcp aggregation timer", mRTCPAggregationTimer ? mRTCPAggregationTimer->getID() : 0);
+
+      IHelper::debugAppend(resultEl, "capture ring", mCaptureRing ? mCaptureRing->toDebug() : ElementPtr());
+
       for (size_t loopDirection = Direction_First; loopDirection != Direction_Last; ++loopDirection) {
         IHelper::debugAppend(resultEl, toString((Directions)loopDirection), mMaterial[loopDirection].toDebug());
       }
@@ -1120,6 +1329,15 @@ namespace ortc
         mDefaultSubscription->cancel();
         mDefaultSubscription.reset();
       }
+
+      if (mRTCPAggregationTimer) {
+        mRTCPAggregationTimer->cancel();
+        mRTCPAggregationTimer.reset();
+      }
+
+      for (size_t loop = IICETypes::Component_First; loop <= IICETypes::Component_Last; ++loop) {
+        mPendingRTCP[loop] = PendingRTCP();
+      }
     }
 
     //-------------------------------------------------------------------------
@@ -1363,6 +1581,26 @@ namespace ortc
       return hasher->finalizeAsString();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SRTPTransport::PendingRTCP
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr SRTPTransport::PendingRTCP::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::SRTPTransport::PendingRTCP");
+
+      IHelper::debugAppend(resultEl, "buffer", mBuffer ? mBuffer->SizeInBytes() : 0);
+      IHelper::debugAppend(resultEl, "size", mSize);
+      IHelper::debugAppend(resultEl, "total packets", mTotalPackets);
+
+      return resultEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -30,6 +30,8 @@
  */
 
 #include <ortc/internal/ortc_StatsReport.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
 #include <ortc/internal/ortc_Helper.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc.stats.events.h>
@@ -210,6 +212,8 @@ namespace ortc
       virtual void notifySettingsApplyDefaults() override
       {
         //      ISettings::setUInt(ORTC_SETTING_STATS_REPORT_, 0);
+        ISettings::setUInt(ORTC_SETTING_STATS_SUBSCRIPTION_DEFAULT_SAMPLING_INTERVAL_IN_MILLISECONDS, 1000);
+        ISettings::setUInt(ORTC_SETTING_STATS_SUBSCRIPTION_MINIMUM_SAMPLING_INTERVAL_IN_MILLISECONDS, 100);
       }
       
     };
@@ -538,96 +542,1721 @@ namespace ortc
       return internal::StatsReport::collectReports(promises, previouslyCreatedPromiseToResolve);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPStreamCounters::Snapshot
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    unsigned long RTPStreamCounters::Snapshot::packetsLost() const
+    {
+      if (mPacketsExpected <= mPacketsReceivedOnSSRC) return 0;
+      return static_cast<unsigned long>(mPacketsExpected - mPacketsReceivedOnSSRC);
+    }
+
+    //-------------------------------------------------------------------------
+    double RTPStreamCounters::Snapshot::fractionLost() const
+    {
+      if (mHasReportingInterval) return mFractionLost;
+
+      // no receiver report has been sent yet so the reporting interval is
+      // the entire stream so far
+      if (0 == mPacketsExpected) return 0.0;
+      return static_cast<double>(packetsLost()) / static_cast<double>(mPacketsExpected);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::Snapshot::applyTo(IStatsReportTypes::InboundRTPStreamStats &stats) const
+    {
+      stats.mSSRC = mSSRC;
+      stats.mPacketsReceived = static_cast<unsigned long>(mPackets);
+      stats.mBytesReceived = mBytes;
+      stats.mPacketsLost = packetsLost();
+      stats.mJitter = mJitter;
+      stats.mFractionLost = fractionLost();
+      stats.mNACKCount = mNACKCount;
+      stats.mPLICount = mPLICount;
+      stats.mFIRCount = mFIRCount;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::Snapshot::applyTo(IStatsReportTypes::OutboundRTPStreamStats &stats) const
+    {
+      stats.mSSRC = mSSRC;
+      stats.mPacketsSent = static_cast<unsigned long>(mPackets);
+      stats.mBytesSent = mBytes;
+      stats.mTargetBitrate = mRemoteEstimatedBitrate;
+      stats.mRoundTripTime = mRoundTripTime;
+      stats.mNACKCount = mNACKCount;
+      stats.mPLICount = mPLICount;
+      stats.mFIRCount = mFIRCount;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPStreamCounters::Snapshot::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPStreamCounters::Snapshot");
+
+      IHelper::debugAppend(resultEl, "ssrc", mSSRC);
+      IHelper::debugAppend(resultEl, "payload type", mPayloadType);
+      IHelper::debugAppend(resultEl, "packets", mPackets);
+      IHelper::debugAppend(resultEl, "bytes", mBytes);
+      IHelper::debugAppend(resultEl, "packets expected", mPacketsExpected);
+      IHelper::debugAppend(resultEl, "packets received on ssrc", mPacketsReceivedOnSSRC);
+      IHelper::debugAppend(resultEl, "jitter", mJitter);
+      IHelper::debugAppend(resultEl, "nack count", mNACKCount);
+      IHelper::debugAppend(resultEl, "pli count", mPLICount);
+      IHelper::debugAppend(resultEl, "fir count", mFIRCount);
+      IHelper::debugAppend(resultEl, "round trip time", mRoundTripTime);
+      IHelper::debugAppend(resultEl, "remote estimated bitrate", mRemoteEstimatedBitrate);
+      IHelper::debugAppend(resultEl, "fraction lost", mFractionLost);
+      IHelper::debugAppend(resultEl, "has reporting interval", mHasReportingInterval);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPStreamCounters
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    // extractFeedback() yields one event per FCI entry (e.g. every PID/BLP
+    // pair of a generic NACK) but each feedback message must only be counted
+    // once
+    static bool isNewFeedbackMessage(
+                                     const RTCPPacket::FeedbackEvent *previous,
+                                     const RTCPPacket::FeedbackEvent &event
+                                     )
+    {
+      if (!previous) return true;
+      if (previous->mType != event.mType) return true;
+      if (previous->mSSRCOfPacketSender != event.mSSRCOfPacketSender) return true;
+      return (previous->mSSRC != event.mSSRC);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPStreamCounters::RTPStreamCounters()
+    {
+      for (size_t index = 0; index < kMaxPayloadTypes; ++index) {
+        mClockRates[index].store(0, std::memory_order_relaxed);
+      }
+      for (size_t index = 0; index < kMaxSSRCs; ++index) {
+        mSentSSRCs[index].store(0, std::memory_order_relaxed);
+        mEncodingSSRCs[index].store(0, std::memory_order_relaxed);
+      }
+      for (size_t index = 0; index < kSenderReportHistory; ++index) {
+        mSenderReports[index].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::updateParameters(const Parameters &params)
+    {
+      for (auto iter = params.mCodecs.begin(); iter != params.mCodecs.end(); ++iter) {
+        auto &codec = (*iter);
+        if (codec.mPayloadType >= kMaxPayloadTypes) continue;
+
+        DWORD clockRate = (codec.mClockRate.hasValue() ? static_cast<DWORD>(codec.mClockRate.value()) : 0);
+
+        // RTX and FEC payload types never identify the media stream
+        switch (IRTPTypes::getCodecKind(IRTPTypes::toSupportedCodec(codec.mName))) {
+          case IRTPTypes::CodecKind_RTX:
+          case IRTPTypes::CodecKind_FEC:  clockRate = 0; break;
+          default:                        break;
+        }
+
+        mClockRates[codec.mPayloadType].store(clockRate, std::memory_order_relaxed);
+      }
+
+      size_t index = 0;
+      for (auto iter = params.mEncodings.begin(); (iter != params.mEncodings.end()) && (index < kMaxSSRCs); ++iter) {
+        auto &encoding = (*iter);
+        if (!encoding.mSSRC.hasValue()) continue;
+        if (0 == encoding.mSSRC.value()) continue;
+
+        mEncodingSSRCs[index].store(encoding.mSSRC.value(), std::memory_order_relaxed);
+        ++index;
+      }
+      for (; index < kMaxSSRCs; ++index) {
+        mEncodingSSRCs[index].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::notifyReceived(const RTPPacket &packet)
+    {
+      mPackets.fetch_add(1, std::memory_order_relaxed);
+      mBytes.fetch_add(packet.size(), std::memory_order_relaxed);
+
+      // sequence and jitter tracking only follow the media stream (i.e.
+      // not any associated RTX/FEC stream)
+      if (!mReceiveStarted) {
+        if (!isStreamSSRC(packet.ssrc(), packet.pt())) return;
+        startReceiving(packet);
+      } else if (packet.ssrc() != mSSRC.load(std::memory_order_relaxed)) {
+        // the encoding parameters can name the media SSRC after packets
+        // from another SSRC were already being followed
+        if (!isEncodingSSRC(packet.ssrc())) return;
+        if (isEncodingSSRC(mSSRC.load(std::memory_order_relaxed))) return;
+        startReceiving(packet);
+      } else {
+        WORD delta = static_cast<WORD>(packet.sequenceNumber() - mMaxSequenceNumber);
+        if (delta < 0x8000) {
+          if (packet.sequenceNumber() < mMaxSequenceNumber) mSequenceCycles += 0x10000;
+          mMaxSequenceNumber = packet.sequenceNumber();
+        }
+      }
+
+      mPayloadType.store(packet.pt(), std::memory_order_relaxed);
+      mPacketsReceivedOnSSRC.fetch_add(1, std::memory_order_relaxed);
+      mPacketsExpected.store(static_cast<QWORD>(mSequenceCycles) + mMaxSequenceNumber - mBaseSequenceNumber + 1, std::memory_order_relaxed);
+
+      // https://tools.ietf.org/html/rfc3550#appendix-A.8
+      DWORD clockRate = (packet.pt() < kMaxPayloadTypes ? mClockRates[packet.pt()].load(std::memory_order_relaxed) : 0);
+      if (0 == clockRate) return;
+
+      if (clockRate != mTransitClockRate) {
+        mTransitClockRate = clockRate;
+        mHasTransit = false;
+        mJitter = 0.0;
+      }
+
+      DWORD arrival = static_cast<DWORD>((static_cast<QWORD>(nowInMilliseconds()) * clockRate) / 1000);
+      LONG transit = static_cast<LONG>(arrival - packet.timestamp());
+
+      if (mHasTransit) {
+        LONG difference = transit - mLastTransit;
+        if (difference < 0) difference = -difference;
+        mJitter += (static_cast<double>(difference) - mJitter) / 16.0;
+      }
+
+      mHasTransit = true;
+      mLastTransit = transit;
+
+      mJitterInTimestampUnits.store(static_cast<DWORD>(mJitter + 0.5), std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::notifyFeedbackSent(const RTCPPacket &packet)
+    {
+      RTCPPacket::FeedbackEventList events;
+      bool feedbackOnly = false;
+
+      auto buffer = packet.buffer();
+      if (!buffer) return;
+
+      if (!RTCPPacket::extractFeedback(buffer->BytePtr(), buffer->SizeInBytes(), events, feedbackOnly)) return;
+
+      const RTCPPacket::FeedbackEvent *previous = NULL;
+      for (auto iter = events.begin(); iter != events.end(); previous = &(*iter), ++iter) {
+        auto &event = (*iter);
+        if (!isNewFeedbackMessage(previous, event)) continue;
+
+        switch (event.mType) {
+          case RTCPPacket::FeedbackEvent::Type_GenericNACK: mNACKCount.fetch_add(1, std::memory_order_relaxed); break;
+          case RTCPPacket::FeedbackEvent::Type_PLI:         mPLICount.fetch_add(1, std::memory_order_relaxed); break;
+          case RTCPPacket::FeedbackEvent::Type_FIR:         mFIRCount.fetch_add(1, std::memory_order_relaxed); break;
+          case RTCPPacket::FeedbackEvent::Type_REMB:        break;
+        }
+      }
+
+      // a new reporting interval starts each time a report block about the
+      // stream is sent
+      SSRCType ssrc = mSSRC.load(std::memory_order_relaxed);
+      if (0 == ssrc) return;
+
+      for (auto sr = packet.firstSenderReport(); NULL != sr; sr = sr->nextSenderReport()) {
+        for (auto rb = sr->firstReportBlock(); NULL != rb; rb = rb->next()) {
+          if (ssrc != rb->ssrc()) continue;
+          updateReportingInterval();
+          return;
+        }
+      }
+      for (auto rr = packet.firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport()) {
+        for (auto rb = rr->firstReportBlock(); NULL != rb; rb = rb->next()) {
+          if (ssrc != rb->ssrc()) continue;
+          updateReportingInterval();
+          return;
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::notifySent(const RTPPacket &packet)
+    {
+      mPackets.fetch_add(1, std::memory_order_relaxed);
+      mBytes.fetch_add(packet.size(), std::memory_order_relaxed);
+      mPayloadType.store(packet.pt(), std::memory_order_relaxed);
+
+      SSRCType ssrc = packet.ssrc();
+      if (isSentSSRC(ssrc)) return;
+
+      // every sent SSRC is remembered for matching incoming RTCP but only
+      // the media stream's SSRC is reported
+      if (isStreamSSRC(ssrc, packet.pt())) {
+        if ((0 == mSSRC.load(std::memory_order_relaxed)) ||
+            (isEncodingSSRC(ssrc))) {
+          mSSRC.store(ssrc, std::memory_order_relaxed);
+        }
+      }
+
+      for (size_t index = 0; index < kMaxSSRCs; ++index) {
+        DWORD expected = 0;
+        if (mSentSSRCs[index].compare_exchange_strong(expected, ssrc, std::memory_order_relaxed)) break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::notifySenderReportsSent(const RTCPPacket &packet)
+    {
+      for (auto sr = packet.firstSenderReport(); NULL != sr; sr = sr->nextSenderReport()) {
+        DWORD ntpMiddle = ((sr->ntpTimestampMS() & 0xFFFF) << 16) | (sr->ntpTimestampLS() >> 16);
+        QWORD entry = (static_cast<QWORD>(ntpMiddle) << 32) | static_cast<QWORD>(nowInMilliseconds());
+
+        mSenderReports[mNextSenderReport % kSenderReportHistory].store(entry, std::memory_order_relaxed);
+        ++mNextSenderReport;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::notifyIncomingRTCP(const RTCPPacket &packet)
+    {
+      {
+        RTCPPacket::FeedbackEventList events;
+        bool feedbackOnly = false;
+
+        auto buffer = packet.buffer();
+        if ((buffer) &&
+            (RTCPPacket::extractFeedback(buffer->BytePtr(), buffer->SizeInBytes(), events, feedbackOnly))) {
+          const RTCPPacket::FeedbackEvent *previous = NULL;
+          for (auto iter = events.begin(); iter != events.end(); previous = &(*iter), ++iter) {
+            auto &event = (*iter);
+            if (!isSentSSRC(event.mSSRC)) continue;
+            if (!isNewFeedbackMessage(previous, event)) continue;
+
+            switch (event.mType) {
+              case RTCPPacket::FeedbackEvent::Type_GenericNACK: mNACKCount.fetch_add(1, std::memory_order_relaxed); break;
+              case RTCPPacket::FeedbackEvent::Type_PLI:         mPLICount.fetch_add(1, std::memory_order_relaxed); break;
+              case RTCPPacket::FeedbackEvent::Type_FIR:         mFIRCount.fetch_add(1, std::memory_order_relaxed); break;
+              case RTCPPacket::FeedbackEvent::Type_REMB:        {
+                QWORD bitrate = (event.mBRExp < 46 ? (static_cast<QWORD>(event.mBRMantissa) << event.mBRExp) : 0);
+                mRemoteEstimatedBitrate.store(bitrate, std::memory_order_relaxed);
+                break;
+              }
+            }
+          }
+        }
+      }
+
+      // https://tools.ietf.org/html/rfc3550#section-6.4.1 (round trip time
+      // calculation from LSR and DLSR)
+      DWORD now = nowInMilliseconds();
+
+      for (auto rr = packet.firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport()) {
+        for (auto rb = rr->firstReportBlock(); NULL != rb; rb = rb->next()) {
+          if (0 == rb->lsr()) continue;
+          if (!isSentSSRC(rb->ssrc())) continue;
+
+          for (size_t index = 0; index < kSenderReportHistory; ++index) {
+            QWORD entry = mSenderReports[index].load(std::memory_order_relaxed);
+            if (0 == entry) continue;
+            if (static_cast<DWORD>(entry >> 32) != rb->lsr()) continue;
+
+            DWORD sentAt = static_cast<DWORD>(entry & 0xFFFFFFFF);
+            DWORD elapsed = now - sentAt;
+            DWORD delay = static_cast<DWORD>((static_cast<QWORD>(rb->dlsr()) * 1000) / 65536);
+            if (elapsed < delay) break;
+
+            mRoundTripTimeInMilliseconds.store(elapsed - delay, std::memory_order_relaxed);
+            break;
+          }
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::snapshot(Snapshot &outSnapshot) const
+    {
+      outSnapshot.mSSRC = mSSRC.load(std::memory_order_relaxed);
+      outSnapshot.mPayloadType = static_cast<PayloadType>(mPayloadType.load(std::memory_order_relaxed));
+      outSnapshot.mPackets = mPackets.load(std::memory_order_relaxed);
+      outSnapshot.mBytes = mBytes.load(std::memory_order_relaxed);
+      outSnapshot.mPacketsExpected = mPacketsExpected.load(std::memory_order_relaxed);
+      outSnapshot.mPacketsReceivedOnSSRC = mPacketsReceivedOnSSRC.load(std::memory_order_relaxed);
+      outSnapshot.mJitter = static_cast<double>(mJitterInTimestampUnits.load(std::memory_order_relaxed));
+      outSnapshot.mNACKCount = mNACKCount.load(std::memory_order_relaxed);
+      outSnapshot.mPLICount = mPLICount.load(std::memory_order_relaxed);
+      outSnapshot.mFIRCount = mFIRCount.load(std::memory_order_relaxed);
+      outSnapshot.mRoundTripTime = static_cast<double>(mRoundTripTimeInMilliseconds.load(std::memory_order_relaxed));
+      outSnapshot.mRemoteEstimatedBitrate = static_cast<double>(mRemoteEstimatedBitrate.load(std::memory_order_relaxed));
+      outSnapshot.mFractionLost = static_cast<double>(mFractionLostInPPM.load(std::memory_order_relaxed)) / 1000000.0;
+      outSnapshot.mHasReportingInterval = mHasReportingInterval.load(std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPStreamCounters::excludeStatsType(
+                                             const IStatsReportTypes::StatsTypeSet &requested,
+                                             IStatsReportTypes::StatsTypes statsType,
+                                             IStatsReportTypes::StatsTypeSet &outRemaining
+                                             )
+    {
+      outRemaining.clear();
+
+      if (!requested.hasStatType(statsType)) return false;
+
+      for (IStatsReportTypes::StatsTypes index = IStatsReportTypes::StatsType_First; index <= IStatsReportTypes::StatsType_Last; index = static_cast<IStatsReportTypes::StatsTypes>(static_cast<std::underlying_type<IStatsReportTypes::StatsTypes>::type>(index) + 1)) {
+        if (index == statsType) continue;
+        if (!requested.hasStatType(index)) continue;
+        outRemaining.insert(index);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPStreamCounters::isSentSSRC(SSRCType ssrc) const
+    {
+      for (size_t index = 0; index < kMaxSSRCs; ++index) {
+        DWORD current = mSentSSRCs[index].load(std::memory_order_relaxed);
+        if (0 == current) return false;
+        if (ssrc == current) return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPStreamCounters::isEncodingSSRC(SSRCType ssrc) const
+    {
+      for (size_t index = 0; index < kMaxSSRCs; ++index) {
+        DWORD current = mEncodingSSRCs[index].load(std::memory_order_relaxed);
+        if (0 == current) return false;
+        if (ssrc == current) return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPStreamCounters::hasEncodingSSRCs() const
+    {
+      return (0 != mEncodingSSRCs[0].load(std::memory_order_relaxed));
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPStreamCounters::isStreamSSRC(
+                                         SSRCType ssrc,
+                                         PayloadType payloadType
+                                         ) const
+    {
+      if (hasEncodingSSRCs()) return isEncodingSSRC(ssrc);
+
+      // without explicit SSRCs the stream is the first SSRC carrying a
+      // media payload type (i.e. not RTX/FEC)
+      if (payloadType >= kMaxPayloadTypes) return false;
+      return (0 != mClockRates[payloadType].load(std::memory_order_relaxed));
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::startReceiving(const RTPPacket &packet)
+    {
+      mReceiveStarted = true;
+      mSSRC.store(packet.ssrc(), std::memory_order_relaxed);
+      mBaseSequenceNumber = packet.sequenceNumber();
+      mMaxSequenceNumber = packet.sequenceNumber();
+      mSequenceCycles = 0;
+      mHasTransit = false;
+      mJitter = 0.0;
+
+      mPacketsReceivedOnSSRC.store(0, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPStreamCounters::updateReportingInterval()
+    {
+      // https://tools.ietf.org/html/rfc3550#appendix-A.3
+      QWORD expected = mPacketsExpected.load(std::memory_order_relaxed);
+      QWORD received = mPacketsReceivedOnSSRC.load(std::memory_order_relaxed);
+
+      // the stream restarted on another SSRC since the last report
+      if ((expected < mExpectedPrior) ||
+          (received < mReceivedPrior)) {
+        mExpectedPrior = 0;
+        mReceivedPrior = 0;
+      }
+
+      QWORD expectedInterval = expected - mExpectedPrior;
+      QWORD receivedInterval = received - mReceivedPrior;
+
+      mExpectedPrior = expected;
+      mReceivedPrior = received;
+
+      DWORD fraction = 0;
+      if ((0 != expectedInterval) &&
+          (expectedInterval > receivedInterval)) {
+        fraction = static_cast<DWORD>(((expectedInterval - receivedInterval) * 1000000) / expectedInterval);
+      }
+
+      mFractionLostInPPM.store(fraction, std::memory_order_relaxed);
+      mHasReportingInterval.store(true, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    DWORD RTPStreamCounters::nowInMilliseconds()
+    {
+      return static_cast<DWORD>(zsLib::timeSinceEpoch<Milliseconds>(zsLib::now()).count());
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LatencyHistogram
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    LatencyHistogram::LatencyHistogram()
+    {
+      for (size_t index = 0; index < kBuckets; ++index) {
+        mBuckets[index].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void LatencyHistogram::record(QWORD valueInMicroseconds)
+    {
+      mBuckets[toBucket(valueInMicroseconds)].fetch_add(1, std::memory_order_relaxed);
+      mTotal.fetch_add(valueInMicroseconds, std::memory_order_relaxed);
+      mCount.fetch_add(1, std::memory_order_relaxed);
+
+      QWORD currentMax = mMax.load(std::memory_order_relaxed);
+      while (valueInMicroseconds > currentMax) {
+        if (mMax.compare_exchange_weak(currentMax, valueInMicroseconds, std::memory_order_relaxed)) break;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void LatencyHistogram::snapshot(HopLatency &outLatency) const
+    {
+      static const double percentiles[] = {0.50, 0.90, 0.99, 0.999};
+      double *results[] = {&outLatency.mP50, &outLatency.mP90, &outLatency.mP99, &outLatency.mP999};
+
+      QWORD counts[kBuckets];
+      QWORD count = 0;
+      for (size_t index = 0; index < kBuckets; ++index) {
+        counts[index] = mBuckets[index].load(std::memory_order_relaxed);
+        count += counts[index];
+      }
+
+      QWORD maxValue = mMax.load(std::memory_order_relaxed);
+      QWORD total = mTotal.load(std::memory_order_relaxed);
+
+      outLatency = HopLatency();
+      if (0 == count) return;
+
+      outLatency.mCount = count;
+      outLatency.mAverage = (static_cast<double>(total) / static_cast<double>(count)) / 1000.0;
+      outLatency.mMax = static_cast<double>(maxValue) / 1000.0;
+
+      size_t bucket = 0;
+      QWORD seen = 0;
+      for (size_t index = 0; index < (sizeof(percentiles) / sizeof(percentiles[0])); ++index) {
+        QWORD target = static_cast<QWORD>(percentiles[index] * static_cast<double>(count) + 0.5);
+        if (target < 1) target = 1;
+
+        while ((bucket < kBuckets) &&
+               (seen + counts[bucket] < target)) {
+          seen += counts[bucket];
+          ++bucket;
+        }
+
+        // interpolate by rank across the values equivalent to the bucket (but
+        // never report more than the largest value actually recorded)
+        double value = static_cast<double>(maxValue);
+        if (bucket < kBuckets) {
+          double lowest = static_cast<double>(bucketLowestValue(bucket));
+          double highest = static_cast<double>(bucketHighestValue(bucket));
+          value = lowest + ((highest - lowest) * static_cast<double>(target - seen)) / static_cast<double>(counts[bucket]);
+          if (value > static_cast<double>(maxValue)) value = static_cast<double>(maxValue);
+        }
+        *(results[index]) = value / 1000.0;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    size_t LatencyHistogram::toBucket(QWORD value)
+    {
+      if (value < (kSubBuckets * 2)) return static_cast<size_t>(value);
+
+      static const QWORD maxValue = (static_cast<QWORD>(1) << kMaxValueBits) - 1;
+      if (value > maxValue) value = maxValue;
+
+      size_t highestBit = kSubBucketBits + 1;
+      while ((value >> (highestBit + 1)) != 0) ++highestBit;
+
+      size_t shift = highestBit - kSubBucketBits;
+      return ((shift + 1) * kSubBuckets) + static_cast<size_t>(value >> shift) - kSubBuckets;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD LatencyHistogram::bucketLowestValue(size_t bucket)
+    {
+      if (bucket < (kSubBuckets * 2)) return static_cast<QWORD>(bucket);
+
+      size_t shift = (bucket / kSubBuckets) - 1;
+      QWORD top = static_cast<QWORD>((bucket % kSubBuckets) + kSubBuckets);
+      return top << shift;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD LatencyHistogram::bucketHighestValue(size_t bucket)
+    {
+      if (bucket < (kSubBuckets * 2)) return static_cast<QWORD>(bucket);
+
+      size_t shift = (bucket / kSubBuckets) - 1;
+      QWORD top = static_cast<QWORD>((bucket % kSubBuckets) + kSubBuckets);
+      return ((top + 1) << shift) - 1;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark PacketPipelineLatency
+    #pragma mark
+
+    namespace
+    {
+      struct PacketPipelineThreadContext
+      {
+        QWORD mIngress;
+        QWORD mLastMark;
+      };
+
+      thread_local PacketPipelineThreadContext gPacketPipelineThreadContext {};
+    }
+
+    //-------------------------------------------------------------------------
+    PacketPipelineLatency::IngressScope::IngressScope()
+    {
+      auto &context = gPacketPipelineThreadContext;
+      mPreviousIngress = context.mIngress;
+      mPreviousMark = context.mLastMark;
+
+      context.mIngress = context.mLastMark = PacketPipelineLatency::now();
+    }
+
+    //-------------------------------------------------------------------------
+    PacketPipelineLatency::IngressScope::~IngressScope()
+    {
+      auto &context = gPacketPipelineThreadContext;
+      context.mIngress = mPreviousIngress;
+      context.mLastMark = mPreviousMark;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD PacketPipelineLatency::now()
+    {
+      static const auto epoch = std::chrono::steady_clock::now();
+      return static_cast<QWORD>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count()) + 1;
+    }
+
+    //-------------------------------------------------------------------------
+    QWORD PacketPipelineLatency::ingressTime()
+    {
+      return gPacketPipelineThreadContext.mIngress;
+    }
+
+    //-------------------------------------------------------------------------
+    void PacketPipelineLatency::markHop(PacketPipelineHops hop)
+    {
+      auto &context = gPacketPipelineThreadContext;
+      if (0 == context.mIngress) return;
+
+      QWORD current = now();
+      histograms()[hop].record(current - context.mLastMark);
+      context.mLastMark = current;
+    }
+
+    //-------------------------------------------------------------------------
+    void PacketPipelineLatency::recordSince(
+                                            PacketPipelineHops hop,
+                                            QWORD sinceInMicroseconds
+                                            )
+    {
+      if (0 == sinceInMicroseconds) return;
+
+      QWORD current = now();
+      histograms()[hop].record(current > sinceInMicroseconds ? current - sinceInMicroseconds : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::PacketPipelineStatsPtr PacketPipelineLatency::createStats()
+    {
+      auto result = make_shared<IStatsReportTypes::PacketPipelineStats>();
+      result->mID = IStatsReportTypes::toString(IStatsReportTypes::StatsType_PacketPipeline);
+
+      auto all = histograms();
+      for (size_t index = 0; index <= IStatsReportTypes::PacketPipelineHop_Last; ++index) {
+        all[index].snapshot(result->mHops[index]);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    LatencyHistogram *PacketPipelineLatency::histograms()
+    {
+      static LatencyHistogram all[IStatsReportTypes::PacketPipelineHop_Last + 1];
+      return &(all[0]);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MediaChannelLatency
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    QWORD MediaChannelLatency::now()
+    {
+      return PacketPipelineLatency::now();
+    }
+
+    //-------------------------------------------------------------------------
+    void MediaChannelLatency::notifySetupRequested()
+    {
+      counters().mSetupsRequested.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    void MediaChannelLatency::recordSetup(
+                                          QWORD sinceInMicroseconds,
+                                          bool succeeded
+                                          )
+    {
+      if (0 == sinceInMicroseconds) return;
+
+      auto &all = counters();
+      (succeeded ? all.mSetupsSucceeded : all.mSetupsFailed).fetch_add(1, std::memory_order_relaxed);
+
+      QWORD current = now();
+      all.mSetup.record(current > sinceInMicroseconds ? current - sinceInMicroseconds : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    void MediaChannelLatency::recordShutdown(QWORD sinceInMicroseconds)
+    {
+      if (0 == sinceInMicroseconds) return;
+
+      auto &all = counters();
+      all.mShutdowns.fetch_add(1, std::memory_order_relaxed);
+
+      QWORD current = now();
+      all.mShutdown.record(current > sinceInMicroseconds ? current - sinceInMicroseconds : 0);
+    }
+
+    //-------------------------------------------------------------------------
+    IStatsReportTypes::MediaChannelStatsPtr MediaChannelLatency::createStats()
+    {
+      auto result = make_shared<IStatsReportTypes::MediaChannelStats>();
+      result->mID = IStatsReportTypes::toString(IStatsReportTypes::StatsType_MediaChannel);
+      result->mTimestamp = zsLib::now();
+
+      auto &all = counters();
+
+      QWORD requested = all.mSetupsRequested.load(std::memory_order_relaxed);
+      QWORD succeeded = all.mSetupsSucceeded.load(std::memory_order_relaxed);
+      QWORD failed = all.mSetupsFailed.load(std::memory_order_relaxed);
+
+      result->mSetupsRequested = requested;
+      result->mSetupsSucceeded = succeeded;
+      result->mSetupsFailed = failed;
+      result->mSetupsPending = SafeInt<unsigned long>(requested > (succeeded + failed) ? requested - (succeeded + failed) : 0);
+      result->mShutdowns = all.mShutdowns.load(std::memory_order_relaxed);
+      all.mSetup.snapshot(result->mSetupLatency);
+      all.mShutdown.snapshot(result->mShutdownLatency);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    MediaChannelLatency::Counters &MediaChannelLatency::counters()
+    {
+      static Counters all;
+      return all;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    StatsSubscription::StatsSubscription(
+                                         const make_private &,
+                                         IMessageQueuePtr queue,
+                                         IStatsSubscriptionDelegatePtr delegate,
+                                         IStatsProviderPtr provider,
+                                         const SamplingIntervalMap &intervals
+                                         ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mDelegate(IStatsSubscriptionDelegateProxy::create(IORTCForInternal::queueDelegate(), delegate)),
+      mProvider(provider),
+      mMinimumInterval(ISettings::getUInt(ORTC_SETTING_STATS_SUBSCRIPTION_MINIMUM_SAMPLING_INTERVAL_IN_MILLISECONDS))
+    {
+      ZS_LOG_DEBUG(debug("created"))
+
+      auto now = zsLib::now();
+
+      if (intervals.size() < 1) {
+        Milliseconds defaultInterval = normalizeInterval(Milliseconds(ISettings::getUInt(ORTC_SETTING_STATS_SUBSCRIPTION_DEFAULT_SAMPLING_INTERVAL_IN_MILLISECONDS)));
+        for (IStatsReportTypes::StatsTypes index = IStatsReportTypes::StatsType_First; index <= IStatsReportTypes::StatsType_Last; index = static_cast<IStatsReportTypes::StatsTypes>(static_cast<std::underlying_type<IStatsReportTypes::StatsTypes>::type>(index) + 1)) {
+          SamplingInfo info;
+          info.mInterval = defaultInterval;
+          info.mNextSample = now;
+          mSampling[index] = info;
+        }
+        return;
+      }
+
+      for (auto iter = intervals.begin(); iter != intervals.end(); ++iter) {
+        auto interval = normalizeInterval((*iter).second);
+        if (0 == interval.count()) continue;
+
+        SamplingInfo info;
+        info.mInterval = interval;
+        info.mNextSample = now;
+        mSampling[(*iter).first] = info;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::init()
+    {
+      AutoRecursiveLock lock(*this);
+      resetTimer();
+    }
+
+    //-------------------------------------------------------------------------
+    StatsSubscription::~StatsSubscription()
+    {
+      if (isNoop()) return;
+
+      ZS_LOG_DEBUG(log("destroyed"))
+      mThisWeak.reset();
+
+      cancel();
+    }
+
+    //-------------------------------------------------------------------------
+    StatsSubscriptionPtr StatsSubscription::convert(IStatsSubscriptionPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(StatsSubscription, object);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription => IStatsSubscription
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr StatsSubscription::toDebug(StatsSubscriptionPtr subscription)
+    {
+      if (!subscription) return ElementPtr();
+      return subscription->toDebug();
+    }
+
+    //-------------------------------------------------------------------------
+    StatsSubscriptionPtr StatsSubscription::create(
+                                                   IStatsSubscriptionDelegatePtr delegate,
+                                                   IStatsProviderPtr provider,
+                                                   const SamplingIntervalMap &intervals
+                                                   )
+    {
+      StatsSubscriptionPtr pThis(make_shared<StatsSubscription>(make_private {}, IORTCForInternal::queueORTC(), delegate, provider, intervals));
+      pThis->mThisWeak = pThis;
+      pThis->init();
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::setSamplingInterval(
+                                                StatsTypes statsType,
+                                                Milliseconds interval
+                                                )
+    {
+      AutoRecursiveLock lock(*this);
+
+      if (mShutdown) {
+        ZS_LOG_WARNING(Detail, log("cannot change sampling interval after subscription is cancelled"))
+        return;
+      }
+
+      interval = normalizeInterval(interval);
+
+      ZS_LOG_DEBUG(log("set sampling interval") + ZS_PARAM("stats type", IStatsReportTypes::toString(statsType)) + ZS_PARAM("interval (ms)", interval))
+
+      if (0 == interval.count()) {
+        mSampling.erase(statsType);
+      } else {
+        SamplingInfo info;
+        info.mInterval = interval;
+        info.mNextSample = zsLib::now();
+        mSampling[statsType] = info;
+      }
+
+      resetTimer();
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::cancel()
+    {
+      ZS_LOG_DEBUG(log("cancel called"))
+
+      AutoRecursiveLock lock(*this);
+
+      mShutdown = true;
+
+      if (mTimer) {
+        mTimer->cancel();
+        mTimer.reset();
+      }
+
+      mPendingSample.reset();
+      mPendingStatsTypes.clear();
+
+      mSampling.clear();
+      mStatStates.clear();
+      mFlattenBuffer.clear();
+
+      mProvider.reset();
+      mDelegate.reset();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::onTimer(ITimerPtr timer)
+    {
+      ZS_LOG_INSANE(log("timer") + ZS_PARAM("timer id", timer->getID()))
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (timer != mTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete timer (thus ignoring)") + ZS_PARAM("timer id", timer->getID()))
+          return;
+        }
+      }
+
+      sample();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription => IPromiseSettledDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::onPromiseSettled(PromisePtr promise)
+    {
+      if (!promise) return;
+
+      IStatsSubscriptionDelegatePtr delegate;
+      StatsDeltaPtr delta;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (!mPendingSample) return;
+        if (mPendingSample->getID() != promise->getID()) {
+          ZS_LOG_WARNING(Trace, log("notified about obsolete sample (thus ignoring)") + ZS_PARAM("promise id", promise->getID()))
+          return;
+        }
+
+        IStatsReportPtr report = mPendingSample->value();
+        mPendingSample.reset();
+
+        if (!report) {
+          ZS_LOG_WARNING(Debug, log("provider did not produce a stats report"))
+          mPendingStatsTypes.clear();
+          return;
+        }
+
+        StatsList stats;
+        auto ids = report->getStatesIDs();
+        if (ids) {
+          for (auto iter = ids->begin(); iter != ids->end(); ++iter) {
+            auto stat = report->getStats(*iter);
+            if (stat) stats.push_back(stat);
+          }
+        }
+
+        delta = createDelta(stats, mPendingStatsTypes);
+        mPendingStatsTypes.clear();
+
+        delegate = mDelegate;
+      }
+
+      notifyDelta(delegate, delta);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsSubscription::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::StatsSubscription");
+      IHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsSubscription::slog(const char *message)
+    {
+      ElementPtr objectEl = Element::create("ortc::StatsSubscription");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params StatsSubscription::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr StatsSubscription::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::StatsSubscription");
+
+      IHelper::debugAppend(resultEl, "id", mID);
+
+      IHelper::debugAppend(resultEl, "delegate", (bool)mDelegate);
+      IHelper::debugAppend(resultEl, "provider", (bool)mProvider.lock());
+
+      IHelper::debugAppend(resultEl, "minimum interval", mMinimumInterval);
+
+      if (mSampling.size() > 0) {
+        ElementPtr samplingEl = Element::create("sampling");
+        for (auto iter = mSampling.begin(); iter != mSampling.end(); ++iter) {
+          ElementPtr typeEl = Element::create("type");
+          IHelper::debugAppend(typeEl, "stats type", IStatsReportTypes::toString((*iter).first));
+          IHelper::debugAppend(typeEl, "interval", (*iter).second.mInterval);
+          IHelper::debugAppend(typeEl, "next sample", (*iter).second.mNextSample);
+          IHelper::debugAppend(samplingEl, typeEl);
+        }
+        IHelper::debugAppend(resultEl, samplingEl);
+      }
+
+      IHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
+      IHelper::debugAppend(resultEl, "timer interval", mTimerInterval);
+
+      IHelper::debugAppend(resultEl, "pending sample", mPendingSample ? mPendingSample->getID() : 0);
+      IHelper::debugAppend(resultEl, "pending stats types", mPendingStatsTypes.size());
+
+      IHelper::debugAppend(resultEl, "sequence number", mSequenceNumber);
+      IHelper::debugAppend(resultEl, "total samples", mTotalSamples);
+      IHelper::debugAppend(resultEl, "next counter key", mNextCounterKey);
+      IHelper::debugAppend(resultEl, "stat states", mStatStates.size());
+
+      IHelper::debugAppend(resultEl, "shutdown", mShutdown);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    Milliseconds StatsSubscription::normalizeInterval(Milliseconds interval) const
+    {
+      if (interval.count() <= 0) return Milliseconds();
+      if (interval < mMinimumInterval) return mMinimumInterval;
+      return interval;
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::resetTimer()
+    {
+      Milliseconds shortest {};
+
+      for (auto iter = mSampling.begin(); iter != mSampling.end(); ++iter) {
+        auto &interval = (*iter).second.mInterval;
+        if ((0 == shortest.count()) ||
+            (interval < shortest)) {
+          shortest = interval;
+        }
+      }
+
+      if ((mTimer) &&
+          (shortest == mTimerInterval)) return;
+
+      if (mTimer) {
+        mTimer->cancel();
+        mTimer.reset();
+      }
+
+      mTimerInterval = shortest;
+
+      if (0 == mTimerInterval.count()) {
+        ZS_LOG_DEBUG(log("no stats types are being sampled"))
+        return;
+      }
+
+      mTimer = ITimer::create(mThisWeak.lock(), mTimerInterval);
+      ZS_LOG_DEBUG(log("sampling timer reset") + ZS_PARAM("timer id", mTimer->getID()) + ZS_PARAM("interval (ms)", mTimerInterval))
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::sample()
+    {
+      IStatsProviderPtr provider;
+      StatsTypeSet statsTypes;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mShutdown) return;
+
+        if (mPendingSample) {
+          ZS_LOG_TRACE(log("previous sample has not completed (thus skipping sample)") + ZS_PARAM("promise id", mPendingSample->getID()))
+          return;
+        }
+
+        provider = mProvider.lock();
+        if (!provider) {
+          ZS_LOG_WARNING(Detail, log("stats provider is gone (thus cancelling subscription)"))
+          cancel();
+          return;
+        }
+
+        auto now = zsLib::now();
+
+        for (auto iter = mSampling.begin(); iter != mSampling.end(); ++iter) {
+          auto &info = (*iter).second;
+          if (info.mNextSample > now) continue;
+
+          info.mNextSample = now + info.mInterval;
+          statsTypes.insert((*iter).first);
+        }
+
+        if (statsTypes.size() < 1) return;
+
+        mPendingStatsTypes = statsTypes;
+      }
+
+      // call provider outside of lock to prevent lock inversion with the provider
+      auto directProvider = ZS_DYNAMIC_PTR_CAST(UseDirectStatsProvider, provider);
+      if (directProvider) {
+        StatsList stats;
+        if (directProvider->sampleStats(statsTypes, stats)) {
+          IStatsSubscriptionDelegatePtr delegate;
+          StatsDeltaPtr delta;
+
+          {
+            AutoRecursiveLock lock(*this);
+            if (mShutdown) return;
+
+            delta = createDelta(stats, statsTypes);
+            mPendingStatsTypes.clear();
+
+            delegate = mDelegate;
+          }
+
+          notifyDelta(delegate, delta);
+          return;
+        }
+      }
+
+      {
+        auto promise = provider->getStats(statsTypes);
+        if (!promise) {
+          ZS_LOG_WARNING(Debug, log("stats provider returned no stats promise"))
+          AutoRecursiveLock lock(*this);
+          mPendingStatsTypes.clear();
+          return;
+        }
+
+        {
+          AutoRecursiveLock lock(*this);
+          if (mShutdown) return;
+          mPendingSample = promise;
+        }
+
+        promise->thenWeak(mThisWeak.lock());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    StatsSubscription::StatsDeltaPtr StatsSubscription::createDelta(
+                                                                    const StatsList &stats,
+                                                                    const StatsTypeSet &sampledStatsTypes
+                                                                    )
+    {
+      StatsDeltaPtr delta(make_shared<StatsDelta>());
+
+      delta->mTimestamp = zsLib::now();
+
+      DWORD sample = ++mTotalSamples;
+
+      for (auto iter = stats.begin(); iter != stats.end(); ++iter) {
+        auto &stat = (*iter);
+        if (!stat) continue;
+        if (!stat->mStatsType.hasValue()) continue;
+
+        auto &id = stat->mID;
+
+        StatsTypes statsType = stat->mStatsType.value();
+        if (!sampledStatsTypes.hasStatType(statsType)) continue;
+
+        mFlattenBuffer.clear();
+        stat->flatten(mFlattenBuffer);
+
+        auto &state = mStatStates[id];
+        state.mStatsType = statsType;
+        state.mLastSample = sample;
+
+        // flatten() always emits a stat type's counters in the same order
+        // thus the position is the counter's identity and the name is only
+        // compared (by pointer first) to verify it
+        if (state.mCounters.size() > mFlattenBuffer.size()) {
+          for (size_t index = mFlattenBuffer.size(); index < state.mCounters.size(); ++index) {
+            delta->mRemovedCounters.push_back(state.mCounters[index].mKey);
+          }
+          state.mCounters.resize(mFlattenBuffer.size());
+        }
+
+        for (size_t index = 0; index < mFlattenBuffer.size(); ++index) {
+          auto &flatCounter = mFlattenBuffer[index];
+
+          StatsDelta::Counter counter;
+          counter.mValue = flatCounter.second;
+
+          bool known = (index < state.mCounters.size());
+          if (known) {
+            auto &existing = state.mCounters[index];
+            if ((existing.mName != flatCounter.first) &&
+                (0 != strcmp(existing.mName, flatCounter.first))) {
+              delta->mRemovedCounters.push_back(existing.mKey);
+              known = false;
+            }
+          } else {
+            state.mCounters.push_back(CounterState());
+          }
+
+          auto &counterState = state.mCounters[index];
+
+          if (!known) {
+            counterState.mName = flatCounter.first;
+            counterState.mKey = mNextCounterKey++;
+            counterState.mValue = flatCounter.second;
+
+            StatsDelta::CounterInfo info;
+            info.mKey = counterState.mKey;
+            info.mStatsType = statsType;
+            info.mStatID = id;
+            info.mCounterName = String(flatCounter.first);
+            delta->mNewCounters.push_back(info);
+
+            counter.mKey = counterState.mKey;
+            delta->mChangedCounters.push_back(counter);
+            continue;
+          }
+
+          if (counterState.mValue == flatCounter.second) continue;
+
+          counterState.mValue = flatCounter.second;
+          counter.mKey = counterState.mKey;
+          delta->mChangedCounters.push_back(counter);
+        }
+      }
+
+      // any stat of a sampled type which was not reported is now gone
+      for (auto iter_doNotUse = mStatStates.begin(); iter_doNotUse != mStatStates.end(); ) {
+        auto current = iter_doNotUse;
+        ++iter_doNotUse;
+
+        auto &state = (*current).second;
+        if (state.mLastSample == sample) continue;
+        if (!sampledStatsTypes.hasStatType(state.mStatsType)) continue;
+
+        for (auto iterCounter = state.mCounters.begin(); iterCounter != state.mCounters.end(); ++iterCounter) {
+          delta->mRemovedCounters.push_back((*iterCounter).mKey);
+        }
+        mStatStates.erase(current);
+      }
+
+      // sequence numbers are only consumed by deltas which are delivered
+      if (!delta->isEmpty()) delta->mSequenceNumber = ++mSequenceNumber;
+
+      return delta;
+    }
+
+    //-------------------------------------------------------------------------
+    void StatsSubscription::notifyDelta(
+                                        IStatsSubscriptionDelegatePtr delegate,
+                                        StatsDeltaPtr delta
+                                        )
+    {
+      if (!delegate) return;
+
+      if (delta->isEmpty()) {
+        ZS_LOG_INSANE(log("no counters changed"))
+        return;
+      }
+
+      ZS_LOG_TRACE(log("notifying stats delta") + ZS_PARAM("sequence number", delta->mSequenceNumber) + ZS_PARAM("new", delta->mNewCounters.size()) + ZS_PARAM("changed", delta->mChangedCounters.size()) + ZS_PARAM("removed", delta->mRemovedCounters.size()))
+
+      try {
+        delegate->onStatsSubscriptionDelta(mThisWeak.lock(), delta);
+      } catch (IStatsSubscriptionDelegateProxy::Exceptions::DelegateGone &) {
+        ZS_LOG_WARNING(Detail, log("delegate gone"))
+        cancel();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsSubscriptionFactory
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IStatsSubscriptionFactory &IStatsSubscriptionFactory::singleton()
+    {
+      return StatsSubscriptionFactory::singleton();
+    }
+
+    //-------------------------------------------------------------------------
+    StatsSubscriptionPtr IStatsSubscriptionFactory::create(
+                                                           IStatsSubscriptionDelegatePtr delegate,
+                                                           IStatsProviderPtr provider,
+                                                           const SamplingIntervalMap &intervals
+                                                           )
+    {
+      if (this) {}
+      return internal::StatsSubscription::create(delegate, provider, intervals);
+    }
+
   } // internal namespace
 
 
   //---------------------------------------------------------------------------
-  //---------------------------------------------------------------------------
-  //---------------------------------------------------------------------------
-  //---------------------------------------------------------------------------
-  #pragma mark
-  #pragma mark IStatsReportTypes
-  #pragma mark
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsReportTypes
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  Optional<IStatsReportTypes::StatsTypes> IStatsReportTypes::toStatsType(const char *type)
+  {
+    String str(type);
+    for (IStatsReportTypes::StatsTypes index = IStatsReportTypes::StatsType_First; index <= IStatsReportTypes::StatsType_Last; index = static_cast<IStatsReportTypes::StatsTypes>(static_cast<std::underlying_type<IStatsReportTypes::StatsTypes>::type>(index) + 1)) {
+      if (0 == str.compareNoCase(IStatsReportTypes::toString(index))) return index;
+    }
+
+    return Optional<StatsTypes>();
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IStatsReportTypes::toString(StatsTypes type)
+  {
+    switch (type)
+    {
+      case StatsType_InboundRTP:      return "inboundrtp";
+      case StatsType_OutboundRTP:     return "outboundrtp";
+      case StatsType_Codec:           return "codec";
+      case StatsType_SCTPTransport:   return "sctptransport";
+      case StatsType_DataChannel:     return "datachannel";
+      case StatsType_Stream:          return "stream";
+      case StatsType_Track:           return "track";
+      case StatsType_ICEGatherer:     return "icegatherer";
+      case StatsType_ICETransport:    return "icetransport";
+      case StatsType_DTLSTransport:   return "dtlstransport";
+      case StatsType_SRTPTransport:   return "srtptransport";
+      case StatsType_Certificate:     return "certificate";
+      case StatsType_Candidate:       return "candidate";
+      case StatsType_CandidatePair:   return "candidatepair";
+      case StatsType_LocalCandidate:  return "localcandidate";
+      case StatsType_RemoteCandidate: return "remotecandidate";
+      case StatsType_PacketPipeline:  return "packetpipeline";
+      case StatsType_MessageQueue:    return "messagequeue";
+      case StatsType_MediaChannel:    return "mediachannel";
+    }
+
+    return "undefined";
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IStatsReportTypes::toString(const Optional<StatsTypes> &type)
+  {
+    if (!type.hasValue()) return "";
+    return toString(type.value());
+  }
+
+  //---------------------------------------------------------------------------
+  Optional<IStatsReportTypes::StatsICECandidatePairStates> IStatsReportTypes::toCandidatePairState(const char *type)
+  {
+    String str(type);
+    for (IStatsReportTypes::StatsICECandidatePairStates index = IStatsReportTypes::StatsICECandidatePairState_First; index <= IStatsReportTypes::StatsICECandidatePairState_Last; index = static_cast<IStatsReportTypes::StatsICECandidatePairStates>(static_cast<std::underlying_type<IStatsReportTypes::StatsICECandidatePairStates>::type>(index) + 1)) {
+      if (0 == str.compareNoCase(IStatsReportTypes::toString(index))) return index;
+    }
+
+    return Optional<StatsICECandidatePairStates>();
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IStatsReportTypes::toString(StatsICECandidatePairStates state)
+  {
+    switch (state)
+    {
+      case StatsICECandidatePairState_Frozen:       return "frozen";
+      case StatsICECandidatePairState_Waiting:      return "waiting";
+      case StatsICECandidatePairState_InProgress:   return "inprogress";
+      case StatsICECandidatePairState_Failed:       return "failed";
+      case StatsICECandidatePairState_Succeeded:    return "succeeded";
+      case StatsICECandidatePairState_Cancelled:    return "cancelled";
+    }
+
+    return "undefined";
+  }
+
+  //---------------------------------------------------------------------------
+  const char *IStatsReportTypes::toString(PacketPipelineHops hop)
+  {
+    switch (hop)
+    {
+      case PacketPipelineHop_ICEGatherer:           return "iceGatherer";
+      case PacketPipelineHop_ICETransport:          return "iceTransport";
+      case PacketPipelineHop_DTLSTransport:         return "dtlsTransport";
+      case PacketPipelineHop_SRTPTransport:         return "srtpTransport";
+      case PacketPipelineHop_RTPListener:           return "rtpListener";
+      case PacketPipelineHop_ReceiverChannelQueue:  return "receiverChannelQueue";
+      case PacketPipelineHop_MediaEngineQueue:      return "mediaEngineQueue";
+      case PacketPipelineHop_EndToEnd:              return "endToEnd";
+    }
+
+    return "undefined";
+  }
+
+  //---------------------------------------------------------------------------
+  bool IStatsReportTypes::StatsTypeSet::hasStatType(StatsTypes type) const
+  {
+    if (size() < 1) return true;
+
+    auto found = find(type);
+    if (found == end()) return false;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsReportTypes::Stats
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::Stats::Stats() :
+    mTimestamp(zsLib::now()),
+    mStatsType(IStatsReportTypes::StatsType_First)
+  {
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::Stats::Stats(const Stats &op2) :
+    mTimestamp(op2.mTimestamp),
+    mStatsType(op2.mStatsType),
+    mStatsTypeOther(op2.mStatsTypeOther),
+    mID(op2.mID)
+  {
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::Stats::Stats(ElementPtr rootEl)
+  {
+    if (!rootEl) return;
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "timestamp", mTimestamp);
+    {
+      String value;
+      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "statsType", value);
+      mStatsType = IStatsReportTypes::toStatsType(value);
+      if (!mStatsType.hasValue()) {
+        mStatsTypeOther = value;
+      }
+    }
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "id", mID);
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::StatsPtr IStatsReportTypes::Stats::create(ElementPtr rootEl)
+  {
+    if (!rootEl) return StatsPtr();
+
+    auto type = IStatsReportTypes::toStatsType(rootEl->getValue());
+    if (!type.hasValue()) return make_shared<Stats>(rootEl);
+
+    switch (type)
+    {
+      case StatsType_InboundRTP:      return InboundRTPStreamStats::create(rootEl);
+      case StatsType_OutboundRTP:     return OutboundRTPStreamStats::create(rootEl);
+      case StatsType_Codec:           return Codec::create(rootEl);
+      case StatsType_SCTPTransport:   return SCTPTransportStats::create(rootEl);
+      case StatsType_DataChannel:     return DataChannelStats::create(rootEl);
+      case StatsType_Stream:          return MediaStreamStats::create(rootEl);
+      case StatsType_Track:           return MediaStreamTrackStats::create(rootEl);
+      case StatsType_ICEGatherer:     return ICEGathererStats::create(rootEl);
+      case StatsType_ICETransport:    return ICETransportStats::create(rootEl);
+      case StatsType_DTLSTransport:   return DTLSTransportStats::create(rootEl);
+      case StatsType_SRTPTransport:   return SRTPTransportStats::create(rootEl);
+      case StatsType_Certificate:     return CertificateStats::create(rootEl);
+      case StatsType_Candidate:       return ICECandidateAttributes::create(rootEl);
+      case StatsType_CandidatePair:   return ICECandidatePairStats::create(rootEl);
+      case StatsType_LocalCandidate:  return ICECandidateAttributes::create(rootEl);
+      case StatsType_RemoteCandidate: return ICECandidateAttributes::create(rootEl);
+      case StatsType_PacketPipeline:  return PacketPipelineStats::create(rootEl);
+      case StatsType_MessageQueue:    return MessageQueueStats::create(rootEl);
+      case StatsType_MediaChannel:    return MediaChannelStats::create(rootEl);
+    }
+
+    return StatsPtr();
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::StatsPtr IStatsReportTypes::Stats::convert(AnyPtr any)
+  {
+    return ZS_DYNAMIC_PTR_CAST(Stats, any);
+  }
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsReportTypes::Stats::createElement(const char *objectName) const
+  {
+    ElementPtr rootEl = Element::create(objectName);
+
+    IHelper::adoptElementValue(rootEl, "timestamp", mTimestamp);
+    IHelper::adoptElementValue(rootEl, "statsType", statsType(), false);
+    IHelper::adoptElementValue(rootEl, "id", mID, false);
+
+    if (!rootEl->hasChildren()) return ElementPtr();
+
+    return rootEl;
+  }
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsReportTypes::Stats::toDebug() const
+  {
+    return Element::create("ortc::IStatsReportTypes::Stats");
+  }
+
+  //---------------------------------------------------------------------------
+  String IStatsReportTypes::Stats::hash() const
+  {
+    auto hasher = IHasher::sha1();
+
+    hasher->update("IStatsReportTypes:Stats:");
+
+    hasher->update(mTimestamp);
+    hasher->update(":");
+    hasher->update(mStatsType);
+    hasher->update(":");
+    hasher->update(mID);
+
+    return hasher->finalizeAsString();
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::Stats::eventTrace() const
+  {
+    auto timestamp = internal::getTimestamp(mTimestamp);
+    eventTrace(timestamp);
+    internal::reportString(mID, timestamp, "statsTypeFinal", statsType());
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::Stats::eventTrace(double timestamp) const
+  {
+    internal::reportString(mID, timestamp, "statsType", statsType());
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsReportTypes::RTPStreamStats
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::RTPStreamStats::RTPStreamStats(const RTPStreamStats &op2) :
+    Stats(op2),
+    mSSRC(op2.mSSRC),
+    mAssociatedStatID(op2.mAssociatedStatID),
+    mIsRemote(op2.mIsRemote),
+    mMediaType(op2.mMediaType),
+    mMediaTrackID(op2.mMediaTrackID),
+    mTransportID(op2.mTransportID),
+    mCodecID(op2.mCodecID),
+    mFIRCount(op2.mFIRCount),
+    mPLICount(op2.mPLICount),
+    mNACKCount(op2.mNACKCount),
+    mSLICount(op2.mSLICount)
+  {
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::RTPStreamStats::RTPStreamStats(ElementPtr rootEl) :
+    Stats(rootEl)
+  {
+    if (!rootEl) return;
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "ssrc", mSSRC);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "associatedStatId", mAssociatedStatID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "isRemote", mIsRemote);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "mediaType", mMediaType);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "mediaTrackId", mMediaTrackID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "transportId", mTransportID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "codecId", mCodecID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "firCount", mFIRCount);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "pliCount", mPLICount);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "nackCount", mNACKCount);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "sliCount", mSLICount);
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::RTPStreamStatsPtr IStatsReportTypes::RTPStreamStats::create(ElementPtr rootEl)
+  {
+    if (!rootEl) return RTPStreamStatsPtr();
+    return make_shared<RTPStreamStats>(rootEl);
+  }
 
   //---------------------------------------------------------------------------
-  Optional<IStatsReportTypes::StatsTypes> IStatsReportTypes::toStatsType(const char *type)
+  IStatsReportTypes::RTPStreamStatsPtr IStatsReportTypes::RTPStreamStats::convert(AnyPtr any)
   {
-    String str(type);
-    for (IStatsReportTypes::StatsTypes index = IStatsReportTypes::StatsType_First; index <= IStatsReportTypes::StatsType_Last; index = static_cast<IStatsReportTypes::StatsTypes>(static_cast<std::underlying_type<IStatsReportTypes::StatsTypes>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IStatsReportTypes::toString(index))) return index;
-    }
-
-    return Optional<StatsTypes>();
+    return ZS_DYNAMIC_PTR_CAST(RTPStreamStats, any);
   }
 
   //---------------------------------------------------------------------------
-  const char *IStatsReportTypes::toString(StatsTypes type)
+  ElementPtr IStatsReportTypes::RTPStreamStats::createElement(const char *objectName) const
   {
-    switch (type)
-    {
-      case StatsType_InboundRTP:      return "inboundrtp";
-      case StatsType_OutboundRTP:     return "outboundrtp";
-      case StatsType_Codec:           return "codec";
-      case StatsType_SCTPTransport:   return "sctptransport";
-      case StatsType_DataChannel:     return "datachannel";
-      case StatsType_Stream:          return "stream";
-      case StatsType_Track:           return "track";
-      case StatsType_ICEGatherer:     return "icegatherer";
-      case StatsType_ICETransport:    return "icetransport";
-      case StatsType_DTLSTransport:   return "dtlstransport";
-      case StatsType_SRTPTransport:   return "srtptransport";
-      case StatsType_Certificate:     return "certificate";
-      case StatsType_Candidate:       return "candidate";
-      case StatsType_CandidatePair:   return "candidatepair";
-      case StatsType_LocalCandidate:  return "localcandidate";
-      case StatsType_RemoteCandidate: return "remotecandidate";
-    }
+    ElementPtr rootEl = Stats::createElement(objectName);
 
-    return "undefined";
+    IHelper::adoptElementValue(rootEl, "ssrc", mSSRC);
+    IHelper::adoptElementValue(rootEl, "associatedStatId", mAssociatedStatID, false);
+    IHelper::adoptElementValue(rootEl, "isRemote", mIsRemote);
+    IHelper::adoptElementValue(rootEl, "mediaType", mMediaType, false);
+    IHelper::adoptElementValue(rootEl, "mediaTrackId", mMediaTrackID, false);
+    IHelper::adoptElementValue(rootEl, "transportId", mTransportID, false);
+    IHelper::adoptElementValue(rootEl, "codecId", mCodecID, false);
+    IHelper::adoptElementValue(rootEl, "firCount", mFIRCount);
+    IHelper::adoptElementValue(rootEl, "pliCount", mPLICount);
+    IHelper::adoptElementValue(rootEl, "nackCount", mNACKCount);
+    IHelper::adoptElementValue(rootEl, "sliCount", mSLICount);
+
+    if (!rootEl->hasChildren()) return ElementPtr();
+
+    return rootEl;
   }
 
   //---------------------------------------------------------------------------
-  const char *IStatsReportTypes::toString(const Optional<StatsTypes> &type)
+  ElementPtr IStatsReportTypes::RTPStreamStats::toDebug() const
   {
-    if (!type.hasValue()) return "";
-    return toString(type.value());
+    return Element::create("ortc::IStatsReportTypes::RTPStreamStats");
   }
 
   //---------------------------------------------------------------------------
-  Optional<IStatsReportTypes::StatsICECandidatePairStates> IStatsReportTypes::toCandidatePairState(const char *type)
+  String IStatsReportTypes::RTPStreamStats::hash() const
   {
-    String str(type);
-    for (IStatsReportTypes::StatsICECandidatePairStates index = IStatsReportTypes::StatsICECandidatePairState_First; index <= IStatsReportTypes::StatsICECandidatePairState_Last; index = static_cast<IStatsReportTypes::StatsICECandidatePairStates>(static_cast<std::underlying_type<IStatsReportTypes::StatsICECandidatePairStates>::type>(index) + 1)) {
-      if (0 == str.compareNoCase(IStatsReportTypes::toString(index))) return index;
-    }
+    auto hasher = IHasher::sha1();
 
-    return Optional<StatsICECandidatePairStates>();
+    hasher->update("IStatsReportTypes:RTPStreamStats:");
+
+    hasher->update(Stats::hash());
+
+    hasher->update(mSSRC);
+    hasher->update(":");
+    hasher->update(mAssociatedStatID);
+    hasher->update(":");
+    hasher->update(mIsRemote);
+    hasher->update(":");
+    hasher->update(mMediaType);
+    hasher->update(":");
+    hasher->update(mMediaTrackID);
+    hasher->update(":");
+    hasher->update(mTransportID);
+    hasher->update(":");
+    hasher->update(mCodecID);
+    hasher->update(":");
+    hasher->update(mFIRCount);
+    hasher->update(":");
+    hasher->update(mPLICount);
+    hasher->update(":");
+    hasher->update(mNACKCount);
+    hasher->update(":");
+    hasher->update(mSLICount);
+
+    return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  const char *IStatsReportTypes::toString(StatsICECandidatePairStates state)
+  void IStatsReportTypes::RTPStreamStats::flatten(FlatCounterList &outCounters) const
   {
-    switch (state)
-    {
-      case StatsICECandidatePairState_Frozen:       return "frozen";
-      case StatsICECandidatePairState_Waiting:      return "waiting";
-      case StatsICECandidatePairState_InProgress:   return "inprogress";
-      case StatsICECandidatePairState_Failed:       return "failed";
-      case StatsICECandidatePairState_Succeeded:    return "succeeded";
-      case StatsICECandidatePairState_Cancelled:    return "cancelled";
-    }
-
-    return "undefined";
+    outCounters.push_back(FlatCounter("firCount", static_cast<double>(mFIRCount)));
+    outCounters.push_back(FlatCounter("pliCount", static_cast<double>(mPLICount)));
+    outCounters.push_back(FlatCounter("nackCount", static_cast<double>(mNACKCount)));
+    outCounters.push_back(FlatCounter("sliCount", static_cast<double>(mSLICount)));
   }
 
   //---------------------------------------------------------------------------
-  bool IStatsReportTypes::StatsTypeSet::hasStatType(StatsTypes type) const
+  void IStatsReportTypes::RTPStreamStats::eventTrace(double timestamp) const
   {
-    if (size() < 1) return true;
+    Stats::eventTrace(timestamp);
 
-    auto found = find(type);
-    if (found == end()) return false;
-    return true;
+    if (mSSRC.hasValue()) {
+      internal::reportInt64(mID, timestamp, "ssrc", SafeInt<int64_t>(mSSRC.value()));
+    }
+    internal::reportString(mID, timestamp, "associatedStatId", mAssociatedStatID);
+    internal::reportBool(mID, timestamp, "isRemote", mIsRemote);
+    internal::reportString(mID, timestamp, "mediaType", mMediaType);
+    internal::reportString(mID, timestamp, "mediaTrackId", mMediaTrackID);
+    internal::reportString(mID, timestamp, "transportId", mTransportID);
+    internal::reportString(mID, timestamp, "codecId", mCodecID);
+    internal::reportInt32(mID, timestamp, "firCount", SafeInt<int32_t>(mFIRCount));
+    internal::reportInt32(mID, timestamp, "pliCount", SafeInt<int32_t>(mPLICount));
+    internal::reportInt32(mID, timestamp, "nackCount", SafeInt<int32_t>(mNACKCount));
+    internal::reportInt32(mID, timestamp, "sliCount", SafeInt<int32_t>(mSLICount));
   }
 
   //---------------------------------------------------------------------------
@@ -635,87 +2264,175 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::Stats
+  #pragma mark IStatsReportTypes::Codec
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::Stats::Stats() :
-    mTimestamp(zsLib::now()),
-    mStatsType(IStatsReportTypes::StatsType_First)
+  IStatsReportTypes::Codec::Codec(const Codec &op2) :
+    Stats(op2),
+    mPayloadType(op2.mPayloadType),
+    mCodec(op2.mCodec),
+    mClockRate(op2.mClockRate),
+    mChannels(op2.mChannels),
+    mParameters(op2.mParameters)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::Stats::Stats(const Stats &op2) :
-    mTimestamp(op2.mTimestamp),
-    mStatsType(op2.mStatsType),
-    mStatsTypeOther(op2.mStatsTypeOther),
-    mID(op2.mID)
+  IStatsReportTypes::Codec::Codec(ElementPtr rootEl) :
+    Stats(rootEl)
+  {
+    mStatsType = IStatsReportTypes::StatsType_Codec;
+
+    if (!rootEl) return;
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "payloadType", mPayloadType);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "codec", mCodec);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "clockRate", mClockRate);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "channels", mChannels);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "parameters", mParameters);
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::CodecPtr IStatsReportTypes::Codec::create(ElementPtr rootEl)
   {
+    if (!rootEl) return CodecPtr();
+    return make_shared<Codec>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::Stats::Stats(ElementPtr rootEl)
+  IStatsReportTypes::CodecPtr IStatsReportTypes::Codec::convert(AnyPtr any)
   {
-    if (!rootEl) return;
+    return ZS_DYNAMIC_PTR_CAST(Codec, any);
+  }
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "timestamp", mTimestamp);
-    {
-      String value;
-      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "statsType", value);
-      mStatsType = IStatsReportTypes::toStatsType(value);
-      if (!mStatsType.hasValue()) {
-        mStatsTypeOther = value;
-      }
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsReportTypes::Codec::createElement(const char *objectName) const
+  {
+    ElementPtr rootEl = Stats::createElement(objectName);
+
+    IHelper::adoptElementValue(rootEl, "payloadType", mPayloadType);
+    IHelper::adoptElementValue(rootEl, "codec", mCodec, false);
+    IHelper::adoptElementValue(rootEl, "clockRate", mClockRate);
+    IHelper::adoptElementValue(rootEl, "channels", mChannels);
+    IHelper::adoptElementValue(rootEl, "parameters", mParameters, false);
+
+    if (!rootEl->hasChildren()) return ElementPtr();
+
+    return rootEl;
+  }
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsReportTypes::Codec::toDebug() const
+  {
+    return Element::create("ortc::IStatsReportTypes::Codec");
+  }
+
+  //---------------------------------------------------------------------------
+  String IStatsReportTypes::Codec::hash() const
+  {
+    auto hasher = IHasher::sha1();
+
+    hasher->update("IStatsReportTypes:Codec:");
+
+    hasher->update(Stats::hash());
+
+    hasher->update(mPayloadType);
+    hasher->update(":");
+    hasher->update(mCodec);
+    hasher->update(":");
+    hasher->update(mClockRate);
+    hasher->update(":");
+    hasher->update(mChannels);
+    hasher->update(":");
+    hasher->update(mParameters);
+    hasher->update(":");
+
+    return hasher->finalizeAsString();
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::Codec::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("clockRate", static_cast<double>(mClockRate)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::Codec::eventTrace(double timestamp) const
+  {
+    Stats::eventTrace(timestamp);
+
+    if (mPayloadType.hasValue()) {
+      internal::reportInt32(mID, timestamp, "payloadType", SafeInt<int32_t>(mPayloadType.value()));
     }
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Stats", "id", mID);
+    internal::reportString(mID, timestamp, "codec", mCodec);
+    internal::reportInt32(mID, timestamp, "clockRate", SafeInt<int32_t>(mClockRate));
+    if (mChannels.hasValue()) {
+      internal::reportInt32(mID, timestamp, "channels", SafeInt<int32_t>(mChannels.value()));
+    }
+    internal::reportString(mID, timestamp, "parameters", mParameters);
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsReportTypes::InboundRTPStreamStats
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::InboundRTPStreamStats::InboundRTPStreamStats(const InboundRTPStreamStats &op2) :
+    RTPStreamStats(op2),
+    mPacketsReceived(op2.mPacketsReceived),
+    mBytesReceived(op2.mBytesReceived),
+    mPacketsLost(op2.mPacketsLost),
+    mJitter(op2.mJitter),
+    mFractionLost(op2.mFractionLost),
+    mEndToEndDelay(op2.mEndToEndDelay)
+  {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::StatsPtr IStatsReportTypes::Stats::create(ElementPtr rootEl)
+  IStatsReportTypes::InboundRTPStreamStats::InboundRTPStreamStats(ElementPtr rootEl) :
+    RTPStreamStats(rootEl)
   {
-    if (!rootEl) return StatsPtr();
+    mStatsType = IStatsReportTypes::StatsType_InboundRTP;
 
-    auto type = IStatsReportTypes::toStatsType(rootEl->getValue());
-    if (!type.hasValue()) return make_shared<Stats>(rootEl);
+    if (!rootEl) return;
 
-    switch (type)
-    {
-      case StatsType_InboundRTP:      return InboundRTPStreamStats::create(rootEl);
-      case StatsType_OutboundRTP:     return OutboundRTPStreamStats::create(rootEl);
-      case StatsType_Codec:           return Codec::create(rootEl);
-      case StatsType_SCTPTransport:   return SCTPTransportStats::create(rootEl);
-      case StatsType_DataChannel:     return DataChannelStats::create(rootEl);
-      case StatsType_Stream:          return MediaStreamStats::create(rootEl);
-      case StatsType_Track:           return MediaStreamTrackStats::create(rootEl);
-      case StatsType_ICEGatherer:     return ICEGathererStats::create(rootEl);
-      case StatsType_ICETransport:    return ICETransportStats::create(rootEl);
-      case StatsType_DTLSTransport:   return DTLSTransportStats::create(rootEl);
-      case StatsType_SRTPTransport:   return SRTPTransportStats::create(rootEl);
-      case StatsType_Certificate:     return CertificateStats::create(rootEl);
-      case StatsType_Candidate:       return ICECandidateAttributes::create(rootEl);
-      case StatsType_CandidatePair:   return ICECandidatePairStats::create(rootEl);
-      case StatsType_LocalCandidate:  return ICECandidateAttributes::create(rootEl);
-      case StatsType_RemoteCandidate: return ICECandidateAttributes::create(rootEl);
-    }
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "packetsReceived", mPacketsReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "packetsLost", mPacketsLost);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "jitter", mJitter);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "fractionLost", mFractionLost);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "endToEndDelay", mEndToEndDelay);
+  }
 
-    return StatsPtr();
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::InboundRTPStreamStatsPtr IStatsReportTypes::InboundRTPStreamStats::create(ElementPtr rootEl)
+  {
+    if (!rootEl) return InboundRTPStreamStatsPtr();
+    return make_shared<InboundRTPStreamStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::StatsPtr IStatsReportTypes::Stats::convert(AnyPtr any)
+  IStatsReportTypes::InboundRTPStreamStatsPtr IStatsReportTypes::InboundRTPStreamStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(Stats, any);
+    return ZS_DYNAMIC_PTR_CAST(InboundRTPStreamStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::Stats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::InboundRTPStreamStats::createElement(const char *objectName) const
   {
-    ElementPtr rootEl = Element::create(objectName);
+    ElementPtr rootEl = RTPStreamStats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "timestamp", mTimestamp);
-    IHelper::adoptElementValue(rootEl, "statsType", statsType(), false);
-    IHelper::adoptElementValue(rootEl, "id", mID, false);
+    IHelper::adoptElementValue(rootEl, "packetsReceived", mPacketsReceived);
+    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "packetsLost", mPacketsLost);
+    IHelper::adoptElementValue(rootEl, "jitter", mJitter);
+    IHelper::adoptElementValue(rootEl, "fractionLost", mFractionLost);
+    IHelper::adoptElementValue(rootEl, "endToEndDelay", mEndToEndDelay);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -723,39 +2440,66 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::Stats::toDebug() const
+  ElementPtr IStatsReportTypes::InboundRTPStreamStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::Stats");
+    return Element::create("ortc::IStatsReportTypes::InboundRTPStreamStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::Stats::hash() const
+  String IStatsReportTypes::InboundRTPStreamStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:Stats:");
+    hasher->update("IStatsReportTypes:InboundRTPStreamStats:");
 
-    hasher->update(mTimestamp);
+    hasher->update(RTPStreamStats::hash());
+
+    hasher->update(mPacketsReceived);
     hasher->update(":");
-    hasher->update(mStatsType);
+    hasher->update(mBytesReceived);
+    hasher->update(":");
+    hasher->update(mPacketsLost);
+    hasher->update(":");
+    hasher->update(mJitter);
+    hasher->update(":");
+    hasher->update(mFractionLost);
+    hasher->update(":");
+    hasher->update(mEndToEndDelay);
     hasher->update(":");
-    hasher->update(mID);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::Stats::eventTrace() const
+  void IStatsReportTypes::InboundRTPStreamStats::flatten(FlatCounterList &outCounters) const
   {
-    auto timestamp = internal::getTimestamp(mTimestamp);
-    eventTrace(timestamp);
-    internal::reportString(mID, timestamp, "statsTypeFinal", statsType());
+    RTPStreamStats::flatten(outCounters);
+
+    outCounters.push_back(FlatCounter("packetsReceived", static_cast<double>(mPacketsReceived)));
+    outCounters.push_back(FlatCounter("bytesReceived", static_cast<double>(mBytesReceived)));
+    outCounters.push_back(FlatCounter("packetsLost", static_cast<double>(mPacketsLost)));
+    outCounters.push_back(FlatCounter("jitter", static_cast<double>(mJitter)));
+    outCounters.push_back(FlatCounter("fractionLost", static_cast<double>(mFractionLost)));
+    outCounters.push_back(FlatCounter("endToEndDelay", static_cast<double>(mEndToEndDelay.count())));
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::Stats::eventTrace(double timestamp) const
+  void IStatsReportTypes::InboundRTPStreamStats::eventTrace(double timestamp) const
   {
-    internal::reportString(mID, timestamp, "statsType", statsType());
+    RTPStreamStats::eventTrace(timestamp);
+
+    internal::reportInt32(mID, timestamp, "packetsReceived", SafeInt<int32_t>(mPacketsReceived));
+    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
+    internal::reportInt32(mID, timestamp, "packetsLost", SafeInt<int32_t>(mPacketsLost));
+    internal::reportFloat(mID, timestamp, "jitter", static_cast<float>(mJitter));
+    internal::reportFloat(mID, timestamp, "fractionLost", static_cast<float>(mFractionLost));
+    internal::reportInt64(mID, timestamp, "endToEndDelay", SafeInt<int64_t>(mEndToEndDelay.count()));
+#ifndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
+    internal::reportInt64(mID, timestamp, "winrtEndToEndDelayMs", SafeInt<int64_t>(mEndToEndDelay.count()));
+    internal::reportInt32(mID, timestamp, "googFirsReceived", SafeInt<int32_t>(mFIRCount));
+    internal::reportInt32(mID, timestamp, "googPlisReceived", SafeInt<int32_t>(mPLICount));
+    internal::reportInt32(mID, timestamp, "googNacksReceived", SafeInt<int32_t>(mNACKCount));
+#endif //ndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
   }
 
   //---------------------------------------------------------------------------
@@ -763,74 +2507,61 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::RTPStreamStats
+  #pragma mark IStatsReportTypes::OutboundRTPStreamStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::RTPStreamStats::RTPStreamStats(const RTPStreamStats &op2) :
-    Stats(op2),
-    mSSRC(op2.mSSRC),
-    mAssociatedStatID(op2.mAssociatedStatID),
-    mIsRemote(op2.mIsRemote),
-    mMediaType(op2.mMediaType),
-    mMediaTrackID(op2.mMediaTrackID),
-    mTransportID(op2.mTransportID),
-    mCodecID(op2.mCodecID),
-    mFIRCount(op2.mFIRCount),
-    mPLICount(op2.mPLICount),
-    mNACKCount(op2.mNACKCount),
-    mSLICount(op2.mSLICount)
+  IStatsReportTypes::OutboundRTPStreamStats::OutboundRTPStreamStats(const OutboundRTPStreamStats &op2) :
+    RTPStreamStats(op2),
+    mPacketsSent(op2.mPacketsSent),
+    mBytesSent(op2.mBytesSent),
+    mRetransmittedPacketsSent(op2.mRetransmittedPacketsSent),
+    mRetransmittedBytesSent(op2.mRetransmittedBytesSent),
+    mTargetBitrate(op2.mTargetBitrate),
+    mRoundTripTime(op2.mRoundTripTime)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::RTPStreamStats::RTPStreamStats(ElementPtr rootEl) :
-    Stats(rootEl)
+  IStatsReportTypes::OutboundRTPStreamStats::OutboundRTPStreamStats(ElementPtr rootEl) :
+    RTPStreamStats(rootEl)
   {
+    mStatsType = IStatsReportTypes::StatsType_OutboundRTP;
+
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "ssrc", mSSRC);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "associatedStatId", mAssociatedStatID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "isRemote", mIsRemote);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "mediaType", mMediaType);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "mediaTrackId", mMediaTrackID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "transportId", mTransportID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "codecId", mCodecID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "firCount", mFIRCount);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "pliCount", mPLICount);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "nackCount", mNACKCount);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::RTPStreamStats", "sliCount", mSLICount);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "packetsSent", mPacketsSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "bytesSent", mBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "retransmittedPacketsSent", mRetransmittedPacketsSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "retransmittedBytesSent", mRetransmittedBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "targetBitrate", mTargetBitrate);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "roundTripTime", mRoundTripTime);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::RTPStreamStatsPtr IStatsReportTypes::RTPStreamStats::create(ElementPtr rootEl)
+  IStatsReportTypes::OutboundRTPStreamStatsPtr IStatsReportTypes::OutboundRTPStreamStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return RTPStreamStatsPtr();
-    return make_shared<RTPStreamStats>(rootEl);
+    if (!rootEl) return OutboundRTPStreamStatsPtr();
+    return make_shared<OutboundRTPStreamStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::RTPStreamStatsPtr IStatsReportTypes::RTPStreamStats::convert(AnyPtr any)
+  IStatsReportTypes::OutboundRTPStreamStatsPtr IStatsReportTypes::OutboundRTPStreamStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(RTPStreamStats, any);
+    return ZS_DYNAMIC_PTR_CAST(OutboundRTPStreamStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::RTPStreamStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::OutboundRTPStreamStats::createElement(const char *objectName) const
   {
-    ElementPtr rootEl = Stats::createElement(objectName);
+    ElementPtr rootEl = RTPStreamStats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "ssrc", mSSRC);
-    IHelper::adoptElementValue(rootEl, "associatedStatId", mAssociatedStatID, false);
-    IHelper::adoptElementValue(rootEl, "isRemote", mIsRemote);
-    IHelper::adoptElementValue(rootEl, "mediaType", mMediaType, false);
-    IHelper::adoptElementValue(rootEl, "mediaTrackId", mMediaTrackID, false);
-    IHelper::adoptElementValue(rootEl, "transportId", mTransportID, false);
-    IHelper::adoptElementValue(rootEl, "codecId", mCodecID, false);
-    IHelper::adoptElementValue(rootEl, "firCount", mFIRCount);
-    IHelper::adoptElementValue(rootEl, "pliCount", mPLICount);
-    IHelper::adoptElementValue(rootEl, "nackCount", mNACKCount);
-    IHelper::adoptElementValue(rootEl, "sliCount", mSLICount);
+    IHelper::adoptElementValue(rootEl, "packetsSent", mPacketsSent);
+    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
+    IHelper::adoptElementValue(rootEl, "retransmittedPacketsSent", mRetransmittedPacketsSent);
+    IHelper::adoptElementValue(rootEl, "retransmittedBytesSent", mRetransmittedBytesSent);
+    IHelper::adoptElementValue(rootEl, "targetBitrate", mTargetBitrate);
+    IHelper::adoptElementValue(rootEl, "roundTripTime", mRoundTripTime);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -838,122 +2569,116 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::RTPStreamStats::toDebug() const
+  ElementPtr IStatsReportTypes::OutboundRTPStreamStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::RTPStreamStats");
+    return Element::create("ortc::IStatsReportTypes::OutboundRTPStreamStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::RTPStreamStats::hash() const
+  String IStatsReportTypes::OutboundRTPStreamStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:RTPStreamStats:");
+    hasher->update("IStatsReportTypes:OutboundRTPStreamStats:");
 
-    hasher->update(Stats::hash());
+    hasher->update(RTPStreamStats::hash());
 
-    hasher->update(mSSRC);
-    hasher->update(":");
-    hasher->update(mAssociatedStatID);
-    hasher->update(":");
-    hasher->update(mIsRemote);
-    hasher->update(":");
-    hasher->update(mMediaType);
-    hasher->update(":");
-    hasher->update(mMediaTrackID);
-    hasher->update(":");
-    hasher->update(mTransportID);
+    hasher->update(mPacketsSent);
     hasher->update(":");
-    hasher->update(mCodecID);
+    hasher->update(mBytesSent);
     hasher->update(":");
-    hasher->update(mFIRCount);
+    hasher->update(mRetransmittedPacketsSent);
     hasher->update(":");
-    hasher->update(mPLICount);
+    hasher->update(mRetransmittedBytesSent);
     hasher->update(":");
-    hasher->update(mNACKCount);
+    hasher->update(mTargetBitrate);
     hasher->update(":");
-    hasher->update(mSLICount);
+    hasher->update(mRoundTripTime);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::RTPStreamStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::OutboundRTPStreamStats::flatten(FlatCounterList &outCounters) const
   {
-    Stats::eventTrace(timestamp);
+    RTPStreamStats::flatten(outCounters);
 
-    if (mSSRC.hasValue()) {
-      internal::reportInt64(mID, timestamp, "ssrc", SafeInt<int64_t>(mSSRC.value()));
-    }
-    internal::reportString(mID, timestamp, "associatedStatId", mAssociatedStatID);
-    internal::reportBool(mID, timestamp, "isRemote", mIsRemote);
-    internal::reportString(mID, timestamp, "mediaType", mMediaType);
-    internal::reportString(mID, timestamp, "mediaTrackId", mMediaTrackID);
-    internal::reportString(mID, timestamp, "transportId", mTransportID);
-    internal::reportString(mID, timestamp, "codecId", mCodecID);
-    internal::reportInt32(mID, timestamp, "firCount", SafeInt<int32_t>(mFIRCount));
-    internal::reportInt32(mID, timestamp, "pliCount", SafeInt<int32_t>(mPLICount));
-    internal::reportInt32(mID, timestamp, "nackCount", SafeInt<int32_t>(mNACKCount));
-    internal::reportInt32(mID, timestamp, "sliCount", SafeInt<int32_t>(mSLICount));
+    outCounters.push_back(FlatCounter("packetsSent", static_cast<double>(mPacketsSent)));
+    outCounters.push_back(FlatCounter("bytesSent", static_cast<double>(mBytesSent)));
+    outCounters.push_back(FlatCounter("retransmittedPacketsSent", static_cast<double>(mRetransmittedPacketsSent)));
+    outCounters.push_back(FlatCounter("retransmittedBytesSent", static_cast<double>(mRetransmittedBytesSent)));
+    outCounters.push_back(FlatCounter("targetBitrate", static_cast<double>(mTargetBitrate)));
+    outCounters.push_back(FlatCounter("roundTripTime", static_cast<double>(mRoundTripTime)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::OutboundRTPStreamStats::eventTrace(double timestamp) const
+  {
+    RTPStreamStats::eventTrace(timestamp);
+
+    internal::reportInt32(mID, timestamp, "packetsSent", SafeInt<int32_t>(mPacketsSent));
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
+    internal::reportInt32(mID, timestamp, "retransmittedPacketsSent", SafeInt<int32_t>(mRetransmittedPacketsSent));
+    internal::reportInt64(mID, timestamp, "retransmittedBytesSent", SafeInt<int64_t>(mRetransmittedBytesSent));
+    internal::reportFloat(mID, timestamp, "targetBitrate", static_cast<float>(mTargetBitrate));
+    internal::reportFloat(mID, timestamp, "roundTripTime", static_cast<float>(mRoundTripTime));
+#ifndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
+    internal::reportFloat(mID, timestamp, "googRtt", static_cast<float>(mRoundTripTime));
+    internal::reportInt32(mID, timestamp, "googFirsSent", SafeInt<int32_t>(mFIRCount));
+    internal::reportInt32(mID, timestamp, "googPlisSent", SafeInt<int32_t>(mPLICount));
+    internal::reportInt32(mID, timestamp, "googNacksSent", SafeInt<int32_t>(mNACKCount));
+#endif //ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
   }
 
+
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::Codec
+  #pragma mark IStatsReportTypes::SCTPTransportStats
   #pragma mark
-
-  //---------------------------------------------------------------------------
-  IStatsReportTypes::Codec::Codec(const Codec &op2) :
-    Stats(op2),
-    mPayloadType(op2.mPayloadType),
-    mCodec(op2.mCodec),
-    mClockRate(op2.mClockRate),
-    mChannels(op2.mChannels),
-    mParameters(op2.mParameters)
+
+  //---------------------------------------------------------------------------
+  IStatsReportTypes::SCTPTransportStats::SCTPTransportStats(const SCTPTransportStats &op2) :
+    Stats(op2),
+    mDataChannelsOpened(op2.mDataChannelsOpened),
+    mDataChannelsClosed(op2.mDataChannelsClosed)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::Codec::Codec(ElementPtr rootEl) :
+  IStatsReportTypes::SCTPTransportStats::SCTPTransportStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_Codec;
+    mStatsType = IStatsReportTypes::StatsType_SCTPTransport;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "payloadType", mPayloadType);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "codec", mCodec);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "clockRate", mClockRate);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "channels", mChannels);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::Codec", "parameters", mParameters);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsOpened", mDataChannelsOpened);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsClosed", mDataChannelsClosed);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CodecPtr IStatsReportTypes::Codec::create(ElementPtr rootEl)
+  IStatsReportTypes::SCTPTransportStatsPtr IStatsReportTypes::SCTPTransportStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return CodecPtr();
-    return make_shared<Codec>(rootEl);
+    if (!rootEl) return SCTPTransportStatsPtr();
+    return make_shared<SCTPTransportStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CodecPtr IStatsReportTypes::Codec::convert(AnyPtr any)
+  IStatsReportTypes::SCTPTransportStatsPtr IStatsReportTypes::SCTPTransportStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(Codec, any);
+    return ZS_DYNAMIC_PTR_CAST(SCTPTransportStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::Codec::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::SCTPTransportStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "payloadType", mPayloadType);
-    IHelper::adoptElementValue(rootEl, "codec", mCodec, false);
-    IHelper::adoptElementValue(rootEl, "clockRate", mClockRate);
-    IHelper::adoptElementValue(rootEl, "channels", mChannels);
-    IHelper::adoptElementValue(rootEl, "parameters", mParameters, false);
+    IHelper::adoptElementValue(rootEl, "dataChannelsOpened", mDataChannelsOpened);
+    IHelper::adoptElementValue(rootEl, "dataChannelsClosed", mDataChannelsClosed);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -961,110 +2686,115 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::Codec::toDebug() const
+  ElementPtr IStatsReportTypes::SCTPTransportStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::Codec");
+    return Element::create("ortc::IStatsReportTypes::SCTPTransportStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::Codec::hash() const
+  String IStatsReportTypes::SCTPTransportStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:Codec:");
+    hasher->update("IStatsReportTypes:SCTPTransportStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mPayloadType);
-    hasher->update(":");
-    hasher->update(mCodec);
-    hasher->update(":");
-    hasher->update(mClockRate);
-    hasher->update(":");
-    hasher->update(mChannels);
-    hasher->update(":");
-    hasher->update(mParameters);
+    hasher->update(mDataChannelsOpened);
     hasher->update(":");
+    hasher->update(mDataChannelsClosed);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::Codec::eventTrace(double timestamp) const
+  void IStatsReportTypes::SCTPTransportStats::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("dataChannelsOpened", static_cast<double>(mDataChannelsOpened)));
+    outCounters.push_back(FlatCounter("dataChannelsClosed", static_cast<double>(mDataChannelsClosed)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::SCTPTransportStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    if (mPayloadType.hasValue()) {
-      internal::reportInt32(mID, timestamp, "payloadType", SafeInt<int32_t>(mPayloadType.value()));
-    }
-    internal::reportString(mID, timestamp, "codec", mCodec);
-    internal::reportInt32(mID, timestamp, "clockRate", SafeInt<int32_t>(mClockRate));
-    if (mChannels.hasValue()) {
-      internal::reportInt32(mID, timestamp, "channels", SafeInt<int32_t>(mChannels.value()));
-    }
-    internal::reportString(mID, timestamp, "parameters", mParameters);
+    internal::reportInt32(mID, timestamp, "dataChannelsOpen", SafeInt<int32_t>(mDataChannelsOpened));
+    internal::reportInt32(mID, timestamp, "dataChannelsClosed", SafeInt<int32_t>(mDataChannelsClosed));
   }
 
+
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::InboundRTPStreamStats
+  #pragma mark IStatsReportTypes::MediaStreamStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::InboundRTPStreamStats::InboundRTPStreamStats(const InboundRTPStreamStats &op2) :
-    RTPStreamStats(op2),
-    mPacketsReceived(op2.mPacketsReceived),
-    mBytesReceived(op2.mBytesReceived),
-    mPacketsLost(op2.mPacketsLost),
-    mJitter(op2.mJitter),
-    mFractionLost(op2.mFractionLost),
-    mEndToEndDelay(op2.mEndToEndDelay)
+  IStatsReportTypes::MediaStreamStats::MediaStreamStats(const MediaStreamStats &op2) :
+    Stats(op2),
+    mStreamID(op2.mStreamID),
+    mTrackIDs(op2.mTrackIDs)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::InboundRTPStreamStats::InboundRTPStreamStats(ElementPtr rootEl) :
-    RTPStreamStats(rootEl)
+  IStatsReportTypes::MediaStreamStats::MediaStreamStats(ElementPtr rootEl) :
+    Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_InboundRTP;
+    mStatsType = IStatsReportTypes::StatsType_Stream;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "packetsReceived", mPacketsReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "bytesReceived", mBytesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "packetsLost", mPacketsLost);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "jitter", mJitter);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "fractionLost", mFractionLost);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::InboundRTPStreamStats", "endToEndDelay", mEndToEndDelay);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsOpened", mStreamID);
+
+    {
+      ElementPtr trackIDsEl = rootEl->findFirstChildElement("trackIds");
+      if (trackIDsEl) {
+        ElementPtr trackIDEl = trackIDsEl->findFirstChildElement("trackId");
+        while (trackIDEl) {
+          String value = IHelper::getElementTextAndDecode(trackIDEl);
+          trackIDEl = trackIDEl->findNextSiblingElement("trackId");
+
+          if (value.isEmpty()) continue;
+          mTrackIDs.push_front(value);
+        }
+      }
+    }
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::InboundRTPStreamStatsPtr IStatsReportTypes::InboundRTPStreamStats::create(ElementPtr rootEl)
+  IStatsReportTypes::MediaStreamStatsPtr IStatsReportTypes::MediaStreamStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return InboundRTPStreamStatsPtr();
-    return make_shared<InboundRTPStreamStats>(rootEl);
+    if (!rootEl) return MediaStreamStatsPtr();
+    return make_shared<MediaStreamStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::InboundRTPStreamStatsPtr IStatsReportTypes::InboundRTPStreamStats::convert(AnyPtr any)
+  IStatsReportTypes::MediaStreamStatsPtr IStatsReportTypes::MediaStreamStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(InboundRTPStreamStats, any);
+    return ZS_DYNAMIC_PTR_CAST(MediaStreamStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::InboundRTPStreamStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::MediaStreamStats::createElement(const char *objectName) const
   {
-    ElementPtr rootEl = RTPStreamStats::createElement(objectName);
+    ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "packetsReceived", mPacketsReceived);
-    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
-    IHelper::adoptElementValue(rootEl, "packetsLost", mPacketsLost);
-    IHelper::adoptElementValue(rootEl, "jitter", mJitter);
-    IHelper::adoptElementValue(rootEl, "fractionLost", mFractionLost);
-    IHelper::adoptElementValue(rootEl, "endToEndDelay", mEndToEndDelay);
+    IHelper::adoptElementValue(rootEl, "streamId", mStreamID, false);
+
+    if (mTrackIDs.size() > 0) {
+      ElementPtr trackIDsEl = Element::create("trackIds");
+      for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter) {
+        auto &value = *(iter);
+        IHelper::adoptElementValue(trackIDsEl, "trackId", value, false);
+      }
+      if (trackIDsEl->hasChildren()) {
+        rootEl->adoptAsLastChild(trackIDsEl);
+      }
+    }
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1072,53 +2802,45 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::InboundRTPStreamStats::toDebug() const
+  ElementPtr IStatsReportTypes::MediaStreamStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::InboundRTPStreamStats");
+    return Element::create("ortc::IStatsReportTypes::MediaStreamStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::InboundRTPStreamStats::hash() const
+  String IStatsReportTypes::MediaStreamStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:InboundRTPStreamStats:");
+    hasher->update("IStatsReportTypes:MediaStreamStats:");
 
-    hasher->update(RTPStreamStats::hash());
+    hasher->update(Stats::hash());
 
-    hasher->update(mPacketsReceived);
-    hasher->update(":");
-    hasher->update(mBytesReceived);
-    hasher->update(":");
-    hasher->update(mPacketsLost);
-    hasher->update(":");
-    hasher->update(mJitter);
-    hasher->update(":");
-    hasher->update(mFractionLost);
-    hasher->update(":");
-    hasher->update(mEndToEndDelay);
-    hasher->update(":");
+    hasher->update(mStreamID);
+    hasher->update(":tracks:c94ff2e0568fae77366ca8824b1e22852f6933ae");
+
+    for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter) {
+      auto &value = (*iter);
+      hasher->update(":");
+      hasher->update(value);
+    }
+    hasher->update(":tracks");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::InboundRTPStreamStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::MediaStreamStats::eventTrace(double timestamp) const
   {
-    RTPStreamStats::eventTrace(timestamp);
+    Stats::eventTrace(timestamp);
 
-    internal::reportInt32(mID, timestamp, "packetsReceived", SafeInt<int32_t>(mPacketsReceived));
-    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
-    internal::reportInt32(mID, timestamp, "packetsLost", SafeInt<int32_t>(mPacketsLost));
-    internal::reportFloat(mID, timestamp, "jitter", static_cast<float>(mJitter));
-    internal::reportFloat(mID, timestamp, "fractionLost", static_cast<float>(mFractionLost));
-    internal::reportInt64(mID, timestamp, "endToEndDelay", SafeInt<int64_t>(mEndToEndDelay.count()));
-#ifndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
-    internal::reportInt64(mID, timestamp, "winrtEndToEndDelayMs", SafeInt<int64_t>(mEndToEndDelay.count()));
-    internal::reportInt32(mID, timestamp, "googFirsReceived", SafeInt<int32_t>(mFIRCount));
-    internal::reportInt32(mID, timestamp, "googPlisReceived", SafeInt<int32_t>(mPLICount));
-    internal::reportInt32(mID, timestamp, "googNacksReceived", SafeInt<int32_t>(mNACKCount));
-#endif //ndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
+    internal::reportString(mID, timestamp, "streamId", mStreamID);
+    internal::reportInt32(mID, timestamp, "tracks", SafeInt<int32_t>(mTrackIDs.size()));
+    unsigned long index = 0;
+    for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter, ++index) {
+      auto &trackID = (*iter);
+      internal::reportString(mID, timestamp, (String("trackId") + string(index)).c_str(), mStreamID);
+    }
   }
 
   //---------------------------------------------------------------------------
@@ -1126,55 +2848,114 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::OutboundRTPStreamStats
+  #pragma mark IStatsReportTypes::MediaStreamTrackStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::OutboundRTPStreamStats::OutboundRTPStreamStats(const OutboundRTPStreamStats &op2) :
-    RTPStreamStats(op2),
-    mPacketsSent(op2.mPacketsSent),
-    mBytesSent(op2.mBytesSent),
-    mTargetBitrate(op2.mTargetBitrate),
-    mRoundTripTime(op2.mRoundTripTime)
+  IStatsReportTypes::MediaStreamTrackStats::MediaStreamTrackStats(const MediaStreamTrackStats &op2) :
+    Stats(op2),
+    mTrackID(op2.mTrackID),
+    mRemoteSource(op2.mRemoteSource),
+    mSSRCIDs(op2.mSSRCIDs),
+    mFrameWidth(op2.mFrameWidth),
+    mFrameHeight(op2.mFrameHeight),
+    mFramesPerSecond(op2.mFramesPerSecond),
+    mFramesSent(op2.mFramesSent),
+    mFramesReceived(op2.mFramesReceived),
+    mFramesDecoded(op2.mFramesDecoded),
+    mFramesDropped(op2.mFramesDropped),
+    mFramesCorrupted(op2.mFramesCorrupted),
+    mAudioLevel(op2.mAudioLevel),
+    mEchoReturnLoss(op2.mEchoReturnLoss),
+    mEchoReturnLossEnhancement(op2.mEchoReturnLossEnhancement)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::OutboundRTPStreamStats::OutboundRTPStreamStats(ElementPtr rootEl) :
-    RTPStreamStats(rootEl)
+  IStatsReportTypes::MediaStreamTrackStats::MediaStreamTrackStats(ElementPtr rootEl) :
+    Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_OutboundRTP;
+    mStatsType = IStatsReportTypes::StatsType_Track;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "packetsSent", mPacketsSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "bytesSent", mBytesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "targetBitrate", mTargetBitrate);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::OutboundRTPStreamStats", "roundTripTime", mRoundTripTime);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "trackId", mTrackID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "remoteSource", mRemoteSource);
+
+    {
+      ElementPtr trackIDsEl = rootEl->findFirstChildElement("ssrcIds");
+      if (trackIDsEl) {
+        ElementPtr trackIDEl = trackIDsEl->findFirstChildElement("ssrcId");
+        while (trackIDEl) {
+          String value = IHelper::getElementText(trackIDEl);
+          trackIDEl = trackIDEl->findNextSiblingElement("ssrcId");
+          if (value.isEmpty()) continue;
+          try {
+            //HERE
+            SSRCType ssrcId = Numeric<SSRCType>(value);
+            mSSRCIDs.push_front(ssrcId);
+          } catch (const Numeric<SSRCType>::ValueOutOfRange &) {
+            ZS_LOG_WARNING(Debug, internal::slog("ssrc value out of range") + ZS_PARAM("value", value));
+          }
+        }
+      }
+    }
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "frameWidth", mFrameWidth);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "frameHeight", mFrameHeight);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesPerSecond", mFramesPerSecond);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesSent", mFramesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesReceived", mFramesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesDecoded", mFramesDecoded);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesCorrupted", mFramesCorrupted);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "audioLevel", mAudioLevel);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "echoReturnLoss", mEchoReturnLoss);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "echoReturnLossEnhancement", mEchoReturnLossEnhancement);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::OutboundRTPStreamStatsPtr IStatsReportTypes::OutboundRTPStreamStats::create(ElementPtr rootEl)
+  IStatsReportTypes::MediaStreamTrackStatsPtr IStatsReportTypes::MediaStreamTrackStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return OutboundRTPStreamStatsPtr();
-    return make_shared<OutboundRTPStreamStats>(rootEl);
+    if (!rootEl) return MediaStreamTrackStatsPtr();
+    return make_shared<MediaStreamTrackStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::OutboundRTPStreamStatsPtr IStatsReportTypes::OutboundRTPStreamStats::convert(AnyPtr any)
+  IStatsReportTypes::MediaStreamTrackStatsPtr IStatsReportTypes::MediaStreamTrackStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(OutboundRTPStreamStats, any);
+    return ZS_DYNAMIC_PTR_CAST(MediaStreamTrackStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::OutboundRTPStreamStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::MediaStreamTrackStats::createElement(const char *objectName) const
   {
-    ElementPtr rootEl = RTPStreamStats::createElement(objectName);
+    ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "packetsSent", mPacketsSent);
-    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
-    IHelper::adoptElementValue(rootEl, "targetBitrate", mTargetBitrate);
-    IHelper::adoptElementValue(rootEl, "roundTripTime", mRoundTripTime);
+    IHelper::adoptElementValue(rootEl, "trackId", mTrackID, false);
+    IHelper::adoptElementValue(rootEl, "remoteSource", mRemoteSource);
+
+    if (mSSRCIDs.size() > 0) {
+      ElementPtr ssrcIDsEl = Element::create("ssrcIds");
+      for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter) {
+        auto &value = *(iter);
+        IHelper::adoptElementValue(ssrcIDsEl, "ssrcId", value);
+      }
+      if (ssrcIDsEl->hasChildren()) {
+        rootEl->adoptAsLastChild(ssrcIDsEl);
+      }
+    }
+
+    IHelper::adoptElementValue(rootEl, "frameWidth", mFrameWidth);
+    IHelper::adoptElementValue(rootEl, "frameHeight", mFrameHeight);
+    IHelper::adoptElementValue(rootEl, "framesPerSecond", mFramesPerSecond);
+    IHelper::adoptElementValue(rootEl, "framesSent", mFramesSent);
+    IHelper::adoptElementValue(rootEl, "framesReceived", mFramesReceived);
+    IHelper::adoptElementValue(rootEl, "framesDecoded", mFramesDecoded);
+    IHelper::adoptElementValue(rootEl, "framesDropped", mFramesDropped);
+    IHelper::adoptElementValue(rootEl, "framesCorrupted", mFramesCorrupted);
+    IHelper::adoptElementValue(rootEl, "audioLevel", mAudioLevel);
+    IHelper::adoptElementValue(rootEl, "echoReturnLoss", mEchoReturnLoss);
+    IHelper::adoptElementValue(rootEl, "echoReturnLossEnhancement", mEchoReturnLossEnhancement);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1182,45 +2963,110 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::OutboundRTPStreamStats::toDebug() const
+  ElementPtr IStatsReportTypes::MediaStreamTrackStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::OutboundRTPStreamStats");
+    return Element::create("ortc::IStatsReportTypes::MediaStreamTrackStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::OutboundRTPStreamStats::hash() const
+  String IStatsReportTypes::MediaStreamTrackStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:OutboundRTPStreamStats:");
+    hasher->update("IStatsReportTypes:MediaStreamTrackStats:");
 
-    hasher->update(RTPStreamStats::hash());
+    hasher->update(Stats::hash());
 
-    hasher->update(mPacketsSent);
+    hasher->update(mTrackID);
     hasher->update(":");
-    hasher->update(mBytesSent);
+    hasher->update(mRemoteSource);
+
+    hasher->update(":ssrcs:4a2f24cc4bfc91dbd040942775fb3818851495c7");
+
+    for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter) {
+      auto &value = (*iter);
+      hasher->update(":");
+      hasher->update(value);
+    }
+    hasher->update(":ssrcs:");
+    hasher->update(mFrameWidth);
     hasher->update(":");
-    hasher->update(mTargetBitrate);
+    hasher->update(mFrameHeight);
     hasher->update(":");
-    hasher->update(mRoundTripTime);
+    hasher->update(mFramesPerSecond);
+    hasher->update(":");
+    hasher->update(mFramesSent);
+    hasher->update(":");
+    hasher->update(mFramesReceived);
+    hasher->update(":");
+    hasher->update(mFramesDecoded);
+    hasher->update(":");
+    hasher->update(mFramesDropped);
+    hasher->update(":");
+    hasher->update(mFramesCorrupted);
+    hasher->update(":");
+    hasher->update(mAudioLevel);
+    hasher->update(":");
+    hasher->update(mEchoReturnLoss);
+    hasher->update(":");
+    hasher->update(mEchoReturnLossEnhancement);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::OutboundRTPStreamStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::MediaStreamTrackStats::flatten(FlatCounterList &outCounters) const
   {
-    RTPStreamStats::eventTrace(timestamp);
+    outCounters.push_back(FlatCounter("frameWidth", static_cast<double>(mFrameWidth)));
+    outCounters.push_back(FlatCounter("frameHeight", static_cast<double>(mFrameHeight)));
+    outCounters.push_back(FlatCounter("framesPerSecond", static_cast<double>(mFramesPerSecond)));
+    outCounters.push_back(FlatCounter("framesSent", static_cast<double>(mFramesSent)));
+    outCounters.push_back(FlatCounter("framesReceived", static_cast<double>(mFramesReceived)));
+    outCounters.push_back(FlatCounter("framesDecoded", static_cast<double>(mFramesDecoded)));
+    outCounters.push_back(FlatCounter("framesDropped", static_cast<double>(mFramesDropped)));
+    outCounters.push_back(FlatCounter("framesCorrupted", static_cast<double>(mFramesCorrupted)));
+    outCounters.push_back(FlatCounter("audioLevel", static_cast<double>(mAudioLevel)));
+    outCounters.push_back(FlatCounter("echoReturnLoss", static_cast<double>(mEchoReturnLoss)));
+    outCounters.push_back(FlatCounter("echoReturnLossEnhancement", static_cast<double>(mEchoReturnLossEnhancement)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::MediaStreamTrackStats::eventTrace(double timestamp) const
+  {
+    Stats::eventTrace(timestamp);
+
+    internal::reportString(mID, timestamp, "trackId", mTrackID);
+    internal::reportBool(mID, timestamp, "remoteSource", mRemoteSource);
+    internal::reportInt32(mID, timestamp, "ssrcs", SafeInt<int32_t>(mSSRCIDs.size()));
+    unsigned long index = 0;
+    for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter, ++index) {
+      auto &ssrcID = (*iter);
+      internal::reportInt64(mID, timestamp, (String("ssrcId") + string(index)).c_str(), SafeInt<int64_t>(ssrcID));
+    }
+    internal::reportInt32(mID, timestamp, "frameWidth", SafeInt<int32_t>(mFrameWidth));
+    internal::reportInt32(mID, timestamp, "frameHeight", SafeInt<int32_t>(mFrameHeight));
+    internal::reportFloat(mID, timestamp, "framesPerSecond", static_cast<float>(mFramesPerSecond));
+    internal::reportInt32(mID, timestamp, "framesSent", SafeInt<int32_t>(mFramesSent));
+    internal::reportInt32(mID, timestamp, "framesReceived", SafeInt<int32_t>(mFramesReceived));
+    internal::reportInt32(mID, timestamp, "framesDecoded", SafeInt<int32_t>(mFramesDecoded));
+    internal::reportInt32(mID, timestamp, "framesDropped", SafeInt<int32_t>(mFramesDropped));
+    internal::reportInt32(mID, timestamp, "framesCorrupted", SafeInt<int32_t>(mFramesCorrupted));
+    internal::reportFloat(mID, timestamp, "audioLevel", static_cast<float>(mAudioLevel));
+    internal::reportFloat(mID, timestamp, "echoReturnLoss", static_cast<float>(mEchoReturnLoss));
+    internal::reportFloat(mID, timestamp, "echoReturnLossEnhancement", static_cast<float>(mEchoReturnLossEnhancement));
 
-    internal::reportInt32(mID, timestamp, "packetsSent", SafeInt<int32_t>(mPacketsSent));
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
-    internal::reportFloat(mID, timestamp, "targetBitrate", static_cast<float>(mTargetBitrate));
-    internal::reportFloat(mID, timestamp, "roundTripTime", static_cast<float>(mRoundTripTime));
 #ifndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
-    internal::reportFloat(mID, timestamp, "googRtt", static_cast<float>(mRoundTripTime));
-    internal::reportInt32(mID, timestamp, "googFirsSent", SafeInt<int32_t>(mFIRCount));
-    internal::reportInt32(mID, timestamp, "googPlisSent", SafeInt<int32_t>(mPLICount));
-    internal::reportInt32(mID, timestamp, "googNacksSent", SafeInt<int32_t>(mNACKCount));
+    if (mRemoteSource) {
+      internal::reportFloat(mID, timestamp, "googFrameHeightReceived", static_cast<float>(mFrameWidth));
+      internal::reportFloat(mID, timestamp, "googFrameWidthReceived", static_cast<float>(mFrameHeight));
+      internal::reportInt32(mID, timestamp, "googFrameRateReceived", SafeInt<int32_t>(mFramesPerSecond));
+      internal::reportFloat(mID, timestamp, "audioOutputLevel", static_cast<float>(mAudioLevel));
+    } else {
+      internal::reportFloat(mID, timestamp, "googFrameWidthSent", static_cast<float>(mFrameWidth));
+      internal::reportFloat(mID, timestamp, "googFrameHeightSent", static_cast<float>(mFrameHeight));
+      internal::reportInt32(mID, timestamp, "googFrameRateSent", SafeInt<int32_t>(mFramesPerSecond));
+      internal::reportFloat(mID, timestamp, "audioInputLevel", static_cast<float>(mAudioLevel));
+    }
 #endif //ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
   }
 
@@ -1230,49 +3076,75 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::SCTPTransportStats
+  #pragma mark IStatsReportTypes::DataChannelStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SCTPTransportStats::SCTPTransportStats(const SCTPTransportStats &op2) :
+  IStatsReportTypes::DataChannelStats::DataChannelStats(const DataChannelStats &op2) :
     Stats(op2),
-    mDataChannelsOpened(op2.mDataChannelsOpened),
-    mDataChannelsClosed(op2.mDataChannelsClosed)
+    mLabel(op2.mLabel),
+    mProtocol(op2.mProtocol),
+    mDataChannelID(op2.mDataChannelID),
+    mState(op2.mState),
+    mMessagesSent(op2.mMessagesSent),
+    mBytesSent(op2.mBytesSent),
+    mMessagesReceived(op2.mMessagesReceived),
+    mBytesReceived(op2.mBytesReceived)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SCTPTransportStats::SCTPTransportStats(ElementPtr rootEl) :
+  IStatsReportTypes::DataChannelStats::DataChannelStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_SCTPTransport;
+    mStatsType = IStatsReportTypes::StatsType_DataChannel;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsOpened", mDataChannelsOpened);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsClosed", mDataChannelsClosed);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "label", mLabel);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "protocol", mProtocol);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "datachannelId", mDataChannelID);
+
+    {
+      String str;
+      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "state", str);
+      if (str.hasData()) {
+        mState = IDataChannelTypes::toState(str);
+      }
+    }
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "messagesSent", mMessagesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "bytesSent", mBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "messagesReceived", mMessagesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "bytesReceived", mBytesReceived);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SCTPTransportStatsPtr IStatsReportTypes::SCTPTransportStats::create(ElementPtr rootEl)
+  IStatsReportTypes::DataChannelStatsPtr IStatsReportTypes::DataChannelStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return SCTPTransportStatsPtr();
-    return make_shared<SCTPTransportStats>(rootEl);
+    if (!rootEl) return DataChannelStatsPtr();
+    return make_shared<DataChannelStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SCTPTransportStatsPtr IStatsReportTypes::SCTPTransportStats::convert(AnyPtr any)
+  IStatsReportTypes::DataChannelStatsPtr IStatsReportTypes::DataChannelStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(SCTPTransportStats, any);
+    return ZS_DYNAMIC_PTR_CAST(DataChannelStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::SCTPTransportStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::DataChannelStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "dataChannelsOpened", mDataChannelsOpened);
-    IHelper::adoptElementValue(rootEl, "dataChannelsClosed", mDataChannelsClosed);
+    IHelper::adoptElementValue(rootEl, "label", mLabel, false);
+    IHelper::adoptElementValue(rootEl, "protocol", mProtocol, false);
+    IHelper::adoptElementValue(rootEl, "datachannelId", mDataChannelID);
+    IHelper::adoptElementValue(rootEl, "state", IDataChannelTypes::toString(mState), false);
+    IHelper::adoptElementValue(rootEl, "messagesSent", mMessagesSent);
+    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
+    IHelper::adoptElementValue(rootEl, "messagesReceived", mMessagesReceived);
+    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1280,108 +3152,115 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::SCTPTransportStats::toDebug() const
+  ElementPtr IStatsReportTypes::DataChannelStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::SCTPTransportStats");
+    return Element::create("ortc::IStatsReportTypes::DataChannelStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::SCTPTransportStats::hash() const
+  String IStatsReportTypes::DataChannelStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:SCTPTransportStats:");
+    hasher->update("IStatsReportTypes:DataChannelStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mDataChannelsOpened);
+    hasher->update(mLabel);
+    hasher->update(":");
+    hasher->update(mProtocol);
+    hasher->update(":");
+    hasher->update(mDataChannelID);
+    hasher->update(":");
+    hasher->update(IDataChannelTypes::toString(mState));
+    hasher->update(":");
+    hasher->update(mMessagesSent);
+    hasher->update(":");
+    hasher->update(mBytesSent);
+    hasher->update(":");
+    hasher->update(mMessagesReceived);
+    hasher->update(":");
+    hasher->update(mBytesReceived);
     hasher->update(":");
-    hasher->update(mDataChannelsClosed);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::SCTPTransportStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::DataChannelStats::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("messagesSent", static_cast<double>(mMessagesSent)));
+    outCounters.push_back(FlatCounter("bytesSent", static_cast<double>(mBytesSent)));
+    outCounters.push_back(FlatCounter("messagesReceived", static_cast<double>(mMessagesReceived)));
+    outCounters.push_back(FlatCounter("bytesReceived", static_cast<double>(mBytesReceived)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::DataChannelStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportInt32(mID, timestamp, "dataChannelsOpen", SafeInt<int32_t>(mDataChannelsOpened));
-    internal::reportInt32(mID, timestamp, "dataChannelsClosed", SafeInt<int32_t>(mDataChannelsClosed));
+    internal::reportString(mID, timestamp, "label", mLabel);
+    internal::reportString(mID, timestamp, "protocol", mProtocol);
+    internal::reportInt32(mID, timestamp, "dataChannelId", SafeInt<int32_t>(mDataChannelID));
+    internal::reportString(mID, timestamp, "state", IDataChannelTypes::toString(mState));
+    internal::reportInt32(mID, timestamp, "messagesSent", SafeInt<int32_t>(mMessagesSent));
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
+    internal::reportInt32(mID, timestamp, "messagesReceived", SafeInt<int32_t>(mMessagesReceived));
+    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
   }
 
-
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::MediaStreamStats
+  #pragma mark IStatsReportTypes::ICEGathererStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamStats::MediaStreamStats(const MediaStreamStats &op2) :
+  IStatsReportTypes::ICEGathererStats::ICEGathererStats(const ICEGathererStats &op2) :
     Stats(op2),
-    mStreamID(op2.mStreamID),
-    mTrackIDs(op2.mTrackIDs)
+    mBytesSent(op2.mBytesSent),
+    mBytesReceived(op2.mBytesReceived),
+    mRTCPGathererStatsID(op2.mRTCPGathererStatsID)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamStats::MediaStreamStats(ElementPtr rootEl) :
+  IStatsReportTypes::ICEGathererStats::ICEGathererStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_Stream;
+    mStatsType = IStatsReportTypes::StatsType_ICEGatherer;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::SCTPTransportStats", "dataChannelsOpened", mStreamID);
-
-    {
-      ElementPtr trackIDsEl = rootEl->findFirstChildElement("trackIds");
-      if (trackIDsEl) {
-        ElementPtr trackIDEl = trackIDsEl->findFirstChildElement("trackId");
-        while (trackIDEl) {
-          String value = IHelper::getElementTextAndDecode(trackIDEl);
-          trackIDEl = trackIDEl->findNextSiblingElement("trackId");
-
-          if (value.isEmpty()) continue;
-          mTrackIDs.push_front(value);
-        }
-      }
-    }
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "bytesSent", mBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "rtcpGathererStatsId", mRTCPGathererStatsID);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamStatsPtr IStatsReportTypes::MediaStreamStats::create(ElementPtr rootEl)
+  IStatsReportTypes::ICEGathererStatsPtr IStatsReportTypes::ICEGathererStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return MediaStreamStatsPtr();
-    return make_shared<MediaStreamStats>(rootEl);
+    if (!rootEl) return ICEGathererStatsPtr();
+    return make_shared<ICEGathererStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamStatsPtr IStatsReportTypes::MediaStreamStats::convert(AnyPtr any)
+  IStatsReportTypes::ICEGathererStatsPtr IStatsReportTypes::ICEGathererStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(MediaStreamStats, any);
+    return ZS_DYNAMIC_PTR_CAST(ICEGathererStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::MediaStreamStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::ICEGathererStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "streamId", mStreamID, false);
-
-    if (mTrackIDs.size() > 0) {
-      ElementPtr trackIDsEl = Element::create("trackIds");
-      for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter) {
-        auto &value = *(iter);
-        IHelper::adoptElementValue(trackIDsEl, "trackId", value, false);
-      }
-      if (trackIDsEl->hasChildren()) {
-        rootEl->adoptAsLastChild(trackIDsEl);
-      }
-    }
+    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
+    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "rtcpGathererStatsId", mRTCPGathererStatsID, false);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1389,160 +3268,105 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::MediaStreamStats::toDebug() const
+  ElementPtr IStatsReportTypes::ICEGathererStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::MediaStreamStats");
+    return Element::create("ortc::IStatsReportTypes::ICEGathererStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::MediaStreamStats::hash() const
+  String IStatsReportTypes::ICEGathererStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:MediaStreamStats:");
+    hasher->update("IStatsReportTypes:ICEGathererStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mStreamID);
-    hasher->update(":tracks:c94ff2e0568fae77366ca8824b1e22852f6933ae");
-
-    for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter) {
-      auto &value = (*iter);
-      hasher->update(":");
-      hasher->update(value);
-    }
-    hasher->update(":tracks");
+    hasher->update(mBytesSent);
+    hasher->update(":");
+    hasher->update(mBytesReceived);
+    hasher->update(":");
+    hasher->update(mRTCPGathererStatsID);
+    hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::MediaStreamStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::ICEGathererStats::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("bytesSent", static_cast<double>(mBytesSent)));
+    outCounters.push_back(FlatCounter("bytesReceived", static_cast<double>(mBytesReceived)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::ICEGathererStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "streamId", mStreamID);
-    internal::reportInt32(mID, timestamp, "tracks", SafeInt<int32_t>(mTrackIDs.size()));
-    unsigned long index = 0;
-    for (auto iter = mTrackIDs.begin(); iter != mTrackIDs.end(); ++iter, ++index) {
-      auto &trackID = (*iter);
-      internal::reportString(mID, timestamp, (String("trackId") + string(index)).c_str(), mStreamID);
-    }
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesReceived));
+    internal::reportString(mID, timestamp, "rtcpGathererStatsId", mRTCPGathererStatsID);
   }
 
+
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::MediaStreamTrackStats
+  #pragma mark IStatsReportTypes::ICETransportStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamTrackStats::MediaStreamTrackStats(const MediaStreamTrackStats &op2) :
+  IStatsReportTypes::ICETransportStats::ICETransportStats(const ICETransportStats &op2) :
     Stats(op2),
-    mTrackID(op2.mTrackID),
-    mRemoteSource(op2.mRemoteSource),
-    mSSRCIDs(op2.mSSRCIDs),
-    mFrameWidth(op2.mFrameWidth),
-    mFrameHeight(op2.mFrameHeight),
-    mFramesPerSecond(op2.mFramesPerSecond),
-    mFramesSent(op2.mFramesSent),
-    mFramesReceived(op2.mFramesReceived),
-    mFramesDecoded(op2.mFramesDecoded),
-    mFramesDropped(op2.mFramesDropped),
-    mFramesCorrupted(op2.mFramesCorrupted),
-    mAudioLevel(op2.mAudioLevel),
-    mEchoReturnLoss(op2.mEchoReturnLoss),
-    mEchoReturnLossEnhancement(op2.mEchoReturnLossEnhancement)
+    mBytesSent(op2.mBytesSent),
+    mBytesReceived(op2.mBytesReceived),
+    mRTCPTransportStatsID(op2.mRTCPTransportStatsID),
+    mActiveConnection(op2.mActiveConnection),
+    mSelectedCandidatePairID(op2.mSelectedCandidatePairID)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamTrackStats::MediaStreamTrackStats(ElementPtr rootEl) :
+  IStatsReportTypes::ICETransportStats::ICETransportStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_Track;
+    mStatsType = IStatsReportTypes::StatsType_ICETransport;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "trackId", mTrackID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "remoteSource", mRemoteSource);
-
-    {
-      ElementPtr trackIDsEl = rootEl->findFirstChildElement("ssrcIds");
-      if (trackIDsEl) {
-        ElementPtr trackIDEl = trackIDsEl->findFirstChildElement("ssrcId");
-        while (trackIDEl) {
-          String value = IHelper::getElementText(trackIDEl);
-          trackIDEl = trackIDEl->findNextSiblingElement("ssrcId");
-          if (value.isEmpty()) continue;
-          try {
-            //HERE
-            SSRCType ssrcId = Numeric<SSRCType>(value);
-            mSSRCIDs.push_front(ssrcId);
-          } catch (const Numeric<SSRCType>::ValueOutOfRange &) {
-            ZS_LOG_WARNING(Debug, internal::slog("ssrc value out of range") + ZS_PARAM("value", value));
-          }
-        }
-      }
-    }
-
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "frameWidth", mFrameWidth);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "frameHeight", mFrameHeight);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesPerSecond", mFramesPerSecond);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesSent", mFramesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesReceived", mFramesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesDecoded", mFramesDecoded);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "framesCorrupted", mFramesCorrupted);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "audioLevel", mAudioLevel);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "echoReturnLoss", mEchoReturnLoss);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaStreamTrackStats", "echoReturnLossEnhancement", mEchoReturnLossEnhancement);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "bytesSent", mBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "rtcpTransportStatsId", mRTCPTransportStatsID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "activeConnection", mActiveConnection);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "selectedCandidatePairId", mSelectedCandidatePairID);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamTrackStatsPtr IStatsReportTypes::MediaStreamTrackStats::create(ElementPtr rootEl)
+  IStatsReportTypes::ICETransportStatsPtr IStatsReportTypes::ICETransportStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return MediaStreamTrackStatsPtr();
-    return make_shared<MediaStreamTrackStats>(rootEl);
+    if (!rootEl) return ICETransportStatsPtr();
+    return make_shared<ICETransportStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::MediaStreamTrackStatsPtr IStatsReportTypes::MediaStreamTrackStats::convert(AnyPtr any)
+  IStatsReportTypes::ICETransportStatsPtr IStatsReportTypes::ICETransportStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(MediaStreamTrackStats, any);
+    return ZS_DYNAMIC_PTR_CAST(ICETransportStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::MediaStreamTrackStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::ICETransportStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "trackId", mTrackID, false);
-    IHelper::adoptElementValue(rootEl, "remoteSource", mRemoteSource);
-
-    if (mSSRCIDs.size() > 0) {
-      ElementPtr ssrcIDsEl = Element::create("ssrcIds");
-      for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter) {
-        auto &value = *(iter);
-        IHelper::adoptElementValue(ssrcIDsEl, "ssrcId", value);
-      }
-      if (ssrcIDsEl->hasChildren()) {
-        rootEl->adoptAsLastChild(ssrcIDsEl);
-      }
-    }
-
-    IHelper::adoptElementValue(rootEl, "frameWidth", mFrameWidth);
-    IHelper::adoptElementValue(rootEl, "frameHeight", mFrameHeight);
-    IHelper::adoptElementValue(rootEl, "framesPerSecond", mFramesPerSecond);
-    IHelper::adoptElementValue(rootEl, "framesSent", mFramesSent);
-    IHelper::adoptElementValue(rootEl, "framesReceived", mFramesReceived);
-    IHelper::adoptElementValue(rootEl, "framesDecoded", mFramesDecoded);
-    IHelper::adoptElementValue(rootEl, "framesDropped", mFramesDropped);
-    IHelper::adoptElementValue(rootEl, "framesCorrupted", mFramesCorrupted);
-    IHelper::adoptElementValue(rootEl, "audioLevel", mAudioLevel);
-    IHelper::adoptElementValue(rootEl, "echoReturnLoss", mEchoReturnLoss);
-    IHelper::adoptElementValue(rootEl, "echoReturnLossEnhancement", mEchoReturnLossEnhancement);
+    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
+    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "rtcpTransportStatsId", mRTCPTransportStatsID, false);
+    IHelper::adoptElementValue(rootEl, "activeConnection", mActiveConnection);
+    IHelper::adoptElementValue(rootEl, "selectedCandidatePairId", mSelectedCandidatePairID, false);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1550,95 +3374,51 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::MediaStreamTrackStats::toDebug() const
+  ElementPtr IStatsReportTypes::ICETransportStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::MediaStreamTrackStats");
+    return Element::create("ortc::IStatsReportTypes::ICETransportStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::MediaStreamTrackStats::hash() const
+  String IStatsReportTypes::ICETransportStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:MediaStreamTrackStats:");
+    hasher->update("IStatsReportTypes:ICETransportStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mTrackID);
-    hasher->update(":");
-    hasher->update(mRemoteSource);
-
-    hasher->update(":ssrcs:4a2f24cc4bfc91dbd040942775fb3818851495c7");
-
-    for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter) {
-      auto &value = (*iter);
-      hasher->update(":");
-      hasher->update(value);
-    }
-    hasher->update(":ssrcs:");
-    hasher->update(mFrameWidth);
-    hasher->update(":");
-    hasher->update(mFrameHeight);
-    hasher->update(":");
-    hasher->update(mFramesPerSecond);
-    hasher->update(":");
-    hasher->update(mFramesSent);
-    hasher->update(":");
-    hasher->update(mFramesReceived);
-    hasher->update(":");
-    hasher->update(mFramesDecoded);
+    hasher->update(mBytesSent);
     hasher->update(":");
-    hasher->update(mFramesDropped);
+    hasher->update(mBytesReceived);
     hasher->update(":");
-    hasher->update(mFramesCorrupted);
+    hasher->update(mRTCPTransportStatsID);
     hasher->update(":");
-    hasher->update(mAudioLevel);
+    hasher->update(mActiveConnection);
     hasher->update(":");
-    hasher->update(mEchoReturnLoss);
+    hasher->update(mSelectedCandidatePairID);
     hasher->update(":");
-    hasher->update(mEchoReturnLossEnhancement);
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::MediaStreamTrackStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::ICETransportStats::flatten(FlatCounterList &outCounters) const
   {
-    Stats::eventTrace(timestamp);
+    outCounters.push_back(FlatCounter("bytesSent", static_cast<double>(mBytesSent)));
+    outCounters.push_back(FlatCounter("bytesReceived", static_cast<double>(mBytesReceived)));
+  }
 
-    internal::reportString(mID, timestamp, "trackId", mTrackID);
-    internal::reportBool(mID, timestamp, "remoteSource", mRemoteSource);
-    internal::reportInt32(mID, timestamp, "ssrcs", SafeInt<int32_t>(mSSRCIDs.size()));
-    unsigned long index = 0;
-    for (auto iter = mSSRCIDs.begin(); iter != mSSRCIDs.end(); ++iter, ++index) {
-      auto &ssrcID = (*iter);
-      internal::reportInt64(mID, timestamp, (String("ssrcId") + string(index)).c_str(), SafeInt<int64_t>(ssrcID));
-    }
-    internal::reportInt32(mID, timestamp, "frameWidth", SafeInt<int32_t>(mFrameWidth));
-    internal::reportInt32(mID, timestamp, "frameHeight", SafeInt<int32_t>(mFrameHeight));
-    internal::reportFloat(mID, timestamp, "framesPerSecond", static_cast<float>(mFramesPerSecond));
-    internal::reportInt32(mID, timestamp, "framesSent", SafeInt<int32_t>(mFramesSent));
-    internal::reportInt32(mID, timestamp, "framesReceived", SafeInt<int32_t>(mFramesReceived));
-    internal::reportInt32(mID, timestamp, "framesDecoded", SafeInt<int32_t>(mFramesDecoded));
-    internal::reportInt32(mID, timestamp, "framesDropped", SafeInt<int32_t>(mFramesDropped));
-    internal::reportInt32(mID, timestamp, "framesCorrupted", SafeInt<int32_t>(mFramesCorrupted));
-    internal::reportFloat(mID, timestamp, "audioLevel", static_cast<float>(mAudioLevel));
-    internal::reportFloat(mID, timestamp, "echoReturnLoss", static_cast<float>(mEchoReturnLoss));
-    internal::reportFloat(mID, timestamp, "echoReturnLossEnhancement", static_cast<float>(mEchoReturnLossEnhancement));
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::ICETransportStats::eventTrace(double timestamp) const
+  {
+    Stats::eventTrace(timestamp);
 
-#ifndef ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
-    if (mRemoteSource) {
-      internal::reportFloat(mID, timestamp, "googFrameHeightReceived", static_cast<float>(mFrameWidth));
-      internal::reportFloat(mID, timestamp, "googFrameWidthReceived", static_cast<float>(mFrameHeight));
-      internal::reportInt32(mID, timestamp, "googFrameRateReceived", SafeInt<int32_t>(mFramesPerSecond));
-      internal::reportFloat(mID, timestamp, "audioOutputLevel", static_cast<float>(mAudioLevel));
-    } else {
-      internal::reportFloat(mID, timestamp, "googFrameWidthSent", static_cast<float>(mFrameWidth));
-      internal::reportFloat(mID, timestamp, "googFrameHeightSent", static_cast<float>(mFrameHeight));
-      internal::reportInt32(mID, timestamp, "googFrameRateSent", SafeInt<int32_t>(mFramesPerSecond));
-      internal::reportFloat(mID, timestamp, "audioInputLevel", static_cast<float>(mAudioLevel));
-    }
-#endif //ORTC_EXCLUDE_WEBRTC_COMPATIBILITY_STATS
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesReceived));
+    internal::reportString(mID, timestamp, "rtcpTransportStatsId", mRTCPTransportStatsID);
+    internal::reportBool(mID, timestamp, "activeConnection", mActiveConnection);
+    internal::reportString(mID, timestamp, "selectedCandidatePairId", mSelectedCandidatePairID);
   }
 
 
@@ -1647,75 +3427,49 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::DataChannelStats
+  #pragma mark IStatsReportTypes::DTLSTransportStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DataChannelStats::DataChannelStats(const DataChannelStats &op2) :
+  IStatsReportTypes::DTLSTransportStats::DTLSTransportStats(const DTLSTransportStats &op2) :
     Stats(op2),
-    mLabel(op2.mLabel),
-    mProtocol(op2.mProtocol),
-    mDataChannelID(op2.mDataChannelID),
-    mState(op2.mState),
-    mMessagesSent(op2.mMessagesSent),
-    mBytesSent(op2.mBytesSent),
-    mMessagesReceived(op2.mMessagesReceived),
-    mBytesReceived(op2.mBytesReceived)
+    mLocalCertificateID(op2.mLocalCertificateID),
+    mRemoteCertificateID(op2.mRemoteCertificateID)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DataChannelStats::DataChannelStats(ElementPtr rootEl) :
+  IStatsReportTypes::DTLSTransportStats::DTLSTransportStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_DataChannel;
+    mStatsType = IStatsReportTypes::StatsType_DTLSTransport;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "label", mLabel);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "protocol", mProtocol);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "datachannelId", mDataChannelID);
-
-    {
-      String str;
-      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "state", str);
-      if (str.hasData()) {
-        mState = IDataChannelTypes::toState(str);
-      }
-    }
-
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "messagesSent", mMessagesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "bytesSent", mBytesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "messagesReceived", mMessagesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DataChannelStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DTLSTransportStats", "localCertificateId", mLocalCertificateID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DTLSTransportStats", "remoteCertificateId", mRemoteCertificateID);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DataChannelStatsPtr IStatsReportTypes::DataChannelStats::create(ElementPtr rootEl)
+  IStatsReportTypes::DTLSTransportStatsPtr IStatsReportTypes::DTLSTransportStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return DataChannelStatsPtr();
-    return make_shared<DataChannelStats>(rootEl);
+    if (!rootEl) return DTLSTransportStatsPtr();
+    return make_shared<DTLSTransportStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DataChannelStatsPtr IStatsReportTypes::DataChannelStats::convert(AnyPtr any)
+  IStatsReportTypes::DTLSTransportStatsPtr IStatsReportTypes::DTLSTransportStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(DataChannelStats, any);
+    return ZS_DYNAMIC_PTR_CAST(DTLSTransportStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::DataChannelStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::DTLSTransportStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "label", mLabel, false);
-    IHelper::adoptElementValue(rootEl, "protocol", mProtocol, false);
-    IHelper::adoptElementValue(rootEl, "datachannelId", mDataChannelID);
-    IHelper::adoptElementValue(rootEl, "state", IDataChannelTypes::toString(mState), false);
-    IHelper::adoptElementValue(rootEl, "messagesSent", mMessagesSent);
-    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
-    IHelper::adoptElementValue(rootEl, "messagesReceived", mMessagesReceived);
-    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "localCertificateId", mLocalCertificateID, false);
+    IHelper::adoptElementValue(rootEl, "remoteCertificateId", mRemoteCertificateID, false);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1723,145 +3477,108 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::DataChannelStats::toDebug() const
+  ElementPtr IStatsReportTypes::DTLSTransportStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::DataChannelStats");
+    return Element::create("ortc::IStatsReportTypes::DTLSTransportStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::DataChannelStats::hash() const
+  String IStatsReportTypes::DTLSTransportStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:DataChannelStats:");
+    hasher->update("IStatsReportTypes:DTLSTransportStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mLabel);
-    hasher->update(":");
-    hasher->update(mProtocol);
-    hasher->update(":");
-    hasher->update(mDataChannelID);
-    hasher->update(":");
-    hasher->update(IDataChannelTypes::toString(mState));
-    hasher->update(":");
-    hasher->update(mMessagesSent);
-    hasher->update(":");
-    hasher->update(mBytesSent);
-    hasher->update(":");
-    hasher->update(mMessagesReceived);
+    hasher->update(mLocalCertificateID);
     hasher->update(":");
-    hasher->update(mBytesReceived);
+    hasher->update(mRemoteCertificateID);
     hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::DataChannelStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::DTLSTransportStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "label", mLabel);
-    internal::reportString(mID, timestamp, "protocol", mProtocol);
-    internal::reportInt32(mID, timestamp, "dataChannelId", SafeInt<int32_t>(mDataChannelID));
-    internal::reportString(mID, timestamp, "state", IDataChannelTypes::toString(mState));
-    internal::reportInt32(mID, timestamp, "messagesSent", SafeInt<int32_t>(mMessagesSent));
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
-    internal::reportInt32(mID, timestamp, "messagesReceived", SafeInt<int32_t>(mMessagesReceived));
-    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
+    internal::reportString(mID, timestamp, "localCertificateId", mLocalCertificateID);
+    internal::reportString(mID, timestamp, "remoteCertificateId", mRemoteCertificateID);
   }
 
+
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::ICEGathererStats
+  #pragma mark IStatsReportTypes::SRTPTransportStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICEGathererStats::ICEGathererStats(const ICEGathererStats &op2) :
-    Stats(op2),
-    mBytesSent(op2.mBytesSent),
-    mBytesReceived(op2.mBytesReceived),
-    mRTCPGathererStatsID(op2.mRTCPGathererStatsID)
+  IStatsReportTypes::SRTPTransportStats::SRTPTransportStats(const SRTPTransportStats &op2) :
+    Stats(op2)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICEGathererStats::ICEGathererStats(ElementPtr rootEl) :
+  IStatsReportTypes::SRTPTransportStats::SRTPTransportStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_ICEGatherer;
+    mStatsType = IStatsReportTypes::StatsType_SRTPTransport;
 
     if (!rootEl) return;
-
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "bytesSent", mBytesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "bytesReceived", mBytesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICEGathererStats", "rtcpGathererStatsId", mRTCPGathererStatsID);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICEGathererStatsPtr IStatsReportTypes::ICEGathererStats::create(ElementPtr rootEl)
+  IStatsReportTypes::SRTPTransportStatsPtr IStatsReportTypes::SRTPTransportStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return ICEGathererStatsPtr();
-    return make_shared<ICEGathererStats>(rootEl);
+    if (!rootEl) return SRTPTransportStatsPtr();
+    return make_shared<SRTPTransportStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICEGathererStatsPtr IStatsReportTypes::ICEGathererStats::convert(AnyPtr any)
+  IStatsReportTypes::SRTPTransportStatsPtr IStatsReportTypes::SRTPTransportStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(ICEGathererStats, any);
+    return ZS_DYNAMIC_PTR_CAST(SRTPTransportStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICEGathererStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::SRTPTransportStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
-    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
-    IHelper::adoptElementValue(rootEl, "rtcpGathererStatsId", mRTCPGathererStatsID, false);
-
     if (!rootEl->hasChildren()) return ElementPtr();
 
     return rootEl;
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICEGathererStats::toDebug() const
+  ElementPtr IStatsReportTypes::SRTPTransportStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::ICEGathererStats");
+    return Element::create("ortc::IStatsReportTypes::SRTPTransportStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::ICEGathererStats::hash() const
+  String IStatsReportTypes::SRTPTransportStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:ICEGathererStats:");
+    hasher->update("IStatsReportTypes:SRTPTransportStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mBytesSent);
-    hasher->update(":");
-    hasher->update(mBytesReceived);
-    hasher->update(":");
-    hasher->update(mRTCPGathererStatsID);
     hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::ICEGathererStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::SRTPTransportStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
-
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesReceived));
-    internal::reportString(mID, timestamp, "rtcpGathererStatsId", mRTCPGathererStatsID);
   }
 
 
@@ -1870,58 +3587,76 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::ICETransportStats
+  #pragma mark IStatsReportTypes::ICECandidateAttributes
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICETransportStats::ICETransportStats(const ICETransportStats &op2) :
+  IStatsReportTypes::ICECandidateAttributes::ICECandidateAttributes(const ICECandidateAttributes &op2) :
     Stats(op2),
-    mBytesSent(op2.mBytesSent),
-    mBytesReceived(op2.mBytesReceived),
-    mRTCPTransportStatsID(op2.mRTCPTransportStatsID),
-    mActiveConnection(op2.mActiveConnection),
-    mSelectedCandidatePairID(op2.mSelectedCandidatePairID)
+    mRelatedID(op2.mRelatedID),
+    mIPAddress(op2.mIPAddress),
+    mPortNumber(op2.mPortNumber),
+    mTransport(op2.mTransport),
+    mCandidateType(op2.mCandidateType),
+    mPriority(op2.mPriority),
+    mAddressSourceURL(op2.mAddressSourceURL)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICETransportStats::ICETransportStats(ElementPtr rootEl) :
+  IStatsReportTypes::ICECandidateAttributes::ICECandidateAttributes(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_ICETransport;
+    mStatsType = IStatsReportTypes::StatsType_Candidate;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "bytesSent", mBytesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "bytesReceived", mBytesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "rtcpTransportStatsId", mRTCPTransportStatsID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "activeConnection", mActiveConnection);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICETransportStats", "selectedCandidatePairId", mSelectedCandidatePairID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "relatedId", mRelatedID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "ipAddress", mIPAddress);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "portNumber", mPortNumber);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "transport", mTransport);
+
+    {
+      String str;
+      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "candidateType", str);
+      if (str.hasData()) {
+        try {
+          mCandidateType = IICETypes::toCandidateType(str);
+        } catch (const InvalidParameters &) {
+          ZS_LOG_WARNING(Debug, internal::slog("candidate type is not value") + ZS_PARAM("type", str));
+        }
+      }
+    }
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "priority", mPriority);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "addressSourceUrl", mAddressSourceURL);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICETransportStatsPtr IStatsReportTypes::ICETransportStats::create(ElementPtr rootEl)
+  IStatsReportTypes::ICECandidateAttributesPtr IStatsReportTypes::ICECandidateAttributes::create(ElementPtr rootEl)
   {
-    if (!rootEl) return ICETransportStatsPtr();
-    return make_shared<ICETransportStats>(rootEl);
+    if (!rootEl) return ICECandidateAttributesPtr();
+    return make_shared<ICECandidateAttributes>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICETransportStatsPtr IStatsReportTypes::ICETransportStats::convert(AnyPtr any)
+  IStatsReportTypes::ICECandidateAttributesPtr IStatsReportTypes::ICECandidateAttributes::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(ICETransportStats, any);
+    return ZS_DYNAMIC_PTR_CAST(ICECandidateAttributes, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICETransportStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::ICECandidateAttributes::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
-    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
-    IHelper::adoptElementValue(rootEl, "rtcpTransportStatsId", mRTCPTransportStatsID, false);
-    IHelper::adoptElementValue(rootEl, "activeConnection", mActiveConnection);
-    IHelper::adoptElementValue(rootEl, "selectedCandidatePairId", mSelectedCandidatePairID, false);
+    IHelper::adoptElementValue(rootEl, "relatedId", mRelatedID, false);
+    IHelper::adoptElementValue(rootEl, "ipAddress", mIPAddress, false);
+    IHelper::adoptElementValue(rootEl, "portNumber", mPortNumber);
+    IHelper::adoptElementValue(rootEl, "transport", mTransport, false);
+    IHelper::adoptElementValue(rootEl, "candidateType", IICETypes::toString(mCandidateType), false);
+    IHelper::adoptElementValue(rootEl, "priority", mPriority);
+    IHelper::adoptElementValue(rootEl, "addressSourceUrl", mAddressSourceURL, false);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -1929,95 +3664,145 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICETransportStats::toDebug() const
+  ElementPtr IStatsReportTypes::ICECandidateAttributes::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::ICETransportStats");
+    return Element::create("ortc::IStatsReportTypes::ICECandidateAttributes");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::ICETransportStats::hash() const
+  String IStatsReportTypes::ICECandidateAttributes::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:ICETransportStats:");
+    hasher->update("IStatsReportTypes:ICECandidateAttributes:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mBytesSent);
+    hasher->update(mRelatedID);
     hasher->update(":");
-    hasher->update(mBytesReceived);
+    hasher->update(mIPAddress);
     hasher->update(":");
-    hasher->update(mRTCPTransportStatsID);
+    hasher->update(mPortNumber);
     hasher->update(":");
-    hasher->update(mActiveConnection);
+    hasher->update(mTransport);
+    hasher->update(":");
+    hasher->update(IICETypes::toString(mCandidateType));
+    hasher->update(":");
+    hasher->update(mPriority);
     hasher->update(":");
-    hasher->update(mSelectedCandidatePairID);
+    hasher->update(mAddressSourceURL);
     hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::ICETransportStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::ICECandidateAttributes::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesReceived));
-    internal::reportString(mID, timestamp, "rtcpTransportStatsId", mRTCPTransportStatsID);
-    internal::reportBool(mID, timestamp, "activeConnection", mActiveConnection);
-    internal::reportString(mID, timestamp, "selectedCandidatePairId", mSelectedCandidatePairID);
+    internal::reportString(mID, timestamp, "relatedId", mRelatedID);
+    internal::reportString(mID, timestamp, "ipAddress", mIPAddress);
+    internal::reportInt32(mID, timestamp, "portNumber", SafeInt<int32_t>(mPortNumber));
+    internal::reportString(mID, timestamp, "transport", mTransport);
+    internal::reportString(mID, timestamp, "candidateType", IICETypes::toString(mCandidateType));
+    internal::reportInt64(mID, timestamp, "priority", SafeInt<int64_t>(mPriority));
+    internal::reportString(mID, timestamp, "addressSourceUrl", mAddressSourceURL);
   }
 
-
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::DTLSTransportStats
+  #pragma mark IStatsReportTypes::ICECandidatePairStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DTLSTransportStats::DTLSTransportStats(const DTLSTransportStats &op2) :
+  IStatsReportTypes::ICECandidatePairStats::ICECandidatePairStats(const ICECandidatePairStats &op2) :
     Stats(op2),
-    mLocalCertificateID(op2.mLocalCertificateID),
-    mRemoteCertificateID(op2.mRemoteCertificateID)
+    mTransportID(op2.mTransportID),
+    mLocalCandidateID(op2.mLocalCandidateID),
+    mRemoteCandidateID(op2.mRemoteCandidateID),
+    mState(op2.mState),
+    mPriority(op2.mPriority),
+    mNominated(op2.mNominated),
+    mWritable(op2.mWritable),
+    mReadable(op2.mReadable),
+    mBytesSent(op2.mBytesSent),
+    mBytesReceived(op2.mBytesReceived),
+    mRoundTripTime(op2.mRoundTripTime),
+    mAvailableOutgoingBitrate(op2.mAvailableOutgoingBitrate),
+    mAvailableIncomingBitrate(op2.mAvailableIncomingBitrate)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DTLSTransportStats::DTLSTransportStats(ElementPtr rootEl) :
+  IStatsReportTypes::ICECandidatePairStats::ICECandidatePairStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_DTLSTransport;
+    mStatsType = IStatsReportTypes::StatsType_CandidatePair;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DTLSTransportStats", "localCertificateId", mLocalCertificateID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::DTLSTransportStats", "remoteCertificateId", mRemoteCertificateID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "transportId", mTransportID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "localCandidateId", mLocalCandidateID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "remoteCandidateId", mRemoteCandidateID);
+
+    {
+      String str;
+      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "state", str);
+      if (str.hasData()) {
+        try {
+          mState = IStatsReportTypes::toCandidatePairState(str);
+        } catch (const InvalidParameters &) {
+          ZS_LOG_WARNING(Debug, internal::slog("candidate pair state is not value") + ZS_PARAM("type", str));
+        }
+      }
+    }
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "priority", mPriority);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "nominated", mNominated);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "writable", mWritable);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "readable", mReadable);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesSent", mBytesSent);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesReceived", mBytesReceived);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "roundTripTime", mRoundTripTime);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableOutgoingBitrate", mAvailableOutgoingBitrate);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableIncomingBitrate", mAvailableIncomingBitrate);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DTLSTransportStatsPtr IStatsReportTypes::DTLSTransportStats::create(ElementPtr rootEl)
+  IStatsReportTypes::ICECandidatePairStatsPtr IStatsReportTypes::ICECandidatePairStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return DTLSTransportStatsPtr();
-    return make_shared<DTLSTransportStats>(rootEl);
+    if (!rootEl) return ICECandidatePairStatsPtr();
+    return make_shared<ICECandidatePairStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::DTLSTransportStatsPtr IStatsReportTypes::DTLSTransportStats::convert(AnyPtr any)
+  IStatsReportTypes::ICECandidatePairStatsPtr IStatsReportTypes::ICECandidatePairStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(DTLSTransportStats, any);
+    return ZS_DYNAMIC_PTR_CAST(ICECandidatePairStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::DTLSTransportStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::ICECandidatePairStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "localCertificateId", mLocalCertificateID, false);
-    IHelper::adoptElementValue(rootEl, "remoteCertificateId", mRemoteCertificateID, false);
+    IHelper::adoptElementValue(rootEl, "transportId", mTransportID, false);
+    IHelper::adoptElementValue(rootEl, "localCandidateId", mLocalCandidateID, false);
+    IHelper::adoptElementValue(rootEl, "remoteCandidateId", mRemoteCandidateID, false);
+    IHelper::adoptElementValue(rootEl, "state", IStatsReportTypes::toString(mState), false);
+    IHelper::adoptElementValue(rootEl, "priority", mPriority);
+    IHelper::adoptElementValue(rootEl, "nominated", mNominated);
+    IHelper::adoptElementValue(rootEl, "writable", mWritable);
+    IHelper::adoptElementValue(rootEl, "readable", mReadable);
+    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
+    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
+    IHelper::adoptElementValue(rootEl, "roundTripTime", mRoundTripTime);
+    IHelper::adoptElementValue(rootEl, "availableOutgoingBitrate", mAvailableOutgoingBitrate);
+    IHelper::adoptElementValue(rootEl, "availableIncomingBitrate", mAvailableIncomingBitrate);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -2025,186 +3810,255 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::DTLSTransportStats::toDebug() const
+  ElementPtr IStatsReportTypes::ICECandidatePairStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::DTLSTransportStats");
+    return Element::create("ortc::IStatsReportTypes::ICECandidatePairStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::DTLSTransportStats::hash() const
+  String IStatsReportTypes::ICECandidatePairStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:DTLSTransportStats:");
+    hasher->update("IStatsReportTypes:ICECandidatePairStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mLocalCertificateID);
+    hasher->update(mTransportID);
     hasher->update(":");
-    hasher->update(mRemoteCertificateID);
+    hasher->update(mLocalCandidateID);
+    hasher->update(":");
+    hasher->update(mRemoteCandidateID);
+    hasher->update(":");
+    hasher->update(IStatsReportTypes::toString(mState));
+    hasher->update(":");
+    hasher->update(mPriority);
+    hasher->update(":");
+    hasher->update(mNominated);
+    hasher->update(":");
+    hasher->update(mWritable);
+    hasher->update(":");
+    hasher->update(mReadable);
+    hasher->update(":");
+    hasher->update(mBytesSent);
+    hasher->update(":");
+    hasher->update(mRoundTripTime);
+    hasher->update(":");
+    hasher->update(mAvailableOutgoingBitrate);
+    hasher->update(":");
+    hasher->update(mAvailableIncomingBitrate);
     hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::DTLSTransportStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::ICECandidatePairStats::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("bytesSent", static_cast<double>(mBytesSent)));
+    outCounters.push_back(FlatCounter("bytesReceived", static_cast<double>(mBytesReceived)));
+    outCounters.push_back(FlatCounter("roundTripTime", static_cast<double>(mRoundTripTime)));
+    outCounters.push_back(FlatCounter("availableOutgoingBitrate", static_cast<double>(mAvailableOutgoingBitrate)));
+    outCounters.push_back(FlatCounter("availableIncomingBitrate", static_cast<double>(mAvailableIncomingBitrate)));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::ICECandidatePairStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "localCertificateId", mLocalCertificateID);
-    internal::reportString(mID, timestamp, "remoteCertificateId", mRemoteCertificateID);
+    internal::reportString(mID, timestamp, "transportId", mTransportID);
+    internal::reportString(mID, timestamp, "localCandidateId", mLocalCandidateID);
+    internal::reportString(mID, timestamp, "remoteCandidateId", mRemoteCandidateID);
+    internal::reportString(mID, timestamp, "state", IStatsReportTypes::toString(mState));
+    internal::reportInt64(mID, timestamp, "priority", static_cast<int64_t>(mPriority));
+    internal::reportBool(mID, timestamp, "nominated", mNominated);
+    internal::reportBool(mID, timestamp, "writable", mWritable);
+    internal::reportBool(mID, timestamp, "readable", mReadable);
+    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
+    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
+    internal::reportFloat(mID, timestamp, "roundTripTime", static_cast<float>(mRoundTripTime));
+    internal::reportFloat(mID, timestamp, "availableOutgoingBitrate", static_cast<float>(mAvailableOutgoingBitrate));
+    internal::reportFloat(mID, timestamp, "availableIncomingBitrate", static_cast<float>(mAvailableIncomingBitrate));
   }
 
-
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::SRTPTransportStats
+  #pragma mark IStatsReportTypes::CertificateStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SRTPTransportStats::SRTPTransportStats(const SRTPTransportStats &op2) :
-    Stats(op2)
+  IStatsReportTypes::CertificateStats::CertificateStats(const CertificateStats &op2) :
+    Stats(op2),
+    mFingerprint(op2.mFingerprint),
+    mFingerprintAlgorithm(op2.mFingerprintAlgorithm),
+    mBase64Certificate(op2.mBase64Certificate),
+    mIssuerCertificateID(op2.mIssuerCertificateID)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SRTPTransportStats::SRTPTransportStats(ElementPtr rootEl) :
+  IStatsReportTypes::CertificateStats::CertificateStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_SRTPTransport;
+    mStatsType = IStatsReportTypes::StatsType_Certificate;
 
     if (!rootEl) return;
+
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "fingerprint", mFingerprint);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "fingerprintAlgorithm", mFingerprintAlgorithm);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "base64Certificate", mBase64Certificate);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "issuerCertificateID", mIssuerCertificateID);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SRTPTransportStatsPtr IStatsReportTypes::SRTPTransportStats::create(ElementPtr rootEl)
+  IStatsReportTypes::CertificateStatsPtr IStatsReportTypes::CertificateStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return SRTPTransportStatsPtr();
-    return make_shared<SRTPTransportStats>(rootEl);
+    if (!rootEl) return CertificateStatsPtr();
+    return make_shared<CertificateStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::SRTPTransportStatsPtr IStatsReportTypes::SRTPTransportStats::convert(AnyPtr any)
+  IStatsReportTypes::CertificateStatsPtr IStatsReportTypes::CertificateStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(SRTPTransportStats, any);
+    return ZS_DYNAMIC_PTR_CAST(CertificateStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::SRTPTransportStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::CertificateStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
+    IHelper::adoptElementValue(rootEl, "fingerprint", mFingerprint, false);
+    IHelper::adoptElementValue(rootEl, "fingerprintAlgorithm", mFingerprintAlgorithm, false);
+    IHelper::adoptElementValue(rootEl, "base64Certificate", mBase64Certificate, false);
+    IHelper::adoptElementValue(rootEl, "issuerCertificateID", mIssuerCertificateID, false);
+
     if (!rootEl->hasChildren()) return ElementPtr();
 
     return rootEl;
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::SRTPTransportStats::toDebug() const
+  ElementPtr IStatsReportTypes::CertificateStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::SRTPTransportStats");
+    return Element::create("ortc::IStatsReportTypes::CertificateStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::SRTPTransportStats::hash() const
+  String IStatsReportTypes::CertificateStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:SRTPTransportStats:");
+    hasher->update("IStatsReportTypes:CertificateStats:");
 
     hasher->update(Stats::hash());
 
+    hasher->update(mFingerprint);
+    hasher->update(":");
+    hasher->update(mFingerprintAlgorithm);
+    hasher->update(":");
+    hasher->update(mBase64Certificate);
+    hasher->update(":");
+    hasher->update(mIssuerCertificateID);
     hasher->update(":");
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::SRTPTransportStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::CertificateStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
-  }
 
+    internal::reportString(mID, timestamp, "fingerprint", mFingerprint);
+    internal::reportString(mID, timestamp, "fingerprintAlgorithm", mFingerprintAlgorithm);
+    internal::reportString(mID, timestamp, "base64Certificate", mBase64Certificate);
+    internal::reportString(mID, timestamp, "issuerCertificateId", mIssuerCertificateID);
+  }
 
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::ICECandidateAttributes
+  #pragma mark IStatsReportTypes::PacketPipelineStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidateAttributes::ICECandidateAttributes(const ICECandidateAttributes &op2) :
-    Stats(op2),
-    mRelatedID(op2.mRelatedID),
-    mIPAddress(op2.mIPAddress),
-    mPortNumber(op2.mPortNumber),
-    mTransport(op2.mTransport),
-    mCandidateType(op2.mCandidateType),
-    mPriority(op2.mPriority),
-    mAddressSourceURL(op2.mAddressSourceURL)
+  IStatsReportTypes::PacketPipelineStats::PacketPipelineStats(const PacketPipelineStats &op2) :
+    Stats(op2)
   {
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      mHops[index] = op2.mHops[index];
+    }
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidateAttributes::ICECandidateAttributes(ElementPtr rootEl) :
+  IStatsReportTypes::PacketPipelineStats::PacketPipelineStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_Candidate;
+    mStatsType = IStatsReportTypes::StatsType_PacketPipeline;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "relatedId", mRelatedID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "ipAddress", mIPAddress);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "portNumber", mPortNumber);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "transport", mTransport);
-
-    {
-      String str;
-      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "candidateType", str);
-      if (str.hasData()) {
-        try {
-          mCandidateType = IICETypes::toCandidateType(str);
-        } catch (const InvalidParameters &) {
-          ZS_LOG_WARNING(Debug, internal::slog("candidate type is not value") + ZS_PARAM("type", str));
-        }
-      }
+    ElementPtr hopsEl = rootEl->findFirstChildElement("hops");
+    if (!hopsEl) return;
+
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      ElementPtr hopEl = hopsEl->findFirstChildElement(IStatsReportTypes::toString(static_cast<PacketPipelineHops>(index)));
+      if (!hopEl) continue;
+
+      auto &hop = mHops[index];
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "count", hop.mCount);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "average", hop.mAverage);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "p50", hop.mP50);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "p90", hop.mP90);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "p99", hop.mP99);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "p999", hop.mP999);
+      IHelper::getElementValue(hopEl, "ortc::IStatsReportTypes::PacketPipelineStats", "max", hop.mMax);
     }
-
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "priority", mPriority);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidateAttributes", "addressSourceUrl", mAddressSourceURL);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidateAttributesPtr IStatsReportTypes::ICECandidateAttributes::create(ElementPtr rootEl)
+  IStatsReportTypes::PacketPipelineStatsPtr IStatsReportTypes::PacketPipelineStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return ICECandidateAttributesPtr();
-    return make_shared<ICECandidateAttributes>(rootEl);
+    if (!rootEl) return PacketPipelineStatsPtr();
+    return make_shared<PacketPipelineStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidateAttributesPtr IStatsReportTypes::ICECandidateAttributes::convert(AnyPtr any)
+  IStatsReportTypes::PacketPipelineStatsPtr IStatsReportTypes::PacketPipelineStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(ICECandidateAttributes, any);
+    return ZS_DYNAMIC_PTR_CAST(PacketPipelineStats, any);
   }
 
-  //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICECandidateAttributes::createElement(const char *objectName) const
-  {
-    ElementPtr rootEl = Stats::createElement(objectName);
-
-    IHelper::adoptElementValue(rootEl, "relatedId", mRelatedID, false);
-    IHelper::adoptElementValue(rootEl, "ipAddress", mIPAddress, false);
-    IHelper::adoptElementValue(rootEl, "portNumber", mPortNumber);
-    IHelper::adoptElementValue(rootEl, "transport", mTransport, false);
-    IHelper::adoptElementValue(rootEl, "candidateType", IICETypes::toString(mCandidateType), false);
-    IHelper::adoptElementValue(rootEl, "priority", mPriority);
-    IHelper::adoptElementValue(rootEl, "addressSourceUrl", mAddressSourceURL, false);
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsReportTypes::PacketPipelineStats::createElement(const char *objectName) const
+  {
+    ElementPtr rootEl = Stats::createElement(objectName);
+
+    ElementPtr hopsEl = Element::create("hops");
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      auto &hop = mHops[index];
+      if (0 == hop.mCount) continue;
+
+      ElementPtr hopEl = Element::create(IStatsReportTypes::toString(static_cast<PacketPipelineHops>(index)));
+      IHelper::adoptElementValue(hopEl, "count", hop.mCount);
+      IHelper::adoptElementValue(hopEl, "average", hop.mAverage);
+      IHelper::adoptElementValue(hopEl, "p50", hop.mP50);
+      IHelper::adoptElementValue(hopEl, "p90", hop.mP90);
+      IHelper::adoptElementValue(hopEl, "p99", hop.mP99);
+      IHelper::adoptElementValue(hopEl, "p999", hop.mP999);
+      IHelper::adoptElementValue(hopEl, "max", hop.mMax);
+      hopsEl->adoptAsLastChild(hopEl);
+    }
+    if (hopsEl->hasChildren()) {
+      rootEl->adoptAsLastChild(hopsEl);
+    }
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -2212,50 +4066,85 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICECandidateAttributes::toDebug() const
+  ElementPtr IStatsReportTypes::PacketPipelineStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::ICECandidateAttributes");
+    return Element::create("ortc::IStatsReportTypes::PacketPipelineStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::ICECandidateAttributes::hash() const
+  String IStatsReportTypes::PacketPipelineStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:ICECandidateAttributes:");
+    hasher->update("IStatsReportTypes:PacketPipelineStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mRelatedID);
-    hasher->update(":");
-    hasher->update(mIPAddress);
-    hasher->update(":");
-    hasher->update(mPortNumber);
-    hasher->update(":");
-    hasher->update(mTransport);
-    hasher->update(":");
-    hasher->update(IICETypes::toString(mCandidateType));
-    hasher->update(":");
-    hasher->update(mPriority);
-    hasher->update(":");
-    hasher->update(mAddressSourceURL);
-    hasher->update(":");
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      auto &hop = mHops[index];
+      hasher->update(":");
+      hasher->update(IStatsReportTypes::toString(static_cast<PacketPipelineHops>(index)));
+      hasher->update(":");
+      hasher->update(hop.mCount);
+      hasher->update(":");
+      hasher->update(hop.mAverage);
+      hasher->update(":");
+      hasher->update(hop.mP50);
+      hasher->update(":");
+      hasher->update(hop.mP90);
+      hasher->update(":");
+      hasher->update(hop.mP99);
+      hasher->update(":");
+      hasher->update(hop.mP999);
+      hasher->update(":");
+      hasher->update(hop.mMax);
+    }
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::ICECandidateAttributes::eventTrace(double timestamp) const
+  void IStatsReportTypes::PacketPipelineStats::flatten(FlatCounterList &outCounters) const
+  {
+    // counter names must outlive the counter list
+    static const char *names[PacketPipelineHop_Last + 1][4] = {
+      {"iceGathererCount", "iceGathererP50", "iceGathererP99", "iceGathererMax"},
+      {"iceTransportCount", "iceTransportP50", "iceTransportP99", "iceTransportMax"},
+      {"dtlsTransportCount", "dtlsTransportP50", "dtlsTransportP99", "dtlsTransportMax"},
+      {"srtpTransportCount", "srtpTransportP50", "srtpTransportP99", "srtpTransportMax"},
+      {"rtpListenerCount", "rtpListenerP50", "rtpListenerP99", "rtpListenerMax"},
+      {"receiverChannelQueueCount", "receiverChannelQueueP50", "receiverChannelQueueP99", "receiverChannelQueueMax"},
+      {"mediaEngineQueueCount", "mediaEngineQueueP50", "mediaEngineQueueP99", "mediaEngineQueueMax"},
+      {"endToEndCount", "endToEndP50", "endToEndP99", "endToEndMax"},
+    };
+
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      auto &hop = mHops[index];
+      outCounters.push_back(FlatCounter(names[index][0], static_cast<double>(hop.mCount)));
+      outCounters.push_back(FlatCounter(names[index][1], hop.mP50));
+      outCounters.push_back(FlatCounter(names[index][2], hop.mP99));
+      outCounters.push_back(FlatCounter(names[index][3], hop.mMax));
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::PacketPipelineStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "relatedId", mRelatedID);
-    internal::reportString(mID, timestamp, "ipAddress", mIPAddress);
-    internal::reportInt32(mID, timestamp, "portNumber", SafeInt<int32_t>(mPortNumber));
-    internal::reportString(mID, timestamp, "transport", mTransport);
-    internal::reportString(mID, timestamp, "candidateType", IICETypes::toString(mCandidateType));
-    internal::reportInt64(mID, timestamp, "priority", SafeInt<int64_t>(mPriority));
-    internal::reportString(mID, timestamp, "addressSourceUrl", mAddressSourceURL);
+    for (size_t index = 0; index <= PacketPipelineHop_Last; ++index) {
+      auto &hop = mHops[index];
+      if (0 == hop.mCount) continue;
+
+      String name(IStatsReportTypes::toString(static_cast<PacketPipelineHops>(index)));
+      internal::reportInt64(mID, timestamp, (name + "Count").c_str(), SafeInt<int64_t>(hop.mCount));
+      internal::reportFloat(mID, timestamp, (name + "Average").c_str(), static_cast<float>(hop.mAverage));
+      internal::reportFloat(mID, timestamp, (name + "P50").c_str(), static_cast<float>(hop.mP50));
+      internal::reportFloat(mID, timestamp, (name + "P90").c_str(), static_cast<float>(hop.mP90));
+      internal::reportFloat(mID, timestamp, (name + "P99").c_str(), static_cast<float>(hop.mP99));
+      internal::reportFloat(mID, timestamp, (name + "P999").c_str(), static_cast<float>(hop.mP999));
+      internal::reportFloat(mID, timestamp, (name + "Max").c_str(), static_cast<float>(hop.mMax));
+    }
   }
 
   //---------------------------------------------------------------------------
@@ -2263,94 +4152,121 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::ICECandidatePairStats
+  #pragma mark IStatsReportTypes::MessageQueueStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidatePairStats::ICECandidatePairStats(const ICECandidatePairStats &op2) :
+  IStatsReportTypes::MessageQueueStats::MessageQueueStats(const MessageQueueStats &op2) :
     Stats(op2),
-    mTransportID(op2.mTransportID),
-    mLocalCandidateID(op2.mLocalCandidateID),
-    mRemoteCandidateID(op2.mRemoteCandidateID),
-    mState(op2.mState),
-    mPriority(op2.mPriority),
-    mNominated(op2.mNominated),
-    mWritable(op2.mWritable),
-    mReadable(op2.mReadable),
-    mBytesSent(op2.mBytesSent),
-    mBytesReceived(op2.mBytesReceived),
-    mRoundTripTime(op2.mRoundTripTime),
-    mAvailableOutgoingBitrate(op2.mAvailableOutgoingBitrate),
-    mAvailableIncomingBitrate(op2.mAvailableIncomingBitrate)
+    mQueueName(op2.mQueueName),
+    mPosted(op2.mPosted),
+    mProcessed(op2.mProcessed),
+    mCurrentDepth(op2.mCurrentDepth),
+    mPeakDepth(op2.mPeakDepth),
+    mDwell(op2.mDwell),
+    mTopMethods(op2.mTopMethods)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidatePairStats::ICECandidatePairStats(ElementPtr rootEl) :
+  IStatsReportTypes::MessageQueueStats::MessageQueueStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_CandidatePair;
+    mStatsType = IStatsReportTypes::StatsType_MessageQueue;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "transportId", mTransportID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "localCandidateId", mLocalCandidateID);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "remoteCandidateId", mRemoteCandidateID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MessageQueueStats", "queueName", mQueueName);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MessageQueueStats", "posted", mPosted);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MessageQueueStats", "processed", mProcessed);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MessageQueueStats", "currentDepth", mCurrentDepth);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MessageQueueStats", "peakDepth", mPeakDepth);
 
     {
-      String str;
-      IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "state", str);
-      if (str.hasData()) {
-        try {
-          mState = IStatsReportTypes::toCandidatePairState(str);
-        } catch (const InvalidParameters &) {
-          ZS_LOG_WARNING(Debug, internal::slog("candidate pair state is not value") + ZS_PARAM("type", str));
-        }
+      ElementPtr dwellEl = rootEl->findFirstChildElement("dwell");
+      if (dwellEl) {
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "count", mDwell.mCount);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "average", mDwell.mAverage);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "p50", mDwell.mP50);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "p90", mDwell.mP90);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "p99", mDwell.mP99);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "p999", mDwell.mP999);
+        IHelper::getElementValue(dwellEl, "ortc::IStatsReportTypes::MessageQueueStats", "max", mDwell.mMax);
       }
     }
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "priority", mPriority);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "nominated", mNominated);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "writable", mWritable);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "readable", mReadable);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesSent", mBytesSent);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "bytesReceived", mBytesReceived);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "roundTripTime", mRoundTripTime);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableOutgoingBitrate", mAvailableOutgoingBitrate);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::ICECandidatePairStats", "availableIncomingBitrate", mAvailableIncomingBitrate);
+    {
+      ElementPtr methodsEl = rootEl->findFirstChildElement("topMethods");
+      if (methodsEl) {
+        ElementPtr methodEl = methodsEl->findFirstChildElement("method");
+        while (methodEl) {
+          MethodUsage usage;
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "delegateName", usage.mDelegateName);
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "methodName", usage.mMethodName);
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "count", usage.mCount);
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "total", usage.mTotal);
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "average", usage.mAverage);
+          IHelper::getElementValue(methodEl, "ortc::IStatsReportTypes::MessageQueueStats", "max", usage.mMax);
+          mTopMethods.push_back(usage);
+
+          methodEl = methodEl->findNextSiblingElement("method");
+        }
+      }
+    }
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidatePairStatsPtr IStatsReportTypes::ICECandidatePairStats::create(ElementPtr rootEl)
+  IStatsReportTypes::MessageQueueStatsPtr IStatsReportTypes::MessageQueueStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return ICECandidatePairStatsPtr();
-    return make_shared<ICECandidatePairStats>(rootEl);
+    if (!rootEl) return MessageQueueStatsPtr();
+    return make_shared<MessageQueueStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::ICECandidatePairStatsPtr IStatsReportTypes::ICECandidatePairStats::convert(AnyPtr any)
+  IStatsReportTypes::MessageQueueStatsPtr IStatsReportTypes::MessageQueueStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(ICECandidatePairStats, any);
+    return ZS_DYNAMIC_PTR_CAST(MessageQueueStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICECandidatePairStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::MessageQueueStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "transportId", mTransportID, false);
-    IHelper::adoptElementValue(rootEl, "localCandidateId", mLocalCandidateID, false);
-    IHelper::adoptElementValue(rootEl, "remoteCandidateId", mRemoteCandidateID, false);
-    IHelper::adoptElementValue(rootEl, "state", IStatsReportTypes::toString(mState), false);
-    IHelper::adoptElementValue(rootEl, "priority", mPriority);
-    IHelper::adoptElementValue(rootEl, "nominated", mNominated);
-    IHelper::adoptElementValue(rootEl, "writable", mWritable);
-    IHelper::adoptElementValue(rootEl, "readable", mReadable);
-    IHelper::adoptElementValue(rootEl, "bytesSent", mBytesSent);
-    IHelper::adoptElementValue(rootEl, "bytesReceived", mBytesReceived);
-    IHelper::adoptElementValue(rootEl, "roundTripTime", mRoundTripTime);
-    IHelper::adoptElementValue(rootEl, "availableOutgoingBitrate", mAvailableOutgoingBitrate);
-    IHelper::adoptElementValue(rootEl, "availableIncomingBitrate", mAvailableIncomingBitrate);
+    IHelper::adoptElementValue(rootEl, "queueName", mQueueName, false);
+    IHelper::adoptElementValue(rootEl, "posted", mPosted);
+    IHelper::adoptElementValue(rootEl, "processed", mProcessed);
+    IHelper::adoptElementValue(rootEl, "currentDepth", mCurrentDepth);
+    IHelper::adoptElementValue(rootEl, "peakDepth", mPeakDepth);
+
+    if (0 != mDwell.mCount) {
+      ElementPtr dwellEl = Element::create("dwell");
+      IHelper::adoptElementValue(dwellEl, "count", mDwell.mCount);
+      IHelper::adoptElementValue(dwellEl, "average", mDwell.mAverage);
+      IHelper::adoptElementValue(dwellEl, "p50", mDwell.mP50);
+      IHelper::adoptElementValue(dwellEl, "p90", mDwell.mP90);
+      IHelper::adoptElementValue(dwellEl, "p99", mDwell.mP99);
+      IHelper::adoptElementValue(dwellEl, "p999", mDwell.mP999);
+      IHelper::adoptElementValue(dwellEl, "max", mDwell.mMax);
+      rootEl->adoptAsLastChild(dwellEl);
+    }
+
+    if (mTopMethods.size() > 0) {
+      ElementPtr methodsEl = Element::create("topMethods");
+      for (auto iter = mTopMethods.begin(); iter != mTopMethods.end(); ++iter) {
+        auto &usage = (*iter);
+
+        ElementPtr methodEl = Element::create("method");
+        IHelper::adoptElementValue(methodEl, "delegateName", usage.mDelegateName, false);
+        IHelper::adoptElementValue(methodEl, "methodName", usage.mMethodName, false);
+        IHelper::adoptElementValue(methodEl, "count", usage.mCount);
+        IHelper::adoptElementValue(methodEl, "total", usage.mTotal);
+        IHelper::adoptElementValue(methodEl, "average", usage.mAverage);
+        IHelper::adoptElementValue(methodEl, "max", usage.mMax);
+        methodsEl->adoptAsLastChild(methodEl);
+      }
+      rootEl->adoptAsLastChild(methodsEl);
+    }
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -2358,66 +4274,104 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::ICECandidatePairStats::toDebug() const
+  ElementPtr IStatsReportTypes::MessageQueueStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::ICECandidatePairStats");
+    return Element::create("ortc::IStatsReportTypes::MessageQueueStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::ICECandidatePairStats::hash() const
+  String IStatsReportTypes::MessageQueueStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:ICECandidatePairStats:");
+    hasher->update("IStatsReportTypes:MessageQueueStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mTransportID);
-    hasher->update(":");
-    hasher->update(mLocalCandidateID);
+    hasher->update(mQueueName);
     hasher->update(":");
-    hasher->update(mRemoteCandidateID);
-    hasher->update(":");
-    hasher->update(IStatsReportTypes::toString(mState));
+    hasher->update(mPosted);
     hasher->update(":");
-    hasher->update(mPriority);
+    hasher->update(mProcessed);
     hasher->update(":");
-    hasher->update(mNominated);
+    hasher->update(mCurrentDepth);
     hasher->update(":");
-    hasher->update(mWritable);
+    hasher->update(mPeakDepth);
+    hasher->update(":dwell:");
+    hasher->update(mDwell.mCount);
     hasher->update(":");
-    hasher->update(mReadable);
+    hasher->update(mDwell.mAverage);
     hasher->update(":");
-    hasher->update(mBytesSent);
+    hasher->update(mDwell.mP50);
     hasher->update(":");
-    hasher->update(mRoundTripTime);
+    hasher->update(mDwell.mP90);
     hasher->update(":");
-    hasher->update(mAvailableOutgoingBitrate);
+    hasher->update(mDwell.mP99);
     hasher->update(":");
-    hasher->update(mAvailableIncomingBitrate);
+    hasher->update(mDwell.mP999);
     hasher->update(":");
+    hasher->update(mDwell.mMax);
+    hasher->update(":methods");
+
+    for (auto iter = mTopMethods.begin(); iter != mTopMethods.end(); ++iter) {
+      auto &usage = (*iter);
+      hasher->update(":");
+      hasher->update(usage.mDelegateName);
+      hasher->update(":");
+      hasher->update(usage.mMethodName);
+      hasher->update(":");
+      hasher->update(usage.mCount);
+      hasher->update(":");
+      hasher->update(usage.mTotal);
+      hasher->update(":");
+      hasher->update(usage.mAverage);
+      hasher->update(":");
+      hasher->update(usage.mMax);
+    }
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::ICECandidatePairStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::MessageQueueStats::flatten(FlatCounterList &outCounters) const
+  {
+    // the per method usage changes membership over time so only the queue
+    // wide counters are flattened
+    outCounters.push_back(FlatCounter("posted", static_cast<double>(mPosted)));
+    outCounters.push_back(FlatCounter("processed", static_cast<double>(mProcessed)));
+    outCounters.push_back(FlatCounter("currentDepth", static_cast<double>(mCurrentDepth)));
+    outCounters.push_back(FlatCounter("peakDepth", static_cast<double>(mPeakDepth)));
+    outCounters.push_back(FlatCounter("dwellP50", mDwell.mP50));
+    outCounters.push_back(FlatCounter("dwellP99", mDwell.mP99));
+    outCounters.push_back(FlatCounter("dwellMax", mDwell.mMax));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::MessageQueueStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "transportId", mTransportID);
-    internal::reportString(mID, timestamp, "localCandidateId", mLocalCandidateID);
-    internal::reportString(mID, timestamp, "remoteCandidateId", mRemoteCandidateID);
-    internal::reportString(mID, timestamp, "state", IStatsReportTypes::toString(mState));
-    internal::reportInt64(mID, timestamp, "priority", static_cast<int64_t>(mPriority));
-    internal::reportBool(mID, timestamp, "nominated", mNominated);
-    internal::reportBool(mID, timestamp, "writable", mWritable);
-    internal::reportBool(mID, timestamp, "readable", mReadable);
-    internal::reportInt64(mID, timestamp, "bytesSent", SafeInt<int64_t>(mBytesSent));
-    internal::reportInt64(mID, timestamp, "bytesReceived", SafeInt<int64_t>(mBytesReceived));
-    internal::reportFloat(mID, timestamp, "roundTripTime", static_cast<float>(mRoundTripTime));
-    internal::reportFloat(mID, timestamp, "availableOutgoingBitrate", static_cast<float>(mAvailableOutgoingBitrate));
-    internal::reportFloat(mID, timestamp, "availableIncomingBitrate", static_cast<float>(mAvailableIncomingBitrate));
+    internal::reportString(mID, timestamp, "queueName", mQueueName);
+    internal::reportInt64(mID, timestamp, "posted", SafeInt<int64_t>(mPosted));
+    internal::reportInt64(mID, timestamp, "processed", SafeInt<int64_t>(mProcessed));
+    internal::reportInt64(mID, timestamp, "currentDepth", SafeInt<int64_t>(mCurrentDepth));
+    internal::reportInt64(mID, timestamp, "peakDepth", SafeInt<int64_t>(mPeakDepth));
+    internal::reportFloat(mID, timestamp, "dwellAverage", static_cast<float>(mDwell.mAverage));
+    internal::reportFloat(mID, timestamp, "dwellP50", static_cast<float>(mDwell.mP50));
+    internal::reportFloat(mID, timestamp, "dwellP90", static_cast<float>(mDwell.mP90));
+    internal::reportFloat(mID, timestamp, "dwellP99", static_cast<float>(mDwell.mP99));
+    internal::reportFloat(mID, timestamp, "dwellP999", static_cast<float>(mDwell.mP999));
+    internal::reportFloat(mID, timestamp, "dwellMax", static_cast<float>(mDwell.mMax));
+
+    unsigned long index = 0;
+    for (auto iter = mTopMethods.begin(); iter != mTopMethods.end(); ++iter, ++index) {
+      auto &usage = (*iter);
+      String prefix(String("method") + string(index));
+      internal::reportString(mID, timestamp, (prefix + "Name").c_str(), (usage.mDelegateName + "::" + usage.mMethodName).c_str());
+      internal::reportInt64(mID, timestamp, (prefix + "Count").c_str(), SafeInt<int64_t>(usage.mCount));
+      internal::reportFloat(mID, timestamp, (prefix + "Total").c_str(), static_cast<float>(usage.mTotal));
+      internal::reportFloat(mID, timestamp, (prefix + "Max").c_str(), static_cast<float>(usage.mMax));
+    }
   }
 
   //---------------------------------------------------------------------------
@@ -2425,55 +4379,93 @@ namespace ortc
   //---------------------------------------------------------------------------
   //---------------------------------------------------------------------------
   #pragma mark
-  #pragma mark IStatsReportTypes::CertificateStats
+  #pragma mark IStatsReportTypes::MediaChannelStats
   #pragma mark
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CertificateStats::CertificateStats(const CertificateStats &op2) :
+  IStatsReportTypes::MediaChannelStats::MediaChannelStats(const MediaChannelStats &op2) :
     Stats(op2),
-    mFingerprint(op2.mFingerprint),
-    mFingerprintAlgorithm(op2.mFingerprintAlgorithm),
-    mBase64Certificate(op2.mBase64Certificate),
-    mIssuerCertificateID(op2.mIssuerCertificateID)
+    mSetupsRequested(op2.mSetupsRequested),
+    mSetupsSucceeded(op2.mSetupsSucceeded),
+    mSetupsFailed(op2.mSetupsFailed),
+    mSetupsPending(op2.mSetupsPending),
+    mShutdowns(op2.mShutdowns),
+    mSetupLatency(op2.mSetupLatency),
+    mShutdownLatency(op2.mShutdownLatency)
   {
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CertificateStats::CertificateStats(ElementPtr rootEl) :
+  IStatsReportTypes::MediaChannelStats::MediaChannelStats(ElementPtr rootEl) :
     Stats(rootEl)
   {
-    mStatsType = IStatsReportTypes::StatsType_Certificate;
+    mStatsType = IStatsReportTypes::StatsType_MediaChannel;
 
     if (!rootEl) return;
 
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "fingerprint", mFingerprint);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "fingerprintAlgorithm", mFingerprintAlgorithm);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "base64Certificate", mBase64Certificate);
-    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::CertificateStats", "issuerCertificateID", mIssuerCertificateID);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaChannelStats", "setupsRequested", mSetupsRequested);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaChannelStats", "setupsSucceeded", mSetupsSucceeded);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaChannelStats", "setupsFailed", mSetupsFailed);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaChannelStats", "setupsPending", mSetupsPending);
+    IHelper::getElementValue(rootEl, "ortc::IStatsReportTypes::MediaChannelStats", "shutdowns", mShutdowns);
+
+    auto getLatency = [&rootEl](const char *name, Latency &latency) {
+      ElementPtr latencyEl = rootEl->findFirstChildElement(name);
+      if (!latencyEl) return;
+
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "count", latency.mCount);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "average", latency.mAverage);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "p50", latency.mP50);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "p90", latency.mP90);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "p99", latency.mP99);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "p999", latency.mP999);
+      IHelper::getElementValue(latencyEl, "ortc::IStatsReportTypes::MediaChannelStats", "max", latency.mMax);
+    };
+
+    getLatency("setupLatency", mSetupLatency);
+    getLatency("shutdownLatency", mShutdownLatency);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CertificateStatsPtr IStatsReportTypes::CertificateStats::create(ElementPtr rootEl)
+  IStatsReportTypes::MediaChannelStatsPtr IStatsReportTypes::MediaChannelStats::create(ElementPtr rootEl)
   {
-    if (!rootEl) return CertificateStatsPtr();
-    return make_shared<CertificateStats>(rootEl);
+    if (!rootEl) return MediaChannelStatsPtr();
+    return make_shared<MediaChannelStats>(rootEl);
   }
 
   //---------------------------------------------------------------------------
-  IStatsReportTypes::CertificateStatsPtr IStatsReportTypes::CertificateStats::convert(AnyPtr any)
+  IStatsReportTypes::MediaChannelStatsPtr IStatsReportTypes::MediaChannelStats::convert(AnyPtr any)
   {
-    return ZS_DYNAMIC_PTR_CAST(CertificateStats, any);
+    return ZS_DYNAMIC_PTR_CAST(MediaChannelStats, any);
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::CertificateStats::createElement(const char *objectName) const
+  ElementPtr IStatsReportTypes::MediaChannelStats::createElement(const char *objectName) const
   {
     ElementPtr rootEl = Stats::createElement(objectName);
 
-    IHelper::adoptElementValue(rootEl, "fingerprint", mFingerprint, false);
-    IHelper::adoptElementValue(rootEl, "fingerprintAlgorithm", mFingerprintAlgorithm, false);
-    IHelper::adoptElementValue(rootEl, "base64Certificate", mBase64Certificate, false);
-    IHelper::adoptElementValue(rootEl, "issuerCertificateID", mIssuerCertificateID, false);
+    IHelper::adoptElementValue(rootEl, "setupsRequested", mSetupsRequested);
+    IHelper::adoptElementValue(rootEl, "setupsSucceeded", mSetupsSucceeded);
+    IHelper::adoptElementValue(rootEl, "setupsFailed", mSetupsFailed);
+    IHelper::adoptElementValue(rootEl, "setupsPending", mSetupsPending);
+    IHelper::adoptElementValue(rootEl, "shutdowns", mShutdowns);
+
+    auto adoptLatency = [&rootEl](const char *name, const Latency &latency) {
+      if (0 == latency.mCount) return;
+
+      ElementPtr latencyEl = Element::create(name);
+      IHelper::adoptElementValue(latencyEl, "count", latency.mCount);
+      IHelper::adoptElementValue(latencyEl, "average", latency.mAverage);
+      IHelper::adoptElementValue(latencyEl, "p50", latency.mP50);
+      IHelper::adoptElementValue(latencyEl, "p90", latency.mP90);
+      IHelper::adoptElementValue(latencyEl, "p99", latency.mP99);
+      IHelper::adoptElementValue(latencyEl, "p999", latency.mP999);
+      IHelper::adoptElementValue(latencyEl, "max", latency.mMax);
+      rootEl->adoptAsLastChild(latencyEl);
+    };
+
+    adoptLatency("setupLatency", mSetupLatency);
+    adoptLatency("shutdownLatency", mShutdownLatency);
 
     if (!rootEl->hasChildren()) return ElementPtr();
 
@@ -2481,41 +4473,89 @@ namespace ortc
   }
 
   //---------------------------------------------------------------------------
-  ElementPtr IStatsReportTypes::CertificateStats::toDebug() const
+  ElementPtr IStatsReportTypes::MediaChannelStats::toDebug() const
   {
-    return Element::create("ortc::IStatsReportTypes::CertificateStats");
+    return Element::create("ortc::IStatsReportTypes::MediaChannelStats");
   }
 
   //---------------------------------------------------------------------------
-  String IStatsReportTypes::CertificateStats::hash() const
+  String IStatsReportTypes::MediaChannelStats::hash() const
   {
     auto hasher = IHasher::sha1();
 
-    hasher->update("IStatsReportTypes:CertificateStats:");
+    hasher->update("IStatsReportTypes:MediaChannelStats:");
 
     hasher->update(Stats::hash());
 
-    hasher->update(mFingerprint);
+    hasher->update(mSetupsRequested);
     hasher->update(":");
-    hasher->update(mFingerprintAlgorithm);
+    hasher->update(mSetupsSucceeded);
     hasher->update(":");
-    hasher->update(mBase64Certificate);
+    hasher->update(mSetupsFailed);
     hasher->update(":");
-    hasher->update(mIssuerCertificateID);
+    hasher->update(mSetupsPending);
     hasher->update(":");
+    hasher->update(mShutdowns);
+
+    const Latency *latencies[] = { &mSetupLatency, &mShutdownLatency };
+    for (auto latency : latencies) {
+      hasher->update(":latency:");
+      hasher->update(latency->mCount);
+      hasher->update(":");
+      hasher->update(latency->mAverage);
+      hasher->update(":");
+      hasher->update(latency->mP50);
+      hasher->update(":");
+      hasher->update(latency->mP90);
+      hasher->update(":");
+      hasher->update(latency->mP99);
+      hasher->update(":");
+      hasher->update(latency->mP999);
+      hasher->update(":");
+      hasher->update(latency->mMax);
+    }
 
     return hasher->finalizeAsString();
   }
 
   //---------------------------------------------------------------------------
-  void IStatsReportTypes::CertificateStats::eventTrace(double timestamp) const
+  void IStatsReportTypes::MediaChannelStats::flatten(FlatCounterList &outCounters) const
+  {
+    outCounters.push_back(FlatCounter("setupsRequested", static_cast<double>(mSetupsRequested)));
+    outCounters.push_back(FlatCounter("setupsSucceeded", static_cast<double>(mSetupsSucceeded)));
+    outCounters.push_back(FlatCounter("setupsFailed", static_cast<double>(mSetupsFailed)));
+    outCounters.push_back(FlatCounter("setupsPending", static_cast<double>(mSetupsPending)));
+    outCounters.push_back(FlatCounter("shutdowns", static_cast<double>(mShutdowns)));
+    outCounters.push_back(FlatCounter("setupP50", mSetupLatency.mP50));
+    outCounters.push_back(FlatCounter("setupP99", mSetupLatency.mP99));
+    outCounters.push_back(FlatCounter("setupMax", mSetupLatency.mMax));
+    outCounters.push_back(FlatCounter("shutdownP50", mShutdownLatency.mP50));
+    outCounters.push_back(FlatCounter("shutdownP99", mShutdownLatency.mP99));
+    outCounters.push_back(FlatCounter("shutdownMax", mShutdownLatency.mMax));
+  }
+
+  //---------------------------------------------------------------------------
+  void IStatsReportTypes::MediaChannelStats::eventTrace(double timestamp) const
   {
     Stats::eventTrace(timestamp);
 
-    internal::reportString(mID, timestamp, "fingerprint", mFingerprint);
-    internal::reportString(mID, timestamp, "fingerprintAlgorithm", mFingerprintAlgorithm);
-    internal::reportString(mID, timestamp, "base64Certificate", mBase64Certificate);
-    internal::reportString(mID, timestamp, "issuerCertificateId", mIssuerCertificateID);
+    internal::reportInt64(mID, timestamp, "setupsRequested", SafeInt<int64_t>(mSetupsRequested));
+    internal::reportInt64(mID, timestamp, "setupsSucceeded", SafeInt<int64_t>(mSetupsSucceeded));
+    internal::reportInt64(mID, timestamp, "setupsFailed", SafeInt<int64_t>(mSetupsFailed));
+    internal::reportInt64(mID, timestamp, "setupsPending", SafeInt<int64_t>(mSetupsPending));
+    internal::reportInt64(mID, timestamp, "shutdowns", SafeInt<int64_t>(mShutdowns));
+
+    auto reportLatency = [this, timestamp](const String &name, const Latency &latency) {
+      internal::reportFloat(mID, timestamp, (name + "Average").c_str(), static_cast<float>(latency.mAverage));
+      internal::reportFloat(mID, timestamp, (name + "P50").c_str(), static_cast<float>(latency.mP50));
+      internal::reportFloat(mID, timestamp, (name + "P90").c_str(), static_cast<float>(latency.mP90));
+      internal::reportFloat(mID, timestamp, (name + "P99").c_str(), static_cast<float>(latency.mP99));
+      internal::reportFloat(mID, timestamp, (name + "P999").c_str(), static_cast<float>(latency.mP999));
+      internal::reportFloat(mID, timestamp, (name + "Max").c_str(), static_cast<float>(latency.mMax));
+    };
+
+    reportLatency("setup", mSetupLatency);
+    reportLatency("shutdown", mShutdownLatency);
   }
 
   //---------------------------------------------------------------------------
@@ -2538,5 +4578,85 @@ namespace ortc
     return ZS_DYNAMIC_PTR_CAST(IStatsReport, any);
   }
 
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsProviderTypes::StatsDelta
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsProviderTypes::StatsDelta::CounterInfo::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IStatsProviderTypes::StatsDelta::CounterInfo");
+
+    IHelper::debugAppend(resultEl, "key", mKey);
+    IHelper::debugAppend(resultEl, "stats type", IStatsReportTypes::toString(mStatsType));
+    IHelper::debugAppend(resultEl, "stat id", mStatID);
+    IHelper::debugAppend(resultEl, "counter name", mCounterName);
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsProviderTypes::StatsDelta::toDebug() const
+  {
+    ElementPtr resultEl = Element::create("ortc::IStatsProviderTypes::StatsDelta");
+
+    IHelper::debugAppend(resultEl, "timestamp", mTimestamp);
+    IHelper::debugAppend(resultEl, "sequence number", mSequenceNumber);
+
+    if (mNewCounters.size() > 0) {
+      ElementPtr newEl = Element::create("new counters");
+      for (auto iter = mNewCounters.begin(); iter != mNewCounters.end(); ++iter) {
+        IHelper::debugAppend(newEl, (*iter).toDebug());
+      }
+      IHelper::debugAppend(resultEl, newEl);
+    }
+
+    if (mChangedCounters.size() > 0) {
+      ElementPtr changedEl = Element::create("changed counters");
+      for (auto iter = mChangedCounters.begin(); iter != mChangedCounters.end(); ++iter) {
+        IHelper::debugAppend(changedEl, "counter", string((*iter).mKey) + "=" + string((*iter).mValue));
+      }
+      IHelper::debugAppend(resultEl, changedEl);
+    }
+
+    if (mRemovedCounters.size() > 0) {
+      ElementPtr removedEl = Element::create("removed counters");
+      for (auto iter = mRemovedCounters.begin(); iter != mRemovedCounters.end(); ++iter) {
+        IHelper::debugAppend(removedEl, "key", *iter);
+      }
+      IHelper::debugAppend(resultEl, removedEl);
+    }
+
+    return resultEl;
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark IStatsSubscription
+  #pragma mark
+
+  //---------------------------------------------------------------------------
+  ElementPtr IStatsSubscription::toDebug(IStatsSubscriptionPtr subscription)
+  {
+    return internal::StatsSubscription::toDebug(internal::StatsSubscription::convert(subscription));
+  }
+
+  //---------------------------------------------------------------------------
+  IStatsSubscriptionPtr IStatsSubscription::create(
+                                                   IStatsSubscriptionDelegatePtr delegate,
+                                                   IStatsProviderPtr provider,
+                                                   const SamplingIntervalMap &intervals
+                                                   )
+  {
+    return internal::IStatsSubscriptionFactory::singleton().create(delegate, provider, intervals);
+  }
+
 
 }
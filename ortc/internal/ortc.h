@@ -36,13 +36,20 @@
 #include <ortc/ortc.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_Helper.h>
+#include <ortc/internal/ortc_ActiveSpeakerDetector.h>
+#include <ortc/internal/ortc_AudioRingBuffer.h>
 #include <ortc/internal/ortc_Certificate.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_ICEGatherer.h>
 #include <ortc/internal/ortc_ICEGathererRouter.h>
+#include <ortc/internal/ortc_ICEGathererPool.h>
 #include <ortc/internal/ortc_ICETransport.h>
 #include <ortc/internal/ortc_ICETransportController.h>
+#include <ortc/internal/ortc_LockProfiler.h>
 #include <ortc/internal/ortc_MediaDevices.h>
+#include <ortc/internal/ortc_MessageQueueMonitor.h>
+#include <ortc/internal/ortc_NetworkImpairment.h>
+#include <ortc/internal/ortc_RTPCapture.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
 #include <ortc/internal/ortc_RTPReceiver.h>
@@ -50,6 +57,7 @@
 #include <ortc/internal/ortc_RTPReceiverChannelMediaBase.h>
 #include <ortc/internal/ortc_RTPReceiverChannelAudio.h>
 #include <ortc/internal/ortc_RTPReceiverChannelVideo.h>
+#include <ortc/internal/ortc_RTPRelay.h>
 #include <ortc/internal/ortc_RTPSender.h>
 #include <ortc/internal/ortc_RTPSenderChannel.h>
 #include <ortc/internal/ortc_RTPSenderChannelMediaBase.h>
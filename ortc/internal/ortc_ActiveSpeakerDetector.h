@@ -0,0 +1,307 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IActiveSpeakerDetector.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/ITimer.h>
+
+#include <atomic>
+
+#define ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_EVALUATION_INTERVAL_IN_MILLISECONDS "ortc/active-speaker-detector/evaluation-interval-in-milliseconds"
+#define ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SILENCE_LEVEL "ortc/active-speaker-detector/silence-level"
+#define ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SWITCH_MARGIN "ortc/active-speaker-detector/switch-margin"
+#define ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_MIN_HOLD_IN_MILLISECONDS "ortc/active-speaker-detector/min-hold-in-milliseconds"
+#define ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_STREAM_TIMEOUT_IN_MILLISECONDS "ortc/active-speaker-detector/stream-timeout-in-milliseconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_INTERACTION_PTR(IActiveSpeakerDetectorForRTPReceiver)
+
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForActiveSpeakerDetector)
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IActiveSpeakerDetectorForRTPReceiver
+    #pragma mark
+
+    interaction IActiveSpeakerDetectorForRTPReceiver
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IActiveSpeakerDetectorForRTPReceiver, ForRTPReceiver)
+
+      static ElementPtr toDebug(ForRTPReceiverPtr detector);
+
+      virtual PUID getID() const = 0;
+
+      // called outside the receiver's lock for every mapped RTP packet that
+      // carries a client-to-mixer audio level header extension
+      virtual void notifyAudioLevel(
+                                    PUID receiverID,
+                                    IRTPTypes::SSRCType ssrc,
+                                    BYTE level,
+                                    const Optional<bool> &voiceActivity
+                                    ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ActiveSpeakerDetector
+    #pragma mark
+    
+    class ActiveSpeakerDetector : public Noop,
+                                  public MessageQueueAssociator,
+                                  public SharedRecursiveLock,
+                                  public IActiveSpeakerDetector,
+                                  public IActiveSpeakerDetectorForRTPReceiver,
+                                  public zsLib::ITimerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IActiveSpeakerDetector;
+      friend interaction IActiveSpeakerDetectorFactory;
+      friend interaction IActiveSpeakerDetectorForRTPReceiver;
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForActiveSpeakerDetector, UseReceiver)
+
+      ZS_DECLARE_STRUCT_PTR(StreamInfo)
+
+      typedef IRTPTypes::SSRCType SSRCType;
+
+      typedef std::pair<PUID, SSRCType> StreamKey;                 // receiver id, ssrc
+      typedef std::map<StreamKey, StreamInfoPtr> StreamMap;
+      typedef std::map<PUID, UseReceiverWeakPtr> ReceiverWeakMap;
+
+      static const size_t kLevelHistory {4};      // evaluation intervals of level history kept per stream (~800ms at the default interval)
+      static const size_t kMaxStreamSlots {64};   // audio streams which can be monitored at the same time
+
+      enum SlotStates
+      {
+        SlotState_Free,
+        SlotState_Claiming,
+        SlotState_Active,
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector::StreamSlot
+      #pragma mark
+
+      // Written by the receivers for every audio packet without taking the
+      // detector lock; evaluate() drains the totals into the stream's
+      // StreamInfo under the lock.
+      struct StreamSlot
+      {
+        std::atomic<DWORD> mState {SlotState_Free};
+        std::atomic<PUID> mReceiverID {};
+        std::atomic<SSRCType> mSSRC {};
+        std::atomic<QWORD> mTotals {};              // packets in the upper 32 bits, summed loudness in the lower 32 bits
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector::StreamInfo
+      #pragma mark
+
+      struct StreamInfo
+      {
+        StreamKey mKey;
+        size_t mSlot {};
+        Time mLastReceived;
+
+        BYTE mLoudness[kLevelHistory];    // ring of per-interval average loudness (127 - level in -dBov)
+        size_t mNext {};
+        size_t mFilled {};
+        DWORD mSum {};
+
+        size_t mTotalPackets {};
+
+        StreamInfo();
+
+        void add(BYTE loudness);
+        BYTE average() const;
+
+        ElementPtr toDebug() const;
+      };
+
+    public:
+      ActiveSpeakerDetector(
+                            const make_private &,
+                            IMessageQueuePtr queue,
+                            IActiveSpeakerDetectorDelegatePtr delegate
+                            );
+
+    protected:
+      ActiveSpeakerDetector(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+    public:
+      virtual ~ActiveSpeakerDetector();
+
+      static ActiveSpeakerDetectorPtr convert(IActiveSpeakerDetectorPtr object);
+      static ActiveSpeakerDetectorPtr convert(ForRTPReceiverPtr object);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector => IActiveSpeakerDetector
+      #pragma mark
+
+      static ElementPtr toDebug(ActiveSpeakerDetectorPtr detector);
+
+      static ActiveSpeakerDetectorPtr create(IActiveSpeakerDetectorDelegatePtr delegate);
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual IActiveSpeakerDetectorSubscriptionPtr subscribe(IActiveSpeakerDetectorDelegatePtr delegate) override;
+
+      virtual void addReceiver(IRTPReceiverPtr receiver) throw (
+                                                                InvalidParameters,
+                                                                InvalidStateError
+                                                                ) override;
+
+      virtual void removeReceiver(IRTPReceiverPtr receiver) override;
+
+      virtual SpeakerPtr getDominantSpeaker() const override;
+
+      virtual void stop() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector => IActiveSpeakerDetectorForRTPReceiver
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPReceiverPtr detector);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual void notifyAudioLevel(
+                                    PUID receiverID,
+                                    SSRCType ssrc,
+                                    BYTE level,
+                                    const Optional<bool> &voiceActivity
+                                    ) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(ITimerPtr timer) override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      void cancel();
+
+      StreamSlot *findSlot(
+                           PUID receiverID,
+                           SSRCType ssrc
+                           );
+      void releaseSlot(size_t index);
+      void collectSlots(const Time &tick);
+
+      void evaluate();
+      SpeakerPtr createSpeaker(const StreamInfo &info) const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ActiveSpeakerDetector => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      ActiveSpeakerDetectorWeakPtr mThisWeak;
+
+      IActiveSpeakerDetectorDelegateSubscriptions mSubscriptions;
+      IActiveSpeakerDetectorSubscriptionPtr mDefaultSubscription;
+
+      bool mShutdown {false};
+
+      ReceiverWeakMap mReceivers;
+      StreamMap mStreams;
+      StreamSlot mSlots[kMaxStreamSlots];
+
+      ITimerPtr mEvaluationTimer;
+      Milliseconds mEvaluationInterval {};
+      BYTE mSilenceLoudness {};                     // averages at or below this loudness are silent
+      BYTE mSwitchMargin {};
+      Milliseconds mMinHold {};
+      Milliseconds mStreamTimeout {};
+
+      Optional<StreamKey> mDominant;
+      Time mDominantSince;
+      size_t mTotalSwitches {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IActiveSpeakerDetectorFactory
+    #pragma mark
+
+    interaction IActiveSpeakerDetectorFactory
+    {
+      static IActiveSpeakerDetectorFactory &singleton();
+
+      virtual ActiveSpeakerDetectorPtr create(IActiveSpeakerDetectorDelegatePtr delegate);
+    };
+
+    class ActiveSpeakerDetectorFactory : public IFactory<IActiveSpeakerDetectorFactory> {};
+  }
+}
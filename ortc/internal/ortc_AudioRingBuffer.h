@@ -0,0 +1,91 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <atomic>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark AudioRingBuffer
+    #pragma mark
+
+    // Lock-free single producer / single consumer ring of interleaved 16-bit
+    // PCM samples. Exactly one thread may call write() and exactly one
+    // (possibly different) thread may call read()/skip().
+    class AudioRingBuffer
+    {
+    public:
+      AudioRingBuffer(size_t minCapacityInSamples);
+      ~AudioRingBuffer();
+
+      AudioRingBuffer(const AudioRingBuffer &) = delete;
+      AudioRingBuffer &operator=(const AudioRingBuffer &) = delete;
+
+      size_t capacity() const {return mMask + 1;}
+
+      size_t available() const;   // samples that can be read
+      size_t space() const;       // samples that can be written
+
+      // producer only; writes all samples or none (returns samples written)
+      size_t write(
+                   const int16_t *samples,
+                   size_t count
+                   );
+
+      // consumer only; returns samples read / skipped (up to count)
+      size_t read(
+                  int16_t *outSamples,
+                  size_t count
+                  );
+      size_t skip(size_t count);
+
+      ElementPtr toDebug() const;
+
+    protected:
+      int16_t *mBuffer {};
+      size_t mMask {};
+
+      std::atomic<size_t> mWritePosition {};  // only modified by the producer
+      std::atomic<size_t> mReadPosition {};   // only modified by the consumer
+    };
+
+  }
+}
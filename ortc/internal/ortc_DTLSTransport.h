@@ -118,6 +118,7 @@ namespace ortc
                           public ISecureTransportForICETransport,
                           public ISecureTransportForSRTPTransport,
                           public ISecureTransportForRTPListener,
+                          public ISecureTransportForRTPCapture,
                           public ISecureTransportForDataTransport,
                           public IDTLSTransportForSettings,
                           public IWakeDelegate,
@@ -136,6 +137,7 @@ namespace ortc
       friend interaction ISecureTransportForRTPReceiver;
       friend interaction ISecureTransportForICETransport;
       friend interaction ISecureTransportForRTPListener;
+      friend interaction ISecureTransportForRTPCapture;
       friend interaction ISecureTransportForSRTPTransport;
       friend interaction ISecureTransportForDataTransport;
       friend interaction IDTLSTransportForSettings;
@@ -192,6 +194,7 @@ namespace ortc
       static DTLSTransportPtr convert(ForICETransportPtr object);
       static DTLSTransportPtr convert(ForSRTPPtr object);
       static DTLSTransportPtr convert(ForRTPListenerPtr object);
+      static DTLSTransportPtr convert(ForRTPCapturePtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -342,6 +345,17 @@ namespace ortc
 
       virtual RTPListenerPtr getListener() const override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark DTLSTransport => ISecureTransportForRTPCapture
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPCapturePtr transport);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual RTPCaptureRingPtr getCaptureRing() const override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark DTLSTransport => ISecureTransportForDataTransport
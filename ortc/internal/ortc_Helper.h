@@ -52,6 +52,207 @@ namespace ortc
     public:
       static Log::Params slog(const char *message);
     };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark EnumStringTable
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    // Perfect hash from the names an enum's toString() produces back to the
+    // enum values. Meant to be built once (as a function local static) so a
+    // string to enum conversion costs one hash and one compare instead of a
+    // toString() and a compare for every value of the enum. When two values
+    // share a name the first one wins, as it did with a linear scan. Should no
+    // seed produce a perfect hash within Size_MaxSlotBits the table falls
+    // back to that linear scan.
+    template <typename EnumType>
+    class EnumStringTable
+    {
+    public:
+      typedef const char *(*ToStringFunc)(EnumType);
+      typedef typename std::underlying_type<EnumType>::type UnderlyingType;
+
+      enum Sizes
+      {
+        Size_MinSlotBits = 3,
+        Size_MaxSlotBits = 16,
+        Size_MaxSeedAttempts = 256,
+      };
+
+    public:
+      //-----------------------------------------------------------------------
+      EnumStringTable(
+                      EnumType first,
+                      EnumType last,
+                      ToStringFunc toStringFunc,
+                      bool caseSensitive = true
+                      ) :
+        mCaseSensitive(caseSensitive)
+      {
+        for (auto index = first; index <= last; index = static_cast<EnumType>(static_cast<UnderlyingType>(index) + 1)) {
+          Entry entry;
+          entry.mName = toStringFunc(index);
+          entry.mLength = strlen(entry.mName);
+          entry.mValue = index;
+
+          size_t existing {};
+          if (findEntry(entry.mName, entry.mLength, existing)) continue;
+
+          mEntries.push_back(entry);
+        }
+
+        for (size_t bits = Size_MinSlotBits; bits <= Size_MaxSlotBits; ++bits) {
+          if ((static_cast<size_t>(1) << bits) < (mEntries.size() * 2)) continue;
+
+          for (DWORD seed = 0; seed < Size_MaxSeedAttempts; ++seed) {
+            if (fill(bits, seed)) return;
+          }
+        }
+
+        // no perfect hash found; mSlots stays empty and find() scans mEntries
+      }
+
+      //-----------------------------------------------------------------------
+      bool find(
+                const char *name,
+                size_t length,
+                EnumType &outValue
+                ) const
+      {
+        if (!name) {
+          name = "";
+          length = 0;
+        }
+
+        if (mSlots.empty()) {
+          size_t index {};
+          if (!findEntry(name, length, index)) return false;
+          outValue = mEntries[index].mValue;
+          return true;
+        }
+
+        size_t slot = mSlots[slotFor(mSlotBits, mSeed, name, length)];
+        if (slot >= mEntries.size()) return false;
+
+        auto &entry = mEntries[slot];
+        if (!equals(entry, name, length)) return false;
+
+        outValue = entry.mValue;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool find(
+                const char *name,
+                EnumType &outValue
+                ) const
+      {
+        return find(name, (name ? strlen(name) : 0), outValue);
+      }
+
+    protected:
+      struct Entry
+      {
+        const char *mName {};
+        size_t mLength {};
+        EnumType mValue {};
+      };
+
+      typedef std::vector<Entry> EntryList;
+      typedef std::vector<size_t> SlotList;
+
+      //-----------------------------------------------------------------------
+      static BYTE normalize(
+                            bool caseSensitive,
+                            char value
+                            )
+      {
+        BYTE result = static_cast<BYTE>(value);
+        if ((!caseSensitive) && (result >= 'A') && (result <= 'Z')) result = static_cast<BYTE>(result - 'A' + 'a');
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t slotFor(
+                     size_t bits,
+                     DWORD seed,
+                     const char *name,
+                     size_t length
+                     ) const
+      {
+        // FNV-1a; the high bits are used as the low bits of a 32 bit FNV
+        // product only depend on the low bits of its inputs
+        DWORD hash = 2166136261UL ^ seed;
+        for (size_t index = 0; index < length; ++index) {
+          hash = (hash ^ normalize(mCaseSensitive, name[index])) * 16777619UL;
+        }
+        return static_cast<size_t>((hash & 0xFFFFFFFFUL) >> (32 - bits));
+      }
+
+      //-----------------------------------------------------------------------
+      bool equals(
+                  const Entry &entry,
+                  const char *name,
+                  size_t length
+                  ) const
+      {
+        if (entry.mLength != length) return false;
+        if (mCaseSensitive) return (0 == memcmp(entry.mName, name, length));
+
+        for (size_t index = 0; index < length; ++index) {
+          if (normalize(false, entry.mName[index]) != normalize(false, name[index])) return false;
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool findEntry(
+                     const char *name,
+                     size_t length,
+                     size_t &outIndex
+                     ) const
+      {
+        for (size_t index = 0; index < mEntries.size(); ++index) {
+          if (!equals(mEntries[index], name, length)) continue;
+          outIndex = index;
+          return true;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      bool fill(
+                size_t bits,
+                DWORD seed
+                )
+      {
+        SlotList slots(static_cast<size_t>(1) << bits, mEntries.size());
+
+        for (size_t index = 0; index < mEntries.size(); ++index) {
+          auto &entry = mEntries[index];
+          auto &slot = slots[slotFor(bits, seed, entry.mName, entry.mLength)];
+          if (slot < mEntries.size()) return false;
+          slot = index;
+        }
+
+        mSlots = slots;
+        mSlotBits = bits;
+        mSeed = seed;
+        return true;
+      }
+
+    protected:
+      bool mCaseSensitive {true};
+
+      EntryList mEntries;
+      SlotList mSlots;
+      size_t mSlotBits {};
+      DWORD mSeed {};
+    };
   }
 }
 
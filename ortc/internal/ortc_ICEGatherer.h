@@ -36,6 +36,7 @@
 #include <ortc/IICEGatherer.h>
 
 #include <ortc/internal/ortc_ICEGathererRouter.h>
+#include <ortc/internal/ortc_NetworkImpairment.h>
 
 #include <ortc/services/IBackOffTimer.h>
 #include <ortc/services/IDNS.h>
@@ -88,6 +89,9 @@
 
 #define ORTC_SETTING_GATHERER_RECHECK_IP_ADDRESSES_IN_SECONDS "ortc/gatherer/recheck-ip-addresses-in-seconds"
 
+#define ORTC_SETTING_GATHERER_LOOPBACK_ONLY "ortc/gatherer/loopback-only"   // only gather 127.0.0.1 and ::1 host candidates (in-process benchmarks)
+#define ORTC_SETTING_GATHERER_LOOPBACK_INTERFACE_NAME "ortc/gatherer/loopback-interface-name"   // interface name the loopback hosts are mapped with (see ORTC_SETTING_GATHERER_INTERFACE_NAME_MAPPING)
+
 namespace ortc
 {
   namespace internal
@@ -279,6 +283,7 @@ namespace ortc
       ZS_DECLARE_STRUCT_PTR(RelayPort);
       ZS_DECLARE_STRUCT_PTR(TCPPort);
       ZS_DECLARE_STRUCT_PTR(BufferedPacket);
+      ZS_DECLARE_STRUCT_PTR(ImpairedPacket);
       ZS_DECLARE_STRUCT_PTR(Route);
       ZS_DECLARE_STRUCT_PTR(InstalledTransport);
       ZS_DECLARE_STRUCT_PTR(Preference);
@@ -311,6 +316,7 @@ namespace ortc
       typedef std::map<CandidatePtr, TCPPortPtr> CandidateToTCPPortMap;
 
       typedef std::list<BufferedPacketPtr> BufferedPacketList;
+      typedef std::multimap<Time, ImpairedPacketPtr> ImpairedPacketMap;
 
       typedef String UsernameFragment;
       typedef PUID TransportID;
@@ -358,6 +364,25 @@ namespace ortc
       static ICEGathererPtr convert(IICEGathererPtr object);
       static ICEGathererPtr convert(ForICETransportPtr object);
 
+      // empty unless ORTC_SETTING_NETWORK_IMPAIRMENT_ENABLED was set when
+      // the gatherer was created
+      NetworkImpairment::Stats getImpairmentStats() const;
+
+      struct ResourceCounts
+      {
+        size_t mTimers {};            // including socket bind back off timers
+        size_t mSockets {};
+        size_t mSTUNDiscoveries {};
+        size_t mTURNSockets {};
+        size_t mLocalCandidates {};
+        size_t mRoutes {};
+        size_t mInstalledTransports {};
+        size_t mBufferedPackets {};
+      };
+
+      // what the gatherer holds right now (for scale testing)
+      ResourceCounts getResourceCounts() const;
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -841,6 +866,23 @@ namespace ortc
 
         ElementPtr toDebug() const;
       };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGatherer::ImpairedPacket
+      #pragma mark
+
+      struct ImpairedPacket
+      {
+        SocketPtr mSocket;
+        IPAddress mBoundIP;
+        IPAddress mRemoteIP;
+
+        SecureByteBlockPtr mBuffer;
+      };
       
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -945,6 +987,7 @@ namespace ortc
       void stepGetHostIPs_WinRT();
       void stepGetHostIPs_Win32();
       void stepGetHostIPs_ifaddr();
+      void stepGetHostIPs_Loopback();
       bool stepCalculateHostsHash();
       bool stepFixHostPorts();
       bool stepBindHostPorts();
@@ -1089,6 +1132,21 @@ namespace ortc
                          const BYTE *buffer,
                          size_t bufferSizeInBytes
                          );
+      bool sendImpairedUDPPacket(
+                                 SocketPtr socket,
+                                 const IPAddress &boundIP,
+                                 const IPAddress &remoteIP,
+                                 const BYTE *buffer,
+                                 size_t bufferSizeInBytes
+                                 );
+      bool writeUDPPacket(
+                          SocketPtr socket,
+                          const IPAddress &boundIP,
+                          const IPAddress &remoteIP,
+                          const BYTE *buffer,
+                          size_t bufferSizeInBytes
+                          );
+      void sendDueImpairedPackets();
 
       bool shouldKeepWarm() const;
       bool shouldWarmUpAfterInterfaceBinding() const;
@@ -1129,6 +1187,8 @@ namespace ortc
       Preference mPreferences[PreferenceType_Last+1];
       HostIPSorter::InterfaceMappingList mInterfaceMappings;
       bool mCreateTCPCandidates {true};
+      bool mLoopbackOnly {false};
+      String mLoopbackInterfaceName;
 
       bool mGetLocalIPsNow {true};
       Seconds mRecheckIPsDuration {};
@@ -1189,6 +1249,11 @@ namespace ortc
       size_t mMaxTotalBuffers {};
       BufferedPacketList mBufferedPackets;
 
+      NetworkImpairmentPtr mImpairment;     // null unless network impairment is enabled (testing only)
+      ImpairedPacketMap mImpairedPackets;
+      ITimerPtr mImpairmentTimer;
+      Time mImpairmentTimerFireAt;
+
       LocalCandidateRemoteIPRouteMap mQuickSearchRoutes;
       RouteMap mRoutes;
       ITimerPtr mCleanUnusedRoutesTimer;
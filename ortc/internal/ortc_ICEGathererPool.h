@@ -0,0 +1,280 @@
+/*
+
+ Copyright (c) 2016, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IICEGatherer.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/ITimer.h>
+
+#define ORTC_SETTING_GATHERER_POOL_SIZE "ortc/gatherer-pool/size"
+#define ORTC_SETTING_GATHERER_POOL_MAX_AGE_IN_SECONDS "ortc/gatherer-pool/max-age-in-seconds"
+#define ORTC_SETTING_GATHERER_POOL_IDLE_TIMEOUT_IN_SECONDS "ortc/gatherer-pool/idle-timeout-in-seconds"
+#define ORTC_SETTING_GATHERER_POOL_MAINTENANCE_INTERVAL_IN_SECONDS "ortc/gatherer-pool/maintenance-interval-in-seconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererPool
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    // Process wide pool of ICE gatherers that have already bound their ports,
+    // enumerated the interfaces and allocated their STUN/TURN candidates so
+    // a new peer connection does not gather in its call setup path. Gatherers
+    // are pooled per set of gather options once those options have been
+    // asked for; pooled gatherers stay alive (and thus keep their TURN
+    // allocations refreshed) until adopted or they reach their maximum age.
+    class ICEGathererPool : public Noop,
+                            public MessageQueueAssociator,
+                            public SharedRecursiveLock,
+                            public IICEGathererDelegate,
+                            public zsLib::ITimerDelegate,
+                            public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      ZS_DECLARE_TYPEDEF_PTR(IICEGathererTypes::Options, Options)
+
+      ZS_DECLARE_STRUCT_PTR(PooledGatherer)
+      ZS_DECLARE_STRUCT_PTR(OptionsPool)
+
+      typedef String OptionsHash;
+      typedef std::list<PooledGathererPtr> PooledGathererList;
+      typedef std::map<OptionsHash, OptionsPoolPtr> OptionsPoolMap;
+
+      struct Stats
+      {
+        size_t mHits {};
+        size_t mMisses {};
+        size_t mPooled {};
+        size_t mExpired {};
+
+        size_t mPooledFirstCandidates {};
+        Milliseconds mPooledFirstCandidateTotal {};
+        size_t mUnpooledFirstCandidates {};
+        Milliseconds mUnpooledFirstCandidateTotal {};
+
+        double hitRate() const;
+        Milliseconds averagePooledFirstCandidate() const;
+        Milliseconds averageUnpooledFirstCandidate() const;
+
+        ElementPtr toDebug() const;
+      };
+
+    public:
+      ICEGathererPool(
+                      const make_private &,
+                      IMessageQueuePtr queue
+                      );
+
+    protected:
+      ICEGathererPool(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      static ICEGathererPoolPtr create();
+
+    public:
+      virtual ~ICEGathererPool();
+
+      static ICEGathererPoolPtr singleton();
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => (for peer connection)
+      #pragma mark
+
+      // returns a gatherer that is subscribed to the delegate and gathering;
+      // outPooled is set when a warm gatherer was taken from the pool
+      static IICEGathererPtr acquire(
+                                     IICEGathererDelegatePtr delegate,
+                                     const Options &options,
+                                     IICEGathererSubscriptionPtr &outSubscription,
+                                     bool &outPooled
+                                     );
+
+      static void notifyFirstCandidate(
+                                       bool pooled,
+                                       Milliseconds timeToFirstCandidate
+                                       );
+
+      static Stats getStats();
+
+      static ElementPtr singletonToDebug();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => IICEGathererDelegate
+      #pragma mark
+
+      virtual void onICEGathererStateChange(
+                                            IICEGathererPtr gatherer,
+                                            IICEGathererTypes::States state
+                                            ) override;
+
+      virtual void onICEGathererLocalCandidate(
+                                               IICEGathererPtr gatherer,
+                                               CandidatePtr candidate
+                                               ) override;
+
+      virtual void onICEGathererLocalCandidateComplete(
+                                                       IICEGathererPtr gatherer,
+                                                       CandidateCompletePtr candidate
+                                                       ) override;
+
+      virtual void onICEGathererLocalCandidateGone(
+                                                   IICEGathererPtr gatherer,
+                                                   CandidatePtr candidate
+                                                   ) override;
+
+      virtual void onICEGathererError(
+                                      IICEGathererPtr gatherer,
+                                      ErrorEventPtr errorEvent
+                                      ) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(ITimerPtr timer) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      bool isShutdown() const { return mShutdown; }
+
+      IICEGathererPtr take(
+                           IICEGathererDelegatePtr delegate,
+                           const Options &options,
+                           IICEGathererSubscriptionPtr &outSubscription
+                           );
+      void readSettings();
+      void startTimer();
+      void record(
+                  bool pooled,
+                  Milliseconds timeToFirstCandidate
+                  );
+
+      void refill();
+      void refill(OptionsPool &pool);
+      virtual IICEGathererPtr createGatherer(const Options &options);
+      void expire(OptionsPool &pool);
+      void remove(IICEGathererPtr gatherer);
+      void close(PooledGatherer &pooled);
+
+      void cancel();
+
+    public:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool::PooledGatherer
+      #pragma mark
+
+      struct PooledGatherer
+      {
+        IICEGathererPtr mGatherer;
+        IICEGathererSubscriptionPtr mSubscription;
+
+        Time mCreated;
+        bool mComplete {false};
+
+        ElementPtr toDebug() const;
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool::OptionsPool
+      #pragma mark
+
+      struct OptionsPool
+      {
+        OptionsHash mHash;
+        Options mOptions;
+        Time mLastRequested;
+
+        PooledGathererList mGatherers;
+
+        ElementPtr toDebug() const;
+      };
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererPool => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      ICEGathererPoolWeakPtr mThisWeak;
+
+      bool mShutdown {false};
+
+      size_t mPoolSize {};
+      Seconds mMaxAge {};
+      Seconds mIdleTimeout {};
+
+      OptionsPoolMap mPools;
+      Stats mStats;
+
+      ITimerPtr mTimer;
+    };
+  }
+}
@@ -330,6 +330,20 @@ namespace ortc
       static ICETransportPtr convert(ForSecureTransportPtr object);
       static ICETransportPtr convert(ForDataTransportPtr object);
 
+      struct ResourceCounts
+      {
+        size_t mTimers {};
+        size_t mSTUNRequesters {};
+        size_t mLegalRoutes {};
+        size_t mWarmRoutes {};
+        size_t mFrozenRoutes {};
+        size_t mPendingActivation {};
+        size_t mBufferedPackets {};
+      };
+
+      // what the transport holds right now (for scale testing)
+      ResourceCounts getResourceCounts() const;
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -271,6 +271,27 @@ namespace ortc
       virtual RTPListenerPtr getListener() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ISecureTransportForRTPCapture
+    #pragma mark
+
+    interaction ISecureTransportForRTPCapture
+    {
+      ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPCapture, ForRTPCapture)
+
+      static ElementPtr toDebug(ForRTPCapturePtr transport);
+
+      static ForRTPCapturePtr convert(IRTPTransportPtr transport);
+
+      virtual PUID getID() const = 0;
+
+      virtual RTPCaptureRingPtr getCaptureRing() const = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
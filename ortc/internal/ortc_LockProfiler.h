@@ -0,0 +1,188 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <atomic>
+
+// Build with ORTC_LOCK_PROFILING defined to measure lock wait and hold
+// times at every ORTC_AUTO_RECURSIVE_LOCK site. Without it the macro is
+// exactly an AutoRecursiveLock and nothing is recorded.
+#ifdef ORTC_LOCK_PROFILING
+
+#ifdef _MSC_VER
+#define ORTC_LOCK_PROFILER_FUNCTION __FUNCTION__
+#else
+#define ORTC_LOCK_PROFILER_FUNCTION __PRETTY_FUNCTION__
+#endif //_MSC_VER
+
+#define ORTC_AUTO_RECURSIVE_LOCK(xName, xLockable)                                                                \
+  static ::ortc::internal::LockProfiler::Site xName##ProfilerSite(__FILE__, __LINE__, ORTC_LOCK_PROFILER_FUNCTION); \
+  ::ortc::internal::LockProfiler::ProfiledAutoRecursiveLock xName(xLockable, xName##ProfilerSite)
+
+#else
+
+#define ORTC_AUTO_RECURSIVE_LOCK(xName, xLockable) AutoRecursiveLock xName(xLockable)
+
+#endif //ORTC_LOCK_PROFILING
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LockProfiler
+    #pragma mark
+
+    // Per call site lock usage. A site is a function local static created
+    // the first time its lock statement runs; sites link themselves into a
+    // process wide list and are never destroyed before exit. Wait time is
+    // attributed to the site that had to wait and hold time to the site
+    // that held the lock, so a slow holder on one thread and the waiter it
+    // stalls on another thread both show up.
+    class LockProfiler
+    {
+    public:
+      enum Metrics
+      {
+        Metric_First,
+
+        Metric_WaitTime = Metric_First,
+        Metric_HoldTime,
+        Metric_Contentions,
+
+        Metric_Last = Metric_Contentions,
+      };
+
+      static const char *toString(Metrics metric);
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LockProfiler::Site
+      #pragma mark
+
+      class Site
+      {
+      public:
+        Site(
+             const char *file,
+             ULONG line,
+             const char *function
+             );
+
+        Site(const Site &) = delete;
+        Site &operator=(const Site &) = delete;
+
+        void record(
+                    bool contended,
+                    QWORD waitInNanoseconds,
+                    QWORD holdInNanoseconds
+                    );
+
+      public:
+        const char *mFile {};
+        ULONG mLine {};
+        const char *mFunction {};
+
+        Site *mNext {};
+
+        std::atomic<QWORD> mAcquired {};
+        std::atomic<QWORD> mContended {};
+        std::atomic<QWORD> mTotalWait {};   // nanoseconds
+        std::atomic<QWORD> mMaxWait {};     // nanoseconds
+        std::atomic<QWORD> mTotalHold {};   // nanoseconds
+        std::atomic<QWORD> mMaxHold {};     // nanoseconds
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LockProfiler::ProfiledAutoRecursiveLock
+      #pragma mark
+
+      class ProfiledAutoRecursiveLock
+      {
+      public:
+        ProfiledAutoRecursiveLock(
+                                  RecursiveLock &lock,
+                                  Site &site
+                                  );
+        ~ProfiledAutoRecursiveLock();
+
+        ProfiledAutoRecursiveLock(const ProfiledAutoRecursiveLock &) = delete;
+        ProfiledAutoRecursiveLock &operator=(const ProfiledAutoRecursiveLock &) = delete;
+
+      protected:
+        RecursiveLock &mLock;
+        Site &mSite;
+        bool mContended {};
+        QWORD mWait {};
+        QWORD mAcquiredAt {};
+      };
+
+    public:
+      static bool isEnabled();              // built with ORTC_LOCK_PROFILING
+
+      // one line per site sorted by the chosen metric (largest first)
+      static String toReport(Metrics sortBy = Metric_WaitTime);
+
+      // "class;function;file:line value" lines as consumed by
+      // flamegraph.pl (values in microseconds or contention counts)
+      static String toFlameGraph(Metrics metric = Metric_WaitTime);
+
+      static void reset();
+
+    protected:
+      static QWORD now();                   // monotonic nanoseconds
+
+      static std::atomic<Site *> &sites();
+
+      static void updateMax(
+                            std::atomic<QWORD> &max,
+                            QWORD value
+                            );
+
+      static QWORD value(
+                         const Site &site,
+                         Metrics metric
+                         );
+      static String lockClass(const char *function);
+      static String functionName(const char *function);
+    };
+
+  }
+}
@@ -0,0 +1,243 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+#include <ortc/internal/ortc_StatsReport.h>
+
+#include <ortc/IStatsProvider.h>
+
+#include <zsLib/IMessageQueue.h>
+
+#include <atomic>
+
+#define ORTC_SETTING_MESSAGE_QUEUE_MONITOR_ENABLED "ortc/message-queue-monitor-enabled"
+#define ORTC_SETTING_MESSAGE_QUEUE_MONITOR_TOP_METHODS "ortc/message-queue-monitor-top-methods"
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor
+    #pragma mark
+
+    // Process wide usage counters for each of the queues handed out by
+    // IORTCForInternal. Queues are wrapped (see monitor()) so that every
+    // posted message is timestamped; the wrapper records the time spent
+    // waiting in the queue and the time spent executing, keyed by the
+    // addresses of the proxy's delegate and method names (methods with the
+    // same names are merged when reporting). Recording is lock free (a few
+    // atomic operations and two clock reads per message) and the message
+    // wrappers come from a preallocated pool.
+    class MessageQueueMonitor
+    {
+    public:
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::StatsTypeSet, StatsTypeSet);
+
+      enum Queues
+      {
+        Queue_First,
+
+        Queue_ORTC = Queue_First,
+        Queue_ORTCPipeline,
+        Queue_Packet,
+        Queue_BlockingMediaStartStop,
+        Queue_MediaChannelStartStop,
+        Queue_CertificateGeneration,
+
+        Queue_Last = Queue_CertificateGeneration,
+      };
+
+      static const char *toString(Queues queue);
+
+      enum Constants
+      {
+        kMaxMethods = 256,        // distinct delegate methods tracked per queue
+        kMessagePoolSize = 1024,  // message wrappers preallocated per process (more are allocated when exhausted)
+      };
+
+      class MonitoredQueue;
+      class MonitoredMessage;
+
+    public:
+      MessageQueueMonitor();
+      MessageQueueMonitor(const MessageQueueMonitor &) = delete;
+      MessageQueueMonitor &operator=(const MessageQueueMonitor &) = delete;
+
+      // returns the original queue if monitoring is disabled
+      static IMessageQueuePtr monitor(
+                                      Queues queue,
+                                      IMessageQueuePtr original
+                                      );
+
+      static PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats);
+
+    protected:
+      struct MethodUsage
+      {
+        enum States
+        {
+          State_Empty,
+          State_Claiming,
+          State_Ready,
+        };
+
+        std::atomic<int> mState {};
+        const char *mDelegateName {};
+        const char *mMethodName {};
+
+        std::atomic<QWORD> mCount {};
+        std::atomic<QWORD> mTotal {};     // microseconds
+        std::atomic<QWORD> mMax {};       // microseconds
+      };
+
+      static MessageQueueMonitor *monitors();
+
+      void notifyPosted();
+      void notifyDequeued(QWORD dwellInMicroseconds);
+      void notifyDiscarded();
+      void notifyExecuted(
+                          const char *delegateName,
+                          const char *methodName,
+                          QWORD executionInMicroseconds
+                          );
+
+      MethodUsage &findMethod(
+                              const char *delegateName,
+                              const char *methodName
+                              );
+
+      IStatsReportTypes::MessageQueueStatsPtr createStats(
+                                                          Queues queue,
+                                                          size_t totalTopMethods
+                                                          ) const;
+
+      static void updateMax(
+                            std::atomic<QWORD> &max,
+                            QWORD value
+                            );
+
+    protected:
+      BYTE mPaddingBefore[ORTC_CACHE_LINE_SIZE] {};
+
+      std::atomic<QWORD> mPosted {};
+      std::atomic<QWORD> mProcessed {};   // dequeued or discarded
+      std::atomic<QWORD> mPeakDepth {};
+
+      LatencyHistogram mDwell;
+
+      MethodUsage mMethods[kMaxMethods];
+      MethodUsage mOtherMethods;          // used once mMethods is full
+
+      BYTE mPaddingAfter[ORTC_CACHE_LINE_SIZE] {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor::MonitoredQueue
+    #pragma mark
+
+    class MessageQueueMonitor::MonitoredQueue : public IMessageQueue
+    {
+    public:
+      MonitoredQueue(
+                     MessageQueueMonitor &monitor,
+                     IMessageQueuePtr queue
+                     );
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageQueueMonitor::MonitoredQueue => IMessageQueue
+      #pragma mark
+
+      virtual void post(IMessageQueueMessageUPtr message) override;
+
+      virtual size_type getTotalUnprocessedMessages() const override;
+
+    protected:
+      MessageQueueMonitor &mMonitor;
+      IMessageQueuePtr mQueue;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MessageQueueMonitor::MonitoredMessage
+    #pragma mark
+
+    class MessageQueueMonitor::MonitoredMessage : public IMessageQueueMessage
+    {
+    public:
+      MonitoredMessage(
+                       MessageQueueMonitor &monitor,
+                       IMessageQueueMessageUPtr message
+                       );
+      ~MonitoredMessage();
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageQueueMonitor::MonitoredMessage => IMessageQueueMessage
+      #pragma mark
+
+      virtual const char *getDelegateName() const override;
+      virtual const char *getMethodName() const override;
+      virtual void processMessage() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageQueueMonitor::MonitoredMessage => (allocation)
+      #pragma mark
+
+      static void *operator new(size_t size);
+      static void operator delete(void *ptr);
+
+    protected:
+      MessageQueueMonitor &mMonitor;
+      IMessageQueueMessageUPtr mMessage;
+      QWORD mPostedAt {};
+      bool mDequeued {};
+    };
+
+  }
+}
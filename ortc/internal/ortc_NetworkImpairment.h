@@ -0,0 +1,160 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_ENABLED "ortc/network-impairment/enabled"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_SEED "ortc/network-impairment/seed"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_LOSS_PER_MILLE "ortc/network-impairment/loss-per-mille"                  // chance a packet starts a loss burst
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_BURST_LOSS_PER_MILLE "ortc/network-impairment/burst-loss-per-mille"      // chance the next packet is lost while in a burst
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_DELAY_IN_MILLISECONDS "ortc/network-impairment/delay-in-milliseconds"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_JITTER_IN_MILLISECONDS "ortc/network-impairment/jitter-in-milliseconds"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_PER_MILLE "ortc/network-impairment/reorder-per-mille"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_DELAY_IN_MILLISECONDS "ortc/network-impairment/reorder-delay-in-milliseconds"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_DUPLICATE_PER_MILLE "ortc/network-impairment/duplicate-per-mille"
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_BANDWIDTH_IN_KBITS_PER_SECOND "ortc/network-impairment/bandwidth-in-kbits-per-second"  // 0 = unlimited
+#define ORTC_SETTING_NETWORK_IMPAIRMENT_QUEUE_SIZE_IN_BYTES "ortc/network-impairment/queue-size-in-bytes"      // bottleneck queue (drop tail) when bandwidth is capped
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark NetworkImpairment
+    #pragma mark
+
+    // Deterministic outgoing link emulator used to test and benchmark
+    // recovery (NACK/RTX, FEC, SCTP retransmission, ICE consent) without a
+    // real impaired network. Given the same seed, parameters and sequence
+    // of packet sizes, schedule() always makes the same decisions.
+    //
+    // Loss follows a two state (Gilbert) model: a packet starts a loss
+    // burst with the loss chance, and every following packet is lost with
+    // the burst chance until one gets through. Accepted packets queue
+    // behind the bandwidth cap (drop tail when the queue is full), then get
+    // the fixed delay plus uniform jitter. Jitter never reorders packets on
+    // its own; only packets picked for reordering are held back past their
+    // successors.
+    //
+    // The object does no I/O and has no lock; the owner serialises calls
+    // and is responsible for actually sending each copy at its time.
+    class NetworkImpairment
+    {
+    public:
+      struct Parameters
+      {
+        bool mEnabled {false};            // enabled with nothing set is a pass through (still counts)
+        QWORD mSeed {1};
+
+        ULONG mLossPerMille {};
+        ULONG mBurstLossPerMille {};
+
+        Milliseconds mDelay {};
+        Milliseconds mJitter {};
+
+        ULONG mReorderPerMille {};
+        Milliseconds mReorderDelay {};
+
+        ULONG mDuplicatePerMille {};
+
+        ULONG mBandwidthInKbitsPerSecond {};
+        size_t mQueueSizeInBytes {};
+
+        static Parameters createFromSettings();
+
+        ElementPtr toDebug() const;
+      };
+
+      struct Stats
+      {
+        size_t mPacketsSubmitted {};
+        size_t mBytesSubmitted {};
+        size_t mPacketsScheduled {};        // including duplicates
+        size_t mBytesScheduled {};
+        size_t mPacketsLost {};             // random loss
+        size_t mPacketsDropped {};          // bottleneck queue overflow
+        size_t mPacketsDuplicated {};
+        size_t mPacketsReordered {};
+
+        ElementPtr toDebug() const;
+      };
+
+      enum ScheduleLimits
+      {
+        ScheduleLimit_MaxCopies = 2,
+      };
+
+    public:
+      NetworkImpairment(const Parameters &params);
+
+      // returns null unless the parameters are enabled
+      static NetworkImpairmentPtr create(const Parameters &params);
+
+      // Decides the fate of one outgoing packet. Fills outSendAt with the
+      // time each copy must be sent (ordered, never before now) and returns
+      // the number of copies: 0 when the packet is lost or dropped, 2 when
+      // it is duplicated.
+      size_t schedule(
+                      const Time &now,
+                      size_t packetSizeInBytes,
+                      Time (&outSendAt)[ScheduleLimit_MaxCopies]
+                      );
+
+      const Parameters &parameters() const {return mParams;}
+      Stats stats() const {return mStats;}
+
+      ElementPtr toDebug() const;
+
+    protected:
+      QWORD random();
+      bool chance(ULONG perMille);
+      Microseconds randomJitter();
+
+    protected:
+      Parameters mParams;
+      Stats mStats;
+
+      QWORD mRandomState {};
+      bool mInLossBurst {false};
+
+      Time mLinkFreeAt {};                  // when the bottleneck finishes serialising queued packets
+      Time mLastInOrderAt {};               // latest time handed to an in order packet
+    };
+
+  }
+}
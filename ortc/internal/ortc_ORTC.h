@@ -40,6 +40,8 @@
 #define ORTC_QUEUE_CERTIFICATE_GENERATION_NAME "org.ortc.ortcLibCertificateGeneration"
 #define ORTC_QUEUE_PACKET_THREAD_NAME "org.ortc.ortcLibPacketThread."
 #define ORTC_QUEUE_TOTAL_PACKET_THREADS 4
+#define ORTC_QUEUE_MEDIA_CHANNEL_THREAD_NAME "org.ortc.ortcLibMediaChannel."
+#define ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS 4
 
 #define ORTC_QUEUE_THREAD_MAIN_PRIORITY  "ortc/ortc-thread-main-priority"
 #define ORTC_QUEUE_THREAD_PIPELINE_PRIORITY  "ortc/ortc-thread-pipeline-priority"
@@ -66,6 +68,7 @@ namespace ortc
       static IMessageQueuePtr queueORTCPipeline();
       static IMessageQueuePtr queuePacket();
       static IMessageQueuePtr queueBlockingMediaStartStopThread();
+      static IMessageQueuePtr queueMediaChannelStartStop();
       static IMessageQueuePtr queueCertificateGeneration();
 
       static Optional<Log::Level> webrtcLogLevel();
@@ -141,6 +144,7 @@ namespace ortc
       virtual IMessageQueuePtr queueORTCPipeline() const;
       virtual IMessageQueuePtr queuePacket() const;
       virtual IMessageQueuePtr queueBlockingMediaStartStopThread() const;
+      virtual IMessageQueuePtr queueMediaChannelStartStop() const;
       virtual IMessageQueuePtr queueCertificateGeneration() const;
 
       virtual Optional<Log::Level> webrtcLogLevel() const;
@@ -170,6 +174,9 @@ namespace ortc
       mutable IMessageQueuePtr mPacketQueues[ORTC_QUEUE_TOTAL_PACKET_THREADS];
       mutable size_t mNextPacketQueueThread {};
 
+      mutable IMessageQueuePtr mMediaChannelQueues[ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS];
+      mutable size_t mNextMediaChannelQueueThread {};
+
       Milliseconds mNTPServerTime {};
 
       Optional<Log::Level> mDefaultWebRTCLogLevel{};
@@ -660,6 +660,117 @@ namespace ortc
         public:
         };
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC
+        #pragma mark
+
+        struct TransportCC
+        {
+          // https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01#section-3.1
+
+          static const BYTE kFmt {15};
+
+          typedef WORD PacketChunk;
+
+          static const BYTE kStatusSymbolNotReceived {0};
+          static const BYTE kStatusSymbolReceivedSmallDelta {1};
+          static const BYTE kStatusSymbolReceivedLargeOrNegativeDelta {2};
+          static const BYTE kStatusSymbolReserved {3};
+
+          static const size_t kMaxRunLength {0x1FFF};
+          static const size_t kOneBitSymbolsPerVector {14};
+          static const size_t kTwoBitSymbolsPerVector {7};
+
+          static const size_t kRecvDeltaResolutionInMicroseconds {250};
+          static const size_t kReferenceTimeResolutionInMilliseconds {64};
+
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC::RunLength
+          #pragma mark
+
+          struct RunLength
+          {
+            // https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01#section-3.1.3
+
+            RunLength(PacketChunk chunk);
+
+            BYTE statusSymbol() const                         {return mStatusSymbol;}
+            size_t runLength() const                          {return static_cast<size_t>(mRunLength);}
+
+          public:
+            BYTE mStatusSymbol {};
+            WORD mRunLength {};   // A value between 1 and 8191.
+          };
+
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC::StatusVector
+          #pragma mark
+
+          struct StatusVector
+          {
+            // https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01#section-3.1.4
+
+            StatusVector(PacketChunk chunk);
+
+            size_t symbolSizeInBits() const                   {return (0 != mSymbolSize ? 2 : 1);}
+            size_t symbolCount() const;
+            BYTE symbolAtIndex(size_t index) const;
+
+          public:
+            BYTE mSymbolSize {};  // Zero indicates one bit symbols.  One indicates two bit symbols.
+            WORD mSymbolList {};
+          };
+
+          //-------------------------------------------------------------------
+          #pragma mark
+          #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC (public)
+          #pragma mark
+
+          WORD baseSequenceNumber() const                     {return mBaseSequenceNumber;}
+          WORD packetStatusCount() const                      {return mPacketStatusCount;}
+          LONG referenceTime() const                          {return mReferenceTime;}    // signed, in multiples of 64ms
+          BYTE fbPktCount() const                             {return mFBPktCount;}
+
+          size_t packetChunkCount() const                     {return mPacketChunkCount;}
+          PacketChunk packetChunkAtIndex(size_t index) const;
+
+          size_t recvDeltaCount() const                       {return mRecvDeltaCount;}
+          LONG recvDeltaAtIndex(size_t index) const;          // signed, in multiples of 250us
+
+          static bool isRunLengthChunk(PacketChunk chunk);
+          static bool isStatusVectorChunk(PacketChunk chunk);
+
+          static RunLength runLength(PacketChunk chunk)       {return RunLength(chunk);}
+          static StatusVector statusVector(PacketChunk chunk) {return StatusVector(chunk);}
+
+          static PacketChunk createRunLengthChunk(
+                                                  BYTE statusSymbol,
+                                                  size_t runLength
+                                                  );
+          static PacketChunk createStatusVectorChunk(
+                                                     const BYTE *statusSymbols,
+                                                     size_t symbolCount,
+                                                     bool twoBitSymbols
+                                                     );
+
+          static size_t getRecvDeltaSize(BYTE statusSymbol);
+
+        public:
+          WORD mBaseSequenceNumber {};
+          WORD mPacketStatusCount {};
+          LONG mReferenceTime {};
+          BYTE mFBPktCount {};
+
+          size_t mPacketChunkCount {};
+          PacketChunk *mPacketChunks {};
+
+          size_t mRecvDeltaCount {};
+          LONG *mRecvDeltas {};
+        };
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTCPPacket::TransportLayerFeedbackMessage (public)
@@ -678,6 +789,8 @@ namespace ortc
         size_t tmmbnCount() const                               {return mTMMBNCount;}
         TMMBN *tmmbnAtIndex(size_t index) const;
 
+        TransportCC *transportCC() const;
+
         TransportLayerFeedbackMessage *unknown() const          {return mUnknown;}
 
       public:
@@ -692,6 +805,9 @@ namespace ortc
         size_t mTMMBNCount {};
         TMMBN *mFirstTMMBN {};
 
+        bool mHasTransportCC {false};
+        TransportCC mTransportCC {};
+
         TransportLayerFeedbackMessage *mUnknown {};
       };
 
@@ -1401,6 +1517,46 @@ namespace ortc
         UnknownReport *mNextUnknown {};
       };
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTCPPacket::FeedbackEvent
+      #pragma mark
+
+      // Compact description of a single NACK/PLI/FIR/REMB request extracted
+      // from raw RTCP bytes without constructing a full RTCPPacket.
+      struct FeedbackEvent
+      {
+        enum Types
+        {
+          Type_First,
+
+          Type_GenericNACK = Type_First,
+          Type_PLI,
+          Type_FIR,
+          Type_REMB,
+
+          Type_Last = Type_REMB,
+        };
+
+        static const char *toString(Types type);
+
+        ElementPtr toDebug() const;
+
+      public:
+        Types mType {Type_First};
+
+        DWORD mSSRCOfPacketSender {};
+        DWORD mSSRC {};             // SSRC of the media source being targeted
+
+        WORD mPID {};               // Type_GenericNACK
+        WORD mBLP {};               // Type_GenericNACK
+        BYTE mSeqNr {};             // Type_FIR
+        BYTE mBRExp {};             // Type_REMB
+        DWORD mBRMantissa {};       // Type_REMB
+      };
+
+      typedef std::vector<FeedbackEvent> FeedbackEventList;
+
     public:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -1416,6 +1572,34 @@ namespace ortc
       static RTCPPacketPtr create(const Report *first);
       static SecureByteBlockPtr generateFrom(const Report *first);
 
+      // Single pass over a compound RTCP packet that extracts NACK, PLI, FIR
+      // and REMB requests. Returns false if the packet is malformed.
+      // "outFeedbackOnly" is set to true only when every report contained
+      // in the packet was fully described by "outEvents" (i.e. a full parse
+      // would not reveal anything else).
+      static bool extractFeedback(
+                                  const BYTE *buffer,
+                                  size_t bufferLengthInBytes,
+                                  FeedbackEventList &outEvents,
+                                  bool &outFeedbackOnly
+                                  );
+
+      // RFC 5506 - a reduced-size packet does not begin with SR / RR
+      static bool isReducedSize(
+                                const BYTE *buffer,
+                                size_t bufferLengthInBytes
+                                );
+
+      // Prefixes an empty RR and an SDES CNAME chunk from the first report's
+      // sender SSRC so a reduced-size packet can be sent when rtcp-rsize was
+      // not negotiated. Returns NULL when the packet must be sent unchanged
+      // (i.e. it is already compound or no CNAME is available).
+      static SecureByteBlockPtr convertToCompound(
+                                                  const BYTE *buffer,
+                                                  size_t bufferLengthInBytes,
+                                                  const char *cname
+                                                  );
+
       const BYTE *ptr() const;
       size_t size() const;
       SecureByteBlockPtr buffer() const;
@@ -1482,6 +1666,7 @@ namespace ortc
       bool getTransportLayerFeedbackMessageGenericNACKAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getTransportLayerFeedbackMessageTMMBRAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getTransportLayerFeedbackMessageTMMBNAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
+      bool getTransportLayerFeedbackMessageTransportCCAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
 
       bool getPayloadSpecificFeedbackMessagePLIAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getPayloadSpecificFeedbackMessageSLIAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
@@ -1526,8 +1711,17 @@ namespace ortc
       void fillTMMBRCommon(TransportLayerFeedbackMessage *report, TransportLayerFeedbackMessage::TMMBRCommon *common, const BYTE *pos);
       bool parseTMMBR(TransportLayerFeedbackMessage *report);
       bool parseTMMBN(TransportLayerFeedbackMessage *report);
+      bool parseTransportCC(TransportLayerFeedbackMessage *report);
       bool parseUnknown(TransportLayerFeedbackMessage *report);
 
+      static bool getTransportCCSizes(
+                                      const BYTE *contents,
+                                      size_t contentSize,
+                                      size_t &outPacketChunkCount,
+                                      size_t &outRecvDeltaCount,
+                                      size_t &outRecvDeltaSize
+                                      );
+
       //CodecControlCommon
       bool parsePLI(PayloadSpecificFeedbackMessage *report);
       bool parseSLI(PayloadSpecificFeedbackMessage *report);
@@ -1554,6 +1748,14 @@ namespace ortc
 
       void *allocateBuffer(size_t size);
 
+      static bool extractFeedback(
+                                  BYTE pt,
+                                  BYTE fmt,
+                                  const BYTE *contents,
+                                  size_t contentSize,
+                                  FeedbackEventList &ioEvents
+                                  );
+
       static size_t getPacketSize(const Report *first);
       static void writePacket(const Report *first, BYTE * &ioPos, size_t &ioRemaining);
 
@@ -0,0 +1,165 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+
+#include <ortc/IICETypes.h>
+#include <ortc/IRTPCapture.h>
+
+#include <atomic>
+
+namespace ortc
+{
+  namespace internal
+  {
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPCaptureRing
+    #pragma mark
+
+    // Fixed size ring of captured (decrypted) RTP/RTCP packets. All memory
+    // is allocated up front; capture() never allocates or locks and may be
+    // called from any number of threads. Each slot holds the packet's
+    // headers plus the first few payload bytes (up to the snap length).
+    //
+    // Each slot is guarded by a sequence number (a seqlock). A writer
+    // claims the slot by swapping its sequence for a "writing" marker
+    // (compare and swap), fills the slot, then publishes the sequence. A
+    // writer that cannot claim the slot (another writer that wrapped the
+    // ring holds it, or a newer packet already landed) drops its packet
+    // rather than wait. dump() skips any slot whose sequence changed while
+    // it was copied, so a dump running during capture can never return a
+    // torn packet.
+    class RTPCaptureRing
+    {
+    public:
+      typedef IRTPCapture::Formats Formats;
+      typedef IRTPCapture::Directions Directions;
+
+      RTPCaptureRing(
+                     size_t bufferSizeInBytes,
+                     size_t snapLengthInBytes,
+                     size_t rtpPayloadBytes
+                     );
+      ~RTPCaptureRing();
+
+      RTPCaptureRing(const RTPCaptureRing &) = delete;
+      RTPCaptureRing &operator=(const RTPCaptureRing &) = delete;
+
+      // returns null if capturing is disabled (i.e. buffer size is 0)
+      static RTPCaptureRingPtr create(
+                                      size_t bufferSizeInBytes,
+                                      size_t snapLengthInBytes,
+                                      size_t rtpPayloadBytes
+                                      );
+
+      void capture(
+                   Directions direction,          // incoming or outgoing
+                   IICETypes::Components packetType,
+                   const BYTE *buffer,
+                   size_t bufferLengthInBytes
+                   );
+
+      SecureByteBlockPtr dump(
+                              Formats format,
+                              Directions direction
+                              ) const;
+
+      ElementPtr toDebug() const;
+
+    protected:
+      struct Slot
+      {
+        std::atomic<QWORD> mSequence {};  // 0 = empty, kSlotWriting = being written
+        QWORD mTimestamp {};              // microseconds since epoch
+        DWORD mOriginalLength {};
+        WORD mCapturedLength {};
+        BYTE mDirection {};
+        BYTE mPacketType {};
+      };
+
+      struct Packet
+      {
+        QWORD mTimestamp {};
+        DWORD mOriginalLength {};
+        Directions mDirection {};
+        IICETypes::Components mPacketType {};
+        size_t mOffset {};                // into the dump's data copy
+        size_t mCapturedLength {};
+      };
+
+      typedef std::list<Packet> PacketList;
+
+      static const QWORD kSlotWriting = static_cast<QWORD>(-1);
+
+      size_t captureLength(
+                           IICETypes::Components packetType,
+                           const BYTE *buffer,
+                           size_t bufferLengthInBytes
+                           ) const;
+
+      void snapshot(
+                    Directions direction,
+                    PacketList &outPackets,
+                    SecureByteBlock &outData
+                    ) const;
+
+      static SecureByteBlockPtr toRTPDump(
+                                          const PacketList &packets,
+                                          const SecureByteBlock &data
+                                          );
+      static SecureByteBlockPtr toPCAPNG(
+                                         const PacketList &packets,
+                                         const SecureByteBlock &data
+                                         );
+
+    protected:
+      size_t mSnapLength {};
+      size_t mRTPPayloadBytes {};
+      size_t mTotalSlots {};
+
+      Slot *mSlots {};
+      BYTE *mData {};                     // mTotalSlots * mSnapLength
+
+      BYTE mPaddingBefore[ORTC_CACHE_LINE_SIZE] {};
+      std::atomic<QWORD> mNextSequence {};
+      BYTE mPaddingAfter[ORTC_CACHE_LINE_SIZE] {};
+
+      std::atomic<QWORD> mTotalDropped {};  // lost a slot to a concurrent writer
+    };
+
+  }
+}
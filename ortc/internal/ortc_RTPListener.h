@@ -33,6 +33,7 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
 
 #include <ortc/IRTPListener.h>
 #include <ortc/IMediaStreamTrack.h>
@@ -293,6 +294,12 @@ namespace ortc
       ZS_DECLARE_PTR(ReceiverObjectMap)
       ZS_DECLARE_PTR(SenderObjectMap)
 
+      typedef std::map<SSRCType, SenderID> SenderSSRCMap;
+      ZS_DECLARE_PTR(SenderSSRCMap)
+
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+      typedef std::map<SenderID, FeedbackEventList> SenderFeedbackMap;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPListener::SSRCInfo
@@ -570,6 +577,19 @@ namespace ortc
       void processSDESMid(const RTCPPacket &rtcpPacket);
       void processSenderReports(const RTCPPacket &rtcpPacket);
 
+      bool routeFeedback(
+                         IICETypes::Components viaComponent,
+                         const BYTE *buffer,
+                         size_t bufferLengthInBytes,
+                         const FeedbackEventList &events,
+                         bool &outResult
+                         );
+
+      void setSenderSSRCs(
+                          SenderID senderID,
+                          const Parameters *params
+                          );
+
       void handleDeltaChanges(
                               ReceiverInfoPtr replacementInfo,
                               const EncodingParameters &existing,
@@ -628,6 +648,7 @@ namespace ortc
 
       ReceiverObjectMapPtr mReceivers;  // non-mutable map values (COW)
       SenderObjectMapPtr mSenders;      // non-mutable map values (COW)
+      SenderSSRCMapPtr mSenderSSRCs;    // non-mutable map values (COW)
 
       SSRCMap mSSRCTable;
       SSRCWeakMap mRegisteredSSRCs;
@@ -60,6 +60,9 @@
 #include <webrtc/video/vie_remb.h>
 //#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
 
+#define ORTC_SETTING_RTP_MEDIA_ENGINE_SHARE_VIDEO_ENCODERS "ortc/rtp-media-engine/share-video-encoders"
+#define ORTC_SETTING_RTP_MEDIA_ENGINE_SHARED_VIDEO_ENCODER_MIN_KEY_FRAME_INTERVAL_IN_MILLISECONDS "ortc/rtp-media-engine/shared-video-encoder-min-key-frame-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -245,6 +248,8 @@ namespace ortc
       virtual void onUpdate(ParametersPtr params) = 0;
       virtual void onProvideStats(PromiseWithStatsReportPtr promise, IStatsReportTypes::StatsTypeSet stats) = 0;
       virtual void onSendDTMFTone() = 0;
+      virtual void onStepSetup() = 0;
+      virtual void onStepShutdown() = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -272,6 +277,16 @@ namespace ortc
     {
       virtual bool handlePacket(const RTPPacket &packet) = 0;
       virtual bool handlePacket(const RTCPPacket &packet) = 0;
+
+      // pulls one 10ms frame of decoded (and mixed) audio resampled to the
+      // requested rate; returns false if no frame could be produced
+      virtual bool getAudioFrame(
+                                 const uint32_t samplesPerSecond,
+                                 int16_t *outSamples,
+                                 const size_t maxSamples,
+                                 size_t &outSamplesPerChannel,
+                                 size_t &outNumberOfChannels
+                                 ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -295,6 +310,14 @@ namespace ortc
       virtual String toneBuffer() const = 0;
       virtual Milliseconds duration() const = 0;
       virtual Milliseconds interToneGap() const = 0;
+
+      // pushes one 10ms frame of externally captured audio into the channel
+      virtual bool sendAudioFrame(
+                                  const int16_t *samples,
+                                  const size_t samplesPerChannel,
+                                  const size_t numberOfChannels,
+                                  const uint32_t samplesPerSecond
+                                  ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -581,6 +604,7 @@ namespace ortc
       virtual void notifyResourceGone(IChannelResourceForRTPMediaEngine &resource) = 0;
 
       virtual webrtc::VoiceEngine *getVoiceEngine() = 0;
+      virtual RecursiveLock &getVoiceEngineLock() = 0;
       virtual rtc::scoped_refptr<webrtc::AudioDecoderFactory> getAudioDecoderFactory() = 0;
       virtual rtc::scoped_refptr<webrtc::AudioState> getAudioState() = 0;
       virtual const SharedRecursiveLock &getSharedLock() const = 0;
@@ -614,6 +638,7 @@ namespace ortc
 
       struct SetupChannel : public SetupResource
       {
+        QWORD mRequestedAt {};
         PromiseWithRTPMediaEngineChannelResourcePtr mPromise;
         TransportPtr mTransport;
         UseMediaStreamTrackPtr mTrack;
@@ -655,7 +680,12 @@ namespace ortc
     {
       ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame);
 
-      virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) = 0;
+      virtual void onHandleRTPPacket(
+                                     DWORD timestamp,
+                                     SecureByteBlockPtr buffer,
+                                     QWORD ingressTime,
+                                     QWORD queuedAt
+                                     ) = 0;
       virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) = 0;
       virtual void onSendVideoFrame(VideoFramePtr videoFrame) = 0;
     };
@@ -729,6 +759,7 @@ namespace ortc
       ZS_DECLARE_CLASS_PTR(AudioSenderChannelResource);
       ZS_DECLARE_CLASS_PTR(VideoReceiverChannelResource);
       ZS_DECLARE_CLASS_PTR(VideoSenderChannelResource);
+      ZS_DECLARE_CLASS_PTR(SharedVideoEncoder);
 
       struct VideoCaptureCapabilityWithDistance
       {
@@ -751,6 +782,8 @@ namespace ortc
       typedef std::list<DeviceResourcePtr> DeviceResourceList;
       typedef std::map<PUID, ChannelResourceWeakPtr> ChannelResourceWeakMap;
       typedef std::list<ChannelResourcePtr> ChannelResourceList;
+      typedef std::map<String, SharedVideoEncoderWeakPtr> SharedVideoEncoderWeakMap;
+      typedef std::vector<uint32_t> SSRCList;
 
     public:
       RTPMediaEngine(
@@ -903,6 +936,8 @@ namespace ortc
 
       // (duplicate) virtual webrtc::VoiceEngine *getVoiceEngine() = 0;
 
+      virtual RecursiveLock &getVoiceEngineLock() override { return mVoiceEngineLock; }
+
       virtual rtc::scoped_refptr<webrtc::AudioDecoderFactory> getAudioDecoderFactory() override;
 
       virtual rtc::scoped_refptr<webrtc::AudioState> getAudioState() override;
@@ -967,6 +1002,25 @@ namespace ortc
       #pragma mark
 
       void shutdownChannelResource(ChannelResourcePtr channelResource);
+      void notifyChannelResourceCancelled();
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPMediaEngine => (friend VideoSenderChannelResource)
+      #pragma mark
+
+      SharedVideoEncoderPtr attachSharedVideoEncoder(
+                                                     const String &key,
+                                                     VideoSenderChannelResourcePtr resource,
+                                                     TransportPtr transport,
+                                                     const SSRCList &ssrcs,
+                                                     int redPayloadType,
+                                                     int ulpfecPayloadType,
+                                                     ULONG clockRate,
+                                                     int maxFramerate,
+                                                     bool &outProducer
+                                                     );
+      void resetupChannelResource(ChannelResourcePtr channelResource);
 
     protected:
       //-----------------------------------------------------------------------
@@ -1075,7 +1129,8 @@ namespace ortc
         BaseResource(
                      const make_private &,
                      IRTPMediaEngineRegistrationPtr registration,
-                     RTPMediaEnginePtr engine
+                     RTPMediaEnginePtr engine,
+                     IMessageQueuePtr queue = IMessageQueuePtr()  // defaults to the engine's queue
                      );
         virtual ~BaseResource();
 
@@ -1096,6 +1151,7 @@ namespace ortc
         std::shared_ptr<engine_interface> getEngine() const {return mMediaEngine.lock();}
 
         virtual void lifetimeHolderGone() {}
+        virtual void promisesSettled(bool resolved) {}
 
       protected:
         //---------------------------------------------------------------------
@@ -1354,6 +1410,7 @@ namespace ortc
         virtual ~ChannelResource();
 
         virtual void lifetimeHolderGone() override;
+        virtual void promisesSettled(bool resolved) override;
 
         //---------------------------------------------------------------------
         #pragma mark
@@ -1372,12 +1429,17 @@ namespace ortc
         #pragma mark
 
         virtual void onSendDTMFTone() override { }
+        virtual void onStepSetup() override;
+        virtual void onStepShutdown() override;
 
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTPMediaEngine::ChannelResource => (friend RTPMediaEngine)
         #pragma mark
 
+        void notifySetupRequested(QWORD requestedAt);
+        void notifyShutdownRequested(QWORD requestedAt);
+
         virtual void stepSetup() = 0;
         virtual void stepShutdown() = 0;
 
@@ -1417,6 +1479,9 @@ namespace ortc
         bool mShutdown {false};
         PromiseList mShutdownPromises;
 
+        QWORD mSetupRequestedAt {};       // see MediaChannelLatency
+        QWORD mShutdownRequestedAt {};
+
         IMessageQueuePtr mHandlePacketQueue;
         std::atomic<size_t> mAccessFromNonLockedMethods {};
         std::atomic<bool> mDenyNonLockedAccess {};
@@ -1498,12 +1563,25 @@ namespace ortc
         virtual bool handlePacket(const RTPPacket &packet) override;
         virtual bool handlePacket(const RTCPPacket &packet) override;
 
+        virtual bool getAudioFrame(
+                                   const uint32_t samplesPerSecond,
+                                   int16_t *outSamples,
+                                   const size_t maxSamples,
+                                   size_t &outSamplesPerChannel,
+                                   size_t &outNumberOfChannels
+                                   ) override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTPMediaEngine::AudioReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       QWORD ingressTime,
+                                       QWORD queuedAt
+                                       ) override;
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1556,6 +1634,8 @@ namespace ortc
         webrtc::AudioReceiveStream *mReceiveStream { NULL };
 
         int mDTMFPayloadType{ 0 };
+
+        std::atomic<bool> mExternalMixing {};
       };
 
       //-----------------------------------------------------------------------
@@ -1651,12 +1731,24 @@ namespace ortc
         virtual Milliseconds duration() const override;
         virtual Milliseconds interToneGap() const override;
 
+        virtual bool sendAudioFrame(
+                                    const int16_t *samples,
+                                    const size_t samplesPerChannel,
+                                    const size_t numberOfChannels,
+                                    const uint32_t samplesPerSecond
+                                    ) override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTPMediaEngine::AudioSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       QWORD ingressTime,
+                                       QWORD queuedAt
+                                       ) override {}
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1818,7 +1910,12 @@ namespace ortc
         #pragma mark RTPMediaEngine::VideoReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       QWORD ingressTime,
+                                       QWORD queuedAt
+                                       ) override;
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
 
@@ -1947,7 +2044,12 @@ namespace ortc
         #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
+        virtual void onHandleRTPPacket(
+                                       DWORD timestamp,
+                                       SecureByteBlockPtr buffer,
+                                       QWORD ingressTime,
+                                       QWORD queuedAt
+                                       ) override {}
         virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
         virtual void onSendVideoFrame(VideoFramePtr videoFrame) override;
 
@@ -1973,12 +2075,48 @@ namespace ortc
 
         virtual void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps, uint32_t max_padding_bitrate_bps) override;
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::VideoSenderChannelResource => friend SharedVideoEncoder
+        #pragma mark
+
+        bool isSharedSendActive() const;
+        void deliverSharedRTCP(const BYTE *buffer, size_t bufferLengthInBytes);
+        void notifySharedSendStateChanged();
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::VideoSenderChannelResource => (internal)
+        #pragma mark
+
+        static bool isActive(const Parameters &params);
+        void updateSendStream();
+        static String sharedEncoderKey(
+                                       const String &trackID,
+                                       const Parameters &params,
+                                       const webrtc::VideoSendStream::Config &config,
+                                       const webrtc::VideoEncoderConfig &encoderConfig
+                                       );
+        void provideSharedStats(
+                                PromiseWithStatsReportPtr promise,
+                                const IStatsReportTypes::StatsTypeSet &stats
+                                );
+
       protected:
         TransportPtr mTransport;
         std::atomic<ISecureTransport::States> mTransportState{ ISecureTransport::State_Pending };
+        std::atomic<bool> mEncodingActive {true};
 
         UseMediaStreamTrackWeakPtr mTrack;
 
+        SharedVideoEncoderPtr mSharedEncoder;
+        std::atomic<bool> mSharedConsumer {};
+        SSRCList mSharedSSRCs;
+
+        Lock mSendStreamStateLock;    // orders send stream start / stop
+        bool mSendStreamStarted {};
+
         ParametersPtr mParameters;
 
         String mSendCodecPayloadName;
@@ -1990,6 +2128,176 @@ namespace ortc
         const std::unique_ptr<webrtc::SendDelayStats> mVideoSendDelayStats;
       };
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPMediaEngine::SharedVideoEncoder
+      #pragma mark
+
+      // When several senders carry the same video track with the same codec
+      // and encoding layout, only one of them (the producer) runs a
+      // VideoSendStream. Its RTP is fanned out to the other senders (the
+      // consumers) with their SSRC, sequence number and timestamp rewritten
+      // and keyframe requests from all consumers are rate limited into the
+      // producer's encoder.
+      //
+      // The producer's stream runs while the producer itself or any attached
+      // consumer is connected and active, so a consumer keeps receiving
+      // media even when the producer's own transport is not (yet) connected.
+      // Consumers report transport and activity changes through
+      // notifyConsumerStateChanged() so the producer can start or stop it.
+      class SharedVideoEncoder : public webrtc::Transport
+      {
+        struct make_private {};
+
+      public:
+        struct Layer
+        {
+          uint32_t mSSRC {};
+
+          bool mResync {true};
+          WORD mSequenceNumberDelta {};
+          DWORD mTimestampDelta {};
+          WORD mLastSequenceNumber {};
+          DWORD mLastTimestamp {};
+
+          size_t mPacketsSent {};
+          size_t mBytesSent {};
+        };
+
+        typedef std::vector<Layer> LayerList;
+
+        ZS_DECLARE_STRUCT_PTR(Consumer)
+
+        struct Consumer
+        {
+          PUID mID {};
+          VideoSenderChannelResourceWeakPtr mResource;
+          TransportPtr mTransport;
+          LayerList mLayers;
+        };
+
+        typedef std::map<PUID, ConsumerPtr> ConsumerMap;
+
+        typedef std::list<ConsumerPtr> ConsumerList;
+
+      public:
+        SharedVideoEncoder(
+                           const make_private &,
+                           const String &key,
+                           int redPayloadType,
+                           int ulpfecPayloadType,
+                           Milliseconds minKeyFrameInterval,
+                           DWORD frameTimestampStep
+                           );
+        ~SharedVideoEncoder();
+
+        static SharedVideoEncoderPtr create(
+                                            const String &key,
+                                            int redPayloadType,
+                                            int ulpfecPayloadType,
+                                            Milliseconds minKeyFrameInterval,
+                                            ULONG clockRate,
+                                            int maxFramerate
+                                            );
+
+        // one frame interval in RTP timestamp units of the codec clock
+        static DWORD frameTimestampStep(
+                                        ULONG clockRate,
+                                        int maxFramerate
+                                        );
+
+        // rewrites a producer packet's numbering into the layer's own; after
+        // a resync the layer continues one packet / frame after its last
+        static void rewrite(
+                            Layer &ioLayer,
+                            WORD sequenceNumber,
+                            DWORD timestamp,
+                            DWORD frameTimestampStep,
+                            WORD &outSequenceNumber,
+                            DWORD &outTimestamp
+                            );
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::SharedVideoEncoder => (for VideoSenderChannelResource)
+        #pragma mark
+
+        // returns true if the resource must run the encoder itself
+        bool attach(
+                    VideoSenderChannelResourcePtr resource,
+                    TransportPtr transport,
+                    const SSRCList &ssrcs
+                    );
+
+        // returns the consumer promoted to producer (if the producer left)
+        VideoSenderChannelResourcePtr detach(PUID resourceID);
+
+        void requestKeyFrame(
+                             PUID consumerID,
+                             uint32_t mediaSSRC,
+                             uint32_t senderSSRC
+                             );
+        void requestKeyFrames(PUID consumerID);
+
+        bool getConsumerLayers(
+                               PUID consumerID,
+                               LayerList &outLayers
+                               ) const;
+
+        bool hasActiveConsumer() const;
+        void notifyConsumerStateChanged();
+
+        ElementPtr toDebug() const;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::SharedVideoEncoder => webrtc::Transport
+        #pragma mark
+
+        virtual bool SendRtp(
+                             const uint8_t* packet,
+                             size_t length,
+                             const webrtc::PacketOptions& options
+                             ) override;
+
+        virtual bool SendRtcp(const uint8_t* packet, size_t length) override;
+
+      protected:
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::SharedVideoEncoder => (internal)
+        #pragma mark
+
+        bool isFECPacket(const uint8_t *packet, size_t length) const;
+
+      protected:
+        mutable Lock mLock;
+
+        String mKey;
+        int mREDPayloadType {-1};
+        int mULPFECPayloadType {-1};
+        Milliseconds mMinKeyFrameInterval {};
+        DWORD mFrameTimestampStep {};
+
+        PUID mProducerID {};
+        VideoSenderChannelResourceWeakPtr mProducer;
+        TransportPtr mProducerTransport;
+        SSRCList mProducerSSRCs;
+        std::vector<Time> mLastKeyFrameRequests;
+
+        ConsumerMap mConsumers;
+
+        Lock mSendLock;               // serializes the fan out (guards mScratch)
+        SecureByteBlock mScratch;
+
+        size_t mPacketsFannedOut {};
+        size_t mKeyFrameRequests {};
+        size_t mKeyFrameRequestsForwarded {};
+      };
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -2015,7 +2323,11 @@ namespace ortc
       ChannelResourceWeakMap mChannelResources;
       ChannelResourceList mPendingSetupChannelResources;
       ChannelResourceList mPendingCloseChannelResources;
+      size_t mPendingCancelledChannelResources {};  // shutdowns posted by stepCancel
+
+      SharedVideoEncoderWeakMap mSharedVideoEncoders;
 
+      RecursiveLock mVoiceEngineLock;   // channel resources set up / tear down in parallel
       rtc::scoped_refptr<webrtc::AudioState> mAudioState;
       rtc::scoped_refptr<webrtc::AudioDecoderFactory> mAudioDecoderFactory;
       std::unique_ptr<webrtc::VoiceEngine, VoiceEngineDeleter> mVoiceEngine;
@@ -2060,6 +2372,8 @@ ZS_DECLARE_PROXY_METHOD_1(onSecureTransportState, States)
 ZS_DECLARE_PROXY_METHOD_1(onUpdate, ParametersPtr)
 ZS_DECLARE_PROXY_METHOD_2(onProvideStats, PromiseWithStatsReportPtr, StatsTypeSet)
 ZS_DECLARE_PROXY_METHOD_0(onSendDTMFTone)
+ZS_DECLARE_PROXY_METHOD_0(onStepSetup)
+ZS_DECLARE_PROXY_METHOD_0(onStepShutdown)
 ZS_DECLARE_PROXY_END()
 
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPMediaEngineAsyncDelegate)
@@ -2074,7 +2388,7 @@ ZS_DECLARE_PROXY_END()
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::services::SecureByteBlockPtr, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate::VideoFramePtr, VideoFramePtr)
-ZS_DECLARE_PROXY_METHOD_2(onHandleRTPPacket, DWORD, SecureByteBlockPtr)
+ZS_DECLARE_PROXY_METHOD_4(onHandleRTPPacket, DWORD, SecureByteBlockPtr, QWORD, QWORD)
 ZS_DECLARE_PROXY_METHOD_1(onHandleRTCPPacket, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_METHOD_1(onSendVideoFrame, VideoFramePtr)
 ZS_DECLARE_PROXY_END()
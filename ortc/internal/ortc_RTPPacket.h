@@ -57,6 +57,10 @@ namespace ortc
       struct VideoOrientationHeaderExtension;
       struct VideoOrientation6HeaderExtension;
 
+      // enough room in front of a packet to prepend one-byte MID and RID
+      // header extensions (including the extension profile header)
+      static const size_t kDefaultHeaderExtensionHeadroom {40};
+
     public:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -335,12 +339,19 @@ namespace ortc
       static RTPPacketPtr create(const RTPPacket &packet);
       static RTPPacketPtr create(const CreationParams &params);
       static RTPPacketPtr create(const BYTE *buffer, size_t bufferLengthInBytes);
+      static RTPPacketPtr create(
+                                 const BYTE *buffer,
+                                 size_t bufferLengthInBytes,
+                                 size_t headroomInBytes
+                                 );
       static RTPPacketPtr create(const SecureByteBlock &buffer);
       static RTPPacketPtr create(SecureByteBlockPtr buffer);  // NOTE: ownership of buffer is taken
 
       const BYTE *ptr() const;
       size_t size() const;
-      SecureByteBlockPtr buffer() const;
+      SecureByteBlockPtr buffer() const;  // NOTE: copies the packet when headroom is reserved (prefer ptr() / size())
+      size_t headroom() const {return mHeadroom;}
+      QWORD ingressTime() const {return mIngressTime;}
 
       BYTE version() const {return mVersion;}
       size_t padding() const {return mPadding;}
@@ -370,6 +381,12 @@ namespace ortc
 
       void changeHeaderExtensions(HeaderExtension *firstExtension);
 
+      // inserts the extension as the first element of the extension block
+      // by moving the fixed header into the reserved headroom (an element
+      // with the same ID and size is overwritten in place); the packet is
+      // only reallocated when the headroom is insufficient
+      void setHeaderExtension(const HeaderExtension &extension);
+
       ElementPtr toDebug() const;
 
     protected:
@@ -384,6 +401,8 @@ namespace ortc
 
       bool parse();
 
+      void reserveHeadroom(size_t headroomInBytes);
+
       void writeHeaderExtensions(
                                  HeaderExtension *firstExtension,
                                  bool twoByteHeader
@@ -393,6 +412,8 @@ namespace ortc
 
     public:
       SecureByteBlockPtr mBuffer;
+      size_t mHeadroom {};            // unused bytes at the front of mBuffer
+      QWORD mIngressTime {};          // monotonic microseconds of the socket read (0 if unknown); see PacketPipelineLatency
 
       BYTE mVersion {};
       size_t mPadding {};
@@ -34,6 +34,7 @@
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_StatsReport.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IRTPReceiver.h>
@@ -61,6 +62,8 @@ namespace ortc
   {
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPListener)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForMediaStreamTrack)
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPRelay)
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForActiveSpeakerDetector)
 
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverChannelForRTPReceiver)
 
@@ -68,6 +71,8 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPReceiver)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPReceiverChannel)
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPReceiver)
+    ZS_DECLARE_INTERACTION_PTR(IRTPRelayForRTPReceiver)
+    ZS_DECLARE_INTERACTION_PTR(IActiveSpeakerDetectorForRTPReceiver)
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPReceiverAsyncDelegate)
 
@@ -134,6 +139,53 @@ namespace ortc
       virtual PUID getID() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPRelay
+    #pragma mark
+
+    interaction IRTPReceiverForRTPRelay
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPRelay, ForRTPRelay)
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPReceiver, UseRelay)
+
+      static ElementPtr toDebug(ForRTPRelayPtr object);
+
+      virtual PUID getID() const = 0;
+
+      virtual void registerRelay(UseRelayPtr relay) = 0;
+      virtual void unregisterRelay(PUID relayID) = 0;
+
+      virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForActiveSpeakerDetector
+    #pragma mark
+
+    interaction IRTPReceiverForActiveSpeakerDetector
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForActiveSpeakerDetector, ForActiveSpeakerDetector)
+
+      ZS_DECLARE_TYPEDEF_PTR(IActiveSpeakerDetectorForRTPReceiver, UseActiveSpeakerDetector)
+
+      static ElementPtr toDebug(ForActiveSpeakerDetectorPtr object);
+
+      virtual PUID getID() const = 0;
+
+      // returns false if the receiver is not an audio receiver (or is shutdown)
+      virtual bool registerActiveSpeakerDetector(UseActiveSpeakerDetectorPtr detector) = 0;
+      virtual void unregisterActiveSpeakerDetector(PUID detectorID) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -162,6 +214,9 @@ namespace ortc
                         public IRTPReceiverForRTPListener,
                         public IRTPReceiverForRTPReceiverChannel,
                         public IRTPReceiverForMediaStreamTrack,
+                        public IRTPReceiverForRTPRelay,
+                        public IRTPReceiverForActiveSpeakerDetector,
+                        public IStatsProviderForStatsSubscription,
                         public ISecureTransportDelegate,
                         public IWakeDelegate,
                         public zsLib::ITimerDelegate,
@@ -176,11 +231,15 @@ namespace ortc
       friend interaction IRTPReceiverForRTPListener;
       friend interaction IRTPReceiverForRTPReceiverChannel;
       friend interaction IRTPReceiverForMediaStreamTrack;
+      friend interaction IRTPReceiverForRTPRelay;
+      friend interaction IRTPReceiverForActiveSpeakerDetector;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPReceiver, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPReceiver, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelForRTPReceiver, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPReceiver, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPReceiver, UseRelay);
+      ZS_DECLARE_TYPEDEF_PTR(IActiveSpeakerDetectorForRTPReceiver, UseActiveSpeakerDetector);
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
       ZS_DECLARE_STRUCT_PTR(RegisteredHeaderExtension);
@@ -223,6 +282,16 @@ namespace ortc
       typedef std::map<ChannelID, ChannelHolderWeakPtr> ChannelWeakMap;
       ZS_DECLARE_PTR(ChannelWeakMap)
 
+      typedef std::map<PUID, UseRelayWeakPtr> RelayWeakMap;
+      ZS_DECLARE_PTR(RelayWeakMap)
+
+      typedef std::pair<String, RTPPacketPtr> EncodingIDRTPPacketPair;
+      typedef std::list<EncodingIDRTPPacketPair> RelayRTPPacketList;
+      ZS_DECLARE_PTR(RelayRTPPacketList)
+
+      typedef std::map<PUID, UseActiveSpeakerDetectorWeakPtr> ActiveSpeakerDetectorWeakMap;
+      ZS_DECLARE_PTR(ActiveSpeakerDetectorWeakMap)
+
       typedef DWORD RoutingPayloadType;
 
       typedef std::pair<SSRCType, RoutingPayloadType> SSRCRoutingPair;
@@ -403,6 +472,8 @@ namespace ortc
       static RTPReceiverPtr convert(ForRTPListenerPtr object);
       static RTPReceiverPtr convert(ForRTPReceiverChannelPtr object);
       static RTPReceiverPtr convert(ForMediaStreamTrackPtr object);
+      static RTPReceiverPtr convert(ForRTPRelayPtr object);
+      static RTPReceiverPtr convert(ForActiveSpeakerDetectorPtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -412,6 +483,16 @@ namespace ortc
 
       virtual PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats = StatsTypeSet()) const override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver => IStatsProviderForStatsSubscription
+      #pragma mark
+
+      virtual bool sampleStats(
+                               const StatsTypeSet &stats,
+                               StatsList &outStats
+                               ) const override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => IRTPReceiver
@@ -487,6 +568,32 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver => IRTPReceiverForRTPRelay
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPRelayPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual void registerRelay(UseRelayPtr relay) override;
+      virtual void unregisterRelay(PUID relayID) override;
+
+      // (duplicate) virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver => IRTPReceiverForActiveSpeakerDetector
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForActiveSpeakerDetectorPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual bool registerActiveSpeakerDetector(UseActiveSpeakerDetectorPtr detector) override;
+      virtual void unregisterActiveSpeakerDetector(PUID detectorID) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => ISecureTransportDelegate
@@ -656,6 +763,11 @@ namespace ortc
       void processSenderReports(const RTCPPacket &rtcpPacket);
 
       void extractCSRCs(const RTPPacket &rtpPacket);
+      bool extractAudioLevel(
+                             const RTPPacket &rtpPacket,
+                             BYTE &outLevel,
+                             Optional<bool> &outVoiceActivity
+                             ) const;
       void setContributingSource(
                                  SSRCType csrc,
                                  BYTE level,
@@ -667,6 +779,9 @@ namespace ortc
                                         ChannelHolderPtr &channelHolder
                                         );
 
+      String getRelayEncodingID(ChannelHolderPtr channelHolder) const;
+      void postRelayPackets(RelayRTPPacketListPtr packets);
+
       void resetActiveReceiverChannel();
 
       Optional<RoutingPayloadType> decodeREDRoutingPayloadType(
@@ -768,6 +883,9 @@ namespace ortc
 
       ChannelHolderPtr mCurrentChannel;
       Time mLastSwitchedCurrentChannel;
+
+      RelayWeakMapPtr mRelays;                     // COW pattern, always valid ptr
+      ActiveSpeakerDetectorWeakMapPtr mActiveSpeakerDetectors;  // COW pattern, always valid ptr
       Milliseconds mLockAfterSwitchTime {};
 
       Milliseconds mAmbiguousPayloadMappingMinDifference {};
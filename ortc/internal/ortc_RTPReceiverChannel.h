@@ -33,6 +33,7 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_StatsReport.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IDTLSTransport.h>
@@ -107,6 +108,9 @@ namespace ortc
       virtual bool handlePacket(RTCPPacketPtr packet) = 0;
 
       virtual void requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats) = 0;
+
+      // snapshot of the channel's own counters only (never blocks)
+      virtual IStatsReportTypes::InboundRTPStreamStatsPtr sampleStats() const = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -130,6 +134,7 @@ namespace ortc
       virtual int32_t getAudioSamples(
                                       const size_t numberOfSamples,
                                       const uint8_t numberOfChannels,
+                                      const uint32_t samplesPerSecond,
                                       void* audioSamples,
                                       size_t& numberOfSamplesOut
                                       ) = 0;
@@ -151,7 +156,10 @@ namespace ortc
 
       virtual void onSecureTransportState(ISecureTransport::States state) = 0;
 
-      virtual void onNotifyPacket(RTPPacketPtr packet) = 0;
+      virtual void onNotifyPacket(
+                                  RTPPacketPtr packet,
+                                  QWORD queuedAt
+                                  ) = 0;
 
       virtual void onNotifyPackets(RTCPPacketListPtr packets) = 0;
 
@@ -219,6 +227,7 @@ namespace ortc
                                public IRTPReceiverChannelForRTPReceiverChannelVideo,
                                public IWakeDelegate,
                                public zsLib::ITimerDelegate,
+                               public zsLib::IPromiseSettledDelegate,
                                public IRTPReceiverChannelAsyncDelegate
     {
     protected:
@@ -239,11 +248,20 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelMediaBaseForRTPReceiverChannel, UseMediaBase)
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelAudioForRTPReceiverChannel, UseAudio)
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelVideoForRTPReceiverChannel, UseVideo)
+      ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport)
 
       ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::Parameters, Parameters)
       typedef std::list<RTCPPacketPtr> RTCPPacketList;
       ZS_DECLARE_PTR(RTCPPacketList)
 
+      struct PendingStats
+      {
+        PromiseWithStatsReportPtr mResolvePromise;
+        PromiseWithStatsReportPtr mMediaPromise;
+        UseStatsReport::StatMap mCountersStats;
+      };
+      typedef std::map<PUID, PendingStats> PendingStatsMap;
+
       enum States
       {
         State_Pending,
@@ -311,6 +329,8 @@ namespace ortc
 
       virtual void requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats) override;
 
+      virtual IStatsReportTypes::InboundRTPStreamStatsPtr sampleStats() const override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiverChannel => IRTPReceiverChannelForMediaStreamTrack
@@ -323,6 +343,7 @@ namespace ortc
       virtual int32_t getAudioSamples(
                                       const size_t numberOfSamples,
                                       const uint8_t numberOfChannels,
+                                      const uint32_t samplesPerSecond,
                                       void *audioSamples,
                                       size_t& numberOfSamplesOut
                                       ) override;
@@ -360,6 +381,13 @@ namespace ortc
 
       virtual void onTimer(ITimerPtr timer) override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiverChannel => IPromiseSettledDelegate
+      #pragma mark
+
+      virtual void onPromiseSettled(PromisePtr promise) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiverChannel => IRTPReceiverChannelAsyncDelegate
@@ -367,7 +395,10 @@ namespace ortc
 
       virtual void onSecureTransportState(ISecureTransport::States state) override;
 
-      virtual void onNotifyPacket(RTPPacketPtr packet) override;
+      virtual void onNotifyPacket(
+                                  RTPPacketPtr packet,
+                                  QWORD queuedAt
+                                  ) override;
 
       virtual void onNotifyPackets(RTCPPacketListPtr packets) override;
 
@@ -393,6 +424,12 @@ namespace ortc
       void setState(States state);
       void setError(WORD error, const char *reason = NULL);
 
+      IStatsReportTypes::InboundRTPStreamStatsPtr createInboundRTPStreamStats();
+      static UseStatsReport::StatMap mergeStats(
+                                                IStatsReportPtr mediaReport,
+                                                const UseStatsReport::StatMap &countersStats
+                                                );
+
 
     protected:
       //-----------------------------------------------------------------------
@@ -419,6 +456,11 @@ namespace ortc
       Optional<IMediaStreamTrackTypes::Kinds> mKind;
       UseMediaStreamTrackPtr mTrack;
 
+      PendingStatsMap mPendingStats;
+
+      // NO lock is needed (updated by the packet paths):
+      RTPStreamCounters mCounters;
+
       // NO lockk is needed:
       UseMediaBasePtr mMediaBase; // valid
       UseAudioPtr mAudio; // either
@@ -458,7 +500,7 @@ ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPReceiverChannelAsyncDelegate::RTCPP
 ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::RTPPacketPtr, RTPPacketPtr)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPReceiverChannelAsyncDelegate::ParametersPtr, ParametersPtr)
 ZS_DECLARE_PROXY_METHOD_1(onSecureTransportState, States)
-ZS_DECLARE_PROXY_METHOD_1(onNotifyPacket, RTPPacketPtr)
+ZS_DECLARE_PROXY_METHOD_2(onNotifyPacket, RTPPacketPtr, QWORD)
 ZS_DECLARE_PROXY_METHOD_1(onNotifyPackets, RTCPPacketListPtr)
 ZS_DECLARE_PROXY_METHOD_1(onUpdate, ParametersPtr)
 ZS_DECLARE_PROXY_END()
@@ -48,9 +48,12 @@
 #include <webrtc/transport.h>
 
 #include <queue>
+#include <vector>
 
 //#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
 
+#define ORTC_SETTING_RTP_RECEIVER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS "ortc/rtp-receiver-channel-audio/external-audio-buffer-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -91,6 +94,7 @@ namespace ortc
       virtual int32_t getAudioSamples(
                                       const size_t numberOfSamples,
                                       const uint8_t numberOfChannels,
+                                      const uint32_t samplesPerSecond,
                                       void *audioSamples,
                                       size_t& numberOfSamplesOut
                                       ) = 0;
@@ -197,6 +201,7 @@ namespace ortc
       ZS_DECLARE_PTR(RTCPPacketList)
       typedef std::queue<RTPPacketPtr> RTPPacketQueue;
       typedef std::queue<RTCPPacketPtr> RTCPPacketQueue;
+      typedef std::vector<int16_t> SampleBuffer;
 
       enum States
       {
@@ -273,6 +278,7 @@ namespace ortc
       virtual int32_t getAudioSamples(
                                       const size_t numberOfSamples,
                                       const uint8_t numberOfChannels,
+                                      const uint32_t samplesPerSecond,
                                       void *audioSamples,
                                       size_t& numberOfSamplesOut
                                       ) override;
@@ -392,12 +398,15 @@ namespace ortc
       void step();
       bool stepChannelPromise();
       bool stepSetupChannel();
+      bool stepExternalAudio();
 
       void cancel();
 
       void setState(States state);
       void setError(WORD error, const char *reason = NULL);
 
+      void pumpExternalAudio(UseChannelResourcePtr channelResource);
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -430,6 +439,23 @@ namespace ortc
 
       RTPPacketQueue mQueuedRTP;
       RTCPPacketQueue mQueuedRTCP;
+
+      // timer (producer) -> application (consumer); the format is packed as
+      // (samples per second << 8) | number of channels
+      AudioRingBufferPtr mExternalAudio;
+      std::atomic<DWORD> mExternalAudioFormat {};
+      std::atomic<bool> mExternalAudioStarted {};
+      std::atomic<size_t> mExternalAudioUnderrunSamples {};
+      std::atomic<size_t> mExternalAudioDroppedSamples {};
+      ITimerPtr mExternalAudioTimer;
+
+      // only accessed by the application (consumer)
+      DWORD mExternalAudioConsumerFormat {};
+
+      // only accessed from the external audio timer
+      Time mExternalAudioNextFrame;
+      SampleBuffer mExternalAudioFrame;
+      SampleBuffer mExternalAudioRemixed;
     };
 
     //-------------------------------------------------------------------------
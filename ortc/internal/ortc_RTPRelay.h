@@ -0,0 +1,342 @@
+/*
+
+ Copyright (c) 2017, Hookflash Inc. / Hookflash Inc.
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+#pragma once
+
+#include <ortc/internal/types.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+
+#include <ortc/IRTPRelay.h>
+
+#define ORTC_SETTING_RTP_RELAY_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS "ortc/rtp-relay/min-key-frame-request-interval-in-milliseconds"
+
+namespace ortc
+{
+  namespace internal
+  {
+    ZS_DECLARE_INTERACTION_PTR(IRTPRelayForRTPReceiver)
+    ZS_DECLARE_INTERACTION_PTR(IRTPRelayForRTPSender)
+
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPRelay)
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPRelay)
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayForRTPReceiver
+    #pragma mark
+
+    interaction IRTPRelayForRTPReceiver
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPReceiver, ForRTPReceiver)
+
+      static ElementPtr toDebug(ForRTPReceiverPtr relay);
+
+      virtual PUID getID() const = 0;
+
+      // called outside the receiver's lock for every RTP packet that was
+      // mapped to one of the receiver's channels (including buffered
+      // packets delivered once their channel is known)
+      virtual void notifyReceivedPacket(
+                                        IRTPTypes::ParametersPtr receiverParams,
+                                        const String &encodingID,
+                                        RTPPacketPtr packet
+                                        ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayForRTPSender
+    #pragma mark
+
+    interaction IRTPRelayForRTPSender
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPSender, ForRTPSender)
+
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
+      static ElementPtr toDebug(ForRTPSenderPtr relay);
+
+      virtual PUID getID() const = 0;
+
+      virtual void notifySenderParameters(
+                                          PUID senderID,
+                                          IRTPTypes::ParametersPtr params
+                                          ) = 0;
+
+      // returns true if the feedback was forwarded to the relayed source
+      virtual bool notifySenderFeedback(
+                                        PUID senderID,
+                                        const FeedbackEventList &events
+                                        ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPRelay
+    #pragma mark
+    
+    class RTPRelay : public Noop,
+                     public SharedRecursiveLock,
+                     public IRTPRelay,
+                     public IRTPRelayForRTPReceiver,
+                     public IRTPRelayForRTPSender
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IRTPRelay;
+      friend interaction IRTPRelayFactory;
+      friend interaction IRTPRelayForRTPReceiver;
+      friend interaction IRTPRelayForRTPSender;
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPRelay, UseReceiver)
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPRelay, UseSender)
+
+      ZS_DECLARE_STRUCT_PTR(SenderInfo)
+
+      typedef IRTPTypes::Parameters Parameters;
+      ZS_DECLARE_PTR(Parameters)
+      typedef IRTPTypes::SSRCType SSRCType;
+      typedef IRTPTypes::PayloadType PayloadType;
+      typedef IRTPTypes::EncodingID EncodingID;
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
+      typedef std::map<PayloadType, PayloadType> PayloadTypeMap;
+      typedef std::map<BYTE, BYTE> HeaderExtensionIDMap;
+      typedef std::map<PUID, SenderInfoPtr> SenderInfoMap;
+      typedef std::map<EncodingID, SSRCType> EncodingSSRCMap;
+      typedef std::map<EncodingID, Time> EncodingTimeMap;
+
+      typedef std::pair<UseSenderPtr, RTPPacketPtr> SenderPacketPair;
+      typedef std::list<SenderPacketPair> SenderPacketList;
+      typedef std::list<RTCPPacketPtr> RTCPPacketList;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay::SenderInfo
+      #pragma mark
+
+      struct SenderInfo
+      {
+        UseSenderPtr mSender;
+        Options mOptions;
+
+        ParametersPtr mParameters;
+        ParametersPtr mMappedReceiverParameters;  // receiver parameters the maps below were computed against
+
+        Optional<SSRCType> mSSRC;
+        String mMuxID;
+        String mRID;
+        PayloadTypeMap mPayloadTypes;             // receiver payload type -> sender payload type
+        HeaderExtensionIDMap mHeaderExtensions;   // receiver extension id -> sender extension id
+        Optional<BYTE> mMuxIDHeaderExtensionID;
+        Optional<BYTE> mRIDHeaderExtensionID;
+
+        EncodingID mActiveEncodingID;             // encoding currently being forwarded (switches on key frames)
+
+        bool mStarted {false};
+        Optional<SSRCType> mSourceSSRC;
+        WORD mSequenceNumberOffset {};
+        DWORD mTimestampOffset {};
+        WORD mLastSequenceNumber {};
+        DWORD mLastTimestamp {};
+        Time mLastSent;
+
+        size_t mTotalForwarded {};
+        size_t mTotalDropped {};
+
+        ElementPtr toDebug() const;
+      };
+
+    public:
+      RTPRelay(
+               const make_private &,
+               UseReceiverPtr receiver
+               );
+
+    protected:
+      RTPRelay(Noop) :
+        Noop(true),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+    public:
+      virtual ~RTPRelay();
+
+      static RTPRelayPtr convert(IRTPRelayPtr object);
+      static RTPRelayPtr convert(ForRTPReceiverPtr object);
+      static RTPRelayPtr convert(ForRTPSenderPtr object);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay => IRTPRelay
+      #pragma mark
+
+      static ElementPtr toDebug(RTPRelayPtr relay);
+
+      static RTPRelayPtr create(IRTPReceiverPtr receiver);
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual IRTPReceiverPtr receiver() const override;
+
+      virtual void addSender(
+                             IRTPSenderPtr sender,
+                             const Options &options = Options()
+                             ) throw (
+                                      InvalidParameters,
+                                      InvalidStateError
+                                      ) override;
+
+      virtual void removeSender(IRTPSenderPtr sender) override;
+
+      virtual void stop() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay => IRTPRelayForRTPReceiver
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPReceiverPtr relay);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual void notifyReceivedPacket(
+                                        ParametersPtr receiverParams,
+                                        const String &encodingID,
+                                        RTPPacketPtr packet
+                                        ) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay => IRTPRelayForRTPSender
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPSenderPtr relay);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual void notifySenderParameters(
+                                          PUID senderID,
+                                          ParametersPtr params
+                                          ) override;
+
+      virtual bool notifySenderFeedback(
+                                        PUID senderID,
+                                        const FeedbackEventList &events
+                                        ) override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      void cancel();
+
+      void updateMappings(
+                          SenderInfo &info,
+                          ParametersPtr receiverParams
+                          );
+
+      EncodingID resolveEncodingID(
+                                   const Options &options,
+                                   const Parameters &receiverParams
+                                   ) const;
+
+      RTPPacketPtr rewrite(
+                           SenderInfo &info,
+                           const RTPPacket &packet,
+                           PayloadType senderPayloadType,
+                           Optional<PayloadType> senderRedPrimaryPayloadType,
+                           ULONG clockRate
+                           );
+
+      RTCPPacketPtr prepareKeyFrameRequest(const EncodingID &encodingID);
+      void sendKeyFrameRequests();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPRelay => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      RTPRelayWeakPtr mThisWeak;
+
+      UseReceiverPtr mReceiver;
+      bool mShutdown {false};
+
+      ParametersPtr mReceiverParameters;
+
+      SenderInfoMap mSenders;
+
+      EncodingSSRCMap mEncodingSSRCs;               // last media SSRC seen per receiver encoding
+      EncodingTimeMap mLastKeyFrameRequests;
+      Milliseconds mMinKeyFrameRequestInterval {};
+      RTCPPacketList mPendingKeyFrameRequests;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPRelayFactory
+    #pragma mark
+
+    interaction IRTPRelayFactory
+    {
+      static IRTPRelayFactory &singleton();
+
+      virtual RTPRelayPtr create(IRTPReceiverPtr receiver);
+    };
+
+    class RTPRelayFactory : public IFactory<IRTPRelayFactory> {};
+  }
+}
@@ -33,6 +33,8 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_StatsReport.h>
 
 #include <ortc/IRTPSender.h>
 #include <ortc/IDTLSTransport.h>
@@ -45,6 +47,11 @@
 
 //#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
 
+#define ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_PACKETS "ortc/rtp-sender/retransmission-history-max-packets"
+#define ORTC_SETTING_RTP_SENDER_RETRANSMISSION_HISTORY_MAX_BYTES "ortc/rtp-sender/retransmission-history-max-bytes"
+
+#define ORTC_SETTING_RTP_SENDER_RETRANSMISSION_MIN_INTERVAL_IN_MILLISECONDS "ortc/rtp-sender/retransmission-min-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -54,11 +61,13 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPSenderChannel);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForMediaStreamTrack);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderForDTMFSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPRelay);
 
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderChannelForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPRelayForRTPSender);
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPSenderAsyncDelegate)
 
@@ -91,6 +100,8 @@ namespace ortc
     {
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPListener, ForRTPListener)
 
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
       static ElementPtr toDebug(ForRTPListenerPtr transport);
 
       virtual PUID getID() const = 0;
@@ -99,6 +110,15 @@ namespace ortc
                                 IICETypes::Components viaTransport,
                                 RTCPPacketPtr packet
                                 ) = 0;
+
+      // feedback-only RTCP packet where every event targets an SSRC
+      // registered by this sender; the packet is parsed once by the listener
+      // and shared between all senders the feedback is routed to
+      virtual bool handleFeedback(
+                                  IICETypes::Components viaTransport,
+                                  RTCPPacketPtr packet,
+                                  const FeedbackEventList &events
+                                  ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -169,6 +189,33 @@ namespace ortc
       virtual PUID getID() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPRelay
+    #pragma mark
+
+    interaction IRTPSenderForRTPRelay
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPRelay, ForRTPRelay)
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPSender, UseRelay)
+
+      static ElementPtr toDebug(ForRTPRelayPtr object);
+
+      virtual PUID getID() const = 0;
+
+      // returns the current send parameters (null if send() was not called)
+      virtual IRTPTypes::ParametersPtr registerRelay(UseRelayPtr relay) = 0;
+      virtual void unregisterRelay(PUID relayID) = 0;
+
+      // sends the packet and keeps a copy in the retransmission history so
+      // generic NACKs for the relayed stream can be answered by the sender
+      virtual bool sendRelayedPacket(RTPPacketPtr packet) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -201,6 +248,8 @@ namespace ortc
                       public IRTPSenderForRTPSenderChannel,
                       public IRTPSenderForDTMFSender,
                       public IRTPSenderForMediaStreamTrack,
+                      public IRTPSenderForRTPRelay,
+                      public IStatsProviderForStatsSubscription,
                       public ISecureTransportDelegate,
                       public IWakeDelegate,
                       public IDTMFSenderDelegate,
@@ -217,26 +266,36 @@ namespace ortc
       friend interaction IRTPSenderForRTPSenderChannel;
       friend interaction IRTPSenderForDTMFSender;
       friend interaction IRTPSenderForMediaStreamTrack;
+      friend interaction IRTPSenderForRTPRelay;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPSender, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPSender, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelForRTPSender, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPSender, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPRelayForRTPSender, UseRelay);
 
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
       typedef std::list<RTCPPacketPtr> RTCPPacketList;
       ZS_DECLARE_PTR(RTCPPacketList)
 
+      typedef std::list<RTPPacketPtr> RTPPacketList;
+
       ZS_DECLARE_STRUCT_PTR(ChannelHolder)
+      ZS_DECLARE_STRUCT_PTR(RetransmissionHistory)
 
       typedef std::map<ParametersPtr, ChannelHolderPtr> ParametersToChannelHolderMap;
       ZS_DECLARE_PTR(ParametersToChannelHolderMap)
 
+      typedef std::map<PUID, UseRelayWeakPtr> RelayWeakMap;
+      ZS_DECLARE_PTR(RelayWeakMap)
+
       ZS_DECLARE_TYPEDEF_PTR(std::list<ParametersPtr>, ParametersPtrList)
 
       typedef std::list<IRTPTypes::SSRCType> SSRCList;
 
+      typedef std::map<IRTPTypes::SSRCType, RetransmissionHistoryPtr> RetransmissionHistoryMap;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender::ChannelHolder
@@ -261,6 +320,7 @@ namespace ortc
         bool handle(RTCPPacketPtr packet);
 
         void requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats);
+        IStatsReportTypes::OutboundRTPStreamStatsPtr sampleStats() const;
 
         void insertDTMF(
                         const char *tones,
@@ -275,6 +335,61 @@ namespace ortc
         ElementPtr toDebug() const;
       };
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender::RetransmissionHistory
+      #pragma mark
+
+      // ring of recently relayed packets for one SSRC, indexed by sequence
+      // number modulo the ring size
+      struct RetransmissionHistory
+      {
+        struct Entry
+        {
+          RTPPacketPtr mPacket;
+          Time mLastRetransmitted;
+        };
+
+        typedef std::vector<Entry> EntryList;
+
+        IRTPTypes::SSRCType mSSRC {};
+
+        EntryList mEntries;
+        size_t mTotalBytes {};
+        size_t mMaxBytes {};
+
+        bool mHasPackets {false};
+        WORD mOldestSequenceNumber {};
+        WORD mNewestSequenceNumber {};
+
+        WORD mRTXSequenceNumber {};
+
+        unsigned long mPacketsSent {};
+        unsigned long long mBytesSent {};
+        unsigned long mNACKCount {};
+        unsigned long mPacketsRequested {};
+        unsigned long mPacketsMissing {};
+        unsigned long mRetransmittedPacketsSent {};
+        unsigned long long mRetransmittedBytesSent {};
+
+        RetransmissionHistory(
+                              IRTPTypes::SSRCType ssrc,
+                              size_t maxPackets,
+                              size_t maxBytes
+                              );
+
+        void store(RTPPacketPtr packet);
+        Entry *find(WORD sequenceNumber);
+
+        double retransmissionRate() const;
+
+        ElementPtr toDebug() const;
+
+      protected:
+        void evictOldest();
+        void clear();
+      };
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender::States
@@ -326,6 +441,16 @@ namespace ortc
 
       virtual PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats = StatsTypeSet()) const override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => IStatsProviderForStatsSubscription
+      #pragma mark
+
+      virtual bool sampleStats(
+                               const StatsTypeSet &stats,
+                               StatsList &outStats
+                               ) const override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSender
@@ -374,6 +499,12 @@ namespace ortc
                                 RTCPPacketPtr packet
                                 ) override;
 
+      virtual bool handleFeedback(
+                                  IICETypes::Components viaTransport,
+                                  RTCPPacketPtr packet,
+                                  const FeedbackEventList &events
+                                  ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSenderForRTPSenderChannel
@@ -403,6 +534,20 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => IRTPSenderForRTPRelay
+      #pragma mark
+
+      // (duplciate) static ElementPtr toDebug(ForRTPRelayPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual ParametersPtr registerRelay(UseRelayPtr relay) override;
+      virtual void unregisterRelay(PUID relayID) override;
+
+      virtual bool sendRelayedPacket(RTPPacketPtr packet) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSenderForDTMFSender
@@ -503,6 +648,14 @@ namespace ortc
 
       ChannelHolderPtr getDTMFChannelHolder() const;
 
+      void appendRetransmissionHistoryStats(StatsList &outStats) const;
+
+      bool handleRetransmissionRequests(const FeedbackEventList &events);
+      RTPPacketPtr createRetransmission(
+                                        RetransmissionHistory &history,
+                                        RTPPacketPtr packet
+                                        );
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -544,6 +697,13 @@ namespace ortc
 
       ParametersToChannelHolderMapPtr mChannels;  // using COW pattern
 
+      RelayWeakMapPtr mRelays;                    // using COW pattern
+
+      size_t mRetransmissionHistoryMaxPackets {};
+      size_t mRetransmissionHistoryMaxBytes {};
+      Milliseconds mRetransmissionMinInterval {};
+      RetransmissionHistoryMap mRetransmissionHistories;
+
       SSRCList mConflicts;
     };
 
@@ -34,6 +34,7 @@
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_StatsReport.h>
 
 #include <ortc/IDTLSTransport.h>
 #include <ortc/IICETransport.h>
@@ -108,6 +109,9 @@ namespace ortc
 
       virtual void requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats) = 0;
 
+      // snapshot of the channel's own counters only (never blocks)
+      virtual IStatsReportTypes::OutboundRTPStreamStatsPtr sampleStats() const = 0;
+
       virtual void insertDTMF(
                               const char *tones,
                               Milliseconds duration,
@@ -186,7 +190,8 @@ namespace ortc
       virtual int32_t sendAudioSamples(
                                        const void* audioSamples,
                                        const size_t numberOfSamples,
-                                       const uint8_t numberOfChannels
+                                       const uint8_t numberOfChannels,
+                                       const uint32_t samplesPerSecond
                                        ) = 0;
       
       virtual void sendVideoFrame(VideoFramePtr videoFrame) = 0;
@@ -255,6 +260,7 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelMediaBaseForRTPSenderChannel, UseMediaBase);
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelAudioForRTPSenderChannel, UseAudio);
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelVideoForRTPSenderChannel, UseVideo);
+      ZS_DECLARE_TYPEDEF_PTR(IStatsReportForInternal, UseStatsReport);
 
       ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::Parameters, Parameters)
       typedef std::list<RTCPPacketPtr> RTCPPacketList;
@@ -343,6 +349,8 @@ namespace ortc
 
       virtual void requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats) override;
 
+      virtual IStatsReportTypes::OutboundRTPStreamStatsPtr sampleStats() const override;
+
       virtual void insertDTMF(
                               const char *tones,
                               Milliseconds duration,
@@ -388,7 +396,8 @@ namespace ortc
       virtual int32_t sendAudioSamples(
                                        const void* audioSamples,
                                        const size_t numberOfSamples,
-                                       const uint8_t numberOfChannels
+                                       const uint8_t numberOfChannels,
+                                       const uint32_t samplesPerSecond
                                        ) override;
 
       virtual void sendVideoFrame(VideoFramePtr videoFrame) override;
@@ -442,6 +451,8 @@ namespace ortc
 
       void setupTagging();
 
+      IStatsReportTypes::OutboundRTPStreamStatsPtr createOutboundRTPStreamStats();
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -478,6 +489,9 @@ namespace ortc
       Optional<IMediaStreamTrackTypes::Kinds> mKind;
       UseMediaStreamTrackPtr mTrack;
 
+      // NO lock is needed (updated by the packet paths):
+      RTPStreamCounters mCounters;
+
       // NO lockk is needed:
       UseMediaBasePtr mMediaBase; // valid
       UseAudioPtr mAudio; // either
@@ -44,9 +44,14 @@
 #include <zsLib/Event.h>
 
 #include <webrtc/transport.h>
+#include <webrtc/common_audio/resampler/include/push_resampler.h>
+
+#include <vector>
 
 //#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
 
+#define ORTC_SETTING_RTP_SENDER_CHANNEL_AUDIO_EXTERNAL_AUDIO_BUFFER_IN_MILLISECONDS "ortc/rtp-sender-channel-audio/external-audio-buffer-in-milliseconds"
+
 #define ORTC_SENDER_CHANNEL_PENDING_TONE_LOCK_OUT_MAGIC_STRING "PENDING"
 
 namespace ortc
@@ -92,7 +97,8 @@ namespace ortc
       virtual int32_t sendAudioSamples(
                                        const void* audioSamples,
                                        const size_t numberOfSamples,
-                                       const uint8_t numberOfChannels
+                                       const uint8_t numberOfChannels,
+                                       const uint32_t samplesPerSecond
                                        ) = 0;
     };
 
@@ -221,6 +227,8 @@ namespace ortc
 
       typedef std::list<ToneInfoPtr> ToneInfoList;
 
+      typedef std::vector<int16_t> SampleBuffer;
+
     public:
       RTPSenderChannelAudio(
                             const make_private &,
@@ -290,7 +298,8 @@ namespace ortc
       virtual int32_t sendAudioSamples(
                                        const void* audioSamples,
                                        const size_t numberOfSamples,
-                                       const uint8_t numberOfChannels
+                                       const uint8_t numberOfChannels,
+                                       const uint32_t samplesPerSecond
                                        ) override;
       
       //-----------------------------------------------------------------------
@@ -421,12 +430,19 @@ namespace ortc
 
       void step();
       bool stepSetupChannel();
+      bool stepExternalAudio();
 
       void cancel();
 
       void setState(States state);
       void setError(WORD error, const char *reason = NULL);
 
+      uint32_t getSendSamplesPerSecond() const;
+      void pumpExternalAudio(
+                             UseChannelResourcePtr channelResource,
+                             uint32_t sendSamplesPerSecond
+                             );
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -458,6 +474,20 @@ namespace ortc
       std::atomic<ISecureTransport::States> mTransportState { ISecureTransport::State_Pending };
 
       ToneInfoList mPendingTones;
+
+      // application (producer) -> timer (consumer); the format is packed as
+      // (samples per second << 8) | number of channels
+      AudioRingBufferPtr mExternalAudio;
+      std::atomic<DWORD> mExternalAudioFormat {};
+      std::atomic<bool> mExternalAudioStarted {};
+      std::atomic<size_t> mExternalAudioDroppedSamples {};
+      ITimerPtr mExternalAudioTimer;
+
+      // only accessed from the external audio timer
+      DWORD mExternalAudioConsumerFormat {};
+      SampleBuffer mExternalAudioFrame;
+      SampleBuffer mExternalAudioResampled;
+      webrtc::PushResampler<int16_t> mExternalAudioResampler;
     };
 
     //-------------------------------------------------------------------------
@@ -85,6 +85,7 @@ namespace ortc
                               public ISecureTransportForICETransport,
                               public ISecureTransportForSRTPTransport,
                               public ISecureTransportForRTPListener,
+                              public ISecureTransportForRTPCapture,
                               public ISRTPSDESTransportAsyncDelegate,
                               public ISRTPTransportDelegate,
                               public IICETransportDelegate
@@ -100,6 +101,7 @@ namespace ortc
       friend interaction ISecureTransportForICETransport;
       friend interaction ISecureTransportForSRTPTransport;
       friend interaction ISecureTransportForRTPListener;
+      friend interaction ISecureTransportForRTPCapture;
 
       ZS_DECLARE_TYPEDEF_PTR(IICETransportForSecureTransport, UseICETransport)
       ZS_DECLARE_TYPEDEF_PTR(ISRTPTransportForSecureTransport, UseSRTPTransport)
@@ -134,6 +136,7 @@ namespace ortc
       static SRTPSDESTransportPtr convert(ForICETransportPtr object);
       static SRTPSDESTransportPtr convert(ForSRTPPtr object);
       static SRTPSDESTransportPtr convert(ForRTPListenerPtr object);
+      static SRTPSDESTransportPtr convert(ForRTPCapturePtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -278,6 +281,17 @@ namespace ortc
 
       virtual RTPListenerPtr getListener() const override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SRTPSDESTransport => ISecureTransportForRTPCapture
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPCapturePtr transport);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual RTPCaptureRingPtr getCaptureRing() const override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark SRTPSDESTransport => ISRTPSDESTransportForSettings
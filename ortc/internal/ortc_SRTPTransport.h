@@ -45,6 +45,13 @@ struct srtp_policy_t;
 
 //#define ORTC_SETTING_SRTP_TRANSPORT_WARN_OF_KEY_LIFETIME_EXHAUGSTION_WHEN_REACH_PERCENTAGE_USSED "ortc/srtp/warm-key-lifetime-exhaustion-when-reach-percentage-used"
 
+#define ORTC_SETTING_SRTP_TRANSPORT_RTCP_AGGREGATION_WINDOW_IN_MILLISECONDS "ortc/srtp/rtcp-aggregation-window-in-milliseconds"
+#define ORTC_SETTING_SRTP_TRANSPORT_MAX_RTCP_COMPOUND_PACKET_SIZE "ortc/srtp/max-rtcp-compound-packet-size"
+
+#define ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_BUFFER_SIZE_IN_BYTES "ortc/srtp/capture-buffer-size-in-bytes"
+#define ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_SNAP_LENGTH_IN_BYTES "ortc/srtp/capture-snap-length-in-bytes"
+#define ORTC_SETTING_SRTP_TRANSPORT_CAPTURE_RTP_PAYLOAD_BYTES "ortc/srtp/capture-rtp-payload-bytes"
+
 #pragma warning(push)
 #pragma warning(disable:4351)
 
@@ -119,6 +126,8 @@ namespace ortc
                               const BYTE *buffer,
                               size_t bufferLengthInBytes
                               ) = 0;
+
+      virtual RTPCaptureRingPtr getCaptureRing() const = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -163,6 +172,11 @@ namespace ortc
       typedef std::map<MKIValuePtr, KeyingMaterialPtr, MKIValueCompare> KeyMap;
       typedef std::list<KeyingMaterialPtr> KeyList;
 
+      ZS_DECLARE_STRUCT_PTR(PendingRTCP)
+      ZS_DECLARE_STRUCT_PTR(FlushedRTCP)
+
+      typedef std::list<FlushedRTCP> FlushedRTCPList;
+
       enum Directions
       {
         Direction_First,
@@ -237,6 +251,8 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) override;
 
+      virtual RTPCaptureRingPtr getCaptureRing() const override {return mCaptureRing;}
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark SRTPTransport => IWakeDelegate
@@ -283,6 +299,25 @@ namespace ortc
                                                                        size_t maxByteLength
                                                                        ) throw(InvalidParameters);
 
+      bool protectAndSendPacket(
+                                IICETypes::Components sendOverICETransport,
+                                IICETypes::Components packetType,
+                                const BYTE *buffer,
+                                size_t bufferLengthInBytes
+                                );
+
+      bool queueRTCP(
+                     IICETypes::Components sendOverICETransport,
+                     const BYTE *buffer,
+                     size_t bufferLengthInBytes,
+                     FlushedRTCPList &outFlushed
+                     );
+      void flushRTCP(
+                     IICETypes::Components sendOverICETransport,
+                     FlushedRTCPList &outFlushed
+                     );
+      bool sendFlushedRTCP(const FlushedRTCPList &flushed);
+
     public:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -339,6 +374,34 @@ namespace ortc
         String hash() const;
       };
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SRTPTransport::PendingRTCP
+      #pragma mark
+
+      // RTCP packets waiting to be merged into a single compound packet
+      // (and thus a single SRTCP protect / send)
+      struct PendingRTCP
+      {
+        SecureByteBlockPtr mBuffer;   // allocated to max compound size
+        size_t mSize {};
+        size_t mTotalPackets {};
+
+        ElementPtr toDebug() const;
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SRTPTransport::FlushedRTCP
+      #pragma mark
+
+      struct FlushedRTCP
+      {
+        IICETypes::Components mSendOver {IICETypes::Component_RTCP};
+        SecureByteBlockPtr mBuffer;
+        size_t mSize {};
+      };
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -360,7 +423,15 @@ namespace ortc
 
       DirectionMaterial mMaterial[Direction_Last+1];
 
+      const Milliseconds mRTCPAggregationWindow {};
+      size_t mMaxRTCPCompoundPacketSize {};
+
+      PendingRTCP mPendingRTCP[IICETypes::Component_Last+1];  // indexed by send over component
+      ITimerPtr mRTCPAggregationTimer;
+
       SRTPInitPtr mSRTPInit;
+
+      RTPCaptureRingPtr mCaptureRing;     // null unless capturing is enabled
     };
 
     //-------------------------------------------------------------------------
@@ -39,13 +39,19 @@
 #include <zsLib/MessageQueueAssociator.h>
 #include <zsLib/ITimer.h>
 
+#include <atomic>
+
 //#define ORTC_SETTING_SRTP_TRANSPORT_WARN_OF_KEY_LIFETIME_EXHAUGSTION_WHEN_REACH_PERCENTAGE_USSED "ortc/srtp/warm-key-lifetime-exhaustion-when-reach-percentage-used"
 
+#define ORTC_SETTING_STATS_SUBSCRIPTION_DEFAULT_SAMPLING_INTERVAL_IN_MILLISECONDS "ortc/stats/subscription-default-sampling-interval-in-milliseconds"
+#define ORTC_SETTING_STATS_SUBSCRIPTION_MINIMUM_SAMPLING_INTERVAL_IN_MILLISECONDS "ortc/stats/subscription-minimum-sampling-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
   {
     ZS_DECLARE_INTERACTION_PTR(IStatsReportForInternal);
+    ZS_DECLARE_INTERACTION_PTR(IStatsProviderForStatsSubscription);
 
     
     //-------------------------------------------------------------------------
@@ -77,6 +83,32 @@ namespace ortc
 
       virtual ~IStatsReportForInternal() {}
     };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsProviderForStatsSubscription
+    #pragma mark
+
+    interaction IStatsProviderForStatsSubscription
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderForStatsSubscription, ForStatsSubscription);
+
+      typedef std::list<IStatsReportTypes::StatsPtr> StatsList;
+
+      // Synchronously snapshots the provider's directly maintained counters
+      // for the requested stats types (no promise is created and the media
+      // engine is never consulted). Returns false if the provider cannot be
+      // sampled this way, in which case getStats() is used instead.
+      virtual bool sampleStats(
+                               const IStatsReportTypes::StatsTypeSet &stats,
+                               StatsList &outStats
+                               ) const = 0;
+
+      virtual ~IStatsProviderForStatsSubscription() {}
+    };
     
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -220,5 +252,472 @@ namespace ortc
     };
 
     class StatsReportFactory : public IFactory<IStatsReportFactory> {};
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPStreamCounters
+    #pragma mark
+
+    // Per stream RTP counters maintained directly by the packet paths of a
+    // channel. Each notify method must only be called from the single path
+    // noted beside it; snapshot() only performs relaxed atomic loads and is
+    // safe (and wait-free) from any thread at any time. The published values
+    // are surrounded by cache line padding so neighbouring objects (or the
+    // writer-only state) never share a cache line with them.
+    class RTPStreamCounters
+    {
+    public:
+      typedef IRTPTypes::SSRCType SSRCType;
+      typedef IRTPTypes::PayloadType PayloadType;
+      typedef IRTPTypes::Parameters Parameters;
+
+      enum Constants
+      {
+        kMaxPayloadTypes = 128,
+        kMaxSSRCs = 4,
+        kSenderReportHistory = 8,
+      };
+
+      struct Snapshot
+      {
+        SSRCType mSSRC {};
+        PayloadType mPayloadType {};
+
+        QWORD mPackets {};
+        QWORD mBytes {};
+        QWORD mPacketsExpected {};
+        QWORD mPacketsReceivedOnSSRC {};
+        double mJitter {};                  // RTP timestamp units
+        DWORD mNACKCount {};
+        DWORD mPLICount {};
+        DWORD mFIRCount {};
+        double mRoundTripTime {};           // milliseconds
+        double mRemoteEstimatedBitrate {};  // bits per second (from REMB)
+        double mFractionLost {};            // over the last RTCP reporting interval
+        bool mHasReportingInterval {};      // false until the first receiver report is sent
+
+        unsigned long packetsLost() const;
+        double fractionLost() const;
+
+        void applyTo(IStatsReportTypes::InboundRTPStreamStats &stats) const;
+        void applyTo(IStatsReportTypes::OutboundRTPStreamStats &stats) const;
+
+        ElementPtr toDebug() const;
+      };
+
+    public:
+      RTPStreamCounters();
+
+      void updateParameters(const Parameters &params);     // any thread
+
+      void notifyReceived(const RTPPacket &packet);         // incoming RTP path
+      void notifyFeedbackSent(const RTCPPacket &packet);    // outgoing RTCP path
+
+      void notifySent(const RTPPacket &packet);             // outgoing RTP path
+      void notifySenderReportsSent(const RTCPPacket &packet); // outgoing RTCP path
+      void notifyIncomingRTCP(const RTCPPacket &packet);    // incoming RTCP path
+
+      void snapshot(Snapshot &outSnapshot) const;
+
+      // Returns true if "requested" includes "statsType" in which case
+      // "outRemaining" is filled with the explicit set of every other
+      // requested stats type (an empty result means nothing else is needed).
+      static bool excludeStatsType(
+                                   const IStatsReportTypes::StatsTypeSet &requested,
+                                   IStatsReportTypes::StatsTypes statsType,
+                                   IStatsReportTypes::StatsTypeSet &outRemaining
+                                   );
+
+    protected:
+      bool isSentSSRC(SSRCType ssrc) const;
+      bool isEncodingSSRC(SSRCType ssrc) const;
+      bool hasEncodingSSRCs() const;
+      bool isStreamSSRC(
+                        SSRCType ssrc,
+                        PayloadType payloadType
+                        ) const;
+      void startReceiving(const RTPPacket &packet);
+      void updateReportingInterval();
+      static DWORD nowInMilliseconds();
+
+    protected:
+      BYTE mPaddingBefore[ORTC_CACHE_LINE_SIZE] {};
+
+      // published by the packet paths; read by snapshot()
+      std::atomic<DWORD> mSSRC {};
+      std::atomic<DWORD> mPayloadType {};
+      std::atomic<QWORD> mPackets {};
+      std::atomic<QWORD> mBytes {};
+      std::atomic<QWORD> mPacketsExpected {};
+      std::atomic<QWORD> mPacketsReceivedOnSSRC {};
+      std::atomic<DWORD> mJitterInTimestampUnits {};
+      std::atomic<DWORD> mNACKCount {};
+      std::atomic<DWORD> mPLICount {};
+      std::atomic<DWORD> mFIRCount {};
+      std::atomic<DWORD> mRoundTripTimeInMilliseconds {};
+      std::atomic<QWORD> mRemoteEstimatedBitrate {};
+      std::atomic<DWORD> mFractionLostInPPM {};            // parts per million
+      std::atomic<bool> mHasReportingInterval {};
+
+      BYTE mPaddingPublished[ORTC_CACHE_LINE_SIZE] {};
+
+      // incoming RTP path only
+      bool mReceiveStarted {false};
+      WORD mMaxSequenceNumber {};
+      DWORD mSequenceCycles {};
+      DWORD mBaseSequenceNumber {};
+      bool mHasTransit {false};
+      DWORD mTransitClockRate {};
+      LONG mLastTransit {};
+      double mJitter {};
+
+      // outgoing RTCP path only
+      size_t mNextSenderReport {};
+      QWORD mExpectedPrior {};
+      QWORD mReceivedPrior {};
+
+      BYTE mPaddingWriter[ORTC_CACHE_LINE_SIZE] {};
+
+      // rarely written lookup tables
+      std::atomic<DWORD> mClockRates[kMaxPayloadTypes];   // 0 for unknown and RTX/FEC payload types
+      std::atomic<DWORD> mEncodingSSRCs[kMaxSSRCs];       // media SSRCs from the encoding parameters
+      std::atomic<DWORD> mSentSSRCs[kMaxSSRCs];
+      std::atomic<QWORD> mSenderReports[kSenderReportHistory];  // (NTP middle 32 bits << 32) | local milliseconds
+
+      BYTE mPaddingAfter[ORTC_CACHE_LINE_SIZE] {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark LatencyHistogram
+    #pragma mark
+
+    // HDR style log-linear histogram of microsecond latencies. Values below
+    // twice the sub-bucket count are recorded exactly; above that each power
+    // of two is split into kSubBuckets buckets (i.e. every recorded value is
+    // accurate to within ~6%). Percentiles are interpolated by rank across
+    // the values a bucket covers. record() is lock-free and may be called from
+    // any number of threads; snapshot() is safe from any thread at any time.
+    class LatencyHistogram
+    {
+    public:
+      typedef IStatsReportTypes::PacketPipelineStats::HopLatency HopLatency;
+
+      enum Constants
+      {
+        kSubBucketBits = 4,
+        kSubBuckets = (1 << kSubBucketBits),
+        kMaxValueBits = 32,
+        kBuckets = ((kMaxValueBits - kSubBucketBits + 1) * kSubBuckets),
+      };
+
+    public:
+      LatencyHistogram();
+
+      void record(QWORD valueInMicroseconds);
+
+      void snapshot(HopLatency &outLatency) const;
+
+    protected:
+      static size_t toBucket(QWORD value);
+      static QWORD bucketLowestValue(size_t bucket);
+      static QWORD bucketHighestValue(size_t bucket);
+
+    protected:
+      BYTE mPaddingBefore[ORTC_CACHE_LINE_SIZE] {};
+
+      std::atomic<QWORD> mCount {};
+      std::atomic<QWORD> mTotal {};
+      std::atomic<QWORD> mMax {};
+      std::atomic<QWORD> mBuckets[kBuckets];
+
+      BYTE mPaddingAfter[ORTC_CACHE_LINE_SIZE] {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark PacketPipelineLatency
+    #pragma mark
+
+    // Process wide latency histograms for each hop of the incoming packet
+    // pipeline. The synchronous hops (socket read through to the receiver
+    // channel) are measured against a per thread ingress context installed
+    // by IngressScope; packets delivered outside such a scope (e.g. replayed
+    // from a buffer) are not measured for those hops. The queue hops are
+    // measured from a monotonic enqueue time carried with the packet.
+    class PacketPipelineLatency
+    {
+    public:
+      typedef IStatsReportTypes::PacketPipelineHops PacketPipelineHops;
+
+      class IngressScope
+      {
+      public:
+        IngressScope();
+        ~IngressScope();
+
+      protected:
+        QWORD mPreviousIngress {};
+        QWORD mPreviousMark {};
+      };
+
+    public:
+      static QWORD now();                                   // monotonic microseconds (never 0)
+      static QWORD ingressTime();                           // 0 if no ingress context on this thread
+
+      static void markHop(PacketPipelineHops hop);          // synchronous hop reached on this thread
+      static void recordSince(
+                              PacketPipelineHops hop,
+                              QWORD sinceInMicroseconds
+                              );
+
+      static IStatsReportTypes::PacketPipelineStatsPtr createStats();
+
+    protected:
+      static LatencyHistogram *histograms();
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark MediaChannelLatency
+    #pragma mark
+
+    // Process wide counters for media engine channel resources. A setup is
+    // timed from the moment a channel asks the engine for its resource until
+    // the resource is ready (or has failed); a shutdown from the moment it is
+    // requested until the resource has shut down. Both therefore include the
+    // time spent waiting for one of the media channel threads.
+    class MediaChannelLatency
+    {
+    public:
+      static QWORD now();                                   // monotonic microseconds (never 0)
+
+      static void notifySetupRequested();
+      static void recordSetup(
+                              QWORD sinceInMicroseconds,
+                              bool succeeded
+                              );
+      static void recordShutdown(QWORD sinceInMicroseconds);
+
+      static IStatsReportTypes::MediaChannelStatsPtr createStats();
+
+    protected:
+      struct Counters
+      {
+        std::atomic<QWORD> mSetupsRequested {};
+        std::atomic<QWORD> mSetupsSucceeded {};
+        std::atomic<QWORD> mSetupsFailed {};
+        std::atomic<QWORD> mShutdowns {};
+
+        LatencyHistogram mSetup;
+        LatencyHistogram mShutdown;
+      };
+
+      static Counters &counters();
+    };
+
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark StatsSubscription
+    #pragma mark
+
+    class StatsSubscription : public Noop,
+                              public MessageQueueAssociator,
+                              public SharedRecursiveLock,
+                              public IStatsSubscription,
+                              public zsLib::ITimerDelegate,
+                              public IPromiseSettledDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      friend interaction IStatsSubscription;
+      friend interaction IStatsSubscriptionFactory;
+
+      ZS_DECLARE_TYPEDEF_PTR(IStatsReportTypes::Stats, Stats);
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderForStatsSubscription, UseDirectStatsProvider);
+
+      typedef UseDirectStatsProvider::StatsList StatsList;
+      typedef IStatsReportTypes::FlatCounterList FlatCounterList;
+      typedef StatsDelta::CounterKey CounterKey;
+
+      struct SamplingInfo
+      {
+        Milliseconds mInterval {};
+        Time mNextSample;
+      };
+      typedef std::map<StatsTypes, SamplingInfo> SamplingInfoMap;
+
+      struct CounterState
+      {
+        const char *mName {};   // static name from flatten()
+        CounterKey mKey {};
+        double mValue {};
+      };
+      typedef std::vector<CounterState> CounterStateList;   // indexed by flatten() position
+
+      struct StatState
+      {
+        StatsTypes mStatsType {IStatsReportTypes::StatsType_First};
+        DWORD mLastSample {};
+        CounterStateList mCounters;
+      };
+      typedef String StatID;
+      typedef std::map<StatID, StatState> StatStateMap;
+
+    public:
+      StatsSubscription(
+                        const make_private &,
+                        IMessageQueuePtr queue,
+                        IStatsSubscriptionDelegatePtr delegate,
+                        IStatsProviderPtr provider,
+                        const SamplingIntervalMap &intervals
+                        );
+
+    protected:
+      StatsSubscription(Noop) :
+        Noop(true),
+        MessageQueueAssociator(IMessageQueuePtr()),
+        SharedRecursiveLock(SharedRecursiveLock::create())
+      {}
+
+      void init();
+
+    public:
+      virtual ~StatsSubscription();
+
+      static StatsSubscriptionPtr convert(IStatsSubscriptionPtr object);
+
+    protected:
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsSubscription => IStatsSubscription
+      #pragma mark
+
+      static ElementPtr toDebug(StatsSubscriptionPtr subscription);
+
+      static StatsSubscriptionPtr create(
+                                         IStatsSubscriptionDelegatePtr delegate,
+                                         IStatsProviderPtr provider,
+                                         const SamplingIntervalMap &intervals
+                                         );
+
+      virtual PUID getID() const override {return mID;}
+
+      virtual void setSamplingInterval(
+                                       StatsTypes statsType,
+                                       Milliseconds interval
+                                       ) override;
+
+      virtual void cancel() override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsSubscription => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(ITimerPtr timer) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsSubscription => IPromiseSettledDelegate
+      #pragma mark
+
+      virtual void onPromiseSettled(PromisePtr promise) override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsSubscription => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      Log::Params debug(const char *message) const;
+      virtual ElementPtr toDebug() const;
+
+      Milliseconds normalizeInterval(Milliseconds interval) const;
+      void resetTimer();
+      void sample();
+      StatsDeltaPtr createDelta(
+                                const StatsList &stats,
+                                const StatsTypeSet &sampledStatsTypes
+                                );
+      void notifyDelta(
+                       IStatsSubscriptionDelegatePtr delegate,
+                       StatsDeltaPtr delta
+                       );
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark StatsSubscription => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      StatsSubscriptionWeakPtr mThisWeak;
+
+      IStatsSubscriptionDelegatePtr mDelegate;
+      IStatsProviderWeakPtr mProvider;
+
+      Milliseconds mMinimumInterval {};
+      SamplingInfoMap mSampling;
+
+      ITimerPtr mTimer;
+      Milliseconds mTimerInterval {};
+
+      PromiseWithStatsReportPtr mPendingSample;
+      StatsTypeSet mPendingStatsTypes;
+
+      DWORD mSequenceNumber {};
+      DWORD mTotalSamples {};
+      CounterKey mNextCounterKey {1};
+      StatStateMap mStatStates;
+      FlatCounterList mFlattenBuffer;
+
+      bool mShutdown {false};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IStatsSubscriptionFactory
+    #pragma mark
+
+    interaction IStatsSubscriptionFactory
+    {
+      typedef IStatsProviderTypes::SamplingIntervalMap SamplingIntervalMap;
+
+      static IStatsSubscriptionFactory &singleton();
+
+      virtual StatsSubscriptionPtr create(
+                                          IStatsSubscriptionDelegatePtr delegate,
+                                          IStatsProviderPtr provider,
+                                          const SamplingIntervalMap &intervals
+                                          );
+    };
+
+    class StatsSubscriptionFactory : public IFactory<IStatsSubscriptionFactory> {};
   }
 }
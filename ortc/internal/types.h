@@ -40,6 +40,10 @@
 #include <zsLib/IWakeDelegate.h>
 #include <zsLib/WeightedMovingAverage.h>
 
+#ifndef ORTC_CACHE_LINE_SIZE
+#define ORTC_CACHE_LINE_SIZE (64)
+#endif //ndef ORTC_CACHE_LINE_SIZE
+
 namespace ortc
 {
   namespace internal
@@ -69,6 +73,7 @@ namespace ortc
     ZS_DECLARE_USING_PTR(zsLib, IMessageQueueNotify);
     ZS_DECLARE_USING_PTR(zsLib, IMessageQueueThread);
     ZS_DECLARE_USING_PTR(zsLib, IMessageQueueMessage);
+    using zsLib::IMessageQueueMessageUPtr;
 
     ZS_DECLARE_USING_PTR(zsLib, IMessageQueue);
     ZS_DECLARE_USING_PTR(zsLib, IMessageQueueThread);
@@ -118,31 +123,41 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForSRTPTransport);
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForICETransport);
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForRTPListener);
+    ZS_DECLARE_INTERACTION_PTR(ISecureTransportForRTPCapture);
     ZS_DECLARE_INTERACTION_PTR(ISRTPTransport);
 
     ZS_DECLARE_CLASS_PTR(ORTC);
+    ZS_DECLARE_CLASS_PTR(ActiveSpeakerDetector);
+    ZS_DECLARE_CLASS_PTR(AudioRingBuffer);
     ZS_DECLARE_CLASS_PTR(Certificate);
     ZS_DECLARE_CLASS_PTR(DataChannel);
     ZS_DECLARE_CLASS_PTR(DTMFSender);
     ZS_DECLARE_CLASS_PTR(DTLSTransport);
     ZS_DECLARE_CLASS_PTR(ICEGatherer);
     ZS_DECLARE_CLASS_PTR(ICEGathererRouter);
+    ZS_DECLARE_CLASS_PTR(ICEGathererPool);
     ZS_DECLARE_CLASS_PTR(ICETransport);
     ZS_DECLARE_CLASS_PTR(ICETransportController);
+    ZS_DECLARE_CLASS_PTR(LockProfiler);
     ZS_DECLARE_CLASS_PTR(Identity);
     ZS_DECLARE_CLASS_PTR(MediaDevices);
     ZS_DECLARE_CLASS_PTR(MediaStreamTrack);
+    ZS_DECLARE_CLASS_PTR(MessageQueueMonitor);
+    ZS_DECLARE_CLASS_PTR(NetworkImpairment);
+    ZS_DECLARE_CLASS_PTR(RTPCaptureRing);
     ZS_DECLARE_CLASS_PTR(RTPListener);
     ZS_DECLARE_CLASS_PTR(RTPMediaEngine);
     ZS_DECLARE_CLASS_PTR(RTPReceiver);
     ZS_DECLARE_CLASS_PTR(RTPReceiverChannel);
     ZS_DECLARE_CLASS_PTR(RTPReceiverChannelAudio);
     ZS_DECLARE_CLASS_PTR(RTPReceiverChannelVideo);
+    ZS_DECLARE_CLASS_PTR(RTPRelay);
     ZS_DECLARE_CLASS_PTR(RTPSender);
     ZS_DECLARE_CLASS_PTR(RTPSenderChannel);
     ZS_DECLARE_CLASS_PTR(RTPSenderChannelAudio);
     ZS_DECLARE_CLASS_PTR(RTPSenderChannelVideo);
     ZS_DECLARE_CLASS_PTR(StatsReport);
+    ZS_DECLARE_CLASS_PTR(StatsSubscription);
     ZS_DECLARE_CLASS_PTR(SCTPTransport);
     ZS_DECLARE_CLASS_PTR(SRTPSDESTransport);
     ZS_DECLARE_CLASS_PTR(SRTPTransport);
@@ -34,6 +34,7 @@
 #include <ortc/types.h>
 #include <ortc/IORTC.h>
 
+#include <ortc/IActiveSpeakerDetector.h>
 #include <ortc/ICapabilities.h>
 #include <ortc/IConstraints.h>
 #include <ortc/IDataChannel.h>
@@ -49,6 +50,8 @@
 #include <ortc/IMediaStreamTrack.h>
 #include <ortc/IRTPTypes.h>
 #include <ortc/IRTPListener.h>
+#include <ortc/IRTPCapture.h>
+#include <ortc/IRTPRelay.h>
 #include <ortc/IRTPSender.h>
 #include <ortc/IRTPReceiver.h>
 #include <ortc/ISCTPTransport.h>
@@ -0,0 +1,412 @@
+/*
+ 
+ Copyright (c) 2016, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_ActiveSpeakerDetector.h>
+#include <ortc/internal/ortc_ORTC.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::AutoRecursiveLock;
+using zsLib::IMessageQueuePtr;
+using zsLib::Milliseconds;
+using zsLib::Optional;
+using zsLib::BYTE;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IORTCForInternal, UseORTC)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::ActiveSpeakerDetector, UseDetector)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace activespeakerdetector
+    {
+      ZS_DECLARE_CLASS_PTR(DetectorTester)
+
+      static const PUID kReceiverA = 1001;
+      static const PUID kReceiverB = 1002;
+      static const PUID kReceiverUnmonitored = 1003;
+
+      static const IRTPTypes::SSRCType kSSRCA = 0x1000A;
+      static const IRTPTypes::SSRCType kSSRCB = 0x1000B;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark DetectorTester
+      #pragma mark
+
+      // A detector without an evaluation timer; the test feeds audio levels
+      // as a receiver would and runs each evaluation interval by hand.
+      class DetectorTester : public UseDetector
+      {
+      public:
+        //---------------------------------------------------------------------
+        DetectorTester(
+                       const make_private &,
+                       IMessageQueuePtr queue
+                       ) :
+          UseDetector(make_private {}, queue, IActiveSpeakerDetectorDelegatePtr())
+        {}
+
+        //---------------------------------------------------------------------
+        static DetectorTesterPtr create()
+        {
+          DetectorTesterPtr pThis(make_shared<DetectorTester>(make_private {}, UseORTC::queueORTC()));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        void monitor(PUID receiverID)
+        {
+          AutoRecursiveLock lock(*this);
+          mReceivers[receiverID] = UseReceiverPtr();
+        }
+
+        //---------------------------------------------------------------------
+        void level(
+                   PUID receiverID,
+                   SSRCType ssrc,
+                   BYTE level,
+                   size_t packets = 10,
+                   const Optional<bool> &voiceActivity = Optional<bool>()
+                   )
+        {
+          for (size_t index = 0; index < packets; ++index) {
+            notifyAudioLevel(receiverID, ssrc, level, voiceActivity);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void interval()
+        {
+          AutoRecursiveLock lock(*this);
+          evaluate();
+        }
+
+        //---------------------------------------------------------------------
+        void holdElapsed()
+        {
+          AutoRecursiveLock lock(*this);
+          mDominantSince -= mMinHold;
+        }
+
+        //---------------------------------------------------------------------
+        void silent(PUID receiverID)
+        {
+          AutoRecursiveLock lock(*this);
+          for (auto iter = mStreams.begin(); iter != mStreams.end(); ++iter) {
+            auto &info = *((*iter).second);
+            if (info.mKey.first != receiverID) continue;
+            info.mLastReceived -= (mStreamTimeout + Milliseconds(1));
+          }
+        }
+
+        //---------------------------------------------------------------------
+        Optional<SSRCType> dominant() const
+        {
+          AutoRecursiveLock lock(*this);
+          if (!mDominant.hasValue()) return Optional<SSRCType>();
+          return Optional<SSRCType>(mDominant.value().second);
+        }
+
+        //---------------------------------------------------------------------
+        size_t activeSlots() const
+        {
+          size_t total = 0;
+          for (size_t index = 0; index < kMaxStreamSlots; ++index) {
+            if (SlotState_Active == mSlots[index].mState.load()) ++total;
+          }
+          return total;
+        }
+
+        size_t totalSwitches() const {AutoRecursiveLock lock(*this); return mTotalSwitches;}
+        size_t totalStreams() const {AutoRecursiveLock lock(*this); return mStreams.size();}
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void applyDetectorSettings()
+      {
+        UseSettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SILENCE_LEVEL, 70);
+        UseSettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_SWITCH_MARGIN, 6);
+        UseSettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_MIN_HOLD_IN_MILLISECONDS, 1000);
+        UseSettings::setUInt(ORTC_SETTING_ACTIVE_SPEAKER_DETECTOR_STREAM_TIMEOUT_IN_MILLISECONDS, 2000);
+      }
+
+      //-----------------------------------------------------------------------
+      static DetectorTesterPtr createTester()
+      {
+        applyDetectorSettings();
+
+        auto tester = DetectorTester::create();
+        tester->monitor(kReceiverA);
+        tester->monitor(kReceiverB);
+        return tester;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testFirstSpeaker()
+      {
+        auto tester = createTester();
+
+        tester->interval();
+        TESTING_CHECK(!tester->dominant().hasValue())
+        TESTING_EQUAL(tester->totalSwitches(), 0)
+
+        // levels are -dBov so 100 is below the silence threshold of 70
+        tester->level(kReceiverA, kSSRCA, 100);
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), 1)
+        TESTING_CHECK(!tester->dominant().hasValue())
+
+        // the first stream above silence takes the floor without any hold
+        tester->level(kReceiverB, kSSRCB, 30);
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), 2)
+        TESTING_CHECK(tester->dominant().hasValue())
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+        TESTING_EQUAL(tester->totalSwitches(), 1)
+
+        // the last speaker is kept while everyone is silent
+        for (size_t index = 0; index < UseDetector::kLevelHistory; ++index) {
+          tester->level(kReceiverB, kSSRCB, 110);
+          tester->interval();
+        }
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+        TESTING_EQUAL(tester->totalSwitches(), 1)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testSwitchMargin()
+      {
+        auto tester = createTester();
+
+        tester->level(kReceiverA, kSSRCA, 30);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+
+        tester->holdElapsed();
+
+        // a challenger louder by less than the switch margin never takes over
+        for (size_t index = 0; index < UseDetector::kLevelHistory; ++index) {
+          tester->level(kReceiverA, kSSRCA, 30);
+          tester->level(kReceiverB, kSSRCB, 25);
+          tester->interval();
+        }
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+        TESTING_EQUAL(tester->totalSwitches(), 1)
+
+        // ...but does once it is louder by at least the margin
+        for (size_t index = 0; index < UseDetector::kLevelHistory; ++index) {
+          tester->level(kReceiverA, kSSRCA, 30);
+          tester->level(kReceiverB, kSSRCB, 24);
+          tester->interval();
+        }
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+        TESTING_EQUAL(tester->totalSwitches(), 2)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMinHold()
+      {
+        auto tester = createTester();
+
+        tester->level(kReceiverA, kSSRCA, 40);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+
+        // a clearly louder challenger must wait for the minimum hold
+        for (size_t index = 0; index < UseDetector::kLevelHistory; ++index) {
+          tester->level(kReceiverA, kSSRCA, 40);
+          tester->level(kReceiverB, kSSRCB, 10);
+          tester->interval();
+        }
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+        TESTING_EQUAL(tester->totalSwitches(), 1)
+
+        tester->holdElapsed();
+
+        tester->level(kReceiverA, kSSRCA, 40);
+        tester->level(kReceiverB, kSSRCB, 10);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+        TESTING_EQUAL(tester->totalSwitches(), 2)
+
+        // and the new speaker is protected by the hold in turn
+        for (size_t index = 0; index < UseDetector::kLevelHistory; ++index) {
+          tester->level(kReceiverA, kSSRCA, 0);
+          tester->level(kReceiverB, kSSRCB, 40);
+          tester->interval();
+        }
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+
+        tester->holdElapsed();
+
+        tester->level(kReceiverA, kSSRCA, 0);
+        tester->level(kReceiverB, kSSRCB, 40);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+        TESTING_EQUAL(tester->totalSwitches(), 3)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testVoiceActivity()
+      {
+        auto tester = createTester();
+
+        // packets flagged without voice activity count as silence
+        tester->level(kReceiverA, kSSRCA, 10, 10, Optional<bool>(false));
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), 1)
+        TESTING_CHECK(!tester->dominant().hasValue())
+
+        tester->level(kReceiverB, kSSRCB, 50, 10, Optional<bool>(true));
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCB)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testStreamExpiry()
+      {
+        auto tester = createTester();
+
+        tester->level(kReceiverA, kSSRCA, 30);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+        TESTING_EQUAL(tester->activeSlots(), 1)
+
+        // the dominant stream stops and times out while the other is silent
+        tester->silent(kReceiverA);
+        tester->level(kReceiverB, kSSRCB, 100);
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), 1)
+        TESTING_EQUAL(tester->activeSlots(), 1)
+        TESTING_CHECK(!tester->dominant().hasValue())
+        TESTING_EQUAL(tester->totalSwitches(), 2)
+
+        // the expired stream's slot is reused when it starts again
+        tester->level(kReceiverA, kSSRCA, 30);
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), 2)
+        TESTING_EQUAL(tester->activeSlots(), 2)
+        TESTING_EQUAL(tester->dominant().value(), kSSRCA)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testUnmonitoredReceiver()
+      {
+        auto tester = createTester();
+
+        tester->level(kReceiverUnmonitored, kSSRCA, 0);
+        TESTING_EQUAL(tester->activeSlots(), 1)
+
+        // levels of receivers which are not monitored are dropped and their
+        // slots released on the next evaluation
+        tester->interval();
+        TESTING_EQUAL(tester->activeSlots(), 0)
+        TESTING_EQUAL(tester->totalStreams(), 0)
+        TESTING_CHECK(!tester->dominant().hasValue())
+      }
+
+      //-----------------------------------------------------------------------
+      static void testSlotsExhausted()
+      {
+        auto tester = createTester();
+
+        for (size_t index = 0; index < UseDetector::kMaxStreamSlots; ++index) {
+          tester->level(kReceiverA, static_cast<IRTPTypes::SSRCType>(index + 1), 100, 1);
+        }
+        TESTING_EQUAL(tester->activeSlots(), UseDetector::kMaxStreamSlots)
+
+        // once every slot is taken new streams are ignored...
+        tester->level(kReceiverB, kSSRCB, 0);
+        tester->interval();
+        TESTING_EQUAL(tester->totalStreams(), UseDetector::kMaxStreamSlots)
+        TESTING_CHECK(!tester->dominant().hasValue())
+
+        // ...while known streams keep finding their own slot
+        tester->level(kReceiverA, 7, 20);
+        tester->interval();
+        TESTING_EQUAL(tester->dominant().value(), static_cast<IRTPTypes::SSRCType>(7))
+      }
+    }
+  }
+}
+
+using namespace ortc::test::activespeakerdetector;
+
+void doTestActiveSpeakerDetector()
+{
+  if (!ORTC_TEST_DO_ACTIVE_SPEAKER_DETECTOR_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testFirstSpeaker();
+  testSwitchMargin();
+  testMinHold();
+  testVoiceActivity();
+  testStreamExpiry();
+  testUnmonitoredReceiver();
+  testSlotsExhausted();
+
+  UseSettings::applyDefaults();
+
+  TESTING_UNINSTALL_LOGGER();
+}
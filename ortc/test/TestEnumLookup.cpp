@@ -0,0 +1,275 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_Helper.h>
+
+#include <ortc/IRTPTypes.h>
+#include <ortc/IICETypes.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Stringize.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::ULONG;
+using zsLib::String;
+using zsLib::Time;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::IRTPTypes, UseRTPTypes)
+ZS_DECLARE_TYPEDEF_PTR(ortc::IICETypes, UseICETypes)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPTypesHelper, UseRTPTypesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace enumlookup
+    {
+      typedef UseRTPTypes::SupportedCodecs SupportedCodecs;
+      typedef UseRTPTypes::HeaderExtensionURIs HeaderExtensionURIs;
+      typedef UseICETypes::CandidateTypes CandidateTypes;
+
+      //-----------------------------------------------------------------------
+      // the lookups used before the enum string tables; kept here as the
+      // benchmark baselines
+      static SupportedCodecs linearToSupportedCodec(const char *codec)
+      {
+        String codecStr(codec);
+        for (auto index = UseRTPTypes::SupportedCodec_First; index <= UseRTPTypes::SupportedCodec_Last; index = static_cast<SupportedCodecs>(static_cast<std::underlying_type<SupportedCodecs>::type>(index) + 1)) {
+          if (0 == codecStr.compareNoCase(UseRTPTypes::toString(index))) return index;
+        }
+        return UseRTPTypes::SupportedCodec_Unknown;
+      }
+
+      //-----------------------------------------------------------------------
+      static HeaderExtensionURIs linearToHeaderExtensionURI(const char *uri)
+      {
+        String uriStr(uri);
+        for (auto index = UseRTPTypes::HeaderExtensionURI_First; index <= UseRTPTypes::HeaderExtensionURI_Last; index = static_cast<HeaderExtensionURIs>(static_cast<std::underlying_type<HeaderExtensionURIs>::type>(index) + 1)) {
+          if (uriStr == UseRTPTypes::toString(index)) return index;
+        }
+        return UseRTPTypes::HeaderExtensionURI_Unknown;
+      }
+
+      //-----------------------------------------------------------------------
+      static CandidateTypes linearToCandidateType(const char *candidateType)
+      {
+        String str(candidateType);
+        for (auto index = UseICETypes::CandidateType_First; index <= UseICETypes::CandidateType_Last; index = static_cast<CandidateTypes>(static_cast<std::underlying_type<CandidateTypes>::type>(index) + 1)) {
+          if (0 == str.compareNoCase(UseICETypes::toString(index))) return index;
+        }
+        return UseICETypes::CandidateType_First;
+      }
+
+      //-----------------------------------------------------------------------
+      enum TestEnums
+      {
+        TestEnum_First,
+
+        TestEnum_Alpha = TestEnum_First,
+        TestEnum_Beta,
+        TestEnum_AlsoAlpha,
+        TestEnum_Gamma,
+
+        TestEnum_Last = TestEnum_Gamma,
+      };
+
+      //-----------------------------------------------------------------------
+      static const char *toString(TestEnums value)
+      {
+        switch (value) {
+          case TestEnum_Alpha:      return "alpha";
+          case TestEnum_Beta:       return "Beta";
+          case TestEnum_AlsoAlpha:  return "alpha";
+          case TestEnum_Gamma:      return "";
+        }
+        return "unknown";
+      }
+
+      //-----------------------------------------------------------------------
+      static void testTable()
+      {
+        internal::EnumStringTable<TestEnums> exact(TestEnum_First, TestEnum_Last, toString);
+        internal::EnumStringTable<TestEnums> noCase(TestEnum_First, TestEnum_Last, toString, false);
+
+        TestEnums result {};
+
+        TESTING_CHECK(exact.find("alpha", result))
+        TESTING_EQUAL(result, TestEnum_Alpha)           // first name wins
+        TESTING_CHECK(exact.find("Beta", result))
+        TESTING_EQUAL(result, TestEnum_Beta)
+        TESTING_CHECK(!exact.find("beta", result))
+        TESTING_CHECK(!exact.find("alph", result))
+        TESTING_CHECK(!exact.find("alphabet", result))
+        TESTING_CHECK(exact.find("", result))
+        TESTING_EQUAL(result, TestEnum_Gamma)
+        TESTING_CHECK(exact.find(NULL, result))
+        TESTING_EQUAL(result, TestEnum_Gamma)
+        TESTING_CHECK(exact.find("alpha-and-more", 5, result))
+        TESTING_EQUAL(result, TestEnum_Alpha)
+
+        TESTING_CHECK(noCase.find("BETA", result))
+        TESTING_EQUAL(result, TestEnum_Beta)
+        TESTING_CHECK(noCase.find("Alpha", result))
+        TESTING_EQUAL(result, TestEnum_Alpha)
+        TESTING_CHECK(!noCase.find("gamma", result))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testConversions()
+      {
+        for (auto index = UseRTPTypes::SupportedCodec_First; index <= UseRTPTypes::SupportedCodec_Last; index = static_cast<SupportedCodecs>(static_cast<std::underlying_type<SupportedCodecs>::type>(index) + 1)) {
+          const char *name = UseRTPTypes::toString(index);
+          TESTING_EQUAL(UseRTPTypes::toSupportedCodec(name), linearToSupportedCodec(name))
+
+          String upperName(name);
+          upperName.toUpper();
+          TESTING_EQUAL(UseRTPTypes::toSupportedCodec(upperName), linearToSupportedCodec(upperName))
+        }
+        for (auto index = UseRTPTypes::HeaderExtensionURI_First; index <= UseRTPTypes::HeaderExtensionURI_Last; index = static_cast<HeaderExtensionURIs>(static_cast<std::underlying_type<HeaderExtensionURIs>::type>(index) + 1)) {
+          const char *name = UseRTPTypes::toString(index);
+          TESTING_EQUAL(UseRTPTypes::toHeaderExtensionURI(name), linearToHeaderExtensionURI(name))
+        }
+        for (auto index = UseICETypes::CandidateType_First; index <= UseICETypes::CandidateType_Last; index = static_cast<CandidateTypes>(static_cast<std::underlying_type<CandidateTypes>::type>(index) + 1)) {
+          const char *name = UseICETypes::toString(index);
+          TESTING_EQUAL(UseICETypes::toCandidateType(name), index)
+        }
+
+        TESTING_EQUAL(UseRTPTypes::toSupportedCodec("not-a-codec"), UseRTPTypes::SupportedCodec_Unknown)
+        TESTING_EQUAL(UseRTPTypes::toHeaderExtensionURI("urn:not-an-extension"), UseRTPTypes::HeaderExtensionURI_Unknown)
+      }
+
+      //-----------------------------------------------------------------------
+      static void benchmarkLookups(ULONG iterations)
+      {
+        const char *codecs[] = {"opus", "VP8", "H264", "rtx", "red", "ulpfec", "telephone-event", "not-a-codec", NULL};
+        const char *uris[] = {
+          "urn:ietf:params:rtp-hdrext:ssrc-audio-level",
+          "urn:ietf:params:rtp-hdrext:sdes:mid",
+          "urn:ietf:params:rtp-hdrext:toffset",
+          "urn:not-an-extension",
+          NULL
+        };
+        const char *candidateTypes[] = {"host", "srflx", "prflx", "relay", NULL};
+
+        size_t matched = 0;
+
+        Time start = zsLib::now();
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (size_t index = 0; NULL != codecs[index]; ++index) {
+            if (UseRTPTypes::SupportedCodec_Unknown != linearToSupportedCodec(codecs[index])) ++matched;
+          }
+          for (size_t index = 0; NULL != uris[index]; ++index) {
+            if (UseRTPTypes::HeaderExtensionURI_Unknown != linearToHeaderExtensionURI(uris[index])) ++matched;
+          }
+          for (size_t index = 0; NULL != candidateTypes[index]; ++index) {
+            if (UseICETypes::CandidateType_First != linearToCandidateType(candidateTypes[index])) ++matched;
+          }
+        }
+        auto linear = zsLib::toMicroseconds(zsLib::now() - start);
+
+        start = zsLib::now();
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (size_t index = 0; NULL != codecs[index]; ++index) {
+            if (UseRTPTypes::SupportedCodec_Unknown != UseRTPTypes::toSupportedCodec(codecs[index])) ++matched;
+          }
+          for (size_t index = 0; NULL != uris[index]; ++index) {
+            if (UseRTPTypes::HeaderExtensionURI_Unknown != UseRTPTypes::toHeaderExtensionURI(uris[index])) ++matched;
+          }
+          for (size_t index = 0; NULL != candidateTypes[index]; ++index) {
+            if (UseICETypes::CandidateType_First != UseICETypes::toCandidateType(candidateTypes[index])) ++matched;
+          }
+        }
+        auto hashed = zsLib::toMicroseconds(zsLib::now() - start);
+
+        TESTING_CHECK(matched > 0)
+
+        TESTING_STDOUT() << "BENCHMARK:    enum lookup, iterations=" << iterations << ", linear=" << linear.count() << "us, hashed=" << hashed.count() << "us\n";
+      }
+
+      //-----------------------------------------------------------------------
+      static void benchmarkFindCodec(ULONG iterations)
+      {
+        const char *names[] = {"opus", "ISAC", "G722", "PCMU", "PCMA", "VP8", "VP9", "H264", "red", "ulpfec", NULL};
+
+        UseRTPTypes::Parameters params;
+        for (size_t index = 0; NULL != names[index]; ++index) {
+          UseRTPTypes::CodecParameters codec;
+          codec.mName = names[index];
+          codec.mPayloadType = static_cast<UseRTPTypes::PayloadType>(96 + index);
+          codec.mClockRate = 90000;
+          params.mCodecs.push_back(codec);
+        }
+
+        size_t found = 0;
+
+        Time start = zsLib::now();
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (size_t index = 0; NULL != names[index]; ++index) {
+            UseRTPTypesHelper::FindCodecOptions options;
+            options.mPayloadType = static_cast<UseRTPTypes::PayloadType>(96 + index);
+            if (UseRTPTypesHelper::findCodec(params, options)) ++found;
+          }
+        }
+        auto elapsed = zsLib::toMicroseconds(zsLib::now() - start);
+
+        TESTING_EQUAL(found, static_cast<size_t>(iterations) * (sizeof(names) / sizeof(names[0]) - 1))
+
+        TESTING_STDOUT() << "BENCHMARK:    find codec, iterations=" << iterations << ", codecs=" << params.mCodecs.size() << ", elapsed=" << elapsed.count() << "us\n";
+      }
+    }
+  }
+}
+
+using namespace ortc::test::enumlookup;
+
+void doTestEnumLookup()
+{
+  if (!ORTC_TEST_DO_ENUM_LOOKUP_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testTable();
+  testConversions();
+
+  benchmarkLookups(100000);
+  benchmarkFindCodec(10000);
+
+  TESTING_UNINSTALL_LOGGER();
+}
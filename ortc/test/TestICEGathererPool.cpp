@@ -0,0 +1,455 @@
+/*
+ 
+ Copyright (c) 2016, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_ICEGathererPool.h>
+#include <ortc/internal/ortc_ORTC.h>
+
+#include <ortc/IICEGatherer.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::AutoRecursiveLock;
+using zsLib::IMessageQueuePtr;
+using zsLib::Seconds;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IORTCForInternal, UseORTC)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::ICEGathererPool, UsePool)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace icegathererpool
+    {
+      ZS_DECLARE_CLASS_PTR(FakeGathererSubscription)
+      ZS_DECLARE_CLASS_PTR(FakeGatherer)
+      ZS_DECLARE_CLASS_PTR(PoolTester)
+
+      typedef std::list<FakeGathererPtr> FakeGathererList;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeGathererSubscription
+      #pragma mark
+
+      class FakeGathererSubscription : public IICEGathererSubscription
+      {
+      public:
+        virtual PUID getID() const override {return mID;}
+        virtual void cancel() override {mCancelled = true;}
+        virtual void background() override {}
+
+        bool isCancelled() const {return mCancelled;}
+
+      protected:
+        AutoPUID mID;
+        bool mCancelled {false};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeGatherer
+      #pragma mark
+
+      // Stands in for a gatherer so the pool can be exercised without binding
+      // sockets or talking to STUN/TURN servers.
+      class FakeGatherer : public IICEGatherer
+      {
+      public:
+        virtual PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats = StatsTypeSet()) const override {return PromiseWithStatsReportPtr();}
+
+        virtual PUID getID() const override {return mID;}
+
+        virtual IICEGathererSubscriptionPtr subscribe(IICEGathererDelegatePtr delegate) override
+        {
+          mLastSubscription = make_shared<FakeGathererSubscription>();
+          return mLastSubscription;
+        }
+
+        virtual Components component() const override {return IICETypes::Component_RTP;}
+        virtual States state() const override {return mState;}
+
+        virtual ParametersPtr getLocalParameters() const override {return ParametersPtr();}
+        virtual CandidateListPtr getLocalCandidates() const override {return CandidateListPtr();}
+
+        virtual IICEGathererPtr createAssociatedGatherer(IICEGathererDelegatePtr delegate) throw(InvalidStateError) override {return IICEGathererPtr();}
+
+        virtual void gather(const Optional<Options> &options = Optional<Options>()) override {mState = State_Gathering;}
+
+        virtual void close() override {mState = State_Closed;}
+
+        FakeGathererSubscriptionPtr lastSubscription() const {return mLastSubscription;}
+
+      protected:
+        AutoPUID mID;
+        States mState {State_New};
+        FakeGathererSubscriptionPtr mLastSubscription;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark PoolTester
+      #pragma mark
+
+      // A private pool (rather than the process singleton) which creates fake
+      // gatherers and lets the test age them and drive the maintenance timer.
+      class PoolTester : public UsePool
+      {
+      public:
+        //---------------------------------------------------------------------
+        PoolTester(
+                   const make_private &,
+                   IMessageQueuePtr queue
+                   ) :
+          UsePool(make_private {}, queue)
+        {}
+
+        //---------------------------------------------------------------------
+        static PoolTesterPtr create()
+        {
+          PoolTesterPtr pThis(make_shared<PoolTester>(make_private {}, UseORTC::queueORTC()));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        FakeGathererPtr acquire(const Options &options)
+        {
+          AutoRecursiveLock lock(*this);
+          IICEGathererSubscriptionPtr subscription;
+          auto gatherer = take(IICEGathererDelegatePtr(), options, subscription);
+          if (!gatherer) return FakeGathererPtr();
+
+          // the delegate of the adopter was subscribed in place of the pool
+          auto fake = ZS_DYNAMIC_PTR_CAST(FakeGatherer, gatherer);
+          TESTING_CHECK(fake)
+          TESTING_CHECK(subscription)
+          TESTING_CHECK(subscription == fake->lastSubscription())
+          return fake;
+        }
+
+        //---------------------------------------------------------------------
+        void maintain()
+        {
+          AutoRecursiveLock lock(*this);
+          TESTING_CHECK(mTimer)
+          if (!mTimer) return;
+          onTimer(mTimer);
+        }
+
+        //---------------------------------------------------------------------
+        void notifyClosed(FakeGathererPtr gatherer)
+        {
+          gatherer->close();
+          onICEGathererStateChange(gatherer, IICEGathererTypes::State_Closed);
+        }
+
+        //---------------------------------------------------------------------
+        void age(Seconds duration)
+        {
+          AutoRecursiveLock lock(*this);
+          for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+            auto &pool = *((*iter).second);
+            for (auto iterGatherer = pool.mGatherers.begin(); iterGatherer != pool.mGatherers.end(); ++iterGatherer) {
+              (*iterGatherer)->mCreated -= duration;
+            }
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void idle(Seconds duration)
+        {
+          AutoRecursiveLock lock(*this);
+          for (auto iter = mPools.begin(); iter != mPools.end(); ++iter) {
+            (*iter).second->mLastRequested -= duration;
+          }
+        }
+
+        //---------------------------------------------------------------------
+        size_t pooled(const Options &options) const
+        {
+          AutoRecursiveLock lock(*this);
+          auto found = mPools.find(options.hash());
+          if (found == mPools.end()) return 0;
+          return (*found).second->mGatherers.size();
+        }
+
+        //---------------------------------------------------------------------
+        FakeGathererPtr front(const Options &options) const
+        {
+          AutoRecursiveLock lock(*this);
+          auto found = mPools.find(options.hash());
+          if (found == mPools.end()) return FakeGathererPtr();
+          auto &pool = *((*found).second);
+          if (pool.mGatherers.size() < 1) return FakeGathererPtr();
+          return ZS_DYNAMIC_PTR_CAST(FakeGatherer, pool.mGatherers.front()->mGatherer);
+        }
+
+        size_t totalPools() const {AutoRecursiveLock lock(*this); return mPools.size();}
+        bool hasTimer() const {AutoRecursiveLock lock(*this); return (bool)mTimer;}
+        Stats stats() const {AutoRecursiveLock lock(*this); return mStats;}
+        const FakeGathererList &created() const {return mCreated;}
+
+      protected:
+        //---------------------------------------------------------------------
+        virtual IICEGathererPtr createGatherer(const Options &options) override
+        {
+          auto gatherer = make_shared<FakeGatherer>();
+          mCreated.push_back(gatherer);
+          return gatherer;
+        }
+
+      protected:
+        FakeGathererList mCreated;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void applyPoolSettings(size_t poolSize)
+      {
+        UseSettings::setUInt(ORTC_SETTING_GATHERER_POOL_SIZE, poolSize);
+        UseSettings::setUInt(ORTC_SETTING_GATHERER_POOL_MAX_AGE_IN_SECONDS, 60);
+        UseSettings::setUInt(ORTC_SETTING_GATHERER_POOL_IDLE_TIMEOUT_IN_SECONDS, 30);
+      }
+
+      //-----------------------------------------------------------------------
+      static size_t totalClosed(const FakeGathererList &gatherers)
+      {
+        size_t result = 0;
+        for (auto iter = gatherers.begin(); iter != gatherers.end(); ++iter) {
+          if (IICEGathererTypes::State_Closed == (*iter)->state()) ++result;
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testDisabledUntilConfigured()
+      {
+        IICEGathererTypes::Options options;
+
+        applyPoolSettings(0);
+        auto tester = PoolTester::create();
+
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->stats().mMisses, 1)
+        TESTING_EQUAL(tester->totalPools(), 0)
+        TESTING_CHECK(!tester->hasTimer())
+
+        // enabling the pool after it was created takes effect on next demand
+        applyPoolSettings(2);
+
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->stats().mMisses, 2)
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_CHECK(tester->hasTimer())
+      }
+
+      //-----------------------------------------------------------------------
+      static void testAcquireAndRefill()
+      {
+        IICEGathererTypes::Options options;
+        IICEGathererTypes::Options otherOptions;
+        otherOptions.mContinuousGathering = false;
+
+        applyPoolSettings(2);
+        auto tester = PoolTester::create();
+
+        // first demand for the options is a miss which starts pre-gathering
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_EQUAL(tester->created().size(), 2)
+        TESTING_EQUAL(tester->created().front()->state(), IICEGathererTypes::State_Gathering)
+
+        auto expected = tester->front(options);
+        TESTING_CHECK(expected)
+        auto poolSubscription = expected->lastSubscription();
+        TESTING_CHECK(poolSubscription)
+
+        // the next demand is handed a warm gatherer and the pool is topped up
+        auto gatherer = tester->acquire(options);
+        TESTING_CHECK(gatherer)
+        TESTING_CHECK(gatherer == expected)
+        TESTING_CHECK(poolSubscription->isCancelled())
+        TESTING_EQUAL(tester->stats().mHits, 1)
+        TESTING_EQUAL(tester->stats().mMisses, 1)
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_EQUAL(tester->created().size(), 3)
+        TESTING_EQUAL(tester->stats().mPooled, 3)
+
+        // gatherers are pooled per set of options
+        TESTING_CHECK(!tester->acquire(otherOptions))
+        TESTING_EQUAL(tester->totalPools(), 2)
+        TESTING_EQUAL(tester->pooled(otherOptions), 2)
+        TESTING_EQUAL(tester->stats().mMisses, 2)
+
+        // a pooled gatherer that closed in the mean time is never handed out
+        auto closed = tester->front(options);
+        TESTING_CHECK(closed)
+        if (!closed) return;
+        closed->close();
+        auto next = tester->acquire(options);
+        TESTING_CHECK(next)
+        TESTING_CHECK(next != closed)
+        TESTING_CHECK(closed->lastSubscription()->isCancelled())
+        TESTING_EQUAL(tester->pooled(options), 2)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMaxAge()
+      {
+        IICEGathererTypes::Options options;
+
+        applyPoolSettings(2);
+        auto tester = PoolTester::create();
+
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->created().size(), 2)
+
+        // younger than the maximum age; nothing is rotated out
+        tester->age(Seconds(30));
+        tester->maintain();
+        TESTING_EQUAL(tester->stats().mExpired, 0)
+        TESTING_EQUAL(totalClosed(tester->created()), 0)
+
+        tester->age(Seconds(31));
+        tester->maintain();
+        TESTING_EQUAL(tester->stats().mExpired, 2)
+        TESTING_EQUAL(totalClosed(tester->created()), 2)
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_EQUAL(tester->created().size(), 4)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testIdleTimeout()
+      {
+        IICEGathererTypes::Options options;
+
+        applyPoolSettings(2);
+        auto tester = PoolTester::create();
+
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->pooled(options), 2)
+
+        tester->idle(Seconds(31));
+        tester->maintain();
+
+        // options no longer asked for are dropped along with their gatherers
+        // and the maintenance timer stops until the next demand
+        TESTING_EQUAL(tester->totalPools(), 0)
+        TESTING_EQUAL(totalClosed(tester->created()), 2)
+        TESTING_CHECK(!tester->hasTimer())
+
+        TESTING_CHECK(!tester->acquire(options))
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_CHECK(tester->hasTimer())
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRemove()
+      {
+        IICEGathererTypes::Options options;
+
+        applyPoolSettings(2);
+        auto tester = PoolTester::create();
+
+        TESTING_CHECK(!tester->acquire(options))
+
+        auto gatherer = tester->front(options);
+        TESTING_CHECK(gatherer)
+        if (!gatherer) return;
+
+        auto subscription = gatherer->lastSubscription();
+
+        tester->notifyClosed(gatherer);
+        TESTING_EQUAL(tester->pooled(options), 1)
+        TESTING_CHECK(tester->front(options) != gatherer)
+        TESTING_CHECK(subscription->isCancelled())
+
+        // the pool is refilled on the next maintenance pass
+        tester->maintain();
+        TESTING_EQUAL(tester->pooled(options), 2)
+        TESTING_EQUAL(tester->created().size(), 3)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::icegathererpool;
+
+void doTestICEGathererPool()
+{
+  if (!ORTC_TEST_DO_ICE_GATHERER_POOL_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testDisabledUntilConfigured();
+  testAcquireAndRefill();
+  testMaxAge();
+  testIdleTimeout();
+  testRemove();
+
+  UseSettings::applyDefaults();
+
+  TESTING_UNINSTALL_LOGGER();
+}
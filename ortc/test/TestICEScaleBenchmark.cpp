@@ -0,0 +1,337 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include "TestLoopbackEndpoint.h"
+
+#include <ortc/internal/ortc_ICEGatherer.h>
+#include <ortc/internal/ortc_ICETransport.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::QWORD;
+using zsLib::Time;
+using zsLib::IMessageQueue;
+using zsLib::string;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace icescalebenchmark
+    {
+      ZS_DECLARE_USING_PTR(ortc::internal, ICEGatherer)
+      ZS_DECLARE_USING_PTR(ortc::internal, ICETransport)
+
+      ZS_DECLARE_USING_PTR(ortc::test::loopback, LoopbackEndpoint)
+
+      typedef std::vector<LoopbackEndpointPtr> EndpointList;
+      typedef std::vector<QWORD> DurationList;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (benchmark)
+      #pragma mark
+
+      struct Totals
+      {
+        size_t mTransports {};
+        size_t mTimers {};
+        size_t mSTUNRequesters {};
+        size_t mLegalRoutes {};
+        size_t mWarmRoutes {};
+        size_t mGathererRoutes {};
+        size_t mSockets {};
+      };
+
+      //-----------------------------------------------------------------------
+      static QWORD percentile(
+                              const DurationList &sorted,
+                              size_t percent
+                              )
+      {
+        if (sorted.size() < 1) return 0;
+        size_t index = (sorted.size() - 1) * percent / 100;
+        return sorted[index];
+      }
+
+      //-----------------------------------------------------------------------
+      static double perTransport(
+                                 size_t value,
+                                 size_t transports
+                                 )
+      {
+        if (0 == transports) return 0.0;
+        return static_cast<double>(value) / static_cast<double>(transports);
+      }
+
+      //-----------------------------------------------------------------------
+      static Totals countResources(const EndpointList &endpoints)
+      {
+        Totals totals;
+
+        for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+          auto transport = ICETransport::convert((*iter)->getICETransport());
+          auto gatherer = ICEGatherer::convert((*iter)->getGatherer());
+          if ((!transport) || (!gatherer)) continue;
+
+          auto transportCounts = transport->getResourceCounts();
+          auto gathererCounts = gatherer->getResourceCounts();
+
+          ++totals.mTransports;
+          totals.mTimers += transportCounts.mTimers + gathererCounts.mTimers;
+          totals.mSTUNRequesters += transportCounts.mSTUNRequesters;
+          totals.mLegalRoutes += transportCounts.mLegalRoutes;
+          totals.mWarmRoutes += transportCounts.mWarmRoutes;
+          totals.mGathererRoutes += gathererCounts.mRoutes;
+          totals.mSockets += gathererCounts.mSockets;
+        }
+
+        return totals;
+      }
+
+      //-----------------------------------------------------------------------
+      static void appendTotals(
+                               ElementPtr resultEl,
+                               const char *prefix,
+                               const Totals &totals
+                               )
+      {
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "TimersPerTransport").c_str(), string(perTransport(totals.mTimers, totals.mTransports))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "STUNRequestersPerTransport").c_str(), string(perTransport(totals.mSTUNRequesters, totals.mTransports))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "LegalRoutesPerTransport").c_str(), string(perTransport(totals.mLegalRoutes, totals.mTransports))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "WarmRoutesPerTransport").c_str(), string(perTransport(totals.mWarmRoutes, totals.mTransports))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "GathererRoutesPerTransport").c_str(), string(perTransport(totals.mGathererRoutes, totals.mTransports))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber((String(prefix) + "SocketsPerTransport").c_str(), string(perTransport(totals.mSockets, totals.mTransports))));
+      }
+
+      //-----------------------------------------------------------------------
+      // Creates totalPairs ICE-only endpoint pairs (each end has its own
+      // gatherer bound to 127.0.0.1), runs connectivity checks to completion
+      // and then holds the pairs connected (consent / keep warm only) for
+      // ORTC_TEST_ICE_SCALE_HOLD_IN_MINUTES.
+      //
+      // A "transport" below is one end: one gatherer plus one ICE transport.
+      // Memory is only measured when ORTC_TEST_COUNT_ALLOCATIONS is enabled
+      // and only covers operator new; idle CPU is process time over the hold
+      // (so includes anything else the process is doing).
+      static void runScale(
+                           IMessageQueuePtr thread,
+                           size_t totalPairs
+                           )
+      {
+        UseSettings::applyDefaults();
+        LoopbackEndpoint::applyLoopbackSettings();
+
+        size_t bytesBefore = Testing::getAllocatedBytes();
+
+        EndpointList endpoints;
+        endpoints.reserve(totalPairs * 2);
+
+        LoopbackEndpoint::Options options;
+        options.mDTLS = false;
+
+        for (size_t index = 0; index < totalPairs; ++index) {
+          options.mRole = IICETypes::Role_Controlling;
+          endpoints.push_back(LoopbackEndpoint::create(thread, options));
+          options.mRole = IICETypes::Role_Controlled;
+          endpoints.push_back(LoopbackEndpoint::create(thread, options));
+        }
+
+        for (size_t index = 0; index < endpoints.size(); index += 2) {
+          endpoints[index]->pair(endpoints[index+1]);
+          endpoints[index+1]->pair(endpoints[index]);
+        }
+
+        Time until = zsLib::now() + zsLib::Seconds(ORTC_TEST_ICE_SCALE_CONNECT_TIMEOUT_IN_SECONDS);
+
+        size_t connected = 0;
+        size_t failed = 0;
+
+        while (zsLib::now() < until) {
+          connected = 0;
+          failed = 0;
+          for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+            auto endpoint = (*iter);
+            if (endpoint->isConnected()) {
+              ++connected;
+              continue;
+            }
+            if (endpoint->hasFailed()) {
+              ++failed;
+              continue;
+            }
+            endpoint->step();
+          }
+          if (connected + failed >= endpoints.size()) break;
+
+          TESTING_SLEEP(50)
+        }
+
+        TESTING_EQUAL(connected, endpoints.size())
+        TESTING_EQUAL(failed, 0)
+
+        DurationList connectTimes;
+        for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+          auto endpoint = (*iter);
+          auto connectedAt = endpoint->iceConnectedTime();
+          if (Time() == connectedAt) continue;
+          connectTimes.push_back(static_cast<QWORD>(zsLib::toMilliseconds(connectedAt - endpoint->createdTime()).count()));
+        }
+        std::sort(connectTimes.begin(), connectTimes.end());
+
+        size_t bytesConnected = Testing::getAllocatedBytes();
+        Totals connectedTotals = countResources(endpoints);
+
+        size_t disconnectsBefore = 0;
+        for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+          disconnectsBefore += (*iter)->totalICEDisconnects();
+        }
+
+        TESTING_STDOUT() << "HOLDING:      " << totalPairs << " pairs connected for " << ORTC_TEST_ICE_SCALE_HOLD_IN_MINUTES << " minute(s).\n";
+
+        Time holdStart = zsLib::now();
+        auto cpuStart = Testing::getProcessCPUTime();
+
+        TESTING_SLEEP(static_cast<QWORD>(ORTC_TEST_ICE_SCALE_HOLD_IN_MINUTES) * 60 * 1000)
+
+        auto cpuEnd = Testing::getProcessCPUTime();
+        auto holdDuration = zsLib::toMilliseconds(zsLib::now() - holdStart);
+
+        size_t bytesHeld = Testing::getAllocatedBytes();
+        Totals heldTotals = countResources(endpoints);
+
+        size_t disconnects = 0;
+        size_t stillConnected = 0;
+        for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+          disconnects += (*iter)->totalICEDisconnects();
+          if ((*iter)->isICEConnected()) ++stillConnected;
+        }
+        disconnects -= disconnectsBefore;
+
+        TESTING_EQUAL(disconnects, 0)
+        TESTING_EQUAL(stillConnected, endpoints.size())
+
+        double cpuMilliseconds = static_cast<double>((cpuEnd - cpuStart).count()) / 1000.0;
+        double holdMilliseconds = static_cast<double>(holdDuration.count());
+
+        ElementPtr resultEl = Element::create("iceScaleBenchmark");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("pairs", string(totalPairs)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("transports", string(endpoints.size())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connected", string(connected)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("failed", string(failed)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectP50Ms", string(percentile(connectTimes, 50))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectP90Ms", string(percentile(connectTimes, 90))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectP99Ms", string(percentile(connectTimes, 99))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectMaxMs", string(connectTimes.size() > 0 ? connectTimes.back() : 0)));
+        if (Testing::isCountingAllocations()) {
+          resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectedBytesPerTransport", string(perTransport(bytesConnected - bytesBefore, endpoints.size()))));
+          resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("heldBytesPerTransport", string(perTransport(bytesHeld - bytesBefore, endpoints.size()))));
+        }
+        appendTotals(resultEl, "connected", connectedTotals);
+        appendTotals(resultEl, "held", heldTotals);
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("holdMs", string(holdDuration.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("idleCpuPercent", string(holdMilliseconds > 0.0 ? cpuMilliseconds * 100.0 / holdMilliseconds : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("idleCpuUsPerTransportPerSecond", string(holdMilliseconds > 0.0 ? (cpuMilliseconds * 1000.0) / (holdMilliseconds / 1000.0) / static_cast<double>(endpoints.size()) : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("holdDisconnects", string(disconnects)));
+
+        Testing::outputBenchmark(resultEl);
+
+        for (auto iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+          (*iter)->close();
+        }
+        endpoints.clear();
+
+        TESTING_SLEEP(2000)
+      }
+    }
+  }
+}
+
+using ortc::IICETypes;
+using namespace ortc::test::icescalebenchmark;
+
+void doTestICEScaleBenchmark()
+{
+  if (!ORTC_TEST_DO_ICE_SCALE_BENCHMARK) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  {
+    static const size_t scales[] = ORTC_TEST_ICE_SCALE_PAIRS;
+
+    for (size_t index = 0; index < (sizeof(scales) / sizeof(scales[0])); ++index) {
+      runScale(thread, scales[index]);
+    }
+  }
+
+  UseSettings::applyDefaults();
+
+  TESTING_SLEEP(2000)
+
+  // wait for shutdown
+  {
+    IMessageQueue::size_type count = 0;
+    do
+    {
+      count = thread->getTotalUnprocessedMessages();
+      if (0 != count)
+        std::this_thread::yield();
+    } while (count > 0);
+
+    thread->waitForShutdown();
+  }
+  TESTING_UNINSTALL_LOGGER();
+  zsLib::proxyDump();
+  TESTING_EQUAL(zsLib::proxyGetTotalConstructed(), 0);
+}
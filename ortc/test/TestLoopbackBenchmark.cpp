@@ -0,0 +1,464 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include "TestLoopbackEndpoint.h"
+
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::QWORD;
+using zsLib::ULONG;
+using zsLib::IMessageQueue;
+using zsLib::AutoRecursiveLock;
+using zsLib::string;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace loopbackbenchmark
+    {
+      ZS_DECLARE_CLASS_PTR(BenchmarkSink)
+
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTCPPacket)
+
+      ZS_DECLARE_USING_PTR(ortc::test::loopback, LoopbackEndpoint)
+      ZS_DECLARE_USING_PTR(ortc::test::loopback, UseListener)
+
+      static const size_t kTimestampSize = sizeof(QWORD);
+
+      //-----------------------------------------------------------------------
+      static QWORD nowInMicroseconds()
+      {
+        return static_cast<QWORD>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark BenchmarkSink
+      #pragma mark
+
+      // Registers with the receiving side's real RTPListener in place of an
+      // RTPReceiver (which would need a media engine) and measures how long
+      // each packet took from the send call to the listener delivering it.
+      class BenchmarkSink : public ortc::internal::RTPReceiver
+      {
+      public:
+        typedef std::vector<DWORD> LatencyList;
+
+      public:
+        //---------------------------------------------------------------------
+        BenchmarkSink(size_t expectedPackets) :
+          RTPReceiver(Noop(true))
+        {
+          mLatencies.reserve(expectedPackets);
+        }
+
+        //---------------------------------------------------------------------
+        ~BenchmarkSink()
+        {
+          mThisWeak.reset();
+          stop();
+        }
+
+        //---------------------------------------------------------------------
+        static BenchmarkSinkPtr create(size_t expectedPackets)
+        {
+          BenchmarkSinkPtr pThis(make_shared<BenchmarkSink>(expectedPackets));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        void attach(
+                    UseListenerPtr listener,
+                    const IRTPTypes::Parameters &params
+                    )
+        {
+          AutoRecursiveLock lock(*this);
+          mListener = listener;
+          mListener->registerReceiver(IMediaStreamTrackTypes::Kind_Audio, mThisWeak.lock(), params);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void stop() override
+        {
+          AutoRecursiveLock lock(*this);
+          if (!mListener) return;
+          mListener->unregisterReceiver(*this);
+          mListener.reset();
+        }
+
+        //---------------------------------------------------------------------
+        virtual ElementPtr toDebug() const override
+        {
+          AutoRecursiveLock lock(*this);
+
+          ElementPtr result = Element::create("ortc::test::loopbackbenchmark::BenchmarkSink");
+
+          UseServicesHelper::debugAppend(result, "id", RTPReceiver::getID());
+          UseServicesHelper::debugAppend(result, "packets", mPackets);
+          UseServicesHelper::debugAppend(result, "bytes", mBytes);
+          UseServicesHelper::debugAppend(result, "listener", mListener ? mListener->getID() : 0);
+
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        virtual bool handlePacket(
+                                  IICETypes::Components viaTransport,
+                                  RTPPacketPtr packet
+                                  ) override
+        {
+          QWORD received = nowInMicroseconds();
+
+          QWORD sent = 0;
+          if (packet->payloadSize() >= kTimestampSize) {
+            memcpy(&sent, packet->payload(), kTimestampSize);
+          }
+
+          AutoRecursiveLock lock(*this);
+
+          ++mPackets;
+          mBytes += packet->size();
+          if ((0 != sent) && (received >= sent)) {
+            mLatencies.push_back(static_cast<DWORD>(received - sent));
+          }
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        virtual bool handlePacket(
+                                  IICETypes::Components viaTransport,
+                                  RTCPPacketPtr packet
+                                  ) override
+        {
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        size_t getPackets() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mPackets;
+        }
+
+        //---------------------------------------------------------------------
+        void reset()
+        {
+          AutoRecursiveLock lock(*this);
+          mPackets = 0;
+          mBytes = 0;
+          mLatencies.clear();
+        }
+
+        //---------------------------------------------------------------------
+        void getResults(
+                        size_t &outPackets,
+                        size_t &outBytes,
+                        LatencyList &outLatencies
+                        ) const
+        {
+          AutoRecursiveLock lock(*this);
+          outPackets = mPackets;
+          outBytes = mBytes;
+          outLatencies = mLatencies;
+        }
+
+      protected:
+        BenchmarkSinkWeakPtr mThisWeak;
+
+        UseListenerPtr mListener;
+
+        size_t mPackets {};
+        size_t mBytes {};
+        LatencyList mLatencies;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (benchmark)
+      #pragma mark
+
+      struct Run
+      {
+        size_t mStreams;
+        size_t mPacketSize;         // bytes including the 12 byte RTP header
+        size_t mPacketsPerSecond;   // all streams combined, 0 = unpaced
+      };
+
+      //-----------------------------------------------------------------------
+      static DWORD percentile(
+                              const BenchmarkSink::LatencyList &sorted,
+                              size_t percent
+                              )
+      {
+        if (sorted.size() < 1) return 0;
+        size_t index = (sorted.size() - 1) * percent / 100;
+        return sorted[index];
+      }
+
+      //-----------------------------------------------------------------------
+      static void runBenchmark(
+                               LoopbackEndpointPtr sender,
+                               LoopbackEndpointPtr receiver,
+                               const Run &run,
+                               ULONG durationInSeconds
+                               )
+      {
+        static const DWORD baseSSRC = 0x10000;
+
+        TESTING_CHECK(run.mStreams > 0)
+        TESTING_CHECK(run.mPacketSize >= 12 + kTimestampSize)
+
+        IICETypes::Components component {IICETypes::Component_RTP};
+        auto transport = sender->getSendingTransport(component);
+        auto listener = receiver->getListener();
+        TESTING_CHECK(transport)
+        TESTING_CHECK(listener)
+        if ((!transport) || (!listener)) return;
+
+        size_t expectedPackets = (0 != run.mPacketsPerSecond ? run.mPacketsPerSecond * durationInSeconds : 100000) + 1000;
+
+        auto sink = BenchmarkSink::create(expectedPackets);
+
+        IRTPTypes::Parameters params;
+        for (size_t index = 0; index < run.mStreams; ++index) {
+          IRTPTypes::EncodingParameters encoding;
+          encoding.mSSRC = baseSSRC + static_cast<DWORD>(index);
+          params.mEncodings.push_back(encoding);
+        }
+        sink->attach(listener, params);
+
+        // one pre-built packet per stream; sequence number, timestamp and
+        // send time are patched in place before each send
+        std::vector<std::vector<BYTE> > packets(run.mStreams);
+        {
+          std::vector<BYTE> payload(run.mPacketSize - 12);
+
+          for (size_t index = 0; index < run.mStreams; ++index) {
+            RTPPacket::CreationParams creationParams;
+            creationParams.mPT = 96;
+            creationParams.mSSRC = baseSSRC + static_cast<DWORD>(index);
+            creationParams.mPayload = &(payload[0]);
+            creationParams.mPayloadSize = payload.size();
+
+            auto packet = RTPPacket::create(creationParams);
+            packets[index].assign(packet->ptr(), packet->ptr() + packet->size());
+          }
+        }
+
+        // warm up so the first run does not pay for route setup
+        for (size_t index = 0; index < run.mStreams; ++index) {
+          transport->sendPacket(component, IICETypes::Component_RTP, &(packets[index][0]), packets[index].size());
+        }
+        TESTING_SLEEP(200)
+        sink->reset();
+
+        size_t sent = 0;
+        size_t failed = 0;
+        WORD sequenceNumber = 0;
+
+        std::clock_t cpuStart = std::clock();
+        QWORD start = nowInMicroseconds();
+        QWORD end = start + (static_cast<QWORD>(durationInSeconds) * 1000000);
+
+        while (true) {
+          QWORD now = nowInMicroseconds();
+          if (now >= end) break;
+
+          size_t due = (0 != run.mPacketsPerSecond ? static_cast<size_t>((now - start) * run.mPacketsPerSecond / 1000000) : sent + run.mStreams);
+          if (due <= sent) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            continue;
+          }
+
+          for (; sent < due; ++sent) {
+            auto &buffer = packets[sent % run.mStreams];
+            if (0 == (sent % run.mStreams)) ++sequenceNumber;
+
+            DWORD timestamp = static_cast<DWORD>(sequenceNumber) * 960;
+            QWORD sendTime = nowInMicroseconds();
+
+            buffer[2] = static_cast<BYTE>(sequenceNumber >> 8);
+            buffer[3] = static_cast<BYTE>(sequenceNumber);
+            buffer[4] = static_cast<BYTE>(timestamp >> 24);
+            buffer[5] = static_cast<BYTE>(timestamp >> 16);
+            buffer[6] = static_cast<BYTE>(timestamp >> 8);
+            buffer[7] = static_cast<BYTE>(timestamp);
+            memcpy(&(buffer[12]), &sendTime, kTimestampSize);
+
+            if (!transport->sendPacket(component, IICETypes::Component_RTP, &(buffer[0]), buffer.size())) ++failed;
+          }
+        }
+
+        QWORD sendDuration = nowInMicroseconds() - start;
+
+        // allow in flight packets to drain (bounded)
+        for (int wait = 0; (wait < 200) && (sink->getPackets() < (sent - failed)); ++wait) {
+          TESTING_SLEEP(10)
+        }
+
+        std::clock_t cpuEnd = std::clock();
+
+        sink->stop();
+
+        size_t received = 0;
+        size_t bytes = 0;
+        BenchmarkSink::LatencyList latencies;
+        sink->getResults(received, bytes, latencies);
+        std::sort(latencies.begin(), latencies.end());
+
+        double seconds = static_cast<double>(sendDuration) / 1000000.0;
+        double cpuMicroseconds = (static_cast<double>(cpuEnd - cpuStart) * 1000000.0) / static_cast<double>(CLOCKS_PER_SEC);
+
+        TESTING_CHECK(received > 0)
+
+        ElementPtr resultEl = Element::create("loopbackBenchmark");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("streams", string(run.mStreams)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetSize", string(run.mPacketSize)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("targetPacketsPerSecond", string(run.mPacketsPerSecond)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("durationMs", string(sendDuration / 1000)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sent", string(sent)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sendFailed", string(failed)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("received", string(received)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetsPerSecond", string(static_cast<QWORD>(static_cast<double>(received) / seconds))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("megabitsPerSecond", string((static_cast<double>(bytes) * 8.0) / seconds / 1000000.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("cpuUsPerPacket", string(received > 0 ? cpuMicroseconds / static_cast<double>(received) : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP50Us", string(percentile(latencies, 50))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP99Us", string(percentile(latencies, 99))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyMaxUs", string(latencies.size() > 0 ? latencies.back() : 0)));
+
+        Testing::outputBenchmark(resultEl);
+      }
+    }
+  }
+}
+
+using ortc::IICETypes;
+using namespace ortc::test::loopbackbenchmark;
+
+void doTestLoopbackBenchmark()
+{
+  if (!ORTC_TEST_DO_LOOPBACK_BENCHMARK) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+  LoopbackEndpoint::applyLoopbackSettings();
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  LoopbackEndpoint::Options options;
+  options.mRole = IICETypes::Role_Controlling;
+  auto endpoint1 = LoopbackEndpoint::create(thread, options);
+  options.mRole = IICETypes::Role_Controlled;
+  auto endpoint2 = LoopbackEndpoint::create(thread, options);
+
+  TESTING_STDOUT() << "WAITING:      Waiting for loopback stacks to connect (max wait is 30 seconds).\n";
+
+  LoopbackEndpoint::connect(endpoint1, endpoint2, zsLib::Seconds(30));
+
+  TESTING_CHECK(endpoint1->isConnected())
+  TESTING_CHECK(endpoint2->isConnected())
+
+  if ((endpoint1->isConnected()) &&
+      (endpoint2->isConnected())) {
+    static const Run runs[] = {
+      {1, 200, 1000},
+      {1, 1200, 5000},
+      {8, 1200, 8000},
+      {32, 1200, 16000},
+      {1, 1200, 0},
+      {8, 200, 0},
+    };
+
+    for (size_t index = 0; index < (sizeof(runs) / sizeof(runs[0])); ++index) {
+      runBenchmark(endpoint1, endpoint2, runs[index], ORTC_TEST_LOOPBACK_BENCHMARK_DURATION_IN_SECONDS);
+    }
+  }
+
+  endpoint1->close();
+  endpoint2->close();
+  endpoint1.reset();
+  endpoint2.reset();
+
+  TESTING_SLEEP(2000)
+
+  // wait for shutdown
+  {
+    IMessageQueue::size_type count = 0;
+    do
+    {
+      count = thread->getTotalUnprocessedMessages();
+      if (0 != count)
+        std::this_thread::yield();
+    } while (count > 0);
+
+    thread->waitForShutdown();
+  }
+  TESTING_UNINSTALL_LOGGER();
+  zsLib::proxyDump();
+  TESTING_EQUAL(zsLib::proxyGetTotalConstructed(), 0);
+}
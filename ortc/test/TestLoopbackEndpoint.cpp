@@ -0,0 +1,590 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include "TestLoopbackEndpoint.h"
+
+#include <ortc/internal/ortc_ICEGatherer.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::AutoRecursiveLock;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace loopback
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      LoopbackEndpoint::LoopbackEndpoint(
+                                         IMessageQueuePtr queue,
+                                         const Options &options
+                                         ) :
+        SharedRecursiveLock(SharedRecursiveLock::create()),
+        MessageQueueAssociator(queue),
+        mOptions(options),
+        mCreated(zsLib::now())
+      {
+        if (mOptions.mSCTP) mOptions.mDTLS = true;
+      }
+
+      //-----------------------------------------------------------------------
+      LoopbackEndpointPtr LoopbackEndpoint::create(
+                                                   IMessageQueuePtr queue,
+                                                   const Options &options
+                                                   )
+      {
+        LoopbackEndpointPtr pThis(make_shared<LoopbackEndpoint>(queue, options));
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::applyLoopbackSettings()
+      {
+        UseSettings::setBool(ORTC_SETTING_GATHERER_LOOPBACK_ONLY, true);
+        UseSettings::setBool(ORTC_SETTING_GATHERER_CREATE_TCP_CANDIDATES, false);
+      }
+
+      //-----------------------------------------------------------------------
+      bool LoopbackEndpoint::connect(
+                                     LoopbackEndpointPtr endpoint1,
+                                     LoopbackEndpointPtr endpoint2,
+                                     Seconds maxWait
+                                     )
+      {
+        endpoint1->pair(endpoint2);
+        endpoint2->pair(endpoint1);
+
+        Time until = zsLib::now() + maxWait;
+
+        while (zsLib::now() < until) {
+          if ((endpoint1->hasFailed()) || (endpoint2->hasFailed())) break;
+          if ((endpoint1->isConnected()) && (endpoint2->isConnected())) return true;
+
+          endpoint1->step();
+          endpoint2->step();
+
+          TESTING_SLEEP(50)
+        }
+
+        return (endpoint1->isConnected()) && (endpoint2->isConnected());
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::pair(LoopbackEndpointPtr remote)
+      {
+        PendingCandidateList candidates;
+        bool complete = false;
+
+        {
+          AutoRecursiveLock lock(*this);
+          mRemote = remote;
+          candidates = mPendingCandidates;
+          mPendingCandidates.clear();
+          complete = mCandidatesComplete;
+        }
+
+        auto remoteTransport = remote->getICETransport();
+        auto remoteGatherer = remote->getGatherer();
+        TESTING_CHECK(remoteTransport)
+        TESTING_CHECK(remoteGatherer)
+        if ((!remoteTransport) || (!remoteGatherer)) return;
+
+        for (auto iter = candidates.begin(); iter != candidates.end(); ++iter) {
+          remoteTransport->addRemoteCandidate(*(*iter));
+        }
+        if (complete) {
+          IICETypes::CandidateComplete candidateComplete;
+          remoteTransport->addRemoteCandidate(candidateComplete);
+        }
+
+        auto remoteParams = remoteGatherer->getLocalParameters();
+        TESTING_CHECK(remoteParams)
+        if (!remoteParams) return;
+
+        IICETransportTypes::Options options;
+        options.mRole = mOptions.mRole;
+
+        AutoRecursiveLock lock(*this);
+        mICETransport->start(mGatherer, *remoteParams, options);
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::step()
+      {
+        LoopbackEndpointPtr remote;
+
+        {
+          AutoRecursiveLock lock(*this);
+          remote = mRemote.lock();
+          if (!remote) return;
+        }
+
+        // the remote's objects are fetched before taking this endpoint's
+        // lock so two endpoints stepping each other cannot deadlock
+        auto remoteDTLS = remote->getDTLSTransport();
+        auto remoteSCTP = remote->getSCTPTransport();
+
+        auto remoteDTLSParams = (remoteDTLS ? remoteDTLS->getLocalParameters() : IDTLSTransportTypes::ParametersPtr());
+
+        AutoRecursiveLock lock(*this);
+
+        if ((mDTLS) &&
+            (!mDTLSStarted) &&
+            (remoteDTLSParams)) {
+          mDTLS->start(*remoteDTLSParams);
+          mDTLSStarted = true;
+        }
+
+        if ((mSCTP) &&
+            (!mSCTPStarted) &&
+            (remoteSCTP)) {
+          mSCTP->start(*ISCTPTransport::getCapabilities(), remoteSCTP->localPort());
+          mSCTPStarted = true;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      bool LoopbackEndpoint::isConnected() const
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (!isICEConnected()) return false;
+        if ((mOptions.mDTLS) && (IDTLSTransportTypes::State_Connected != mDTLSState)) return false;
+        if ((mOptions.mSCTP) && (ISCTPTransport::State_Connected != mSCTPState)) return false;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool LoopbackEndpoint::isICEConnected() const
+      {
+        AutoRecursiveLock lock(*this);
+        return (IICETransport::State_Connected == mICEState) ||
+               (IICETransport::State_Completed == mICEState);
+      }
+
+      //-----------------------------------------------------------------------
+      bool LoopbackEndpoint::hasFailed() const
+      {
+        AutoRecursiveLock lock(*this);
+        if (IICETransport::State_Failed == mICEState) return true;
+        if (IDTLSTransportTypes::State_Failed == mDTLSState) return true;
+        if ((mSCTPStarted) && (ISCTPTransport::State_Closed == mSCTPState)) return true;
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      Time LoopbackEndpoint::createdTime() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mCreated;
+      }
+
+      //-----------------------------------------------------------------------
+      Time LoopbackEndpoint::iceConnectedTime() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mICEConnected;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t LoopbackEndpoint::totalICEDisconnects() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mTotalICEDisconnects;
+      }
+
+      //-----------------------------------------------------------------------
+      IICEGathererPtr LoopbackEndpoint::getGatherer() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mGatherer;
+      }
+
+      //-----------------------------------------------------------------------
+      IICETransportPtr LoopbackEndpoint::getICETransport() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mICETransport;
+      }
+
+      //-----------------------------------------------------------------------
+      IDTLSTransportPtr LoopbackEndpoint::getDTLSTransport() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mDTLS;
+      }
+
+      //-----------------------------------------------------------------------
+      ISCTPTransportPtr LoopbackEndpoint::getSCTPTransport() const
+      {
+        AutoRecursiveLock lock(*this);
+        return mSCTP;
+      }
+
+      //-----------------------------------------------------------------------
+      UseListenerPtr LoopbackEndpoint::getListener() const
+      {
+        auto transport = UseListenerTransport::convert(getDTLSTransport());
+        if (!transport) return UseListenerPtr();
+        return transport->getListener();
+      }
+
+      //-----------------------------------------------------------------------
+      UseSecureTransportPtr LoopbackEndpoint::getSendingTransport(IICETypes::Components &outComponent) const
+      {
+        IICETypes::Components rtcpComponent {IICETypes::Component_RTCP};
+        UseSecureTransportPtr rtpTransport;
+        UseSecureTransportPtr rtcpTransport;
+
+        UseSecureTransport::getSendingTransport(getDTLSTransport(), IRTCPTransportPtr(), outComponent, rtcpComponent, rtpTransport, rtcpTransport);
+        return rtpTransport;
+      }
+
+      //-----------------------------------------------------------------------
+      ortc::internal::NetworkImpairment::Stats LoopbackEndpoint::getImpairmentStats() const
+      {
+        auto gatherer = ortc::internal::ICEGatherer::convert(getGatherer());
+        if (!gatherer) return ortc::internal::NetworkImpairment::Stats();
+        return gatherer->getImpairmentStats();
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::close()
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (mSCTP) mSCTP->stop();
+        if (mDTLS) mDTLS->stop();
+        if (mICETransport) mICETransport->stop();
+        if (mGatherer) mGatherer->close();
+
+        mSCTP.reset();
+        mDTLS.reset();
+        mICETransport.reset();
+        mGatherer.reset();
+        mRemote.reset();
+        mCertificatePromise.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::init()
+      {
+        AutoRecursiveLock lock(*this);
+
+        IICEGathererTypes::Options options;
+        options.mContinuousGathering = false;
+
+        // a single IPv4 path keeps the measurements comparable (and works
+        // on hosts without IPv6)
+        IICEGathererTypes::InterfacePolicy policy;
+        policy.mInterfaceType = "default";
+        policy.mGatherPolicy = IICEGathererTypes::FilterPolicy_NoIPv6;
+        options.mInterfacePolicies.push_back(policy);
+
+        mGatherer = IICEGatherer::create(mThisWeak.lock(), options);
+        mICETransport = IICETransport::create(mThisWeak.lock(), mGatherer);
+
+        if (!mOptions.mDTLS) return;
+
+        mCertificatePromise = ICertificate::generateCertificate();
+        mCertificatePromise->then(mThisWeak.lock());
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => IICEGathererDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICEGathererStateChange(
+                                                      IICEGathererPtr gatherer,
+                                                      IICEGatherer::States state
+                                                      )
+      {
+        ZS_LOG_BASIC(log("gatherer state changed") + ZS_PARAM("state", IICEGatherer::toString(state)))
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICEGathererLocalCandidate(
+                                                         IICEGathererPtr gatherer,
+                                                         CandidatePtr candidate
+                                                         )
+      {
+        TESTING_CHECK(candidate)
+
+        IICETransportPtr remoteTransport;
+
+        {
+          AutoRecursiveLock lock(*this);
+          auto remote = mRemote.lock();
+          if (!remote) {
+            mPendingCandidates.push_back(candidate);
+            return;
+          }
+          remoteTransport = remote->getICETransport();
+        }
+
+        if (remoteTransport) remoteTransport->addRemoteCandidate(*candidate);
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICEGathererLocalCandidateComplete(
+                                                                 IICEGathererPtr gatherer,
+                                                                 CandidateCompletePtr candidate
+                                                                 )
+      {
+        TESTING_CHECK(candidate)
+
+        IICETransportPtr remoteTransport;
+
+        {
+          AutoRecursiveLock lock(*this);
+          auto remote = mRemote.lock();
+          if (!remote) {
+            mCandidatesComplete = true;
+            return;
+          }
+          remoteTransport = remote->getICETransport();
+        }
+
+        if (remoteTransport) remoteTransport->addRemoteCandidate(*candidate);
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICEGathererLocalCandidateGone(
+                                                             IICEGathererPtr gatherer,
+                                                             CandidatePtr candidate
+                                                             )
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICEGathererError(
+                                                IICEGathererPtr gatherer,
+                                                ErrorEventPtr errorEvent
+                                                )
+      {
+        ZS_LOG_ERROR(Basic, log("gatherer error"))
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => IICETransportDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICETransportStateChange(
+                                                       IICETransportPtr transport,
+                                                       IICETransport::States state
+                                                       )
+      {
+        ZS_LOG_BASIC(log("ice transport state changed") + ZS_PARAM("state", IICETransport::toString(state)))
+
+        AutoRecursiveLock lock(*this);
+        mICEState = state;
+
+        switch (state) {
+          case IICETransport::State_Connected:
+          case IICETransport::State_Completed:    {
+            if (Time() == mICEConnected) mICEConnected = zsLib::now();
+            break;
+          }
+          case IICETransport::State_Disconnected: {
+            ++mTotalICEDisconnects;
+            break;
+          }
+          default:                                break;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICETransportCandidatePairAvailable(
+                                                                  IICETransportPtr transport,
+                                                                  CandidatePairPtr candidatePair
+                                                                  )
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICETransportCandidatePairGone(
+                                                             IICETransportPtr transport,
+                                                             CandidatePairPtr candidatePair
+                                                             )
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onICETransportCandidatePairChanged(
+                                                                IICETransportPtr transport,
+                                                                CandidatePairPtr candidatePair
+                                                                )
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => IDTLSTransportDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onDTLSTransportStateChange(
+                                                        IDTLSTransportPtr transport,
+                                                        IDTLSTransport::States state
+                                                        )
+      {
+        ZS_LOG_BASIC(log("dtls transport state changed") + ZS_PARAM("state", IDTLSTransport::toString(state)))
+
+        AutoRecursiveLock lock(*this);
+        mDTLSState = state;
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onDTLSTransportError(
+                                                  IDTLSTransportPtr transport,
+                                                  ErrorAnyPtr error
+                                                  )
+      {
+        ZS_LOG_ERROR(Basic, log("dtls transport error"))
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => ISCTPTransportDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onSCTPTransportStateChange(
+                                                        ISCTPTransportPtr transport,
+                                                        ISCTPTransport::States state
+                                                        )
+      {
+        ZS_LOG_BASIC(log("sctp transport state changed") + ZS_PARAM("state", ISCTPTransport::toString(state)))
+
+        AutoRecursiveLock lock(*this);
+        mSCTPState = state;
+      }
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onSCTPTransportDataChannel(
+                                                        ISCTPTransportPtr transport,
+                                                        IDataChannelPtr channel
+                                                        )
+      {
+        // only negotiated channels are used; anything announced in band is
+        // not expected
+        ZS_LOG_WARNING(Basic, log("unexpected incoming data channel") + ZS_PARAM("channel", channel ? channel->getID() : 0))
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => IPromiseSettledDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void LoopbackEndpoint::onPromiseSettled(PromisePtr promise)
+      {
+        AutoRecursiveLock lock(*this);
+        TESTING_CHECK(promise->isResolved())
+
+        if (!mCertificatePromise) return;
+
+        auto certificate = mCertificatePromise->value();
+        TESTING_CHECK(certificate)
+        if (!certificate) return;
+
+        std::list<ICertificatePtr> certificates;
+        certificates.push_back(certificate);
+
+        mDTLS = IDTLSTransport::create(mThisWeak.lock(), mICETransport, certificates);
+
+        if (!mOptions.mSCTP) return;
+
+        mSCTP = ISCTPTransport::create(mThisWeak.lock(), mDTLS);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      Log::Params LoopbackEndpoint::log(const char *message) const
+      {
+        ElementPtr objectEl = Element::create("ortc::test::loopback::LoopbackEndpoint");
+        UseServicesHelper::debugAppend(objectEl, "id", mID);
+        return Log::Params(message, objectEl);
+      }
+
+    }
+  }
+}
@@ -0,0 +1,277 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#pragma once
+
+#include <ortc/ICertificate.h>
+#include <ortc/IDTLSTransport.h>
+#include <ortc/IICEGatherer.h>
+#include <ortc/IICETransport.h>
+#include <ortc/ISCTPTransport.h>
+
+#include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_NetworkImpairment.h>
+#include <ortc/internal/ortc_RTPListener.h>
+
+#include <zsLib/MessageQueueAssociator.h>
+#include <zsLib/Promise.h>
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace loopback
+    {
+      using zsLib::Log;
+      using zsLib::AutoPUID;
+      using zsLib::Seconds;
+      using zsLib::Time;
+      using zsLib::IPromiseSettledDelegate;
+
+      ZS_DECLARE_CLASS_PTR(LoopbackEndpoint)
+
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::ISecureTransportForRTPSender, UseSecureTransport)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::ISecureTransportForRTPListener, UseListenerTransport)
+      ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IRTPListenerForRTPReceiver, UseListener)
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark LoopbackEndpoint
+      #pragma mark
+
+      // One complete in-process stack bound to 127.0.0.1: ICE gatherer and
+      // ICE transport, optionally a DTLS transport (with the SRTP transport
+      // and RTP listener it owns) and optionally an SCTP transport on top.
+      //
+      // Two endpoints are paired with pair() and then step() is polled on
+      // both until isConnected(); connect() does all of that for one pair.
+      // Data channels must be created negotiated (same id on both sides).
+      class LoopbackEndpoint : public SharedRecursiveLock,
+                               public zsLib::MessageQueueAssociator,
+                               public IICEGathererDelegate,
+                               public IICETransportDelegate,
+                               public IDTLSTransportDelegate,
+                               public ISCTPTransportDelegate,
+                               public IPromiseSettledDelegate
+      {
+      public:
+        struct Options
+        {
+          IICETypes::Roles mRole {IICETypes::Role_Controlling};
+          bool mDTLS {true};
+          bool mSCTP {false};             // requires mDTLS
+        };
+
+        typedef std::list<CandidatePtr> PendingCandidateList;
+
+      public:
+        LoopbackEndpoint(
+                         IMessageQueuePtr queue,
+                         const Options &options
+                         );
+
+        static LoopbackEndpointPtr create(
+                                          IMessageQueuePtr queue,
+                                          const Options &options
+                                          );
+
+        // gather a single 127.0.0.1 UDP host candidate (call after
+        // ISettings::applyDefaults())
+        static void applyLoopbackSettings();
+
+        // pairs both endpoints and waits until both are connected, failed
+        // or the wait runs out
+        static bool connect(
+                            LoopbackEndpointPtr endpoint1,
+                            LoopbackEndpointPtr endpoint2,
+                            Seconds maxWait
+                            );
+
+        void pair(LoopbackEndpointPtr remote);
+        void step();
+
+        bool isConnected() const;
+        bool isICEConnected() const;
+        bool hasFailed() const;
+
+        Time createdTime() const;
+        Time iceConnectedTime() const;      // Time() until ICE first connects
+        size_t totalICEDisconnects() const;
+
+        IICEGathererPtr getGatherer() const;
+        IICETransportPtr getICETransport() const;
+        IDTLSTransportPtr getDTLSTransport() const;
+        ISCTPTransportPtr getSCTPTransport() const;
+
+        UseListenerPtr getListener() const;
+        UseSecureTransportPtr getSendingTransport(IICETypes::Components &outComponent) const;
+
+        ortc::internal::NetworkImpairment::Stats getImpairmentStats() const;
+
+        void close();
+
+      protected:
+        void init();
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => IICEGathererDelegate
+        #pragma mark
+
+        virtual void onICEGathererStateChange(
+                                              IICEGathererPtr gatherer,
+                                              IICEGatherer::States state
+                                              ) override;
+
+        virtual void onICEGathererLocalCandidate(
+                                                 IICEGathererPtr gatherer,
+                                                 CandidatePtr candidate
+                                                 ) override;
+
+        virtual void onICEGathererLocalCandidateComplete(
+                                                         IICEGathererPtr gatherer,
+                                                         CandidateCompletePtr candidate
+                                                         ) override;
+
+        virtual void onICEGathererLocalCandidateGone(
+                                                     IICEGathererPtr gatherer,
+                                                     CandidatePtr candidate
+                                                     ) override;
+
+        virtual void onICEGathererError(
+                                        IICEGathererPtr gatherer,
+                                        ErrorEventPtr errorEvent
+                                        ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => IICETransportDelegate
+        #pragma mark
+
+        virtual void onICETransportStateChange(
+                                               IICETransportPtr transport,
+                                               IICETransport::States state
+                                               ) override;
+
+        virtual void onICETransportCandidatePairAvailable(
+                                                          IICETransportPtr transport,
+                                                          CandidatePairPtr candidatePair
+                                                          ) override;
+
+        virtual void onICETransportCandidatePairGone(
+                                                     IICETransportPtr transport,
+                                                     CandidatePairPtr candidatePair
+                                                     ) override;
+
+        virtual void onICETransportCandidatePairChanged(
+                                                        IICETransportPtr transport,
+                                                        CandidatePairPtr candidatePair
+                                                        ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => IDTLSTransportDelegate
+        #pragma mark
+
+        virtual void onDTLSTransportStateChange(
+                                                IDTLSTransportPtr transport,
+                                                IDTLSTransport::States state
+                                                ) override;
+
+        virtual void onDTLSTransportError(
+                                          IDTLSTransportPtr transport,
+                                          ErrorAnyPtr error
+                                          ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => ISCTPTransportDelegate
+        #pragma mark
+
+        virtual void onSCTPTransportStateChange(
+                                                ISCTPTransportPtr transport,
+                                                ISCTPTransport::States state
+                                                ) override;
+
+        virtual void onSCTPTransportDataChannel(
+                                                ISCTPTransportPtr transport,
+                                                IDataChannelPtr channel
+                                                ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => IPromiseSettledDelegate
+        #pragma mark
+
+        virtual void onPromiseSettled(PromisePtr promise) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark LoopbackEndpoint => (internal)
+        #pragma mark
+
+        Log::Params log(const char *message) const;
+
+      protected:
+        AutoPUID mID;
+        LoopbackEndpointWeakPtr mThisWeak;
+        LoopbackEndpointWeakPtr mRemote;
+
+        Options mOptions;
+        Time mCreated;
+        Time mICEConnected;
+        size_t mTotalICEDisconnects {};
+
+        IICEGathererPtr mGatherer;
+        IICETransportPtr mICETransport;
+        IDTLSTransportPtr mDTLS;
+        ISCTPTransportPtr mSCTP;
+
+        bool mDTLSStarted {false};
+        bool mSCTPStarted {false};
+
+        PendingCandidateList mPendingCandidates;
+        bool mCandidatesComplete {false};
+
+        ICertificateTypes::PromiseWithCertificatePtr mCertificatePromise;
+
+        IICETransport::States mICEState {IICETransport::State_New};
+        IDTLSTransport::States mDTLSState {IDTLSTransport::State_New};
+        ISCTPTransport::States mSCTPState {ISCTPTransport::State_New};
+      };
+
+    }
+  }
+}
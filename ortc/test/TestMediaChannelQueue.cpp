@@ -0,0 +1,237 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+
+#include <ortc/internal/ortc_ORTC.h>
+#include <ortc/internal/ortc_StatsReport.h>
+
+#include <ortc/IORTC.h>
+#include <ortc/IStatsReport.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::IMessageQueue;
+using zsLib::IMessageQueuePtr;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IORTCForInternal, UseORTC)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::MediaChannelLatency, UseLatency)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace mediachannelqueue
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static IStatsReportTypes::MediaChannelStatsPtr getMediaChannelStats()
+      {
+        IStatsProviderTypes::StatsTypeSet stats;
+        stats.insert(IStatsReportTypes::StatsType_MediaChannel);
+
+        auto promise = IORTC::getStats(stats);
+        TESTING_CHECK(promise->isResolved())
+        if (!promise->isResolved()) return IStatsReportTypes::MediaChannelStatsPtr();
+
+        auto report = promise->value();
+        TESTING_CHECK(report)
+        if (!report) return IStatsReportTypes::MediaChannelStatsPtr();
+
+        auto result = IStatsReportTypes::MediaChannelStats::convert(report->getStats(IStatsReportTypes::toString(IStatsReportTypes::StatsType_MediaChannel)));
+        TESTING_CHECK(result)
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testQueuePool()
+      {
+        std::vector<IMessageQueuePtr> queues;
+        std::set<IMessageQueue *> distinct;
+
+        for (size_t index = 0; index < 3*ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS; ++index) {
+          auto queue = UseORTC::queueMediaChannelStartStop();
+          TESTING_CHECK(queue)
+          queues.push_back(queue);
+          distinct.insert(queue.get());
+        }
+
+        // the pool is bounded and handed out round robin
+        TESTING_EQUAL(distinct.size(), ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS)
+        for (size_t index = ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS; index < queues.size(); ++index) {
+          TESTING_CHECK(queues[index] == queues[index - ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS])
+        }
+
+        // media channel work stays off the blocking media start / stop thread
+        TESTING_CHECK(0 == distinct.count(UseORTC::queueBlockingMediaStartStopThread().get()))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testPerResourceOrdering()
+      {
+        static const size_t kResources = 2*ORTC_QUEUE_TOTAL_MEDIA_CHANNEL_THREADS;
+        static const size_t kSteps = 50;
+
+        // each resource keeps the queue it was associated with, so its setup,
+        // updates and shutdown run in the order they were posted even while
+        // other resources use the remaining media channel threads
+        std::vector<IMessageQueuePtr> queues;
+        for (size_t index = 0; index < kResources; ++index) {
+          queues.push_back(UseORTC::queueMediaChannelStartStop());
+        }
+
+        std::mutex lock;
+        std::vector<std::vector<size_t> > executed(kResources);
+        std::atomic<size_t> total {};
+
+        for (size_t step = 0; step < kSteps; ++step) {
+          for (size_t resource = 0; resource < kResources; ++resource) {
+            queues[resource]->postClosure([&lock, &executed, &total, resource, step] {
+              {
+                std::lock_guard<std::mutex> guard(lock);
+                executed[resource].push_back(step);
+              }
+              ++total;
+            });
+          }
+        }
+
+        for (int wait = 0; (wait < 500) && (total.load() < kResources * kSteps); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_EQUAL(total.load(), kResources * kSteps)
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        size_t outOfOrder = 0;
+        for (size_t resource = 0; resource < kResources; ++resource) {
+          auto &steps = executed[resource];
+          TESTING_EQUAL(steps.size(), kSteps)
+          for (size_t index = 0; index < steps.size(); ++index) {
+            if (steps[index] != index) ++outOfOrder;
+          }
+        }
+        TESTING_EQUAL(outOfOrder, 0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMediaChannelStats()
+      {
+        auto before = getMediaChannelStats();
+        if (!before) return;
+
+        TESTING_EQUAL(before->mID, "mediachannel")
+        TESTING_CHECK(before->mStatsType.hasValue())
+        TESTING_CHECK(IStatsReportTypes::StatsType_MediaChannel == before->mStatsType.value())
+
+        // one setup succeeds, one fails, one is still pending
+        for (int index = 0; index < 3; ++index) {
+          UseLatency::notifySetupRequested();
+        }
+        UseLatency::recordSetup(UseLatency::now(), true);
+        UseLatency::recordSetup(UseLatency::now(), false);
+
+        // a resource whose setup was already recorded is not counted again
+        UseLatency::recordSetup(0, true);
+        UseLatency::recordSetup(0, false);
+
+        UseLatency::recordShutdown(UseLatency::now());
+        UseLatency::recordShutdown(0);
+
+        auto after = getMediaChannelStats();
+        if (!after) return;
+
+        TESTING_EQUAL(after->mSetupsRequested, before->mSetupsRequested + 3)
+        TESTING_EQUAL(after->mSetupsSucceeded, before->mSetupsSucceeded + 1)
+        TESTING_EQUAL(after->mSetupsFailed, before->mSetupsFailed + 1)
+        TESTING_EQUAL(after->mSetupsPending, before->mSetupsPending + 1)
+        TESTING_EQUAL(after->mShutdowns, before->mShutdowns + 1)
+        TESTING_EQUAL(after->mSetupLatency.mCount, before->mSetupLatency.mCount + 2)
+        TESTING_EQUAL(after->mShutdownLatency.mCount, before->mShutdownLatency.mCount + 1)
+
+        // the stat survives a round trip through its element form
+        auto copy = IStatsReportTypes::MediaChannelStats::create(after->createElement());
+        TESTING_CHECK(copy)
+        if (!copy) return;
+
+        TESTING_EQUAL(copy->mSetupsRequested, after->mSetupsRequested)
+        TESTING_EQUAL(copy->mSetupsFailed, after->mSetupsFailed)
+        TESTING_EQUAL(copy->mShutdowns, after->mShutdowns)
+        TESTING_EQUAL(copy->mSetupLatency.mCount, after->mSetupLatency.mCount)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::mediachannelqueue;
+
+void doTestMediaChannelQueue()
+{
+  if (!ORTC_TEST_DO_MEDIA_CHANNEL_QUEUE_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testQueuePool();
+  testPerResourceOrdering();
+  testMediaChannelStats();
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -488,6 +488,7 @@ namespace ortc
       int32_t FakeReceiverChannel::getAudioSamples(
                                                    const size_t numberOfSamples,
                                                    const uint8_t numberOfChannels,
+                                                   const uint32_t samplesPerSecond,
                                                    void* audioSamples,
                                                    size_t& numberOfSamplesOut
                                                    )
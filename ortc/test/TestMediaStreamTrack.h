@@ -280,6 +280,7 @@ namespace ortc
         virtual int32_t getAudioSamples(
                                         const size_t numberOfSamples,
                                         const uint8_t numberOfChannels,
+                                        const uint32_t samplesPerSecond,
                                         void* audioSamples,
                                         size_t& numberOfSamplesOut
                                         ) override;
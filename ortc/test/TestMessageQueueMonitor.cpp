@@ -0,0 +1,399 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+#include <ortc/internal/ortc_MessageQueueMonitor.h>
+#include <ortc/internal/ortc_ORTC.h>
+
+#include <ortc/IStatsReport.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::IMessageQueue;
+using zsLib::IMessageQueueMessage;
+using zsLib::IMessageQueueMessageUPtr;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::MessageQueueMonitor, UseMonitor)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IORTCForInternal, UseORTC)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace messagequeuemonitor
+    {
+      ZS_DECLARE_CLASS_PTR(TestMonitor)
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestMonitor
+      #pragma mark
+
+      class TestMonitor : public UseMonitor
+      {
+      public:
+        //---------------------------------------------------------------------
+        bool isSameEntry(
+                         const char *delegateName1,
+                         const char *methodName1,
+                         const char *delegateName2,
+                         const char *methodName2
+                         )
+        {
+          return &(findMethod(delegateName1, methodName1)) == &(findMethod(delegateName2, methodName2));
+        }
+
+        //---------------------------------------------------------------------
+        bool isOtherEntry(
+                          const char *delegateName,
+                          const char *methodName
+                          )
+        {
+          return &(findMethod(delegateName, methodName)) == &mOtherMethods;
+        }
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestMessage
+      #pragma mark
+
+      class TestMessage : public IMessageQueueMessage
+      {
+      public:
+        //---------------------------------------------------------------------
+        TestMessage(
+                    const char *delegateName,
+                    const char *methodName,
+                    std::atomic<size_t> &processed
+                    ) :
+          mDelegateName(delegateName),
+          mMethodName(methodName),
+          mProcessed(processed)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual const char *getDelegateName() const override {return mDelegateName;}
+        virtual const char *getMethodName() const override {return mMethodName;}
+        virtual void processMessage() override {++mProcessed;}
+
+      protected:
+        const char *mDelegateName {};
+        const char *mMethodName {};
+        std::atomic<size_t> &mProcessed;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark BlockingMessage
+      #pragma mark
+
+      class BlockingMessage : public TestMessage
+      {
+      public:
+        //---------------------------------------------------------------------
+        BlockingMessage(
+                        std::atomic<bool> &release,
+                        std::atomic<size_t> &processed
+                        ) :
+          TestMessage("TestBlockingDelegate", "onBlock", processed),
+          mRelease(release)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void processMessage() override
+        {
+          for (int wait = 0; (wait < 500) && (!mRelease.load()); ++wait) {
+            TESTING_SLEEP(10)
+          }
+          TestMessage::processMessage();
+        }
+
+      protected:
+        std::atomic<bool> &mRelease;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static IStatsReportTypes::MessageQueueStatsPtr getQueueStats(UseMonitor::Queues queue)
+      {
+        IStatsProviderTypes::StatsTypeSet stats;
+        stats.insert(IStatsReportTypes::StatsType_MessageQueue);
+
+        auto promise = UseMonitor::getStats(stats);
+        TESTING_CHECK(promise->isResolved())
+        if (!promise->isResolved()) return IStatsReportTypes::MessageQueueStatsPtr();
+
+        auto report = promise->value();
+        TESTING_CHECK(report)
+        if (!report) return IStatsReportTypes::MessageQueueStatsPtr();
+
+        String id = String(IStatsReportTypes::toString(IStatsReportTypes::StatsType_MessageQueue)) + "_" + UseMonitor::toString(queue);
+        auto result = IStatsReportTypes::MessageQueueStats::convert(report->getStats(id));
+        TESTING_CHECK(result)
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testMethodKeys()
+      {
+        auto monitor = make_shared<TestMonitor>();
+
+        // methods are keyed by the addresses of their names; identical
+        // names stored at different addresses are only merged when the
+        // stats are created
+        static char delegateName1[] = "TestDelegate";
+        static char delegateName2[] = "TestDelegate";
+        static char methodName1[] = "onTest";
+        static char methodName2[] = "onTest";
+        static char otherMethodName[] = "onOther";
+
+        TESTING_CHECK(delegateName1 != delegateName2)
+        TESTING_CHECK(monitor->isSameEntry(delegateName1, methodName1, delegateName1, methodName1))
+        TESTING_CHECK(!monitor->isSameEntry(delegateName1, methodName1, delegateName2, methodName2))
+        TESTING_CHECK(!monitor->isSameEntry(delegateName1, methodName1, delegateName1, otherMethodName))
+
+        // the delegate / method boundary is part of the key
+        TESTING_CHECK(!monitor->isSameEntry("ab", "c", "a", "bc"))
+
+        TESTING_CHECK(monitor->isSameEntry(NULL, NULL, NULL, NULL))
+        TESTING_CHECK(!monitor->isSameEntry(NULL, methodName1, "", methodName1))
+
+        // once the table is full further methods share the overflow entry
+        std::vector<std::string> names;
+        for (size_t index = 0; index < UseMonitor::kMaxMethods + 10; ++index) {
+          names.push_back("method" + std::to_string(index));
+        }
+        size_t overflowed = 0;
+        for (auto iter = names.begin(); iter != names.end(); ++iter) {
+          if (monitor->isOtherEntry("TestDelegate", (*iter).c_str())) ++overflowed;
+        }
+        TESTING_CHECK(overflowed >= 10)
+        TESTING_CHECK(!monitor->isOtherEntry(delegateName2, methodName2))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMonitoredQueue()
+      {
+        auto thread(zsLib::IMessageQueueThread::createBasic());
+
+        UseSettings::setBool(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_ENABLED, false);
+        TESTING_CHECK(UseMonitor::monitor(UseMonitor::Queue_CertificateGeneration, thread) == thread)
+
+        UseSettings::setBool(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_ENABLED, true);
+        auto queue = UseMonitor::monitor(UseMonitor::Queue_CertificateGeneration, thread);
+        TESTING_CHECK(queue)
+        TESTING_CHECK(queue != thread)
+
+        auto before = getQueueStats(UseMonitor::Queue_CertificateGeneration);
+
+        static char delegateName1[] = "TestMonitoredQueueDelegate";
+        static char delegateName2[] = "TestMonitoredQueueDelegate";
+        static const size_t kMessages = 10;
+
+        std::atomic<size_t> processed {};
+        for (size_t index = 0; index < kMessages; ++index) {
+          const char *delegateName = (0 == (index % 2) ? delegateName1 : delegateName2);
+          queue->post(IMessageQueueMessageUPtr(new TestMessage(delegateName, "onTest", processed)));
+        }
+
+        for (int wait = 0; (wait < 500) && (processed.load() < kMessages); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_EQUAL(processed.load(), kMessages)
+
+        auto after = getQueueStats(UseMonitor::Queue_CertificateGeneration);
+        if ((before) && (after)) {
+          TESTING_CHECK(after->mPosted >= before->mPosted + kMessages)
+          TESTING_CHECK(after->mProcessed >= before->mProcessed + kMessages)
+
+          // both delegate name copies are reported as a single method
+          size_t found = 0;
+          for (auto iter = after->mTopMethods.begin(); iter != after->mTopMethods.end(); ++iter) {
+            auto &method = (*iter);
+            if (method.mDelegateName != delegateName1) continue;
+            ++found;
+            TESTING_EQUAL(method.mMethodName, "onTest")
+            TESTING_EQUAL(method.mCount, kMessages)
+          }
+          TESTING_EQUAL(found, 1)
+        }
+
+        thread->waitForShutdown();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMessagePool()
+      {
+        auto thread(zsLib::IMessageQueueThread::createBasic());
+        auto queue = UseMonitor::monitor(UseMonitor::Queue_CertificateGeneration, thread);
+        TESTING_CHECK(queue != thread)
+
+        auto before = getQueueStats(UseMonitor::Queue_CertificateGeneration);
+
+        // hold the thread so more wrappers are outstanding than the pool
+        // holds; the extra wrappers fall back to the heap
+        static const size_t kMessages = UseMonitor::kMessagePoolSize + 10;
+
+        std::atomic<bool> release {};
+        std::atomic<size_t> processed {};
+        queue->post(IMessageQueueMessageUPtr(new BlockingMessage(release, processed)));
+        for (size_t index = 0; index < kMessages; ++index) {
+          queue->post(IMessageQueueMessageUPtr(new TestMessage("TestPoolDelegate", "onTest", processed)));
+        }
+        release = true;
+
+        for (int wait = 0; (wait < 500) && (processed.load() < kMessages + 1); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_EQUAL(processed.load(), kMessages + 1)
+
+        // the returned wrappers are handed out again
+        for (size_t index = 0; index < kMessages; ++index) {
+          queue->post(IMessageQueueMessageUPtr(new TestMessage("TestPoolDelegate", "onTest", processed)));
+        }
+
+        for (int wait = 0; (wait < 500) && (processed.load() < (2 * kMessages) + 1); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_EQUAL(processed.load(), (2 * kMessages) + 1)
+
+        auto after = getQueueStats(UseMonitor::Queue_CertificateGeneration);
+        if ((before) && (after)) {
+          TESTING_CHECK(after->mPosted >= before->mPosted + (2 * kMessages) + 1)
+          TESTING_CHECK(after->mProcessed >= before->mProcessed + (2 * kMessages) + 1)
+          TESTING_CHECK(after->mPeakDepth >= kMessages)
+        }
+
+        thread->waitForShutdown();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testStrandPerObject()
+      {
+        auto queue1 = UseORTC::queueORTC();
+        auto queue2 = UseORTC::queueORTC();
+
+        // each object is given its own strand so one slow object cannot
+        // hold up unrelated objects' messages
+        TESTING_CHECK(queue1)
+        TESTING_CHECK(queue2)
+        TESTING_CHECK(queue1 != queue2)
+        TESTING_CHECK(UseORTC::queueORTCPipeline() != UseORTC::queueORTCPipeline())
+
+        if ((!queue1) || (!queue2)) return;
+
+        auto before = getQueueStats(UseMonitor::Queue_ORTC);
+
+        static const size_t kMessages = 10;
+
+        std::atomic<size_t> processed {};
+        for (size_t index = 0; index < kMessages; ++index) {
+          auto queue = (0 == (index % 2) ? queue1 : queue2);
+          queue->post(IMessageQueueMessageUPtr(new TestMessage("TestStrandDelegate", "onTest", processed)));
+        }
+
+        for (int wait = 0; (wait < 500) && (processed.load() < kMessages); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_EQUAL(processed.load(), kMessages)
+
+        // but every strand of the pool is reported under the one queue kind
+        auto after = getQueueStats(UseMonitor::Queue_ORTC);
+        if ((before) && (after)) {
+          TESTING_CHECK(after->mPosted >= before->mPosted + kMessages)
+          TESTING_CHECK(after->mProcessed >= before->mProcessed + kMessages)
+        }
+      }
+    }
+  }
+}
+
+using namespace ortc::test::messagequeuemonitor;
+
+void doTestMessageQueueMonitor()
+{
+  if (!ORTC_TEST_DO_MESSAGE_QUEUE_MONITOR_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+  UseSettings::setUInt(ORTC_SETTING_MESSAGE_QUEUE_MONITOR_TOP_METHODS, UseMonitor::kMaxMethods);
+
+  testMethodKeys();
+  testMonitoredQueue();
+  testMessagePool();
+  testStrandPerObject();
+
+  UseSettings::applyDefaults();
+
+  TESTING_UNINSTALL_LOGGER();
+}
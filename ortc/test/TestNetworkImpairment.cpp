@@ -0,0 +1,635 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include "TestLoopbackEndpoint.h"
+
+#include <ortc/IDataChannel.h>
+
+#include <ortc/internal/ortc_NetworkImpairment.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::BYTE;
+using zsLib::DWORD;
+using zsLib::QWORD;
+using zsLib::ULONG;
+using zsLib::Time;
+using zsLib::Milliseconds;
+using zsLib::IMessageQueue;
+using zsLib::AutoRecursiveLock;
+using zsLib::string;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace networkimpairment
+    {
+      ZS_DECLARE_CLASS_PTR(MessageSink)
+
+      ZS_DECLARE_USING_PTR(ortc::internal, NetworkImpairment)
+      ZS_DECLARE_USING_PTR(ortc::test::loopback, LoopbackEndpoint)
+
+      static const size_t kHeaderSize = sizeof(DWORD) + sizeof(QWORD);   // sequence + send time
+
+      //-----------------------------------------------------------------------
+      static QWORD nowInMicroseconds()
+      {
+        return static_cast<QWORD>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark MessageSink
+      #pragma mark
+
+      // Data channel delegate for both ends of the measured channel. The
+      // receiving end records how long each message took from the send call
+      // (the send time is carried in the message itself).
+      class MessageSink : public SharedRecursiveLock,
+                          public zsLib::MessageQueueAssociator,
+                          public IDataChannelDelegate
+      {
+      public:
+        typedef std::vector<DWORD> LatencyList;
+
+      public:
+        //---------------------------------------------------------------------
+        MessageSink(IMessageQueuePtr queue) :
+          SharedRecursiveLock(SharedRecursiveLock::create()),
+          MessageQueueAssociator(queue)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static MessageSinkPtr create(IMessageQueuePtr queue)
+        {
+          return make_shared<MessageSink>(queue);
+        }
+
+        //---------------------------------------------------------------------
+        bool isOpen() const
+        {
+          AutoRecursiveLock lock(*this);
+          return IDataChannelTypes::State_Open == mState;
+        }
+
+        //---------------------------------------------------------------------
+        size_t getMessages() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mMessages;
+        }
+
+        //---------------------------------------------------------------------
+        void getResults(
+                        size_t &outMessages,
+                        size_t &outBytes,
+                        size_t &outOutOfOrder,
+                        QWORD &outLastReceived,
+                        LatencyList &outLatencies
+                        ) const
+        {
+          AutoRecursiveLock lock(*this);
+          outMessages = mMessages;
+          outBytes = mBytes;
+          outOutOfOrder = mOutOfOrder;
+          outLastReceived = mLastReceived;
+          outLatencies = mLatencies;
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark MessageSink => IDataChannelDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelStateChange(
+                                              IDataChannelPtr channel,
+                                              IDataChannelTypes::States state
+                                              ) override
+        {
+          AutoRecursiveLock lock(*this);
+          mState = state;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelError(
+                                        IDataChannelPtr channel,
+                                        ErrorAnyPtr error
+                                        ) override
+        {
+          TESTING_CHECK(false)
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelBufferedAmountLow(IDataChannelPtr channel) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelMessage(
+                                          IDataChannelPtr channel,
+                                          MessageEventDataPtr data
+                                          ) override
+        {
+          QWORD received = nowInMicroseconds();
+
+          TESTING_CHECK(data)
+          if (!data) return;
+          TESTING_CHECK(data->mBinary)
+          if (!data->mBinary) return;
+
+          auto buffer = data->mBinary;
+          if (buffer->SizeInBytes() < kHeaderSize) return;
+
+          DWORD sequence = 0;
+          QWORD sent = 0;
+          memcpy(&sequence, buffer->BytePtr(), sizeof(sequence));
+          memcpy(&sent, buffer->BytePtr() + sizeof(sequence), sizeof(sent));
+
+          AutoRecursiveLock lock(*this);
+
+          if (sequence != mNextSequence) ++mOutOfOrder;
+          mNextSequence = sequence + 1;
+
+          ++mMessages;
+          mBytes += buffer->SizeInBytes();
+          mLastReceived = received;
+          if (received >= sent) {
+            mLatencies.push_back(static_cast<DWORD>(received - sent));
+          }
+        }
+
+      protected:
+        IDataChannelTypes::States mState {IDataChannelTypes::State_Connecting};
+
+        DWORD mNextSequence {};
+        size_t mMessages {};
+        size_t mBytes {};
+        size_t mOutOfOrder {};
+        QWORD mLastReceived {};
+        LatencyList mLatencies;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (impairment)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static size_t scheduleAll(
+                                const NetworkImpairment::Parameters &params,
+                                size_t totalPackets,
+                                size_t packetSize,
+                                Milliseconds interval,
+                                std::vector<QWORD> &outSendTimes,     // microseconds after the first packet
+                                NetworkImpairment::Stats &outStats
+                                )
+      {
+        auto impairment = NetworkImpairment::create(params);
+        TESTING_CHECK(impairment)
+        if (!impairment) return 0;
+
+        Time start = zsLib::now();
+        Time now = start;
+        Time sendAt[NetworkImpairment::ScheduleLimit_MaxCopies] {};
+
+        outSendTimes.clear();
+        for (size_t index = 0; index < totalPackets; ++index) {
+          auto copies = impairment->schedule(now, packetSize, sendAt);
+          TESTING_CHECK(copies <= NetworkImpairment::ScheduleLimit_MaxCopies)
+          for (size_t copy = 0; copy < copies; ++copy) {
+            TESTING_CHECK(sendAt[copy] >= now)
+            outSendTimes.push_back(static_cast<QWORD>(zsLib::toMicroseconds(sendAt[copy] - start).count()));
+          }
+          now += interval;
+        }
+
+        outStats = impairment->stats();
+        TESTING_EQUAL(outStats.mPacketsSubmitted, totalPackets)
+        TESTING_EQUAL(outStats.mPacketsScheduled, outSendTimes.size())
+        return outSendTimes.size();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testImpairment()
+      {
+        static const size_t kPackets = 10000;
+
+        std::vector<QWORD> times1;
+        std::vector<QWORD> times2;
+        NetworkImpairment::Stats stats;
+
+        // disabled means no impairment object at all
+        {
+          NetworkImpairment::Parameters params;
+          TESTING_CHECK(!NetworkImpairment::create(params))
+        }
+
+        // enabled with nothing set passes everything through unchanged
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          TESTING_EQUAL(scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats), kPackets)
+          TESTING_EQUAL(stats.mBytesScheduled, stats.mBytesSubmitted)
+        }
+
+        // the same seed always makes the same decisions
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mSeed = 42;
+          params.mLossPerMille = 20;
+          params.mBurstLossPerMille = 300;
+          params.mDelay = Milliseconds(30);
+          params.mJitter = Milliseconds(10);
+          params.mReorderPerMille = 10;
+          params.mDuplicatePerMille = 10;
+
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times2, stats);
+          TESTING_CHECK(times1 == times2)
+
+          params.mSeed = 43;
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times2, stats);
+          TESTING_CHECK(times1 != times2)
+        }
+
+        // independent loss lands near the requested rate
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mLossPerMille = 100;
+
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          TESTING_CHECK(stats.mPacketsLost > kPackets * 8 / 100)
+          TESTING_CHECK(stats.mPacketsLost < kPackets * 12 / 100)
+        }
+
+        // bursty loss loses more packets in longer runs
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mLossPerMille = 10;
+          params.mBurstLossPerMille = 800;
+
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          TESTING_CHECK(stats.mPacketsLost > kPackets * 3 / 100)
+        }
+
+        // duplicates are counted and scheduled twice
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mDuplicatePerMille = 50;
+
+          auto total = scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          TESTING_CHECK(stats.mPacketsDuplicated > kPackets * 3 / 100)
+          TESTING_EQUAL(total, kPackets + stats.mPacketsDuplicated)
+        }
+
+        // jitter alone never reorders; reordering does
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mDelay = Milliseconds(20);
+          params.mJitter = Milliseconds(15);
+
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          TESTING_CHECK(std::is_sorted(times1.begin(), times1.end()))
+
+          params.mReorderPerMille = 50;
+          params.mReorderDelay = Milliseconds(10);
+
+          scheduleAll(params, kPackets, 1000, Milliseconds(1), times1, stats);
+          TESTING_CHECK(stats.mPacketsReordered > 0)
+          TESTING_CHECK(!std::is_sorted(times1.begin(), times1.end()))
+        }
+
+        // the bandwidth cap spaces packets by their serialisation time and
+        // drops once the queue is full
+        {
+          NetworkImpairment::Parameters params;
+          params.mEnabled = true;
+          params.mBandwidthInKbitsPerSecond = 1000;     // 1250 bytes = 10ms
+          params.mQueueSizeInBytes = 1250 * 5;
+
+          auto total = scheduleAll(params, 20, 1250, Milliseconds(), times1, stats);
+          TESTING_CHECK(total > 0)
+          TESTING_CHECK(total < 20)
+          TESTING_EQUAL(total + stats.mPacketsDropped, 20)
+
+          for (size_t index = 1; index < times1.size(); ++index) {
+            TESTING_EQUAL(times1[index] - times1[index-1], 10000)
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (benchmark)
+      #pragma mark
+
+      struct Profile
+      {
+        const char *mName;
+        ULONG mLossPerMille;
+        ULONG mBurstLossPerMille;
+        ULONG mDelayInMilliseconds;       // each direction
+        ULONG mJitterInMilliseconds;
+        ULONG mReorderPerMille;
+        ULONG mDuplicatePerMille;
+        ULONG mBandwidthInKbitsPerSecond;
+      };
+
+      //-----------------------------------------------------------------------
+      static DWORD percentile(
+                              const MessageSink::LatencyList &sorted,
+                              size_t percent
+                              )
+      {
+        if (sorted.size() < 1) return 0;
+        size_t index = (sorted.size() - 1) * percent / 100;
+        return sorted[index];
+      }
+
+      //-----------------------------------------------------------------------
+      static void applyProfile(const Profile &profile)
+      {
+        UseSettings::setBool(ORTC_SETTING_NETWORK_IMPAIRMENT_ENABLED, true);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_SEED, ORTC_TEST_NETWORK_IMPAIRMENT_SEED);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_LOSS_PER_MILLE, profile.mLossPerMille);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BURST_LOSS_PER_MILLE, profile.mBurstLossPerMille);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DELAY_IN_MILLISECONDS, profile.mDelayInMilliseconds);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_JITTER_IN_MILLISECONDS, profile.mJitterInMilliseconds);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_REORDER_PER_MILLE, profile.mReorderPerMille);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_DUPLICATE_PER_MILLE, profile.mDuplicatePerMille);
+        UseSettings::setUInt(ORTC_SETTING_NETWORK_IMPAIRMENT_BANDWIDTH_IN_KBITS_PER_SECOND, profile.mBandwidthInKbitsPerSecond);
+      }
+
+      //-----------------------------------------------------------------------
+      // Sends ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGES reliable, ordered data
+      // channel messages across two loopback stacks whose gatherers impair
+      // everything they send (so both directions are impaired).
+      //
+      // goodput         payload bytes delivered per second of transfer
+      // recovery        latency the tail adds over the median (p99 - p50);
+      //                 on a reliable ordered channel every loss shows up
+      //                 as a head of line stall until SCTP retransmits
+      // overhead        bytes put on the wire per payload byte, relative to
+      //                 the unimpaired run (so headers cancel out and what
+      //                 remains is retransmission)
+      static void runProfile(
+                             IMessageQueuePtr thread,
+                             const Profile &profile,
+                             double &ioCleanWireBytesPerPayloadByte
+                             )
+      {
+        static const size_t kMaxBufferedAmount = 64 * 1024;
+
+        UseSettings::applyDefaults();
+        LoopbackEndpoint::applyLoopbackSettings();
+        applyProfile(profile);
+
+        LoopbackEndpoint::Options options;
+        options.mSCTP = true;
+        options.mRole = IICETypes::Role_Controlling;
+        auto sender = LoopbackEndpoint::create(thread, options);
+        options.mRole = IICETypes::Role_Controlled;
+        auto receiver = LoopbackEndpoint::create(thread, options);
+
+        Time connectStart = zsLib::now();
+        bool connected = LoopbackEndpoint::connect(sender, receiver, zsLib::Seconds(60));
+        auto connectTime = zsLib::toMilliseconds(zsLib::now() - connectStart);
+        TESTING_CHECK(connected)
+
+        auto senderSink = MessageSink::create(thread);
+        auto receiverSink = MessageSink::create(thread);
+
+        IDataChannelPtr senderChannel;
+        IDataChannelPtr receiverChannel;
+
+        if (connected) {
+          IDataChannel::Parameters params;
+          params.mLabel = "impairment";
+          params.mNegotiated = true;
+          params.mID = 1;
+
+          senderChannel = IDataChannel::create(senderSink, sender->getSCTPTransport(), params);
+          receiverChannel = IDataChannel::create(receiverSink, receiver->getSCTPTransport(), params);
+
+          for (int wait = 0; (wait < 300) && ((!senderSink->isOpen()) || (!receiverSink->isOpen())); ++wait) {
+            TESTING_SLEEP(100)
+          }
+          TESTING_CHECK(senderSink->isOpen())
+          TESTING_CHECK(receiverSink->isOpen())
+        }
+
+        size_t sent = 0;
+        QWORD start = nowInMicroseconds();
+
+        if ((senderSink->isOpen()) &&
+            (receiverSink->isOpen())) {
+          SecureByteBlock message(ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGE_SIZE);
+
+          QWORD giveUp = start + (static_cast<QWORD>(ORTC_TEST_NETWORK_IMPAIRMENT_MAX_SECONDS) * 1000000);
+
+          while ((sent < ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGES) &&
+                 (nowInMicroseconds() < giveUp)) {
+            if (senderChannel->bufferedAmount() > kMaxBufferedAmount) {
+              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+              continue;
+            }
+
+            DWORD sequence = static_cast<DWORD>(sent);
+            QWORD sendTime = nowInMicroseconds();
+            memcpy(message.BytePtr(), &sequence, sizeof(sequence));
+            memcpy(message.BytePtr() + sizeof(sequence), &sendTime, sizeof(sendTime));
+
+            senderChannel->send(message);
+            ++sent;
+          }
+
+          while ((receiverSink->getMessages() < sent) &&
+                 (nowInMicroseconds() < giveUp)) {
+            TESTING_SLEEP(10)
+          }
+        }
+
+        size_t received = 0;
+        size_t bytes = 0;
+        size_t outOfOrder = 0;
+        QWORD lastReceived = 0;
+        MessageSink::LatencyList latencies;
+        receiverSink->getResults(received, bytes, outOfOrder, lastReceived, latencies);
+        std::sort(latencies.begin(), latencies.end());
+
+        TESTING_EQUAL(received, sent)
+        TESTING_EQUAL(outOfOrder, 0)
+
+        auto senderStats = sender->getImpairmentStats();
+        auto receiverStats = receiver->getImpairmentStats();
+
+        double seconds = (lastReceived > start ? static_cast<double>(lastReceived - start) / 1000000.0 : 0.0);
+        double wireBytesPerPayloadByte = (bytes > 0 ? static_cast<double>(senderStats.mBytesSubmitted) / static_cast<double>(bytes) : 0.0);
+        if (0 == profile.mLossPerMille + profile.mDuplicatePerMille + profile.mReorderPerMille + profile.mBandwidthInKbitsPerSecond + profile.mDelayInMilliseconds) {
+          ioCleanWireBytesPerPayloadByte = wireBytesPerPayloadByte;
+        }
+
+        ElementPtr resultEl = Element::create("networkImpairmentBenchmark");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithTextAndJSONEncode("profile", profile.mName));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("seed", string(ORTC_TEST_NETWORK_IMPAIRMENT_SEED)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("messageSize", string(ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGE_SIZE)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("connectMs", string(connectTime.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sent", string(sent)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("received", string(received)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("goodputKbps", string(seconds > 0.0 ? (static_cast<double>(bytes) * 8.0) / seconds / 1000.0 : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP50Ms", string(percentile(latencies, 50) / 1000)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP99Ms", string(percentile(latencies, 99) / 1000)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyMaxMs", string(latencies.size() > 0 ? latencies.back() / 1000 : 0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("recoveryLatencyMs", string((percentile(latencies, 99) - percentile(latencies, 50)) / 1000)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("wireBytesPerPayloadByte", string(wireBytesPerPayloadByte)));
+        if (ioCleanWireBytesPerPayloadByte > 0.0) {
+          resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("retransmissionOverheadPercent", string(((wireBytesPerPayloadByte / ioCleanWireBytesPerPayloadByte) - 1.0) * 100.0)));
+        }
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetsLost", string(senderStats.mPacketsLost + receiverStats.mPacketsLost)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetsDropped", string(senderStats.mPacketsDropped + receiverStats.mPacketsDropped)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetsDuplicated", string(senderStats.mPacketsDuplicated + receiverStats.mPacketsDuplicated)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("packetsReordered", string(senderStats.mPacketsReordered + receiverStats.mPacketsReordered)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("iceDisconnects", string(sender->totalICEDisconnects() + receiver->totalICEDisconnects())));
+
+        Testing::outputBenchmark(resultEl);
+
+        if (senderChannel) senderChannel->close();
+        if (receiverChannel) receiverChannel->close();
+
+        sender->close();
+        receiver->close();
+
+        TESTING_SLEEP(1000)
+      }
+    }
+  }
+}
+
+using ortc::IICETypes;
+using namespace ortc::test::networkimpairment;
+
+void doTestNetworkImpairment()
+{
+  if (!ORTC_TEST_DO_NETWORK_IMPAIRMENT_TEST) return;
+
+  testImpairment();
+}
+
+void doTestNetworkImpairmentBenchmark()
+{
+  if (!ORTC_TEST_DO_NETWORK_IMPAIRMENT_BENCHMARK) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  {
+    // the unimpaired run must be first; it is the baseline for overhead
+    static const Profile profiles[] = {
+      {"clean", 0, 0, 0, 0, 0, 0, 0},
+      {"loss 1%", 10, 0, 0, 0, 0, 0, 0},
+      {"loss 5%", 50, 0, 0, 0, 0, 0, 0},
+      {"burst loss 2% x 50%", 20, 500, 0, 0, 0, 0, 0},
+      {"rtt 100ms jitter 10ms", 0, 0, 50, 10, 0, 0, 0},
+      {"rtt 100ms loss 2% reorder 2%", 20, 0, 50, 5, 20, 0, 0},
+      {"duplicate 5%", 0, 0, 0, 0, 0, 50, 0},
+      {"bandwidth 2Mbps rtt 40ms", 0, 0, 20, 0, 0, 0, 2000},
+    };
+
+    double cleanWireBytesPerPayloadByte = 0.0;
+
+    for (size_t index = 0; index < (sizeof(profiles) / sizeof(profiles[0])); ++index) {
+      TESTING_STDOUT() << "PROFILE:      " << profiles[index].mName << "\n";
+      runProfile(thread, profiles[index], cleanWireBytesPerPayloadByte);
+    }
+  }
+
+  UseSettings::applyDefaults();
+
+  TESTING_SLEEP(2000)
+
+  // wait for shutdown
+  {
+    IMessageQueue::size_type count = 0;
+    do
+    {
+      count = thread->getTotalUnprocessedMessages();
+      if (0 != count)
+        std::this_thread::yield();
+    } while (count > 0);
+
+    thread->waitForShutdown();
+  }
+  TESTING_UNINSTALL_LOGGER();
+  zsLib::proxyDump();
+  TESTING_EQUAL(zsLib::proxyGetTotalConstructed(), 0);
+}
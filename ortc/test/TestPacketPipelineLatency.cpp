@@ -0,0 +1,310 @@
+/*
+ 
+ Copyright (c) 2016, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_StatsReport.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <thread>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::QWORD;
+
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::LatencyHistogram, UseHistogram)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::PacketPipelineLatency, UsePipeline)
+ZS_DECLARE_TYPEDEF_PTR(ortc::IStatsReportTypes::PacketPipelineStats, UsePipelineStats)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace packetpipelinelatency
+    {
+      typedef UseHistogram::HopLatency HopLatency;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark HistogramTester
+      #pragma mark
+
+      class HistogramTester : public UseHistogram
+      {
+      public:
+        using UseHistogram::toBucket;
+        using UseHistogram::bucketLowestValue;
+        using UseHistogram::bucketHighestValue;
+
+        //---------------------------------------------------------------------
+        HopLatency latency() const
+        {
+          HopLatency result;
+          snapshot(result);
+          return result;
+        }
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static double totalMilliseconds(const HopLatency &latency)
+      {
+        return latency.mAverage * static_cast<double>(latency.mCount);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testBucketEdges()
+      {
+        static const QWORD maxValue = (static_cast<QWORD>(1) << UseHistogram::kMaxValueBits) - 1;
+
+        // values below twice the sub-bucket count each have their own bucket
+        TESTING_EQUAL(HistogramTester::toBucket(0), 0)
+        TESTING_EQUAL(HistogramTester::toBucket(31), 31)
+        TESTING_EQUAL(HistogramTester::bucketLowestValue(31), 31)
+        TESTING_EQUAL(HistogramTester::bucketHighestValue(31), 31)
+
+        // the first shared bucket holds 32 and 33
+        TESTING_EQUAL(HistogramTester::toBucket(32), 32)
+        TESTING_EQUAL(HistogramTester::toBucket(33), 32)
+        TESTING_EQUAL(HistogramTester::toBucket(34), 33)
+        TESTING_EQUAL(HistogramTester::bucketLowestValue(32), 32)
+        TESTING_EQUAL(HistogramTester::bucketHighestValue(32), 33)
+
+        // the largest value fills the last bucket and anything larger clamps
+        TESTING_EQUAL(HistogramTester::toBucket(maxValue), UseHistogram::kBuckets - 1)
+        TESTING_EQUAL(HistogramTester::toBucket(maxValue + 1), UseHistogram::kBuckets - 1)
+        TESTING_EQUAL(HistogramTester::toBucket(static_cast<QWORD>(1) << 40), UseHistogram::kBuckets - 1)
+        TESTING_EQUAL(HistogramTester::bucketHighestValue(UseHistogram::kBuckets - 1), maxValue)
+
+        // every bucket covers its own values with no gaps or overlaps
+        size_t mismatched = 0;
+        for (size_t bucket = 0; bucket < UseHistogram::kBuckets; ++bucket) {
+          QWORD lowest = HistogramTester::bucketLowestValue(bucket);
+          QWORD highest = HistogramTester::bucketHighestValue(bucket);
+          if (HistogramTester::toBucket(lowest) != bucket) ++mismatched;
+          if (HistogramTester::toBucket(highest) != bucket) ++mismatched;
+          if ((bucket + 1 < UseHistogram::kBuckets) &&
+              (highest + 1 != HistogramTester::bucketLowestValue(bucket + 1))) ++mismatched;
+        }
+        TESTING_EQUAL(mismatched, 0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testEmpty()
+      {
+        HistogramTester histogram;
+
+        auto latency = histogram.latency();
+        TESTING_EQUAL(latency.mCount, 0)
+        TESTING_EQUAL(latency.mP50, 0.0)
+        TESTING_EQUAL(latency.mMax, 0.0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testExactPercentiles()
+      {
+        HistogramTester histogram;
+
+        for (QWORD value = 0; value < 32; ++value) {
+          histogram.record(value);
+        }
+
+        auto latency = histogram.latency();
+        TESTING_EQUAL(latency.mCount, 32)
+        TESTING_EQUAL(latency.mP50, 15.0 / 1000.0)
+        TESTING_EQUAL(latency.mP90, 28.0 / 1000.0)
+        TESTING_EQUAL(latency.mP99, 31.0 / 1000.0)
+        TESTING_EQUAL(latency.mMax, 31.0 / 1000.0)
+        TESTING_EQUAL(latency.mAverage, 15.5 / 1000.0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testInterpolatedPercentiles()
+      {
+        HistogramTester histogram;
+
+        for (QWORD value = 1; value <= 100; ++value) {
+          histogram.record(value);
+        }
+
+        // p50 falls on the first of the two values in [50, 51] and p90 on the
+        // third of the four in [88, 91]
+        auto latency = histogram.latency();
+        TESTING_EQUAL(latency.mCount, 100)
+        TESTING_EQUAL(latency.mP50, 50.5 / 1000.0)
+        TESTING_EQUAL(latency.mP90, 90.25 / 1000.0)
+        TESTING_EQUAL(latency.mP99, 99.0 / 1000.0)
+
+        // [100, 103] holds only 100 so the top percentile never exceeds it
+        TESTING_EQUAL(latency.mP999, 100.0 / 1000.0)
+        TESTING_EQUAL(latency.mMax, 100.0 / 1000.0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMaxValue()
+      {
+        HistogramTester histogram;
+
+        histogram.record(static_cast<QWORD>(1) << 40);
+
+        auto latency = histogram.latency();
+        TESTING_EQUAL(latency.mCount, 1)
+        TESTING_EQUAL(latency.mMax, static_cast<double>(static_cast<QWORD>(1) << 40) / 1000.0)
+        TESTING_EQUAL(latency.mP50, static_cast<double>(HistogramTester::bucketHighestValue(UseHistogram::kBuckets - 1)) / 1000.0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testIngressScope()
+      {
+        TESTING_EQUAL(UsePipeline::ingressTime(), 0)
+
+        {
+          UsePipeline::IngressScope scope;
+
+          QWORD ingress = UsePipeline::ingressTime();
+          TESTING_CHECK(0 != ingress)
+
+          {
+            UsePipeline::IngressScope nested;
+            TESTING_CHECK(UsePipeline::ingressTime() >= ingress)
+          }
+          TESTING_EQUAL(UsePipeline::ingressTime(), ingress)
+
+          // the ingress context belongs to the thread which read the packet
+          QWORD otherIngress = 1;
+          std::thread other([&otherIngress]() {otherIngress = UsePipeline::ingressTime();});
+          other.join();
+          TESTING_EQUAL(otherIngress, 0)
+        }
+
+        TESTING_EQUAL(UsePipeline::ingressTime(), 0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMarkHop()
+      {
+        auto gatherer = IStatsReportTypes::PacketPipelineHop_ICEGatherer;
+        auto transport = IStatsReportTypes::PacketPipelineHop_ICETransport;
+
+        // without an ingress context no hop is measured
+        auto before = UsePipeline::createStats();
+        UsePipeline::markHop(gatherer);
+        auto after = UsePipeline::createStats();
+        TESTING_EQUAL(after->mHops[gatherer].mCount, before->mHops[gatherer].mCount)
+
+        before = UsePipeline::createStats();
+        {
+          UsePipeline::IngressScope scope;
+
+          // each hop is charged the time since the previous mark only
+          TESTING_SLEEP(20)
+          UsePipeline::markHop(gatherer);
+          UsePipeline::markHop(transport);
+        }
+        after = UsePipeline::createStats();
+
+        TESTING_EQUAL(after->mHops[gatherer].mCount, before->mHops[gatherer].mCount + 1)
+        TESTING_EQUAL(after->mHops[transport].mCount, before->mHops[transport].mCount + 1)
+
+        double gathererTime = totalMilliseconds(after->mHops[gatherer]) - totalMilliseconds(before->mHops[gatherer]);
+        double transportTime = totalMilliseconds(after->mHops[transport]) - totalMilliseconds(before->mHops[transport]);
+        TESTING_CHECK(gathererTime >= 19.0)
+        TESTING_CHECK(transportTime < 10.0)
+
+        // hops after the scope closed are not measured either
+        before = UsePipeline::createStats();
+        UsePipeline::markHop(transport);
+        after = UsePipeline::createStats();
+        TESTING_EQUAL(after->mHops[transport].mCount, before->mHops[transport].mCount)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRecordSince()
+      {
+        auto queue = IStatsReportTypes::PacketPipelineHop_ReceiverChannelQueue;
+
+        // an unknown (zero) enqueue time is ignored
+        auto before = UsePipeline::createStats();
+        UsePipeline::recordSince(queue, 0);
+        auto after = UsePipeline::createStats();
+        TESTING_EQUAL(after->mHops[queue].mCount, before->mHops[queue].mCount)
+
+        QWORD queuedAt = UsePipeline::now();
+        TESTING_SLEEP(10)
+        UsePipeline::recordSince(queue, queuedAt);
+        after = UsePipeline::createStats();
+
+        TESTING_EQUAL(after->mHops[queue].mCount, before->mHops[queue].mCount + 1)
+        TESTING_CHECK(totalMilliseconds(after->mHops[queue]) - totalMilliseconds(before->mHops[queue]) >= 9.0)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::packetpipelinelatency;
+
+void doTestPacketPipelineLatency()
+{
+  if (!ORTC_TEST_DO_PACKET_PIPELINE_LATENCY_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  testBucketEdges();
+  testEmpty();
+  testExactPercentiles();
+  testInterpolatedPercentiles();
+  testMaxValue();
+  testIngressScope();
+  testMarkHop();
+  testRecordSince();
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -0,0 +1,336 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+#include <ortc/adapter/internal/ortc_adapter_PeerConnection.h>
+#include <ortc/adapter/internal/ortc_adapter_SessionDescription.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::DWORD;
+using zsLib::String;
+using zsLib::string;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::adapter::internal::SessionDescription, UseSessionDescription)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace peerconnectionremotediff
+    {
+      //-----------------------------------------------------------------------
+      class RemoteDiffTester : public adapter::internal::PeerConnection
+      {
+      public:
+        using PeerConnection::calculateRemoteDiff;
+      };
+
+      typedef RemoteDiffTester::RemoteDescriptionHashes RemoteDescriptionHashes;
+      typedef RemoteDiffTester::RemoteDescriptionDiff RemoteDescriptionDiff;
+
+      enum TestConstants
+      {
+        kParticipants = 10,
+      };
+
+      //-----------------------------------------------------------------------
+      struct RoomOptions
+      {
+        size_t mParticipants {kParticipants};
+        size_t mVersion {1};
+        size_t mEditedCandidate {SIZE_MAX};   // participant with a new candidate
+        size_t mReceiveOnly {SIZE_MAX};       // participant that stopped sending
+      };
+
+      //-----------------------------------------------------------------------
+      static String mid(size_t index)
+      {
+        return "p" + string(index);
+      }
+
+      //-----------------------------------------------------------------------
+      static String createRoomSDP(const RoomOptions &options)
+      {
+        String result =
+          "v=0\r\n"
+          "o=- 4611731400430051336 " + string(options.mVersion) + " IN IP4 127.0.0.1\r\n"
+          "s=-\r\n"
+          "t=0 0\r\n"
+          "a=msid-semantic: WMS room\r\n"
+          "a=ice-options:trickle\r\n";
+
+        String group = "a=group:BUNDLE";
+        for (size_t index = 0; index < options.mParticipants; ++index) {
+          group += " " + mid(index);
+        }
+        result += group + "\r\n";
+
+        for (size_t index = 0; index < options.mParticipants; ++index) {
+          DWORD ssrc = static_cast<DWORD>(1000 + (index * 10));
+
+          result +=
+            "m=video 9 UDP/TLS/RTP/SAVPF 96 97\r\n"
+            "c=IN IP4 0.0.0.0\r\n"
+            "a=rtcp:9 IN IP4 0.0.0.0\r\n";
+          result += "a=ice-ufrag:u" + string(index) + "\r\n";
+          result +=
+            "a=ice-pwd:asd88fgpdd777uzjYhagZg\r\n"
+            "a=fingerprint:sha-256 D1:2C:BE:AD:C4:F6:64:5C:25:16:11:9C:AF:E7:0F:73:79:36:4E:9C:1E:15:54:39:0C:06:8B:ED:96:86:00:39\r\n"
+            "a=setup:actpass\r\n";
+          result += "a=mid:" + mid(index) + "\r\n";
+          result += (options.mReceiveOnly == index ? "a=recvonly\r\n" : "a=sendrecv\r\n");
+          result +=
+            "a=rtcp-mux\r\n"
+            "a=rtpmap:96 VP8/90000\r\n"
+            "a=rtcp-fb:96 nack\r\n"
+            "a=rtcp-fb:96 nack pli\r\n"
+            "a=rtpmap:97 rtx/90000\r\n"
+            "a=fmtp:97 apt=96\r\n";
+          result += "a=ssrc-group:FID " + string(ssrc) + " " + string(ssrc + 1) + "\r\n";
+          result += "a=ssrc:" + string(ssrc) + " cname:room\r\n";
+          result += "a=ssrc:" + string(ssrc + 1) + " cname:room\r\n";
+          result += "a=candidate:1 1 udp 2122260223 192.168.1.2 5" + string(1000 + index) + " typ host generation 0\r\n";
+          if (options.mEditedCandidate == index) {
+            result += "a=candidate:2 1 udp 1686052607 203.0.113.7 5" + string(1000 + index) + " typ srflx raddr 192.168.1.2 rport 5" + string(1000 + index) + " generation 0\r\n";
+          }
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      static void applyRemote(
+                              const RoomOptions &options,
+                              RemoteDescriptionHashes &ioHashes,
+                              RemoteDescriptionDiff &outDiff,
+                              bool useSDP = true
+                              )
+      {
+        String blob = createRoomSDP(options);
+
+        auto sessionDescription = UseSessionDescription::create(adapter::ISessionDescriptionTypes::SignalingType_SDPOffer, blob.c_str());
+        TESTING_CHECK(sessionDescription)
+        if (!sessionDescription) return;
+
+        auto description = sessionDescription->description();
+        TESTING_CHECK(description)
+        if (!description) return;
+
+        TESTING_EQUAL(description->mTransports.size(), options.mParticipants)
+        TESTING_EQUAL(description->mRTPMediaLines.size(), options.mParticipants)
+
+        auto sdp = sessionDescription->sdp();
+        TESTING_CHECK(sdp)
+
+        RemoteDescriptionHashes hashes;
+        RemoteDiffTester::calculateRemoteDiff(*description, useSDP ? sdp : adapter::internal::ISDPTypes::SDPPtr(), ioHashes, hashes, outDiff);
+        ioHashes = hashes;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool contains(
+                           const RemoteDescriptionDiff::IDSet &ids,
+                           const String &id
+                           )
+      {
+        return ids.end() != ids.find(id);
+      }
+
+      //-----------------------------------------------------------------------
+      static void testInitial()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        // everything is new thus everything is hashed
+        TESTING_EQUAL(diff.mTransports.size(), kParticipants)
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), kParticipants)
+        TESTING_EQUAL(diff.mSenders.size(), kParticipants)
+        TESTING_EQUAL(diff.mRemovedSenders.size(), 0)
+        TESTING_EQUAL(diff.mTotalHashed, kParticipants * 3)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testUnchanged()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        // a new session version alone does not touch any section
+        options.mVersion = 2;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTransports.size(), 0)
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), 0)
+        TESTING_EQUAL(diff.mSenders.size(), 0)
+        TESTING_EQUAL(diff.mRemovedSenders.size(), 0)
+        TESTING_EQUAL(diff.mTotalHashed, 0)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testJoin()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        // the bundle group changes but only the new section is hashed
+        options.mVersion = 2;
+        options.mParticipants = kParticipants + 1;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTransports.size(), 1)
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), 1)
+        TESTING_EQUAL(diff.mSenders.size(), 1)
+        TESTING_CHECK(contains(diff.mTransports, mid(kParticipants)))
+        TESTING_CHECK(contains(diff.mRTPMediaLines, mid(kParticipants)))
+        TESTING_CHECK(contains(diff.mSenders, mid(kParticipants)))
+        TESTING_EQUAL(diff.mTotalHashed, 3)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testEdit()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        // the edited section is re-hashed but only the transport (whose
+        // candidates changed) ends up being different
+        options.mVersion = 2;
+        options.mEditedCandidate = 3;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTotalHashed, 3)
+        TESTING_EQUAL(diff.mTransports.size(), 1)
+        TESTING_CHECK(contains(diff.mTransports, mid(3)))
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), 0)
+        TESTING_EQUAL(diff.mSenders.size(), 0)
+
+        // reverting is a change too
+        options.mVersion = 3;
+        options.mEditedCandidate = SIZE_MAX;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTotalHashed, 3)
+        TESTING_EQUAL(diff.mTransports.size(), 1)
+        TESTING_CHECK(contains(diff.mTransports, mid(3)))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRemovedSender()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        options.mVersion = 2;
+        options.mReceiveOnly = 5;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTotalHashed, 2)
+        TESTING_EQUAL(diff.mTransports.size(), 0)
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), 1)
+        TESTING_CHECK(contains(diff.mRTPMediaLines, mid(5)))
+        TESTING_EQUAL(diff.mSenders.size(), 0)
+        TESTING_EQUAL(diff.mRemovedSenders.size(), 1)
+        TESTING_CHECK(contains(diff.mRemovedSenders, mid(5)))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testWithoutSDP()
+      {
+        RoomOptions options;
+        RemoteDescriptionHashes hashes;
+        RemoteDescriptionDiff diff;
+        applyRemote(options, hashes, diff);
+
+        // without section digests (e.g. JSON signaling) every entry is
+        // hashed but an identical description still has no changes
+        options.mVersion = 2;
+        applyRemote(options, hashes, diff, false);
+
+        TESTING_EQUAL(diff.mTotalHashed, kParticipants * 3)
+        TESTING_EQUAL(diff.mTransports.size(), 0)
+        TESTING_EQUAL(diff.mRTPMediaLines.size(), 0)
+        TESTING_EQUAL(diff.mSenders.size(), 0)
+
+        // and the hashes it stored are reused once digests are back
+        options.mVersion = 3;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTotalHashed, kParticipants * 3)
+        TESTING_EQUAL(diff.mTransports.size(), 0)
+
+        options.mVersion = 4;
+        applyRemote(options, hashes, diff);
+
+        TESTING_EQUAL(diff.mTotalHashed, 0)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::peerconnectionremotediff;
+
+void doTestPeerConnectionRemoteDiff()
+{
+  if (!ORTC_TEST_DO_PEER_CONNECTION_REMOTE_DIFF_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testInitial();
+  testUnchanged();
+  testJoin();
+  testEdit();
+  testRemovedSender();
+  testWithoutSDP();
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -296,6 +296,7 @@ namespace ortc
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBRCommon TMMBRCommon;
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+        typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
         typedef RTCPPacket::PayloadSpecificFeedbackMessage::PLI PLI;
         typedef RTCPPacket::PayloadSpecificFeedbackMessage::SLI SLI;
@@ -553,6 +554,14 @@ namespace ortc
             delete [] report->mFirstTMMBN;
             report->mFirstTMMBN = NULL;
           }
+          if (NULL != report->mTransportCC.mPacketChunks) {
+            delete [] report->mTransportCC.mPacketChunks;
+            report->mTransportCC.mPacketChunks = NULL;
+          }
+          if (NULL != report->mTransportCC.mRecvDeltas) {
+            delete [] report->mTransportCC.mRecvDeltas;
+            report->mTransportCC.mRecvDeltas = NULL;
+          }
           if (NULL != report->mFCI) {
             delete [] report->mFCI;
             report->mFCI = NULL;
@@ -1292,6 +1301,37 @@ namespace ortc
           }
         }
 
+        //---------------------------------------------------------------------
+        static void compareTransportLayerFeedbackMessageTransportCC(TransportCC *item1, TransportCC *item2)
+        {
+          TESTING_CHECK(NULL != item1)
+          TESTING_CHECK(NULL != item2)
+
+          TESTING_EQUAL(item1->baseSequenceNumber(), item2->baseSequenceNumber())
+          TESTING_EQUAL(item1->packetStatusCount(), item2->packetStatusCount())
+          TESTING_EQUAL(item1->referenceTime(), item2->referenceTime())
+          TESTING_EQUAL(item1->fbPktCount(), item2->fbPktCount())
+
+          TESTING_EQUAL(item1->baseSequenceNumber(), item1->mBaseSequenceNumber)
+          TESTING_EQUAL(item1->packetStatusCount(), item1->mPacketStatusCount)
+          TESTING_EQUAL(item1->referenceTime(), item1->mReferenceTime)
+          TESTING_EQUAL(item1->fbPktCount(), item1->mFBPktCount)
+
+          TESTING_EQUAL(item1->packetChunkCount(), item2->packetChunkCount())
+          TESTING_EQUAL(item1->packetChunkCount(), item1->mPacketChunkCount)
+          for (size_t index = 0; index < item1->packetChunkCount(); ++index) {
+            TESTING_EQUAL(item1->packetChunkAtIndex(index), item2->packetChunkAtIndex(index))
+            TESTING_EQUAL(item1->packetChunkAtIndex(index), item1->mPacketChunks[index])
+          }
+
+          TESTING_EQUAL(item1->recvDeltaCount(), item2->recvDeltaCount())
+          TESTING_EQUAL(item1->recvDeltaCount(), item1->mRecvDeltaCount)
+          for (size_t index = 0; index < item1->recvDeltaCount(); ++index) {
+            TESTING_EQUAL(item1->recvDeltaAtIndex(index), item2->recvDeltaAtIndex(index))
+            TESTING_EQUAL(item1->recvDeltaAtIndex(index), item1->mRecvDeltas[index])
+          }
+        }
+
         //---------------------------------------------------------------------
         static void compareTransportLayerFeedbackMessage(TransportLayerFeedbackMessage *report1, TransportLayerFeedbackMessage *report2)
         {
@@ -1343,6 +1383,12 @@ namespace ortc
               }
               break;
             }
+            case TransportCC::kFmt: {
+              TESTING_CHECK(report1->transportCC() == &(report1->mTransportCC))
+              TESTING_CHECK(report2->transportCC() == &(report2->mTransportCC))
+              compareTransportLayerFeedbackMessageTransportCC(report1->transportCC(), report2->transportCC());
+              break;
+            }
             default:
             {
               TESTING_CHECK(NULL != report1->mUnknown)
@@ -2328,6 +2374,119 @@ namespace ortc
           TESTING_EQUAL(total, 0)
         }
 
+        //---------------------------------------------------------------------
+        static void checkFeedback(const RTCPPacket &packet)
+        {
+          typedef RTCPPacket::FeedbackEvent FeedbackEvent;
+          typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
+          FeedbackEventList events;
+          bool feedbackOnly = false;
+
+          TESTING_CHECK(RTCPPacket::extractFeedback(packet.ptr(), packet.size(), events, feedbackOnly))
+
+          FeedbackEventList expected;
+          bool foundOther = false;
+
+          for (Report *current = packet.mFirst; NULL != current; current = current->next())
+          {
+            FeedbackEvent event;
+
+            switch (current->pt()) {
+              case TransportLayerFeedbackMessage::kPayloadType: {
+                auto report = static_cast<TransportLayerFeedbackMessage *>(current);
+                if (GenericNACK::kFmt != report->fmt()) {
+                  foundOther = true;
+                  break;
+                }
+                event.mType = FeedbackEvent::Type_GenericNACK;
+                event.mSSRCOfPacketSender = report->ssrcOfPacketSender();
+                event.mSSRC = report->ssrcOfMediaSource();
+                for (size_t index = 0; index < report->genericNACKCount(); ++index) {
+                  auto nack = report->genericNACKAtIndex(index);
+                  event.mPID = nack->pid();
+                  event.mBLP = nack->blp();
+                  expected.push_back(event);
+                }
+                break;
+              }
+              case PayloadSpecificFeedbackMessage::kPayloadType: {
+                auto report = static_cast<PayloadSpecificFeedbackMessage *>(current);
+                event.mSSRCOfPacketSender = report->ssrcOfPacketSender();
+                event.mSSRC = report->ssrcOfMediaSource();
+                if (report->pli()) {
+                  event.mType = FeedbackEvent::Type_PLI;
+                  expected.push_back(event);
+                  break;
+                }
+                if (FIR::kFmt == report->fmt()) {
+                  event.mType = FeedbackEvent::Type_FIR;
+                  for (size_t index = 0; index < report->firCount(); ++index) {
+                    auto fir = report->firAtIndex(index);
+                    event.mSSRC = fir->ssrc();
+                    event.mSeqNr = fir->seqNr();
+                    expected.push_back(event);
+                  }
+                  break;
+                }
+                auto remb = report->remb();
+                if (remb) {
+                  event.mType = FeedbackEvent::Type_REMB;
+                  event.mBRExp = remb->brExp();
+                  event.mBRMantissa = remb->brMantissa();
+                  for (size_t index = 0; index < remb->numSSRC(); ++index) {
+                    event.mSSRC = remb->ssrcAtIndex(index);
+                    expected.push_back(event);
+                  }
+                  break;
+                }
+                foundOther = true;
+                break;
+              }
+              default: {
+                foundOther = true;
+                break;
+              }
+            }
+          }
+
+          if (foundOther) {
+            TESTING_CHECK(!feedbackOnly)
+          }
+
+          TESTING_EQUAL(events.size(), expected.size())
+
+          auto iter1 = events.begin();
+          auto iter2 = expected.begin();
+          for (; (iter1 != events.end()) && (iter2 != expected.end()); ++iter1, ++iter2)
+          {
+            auto &event1 = (*iter1);
+            auto &event2 = (*iter2);
+
+            TESTING_EQUAL(event1.mType, event2.mType)
+            TESTING_EQUAL(event1.mSSRCOfPacketSender, event2.mSSRCOfPacketSender)
+            TESTING_EQUAL(event1.mSSRC, event2.mSSRC)
+
+            switch (event1.mType) {
+              case FeedbackEvent::Type_GenericNACK: {
+                TESTING_EQUAL(event1.mPID, event2.mPID)
+                TESTING_EQUAL(event1.mBLP, event2.mBLP)
+                break;
+              }
+              case FeedbackEvent::Type_PLI: break;
+              case FeedbackEvent::Type_FIR: {
+                TESTING_EQUAL(event1.mSeqNr, event2.mSeqNr)
+                break;
+              }
+              case FeedbackEvent::Type_REMB: {
+                TESTING_EQUAL(event1.mBRExp, event2.mBRExp)
+                TESTING_EQUAL(event1.mBRMantissa, event2.mBRMantissa)
+                break;
+              }
+            }
+          }
+        }
+
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -2645,12 +2804,15 @@ namespace ortc
           result->mSSRCOfPacketSender = randomDWORD();
           result->mSSRCOfMediaSource = randomDWORD();
 
-          switch (randomSize(3)) {
+          switch (randomSize(4)) {
             case 0: result->mReportSpecific = GenericNACK::kFmt; break;
             case 1: result->mReportSpecific = TMMBR::kFmt; break;
             case 2: result->mReportSpecific = TMMBN::kFmt; break;
-            case 3: {
-              result->mReportSpecific = static_cast<decltype(result->mReportSpecific)>(randomSize(TMMBN::kFmt+1, 0x1F));
+            case 3: result->mReportSpecific = TransportCC::kFmt; break;
+            case 4: {
+              do {
+                result->mReportSpecific = static_cast<decltype(result->mReportSpecific)>(randomSize(TMMBN::kFmt+1, 0x1F));
+              } while (TransportCC::kFmt == result->mReportSpecific);
               break;
             }
             default:
@@ -2701,6 +2863,83 @@ namespace ortc
               }
               break;
             }
+            case TransportCC::kFmt:  {
+              result->mHasTransportCC = true;
+
+              TransportCC &cc = result->mTransportCC;
+              cc.mBaseSequenceNumber = randomWORD();
+              cc.mReferenceTime = static_cast<LONG>(randomSize(0, 0xFFFFFF)) - 0x800000;
+              cc.mFBPktCount = randomBYTE();
+
+              cc.mPacketChunkCount = randomSize(1, 20);
+              cc.mPacketChunks = new TransportCC::PacketChunk[cc.mPacketChunkCount];
+
+              size_t totalStatuses = 0;
+              size_t totalDeltas = 0;
+
+              for (size_t index = 0; index < cc.mPacketChunkCount; ++index) {
+                BYTE symbols[TransportCC::kOneBitSymbolsPerVector] {};
+
+                switch (randomSize(2)) {
+                  case 0: {
+                    BYTE symbol = static_cast<BYTE>(randomSize(TransportCC::kStatusSymbolReceivedLargeOrNegativeDelta));
+                    size_t length = randomSize(1, 50);
+                    cc.mPacketChunks[index] = TransportCC::createRunLengthChunk(symbol, length);
+                    totalStatuses += length;
+                    if (0 != TransportCC::getRecvDeltaSize(symbol)) totalDeltas += length;
+                    break;
+                  }
+                  case 1: {
+                    for (size_t symbolIndex = 0; symbolIndex < TransportCC::kOneBitSymbolsPerVector; ++symbolIndex) {
+                      symbols[symbolIndex] = static_cast<BYTE>(randomSize(TransportCC::kStatusSymbolReceivedSmallDelta));
+                      if (0 != symbols[symbolIndex]) ++totalDeltas;
+                    }
+                    cc.mPacketChunks[index] = TransportCC::createStatusVectorChunk(&(symbols[0]), TransportCC::kOneBitSymbolsPerVector, false);
+                    totalStatuses += TransportCC::kOneBitSymbolsPerVector;
+                    break;
+                  }
+                  default: {
+                    for (size_t symbolIndex = 0; symbolIndex < TransportCC::kTwoBitSymbolsPerVector; ++symbolIndex) {
+                      symbols[symbolIndex] = static_cast<BYTE>(randomSize(TransportCC::kStatusSymbolReceivedLargeOrNegativeDelta));
+                      if (0 != symbols[symbolIndex]) ++totalDeltas;
+                    }
+                    cc.mPacketChunks[index] = TransportCC::createStatusVectorChunk(&(symbols[0]), TransportCC::kTwoBitSymbolsPerVector, true);
+                    totalStatuses += TransportCC::kTwoBitSymbolsPerVector;
+                    break;
+                  }
+                }
+              }
+
+              cc.mPacketStatusCount = static_cast<WORD>(totalStatuses);
+
+              cc.mRecvDeltaCount = totalDeltas;
+              if (0 != totalDeltas) {
+                cc.mRecvDeltas = new LONG[totalDeltas];
+              }
+
+              // scope: fill in deltas that fit the symbol each one belongs to
+              {
+                size_t deltaIndex = 0;
+                for (size_t index = 0; index < cc.mPacketChunkCount; ++index) {
+                  auto chunk = cc.mPacketChunks[index];
+                  bool isRunLength = TransportCC::isRunLengthChunk(chunk);
+                  TransportCC::RunLength rl(chunk);
+                  TransportCC::StatusVector sv(chunk);
+
+                  size_t symbolCount = (isRunLength ? rl.runLength() : sv.symbolCount());
+                  for (size_t symbolIndex = 0; symbolIndex < symbolCount; ++symbolIndex) {
+                    BYTE symbol = (isRunLength ? rl.statusSymbol() : sv.symbolAtIndex(symbolIndex));
+                    switch (symbol) {
+                      case TransportCC::kStatusSymbolReceivedSmallDelta:            cc.mRecvDeltas[deltaIndex] = static_cast<LONG>(randomBYTE()); ++deltaIndex; break;
+                      case TransportCC::kStatusSymbolReceivedLargeOrNegativeDelta:  cc.mRecvDeltas[deltaIndex] = static_cast<LONG>(static_cast<short>(randomWORD())); ++deltaIndex; break;
+                      default:                                                      break;
+                    }
+                  }
+                }
+                TESTING_EQUAL(deltaIndex, totalDeltas)
+              }
+              break;
+            }
             default: {
               result->mUnknown = result;
               if (shouldPerform(90)) {
@@ -2933,6 +3172,50 @@ namespace ortc
           return result;
         }
 
+        //---------------------------------------------------------------------
+        static TransportLayerFeedbackMessage *createGenericNACK(size_t count)
+        {
+          TransportLayerFeedbackMessage *result = new TransportLayerFeedbackMessage;
+          result->mPT = TransportLayerFeedbackMessage::kPayloadType;
+          fillReport(result);
+
+          result->mSSRCOfPacketSender = randomDWORD();
+          result->mSSRCOfMediaSource = randomDWORD();
+          result->mReportSpecific = GenericNACK::kFmt;
+
+          result->mGenericNACKCount = count;
+          result->mFirstGenericNACK = new GenericNACK[count];
+
+          for (size_t index = 0; index < count; ++index) {
+            auto current = (&(result->mFirstGenericNACK[index]));
+
+            current->mPID = randomWORD();
+            current->mBLP = randomWORD();
+          }
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        static PayloadSpecificFeedbackMessage *createREMB(size_t totalSSRCs)
+        {
+          PayloadSpecificFeedbackMessage *result = new PayloadSpecificFeedbackMessage;
+          result->mPT = PayloadSpecificFeedbackMessage::kPayloadType;
+          fillReport(result);
+
+          result->mSSRCOfPacketSender = randomDWORD();
+          result->mReportSpecific = AFB::kFmt;
+          result->mHasREMB = true;
+
+          result->mREMB.mNumSSRC = static_cast<BYTE>(totalSSRCs);
+          result->mREMB.mBRExp = randomBYTE(6);
+          result->mREMB.mBRMantissa = randomDWORD(18);
+          result->mREMB.mSSRCs = new DWORD[totalSSRCs];
+          for (size_t index = 0; index < totalSSRCs; ++index) {
+            result->mREMB.mSSRCs[index] = randomDWORD();
+          }
+          return result;
+        }
+
         //---------------------------------------------------------------------
         static void fillReportBlockRange(ReportBlockRange *range)
         {
@@ -3415,6 +3698,7 @@ namespace ortc
           TESTING_CHECK(NULL != mGeneratedFirst)
 
           checkSanity(*mPacket);
+          checkFeedback(*mPacket);
           compare(mPacket->first(), mGeneratedFirst);
         }
 
@@ -3455,6 +3739,101 @@ static signed gSeeds[] = {2286, 2075, -57479, 1000, 1001, -17, 89, -97, 523, 104
 
 using namespace ortc::test;
 
+//-----------------------------------------------------------------------------
+static void testReducedSizeGating()
+{
+  typedef RTCPPacket::ReceiverReport ReceiverReport;
+  typedef RTCPPacket::SDES SDES;
+  typedef RTCPPacket::PayloadSpecificFeedbackMessage PayloadSpecificFeedbackMessage;
+  typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
+  const DWORD senderSSRC = 0x1234;
+  const DWORD mediaSSRC = 0x5678;
+
+  PayloadSpecificFeedbackMessage pli;
+  pli.mVersion = 2;
+  pli.mPT = PayloadSpecificFeedbackMessage::kPayloadType;
+  pli.mReportSpecific = PayloadSpecificFeedbackMessage::PLI::kFmt;
+  pli.mSSRCOfPacketSender = senderSSRC;
+  pli.mSSRCOfMediaSource = mediaSSRC;
+
+  // reduced-size (i.e. rtcp-rsize) packet
+  {
+    auto reducedSize = RTCPPacket::generateFrom(&pli);
+    TESTING_CHECK(reducedSize)
+    if (!reducedSize) return;
+
+    TESTING_CHECK(RTCPPacket::isReducedSize(reducedSize->BytePtr(), reducedSize->SizeInBytes()))
+
+    // left unchanged without a CNAME
+    TESTING_CHECK(!RTCPPacket::convertToCompound(reducedSize->BytePtr(), reducedSize->SizeInBytes(), NULL))
+    TESTING_CHECK(!RTCPPacket::convertToCompound(reducedSize->BytePtr(), reducedSize->SizeInBytes(), ""))
+
+    // each length ends the SDES chunk at a different 32-bit alignment
+    const char *cnames[] = {"a", "ab", "abc", "abcd", "rsize@ortc.example.org", NULL};
+
+    for (size_t index = 0; NULL != cnames[index]; ++index) {
+      auto compound = RTCPPacket::convertToCompound(reducedSize->BytePtr(), reducedSize->SizeInBytes(), cnames[index]);
+      TESTING_CHECK(compound)
+      if (!compound) continue;
+
+      TESTING_EQUAL(0, compound->SizeInBytes() % sizeof(DWORD))
+      TESTING_CHECK(!RTCPPacket::isReducedSize(compound->BytePtr(), compound->SizeInBytes()))
+
+      auto packet = RTCPPacket::create(*compound);
+      TESTING_CHECK(packet)
+      if (!packet) continue;
+
+      TESTING_CHECK(packet->first())
+      TESTING_EQUAL(packet->first()->pt(), ReceiverReport::kPayloadType)
+
+      TESTING_EQUAL(packet->receiverReportCount(), 1)
+      TESTING_EQUAL(packet->firstReceiverReport()->ssrcOfSender(), senderSSRC)
+      TESTING_EQUAL(packet->firstReceiverReport()->rc(), 0)
+
+      TESTING_EQUAL(packet->sdesCount(), 1)
+      auto chunk = packet->firstSDES()->firstChunk();
+      TESTING_CHECK(chunk)
+      if (chunk) {
+        TESTING_EQUAL(chunk->ssrc(), senderSSRC)
+        TESTING_EQUAL(chunk->cNameCount(), 1)
+        TESTING_CHECK(chunk->firstCName())
+        if (chunk->firstCName()) {
+          TESTING_EQUAL(zsLib::String(chunk->firstCName()->value()), zsLib::String(cnames[index]))
+        }
+      }
+
+      TESTING_EQUAL(packet->payloadSpecificFeedbackMessage(), 1)
+      TESTING_EQUAL(packet->firstPayloadSpecificFeedbackMessage()->ssrcOfMediaSource(), mediaSSRC)
+
+      FeedbackEventList events;
+      bool feedbackOnly = true;
+      TESTING_CHECK(RTCPPacket::extractFeedback(compound->BytePtr(), compound->SizeInBytes(), events, feedbackOnly))
+      TESTING_CHECK(!feedbackOnly)
+      TESTING_EQUAL(events.size(), 1)
+      if (events.size() > 0) {
+        TESTING_EQUAL(events.front().mSSRC, mediaSSRC)
+      }
+    }
+  }
+
+  // already compound packets are always sent unchanged
+  {
+    ReceiverReport rr;
+    rr.mVersion = 2;
+    rr.mPT = ReceiverReport::kPayloadType;
+    rr.mSSRCOfSender = senderSSRC;
+    rr.mNext = &pli;
+
+    auto compound = RTCPPacket::generateFrom(&rr);
+    TESTING_CHECK(compound)
+    if (!compound) return;
+
+    TESTING_CHECK(!RTCPPacket::isReducedSize(compound->BytePtr(), compound->SizeInBytes()))
+    TESTING_CHECK(!RTCPPacket::convertToCompound(compound->BytePtr(), compound->SizeInBytes(), "rsize@ortc.example.org"))
+  }
+}
+
 void doTestRTCPPacket()
 {
   if (!ORTC_TEST_DO_RTCP_PACKET_TEST) return;
@@ -3558,10 +3937,11 @@ void doTestRTCPPacket()
                 break;
               }
               case 3: {
-                reachedFinalStep = true;
+                testReducedSizeGating();
                 break;
               }
               case 4: {
+                reachedFinalStep = true;
                 break;
               }
               case 5: {
@@ -3626,3 +4006,98 @@ void doTestRTCPPacket()
 
   srand(static_cast<unsigned>(time(NULL))); // put seed back to current time
 }
+
+//-----------------------------------------------------------------------------
+static void benchmarkRTCPPacket(
+                                const char *operation,
+                                Tester::Report *first,
+                                ULONG iterations
+                                )
+{
+  auto buffer = RTCPPacket::generateFrom(first);
+  TESTING_CHECK(buffer)
+  if (!buffer) return;
+
+  auto check = RTCPPacket::create(*buffer);
+  TESTING_CHECK(check)
+  if (!check) return;
+
+  // generating from the parsed reports must reproduce the same wire bytes
+  auto regenerated = RTCPPacket::generateFrom(check->first());
+  TESTING_CHECK(regenerated)
+  if (regenerated) {
+    TESTING_EQUAL(0, UseServicesHelper::compare(*buffer, *regenerated))
+  }
+
+  {
+    size_t parsed = 0;
+
+    size_t allocations = Testing::getTotalAllocations();
+    zsLib::Time start = zsLib::now();
+    for (ULONG loop = 0; loop < iterations; ++loop) {
+      auto packet = RTCPPacket::create(buffer->BytePtr(), buffer->SizeInBytes());
+      if (packet) ++parsed;
+    }
+    auto total = zsLib::toMicroseconds(zsLib::now() - start);
+    allocations = Testing::getTotalAllocations() - allocations;
+
+    TESTING_EQUAL(parsed, iterations)
+
+    Testing::outputOperationBenchmark("rtcpPacketBenchmark", (zsLib::String("parse, ") + operation).c_str(), iterations, buffer->SizeInBytes(), total, allocations);
+  }
+
+  {
+    size_t generated = 0;
+
+    size_t allocations = Testing::getTotalAllocations();
+    zsLib::Time start = zsLib::now();
+    for (ULONG loop = 0; loop < iterations; ++loop) {
+      auto output = RTCPPacket::generateFrom(first);
+      if (output) ++generated;
+    }
+    auto total = zsLib::toMicroseconds(zsLib::now() - start);
+    allocations = Testing::getTotalAllocations() - allocations;
+
+    TESTING_EQUAL(generated, iterations)
+
+    Testing::outputOperationBenchmark("rtcpPacketBenchmark", (zsLib::String("generate, ") + operation).c_str(), iterations, buffer->SizeInBytes(), total, allocations);
+  }
+}
+
+void doTestRTCPPacketBenchmark()
+{
+  if (!ORTC_TEST_DO_PACKET_BENCHMARK) return;
+
+  UseSettings::applyDefaults();
+
+  // the fixtures are random; a fixed seed keeps the packets identical
+  // between runs so results can be compared
+  srand(static_cast<unsigned>(gSeeds[0]));
+
+  {
+    Tester::Report *sr = Tester::createSenderReport();
+    Tester::Report *rr = Tester::createReceiverReport();
+    Tester::Report *sdes = Tester::createSDES();
+    Tester::Report *nack = Tester::createGenericNACK(4);
+    Tester::Report *remb = Tester::createREMB(2);
+
+    sr->mNext = rr;
+    rr->mNext = sdes;
+    sdes->mNext = nack;
+    nack->mNext = remb;
+
+    benchmarkRTCPPacket("compound sr+rr+sdes+nack+remb", sr, ORTC_TEST_PACKET_BENCHMARK_ITERATIONS);
+
+    Tester::clean(sr);
+  }
+
+  {
+    Tester::Report *xr = Tester::createXR();
+
+    benchmarkRTCPPacket("xr", xr, ORTC_TEST_PACKET_BENCHMARK_ITERATIONS);
+
+    Tester::clean(xr);
+  }
+
+  srand(static_cast<unsigned>(time(NULL))); // put seed back to current time
+}
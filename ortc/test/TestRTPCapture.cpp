@@ -0,0 +1,484 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+#include <ortc/internal/ortc_RTPCapture.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::QWORD;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPCaptureRing, UseCaptureRing)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPUtils, UseRTPUtils)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtpcapture
+    {
+      struct Record
+      {
+        IICETypes::Components mPacketType {};
+        IRTPCapture::Directions mDirection {};
+        size_t mOriginalLength {};
+        std::vector<BYTE> mData;
+      };
+
+      typedef std::vector<Record> RecordList;
+
+      static const size_t kRTPPayloadBytes = 4;
+
+      //-----------------------------------------------------------------------
+      static WORD getLE16(const BYTE *memory)
+      {
+        return static_cast<WORD>(memory[0] | (memory[1] << 8));
+      }
+
+      //-----------------------------------------------------------------------
+      static DWORD getLE32(const BYTE *memory)
+      {
+        return static_cast<DWORD>(memory[0]) |
+               (static_cast<DWORD>(memory[1]) << 8) |
+               (static_cast<DWORD>(memory[2]) << 16) |
+               (static_cast<DWORD>(memory[3]) << 24);
+      }
+
+      //-----------------------------------------------------------------------
+      static std::vector<BYTE> createRTP(
+                                         BYTE marker,
+                                         size_t payloadSize
+                                         )
+      {
+        std::vector<BYTE> packet(12 + payloadSize, marker);
+        packet[0] = 0x80;   // version 2, no CSRCs or header extensions
+        packet[1] = 96;
+        return packet;
+      }
+
+      //-----------------------------------------------------------------------
+      static std::vector<BYTE> createRTCP(BYTE marker)
+      {
+        std::vector<BYTE> packet(8, marker);
+        packet[0] = 0x80;
+        packet[1] = 201;    // RR without report blocks
+        UseRTPUtils::setBE16(&(packet[2]), 1);
+        return packet;
+      }
+
+      //-----------------------------------------------------------------------
+      static void capture(
+                          UseCaptureRingPtr ring,
+                          IRTPCapture::Directions direction,
+                          IICETypes::Components packetType,
+                          const std::vector<BYTE> &packet
+                          )
+      {
+        ring->capture(direction, packetType, &(packet[0]), packet.size());
+      }
+
+      //-----------------------------------------------------------------------
+      static bool parseRTPDump(
+                               SecureByteBlockPtr buffer,
+                               RecordList &outRecords
+                               )
+      {
+        static const char *fileHeader = "#!rtpplay1.0 0.0.0.0/0\n";
+        const size_t fileHeaderLength = strlen(fileHeader);
+
+        TESTING_CHECK(buffer)
+        if (!buffer) return false;
+
+        const BYTE *pos = buffer->BytePtr();
+        const BYTE *end = pos + buffer->SizeInBytes();
+
+        TESTING_CHECK(static_cast<size_t>(end - pos) >= fileHeaderLength + 16)
+        if (static_cast<size_t>(end - pos) < fileHeaderLength + 16) return false;
+
+        TESTING_CHECK(0 == memcmp(pos, fileHeader, fileHeaderLength))
+        pos += fileHeaderLength + 16;
+
+        while (pos < end) {
+          TESTING_CHECK(end - pos >= 8)
+          if (end - pos < 8) return false;
+
+          size_t length = UseRTPUtils::getBE16(pos);
+          size_t originalLength = UseRTPUtils::getBE16(pos + 2);
+
+          TESTING_CHECK(length >= 8)
+          TESTING_CHECK(static_cast<size_t>(end - pos) >= length)
+          if ((length < 8) || (static_cast<size_t>(end - pos) < length)) return false;
+
+          Record record;
+          record.mPacketType = (0 == originalLength ? IICETypes::Component_RTCP : IICETypes::Component_RTP);
+          record.mDirection = IRTPCapture::Direction_Both;      // not recorded by rtpdump
+          record.mOriginalLength = originalLength;
+          record.mData.assign(pos + 8, pos + length);
+          outRecords.push_back(record);
+
+          pos += length;
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      static bool parsePCAPNG(
+                              SecureByteBlockPtr buffer,
+                              RecordList &outRecords
+                              )
+      {
+        TESTING_CHECK(buffer)
+        if (!buffer) return false;
+
+        const BYTE *pos = buffer->BytePtr();
+        const BYTE *end = pos + buffer->SizeInBytes();
+
+        bool foundSection = false;
+        bool foundInterface = false;
+
+        while (pos < end) {
+          TESTING_CHECK(end - pos >= 12)
+          if (end - pos < 12) return false;
+
+          DWORD type = getLE32(pos);
+          size_t length = getLE32(pos + 4);
+
+          TESTING_CHECK(0 == (length % 4))
+          TESTING_CHECK(length >= 12)
+          TESTING_CHECK(static_cast<size_t>(end - pos) >= length)
+          if ((length < 12) || (static_cast<size_t>(end - pos) < length)) return false;
+
+          TESTING_EQUAL(getLE32(pos + length - 4), length)
+
+          switch (type) {
+            case 0x0A0D0D0A: {
+              TESTING_EQUAL(getLE32(pos + 8), 0x1A2B3C4D)
+              TESTING_EQUAL(getLE16(pos + 12), 1)
+              foundSection = true;
+              break;
+            }
+            case 0x00000001: {
+              TESTING_CHECK(foundSection)
+              TESTING_EQUAL(getLE16(pos + 8), 101)   // LINKTYPE_RAW
+              foundInterface = true;
+              break;
+            }
+            case 0x00000006: {
+              TESTING_CHECK(foundInterface)
+
+              size_t capturedLength = getLE32(pos + 20);
+              size_t originalLength = getLE32(pos + 24);
+              TESTING_CHECK(28 + capturedLength <= length)
+              if (28 + capturedLength > length) return false;
+              TESTING_CHECK(capturedLength >= 28)
+              if (capturedLength < 28) return false;
+
+              const BYTE *ip = pos + 28;
+              TESTING_EQUAL(ip[0], 0x45)
+              TESTING_EQUAL(ip[9], 17)
+
+              // a valid header checksum sums to 0xFFFF
+              DWORD checksum = 0;
+              for (size_t loop = 0; loop < 20; loop += 2) {
+                checksum += UseRTPUtils::getBE16(ip + loop);
+              }
+              while (0 != (checksum >> 16)) {
+                checksum = (checksum & 0xFFFF) + (checksum >> 16);
+              }
+              TESTING_EQUAL(checksum, 0xFFFF)
+
+              const BYTE *udp = ip + 20;
+              WORD port = UseRTPUtils::getBE16(udp);
+              TESTING_CHECK((5000 == port) || (5001 == port))
+              TESTING_EQUAL(UseRTPUtils::getBE16(udp + 4), originalLength - 20)
+
+              // epb_flags follows the padded packet data
+              const BYTE *options = pos + 28 + ((capturedLength + 3) & ~static_cast<size_t>(3));
+              TESTING_EQUAL(getLE16(options), 2)
+              DWORD flags = getLE32(options + 4);
+              TESTING_CHECK((1 == flags) || (2 == flags))
+
+              Record record;
+              record.mPacketType = (5000 == port ? IICETypes::Component_RTP : IICETypes::Component_RTCP);
+              record.mDirection = (1 == flags ? IRTPCapture::Direction_Incoming : IRTPCapture::Direction_Outgoing);
+              record.mOriginalLength = originalLength - 28;
+              record.mData.assign(udp + 8, ip + capturedLength);
+              outRecords.push_back(record);
+              break;
+            }
+            default: {
+              TESTING_CHECK(false)
+              return false;
+            }
+          }
+
+          pos += length;
+        }
+
+        TESTING_CHECK(foundInterface)
+        return foundInterface;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkRecord(
+                              const Record &record,
+                              IICETypes::Components packetType,
+                              const std::vector<BYTE> &packet,
+                              size_t expectedCapturedLength
+                              )
+      {
+        TESTING_EQUAL(record.mPacketType, packetType)
+        TESTING_EQUAL(record.mData.size(), expectedCapturedLength)
+        if (IICETypes::Component_RTP == packetType) {
+          TESTING_EQUAL(record.mOriginalLength, packet.size())
+        }
+        if (record.mData.size() != expectedCapturedLength) return;
+        TESTING_CHECK(0 == memcmp(&(record.mData[0]), &(packet[0]), expectedCapturedLength))
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testDisabled()
+      {
+        TESTING_CHECK(!UseCaptureRing::create(0, 128, kRTPPayloadBytes))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRTPDump()
+      {
+        auto ring = UseCaptureRing::create(64*1024, 128, kRTPPayloadBytes);
+        TESTING_CHECK(ring)
+        if (!ring) return;
+
+        auto rtp1 = createRTP(1, 100);
+        auto rtcp = createRTCP(2);
+        auto rtp2 = createRTP(3, 2);
+
+        capture(ring, IRTPCapture::Direction_Outgoing, IICETypes::Component_RTP, rtp1);
+        capture(ring, IRTPCapture::Direction_Incoming, IICETypes::Component_RTCP, rtcp);
+        capture(ring, IRTPCapture::Direction_Incoming, IICETypes::Component_RTP, rtp2);
+
+        RecordList records;
+        TESTING_CHECK(parseRTPDump(ring->dump(IRTPCapture::Format_RTPDump, IRTPCapture::Direction_Both), records))
+        TESTING_EQUAL(records.size(), 3)
+        if (records.size() != 3) return;
+
+        // RTP payloads are cut after the configured number of bytes
+        checkRecord(records[0], IICETypes::Component_RTP, rtp1, 12 + kRTPPayloadBytes);
+        checkRecord(records[1], IICETypes::Component_RTCP, rtcp, rtcp.size());
+        checkRecord(records[2], IICETypes::Component_RTP, rtp2, rtp2.size());
+
+        records.clear();
+        TESTING_CHECK(parseRTPDump(ring->dump(IRTPCapture::Format_RTPDump, IRTPCapture::Direction_Incoming), records))
+        TESTING_EQUAL(records.size(), 2)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testPCAPNG()
+      {
+        auto ring = UseCaptureRing::create(64*1024, 128, kRTPPayloadBytes);
+        TESTING_CHECK(ring)
+        if (!ring) return;
+
+        auto rtp1 = createRTP(1, 100);
+        auto rtcp = createRTCP(2);
+        auto rtp2 = createRTP(3, 1);    // padded to a 32 bit boundary
+
+        capture(ring, IRTPCapture::Direction_Outgoing, IICETypes::Component_RTP, rtp1);
+        capture(ring, IRTPCapture::Direction_Incoming, IICETypes::Component_RTCP, rtcp);
+        capture(ring, IRTPCapture::Direction_Incoming, IICETypes::Component_RTP, rtp2);
+
+        RecordList records;
+        TESTING_CHECK(parsePCAPNG(ring->dump(IRTPCapture::Format_PCAPNG, IRTPCapture::Direction_Both), records))
+        TESTING_EQUAL(records.size(), 3)
+        if (records.size() != 3) return;
+
+        checkRecord(records[0], IICETypes::Component_RTP, rtp1, 12 + kRTPPayloadBytes);
+        checkRecord(records[1], IICETypes::Component_RTCP, rtcp, rtcp.size());
+        checkRecord(records[2], IICETypes::Component_RTP, rtp2, rtp2.size());
+
+        TESTING_EQUAL(records[0].mDirection, IRTPCapture::Direction_Outgoing)
+        TESTING_EQUAL(records[1].mDirection, IRTPCapture::Direction_Incoming)
+        TESTING_EQUAL(records[2].mDirection, IRTPCapture::Direction_Incoming)
+
+        records.clear();
+        TESTING_CHECK(parsePCAPNG(ring->dump(IRTPCapture::Format_PCAPNG, IRTPCapture::Direction_Outgoing), records))
+        TESTING_EQUAL(records.size(), 1)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testWrap()
+      {
+        // room for only a handful of slots
+        auto ring = UseCaptureRing::create(4*(16 + 64), 16, kRTPPayloadBytes);
+        TESTING_CHECK(ring)
+        if (!ring) return;
+
+        for (BYTE marker = 1; marker <= 100; ++marker) {
+          capture(ring, IRTPCapture::Direction_Outgoing, IICETypes::Component_RTP, createRTP(marker, 20));
+        }
+
+        RecordList records;
+        TESTING_CHECK(parseRTPDump(ring->dump(IRTPCapture::Format_RTPDump, IRTPCapture::Direction_Both), records))
+        TESTING_CHECK(records.size() > 0)
+        TESTING_CHECK(records.size() < 100)
+
+        // only the newest packets remain, oldest first
+        BYTE expected = static_cast<BYTE>(100 - records.size() + 1);
+        for (auto iter = records.begin(); iter != records.end(); ++iter, ++expected) {
+          checkRecord(*iter, IICETypes::Component_RTP, createRTP(expected, 20), 16);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void testConcurrentWriters()
+      {
+        // a tiny ring guarantees writers keep meeting on the same slots
+        auto ring = UseCaptureRing::create(8*(64 + 64), 64, 64);
+        TESTING_CHECK(ring)
+        if (!ring) return;
+
+        static const size_t kWriters = 4;
+        static const size_t kPacketsPerWriter = 20000;
+        static const size_t kPayloadSize = 40;
+
+        std::atomic<bool> done {false};
+        std::vector<std::thread> writers;
+
+        for (size_t index = 0; index < kWriters; ++index) {
+          writers.push_back(std::thread([ring, index] {
+            for (size_t loop = 0; loop < kPacketsPerWriter; ++loop) {
+              auto packet = createRTP(static_cast<BYTE>(1 + ((index * kPacketsPerWriter + loop) % 250)), kPayloadSize);
+              capture(ring, (0 == (index % 2) ? IRTPCapture::Direction_Outgoing : IRTPCapture::Direction_Incoming), IICETypes::Component_RTP, packet);
+            }
+          }));
+        }
+
+        // dumps are taken while the writers run but parsed afterwards (the
+        // testing macros are not thread safe); a rolling window is kept
+        static const size_t kKeepDumps = 20;
+
+        size_t dumps = 0;
+        std::vector<SecureByteBlockPtr> kept(kKeepDumps);
+
+        std::thread reader([ring, &done, &dumps, &kept] {
+          while (!done.load()) {
+            kept[dumps % kKeepDumps] = ring->dump(IRTPCapture::Format_RTPDump, IRTPCapture::Direction_Both);
+            ++dumps;
+          }
+        });
+
+        for (auto iter = writers.begin(); iter != writers.end(); ++iter) {
+          (*iter).join();
+        }
+        done = true;
+        reader.join();
+
+        TESTING_CHECK(dumps > 0)
+
+        size_t packets = 0;
+        size_t torn = 0;
+
+        for (auto iter = kept.begin(); iter != kept.end(); ++iter) {
+          if (!(*iter)) continue;
+
+          RecordList records;
+          TESTING_CHECK(parseRTPDump(*iter, records))
+
+          for (auto iterRecord = records.begin(); iterRecord != records.end(); ++iterRecord) {
+            auto &data = (*iterRecord).mData;
+            ++packets;
+            if (data.size() != 12 + kPayloadSize) {
+              ++torn;
+              continue;
+            }
+            // everything after the payload type is the writer's marker
+            for (size_t pos = 3; pos < data.size(); ++pos) {
+              if (data[pos] == data[2]) continue;
+              ++torn;
+              break;
+            }
+          }
+        }
+
+        TESTING_CHECK(packets > 0)
+        TESTING_EQUAL(torn, 0)
+
+        TESTING_STDOUT() << "CAPTURE:      " << dumps << " dumps taken during concurrent capture\n";
+
+        TESTING_CHECK(ring->toDebug())
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtpcapture;
+
+void doTestRTPCapture()
+{
+  if (!ORTC_TEST_DO_RTP_CAPTURE_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testDisabled();
+  testRTPDump();
+  testPCAPNG();
+  testWrap();
+  testConcurrentWriters();
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -1539,6 +1539,16 @@ namespace ortc
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      bool FakeSender::handleFeedback(
+                                      IICETypes::Components viaTransport,
+                                      RTCPPacketPtr packet,
+                                      const FeedbackEventList &events
+                                      )
+      {
+        return handlePacket(viaTransport, packet);
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -904,6 +904,12 @@ namespace ortc
                                   RTCPPacketPtr packet
                                   ) override;
 
+        virtual bool handleFeedback(
+                                    IICETypes::Components viaTransport,
+                                    RTCPPacketPtr packet,
+                                    const FeedbackEventList &events
+                                    ) override;
+
 
         //---------------------------------------------------------------------
         #pragma mark
@@ -47,6 +47,8 @@
 #include <webrtc/system_wrappers/include/trace.h>
 #include <webrtc/modules/audio_device/audio_device_impl.h>
 
+#include <math.h>
+
 namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
 
 using zsLib::String;
@@ -252,7 +254,7 @@ namespace ortc
                                                             )
       {
         auto senderChannel = mSenderChannel.lock();
-        if (senderChannel) return senderChannel->sendAudioSamples(audioSamples, nSamples, nChannels);
+        if (senderChannel) return senderChannel->sendAudioSamples(audioSamples, nSamples, nChannels, samplesPerSec);
         return 0;
       }
 
@@ -269,7 +271,7 @@ namespace ortc
                                                      )
       {
         auto receiverChannel = mReceiverChannel.lock();
-        if (receiverChannel) return receiverChannel->getAudioSamples(nSamples, nChannels, audioSamples, nSamplesOut);
+        if (receiverChannel) return receiverChannel->getAudioSamples(nSamples, nChannels, samplesPerSec, audioSamples, nSamplesOut);
         return 0;
       }
 
@@ -971,6 +973,49 @@ namespace ortc
         AutoRecursiveLock lock(*this);
       }
 
+      //-----------------------------------------------------------------------
+      void RTPChannelAudioTester::sendExternalAudio(const char *senderChannelAudioID)
+      {
+        const size_t samplesPerFrame = 480;   // 10ms @ 48kHz mono
+        const double pi = 3.14159265358979323846;
+
+        UseSenderChannelAudioForSenderChannelPtr senderChannelAudio = getSenderChannelAudio(senderChannelAudioID);
+        TESTING_CHECK(senderChannelAudio)
+        if (!senderChannelAudio) return;
+
+        int16_t samples[samplesPerFrame];
+        for (size_t index = 0; index < samplesPerFrame; ++index, ++mExternalAudioPhase) {
+          samples[index] = static_cast<int16_t>(8000.0 * sin((2.0 * pi * 440.0 * static_cast<double>(mExternalAudioPhase)) / 48000.0));
+        }
+
+        TESTING_CHECK(0 == senderChannelAudio->sendAudioSamples(samples, samplesPerFrame, 1, 48000))
+      }
+
+      //-----------------------------------------------------------------------
+      void RTPChannelAudioTester::receiveExternalAudio(const char *receiverChannelAudioID)
+      {
+        const size_t samplesPerFrame = 480;   // 10ms @ 48kHz mono
+
+        UseReceiverChannelAudioForReceiverChannelPtr receiverChannelAudio = getReceiverChannelAudio(receiverChannelAudioID);
+        TESTING_CHECK(receiverChannelAudio)
+        if (!receiverChannelAudio) return;
+
+        int16_t samples[samplesPerFrame];
+        size_t samplesOut {};
+
+        TESTING_CHECK(0 == receiverChannelAudio->getAudioSamples(samplesPerFrame, 1, 48000, samples, samplesOut))
+        TESTING_CHECK(samplesPerFrame == samplesOut)
+
+        int peak = 0;
+        for (size_t index = 0; index < samplesOut; ++index) {
+          int value = static_cast<int>(samples[index]);
+          if (value < 0) value = -value;
+          if (value > peak) peak = value;
+        }
+
+        if (peak > 1000) ++mExternalAudioFramesWithSignal;
+      }
+
       //-----------------------------------------------------------------------
       void RTPChannelAudioTester::attach(
                                          const char *trackID,
@@ -1607,6 +1652,7 @@ using ortc::SecureByteBlockPtr;
 
 #define TEST_BASIC_MEDIA 0
 #define TEST_ADVANCED_MEDIA 1
+#define TEST_EXTERNAL_AUDIO 2
 
 static void bogusSleep()
 {
@@ -1673,6 +1719,16 @@ void doTestRTPChannelAudio()
           }
           break;
         }
+        case TEST_EXTERNAL_AUDIO: {
+          {
+            testObject1 = RTPChannelAudioTester::create(thread, false);
+            testObject2 = RTPChannelAudioTester::create(thread, false);
+
+            TESTING_CHECK(testObject1)
+            TESTING_CHECK(testObject2)
+          }
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -1934,6 +1990,63 @@ void doTestRTPChannelAudio()
             }
             break;
           }
+          case TEST_EXTERNAL_AUDIO: {
+            switch (step) {
+              case 2: {
+                if (testObject1) testObject1->connect(testObject2);
+                break;
+              }
+              case 3: {
+                if (testObject1) testObject1->createMediaStreamTrack("lt", false);
+                if (testObject2) testObject2->createMediaStreamTrack("rt", true);
+                if (testObject1) testObject1->createSenderChannel("sc", "lt", "");
+                if (testObject2) testObject2->createReceiverChannel("rc", "rt", "");
+                if (testObject1) testObject1->createSenderChannelAudio("sc", "sca", "lt", "");
+                if (testObject2) testObject2->createReceiverChannelAudio("rc", "rca", "rt", "");
+                break;
+              }
+              case 4: {
+                if (testObject1) testObject1->send("sc", "");
+                if (testObject2) testObject2->receive("rc", "");
+                break;
+              }
+              case 5: {
+                // no audio device involved; inject and extract 5 seconds of
+                // PCM in 10ms frames
+                for (int loop = 0; loop < 500; ++loop) {
+                  if (testObject1) testObject1->sendExternalAudio("sca");
+                  if (testObject2) testObject2->receiveExternalAudio("rca");
+                  TESTING_SLEEP(10)
+                }
+                break;
+              }
+              case 6: {
+                if (testObject2) {
+                  TESTING_CHECK(testObject2->mExternalAudioFramesWithSignal > 0)
+                }
+                break;
+              }
+              case 7: {
+                if (testObject1) testObject1->stop("sc");
+                if (testObject2) testObject2->stop("rc");
+                break;
+              }
+              case 8: {
+                if (testObject1) testObject1->close();
+                if (testObject2) testObject2->close();
+                break;
+              }
+              case 9: {
+                lastStepReached = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
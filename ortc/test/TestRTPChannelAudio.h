@@ -606,6 +606,9 @@ namespace ortc
         
         void stop(const char *senderOrReceiverChannelID);
 
+        void sendExternalAudio(const char *senderChannelAudioID);
+        void receiveExternalAudio(const char *receiverChannelAudioID);
+
         void attach(
                     const char *trackID,
                     FakeMediaStreamTrackPtr mediaStreamTrack
@@ -787,6 +790,9 @@ namespace ortc
         FakeSenderChannelMap mSenderChannels;
         ReceiverChannelAudioMap mReceiverAudioChannels;
         SenderChannelAudioMap mSenderAudioChannels;
+
+        ULONG mExternalAudioPhase {};
+        ULONG mExternalAudioFramesWithSignal {};
       };
     }
   }
@@ -942,6 +942,36 @@ namespace ortc
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      bool FakeSender::handleFeedback(
+                                      IICETypes::Components viaTransport,
+                                      RTCPPacketPtr packet,
+                                      const FeedbackEventList &events
+                                      )
+      {
+        TESTING_CHECK(packet)
+        TESTING_CHECK(events.size() > 0)
+
+        {
+          AutoRecursiveLock lock(*this);
+
+          TESTING_CHECK(mParameters)
+
+          // only feedback targeting this sender's own SSRCs may be routed here
+          for (auto iter = events.begin(); iter != events.end(); ++iter) {
+            bool owned = false;
+            for (auto iterEncoding = mParameters->mEncodings.begin(); iterEncoding != mParameters->mEncodings.end(); ++iterEncoding) {
+              auto &encoding = (*iterEncoding);
+              if (!encoding.mSSRC.hasValue()) continue;
+              if (encoding.mSSRC.value() == (*iter).mSSRC) owned = true;
+            }
+            TESTING_CHECK(owned)
+          }
+        }
+
+        return handlePacket(viaTransport, packet);
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1694,6 +1724,7 @@ using ortc::SecureByteBlockPtr;
 
 #define TEST_BASIC_ROUTING 0
 #define TEST_BASIC_ROUTING_EXTENDED_SOURCE 1
+#define TEST_FEEDBACK_ROUTING 2
 
 static void bogusSleep()
 {
@@ -1775,6 +1806,21 @@ void doTestRTPListener()
           expectations1.mUnhandled = 0;
           break;
         }
+        case TEST_FEEDBACK_ROUTING:
+        {
+          testObject1 = RTPListenerTester::create(thread);
+          testObject2 = RTPListenerTester::create(thread);
+
+          TESTING_CHECK(testObject1)
+          TESTING_CHECK(testObject2)
+
+          testObject1->setClientRole(true);
+          testObject2->setClientRole(false);
+
+          expectations1.mReceivedPackets = 4;
+          expectations1.mUnhandled = 0;
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -2096,6 +2142,116 @@ void doTestRTPListener()
             }
             break;
           }
+          case TEST_FEEDBACK_ROUTING: {
+            switch (step) {
+              case 1: {
+                if (testObject1) testObject1->connect(testObject2);
+                if (testObject1) testObject1->state(IICETransport::State_Completed);
+                if (testObject2) testObject2->state(IICETransport::State_Completed);
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Connected);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Connected);
+                //bogusSleep();
+                break;
+              }
+              case 2: {
+                Parameters params;
+                EncodingParameters encoding;
+
+                encoding.mSSRC = 5;
+                params.mEncodings.push_back(encoding);
+                testObject1->send("s5", params);
+
+                params.mEncodings.clear();
+                encoding.mSSRC = 6;
+                params.mEncodings.push_back(encoding);
+                testObject1->send("s6", params);
+
+                testObject2->send("s1", Parameters());
+                //bogusSleep();
+                break;
+              }
+              case 3: {
+                typedef RTCPPacket::PayloadSpecificFeedbackMessage PayloadSpecificFeedbackMessage;
+                typedef RTCPPacket::TransportLayerFeedbackMessage TransportLayerFeedbackMessage;
+
+                PayloadSpecificFeedbackMessage pli;
+                pli.mVersion = 2;
+                pli.mPT = PayloadSpecificFeedbackMessage::kPayloadType;
+                pli.mReportSpecific = PayloadSpecificFeedbackMessage::PLI::kFmt;
+                pli.mSSRCOfPacketSender = 1;
+                pli.mSSRCOfMediaSource = 6;
+
+                TransportLayerFeedbackMessage::GenericNACK lost;
+                lost.mPID = 100;
+                lost.mBLP = 0x0003;
+
+                TransportLayerFeedbackMessage nack;
+                nack.mVersion = 2;
+                nack.mPT = TransportLayerFeedbackMessage::kPayloadType;
+                nack.mReportSpecific = TransportLayerFeedbackMessage::GenericNACK::kFmt;
+                nack.mSSRCOfPacketSender = 1;
+                nack.mSSRCOfMediaSource = 5;
+                nack.mGenericNACKCount = 1;
+                nack.mFirstGenericNACK = &lost;
+
+                auto packet = RTCPPacket::create(&pli);
+                testObject1->store("f6", packet);
+                testObject2->store("f6", packet);
+
+                packet = RTCPPacket::create(&nack);
+                testObject1->store("f5", packet);
+                testObject2->store("f5", packet);
+
+                // one compound packet targeting both senders
+                pli.mNext = &nack;
+                packet = RTCPPacket::create(&pli);
+                testObject1->store("f56", packet);
+                testObject2->store("f56", packet);
+
+                pli.mNext = NULL;
+                nack.mFirstGenericNACK = NULL;
+                //bogusSleep();
+                break;
+              }
+              case 4: {
+                testObject1->expectPacket("s6", "f6");
+                testObject2->sendPacket("s1", "f6");
+                //bogusSleep();
+                break;
+              }
+              case 5: {
+                testObject1->expectPacket("s5", "f5");
+                testObject2->sendPacket("s1", "f5");
+                //bogusSleep();
+                break;
+              }
+              case 6: {
+                testObject1->expectPacket("s5", "f56");
+                testObject1->expectPacket("s6", "f56");
+                testObject2->sendPacket("s1", "f56");
+                //bogusSleep();
+                break;
+              }
+              case 7: {
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Closed);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Closed);
+                if (testObject1) testObject1->state(IICETransport::State_Closed);
+                if (testObject2) testObject2->state(IICETransport::State_Closed);
+                //bogusSleep();
+                break;
+              }
+              case 8: {
+                lastStepReached = true;
+                //bogusSleep();
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -281,6 +281,14 @@ static BYTE gHeader5[] =
   0x10, 0x05, 0x00, 0x00
 };
 
+static BYTE gHeader6[] =
+{
+  0xBE, 0xDE, 0x00, 0x03,
+  0x14, 0x61, 0x75, 0x64,
+  0x69, 0x6F, 0x00, 0x00,
+  0x21, 0x72, 0x30, 0x00
+};
+
 void doTestRTPPacket()
 {
   if (!ORTC_TEST_DO_RTP_PACKET_TEST) return;
@@ -1022,6 +1030,61 @@ void doTestRTPPacket()
                 break;
               }
               case 7: {
+                const char *payload = "HEADROOM";
+                auto source = Tester::createPacket(2, 0, 0, true, 96, 7, 4096, 8, NULL, NULL, 0, payload);
+
+                size_t headroom = RTPPacket::kDefaultHeaderExtensionHeadroom;
+
+                auto packet = RTPPacket::create(source->BytePtr(), source->SizeInBytes(), headroom);
+                TESTING_CHECK(packet)
+                TESTING_EQUAL(headroom, packet->headroom())
+                TESTING_EQUAL(0, UseServicesHelper::compare(*source, *(packet->buffer())))
+
+                const BYTE *originalPayload = packet->payload();
+
+                RTPPacket::StringHeaderExtension ridHeader(2, "r0");
+                packet->setHeaderExtension(ridHeader);
+
+                RTPPacket::StringHeaderExtension muxHeader(1, "audio");
+                packet->setHeaderExtension(muxHeader);
+
+                // only the fixed header moved into the reserved headroom
+                TESTING_CHECK(originalPayload == packet->payload())
+                TESTING_EQUAL(headroom - sizeof(gHeader6), packet->headroom())
+
+                TESTING_EQUAL(7, packet->sequenceNumber())
+                TESTING_CHECK(packet->m())
+                TESTING_EQUAL(2, packet->totalHeaderExtensions())
+
+                {
+                  RTPPacket::HeaderExtension *current = packet->firstHeaderExtension();
+                  TESTING_CHECK(current)
+                  TESTING_EQUAL(1, current->mID)
+                  TESTING_EQUAL(5, current->mDataSizeInBytes)
+                  TESTING_EQUAL(packet->getHeaderExtensionAtIndex(1), current->mNext)
+                }
+
+                {
+                  RTPPacket::HeaderExtension *current = packet->getHeaderExtensionAtIndex(1);
+                  TESTING_CHECK(current)
+                  TESTING_EQUAL(2, current->mID)
+                  TESTING_EQUAL(2, current->mDataSizeInBytes)
+                  TESTING_EQUAL(NULL, current->mNext)
+                }
+
+                auto tempPacket = Tester::createPacket(2, 0, 0, true, 96, 7, 4096, 8, NULL, &gHeader6[0], sizeof(gHeader6), payload);
+                TESTING_EQUAL(0, UseServicesHelper::compare(*tempPacket, *(packet->buffer())))
+
+                // same sized value is replaced without moving anything
+                RTPPacket::StringHeaderExtension muxHeader2(1, "video");
+                packet->setHeaderExtension(muxHeader2);
+
+                TESTING_EQUAL(headroom - sizeof(gHeader6), packet->headroom())
+                TESTING_EQUAL(2, packet->totalHeaderExtensions())
+                TESTING_EQUAL('v', packet->firstHeaderExtension()->mData[0])
+                break;
+              }
+              case 8: {
                 reachedFinalStep = true;
                 break;
               }
@@ -1079,3 +1142,97 @@ void doTestRTPPacket()
   zsLib::proxyDump();
   TESTING_EQUAL(zsLib::proxyGetTotalConstructed(), 0);
 }
+
+//-----------------------------------------------------------------------------
+static RTPPacketPtr createBenchmarkPacket(size_t totalHeaderExtensions)
+{
+  static const BYTE extensionData[] = {0x11, 0x22, 0x33, 0x44};
+
+  RTPPacket::HeaderExtension extensions[5];
+  for (size_t index = 0; index < totalHeaderExtensions; ++index) {
+    extensions[index].mID = static_cast<BYTE>(index + 1);
+    extensions[index].mData = extensionData;
+    extensions[index].mDataSizeInBytes = (index % sizeof(extensionData)) + 1;
+    extensions[index].mNext = (index + 1 < totalHeaderExtensions ? &(extensions[index + 1]) : NULL);
+  }
+
+  BYTE payload[160] {};
+
+  RTPPacket::CreationParams params;
+  params.mPT = 96;
+  params.mSequenceNumber = 1;
+  params.mTimestamp = 10000;
+  params.mSSRC = 5;
+  params.mPayload = payload;
+  params.mPayloadSize = sizeof(payload);
+  params.mFirstHeaderExtension = (0 != totalHeaderExtensions ? &(extensions[0]) : NULL);
+
+  return RTPPacket::create(params);
+}
+
+//-----------------------------------------------------------------------------
+static void benchmarkRTPPacket(
+                               size_t totalHeaderExtensions,
+                               ULONG iterations
+                               )
+{
+  auto original = createBenchmarkPacket(totalHeaderExtensions);
+  TESTING_CHECK(original)
+  if (!original) return;
+
+  TESTING_EQUAL(totalHeaderExtensions, original->totalHeaderExtensions())
+
+  auto check = RTPPacket::create(original->ptr(), original->size());
+  TESTING_CHECK(check)
+  if (!check) return;
+  TESTING_EQUAL(totalHeaderExtensions, check->totalHeaderExtensions())
+
+  zsLib::String operation = "parse, header extensions=" + zsLib::string(totalHeaderExtensions);
+
+  {
+    size_t parsed = 0;
+
+    size_t allocations = Testing::getTotalAllocations();
+    zsLib::Time start = zsLib::now();
+    for (ULONG loop = 0; loop < iterations; ++loop) {
+      auto packet = RTPPacket::create(original->ptr(), original->size());
+      if (packet) ++parsed;
+    }
+    auto total = zsLib::toMicroseconds(zsLib::now() - start);
+    allocations = Testing::getTotalAllocations() - allocations;
+
+    TESTING_EQUAL(parsed, iterations)
+
+    Testing::outputOperationBenchmark("rtpPacketBenchmark", operation.c_str(), iterations, original->size(), total, allocations);
+  }
+
+  operation = "generate, header extensions=" + zsLib::string(totalHeaderExtensions);
+
+  {
+    size_t generated = 0;
+
+    size_t allocations = Testing::getTotalAllocations();
+    zsLib::Time start = zsLib::now();
+    for (ULONG loop = 0; loop < iterations; ++loop) {
+      auto packet = createBenchmarkPacket(totalHeaderExtensions);
+      if (packet) ++generated;
+    }
+    auto total = zsLib::toMicroseconds(zsLib::now() - start);
+    allocations = Testing::getTotalAllocations() - allocations;
+
+    TESTING_EQUAL(generated, iterations)
+
+    Testing::outputOperationBenchmark("rtpPacketBenchmark", operation.c_str(), iterations, original->size(), total, allocations);
+  }
+}
+
+void doTestRTPPacketBenchmark()
+{
+  if (!ORTC_TEST_DO_PACKET_BENCHMARK) return;
+
+  UseSettings::applyDefaults();
+
+  benchmarkRTPPacket(0, ORTC_TEST_PACKET_BENCHMARK_ITERATIONS);
+  benchmarkRTPPacket(1, ORTC_TEST_PACKET_BENCHMARK_ITERATIONS);
+  benchmarkRTPPacket(5, ORTC_TEST_PACKET_BENCHMARK_ITERATIONS);
+}
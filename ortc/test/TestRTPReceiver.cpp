@@ -1818,6 +1818,16 @@ namespace ortc
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      bool FakeSender::handleFeedback(
+                                      IICETypes::Components viaTransport,
+                                      RTCPPacketPtr packet,
+                                      const FeedbackEventList &events
+                                      )
+      {
+        return handlePacket(viaTransport, packet);
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -938,6 +938,12 @@ namespace ortc
                                   RTCPPacketPtr packet
                                   ) override;
 
+        virtual bool handleFeedback(
+                                    IICETypes::Components viaTransport,
+                                    RTCPPacketPtr packet,
+                                    const FeedbackEventList &events
+                                    ) override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark FakeSender => (friend RTPReceiverTester)
@@ -0,0 +1,564 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+#include <ortc/internal/ortc_RTPRelay.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
+#include <ortc/internal/ortc_RTPSender.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::PUID;
+using zsLib::AutoRecursiveLock;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtprelay
+    {
+      ZS_DECLARE_CLASS_PTR(FakeRelayReceiver)
+      ZS_DECLARE_CLASS_PTR(FakeRelaySender)
+
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTCPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, IRTPRelayForRTPReceiver)
+      ZS_DECLARE_USING_PTR(ortc::internal, IRTPRelayForRTPSender)
+
+      typedef RTCPPacket::FeedbackEvent FeedbackEvent;
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+      typedef std::list<RTPPacketPtr> RTPPacketList;
+      typedef std::list<RTCPPacketPtr> RTCPPacketList;
+
+      static const BYTE kReceiverPayloadType = 100;
+      static const BYTE kSenderPayloadType = 96;
+      static const DWORD kSourceSSRC = 0xAAAA0001;
+      static const DWORD kSenderSSRC = 0xBBBB0001;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeRelayReceiver
+      #pragma mark
+
+      // Stands in for the RTPReceiver a relay is attached to; records the
+      // relay registration and the key frame requests sent upstream.
+      class FakeRelayReceiver : public ortc::internal::RTPReceiver
+      {
+      public:
+        //---------------------------------------------------------------------
+        FakeRelayReceiver() :
+          RTPReceiver(Noop(true))
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static FakeRelayReceiverPtr create()
+        {
+          FakeRelayReceiverPtr pThis(make_shared<FakeRelayReceiver>());
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void registerRelay(UseRelayPtr relay) override
+        {
+          AutoRecursiveLock lock(*this);
+          mRelay = relay;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void unregisterRelay(PUID relayID) override
+        {
+          AutoRecursiveLock lock(*this);
+          if (!mRelay) return;
+          if (mRelay->getID() != relayID) return;
+          mRelay.reset();
+        }
+
+        //---------------------------------------------------------------------
+        virtual bool sendPacket(RTCPPacketPtr packet) override
+        {
+          AutoRecursiveLock lock(*this);
+          mSentPackets.push_back(packet);
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        void deliver(
+                     IRTPTypes::ParametersPtr params,
+                     const String &encodingID,
+                     RTPPacketPtr packet
+                     )
+        {
+          UseRelayPtr relay;
+          {
+            AutoRecursiveLock lock(*this);
+            relay = mRelay;
+          }
+          // mirrors the receiver which notifies relays outside its lock
+          if (relay) relay->notifyReceivedPacket(params, encodingID, packet);
+        }
+
+        //---------------------------------------------------------------------
+        bool hasRelay() const
+        {
+          AutoRecursiveLock lock(*this);
+          return (bool)mRelay;
+        }
+
+        //---------------------------------------------------------------------
+        size_t getSentPackets() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mSentPackets.size();
+        }
+
+        //---------------------------------------------------------------------
+        RTCPPacketPtr getLastSentPacket() const
+        {
+          AutoRecursiveLock lock(*this);
+          if (mSentPackets.size() < 1) return RTCPPacketPtr();
+          return mSentPackets.back();
+        }
+
+      protected:
+        UseRelayPtr mRelay;
+        RTCPPacketList mSentPackets;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeRelaySender
+      #pragma mark
+
+      // Stands in for an RTPSender being fed by a relay; records the
+      // rewritten packets handed to it.
+      class FakeRelaySender : public ortc::internal::RTPSender
+      {
+      public:
+        //---------------------------------------------------------------------
+        FakeRelaySender(IRTPTypes::ParametersPtr params) :
+          RTPSender(Noop(true)),
+          mSendParameters(params)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static FakeRelaySenderPtr create(IRTPTypes::ParametersPtr params)
+        {
+          FakeRelaySenderPtr pThis(make_shared<FakeRelaySender>(params));
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        virtual ParametersPtr registerRelay(UseRelayPtr relay) override
+        {
+          AutoRecursiveLock lock(*this);
+          mRelay = relay;
+          return mSendParameters;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void unregisterRelay(PUID relayID) override
+        {
+          AutoRecursiveLock lock(*this);
+          if (!mRelay) return;
+          if (mRelay->getID() != relayID) return;
+          mRelay.reset();
+        }
+
+        //---------------------------------------------------------------------
+        virtual bool sendRelayedPacket(RTPPacketPtr packet) override
+        {
+          AutoRecursiveLock lock(*this);
+          mRelayedPackets.push_back(packet);
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        bool feedback(const FeedbackEventList &events)
+        {
+          UseRelayPtr relay;
+          {
+            AutoRecursiveLock lock(*this);
+            relay = mRelay;
+          }
+          if (!relay) return false;
+          return relay->notifySenderFeedback(RTPSender::getID(), events);
+        }
+
+        //---------------------------------------------------------------------
+        bool hasRelay() const
+        {
+          AutoRecursiveLock lock(*this);
+          return (bool)mRelay;
+        }
+
+        //---------------------------------------------------------------------
+        size_t getRelayedPackets() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mRelayedPackets.size();
+        }
+
+        //---------------------------------------------------------------------
+        RTPPacketPtr getLastRelayedPacket() const
+        {
+          AutoRecursiveLock lock(*this);
+          if (mRelayedPackets.size() < 1) return RTPPacketPtr();
+          return mRelayedPackets.back();
+        }
+
+      protected:
+        ParametersPtr mSendParameters;
+        UseRelayPtr mRelay;
+        RTPPacketList mRelayedPackets;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static IRTPTypes::ParametersPtr createParameters(
+                                                       BYTE payloadType,
+                                                       const char *encodingID,
+                                                       Optional<DWORD> ssrc
+                                                       )
+      {
+        auto params = make_shared<IRTPTypes::Parameters>();
+
+        IRTPTypes::CodecParameters codec;
+        codec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_VP8);
+        codec.mPayloadType = payloadType;
+        codec.mClockRate = 90000;
+        params->mCodecs.push_back(codec);
+
+        IRTPTypes::EncodingParameters encoding;
+        encoding.mEncodingID = encodingID;
+        encoding.mSSRC = ssrc;
+        params->mEncodings.push_back(encoding);
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPPacketPtr createVP8Packet(
+                                          BYTE payloadType,
+                                          WORD sequenceNumber,
+                                          DWORD timestamp,
+                                          bool keyFrame
+                                          )
+      {
+        // see https://tools.ietf.org/html/rfc7741#section-4.2 (start of
+        // partition 0; the inverse key frame flag leads the VP8 header)
+        BYTE payload[4] {};
+        payload[0] = 0x10;
+        payload[1] = (keyFrame ? 0x00 : 0x01);
+
+        RTPPacket::CreationParams params;
+        params.mPT = payloadType;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = timestamp;
+        params.mSSRC = kSourceSSRC;
+        params.mPayload = payload;
+        params.mPayloadSize = sizeof(payload);
+        return RTPPacket::create(params);
+      }
+
+      //-----------------------------------------------------------------------
+      static RTPPacketPtr createVP8LayerPacket(
+                                               BYTE payloadType,
+                                               WORD sequenceNumber,
+                                               DWORD timestamp,
+                                               bool keyFrame,
+                                               BYTE temporalLayerID
+                                               )
+      {
+        // extended descriptor carrying only the TID field (T bit)
+        BYTE payload[5] {};
+        payload[0] = 0x90;
+        payload[1] = 0x20;
+        payload[2] = static_cast<BYTE>(temporalLayerID << 6);
+        payload[3] = (keyFrame ? 0x00 : 0x01);
+
+        RTPPacket::CreationParams params;
+        params.mPT = payloadType;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = timestamp;
+        params.mSSRC = kSourceSSRC;
+        params.mPayload = payload;
+        params.mPayloadSize = sizeof(payload);
+        return RTPPacket::create(params);
+      }
+
+      //-----------------------------------------------------------------------
+      static FeedbackEventList createFeedback(FeedbackEvent::Types type)
+      {
+        FeedbackEvent event;
+        event.mType = type;
+        event.mSSRC = kSenderSSRC;
+
+        FeedbackEventList events;
+        events.push_back(event);
+        return events;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testForwarding()
+      {
+        auto receiverParams = createParameters(kReceiverPayloadType, "r0", Optional<DWORD>());
+        auto receiver = FakeRelayReceiver::create();
+        auto sender = FakeRelaySender::create(createParameters(kSenderPayloadType, "s0", kSenderSSRC));
+
+        auto relay = IRTPRelay::create(receiver);
+        TESTING_CHECK(relay)
+        if (!relay) return;
+        TESTING_CHECK(receiver->hasRelay())
+
+        relay->addSender(sender);
+        TESTING_CHECK(sender->hasRelay())
+
+        // forwarding only starts on a key frame
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 5000, 90000, false));
+        TESTING_EQUAL(sender->getRelayedPackets(), 0)
+
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 5001, 93000, true));
+        TESTING_EQUAL(sender->getRelayedPackets(), 1)
+
+        auto packet = sender->getLastRelayedPacket();
+        TESTING_CHECK(packet)
+        if (packet) {
+          TESTING_EQUAL(packet->pt(), kSenderPayloadType)
+          TESTING_EQUAL(packet->ssrc(), kSenderSSRC)
+          TESTING_EQUAL(packet->sequenceNumber(), 5001)
+          TESTING_EQUAL(packet->timestamp(), 93000)
+        }
+
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 5002, 96000, false));
+        TESTING_EQUAL(sender->getRelayedPackets(), 2)
+
+        // unknown payload types and other encodings are never forwarded
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType + 1, 5003, 99000, true));
+        receiver->deliver(receiverParams, "r1", createVP8Packet(kReceiverPayloadType, 5003, 99000, true));
+        TESTING_EQUAL(sender->getRelayedPackets(), 2)
+
+        relay->stop();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testDroppedSequenceNumbers()
+      {
+        auto receiverParams = createParameters(kReceiverPayloadType, "r0", Optional<DWORD>());
+        auto receiver = FakeRelayReceiver::create();
+        auto sender = FakeRelaySender::create(createParameters(kSenderPayloadType, "s0", kSenderSSRC));
+
+        auto relay = IRTPRelay::create(receiver);
+        TESTING_CHECK(relay)
+        if (!relay) return;
+
+        IRTPRelayTypes::Options options;
+        options.mMaxTemporalLayerID = 0;
+        relay->addSender(sender, options);
+
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 10, 0, true, 0));
+        TESTING_EQUAL(sender->getRelayedPackets(), 1)
+
+        // a dropped layer leaves no hole in the outgoing sequence numbers
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 11, 3000, false, 1));
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 12, 3000, false, 0));
+        TESTING_EQUAL(sender->getRelayedPackets(), 2)
+        auto packet = sender->getLastRelayedPacket();
+        TESTING_CHECK(packet)
+        if (packet) TESTING_EQUAL(packet->sequenceNumber(), 11)
+
+        // a gap in the source stays a gap
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 14, 6000, false, 0));
+        packet = sender->getLastRelayedPacket();
+        TESTING_CHECK(packet)
+        if (packet) TESTING_EQUAL(packet->sequenceNumber(), 13)
+
+        // dropping the late packet which fell into that gap must not shift
+        // the packets which follow it
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 13, 3000, false, 1));
+        receiver->deliver(receiverParams, "r0", createVP8LayerPacket(kReceiverPayloadType, 15, 9000, false, 0));
+        TESTING_EQUAL(sender->getRelayedPackets(), 4)
+        packet = sender->getLastRelayedPacket();
+        TESTING_CHECK(packet)
+        if (packet) TESTING_EQUAL(packet->sequenceNumber(), 14)
+
+        relay->stop();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testFeedback()
+      {
+        auto receiverParams = createParameters(kReceiverPayloadType, "r0", Optional<DWORD>());
+        auto receiver = FakeRelayReceiver::create();
+        auto sender = FakeRelaySender::create(createParameters(kSenderPayloadType, "s0", kSenderSSRC));
+
+        auto relay = IRTPRelay::create(receiver);
+        TESTING_CHECK(relay)
+        if (!relay) return;
+
+        relay->addSender(sender);
+
+        // nothing is being forwarded yet thus nothing can be requested
+        TESTING_CHECK(!sender->feedback(createFeedback(FeedbackEvent::Type_PLI)))
+        TESTING_EQUAL(receiver->getSentPackets(), 0)
+
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 100, 0, true));
+        TESTING_EQUAL(sender->getRelayedPackets(), 1)
+
+        // NACK / REMB are left to the sender
+        TESTING_CHECK(!sender->feedback(createFeedback(FeedbackEvent::Type_GenericNACK)))
+        TESTING_CHECK(!sender->feedback(createFeedback(FeedbackEvent::Type_REMB)))
+        TESTING_EQUAL(receiver->getSentPackets(), 0)
+
+        TESTING_CHECK(sender->feedback(createFeedback(FeedbackEvent::Type_PLI)))
+        TESTING_EQUAL(receiver->getSentPackets(), 1)
+
+        auto request = receiver->getLastSentPacket();
+        TESTING_CHECK(request)
+        if ((request) &&
+            (request->size() >= 12)) {
+          auto buffer = request->ptr();
+          TESTING_EQUAL(buffer[1], 206)
+          TESTING_EQUAL(internal::RTPUtils::getBE32(&(buffer[8])), kSourceSSRC)
+        }
+
+        // repeated requests are throttled and thus not forwarded
+        TESTING_CHECK(!sender->feedback(createFeedback(FeedbackEvent::Type_FIR)))
+        TESTING_EQUAL(receiver->getSentPackets(), 1)
+
+        relay->stop();
+      }
+
+      //-----------------------------------------------------------------------
+      static void testTeardown()
+      {
+        auto receiverParams = createParameters(kReceiverPayloadType, "r0", Optional<DWORD>());
+        auto receiver = FakeRelayReceiver::create();
+        auto sender1 = FakeRelaySender::create(createParameters(kSenderPayloadType, "s0", kSenderSSRC));
+        auto sender2 = FakeRelaySender::create(createParameters(kSenderPayloadType, "s0", kSenderSSRC + 1));
+
+        auto relay = IRTPRelay::create(receiver);
+        TESTING_CHECK(relay)
+        if (!relay) return;
+
+        relay->addSender(sender1);
+        relay->addSender(sender2);
+
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 1, 0, true));
+        TESTING_EQUAL(sender1->getRelayedPackets(), 1)
+        TESTING_EQUAL(sender2->getRelayedPackets(), 1)
+
+        // a removed sender is unregistered and no longer fed
+        relay->removeSender(sender2);
+        TESTING_CHECK(!sender2->hasRelay())
+
+        receiver->deliver(receiverParams, "r0", createVP8Packet(kReceiverPayloadType, 2, 3000, false));
+        TESTING_EQUAL(sender1->getRelayedPackets(), 2)
+        TESTING_EQUAL(sender2->getRelayedPackets(), 1)
+
+        relay->stop();
+        TESTING_CHECK(!receiver->hasRelay())
+        TESTING_CHECK(!sender1->hasRelay())
+
+        // senders cannot be added to a stopped relay
+        bool threw = false;
+        try {
+          relay->addSender(sender2);
+        } catch (const InvalidStateError &) {
+          threw = true;
+        }
+        TESTING_CHECK(threw)
+
+        relay->stop();  // stopping twice is harmless
+        relay.reset();
+        TESTING_CHECK(!receiver->hasRelay())
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtprelay;
+
+void doTestRTPRelay()
+{
+  if (!ORTC_TEST_DO_RTP_RELAY_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+  UseSettings::setUInt(ORTC_SETTING_RTP_RELAY_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS, 60*1000);
+
+  testForwarding();
+  testDroppedSequenceNumbers();
+  testFeedback();
+  testTeardown();
+
+  TESTING_UNINSTALL_LOGGER();
+}
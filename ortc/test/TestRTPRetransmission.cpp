@@ -0,0 +1,456 @@
+/*
+ 
+ Copyright (c) 2016, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_RTPSender.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::Milliseconds;
+using zsLib::AutoRecursiveLock;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtpretransmission
+    {
+      ZS_DECLARE_CLASS_PTR(RetransmissionSender)
+
+      ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      ZS_DECLARE_USING_PTR(ortc::internal, RTCPPacket)
+
+      typedef RTCPPacket::FeedbackEvent FeedbackEvent;
+      typedef RTCPPacket::FeedbackEventList FeedbackEventList;
+
+      static const BYTE kPayloadType = 96;
+      static const BYTE kRTXPayloadType = 97;
+      static const DWORD kSSRC = 0xAAAA0001;
+      static const DWORD kRTXSSRC = 0xAAAA0002;
+      static const size_t kPayloadSize = 100;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RetransmissionSender
+      #pragma mark
+
+      // Exposes the retransmission history of an RTPSender without a
+      // transport or channels attached; retransmissions are counted by the
+      // history rather than sent.
+      class RetransmissionSender : public ortc::internal::RTPSender
+      {
+      public:
+        //---------------------------------------------------------------------
+        RetransmissionSender() :
+          RTPSender(Noop(true))
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static RetransmissionSenderPtr create()
+        {
+          RetransmissionSenderPtr pThis(make_shared<RetransmissionSender>());
+          pThis->mThisWeak = pThis;
+          return pThis;
+        }
+
+        //---------------------------------------------------------------------
+        RetransmissionHistory &addHistory(
+                                          DWORD ssrc,
+                                          size_t maxPackets,
+                                          size_t maxBytes
+                                          )
+        {
+          AutoRecursiveLock lock(*this);
+          auto history = make_shared<RetransmissionHistory>(ssrc, maxPackets, maxBytes);
+          mRetransmissionHistories[ssrc] = history;
+          return *history;
+        }
+
+        //---------------------------------------------------------------------
+        void setMinInterval(Milliseconds interval)
+        {
+          AutoRecursiveLock lock(*this);
+          mRetransmissionMinInterval = interval;
+        }
+
+        //---------------------------------------------------------------------
+        void setParameters(ParametersPtr params)
+        {
+          AutoRecursiveLock lock(*this);
+          mParameters = params;
+        }
+
+        //---------------------------------------------------------------------
+        bool nack(
+                  DWORD ssrc,
+                  WORD pid,
+                  WORD blp
+                  )
+        {
+          FeedbackEvent event;
+          event.mType = FeedbackEvent::Type_GenericNACK;
+          event.mSSRC = ssrc;
+          event.mPID = pid;
+          event.mBLP = blp;
+
+          FeedbackEventList events;
+          events.push_back(event);
+          return handleRetransmissionRequests(events);
+        }
+
+        //---------------------------------------------------------------------
+        RTPPacketPtr retransmit(
+                                RetransmissionHistory &history,
+                                RTPPacketPtr packet
+                                )
+        {
+          AutoRecursiveLock lock(*this);
+          return createRetransmission(history, packet);
+        }
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static RTPPacketPtr createPacket(
+                                       WORD sequenceNumber,
+                                       bool marker = false
+                                       )
+      {
+        BYTE payload[kPayloadSize] {};
+        for (size_t index = 0; index < sizeof(payload); ++index) {
+          payload[index] = static_cast<BYTE>(sequenceNumber + index);
+        }
+
+        RTPPacket::CreationParams params;
+        params.mM = marker;
+        params.mPT = kPayloadType;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = static_cast<DWORD>(sequenceNumber) * 3000;
+        params.mSSRC = kSSRC;
+        params.mPayload = payload;
+        params.mPayloadSize = sizeof(payload);
+        return RTPPacket::create(params);
+      }
+
+      //-----------------------------------------------------------------------
+      static void storeRange(
+                             RetransmissionSender::RetransmissionHistory &history,
+                             WORD first,
+                             size_t total
+                             )
+      {
+        for (size_t index = 0; index < total; ++index) {
+          history.store(createPacket(static_cast<WORD>(first + index)));
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static IRTPTypes::ParametersPtr createRTXParameters()
+      {
+        auto params = make_shared<IRTPTypes::Parameters>();
+
+        IRTPTypes::CodecParameters codec;
+        codec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_VP8);
+        codec.mPayloadType = kPayloadType;
+        codec.mClockRate = 90000;
+        params->mCodecs.push_back(codec);
+
+        auto rtxCodecParams = make_shared<IRTPTypes::RTXCodecParameters>();
+        rtxCodecParams->mApt = kPayloadType;
+
+        IRTPTypes::CodecParameters rtxCodec;
+        rtxCodec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_RTX);
+        rtxCodec.mPayloadType = kRTXPayloadType;
+        rtxCodec.mClockRate = 90000;
+        rtxCodec.mParameters = rtxCodecParams;
+        params->mCodecs.push_back(rtxCodec);
+
+        IRTPTypes::RTXParameters rtx;
+        rtx.mSSRC = kRTXSSRC;
+
+        IRTPTypes::EncodingParameters encoding;
+        encoding.mSSRC = kSSRC;
+        encoding.mRTX = rtx;
+        params->mEncodings.push_back(encoding);
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (tests)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      static void testNACKExpansion()
+      {
+        auto sender = RetransmissionSender::create();
+        auto &history = sender->addHistory(kSSRC, 64, 1024*1024);
+        storeRange(history, 100, 21);
+
+        // unknown SSRCs are not answered from any history
+        TESTING_CHECK(!sender->nack(kSSRC + 1, 100, 0))
+
+        // PID plus BLP bits 0 and 2 request 100, 101 and 103
+        TESTING_CHECK(sender->nack(kSSRC, 100, 0x0005))
+        TESTING_EQUAL(history.mNACKCount, 1)
+        TESTING_EQUAL(history.mPacketsRequested, 3)
+        TESTING_EQUAL(history.mPacketsMissing, 0)
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 3)
+        TESTING_CHECK(Time() != history.find(100)->mLastRetransmitted)
+        TESTING_CHECK(Time() != history.find(101)->mLastRetransmitted)
+        TESTING_CHECK(Time() == history.find(102)->mLastRetransmitted)
+        TESTING_CHECK(Time() != history.find(103)->mLastRetransmitted)
+
+        // the highest BLP bit reaches PID + 16; neither packet was ever sent
+        TESTING_CHECK(sender->nack(kSSRC, 130, 0x8000))
+        TESTING_EQUAL(history.mNACKCount, 2)
+        TESTING_EQUAL(history.mPacketsRequested, 5)
+        TESTING_EQUAL(history.mPacketsMissing, 2)
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 3)
+
+        // all 17 packets
+        TESTING_CHECK(sender->nack(kSSRC, 104, 0xFFFF))
+        TESTING_EQUAL(history.mPacketsRequested, 22)
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 20)
+        TESTING_EQUAL(history.mRetransmittedBytesSent, 20 * createPacket(0)->size())
+      }
+
+      //-----------------------------------------------------------------------
+      static void testSequenceNumberWrap()
+      {
+        auto sender = RetransmissionSender::create();
+        auto &history = sender->addHistory(kSSRC, 16, 1024*1024);
+
+        storeRange(history, 0xFFFA, 10);
+        TESTING_EQUAL(history.mOldestSequenceNumber, 0xFFFA)
+        TESTING_EQUAL(history.mNewestSequenceNumber, 3)
+        TESTING_CHECK(history.find(0xFFFA))
+        TESTING_CHECK(history.find(0xFFFF))
+        TESTING_CHECK(history.find(0))
+        TESTING_CHECK(history.find(3))
+        TESTING_CHECK(!history.find(4))
+        TESTING_CHECK(!history.find(0xFFF9))
+
+        // the request spans the wrap: 0xFFFE, 0xFFFF, 0, 1
+        TESTING_CHECK(sender->nack(kSSRC, 0xFFFE, 0x0007))
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 4)
+        TESTING_EQUAL(history.mPacketsMissing, 0)
+
+        // the window slides past the wrap and the oldest are forgotten
+        storeRange(history, 4, 16);
+        TESTING_EQUAL(history.mNewestSequenceNumber, 19)
+        TESTING_CHECK(!history.find(0xFFFF))
+        TESTING_CHECK(!history.find(3))
+        TESTING_CHECK(history.find(4))
+        TESTING_CHECK(history.find(19))
+
+        // late packets behind the window are not kept
+        history.store(createPacket(0xFFF0));
+        TESTING_CHECK(!history.find(0xFFF0))
+      }
+
+      //-----------------------------------------------------------------------
+      static void testEviction()
+      {
+        auto sender = RetransmissionSender::create();
+        size_t packetSize = createPacket(0)->size();
+
+        // bounded by the number of packets
+        {
+          auto &history = sender->addHistory(kSSRC, 8, 1024*1024);
+          storeRange(history, 1, 12);
+
+          for (WORD sequenceNumber = 1; sequenceNumber <= 4; ++sequenceNumber) {
+            TESTING_CHECK(!history.find(sequenceNumber))
+          }
+          for (WORD sequenceNumber = 5; sequenceNumber <= 12; ++sequenceNumber) {
+            TESTING_CHECK(history.find(sequenceNumber))
+          }
+          TESTING_EQUAL(history.mTotalBytes, 8 * packetSize)
+
+          TESTING_CHECK(sender->nack(kSSRC, 3, 0x0003))
+          TESTING_EQUAL(history.mPacketsMissing, 2)
+          TESTING_EQUAL(history.mRetransmittedPacketsSent, 1)
+        }
+
+        // bounded by the number of bytes
+        {
+          auto &history = sender->addHistory(kSSRC, 64, 3 * packetSize);
+          storeRange(history, 1, 5);
+
+          TESTING_EQUAL(history.mTotalBytes, 3 * packetSize)
+          TESTING_CHECK(!history.find(1))
+          TESTING_CHECK(!history.find(2))
+          TESTING_CHECK(history.find(3))
+          TESTING_CHECK(history.find(4))
+          TESTING_CHECK(history.find(5))
+        }
+
+        // a jump beyond the window discards everything remembered
+        {
+          auto &history = sender->addHistory(kSSRC, 8, 1024*1024);
+          storeRange(history, 1, 4);
+          history.store(createPacket(1000));
+
+          TESTING_CHECK(!history.find(4))
+          TESTING_CHECK(history.find(1000))
+          TESTING_EQUAL(history.mTotalBytes, packetSize)
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void testMinInterval()
+      {
+        auto sender = RetransmissionSender::create();
+        auto &history = sender->addHistory(kSSRC, 64, 1024*1024);
+        storeRange(history, 100, 4);
+
+        sender->setMinInterval(Milliseconds(60*1000));
+
+        TESTING_CHECK(sender->nack(kSSRC, 100, 0x0001))
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 2)
+
+        // repeated requests within the interval are ignored per packet
+        TESTING_CHECK(sender->nack(kSSRC, 101, 0x0001))
+        TESTING_EQUAL(history.mPacketsRequested, 4)
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 3)
+
+        // a packet resent into the history is retransmittable again
+        history.store(createPacket(101));
+        TESTING_CHECK(sender->nack(kSSRC, 101, 0))
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 4)
+
+        sender->setMinInterval(Milliseconds());
+        TESTING_CHECK(sender->nack(kSSRC, 100, 0))
+        TESTING_EQUAL(history.mRetransmittedPacketsSent, 5)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRTXLayout()
+      {
+        auto sender = RetransmissionSender::create();
+        auto &history = sender->addHistory(kSSRC, 64, 1024*1024);
+
+        auto original = createPacket(500, true);
+        history.store(original);
+
+        // without a negotiated RTX stream the packet is resent as is
+        TESTING_CHECK(sender->retransmit(history, original) == original)
+
+        sender->setParameters(createRTXParameters());
+        history.mRTXSequenceNumber = 0xFFFF;
+
+        // https://tools.ietf.org/html/rfc4588#section-4
+        auto rtx = sender->retransmit(history, original);
+        TESTING_CHECK(rtx)
+        if (!rtx) return;
+
+        TESTING_CHECK(rtx != original)
+        TESTING_EQUAL(rtx->ssrc(), kRTXSSRC)
+        TESTING_EQUAL(rtx->pt(), kRTXPayloadType)
+        TESTING_CHECK(rtx->m())
+        TESTING_EQUAL(rtx->sequenceNumber(), 0xFFFF)
+        TESTING_EQUAL(rtx->timestamp(), original->timestamp())
+        TESTING_EQUAL(rtx->payloadSize(), original->payloadSize() + sizeof(WORD))
+        TESTING_EQUAL(rtx->size(), original->size() + sizeof(WORD))
+
+        if (rtx->payloadSize() == original->payloadSize() + sizeof(WORD)) {
+          TESTING_EQUAL(internal::RTPUtils::getBE16(rtx->payload()), 500)
+          TESTING_CHECK(0 == memcmp(rtx->payload() + sizeof(WORD), original->payload(), original->payloadSize()))
+        }
+
+        // the RTX stream has its own sequence numbers which wrap
+        TESTING_EQUAL(history.mRTXSequenceNumber, 0)
+        auto next = sender->retransmit(history, original);
+        TESTING_CHECK(next)
+        if (next) TESTING_EQUAL(next->sequenceNumber(), 0)
+        TESTING_EQUAL(history.mRTXSequenceNumber, 1)
+
+        // RTX is only used for payload types it is associated to
+        auto other = createPacket(501);
+        auto unrelated = make_shared<IRTPTypes::RTXCodecParameters>();
+        unrelated->mApt = kPayloadType + 10;
+
+        auto params = createRTXParameters();
+        params->mCodecs.back().mParameters = unrelated;
+        sender->setParameters(params);
+        TESTING_CHECK(sender->retransmit(history, other) == other)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtpretransmission;
+
+void doTestRTPRetransmission()
+{
+  if (!ORTC_TEST_DO_RTP_RETRANSMISSION_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testNACKExpansion();
+  testSequenceNumberWrap();
+  testEviction();
+  testMinInterval();
+  testRTXLayout();
+
+  TESTING_UNINSTALL_LOGGER();
+}
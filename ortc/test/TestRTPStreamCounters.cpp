@@ -0,0 +1,432 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+#include <ortc/internal/ortc_StatsReport.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
+
+#include <ortc/IRTPTypes.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::String;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPPacket, UseRTPPacket)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTCPPacket, UseRTCPPacket)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace rtpstreamcounters
+    {
+      typedef internal::RTPStreamCounters RTPStreamCounters;
+
+      enum TestConstants
+      {
+        kMediaPayloadType = 100,
+        kRTXPayloadType = 101,
+        kClockRate = 90000,
+
+        kMediaSSRC = 0x1000,
+        kRTXSSRC = 0x2000,
+        kEncodingSSRC = 0x3000,
+        kLocalSSRC = 0x4000,
+      };
+
+      //-----------------------------------------------------------------------
+      static IRTPTypes::Parameters createParameters(DWORD encodingSSRC = 0)
+      {
+        IRTPTypes::Parameters params;
+
+        IRTPTypes::CodecParameters media;
+        media.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_VP8);
+        media.mPayloadType = kMediaPayloadType;
+        media.mClockRate = kClockRate;
+        params.mCodecs.push_back(media);
+
+        IRTPTypes::CodecParameters rtx;
+        rtx.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_RTX);
+        rtx.mPayloadType = kRTXPayloadType;
+        rtx.mClockRate = kClockRate;
+        params.mCodecs.push_back(rtx);
+
+        if (0 != encodingSSRC) {
+          IRTPTypes::EncodingParameters encoding;
+          encoding.mSSRC = encodingSSRC;
+          params.mEncodings.push_back(encoding);
+        }
+
+        return params;
+      }
+
+      //-----------------------------------------------------------------------
+      static UseRTPPacketPtr createRTP(
+                                       DWORD ssrc,
+                                       BYTE payloadType,
+                                       WORD sequenceNumber,
+                                       DWORD timestamp
+                                       )
+      {
+        BYTE payload[100] {};
+
+        UseRTPPacket::CreationParams params;
+        params.mPT = payloadType;
+        params.mSequenceNumber = sequenceNumber;
+        params.mTimestamp = timestamp;
+        params.mSSRC = ssrc;
+        params.mPayload = &(payload[0]);
+        params.mPayloadSize = sizeof(payload);
+
+        return UseRTPPacket::create(params);
+      }
+
+      //-----------------------------------------------------------------------
+      static void append(SecureByteBlock &buffer, size_t &pos, DWORD value)
+      {
+        buffer.BytePtr()[pos++] = static_cast<BYTE>(value >> 24);
+        buffer.BytePtr()[pos++] = static_cast<BYTE>(value >> 16);
+        buffer.BytePtr()[pos++] = static_cast<BYTE>(value >> 8);
+        buffer.BytePtr()[pos++] = static_cast<BYTE>(value);
+      }
+
+      //-----------------------------------------------------------------------
+      // https://tools.ietf.org/html/rfc3550#section-6.4.2 receiver report
+      // with a single report block followed by "nackMessages" generic NACK
+      // messages (https://tools.ietf.org/html/rfc4585#section-6.2.1) each
+      // carrying "fciEntries" PID/BLP pairs
+      static UseRTCPPacketPtr createRTCP(
+                                         DWORD mediaSSRC,
+                                         bool includeReceiverReport,
+                                         size_t nackMessages,
+                                         size_t fciEntries
+                                         )
+      {
+        size_t size = (includeReceiverReport ? 32 : 0) + (nackMessages * (12 + (fciEntries * 4)));
+
+        SecureByteBlock buffer(size);
+        size_t pos = 0;
+
+        if (includeReceiverReport) {
+          append(buffer, pos, 0x81C90007);                // V=2, RC=1, PT=201, length=7
+          append(buffer, pos, kLocalSSRC);
+          append(buffer, pos, mediaSSRC);
+          for (size_t index = 0; index < 5; ++index) {    // loss, sequence, jitter, LSR, DLSR
+            append(buffer, pos, 0);
+          }
+        }
+
+        for (size_t message = 0; message < nackMessages; ++message) {
+          append(buffer, pos, 0x81CD0000 | static_cast<DWORD>(2 + fciEntries));  // V=2, FMT=1, PT=205
+          append(buffer, pos, kLocalSSRC);
+          append(buffer, pos, mediaSSRC);
+          for (size_t entry = 0; entry < fciEntries; ++entry) {
+            append(buffer, pos, static_cast<DWORD>((entry * 20) << 16) | 0x0001);
+          }
+        }
+
+        TESTING_EQUAL(pos, size)
+
+        return UseRTCPPacket::create(buffer.BytePtr(), buffer.SizeInBytes());
+      }
+
+      //-----------------------------------------------------------------------
+      static void receive(
+                          RTPStreamCounters &counters,
+                          DWORD ssrc,
+                          BYTE payloadType,
+                          WORD sequenceNumber,
+                          DWORD timestamp = 0
+                          )
+      {
+        auto packet = createRTP(ssrc, payloadType, sequenceNumber, timestamp);
+        TESTING_CHECK(packet)
+        if (!packet) return;
+        counters.notifyReceived(*packet);
+      }
+
+      //-----------------------------------------------------------------------
+      static void sendReport(
+                             RTPStreamCounters &counters,
+                             DWORD mediaSSRC
+                             )
+      {
+        auto packet = createRTCP(mediaSSRC, true, 0, 0);
+        TESTING_CHECK(packet)
+        if (!packet) return;
+        counters.notifyFeedbackSent(*packet);
+      }
+
+      //-----------------------------------------------------------------------
+      static void testStreamSSRC()
+      {
+        TESTING_STDOUT() << "TESTING:      rtp stream counters stream ssrc selection\n";
+
+        {
+          // an RTX packet arriving first must not be taken as the stream
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters());
+
+          receive(counters, kRTXSSRC, kRTXPayloadType, 500);
+          receive(counters, kMediaSSRC, kMediaPayloadType, 10);
+          receive(counters, kRTXSSRC, kRTXPayloadType, 501);
+          receive(counters, kMediaSSRC, kMediaPayloadType, 11);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+
+          TESTING_EQUAL(snapshot.mSSRC, static_cast<DWORD>(kMediaSSRC))
+          TESTING_EQUAL(snapshot.mPackets, 4)
+          TESTING_EQUAL(snapshot.mPacketsReceivedOnSSRC, 2)
+          TESTING_EQUAL(snapshot.mPacketsExpected, 2)
+        }
+
+        {
+          // the encoding parameters name the stream
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters(kEncodingSSRC));
+
+          receive(counters, kMediaSSRC, kMediaPayloadType, 10);
+          receive(counters, kEncodingSSRC, kMediaPayloadType, 1000);
+          receive(counters, kMediaSSRC, kMediaPayloadType, 11);
+          receive(counters, kEncodingSSRC, kMediaPayloadType, 1001);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+
+          TESTING_EQUAL(snapshot.mSSRC, static_cast<DWORD>(kEncodingSSRC))
+          TESTING_EQUAL(snapshot.mPacketsReceivedOnSSRC, 2)
+          TESTING_EQUAL(snapshot.mPacketsExpected, 2)
+        }
+
+        {
+          // the encoding parameters arriving after the stream started
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters());
+
+          receive(counters, kMediaSSRC, kMediaPayloadType, 10);
+          counters.updateParameters(createParameters(kEncodingSSRC));
+          receive(counters, kEncodingSSRC, kMediaPayloadType, 1000);
+          receive(counters, kMediaSSRC, kMediaPayloadType, 11);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+
+          TESTING_EQUAL(snapshot.mSSRC, static_cast<DWORD>(kEncodingSSRC))
+          TESTING_EQUAL(snapshot.mPacketsReceivedOnSSRC, 1)
+        }
+
+        {
+          // sent RTX must not be reported as the stream either
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters());
+
+          auto rtx = createRTP(kRTXSSRC, kRTXPayloadType, 1, 0);
+          auto media = createRTP(kMediaSSRC, kMediaPayloadType, 1, 0);
+          counters.notifySent(*rtx);
+          counters.notifySent(*media);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+
+          TESTING_EQUAL(snapshot.mSSRC, static_cast<DWORD>(kMediaSSRC))
+          TESTING_EQUAL(snapshot.mPackets, 2)
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void testJitter()
+      {
+        TESTING_STDOUT() << "TESTING:      rtp stream counters jitter units\n";
+
+        RTPStreamCounters counters;
+        counters.updateParameters(createParameters());
+
+        // two packets arriving together but 100ms apart in media time give a
+        // transit difference of 9000 timestamp units (i.e. J = 9000/16)
+        receive(counters, kMediaSSRC, kMediaPayloadType, 1, 0);
+        receive(counters, kMediaSSRC, kMediaPayloadType, 2, kClockRate / 10);
+
+        RTPStreamCounters::Snapshot snapshot;
+        counters.snapshot(snapshot);
+
+        // allow for the arrivals to straddle a few milliseconds
+        TESTING_CHECK(snapshot.mJitter >= 540.0)
+        TESTING_CHECK(snapshot.mJitter <= 585.0)
+
+        IStatsReportTypes::InboundRTPStreamStats stats;
+        snapshot.applyTo(stats);
+        TESTING_EQUAL(stats.mJitter, snapshot.mJitter)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testNACKCount()
+      {
+        TESTING_STDOUT() << "TESTING:      rtp stream counters nack count\n";
+
+        {
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters());
+          receive(counters, kMediaSSRC, kMediaPayloadType, 1);
+
+          // one NACK message with several FCI entries is one NACK
+          auto packet = createRTCP(kMediaSSRC, false, 1, 3);
+          TESTING_CHECK(packet)
+          if (packet) counters.notifyFeedbackSent(*packet);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+          TESTING_EQUAL(snapshot.mNACKCount, 1)
+
+          // ... whereas separate NACK messages are counted separately
+          packet = createRTCP(kMediaSSRC, true, 2, 2);
+          TESTING_CHECK(packet)
+          if (packet) counters.notifyFeedbackSent(*packet);
+
+          counters.snapshot(snapshot);
+          TESTING_EQUAL(snapshot.mNACKCount, 2 + 1)
+        }
+
+        {
+          RTPStreamCounters counters;
+          counters.updateParameters(createParameters());
+
+          auto media = createRTP(kMediaSSRC, kMediaPayloadType, 1, 0);
+          counters.notifySent(*media);
+
+          auto packet = createRTCP(kMediaSSRC, true, 1, 4);
+          TESTING_CHECK(packet)
+          if (packet) counters.notifyIncomingRTCP(*packet);
+
+          // feedback about an SSRC never sent is ignored
+          packet = createRTCP(kRTXSSRC, false, 1, 4);
+          TESTING_CHECK(packet)
+          if (packet) counters.notifyIncomingRTCP(*packet);
+
+          RTPStreamCounters::Snapshot snapshot;
+          counters.snapshot(snapshot);
+          TESTING_EQUAL(snapshot.mNACKCount, 1)
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void testFractionLost()
+      {
+        TESTING_STDOUT() << "TESTING:      rtp stream counters fraction lost\n";
+
+        RTPStreamCounters counters;
+        counters.updateParameters(createParameters());
+
+        RTPStreamCounters::Snapshot snapshot;
+
+        // 1 of 10 lost before any report was sent
+        for (WORD sequence = 1; sequence <= 10; ++sequence) {
+          if (5 == sequence) continue;
+          receive(counters, kMediaSSRC, kMediaPayloadType, sequence);
+        }
+
+        counters.snapshot(snapshot);
+        TESTING_CHECK(!snapshot.mHasReportingInterval)
+        TESTING_EQUAL(snapshot.packetsLost(), 1)
+        TESTING_CHECK((snapshot.fractionLost() > 0.099) && (snapshot.fractionLost() < 0.101))
+
+        // a report block about another SSRC does not end the interval
+        sendReport(counters, kRTXSSRC);
+        counters.snapshot(snapshot);
+        TESTING_CHECK(!snapshot.mHasReportingInterval)
+
+        sendReport(counters, kMediaSSRC);
+        counters.snapshot(snapshot);
+        TESTING_CHECK(snapshot.mHasReportingInterval)
+        TESTING_CHECK((snapshot.fractionLost() > 0.099) && (snapshot.fractionLost() < 0.101))
+
+        // nothing lost in the next interval (the last reported value is kept
+        // until the next report is sent)
+        for (WORD sequence = 11; sequence <= 30; ++sequence) {
+          receive(counters, kMediaSSRC, kMediaPayloadType, sequence);
+        }
+
+        counters.snapshot(snapshot);
+        TESTING_CHECK((snapshot.fractionLost() > 0.099) && (snapshot.fractionLost() < 0.101))
+
+        sendReport(counters, kMediaSSRC);
+        counters.snapshot(snapshot);
+        TESTING_EQUAL(snapshot.fractionLost(), 0.0)
+        TESTING_EQUAL(snapshot.packetsLost(), 1)
+
+        // half of the next interval is lost
+        for (WORD sequence = 31; sequence <= 50; ++sequence) {
+          if (0 != (sequence % 2)) continue;
+          receive(counters, kMediaSSRC, kMediaPayloadType, sequence);
+        }
+
+        sendReport(counters, kMediaSSRC);
+        counters.snapshot(snapshot);
+        TESTING_CHECK((snapshot.fractionLost() > 0.49) && (snapshot.fractionLost() < 0.51))
+        TESTING_EQUAL(snapshot.packetsLost(), 11)
+
+        IStatsReportTypes::InboundRTPStreamStats stats;
+        snapshot.applyTo(stats);
+        TESTING_EQUAL(stats.mFractionLost, snapshot.fractionLost())
+        TESTING_EQUAL(stats.mPacketsLost, 11)
+      }
+    }
+  }
+}
+
+using namespace ortc::test::rtpstreamcounters;
+
+void doTestRTPStreamCounters()
+{
+  if (!ORTC_TEST_DO_RTP_STREAM_COUNTERS_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testStreamSSRC();
+  testJitter();
+  testNACKCount();
+  testFractionLost();
+
+  TESTING_UNINSTALL_LOGGER();
+}
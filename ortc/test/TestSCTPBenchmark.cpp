@@ -0,0 +1,651 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include "TestLoopbackEndpoint.h"
+
+#include <ortc/IDataChannel.h>
+#include <ortc/ISCTPTransport.h>
+
+#include <ortc/services/IHelper.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+#include <zsLib/XML.h>
+
+#include "config.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::String;
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::QWORD;
+using zsLib::ULONG;
+using zsLib::Milliseconds;
+using zsLib::IMessageQueue;
+using zsLib::AutoRecursiveLock;
+using zsLib::string;
+using namespace zsLib::XML;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::services::IHelper, UseServicesHelper)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace sctpbenchmark
+    {
+      ZS_DECLARE_CLASS_PTR(ChannelSink)
+
+      ZS_DECLARE_USING_PTR(ortc::test::loopback, LoopbackEndpoint)
+
+      ZS_DECLARE_TYPEDEF_PTR(ISCTPTransportTypes::SocketOptions, SocketOptions)
+
+      static const size_t kHeaderSize = sizeof(DWORD) + sizeof(QWORD);   // sequence + send time
+
+      //-----------------------------------------------------------------------
+      static QWORD nowInMicroseconds()
+      {
+        return static_cast<QWORD>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ChannelSink
+      #pragma mark
+
+      // Delegate for one end of one or more data channels. Records how long
+      // each message took from the send call (the send time is carried in
+      // the message) and, when echoing, sends every message straight back on
+      // the channel it arrived on.
+      class ChannelSink : public SharedRecursiveLock,
+                          public zsLib::MessageQueueAssociator,
+                          public IDataChannelDelegate
+      {
+      public:
+        typedef std::vector<DWORD> LatencyList;
+
+      public:
+        //---------------------------------------------------------------------
+        ChannelSink(
+                    IMessageQueuePtr queue,
+                    bool echo
+                    ) :
+          SharedRecursiveLock(SharedRecursiveLock::create()),
+          MessageQueueAssociator(queue),
+          mEcho(echo)
+        {
+        }
+
+        //---------------------------------------------------------------------
+        static ChannelSinkPtr create(
+                                     IMessageQueuePtr queue,
+                                     bool echo = false
+                                     )
+        {
+          return make_shared<ChannelSink>(queue, echo);
+        }
+
+        //---------------------------------------------------------------------
+        size_t getOpen() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mOpen;
+        }
+
+        //---------------------------------------------------------------------
+        size_t getMessages() const
+        {
+          AutoRecursiveLock lock(*this);
+          return mMessages;
+        }
+
+        //---------------------------------------------------------------------
+        void reset(size_t expectedMessages)
+        {
+          AutoRecursiveLock lock(*this);
+          mMessages = 0;
+          mBytes = 0;
+          mLatencies.clear();
+          mLatencies.reserve(expectedMessages);
+        }
+
+        //---------------------------------------------------------------------
+        void getResults(
+                        size_t &outMessages,
+                        size_t &outBytes,
+                        LatencyList &outLatencies
+                        ) const
+        {
+          AutoRecursiveLock lock(*this);
+          outMessages = mMessages;
+          outBytes = mBytes;
+          outLatencies = mLatencies;
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark ChannelSink => IDataChannelDelegate
+        #pragma mark
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelStateChange(
+                                              IDataChannelPtr channel,
+                                              IDataChannelTypes::States state
+                                              ) override
+        {
+          AutoRecursiveLock lock(*this);
+          if (IDataChannelTypes::State_Open == state) ++mOpen;
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelError(
+                                        IDataChannelPtr channel,
+                                        ErrorAnyPtr error
+                                        ) override
+        {
+          TESTING_CHECK(false)
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelBufferedAmountLow(IDataChannelPtr channel) override
+        {
+        }
+
+        //---------------------------------------------------------------------
+        virtual void onDataChannelMessage(
+                                          IDataChannelPtr channel,
+                                          MessageEventDataPtr data
+                                          ) override
+        {
+          QWORD received = nowInMicroseconds();
+
+          TESTING_CHECK(data)
+          if (!data) return;
+          TESTING_CHECK(data->mBinary)
+          if (!data->mBinary) return;
+
+          auto buffer = data->mBinary;
+          if (buffer->SizeInBytes() < kHeaderSize) return;
+
+          if (mEcho) {
+            channel->send(*buffer);
+            return;
+          }
+
+          QWORD sent = 0;
+          memcpy(&sent, buffer->BytePtr() + sizeof(DWORD), sizeof(sent));
+
+          AutoRecursiveLock lock(*this);
+
+          ++mMessages;
+          mBytes += buffer->SizeInBytes();
+          if (received >= sent) {
+            mLatencies.push_back(static_cast<DWORD>(received - sent));
+          }
+        }
+
+      protected:
+        bool mEcho {};
+
+        size_t mOpen {};
+        size_t mMessages {};
+        size_t mBytes {};
+        LatencyList mLatencies;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (benchmark)
+      #pragma mark
+
+      enum Reliabilities
+      {
+        Reliability_Reliable,
+        Reliability_MaxRetransmits,
+        Reliability_MaxPacketLifetime,
+      };
+
+      struct Run
+      {
+        Reliabilities mReliability;
+        size_t mChannels;
+        size_t mMessageSize;
+      };
+
+      //-----------------------------------------------------------------------
+      static const char *toString(Reliabilities reliability)
+      {
+        switch (reliability) {
+          case Reliability_Reliable:            return "reliable";
+          case Reliability_MaxRetransmits:      return "maxRetransmits";
+          case Reliability_MaxPacketLifetime:   return "maxPacketLifetime";
+        }
+        return "unknown";
+      }
+
+      //-----------------------------------------------------------------------
+      static DWORD percentile(
+                              const ChannelSink::LatencyList &sorted,
+                              size_t percent
+                              )
+      {
+        if (sorted.size() < 1) return 0;
+        size_t index = (sorted.size() - 1) * percent / 100;
+        return sorted[index];
+      }
+
+      //-----------------------------------------------------------------------
+      static void writeHeader(
+                              SecureByteBlock &message,
+                              DWORD sequence
+                              )
+      {
+        QWORD sendTime = nowInMicroseconds();
+        memcpy(message.BytePtr(), &sequence, sizeof(sequence));
+        memcpy(message.BytePtr() + sizeof(sequence), &sendTime, sizeof(sendTime));
+      }
+
+      //-----------------------------------------------------------------------
+      // Opens the same negotiated channels on both transports. Each call
+      // uses fresh stream ids so a run never waits on the stream resets
+      // from the channels the previous run closed.
+      static bool openChannels(
+                               LoopbackEndpointPtr sender,
+                               LoopbackEndpointPtr receiver,
+                               ChannelSinkPtr senderSink,
+                               ChannelSinkPtr receiverSink,
+                               const IDataChannelTypes::Parameters &inParams,
+                               size_t totalChannels,
+                               USHORT &ioNextID,
+                               std::vector<IDataChannelPtr> &outSenderChannels,
+                               std::vector<IDataChannelPtr> &outReceiverChannels
+                               )
+      {
+        IDataChannelTypes::Parameters params(inParams);
+        params.mNegotiated = true;
+
+        for (size_t index = 0; index < totalChannels; ++index) {
+          params.mID = ioNextID++;
+          outSenderChannels.push_back(IDataChannel::create(senderSink, sender->getSCTPTransport(), params));
+          outReceiverChannels.push_back(IDataChannel::create(receiverSink, receiver->getSCTPTransport(), params));
+        }
+
+        for (int wait = 0; (wait < 300) && ((senderSink->getOpen() < totalChannels) || (receiverSink->getOpen() < totalChannels)); ++wait) {
+          TESTING_SLEEP(10)
+        }
+
+        TESTING_EQUAL(senderSink->getOpen(), totalChannels)
+        TESTING_EQUAL(receiverSink->getOpen(), totalChannels)
+        return (senderSink->getOpen() == totalChannels) && (receiverSink->getOpen() == totalChannels);
+      }
+
+      //-----------------------------------------------------------------------
+      static void closeChannels(std::vector<IDataChannelPtr> &channels)
+      {
+        for (auto iter = channels.begin(); iter != channels.end(); ++iter) {
+          (*iter)->close();
+        }
+        channels.clear();
+      }
+
+      //-----------------------------------------------------------------------
+      // Records the socket options in effect (the values prepareSocket and
+      // the usrsctp sysctl defaults left behind) so each set of results can
+      // be tied to the settings that produced it.
+      static void outputOptions(LoopbackEndpointPtr endpoint)
+      {
+        SocketOptions options;
+        options.mRTO = SocketOptions::RTO();
+        options.mSackInfo = SocketOptions::SackInfo();
+        options.mMaximumBurst = 0;
+        options.mMaxSeg = 0;
+        options.mStatus = SocketOptions::Status();
+
+        auto promise = endpoint->getSCTPTransport()->getOptions(options);
+        for (int wait = 0; (wait < 100) && (!promise->isSettled()); ++wait) {
+          TESTING_SLEEP(10)
+        }
+        TESTING_CHECK(promise->isResolved())
+        if (!promise->isResolved()) return;
+
+        auto result = promise->value();
+        TESTING_CHECK(result)
+        if (!result) return;
+
+        ElementPtr resultEl = Element::create("sctpBenchmarkOptions");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("maxMessageSize", string(ISCTPTransport::getCapabilities()->mMaxMessageSize)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rtoInitialMs", string(result->mRTO.value().initial_.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rtoMinMs", string(result->mRTO.value().min_.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rtoMaxMs", string(result->mRTO.value().max_.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sackDelayMs", string(result->mSackInfo.value().delay_.count())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sackFrequency", string(result->mSackInfo.value().freq_)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("maxBurst", string(result->mMaximumBurst.value())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("maxSegment", string(result->mMaxSeg.value())));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("peerWindow", string(result->mStatus.value().rwnd_)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("fragmentationPoint", string(result->mStatus.value().fragmentation_point_)));
+
+        Testing::outputBenchmark(resultEl);
+      }
+
+      //-----------------------------------------------------------------------
+      // Sends as fast as the channels accept for the configured duration,
+      // round robin across the channels and keeping each channel's buffered
+      // amount below ORTC_TEST_SCTP_BENCHMARK_MAX_BUFFERED_AMOUNT. CPU is
+      // process time (both stacks) per megabyte delivered. The sending
+      // thread polls bufferedAmount() (sleeping 500us whenever every
+      // channel is full) and its time is part of the process time; it is
+      // also reported on its own ("senderThreadCpuMs") since it includes
+      // the synchronous part of send() as well as the polling overhead.
+      static void runThroughput(
+                                IMessageQueuePtr thread,
+                                LoopbackEndpointPtr sender,
+                                LoopbackEndpointPtr receiver,
+                                const Run &run,
+                                USHORT &ioNextID
+                                )
+      {
+        TESTING_CHECK(run.mChannels > 0)
+        TESTING_CHECK(run.mMessageSize >= kHeaderSize)
+        TESTING_CHECK(run.mMessageSize <= ISCTPTransport::getCapabilities()->mMaxMessageSize)
+
+        IDataChannelTypes::Parameters params;
+        params.mLabel = toString(run.mReliability);
+        switch (run.mReliability) {
+          case Reliability_Reliable:            break;
+          case Reliability_MaxRetransmits:      params.mOrdered = false; params.mMaxRetransmits = ORTC_TEST_SCTP_BENCHMARK_MAX_RETRANSMITS; break;
+          case Reliability_MaxPacketLifetime:   params.mOrdered = false; params.mMaxPacketLifetime = Milliseconds(ORTC_TEST_SCTP_BENCHMARK_MAX_PACKET_LIFETIME_IN_MILLISECONDS); break;
+        }
+
+        auto senderSink = ChannelSink::create(thread);
+        auto receiverSink = ChannelSink::create(thread);
+
+        std::vector<IDataChannelPtr> senderChannels;
+        std::vector<IDataChannelPtr> receiverChannels;
+
+        if (!openChannels(sender, receiver, senderSink, receiverSink, params, run.mChannels, ioNextID, senderChannels, receiverChannels)) {
+          closeChannels(senderChannels);
+          closeChannels(receiverChannels);
+          return;
+        }
+
+        receiverSink->reset(100000);
+
+        SecureByteBlock message(run.mMessageSize);
+
+        size_t sent = 0;
+        size_t bytesSent = 0;
+
+        auto cpuStart = Testing::getProcessCPUTime();
+        auto threadCPUStart = Testing::getThreadCPUTime();
+        QWORD start = nowInMicroseconds();
+        QWORD end = start + (static_cast<QWORD>(ORTC_TEST_SCTP_BENCHMARK_DURATION_IN_SECONDS) * 1000000);
+
+        while (nowInMicroseconds() < end) {
+          bool sentAny = false;
+          for (auto iter = senderChannels.begin(); iter != senderChannels.end(); ++iter) {
+            auto channel = (*iter);
+            if (channel->bufferedAmount() > ORTC_TEST_SCTP_BENCHMARK_MAX_BUFFERED_AMOUNT) continue;
+
+            writeHeader(message, static_cast<DWORD>(sent));
+            channel->send(message);
+            ++sent;
+            bytesSent += message.SizeInBytes();
+            sentAny = true;
+          }
+          if (!sentAny) std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+
+        QWORD sendDuration = nowInMicroseconds() - start;
+        auto threadCPUEnd = Testing::getThreadCPUTime();
+
+        // drain (bounded; partially reliable channels may never deliver
+        // everything)
+        for (int wait = 0; (wait < 500) && (receiverSink->getMessages() < sent); ++wait) {
+          TESTING_SLEEP(10)
+        }
+
+        QWORD duration = nowInMicroseconds() - start;
+        auto cpuEnd = Testing::getProcessCPUTime();
+
+        size_t received = 0;
+        size_t bytes = 0;
+        ChannelSink::LatencyList latencies;
+        receiverSink->getResults(received, bytes, latencies);
+        std::sort(latencies.begin(), latencies.end());
+
+        if (Reliability_Reliable == run.mReliability) {
+          TESTING_EQUAL(received, sent)
+        }
+        TESTING_CHECK(received > 0)
+
+        double seconds = static_cast<double>(duration) / 1000000.0;
+        double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+        double cpuMicroseconds = static_cast<double>((cpuEnd - cpuStart).count());
+        double senderThreadCPUMicroseconds = static_cast<double>((threadCPUEnd - threadCPUStart).count());
+
+        ElementPtr resultEl = Element::create("sctpBenchmark");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithTextAndJSONEncode("test", "throughput"));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithTextAndJSONEncode("reliability", toString(run.mReliability)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("channels", string(run.mChannels)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("messageSize", string(run.mMessageSize)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sendDurationMs", string(sendDuration / 1000)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("sent", string(sent)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("received", string(received)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("deliveredPercent", string(sent > 0 ? (static_cast<double>(received) * 100.0) / static_cast<double>(sent) : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("messagesPerSecond", string(static_cast<QWORD>(static_cast<double>(received) / seconds))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("megabitsPerSecond", string((static_cast<double>(bytes) * 8.0) / seconds / 1000000.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("cpuMsPerMegabyte", string(megabytes > 0.0 ? cpuMicroseconds / 1000.0 / megabytes : 0.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("senderThreadCpuMs", string(senderThreadCPUMicroseconds / 1000.0)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP50Us", string(percentile(latencies, 50))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyP99Us", string(percentile(latencies, 99))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("latencyMaxUs", string(latencies.size() > 0 ? latencies.back() : 0)));
+
+        Testing::outputBenchmark(resultEl);
+
+        closeChannels(senderChannels);
+        closeChannels(receiverChannels);
+      }
+
+      //-----------------------------------------------------------------------
+      // One small message in flight at a time on a reliable channel; the
+      // receiver echoes it back so no clocks need to be compared.
+      static void runRoundTrip(
+                               IMessageQueuePtr thread,
+                               LoopbackEndpointPtr sender,
+                               LoopbackEndpointPtr receiver,
+                               size_t messageSize,
+                               USHORT &ioNextID
+                               )
+      {
+        IDataChannelTypes::Parameters params;
+        params.mLabel = "rtt";
+
+        auto senderSink = ChannelSink::create(thread);
+        auto receiverSink = ChannelSink::create(thread, true);
+
+        std::vector<IDataChannelPtr> senderChannels;
+        std::vector<IDataChannelPtr> receiverChannels;
+
+        if (!openChannels(sender, receiver, senderSink, receiverSink, params, 1, ioNextID, senderChannels, receiverChannels)) {
+          closeChannels(senderChannels);
+          closeChannels(receiverChannels);
+          return;
+        }
+
+        senderSink->reset(ORTC_TEST_SCTP_BENCHMARK_ROUND_TRIPS);
+
+        auto channel = senderChannels.front();
+        SecureByteBlock message(messageSize);
+
+        size_t timedOut = 0;
+        for (size_t index = 0; index < ORTC_TEST_SCTP_BENCHMARK_ROUND_TRIPS; ++index) {
+          writeHeader(message, static_cast<DWORD>(index));
+          channel->send(message);
+
+          // spin rather than sleep so the wait does not round the result
+          QWORD giveUp = nowInMicroseconds() + 1000000;
+          while ((senderSink->getMessages() <= (index - timedOut)) &&
+                 (nowInMicroseconds() < giveUp)) {
+            std::this_thread::yield();
+          }
+          if (senderSink->getMessages() <= (index - timedOut)) ++timedOut;
+        }
+
+        size_t received = 0;
+        size_t bytes = 0;
+        ChannelSink::LatencyList latencies;
+        senderSink->getResults(received, bytes, latencies);
+        std::sort(latencies.begin(), latencies.end());
+
+        TESTING_EQUAL(timedOut, 0)
+
+        ElementPtr resultEl = Element::create("sctpBenchmark");
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithTextAndJSONEncode("test", "roundTrip"));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("messageSize", string(messageSize)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("roundTrips", string(received)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("timedOut", string(timedOut)));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rttP50Us", string(percentile(latencies, 50))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rttP95Us", string(percentile(latencies, 95))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rttP99Us", string(percentile(latencies, 99))));
+        resultEl->adoptAsLastChild(UseServicesHelper::createElementWithNumber("rttMaxUs", string(latencies.size() > 0 ? latencies.back() : 0)));
+
+        Testing::outputBenchmark(resultEl);
+
+        closeChannels(senderChannels);
+        closeChannels(receiverChannels);
+      }
+    }
+  }
+}
+
+using ortc::IICETypes;
+using namespace ortc::test::sctpbenchmark;
+
+void doTestSCTPBenchmark()
+{
+  if (!ORTC_TEST_DO_SCTP_BENCHMARK) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+  LoopbackEndpoint::applyLoopbackSettings();
+
+  auto thread(zsLib::IMessageQueueThread::createBasic());
+
+  LoopbackEndpoint::Options options;
+  options.mSCTP = true;
+  options.mRole = IICETypes::Role_Controlling;
+  auto endpoint1 = LoopbackEndpoint::create(thread, options);
+  options.mRole = IICETypes::Role_Controlled;
+  auto endpoint2 = LoopbackEndpoint::create(thread, options);
+
+  TESTING_STDOUT() << "WAITING:      Waiting for SCTP over DTLS loopback to connect (max wait is 30 seconds).\n";
+
+  LoopbackEndpoint::connect(endpoint1, endpoint2, zsLib::Seconds(30));
+
+  TESTING_CHECK(endpoint1->isConnected())
+  TESTING_CHECK(endpoint2->isConnected())
+
+  if ((endpoint1->isConnected()) &&
+      (endpoint2->isConnected())) {
+    static const Run runs[] = {
+      {Reliability_Reliable, 1, 100},
+      {Reliability_Reliable, 1, 1024},
+      {Reliability_Reliable, 1, 16 * 1024},
+      {Reliability_Reliable, 4, 1024},
+      {Reliability_Reliable, 4, 16 * 1024},
+      {Reliability_Reliable, 16, 1024},
+      {Reliability_Reliable, 16, 16 * 1024},
+      {Reliability_MaxRetransmits, 1, 1024},
+      {Reliability_MaxRetransmits, 1, 16 * 1024},
+      {Reliability_MaxRetransmits, 4, 1024},
+      {Reliability_MaxPacketLifetime, 1, 1024},
+      {Reliability_MaxPacketLifetime, 1, 16 * 1024},
+      {Reliability_MaxPacketLifetime, 4, 1024},
+    };
+    static const size_t roundTripSizes[] = {16, 1024};
+
+    USHORT nextID = 1;
+
+    outputOptions(endpoint1);
+
+    for (size_t index = 0; index < (sizeof(roundTripSizes) / sizeof(roundTripSizes[0])); ++index) {
+      runRoundTrip(thread, endpoint1, endpoint2, roundTripSizes[index], nextID);
+    }
+
+    for (size_t index = 0; index < (sizeof(runs) / sizeof(runs[0])); ++index) {
+      runThroughput(thread, endpoint1, endpoint2, runs[index], nextID);
+    }
+  }
+
+  endpoint1->close();
+  endpoint2->close();
+  endpoint1.reset();
+  endpoint2.reset();
+
+  TESTING_SLEEP(2000)
+
+  // wait for shutdown
+  {
+    IMessageQueue::size_type count = 0;
+    do
+    {
+      count = thread->getTotalUnprocessedMessages();
+      if (0 != count)
+        std::this_thread::yield();
+    } while (count > 0);
+
+    thread->waitForShutdown();
+  }
+  TESTING_UNINSTALL_LOGGER();
+  zsLib::proxyDump();
+  TESTING_EQUAL(zsLib::proxyGetTotalConstructed(), 0);
+}
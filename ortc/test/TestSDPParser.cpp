@@ -0,0 +1,1507 @@
+/*
+ 
+ Copyright (c) 2016, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/adapter/internal/ortc_adapter_SDPParser.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/Log.h>
+#include <zsLib/SafeInt.h>
+#include <zsLib/Stringize.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::ULONG;
+using zsLib::DWORD;
+using zsLib::String;
+using zsLib::Time;
+using zsLib::Microseconds;
+using zsLib::string;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::adapter::internal::ISDPTypes, UseSDPTypes)
+ZS_DECLARE_TYPEDEF_PTR(ortc::adapter::internal::SDPParser, UseSDPParser)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace sdpparser
+    {
+      typedef UseSDPTypes::Attributes Attributes;
+      typedef UseSDPTypes::SDP SDP;
+      typedef UseSDPTypes::MLinePtr MLinePtr;
+
+      //-----------------------------------------------------------------------
+      // the lookup used before attributes were perfect hashed; kept here as
+      // the benchmark baseline
+      static Attributes linearToAttribute(const char *attribute)
+      {
+        String str(attribute);
+        for (auto index = UseSDPTypes::Attribute_First; index <= UseSDPTypes::Attribute_Last; index = static_cast<Attributes>(static_cast<std::underlying_type<Attributes>::type>(index) + 1)) {
+          if (0 == str.compare(UseSDPTypes::toString(index))) return index;
+        }
+        return UseSDPTypes::Attribute_Unknown;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ReferenceSDPParser
+      #pragma mark
+
+      // The original parser which walked the entire line list once per step.
+      // It only exists as the reference the single pass SDPParser::parse()
+      // is verified and benchmarked against.
+      class ReferenceSDPParser : public UseSDPParser
+      {
+      public:
+        static SDPPtr parseMultiPass(const char *blob);
+
+      protected:
+        static void parseLines(SDP &sdp);
+        static void parseAttributes(SDP &sdp);
+        static void validateAttributeLevels(SDP &sdp);
+        static void parseLinesDetails(SDP &sdp);
+        static void processFlagAttributes(SDP &sdp);
+        static void processSessionLevelValues(SDP &sdp);
+        static void processMediaLevelValues(SDP &sdp);
+        static void processSourceLevelValues(SDP &sdp);
+      };
+
+      //-----------------------------------------------------------------------
+      static zsLib::Log::Params slog(const char *message)
+      {
+        return zsLib::Log::Params(message, "ortc::test::sdpparser::ReferenceSDPParser");
+      }
+
+      void ReferenceSDPParser::parseLines(SDP &sdp)
+      {
+        char *pos = sdp.mRawBuffer.get();
+
+        bool lastWasEOL = true;
+
+        while ('\0' != *pos)
+        {
+          if (('\r' == *pos) ||
+              ('\n' == *pos)) {
+            *pos = '\0';
+            ++pos;
+            lastWasEOL = true;
+            continue;
+          }
+
+          if (!lastWasEOL) {
+            ++pos;
+            continue;
+          }
+
+          lastWasEOL = false;
+
+          auto lineType = toLineType(*pos);
+          if (LineType_Unknown == lineType) {
+            ++pos;
+            continue;
+          }
+
+          ++pos;
+          if ('=' != *pos) {
+            ++pos;
+            continue;
+          }
+          ++pos;
+
+          LineTypeInfo info;
+          info.mLineType = lineType;
+          info.mValue = pos;
+          sdp.mLineInfos.push_back(info);
+          ++pos;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::parseAttributes(SDP &sdp)
+      {
+        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
+        {
+          auto &info = (*iter);
+          if (LineType_a_Attributes != info.mLineType) continue;
+
+          char *pos = const_cast<char *>(info.mValue);
+
+          char *attributeName = pos;
+          const char *attributeValue {};
+
+          while ('\0' != *pos)
+          {
+            // when the ':' is reached the value must start
+            if (':' != *pos) {
+              // continue skipping while not hitting white space
+              if (!isspace(*pos)) {
+                ++pos;
+                continue;
+              }
+
+              // value name ends at white space
+              *pos = '\0';
+              ++pos;
+
+              // be friendly do bad white space infront of a ':' by skipping it....
+              while ('\0' != *pos) {
+                if (!isspace(*pos)) break;
+                ++pos;
+              }
+              // if hit nul character, there is no value 
+              if ('\0' == *pos) continue;
+
+              // otherwise a ':' MUST be hit
+              ORTC_THROW_INVALID_PARAMETERS_IF(':' != *pos);
+              continue;
+            }
+
+            // break value at the point of the colon
+            *pos = '\0';
+            ++pos;
+
+            // skip over white space before any value
+            while ('\0' != *pos)
+            {
+              if (!isspace(*pos)) break;
+              ++pos;
+            }
+
+            if ('\0' != *pos) {
+              // if there was some kind of non-white space before nul
+              /// character then a value must exist
+              attributeValue = pos;
+            }
+            break;
+          }
+
+          info.mAttribute = toAttribute(attributeName);
+          info.mValue = attributeValue;
+          if (Attribute_Unknown == info.mAttribute) {
+            ZS_LOG_WARNING(Trace, slog("attribute is not understood") + ZS_PARAM("attribute name", attributeName) + ZS_PARAM("attribute value", attributeValue))
+            continue;
+          }
+
+          // make sure the value is either present or missing depending on the
+          // attribute type
+          if (info.mValue) {
+            ORTC_THROW_INVALID_PARAMETERS_IF(requiresEmptyValue(info.mAttribute));
+          } else {
+            ORTC_THROW_INVALID_PARAMETERS_IF(requiresValue(info.mAttribute));
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::validateAttributeLevels(SDP &sdp)
+      {
+        auto currentLevel = AttributeLevel_Session;
+
+        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
+        {
+          auto &info = (*iter);
+
+          if (LineType_Unknown == info.mLineType) continue;
+
+          if (LineType_m_MediaLine == info.mLineType) {
+            // immediately switch to the session level (so that media level is legal)
+            currentLevel = AttributeLevel_Session;
+          }
+
+          if (LineType_a_Attributes == info.mLineType) {
+            if (Attribute_Unknown == info.mAttribute) continue; // skip any unknown attributes
+          }
+
+          if (AttributeLevel_Source == currentLevel) {
+
+            AttributeLevels allowedLevels = AttributeLevel_None;
+
+            if (LineType_a_Attributes == info.mLineType) {
+              allowedLevels = getAttributeLevel(info.mAttribute);
+            } else {
+              allowedLevels = getAttributeLevel(info.mLineType);
+            }
+
+            if (0 == (AttributeLevel_Source & allowedLevels)) {
+              // line/attribute is not legal at source level (but maybe switching back to a media level attribute)
+              if (0 != (AttributeLevel_Media & allowedLevels)) {
+                // this line/attribute is moving out of source level back to media level
+                currentLevel = AttributeLevel_Media;
+              }
+            }
+          }
+
+          ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mLineType));
+          if (LineType_a_Attributes == info.mLineType) {
+            // throw an exception if this attribute is not legal at this level
+            ORTC_THROW_INVALID_PARAMETERS_IF(!supportedAtLevel(currentLevel, info.mAttribute));
+          }
+
+          info.mAttributeLevel = currentLevel;  // record the attribute's level
+
+          // switch to new level if line/attribute causes a level switch
+          switch (info.mLineType)
+          {
+            case LineType_Unknown:                break;
+
+            case LineType_v_Version:              break;
+            case LineType_o_Origin:               break;
+            case LineType_s_SessionName:          break;
+            case LineType_b_Bandwidth:            break;
+            case LineType_t_Timing:               break;
+            case LineType_a_Attributes:           {
+              if (Attribute_SSRC == info.mAttribute) {
+                currentLevel = AttributeLevel_Source;
+                break;
+              }
+              break;
+            }
+            case LineType_m_MediaLine:            {
+              currentLevel = AttributeLevel_Media;
+              break;
+            }
+            case LineType_c_ConnectionDataLine:   break;
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::parseLinesDetails(SDP &sdp)
+      {
+        AttributeLevels currentLevel = AttributeLevel_Session;
+
+        MLinePtr currentMLine;
+        ASSRCLinePtr currentSourceLine;
+
+        for (auto iter = sdp.mLineInfos.begin(); iter != sdp.mLineInfos.end(); ++iter)
+        {
+          auto &info = (*iter);
+
+          if (AttributeLevel_Session == info.mAttributeLevel) {
+            currentMLine.reset();
+            currentSourceLine.reset();
+          }
+          if (AttributeLevel_Media == info.mAttributeLevel) {
+            currentSourceLine.reset();
+          }
+
+          switch (info.mLineType)
+          {
+            case LineType_Unknown:                continue;  // will not happen
+
+            case LineType_v_Version:              info.mLineValue = make_shared<VLine>(info.mValue); break;
+            case LineType_o_Origin:               info.mLineValue = make_shared<OLine>(info.mValue); break;
+            case LineType_s_SessionName:          info.mLineValue = make_shared<SLine>(info.mValue); break;
+            case LineType_b_Bandwidth:            {
+              if (AttributeLevel_Session == info.mAttributeLevel) {
+                // https://tools.ietf.org/html/draft-ietf-rtcweb-jsep-14
+                // Section 5.2.1 - ignore b= for session level
+                info.mLineType = LineType_Unknown;  // make sure this line type is ignored in the future
+                continue;
+              }
+              info.mLineValue = make_shared<BLine>(currentMLine, info.mValue); break;
+              break;
+            }
+            case LineType_t_Timing:               info.mLineValue = make_shared<TLine>(info.mValue); break;
+            case LineType_a_Attributes:           {
+              break;
+            }
+            case LineType_m_MediaLine:            {
+              currentMLine = make_shared<MLine>(info.mValue);
+              info.mLineValue = currentMLine;
+              break;
+            }
+            case LineType_c_ConnectionDataLine:   info.mLineValue = make_shared<CLine>(currentMLine, info.mValue); break;
+          }
+
+          if (LineType_a_Attributes != info.mLineType) continue;  // special handling for attributes
+
+          switch (info.mAttribute)
+          {
+            case Attribute_Unknown:           break;
+
+            case Attribute_Group:             info.mLineValue = make_shared<AGroupLine>(info.mValue); break;
+            case Attribute_BundleOnly:        info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
+            case Attribute_MSID:              info.mLineValue = make_shared<AMSIDLine>(currentMLine, info.mValue); break;
+            case Attribute_MSIDSemantic:      info.mLineValue = make_shared<AMSIDSemanticLine>(info.mValue); break;
+            case Attribute_ICEUFrag:          info.mLineValue = make_shared<AICEUFragLine>(currentMLine, info.mValue); break;
+            case Attribute_ICEPwd:            info.mLineValue = make_shared<AICEPwdLine>(currentMLine, info.mValue); break;
+            case Attribute_ICEOptions:        info.mLineValue = make_shared<AICEOptionsLine>(info.mValue); break;
+            case Attribute_ICELite:           break;  // session level flag; struct not needed
+            case Attribute_Candidate:         info.mLineValue = make_shared<ACandidateLine>(currentMLine, info.mValue); break;
+            case Attribute_EndOfCandidates:   info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
+            case Attribute_Fingerprint:       info.mLineValue = make_shared<AFingerprintLine>(currentMLine, info.mValue); break;
+            case Attribute_Crypto:            info.mLineValue = make_shared<ACryptoLine>(currentMLine, info.mValue); break;
+            case Attribute_Setup:             info.mLineValue = make_shared<ASetupLine>(currentMLine, info.mValue); break;
+            case Attribute_MID:               info.mLineValue = make_shared<AMIDLine>(currentMLine, info.mValue); break;
+            case Attribute_Extmap:            info.mLineValue = make_shared<AExtmapLine>(currentMLine, info.mValue); break;
+            case Attribute_SendRecv:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
+            case Attribute_SendOnly:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
+            case Attribute_RecvOnly:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
+            case Attribute_Inactive:          info.mLineValue = make_shared<AMediaDirectionLine>(currentMLine, toString(info.mAttribute)); break;
+            case Attribute_RTPMap:            info.mLineValue = make_shared<ARTPMapLine>(currentMLine, info.mValue); break;
+            case Attirbute_FMTP:              info.mLineValue = make_shared<AFMTPLine>(currentMLine, currentSourceLine, info.mValue); break;
+            case Attribute_RTCP:              info.mLineValue = make_shared<ARTCPLine>(currentMLine, info.mValue); break;
+            case Attribute_RTCPMux:           info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
+            case Attribute_RTCPFB:            info.mLineValue = make_shared<ARTCPFBLine>(currentMLine, info.mValue); break;
+            case Attribute_RTCPRSize:         info.mLineValue = make_shared<AMediaFlagLine>(currentMLine); break;
+            case Attribute_PTime:             info.mLineValue = make_shared<APTimeLine>(currentMLine, info.mValue); break;
+            case Attribute_MaxPTime:          info.mLineValue = make_shared<AMaxPTimeLine>(currentMLine, info.mValue); break;
+            case Attribute_SSRC:              info.mLineValue = make_shared<ASSRCLine>(currentMLine, info.mValue); break;
+            case Attribute_SSRCGroup:         info.mLineValue = make_shared<ASSRCGroupLine>(currentMLine, info.mValue); break;
+            case Attribute_Simulcast:         info.mLineValue = make_shared<ASimulcastLine>(currentMLine, info.mValue); break;
+            case Attribute_RID:               info.mLineValue = make_shared<ARIDLine>(currentMLine, info.mValue); break;
+            case Attribute_SCTPPort:          info.mLineValue = make_shared<ASCTPPortLine>(currentMLine, info.mValue); break;
+            case Attribute_MaxMessageSize:    info.mLineValue = make_shared<AMaxMessageSizeLine>(currentMLine, info.mValue); break;
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::processFlagAttributes(SDP &sdp)
+      {
+        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &info = (*current);
+          if (LineType_a_Attributes != info.mLineType) continue;
+
+          if (!requiresEmptyValue(info.mAttribute)) continue;
+
+          {
+            // this is a "flag" attribute
+            switch (info.mAttribute)
+            {
+              case Attribute_Unknown:           continue;
+
+              case Attribute_Group:             continue;
+              case Attribute_BundleOnly:        break;
+              case Attribute_MSID:              continue;
+              case Attribute_MSIDSemantic:      continue;
+              case Attribute_ICEUFrag:          continue;
+              case Attribute_ICEPwd:            continue;
+              case Attribute_ICEOptions:        continue;
+              case Attribute_ICELite: {
+                sdp.mICELite = true;
+                continue;
+              }
+              case Attribute_Candidate:         continue;
+              case Attribute_EndOfCandidates:   break;
+              case Attribute_Fingerprint:       continue;
+              case Attribute_Crypto:            continue;
+              case Attribute_Setup:             continue;
+              case Attribute_MID:               continue;
+              case Attribute_Extmap:            continue;
+              case Attribute_SendRecv:          
+              case Attribute_SendOnly:          
+              case Attribute_RecvOnly:          
+              case Attribute_Inactive: {
+                auto direction = ZS_DYNAMIC_PTR_CAST(AMediaDirectionLine, info.mLineValue);
+                ZS_THROW_INVALID_ASSUMPTION_IF(!direction);
+                if (direction->mMLine) {
+                  ORTC_THROW_INVALID_PARAMETERS_IF(direction->mMLine->mMediaDirection.hasValue());
+                  direction->mMLine->mMediaDirection = direction->mDirection;
+                } else {
+                  ORTC_THROW_INVALID_PARAMETERS_IF(sdp.mMediaDirection.hasValue());
+                  sdp.mMediaDirection = direction->mDirection;
+                }
+                goto remove_line;;
+              }
+              case Attribute_RTPMap:            continue;
+              case Attirbute_FMTP:              continue;
+              case Attribute_RTCP:              continue;
+              case Attribute_RTCPMux:           break;
+              case Attribute_RTCPFB:            continue;
+              case Attribute_RTCPRSize:         break;
+              case Attribute_PTime:             continue;
+              case Attribute_MaxPTime:          continue;
+              case Attribute_SSRC:              continue;
+              case Attribute_SSRCGroup:         continue;
+              case Attribute_Simulcast:         continue;
+              case Attribute_RID:               continue;
+              case Attribute_SCTPPort:          continue;
+              case Attribute_MaxMessageSize:    continue;
+            }
+
+            auto flag = ZS_DYNAMIC_PTR_CAST(AMediaFlagLine, info.mLineValue);
+            ZS_THROW_INVALID_ASSUMPTION_IF(!flag);
+
+            ORTC_THROW_INVALID_PARAMETERS_IF(!flag->mMLine);
+
+            switch (info.mAttribute)
+            {
+              case Attribute_BundleOnly:        flag->mMLine->mBundleOnly = true; goto remove_line;
+              case Attribute_EndOfCandidates:   flag->mMLine->mEndOfCandidates = true; goto remove_line;
+              case Attribute_RTCPMux:           flag->mMLine->mRTCPMux = true; goto remove_line;
+              case Attribute_RTCPRSize:         flag->mMLine->mRTCPRSize = true; goto remove_line;
+              default:                          break;
+            }
+          }
+          continue;
+
+        remove_line:
+          {
+            // no longer need to process this line
+            sdp.mLineInfos.erase(current);
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::processSessionLevelValues(SDP &sdp)
+      {
+        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &info = (*current);
+
+          if (AttributeLevel_Session != info.mAttributeLevel) continue;
+
+          switch (info.mLineType)
+          {
+            case LineType_Unknown:        goto remove_line;
+
+            case LineType_v_Version: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mVLine);
+              sdp.mVLine = ZS_DYNAMIC_PTR_CAST(VLine, info.mLineValue);
+              goto remove_line;
+            }
+            case LineType_o_Origin: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mOLine);
+              sdp.mOLine = ZS_DYNAMIC_PTR_CAST(OLine, info.mLineValue);
+              goto remove_line;
+            }
+            case LineType_s_SessionName: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mSLine);
+              sdp.mSLine = ZS_DYNAMIC_PTR_CAST(SLine, info.mLineValue);
+              goto remove_line;
+            }
+            case LineType_b_Bandwidth:    goto remove_line;
+            case LineType_t_Timing: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mTLine);
+              sdp.mTLine = ZS_DYNAMIC_PTR_CAST(TLine, info.mLineValue);
+              goto remove_line;
+            }
+            case LineType_a_Attributes:   break;
+            case LineType_m_MediaLine: {
+              sdp.mMLines.push_back(ZS_DYNAMIC_PTR_CAST(MLine, info.mLineValue));
+              goto remove_line;
+            }
+            case LineType_c_ConnectionDataLine: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mCLine);
+              sdp.mCLine = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
+              goto remove_line;
+            }
+          }
+
+          switch (info.mAttribute)
+          {
+            case Attribute_Unknown:           goto remove_line;
+
+            case Attribute_Group: {
+              sdp.mAGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(AGroupLine, info.mLineValue));
+              goto remove_line;
+            }
+            case Attribute_BundleOnly:        continue;
+            case Attribute_MSID:              continue;
+            case Attribute_MSIDSemantic: {
+              sdp.mAMSIDSemanticLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDSemanticLine, info.mLineValue));
+              goto remove_line;
+            }
+            case Attribute_ICEUFrag: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEUFragLine);
+              sdp.mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
+              goto remove_line;
+            }
+            case Attribute_ICEPwd: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEPwdLine);
+              sdp.mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
+              goto remove_line;
+            }
+            case Attribute_ICEOptions: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mAICEOptionsLine);
+              sdp.mAICEOptionsLine = ZS_DYNAMIC_PTR_CAST(AICEOptionsLine, info.mLineValue);
+              goto remove_line;
+            }
+            case Attribute_ICELite:           continue;
+            case Attribute_Candidate:         continue;
+            case Attribute_EndOfCandidates:   continue;
+            case Attribute_Fingerprint: {
+              sdp.mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
+              goto remove_line;
+            }
+            case Attribute_Crypto:            continue;
+            case Attribute_Setup: {
+              ORTC_THROW_INVALID_PARAMETERS_IF((bool)sdp.mASetupLine);
+              sdp.mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
+              goto remove_line;
+            }
+            case Attribute_MID:               continue;
+            case Attribute_Extmap: {
+              sdp.mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
+              goto remove_line;
+            }
+            case Attribute_SendRecv:          continue;
+            case Attribute_SendOnly:          continue;
+            case Attribute_RecvOnly:          continue;
+            case Attribute_Inactive:          continue;
+            case Attribute_RTPMap:            continue;
+            case Attirbute_FMTP:              continue;
+            case Attribute_RTCP:              continue;
+            case Attribute_RTCPMux:           continue;
+            case Attribute_RTCPFB:            continue;
+            case Attribute_RTCPRSize:         continue;
+            case Attribute_PTime:             continue;
+            case Attribute_MaxPTime:          continue;
+            case Attribute_SSRC:              continue;
+            case Attribute_SSRCGroup:         continue;
+            case Attribute_Simulcast:         continue;
+            case Attribute_RID:               continue;
+            case Attribute_SCTPPort:          continue;
+            case Attribute_MaxMessageSize:    continue;
+          }
+
+          continue;
+
+        remove_line:
+          {
+            // no longer need to process this line
+            sdp.mLineInfos.erase(current);
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::processMediaLevelValues(SDP &sdp)
+      {
+        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &info = (*current);
+
+          if (AttributeLevel_Media != info.mAttributeLevel) continue;
+
+          // scope: process line
+          {
+            switch (info.mLineType)
+            {
+              case LineType_Unknown:                goto remove_line;
+
+              case LineType_v_Version:              continue;
+              case LineType_o_Origin:               continue;
+              case LineType_s_SessionName:          continue;
+              case LineType_b_Bandwidth:            {
+                auto bline = ZS_DYNAMIC_PTR_CAST(BLine, info.mLineValue);
+                ORTC_THROW_INVALID_PARAMETERS_IF(!bline->mMLine);
+                bline->mMLine->mBLines.push_back(bline);
+                bline->mMLine.reset();  // no longer point back to mline
+                goto remove_line;
+              }
+              case LineType_t_Timing:               continue;
+              case LineType_a_Attributes:           break;
+              case LineType_m_MediaLine:            continue;
+              case LineType_c_ConnectionDataLine:   {
+                auto cline = ZS_DYNAMIC_PTR_CAST(CLine, info.mLineValue);
+                ORTC_THROW_INVALID_PARAMETERS_IF(!cline->mMLine);
+                ORTC_THROW_INVALID_PARAMETERS_IF((bool)cline->mMLine->mCLine);
+                cline->mMLine->mCLine = cline;
+                cline->mMLine.reset();  // no longer point back to mline
+                goto remove_line;
+              }
+            }
+
+            auto mediaLine = ZS_DYNAMIC_PTR_CAST(AMediaLine, info.mLineValue);
+            ZS_THROW_INVALID_ASSUMPTION_IF(!mediaLine);
+
+            MLinePtr mline = mediaLine->mMLine;
+            mediaLine->mMLine.reset();
+
+            ORTC_THROW_INVALID_PARAMETERS_IF(!mline);
+
+            switch (info.mAttribute)
+            {
+              case Attribute_Unknown:           break;
+
+              case Attribute_Group:             continue;
+              case Attribute_BundleOnly:        continue;
+              case Attribute_MSID:              {
+                mline->mAMSIDLines.push_back(ZS_DYNAMIC_PTR_CAST(AMSIDLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_MSIDSemantic:      continue;
+              case Attribute_ICEUFrag:          {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEUFragLine);
+                mline->mAICEUFragLine = ZS_DYNAMIC_PTR_CAST(AICEUFragLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_ICEPwd:            {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAICEPwdLine);
+                mline->mAICEPwdLine = ZS_DYNAMIC_PTR_CAST(AICEPwdLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_ICEOptions:        continue;
+              case Attribute_ICELite:           continue;
+              case Attribute_Candidate:         {
+                mline->mACandidateLines.push_back(ZS_DYNAMIC_PTR_CAST(ACandidateLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_EndOfCandidates:   continue;
+              case Attribute_Fingerprint:       {
+                mline->mAFingerprintLines.push_back(ZS_DYNAMIC_PTR_CAST(AFingerprintLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_Crypto:            {
+                mline->mACryptoLines.push_back(ZS_DYNAMIC_PTR_CAST(ACryptoLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_Setup:             {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASetupLine);
+                mline->mASetupLine = ZS_DYNAMIC_PTR_CAST(ASetupLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_MID:               {
+                // NOTE: While technically a=mid is allowed multiple times, within
+                // the context of the jsep draft it's only every used once and
+                // mid would get confused if more than value was present thus
+                // make it illegal.
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMIDLine);
+                mline->mAMIDLine = ZS_DYNAMIC_PTR_CAST(AMIDLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_Extmap:            {
+                mline->mAExtmapLines.push_back(ZS_DYNAMIC_PTR_CAST(AExtmapLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_SendRecv:          continue;
+              case Attribute_SendOnly:          continue;
+              case Attribute_RecvOnly:          continue;
+              case Attribute_Inactive:          continue;
+              case Attribute_RTPMap:            {
+                mline->mARTPMapLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTPMapLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attirbute_FMTP:              {
+                mline->mAFMTPLines.push_back(ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_RTCP:              {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mARTCPLine);
+                mline->mARTCPLine = ZS_DYNAMIC_PTR_CAST(ARTCPLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_RTCPMux:           continue;
+              case Attribute_RTCPFB:            {
+                mline->mARTCPFBLines.push_back(ZS_DYNAMIC_PTR_CAST(ARTCPFBLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_RTCPRSize:         continue;
+              case Attribute_PTime:             {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAPTimeLine);
+                mline->mAPTimeLine = ZS_DYNAMIC_PTR_CAST(APTimeLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_MaxPTime:          {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxPTimeLine);
+                mline->mAMaxPTimeLine = ZS_DYNAMIC_PTR_CAST(AMaxPTimeLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_SSRC:              {
+                mline->mASSRCLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_SSRCGroup:         {
+                mline->mASSRCGroupLines.push_back(ZS_DYNAMIC_PTR_CAST(ASSRCGroupLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_Simulcast:         {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASimulcastLine);
+                mline->mASimulcastLine = ZS_DYNAMIC_PTR_CAST(ASimulcastLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_RID:               {
+                mline->mARIDLines.push_back(ZS_DYNAMIC_PTR_CAST(ARIDLine, info.mLineValue));
+                goto remove_line;
+              }
+              case Attribute_SCTPPort:          {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mASCTPPortLine);
+                mline->mASCTPPortLine = ZS_DYNAMIC_PTR_CAST(ASCTPPortLine, info.mLineValue);
+                goto remove_line;
+              }
+              case Attribute_MaxMessageSize: {
+                ORTC_THROW_INVALID_PARAMETERS_IF(mline->mAMaxMessageSize);
+                mline->mAMaxMessageSize = ZS_DYNAMIC_PTR_CAST(AMaxMessageSizeLine, info.mLineValue);
+                goto remove_line;
+              }
+            }
+          }
+          continue;
+
+        remove_line:
+          {
+            // no longer need to process this line
+            sdp.mLineInfos.erase(current);
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void ReferenceSDPParser::processSourceLevelValues(SDP &sdp)
+      {
+        for (auto iter_doNotUse = sdp.mLineInfos.begin(); iter_doNotUse != sdp.mLineInfos.end(); )
+        {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &info = (*current);
+
+          if (AttributeLevel_Source != info.mAttributeLevel) continue;
+
+          // scope: process line
+          {
+            switch (info.mLineType)
+            {
+              case LineType_Unknown:                goto remove_line;
+
+              case LineType_v_Version:              continue;
+              case LineType_o_Origin:               continue;
+              case LineType_s_SessionName:          continue;
+              case LineType_b_Bandwidth:            continue;
+              case LineType_t_Timing:               continue;
+              case LineType_a_Attributes:           break;
+              case LineType_m_MediaLine:            continue;
+              case LineType_c_ConnectionDataLine:   continue;
+            }
+
+            switch (info.mAttribute)
+            {
+              case Attribute_Unknown:           break;
+
+              case Attribute_Group:             continue;
+              case Attribute_BundleOnly:        continue;
+              case Attribute_MSID:              continue;
+              case Attribute_MSIDSemantic:      continue;
+              case Attribute_ICEUFrag:          continue;
+              case Attribute_ICEPwd:            continue;
+              case Attribute_ICEOptions:        continue;
+              case Attribute_ICELite:           continue;
+              case Attribute_Candidate:         continue;
+              case Attribute_EndOfCandidates:   continue;
+              case Attribute_Fingerprint:       continue;
+              case Attribute_Crypto:            continue;
+              case Attribute_Setup:             continue;
+              case Attribute_MID:               continue;
+              case Attribute_Extmap:            continue;
+              case Attribute_SendRecv:          continue;
+              case Attribute_SendOnly:          continue;
+              case Attribute_RecvOnly:          continue;
+              case Attribute_Inactive:          continue;
+              case Attribute_RTPMap:            continue;
+              case Attirbute_FMTP:              {
+                auto fmtpLine = ZS_DYNAMIC_PTR_CAST(AFMTPLine, info.mLineValue);
+                ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mMLine);
+                ORTC_THROW_INVALID_PARAMETERS_IF(!fmtpLine->mSourceLine);
+                fmtpLine->mSourceLine->mAFMTPLines.push_back(fmtpLine);
+
+                // no longer point back to mline or source line
+                fmtpLine->mMLine.reset();
+                fmtpLine->mSourceLine.reset();
+                goto remove_line;
+              }
+              case Attribute_RTCP:              continue;
+              case Attribute_RTCPMux:           continue;
+              case Attribute_RTCPFB:            continue;
+              case Attribute_RTCPRSize:         continue;
+              case Attribute_PTime:             continue;
+              case Attribute_MaxPTime:          continue;
+              case Attribute_SSRC:              continue;
+              case Attribute_SSRCGroup:         continue;
+              case Attribute_Simulcast:         continue;
+              case Attribute_RID:               continue;
+              case Attribute_SCTPPort:          continue;
+              case Attribute_MaxMessageSize:    continue;
+            }
+          }
+
+          continue;
+
+        remove_line:
+          {
+            // no longer need to process this line
+            sdp.mLineInfos.erase(current);
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      UseSDPTypes::SDPPtr ReferenceSDPParser::parseMultiPass(const char *blob)
+      {
+        if (!blob) return SDPPtr();
+
+        SDPPtr sdp(make_shared<SDP>());
+
+        size_t length = strlen(blob);
+        std::unique_ptr<char[]> rawBuffer(new char[length+1]);
+        sdp->mRawBuffer = std::move(rawBuffer);
+
+        memset(sdp->mRawBuffer.get(), 0, sizeof(char)*(length+1));
+        memcpy(sdp->mRawBuffer.get(), blob, sizeof(char)*length);
+
+        try {
+          parseLines(*sdp);
+          parseAttributes(*sdp);
+          validateAttributeLevels(*sdp);
+          parseLinesDetails(*sdp);
+          processFlagAttributes(*sdp);
+          processSessionLevelValues(*sdp);
+          processMediaLevelValues(*sdp);
+          processSourceLevelValues(*sdp);
+        } catch (const SafeIntException &e) {
+          ORTC_THROW_INVALID_PARAMETERS("value found out of legal value range" + string(e.m_code));
+        }
+
+        return sdp;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SDPComparer
+      #pragma mark
+
+      // Compares every parsed field of two SDPs (i.e. the single pass parser
+      // against the multi pass reference parser) and reports the path of
+      // each field that differs.
+      class SDPComparer
+      {
+      public:
+        size_t mismatches() const {return mMismatches;}
+
+        //---------------------------------------------------------------------
+        void compare(const SDP &sdp1, const SDP &sdp2)
+        {
+          same("mediaDirection", sdp1.mMediaDirection, sdp2.mMediaDirection);
+          same("iceLite", sdp1.mICELite, sdp2.mICELite);
+
+          same("lineInfos.size", sdp1.mLineInfos.size(), sdp2.mLineInfos.size());
+          if (sdp1.mLineInfos.size() == sdp2.mLineInfos.size()) {
+            auto iter2 = sdp2.mLineInfos.begin();
+            for (auto iter1 = sdp1.mLineInfos.begin(); iter1 != sdp1.mLineInfos.end(); ++iter1, ++iter2) {
+              same("lineInfo.lineType", (*iter1).mLineType, (*iter2).mLineType);
+              same("lineInfo.attribute", (*iter1).mAttribute, (*iter2).mAttribute);
+              same("lineInfo.attributeLevel", (*iter1).mAttributeLevel, (*iter2).mAttributeLevel);
+              same("lineInfo.value", String((*iter1).mValue), String((*iter2).mValue));
+            }
+          }
+
+          if (present("v", sdp1.mVLine, sdp2.mVLine)) same("v.version", sdp1.mVLine->mVersion, sdp2.mVLine->mVersion);
+          if (present("o", sdp1.mOLine, sdp2.mOLine)) {
+            same("o.username", sdp1.mOLine->mUsername, sdp2.mOLine->mUsername);
+            same("o.sessionID", sdp1.mOLine->mSessionID, sdp2.mOLine->mSessionID);
+            same("o.sessionVersion", sdp1.mOLine->mSessionVersion, sdp2.mOLine->mSessionVersion);
+            same("o.netType", sdp1.mOLine->mNetType, sdp2.mOLine->mNetType);
+            same("o.addrType", sdp1.mOLine->mAddrType, sdp2.mOLine->mAddrType);
+            same("o.unicastAddress", sdp1.mOLine->mUnicastAddress, sdp2.mOLine->mUnicastAddress);
+          }
+          if (present("s", sdp1.mSLine, sdp2.mSLine)) same("s.sessionName", sdp1.mSLine->mSessionName, sdp2.mSLine->mSessionName);
+          if (present("t", sdp1.mTLine, sdp2.mTLine)) {
+            same("t.startTime", sdp1.mTLine->mStartTime, sdp2.mTLine->mStartTime);
+            same("t.endTime", sdp1.mTLine->mEndTime, sdp2.mTLine->mEndTime);
+          }
+          compareLine("c", sdp1.mCLine, sdp2.mCLine, MLinePtr(), MLinePtr());
+          compareLine("ice-ufrag", sdp1.mAICEUFragLine, sdp2.mAICEUFragLine, MLinePtr(), MLinePtr());
+          compareLine("ice-pwd", sdp1.mAICEPwdLine, sdp2.mAICEPwdLine, MLinePtr(), MLinePtr());
+          if (present("ice-options", sdp1.mAICEOptionsLine, sdp2.mAICEOptionsLine)) same("ice-options.tags", sdp1.mAICEOptionsLine->mTags, sdp2.mAICEOptionsLine->mTags);
+          compareLine("setup", sdp1.mASetupLine, sdp2.mASetupLine, MLinePtr(), MLinePtr());
+
+          compareGroups("group", sdp1.mAGroupLines, sdp2.mAGroupLines);
+          compareGroups("msid-semantic", sdp1.mAMSIDSemanticLines, sdp2.mAMSIDSemanticLines);
+          compareLines("fingerprint", sdp1.mAFingerprintLines, sdp2.mAFingerprintLines, MLinePtr(), MLinePtr());
+          compareLines("extmap", sdp1.mAExtmapLines, sdp2.mAExtmapLines, MLinePtr(), MLinePtr());
+
+          same("m.size", sdp1.mMLines.size(), sdp2.mMLines.size());
+          if (sdp1.mMLines.size() != sdp2.mMLines.size()) return;
+
+          auto iter2 = sdp2.mMLines.begin();
+          for (auto iter1 = sdp1.mMLines.begin(); iter1 != sdp1.mMLines.end(); ++iter1, ++iter2) {
+            if (!present("m", *iter1, *iter2)) continue;
+            compareMLine(*iter1, *iter2);
+          }
+        }
+
+      protected:
+        //---------------------------------------------------------------------
+        void compareMLine(const MLinePtr &mline1, const MLinePtr &mline2)
+        {
+          same("m.media", mline1->mMedia, mline2->mMedia);
+          same("m.port", mline1->mPort, mline2->mPort);
+          same("m.integer", mline1->mInteger, mline2->mInteger);
+          same("m.proto", mline1->mProto, mline2->mProto);
+          same("m.protoStr", mline1->mProtoStr, mline2->mProtoStr);
+          same("m.fmts", mline1->mFmts, mline2->mFmts);
+
+          same("m.bundleOnly", mline1->mBundleOnly, mline2->mBundleOnly);
+          same("m.endOfCandidates", mline1->mEndOfCandidates, mline2->mEndOfCandidates);
+          same("m.mediaDirection", mline1->mMediaDirection, mline2->mMediaDirection);
+          same("m.rtcpMux", mline1->mRTCPMux, mline2->mRTCPMux);
+          same("m.rtcpRSize", mline1->mRTCPRSize, mline2->mRTCPRSize);
+
+          compareLine("m.c", mline1->mCLine, mline2->mCLine, mline1, mline2);
+          compareLine("m.ice-ufrag", mline1->mAICEUFragLine, mline2->mAICEUFragLine, mline1, mline2);
+          compareLine("m.ice-pwd", mline1->mAICEPwdLine, mline2->mAICEPwdLine, mline1, mline2);
+          compareLine("m.setup", mline1->mASetupLine, mline2->mASetupLine, mline1, mline2);
+          compareLine("m.mid", mline1->mAMIDLine, mline2->mAMIDLine, mline1, mline2);
+          compareLine("m.rtcp", mline1->mARTCPLine, mline2->mARTCPLine, mline1, mline2);
+          compareLine("m.ptime", mline1->mAPTimeLine, mline2->mAPTimeLine, mline1, mline2);
+          compareLine("m.maxptime", mline1->mAMaxPTimeLine, mline2->mAMaxPTimeLine, mline1, mline2);
+          compareLine("m.sctp-port", mline1->mASCTPPortLine, mline2->mASCTPPortLine, mline1, mline2);
+          compareLine("m.max-message-size", mline1->mAMaxMessageSize, mline2->mAMaxMessageSize, mline1, mline2);
+
+          if (present("m.simulcast", mline1->mASimulcastLine, mline2->mASimulcastLine)) {
+            owner("m.simulcast", mline1->mASimulcastLine->mMLine, mline2->mASimulcastLine->mMLine, mline1, mline2);
+            compareSimulcast(mline1->mASimulcastLine->mValues, mline2->mASimulcastLine->mValues);
+          }
+
+          same("m.b.size", mline1->mBLines.size(), mline2->mBLines.size());
+          if (mline1->mBLines.size() == mline2->mBLines.size()) {
+            auto iter2 = mline2->mBLines.begin();
+            for (auto iter1 = mline1->mBLines.begin(); iter1 != mline1->mBLines.end(); ++iter1, ++iter2) {
+              if (!present("m.b", *iter1, *iter2)) continue;
+              owner("m.b", (*iter1)->mMLine, (*iter2)->mMLine, mline1, mline2);
+              same("m.b.bwType", (*iter1)->mBWType, (*iter2)->mBWType);
+              same("m.b.bandwidth", (*iter1)->mBandwidth, (*iter2)->mBandwidth);
+            }
+          }
+
+          compareLines("m.msid", mline1->mAMSIDLines, mline2->mAMSIDLines, mline1, mline2);
+          compareLines("m.candidate", mline1->mACandidateLines, mline2->mACandidateLines, mline1, mline2);
+          compareLines("m.fingerprint", mline1->mAFingerprintLines, mline2->mAFingerprintLines, mline1, mline2);
+          compareLines("m.crypto", mline1->mACryptoLines, mline2->mACryptoLines, mline1, mline2);
+          compareLines("m.extmap", mline1->mAExtmapLines, mline2->mAExtmapLines, mline1, mline2);
+          compareLines("m.rtpmap", mline1->mARTPMapLines, mline2->mARTPMapLines, mline1, mline2);
+          compareLines("m.fmtp", mline1->mAFMTPLines, mline2->mAFMTPLines, mline1, mline2);
+          compareLines("m.rtcp-fb", mline1->mARTCPFBLines, mline2->mARTCPFBLines, mline1, mline2);
+          compareLines("m.ssrc", mline1->mASSRCLines, mline2->mASSRCLines, mline1, mline2);
+          compareLines("m.ssrc-group", mline1->mASSRCGroupLines, mline2->mASSRCGroupLines, mline1, mline2);
+          compareLines("m.rid", mline1->mARIDLines, mline2->mARIDLines, mline1, mline2);
+        }
+
+        //---------------------------------------------------------------------
+        // every line type with a toString() serializes all of its fields (the
+        // generator relies on this) so comparing the serialized form compares
+        // the line field by field
+        template <typename LinePtr>
+        void compareLine(
+                         const char *name,
+                         const LinePtr &line1,
+                         const LinePtr &line2,
+                         const MLinePtr &mline1,
+                         const MLinePtr &mline2
+                         )
+        {
+          if (!present(name, line1, line2)) return;
+          owner(name, line1->mMLine, line2->mMLine, mline1, mline2);
+          same(name, line1->toString(), line2->toString());
+        }
+
+        //---------------------------------------------------------------------
+        template <typename LineList>
+        void compareLines(
+                          const char *name,
+                          const LineList &lines1,
+                          const LineList &lines2,
+                          const MLinePtr &mline1,
+                          const MLinePtr &mline2
+                          )
+        {
+          same((String(name) + ".size").c_str(), lines1.size(), lines2.size());
+          if (lines1.size() != lines2.size()) return;
+
+          auto iter2 = lines2.begin();
+          for (auto iter1 = lines1.begin(); iter1 != lines1.end(); ++iter1, ++iter2) {
+            compareLine(name, *iter1, *iter2, mline1, mline2);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        template <typename LineList>
+        void compareGroups(
+                           const char *name,
+                           const LineList &lines1,
+                           const LineList &lines2
+                           )
+        {
+          same((String(name) + ".size").c_str(), lines1.size(), lines2.size());
+          if (lines1.size() != lines2.size()) return;
+
+          auto iter2 = lines2.begin();
+          for (auto iter1 = lines1.begin(); iter1 != lines1.end(); ++iter1, ++iter2) {
+            if (!present(name, *iter1, *iter2)) continue;
+            same(name, (*iter1)->toString(), (*iter2)->toString());
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void compareSimulcast(
+                              const UseSDPTypes::ASimulcastLine::SCValueList &values1,
+                              const UseSDPTypes::ASimulcastLine::SCValueList &values2
+                              )
+        {
+          same("m.simulcast.values.size", values1.size(), values2.size());
+          if (values1.size() != values2.size()) return;
+
+          auto iter2 = values2.begin();
+          for (auto iter1 = values1.begin(); iter1 != values1.end(); ++iter1, ++iter2) {
+            same("m.simulcast.direction", (*iter1).mDirection, (*iter2).mDirection);
+            same("m.simulcast.alt.size", (*iter1).mAltSCIDs.size(), (*iter2).mAltSCIDs.size());
+            if ((*iter1).mAltSCIDs.size() != (*iter2).mAltSCIDs.size()) continue;
+
+            auto altIter2 = (*iter2).mAltSCIDs.begin();
+            for (auto altIter1 = (*iter1).mAltSCIDs.begin(); altIter1 != (*iter1).mAltSCIDs.end(); ++altIter1, ++altIter2) {
+              same("m.simulcast.scid.size", (*altIter1).size(), (*altIter2).size());
+              if ((*altIter1).size() != (*altIter2).size()) continue;
+
+              auto scidIter2 = (*altIter2).begin();
+              for (auto scidIter1 = (*altIter1).begin(); scidIter1 != (*altIter1).end(); ++scidIter1, ++scidIter2) {
+                same("m.simulcast.scid.paused", (*scidIter1).mPaused, (*scidIter2).mPaused);
+                same("m.simulcast.scid.rid", (*scidIter1).mRID, (*scidIter2).mRID);
+              }
+            }
+          }
+        }
+
+        //---------------------------------------------------------------------
+        template <typename LinePtr>
+        bool present(
+                     const char *name,
+                     const LinePtr &line1,
+                     const LinePtr &line2
+                     )
+        {
+          same((String(name) + ".present").c_str(), (bool)line1, (bool)line2);
+          return (line1) && (line2);
+        }
+
+        //---------------------------------------------------------------------
+        // lines must point back at the equivalent m-line of their own SDP
+        void owner(
+                   const char *name,
+                   const MLinePtr &lineMLine1,
+                   const MLinePtr &lineMLine2,
+                   const MLinePtr &mline1,
+                   const MLinePtr &mline2
+                   )
+        {
+          same((String(name) + ".mline").c_str(), lineMLine1 == mline1, true);
+          same((String(name) + ".mline").c_str(), lineMLine2 == mline2, true);
+        }
+
+        //---------------------------------------------------------------------
+        template <typename T>
+        void same(
+                  const char *name,
+                  const zsLib::Optional<T> &value1,
+                  const zsLib::Optional<T> &value2
+                  )
+        {
+          same((String(name) + ".hasValue").c_str(), value1.hasValue(), value2.hasValue());
+          if ((!value1.hasValue()) || (!value2.hasValue())) return;
+          same(name, value1.value(), value2.value());
+        }
+
+        //---------------------------------------------------------------------
+        template <typename T>
+        void same(
+                  const char *name,
+                  const T &value1,
+                  const T &value2
+                  )
+        {
+          if (value1 == value2) return;
+
+          ++mMismatches;
+          TESTING_STDOUT() << "MISMATCH:     " << name << "\n";
+        }
+
+      protected:
+        size_t mMismatches {};
+      };
+
+      //-----------------------------------------------------------------------
+      // fixtures covering the session and media level attributes the parser
+      // understands (including unknown attributes which must be left behind
+      // in the line infos)
+      static const char *gFixtures[] =
+      {
+        // audio + video + data (bundled, rtcp-mux, session level fingerprint)
+        "v=0\r\n"
+        "o=- 1723491034856375 2 IN IP4 127.0.0.1\r\n"
+        "s=-\r\n"
+        "t=0 0\r\n"
+        "a=group:BUNDLE audio video data\r\n"
+        "a=msid-semantic: WMS 3kXVsVnZEr2x0ZiuRfJy5lWP2TAa8rB0lxKc\r\n"
+        "a=fingerprint:sha-256 8B:87:09:8A:5D:C2:F3:33:EF:C5:B1:F6:84:3A:3D:D6:A3:E2:9C:17:4C:E7:46:3B:1B:CE:84:98:DD:8E:AF:7B\r\n"
+        "a=ice-options:trickle renomination\r\n"
+        "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 9 0 8 126\r\n"
+        "c=IN IP4 0.0.0.0\r\n"
+        "b=AS:64\r\n"
+        "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:Fd3v\r\n"
+        "a=ice-pwd:2wq2E0XuhRlkoGRp23IOIhUz\r\n"
+        "a=setup:actpass\r\n"
+        "a=mid:audio\r\n"
+        "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+        "a=extmap:3/sendonly http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+        "a=sendrecv\r\n"
+        "a=msid:3kXVsVnZEr2x0ZiuRfJy5lWP2TAa8rB0lxKc 7e5e2b4a-4b0c-4e5c-b1a3-0a8f9f8c7d6e\r\n"
+        "a=rtcp-mux\r\n"
+        "a=rtpmap:111 opus/48000/2\r\n"
+        "a=rtcp-fb:111 transport-cc\r\n"
+        "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+        "a=rtpmap:103 ISAC/16000\r\n"
+        "a=rtpmap:9 G722/8000\r\n"
+        "a=rtpmap:0 PCMU/8000\r\n"
+        "a=rtpmap:8 PCMA/8000\r\n"
+        "a=rtpmap:126 telephone-event/8000\r\n"
+        "a=ptime:20\r\n"
+        "a=maxptime:60\r\n"
+        "a=ssrc:1946734361 cname:0NyF5tcNGLfhYJ1q\r\n"
+        "a=ssrc:1946734361 msid:3kXVsVnZEr2x0ZiuRfJy5lWP2TAa8rB0lxKc 7e5e2b4a-4b0c-4e5c-b1a3-0a8f9f8c7d6e\r\n"
+        "a=candidate:842163049 1 udp 1677729535 203.0.113.7 61665 typ srflx raddr 192.168.1.2 rport 61665 generation 0 network-cost 50\r\n"
+        "a=end-of-candidates\r\n"
+        "a=x-not-understood:value\r\n"
+        "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100\r\n"
+        "c=IN IP4 0.0.0.0\r\n"
+        "b=TIAS:2000000\r\n"
+        "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:Fd3v\r\n"
+        "a=ice-pwd:2wq2E0XuhRlkoGRp23IOIhUz\r\n"
+        "a=setup:actpass\r\n"
+        "a=mid:video\r\n"
+        "a=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+        "a=extmap:4 urn:3gpp:video-orientation\r\n"
+        "a=sendonly\r\n"
+        "a=rtcp-mux\r\n"
+        "a=rtcp-rsize\r\n"
+        "a=rtpmap:96 VP8/90000\r\n"
+        "a=rtcp-fb:96 goog-remb\r\n"
+        "a=rtcp-fb:96 ccm fir\r\n"
+        "a=rtcp-fb:96 nack\r\n"
+        "a=rtcp-fb:96 nack pli\r\n"
+        "a=rtcp-fb:* transport-cc\r\n"
+        "a=rtpmap:97 rtx/90000\r\n"
+        "a=fmtp:97 apt=96\r\n"
+        "a=rtpmap:98 red/90000\r\n"
+        "a=rtpmap:99 ulpfec/90000\r\n"
+        "a=rtpmap:100 H264/90000\r\n"
+        "a=fmtp:100 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n"
+        "a=ssrc-group:FID 2231627014 632943048\r\n"
+        "a=ssrc:2231627014 cname:0NyF5tcNGLfhYJ1q\r\n"
+        "a=ssrc:2231627014 label:video-track\r\n"
+        "a=ssrc:632943048 cname:0NyF5tcNGLfhYJ1q\r\n"
+        "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+        "c=IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:Fd3v\r\n"
+        "a=ice-pwd:2wq2E0XuhRlkoGRp23IOIhUz\r\n"
+        "a=setup:actpass\r\n"
+        "a=mid:data\r\n"
+        "a=sctp-port:5000\r\n"
+        "a=max-message-size:262144\r\n",
+
+        // ice-lite answer with session level ice credentials, a media
+        // direction and an SDES keyed (non bundled) m-line
+        "v=0\r\n"
+        "o=jdoe 2890844526 2890842807 IN IP4 10.47.16.5\r\n"
+        "s=SDP Seminar\r\n"
+        "c=IN IP4 224.2.17.12\r\n"
+        "t=2873397496 2873404696\r\n"
+        "a=ice-lite\r\n"
+        "a=ice-ufrag:8hhY\r\n"
+        "a=ice-pwd:asd88fgpdd777uzjYhagZg\r\n"
+        "a=setup:passive\r\n"
+        "a=recvonly\r\n"
+        "m=audio 49170 RTP/SAVP 0\r\n"
+        "a=crypto:1 AES_CM_128_HMAC_SHA1_80 inline:PS1uQCVeeCFCanVmcjkpPywjNWhcYD0mXXtxaVBR|2^20|1:32\r\n"
+        "a=rtpmap:0 PCMU/8000\r\n"
+        "a=candidate:1 1 UDP 2130706431 10.0.1.1 8998 typ host\r\n"
+        "a=candidate:2 1 UDP 1694498815 192.0.2.3 45664 typ srflx raddr 10.0.1.1 rport 8998\r\n"
+        "m=video 51372 RTP/SAVPF 99\r\n"
+        "a=inactive\r\n"
+        "a=bundle-only\r\n"
+        "a=rtpmap:99 h263-1998/90000\r\n"
+        "a=rid:1 send pt=99;max-width=1280;max-height=720\r\n"
+        "a=rid:2 send pt=99;max-width=640;max-height=360\r\n"
+        "a=simulcast:send 1;~2\r\n",
+
+        NULL
+      };
+
+      //-----------------------------------------------------------------------
+      static bool parseBoth(
+                            const char *blob,
+                            UseSDPTypes::SDPPtr &outSinglePass,
+                            UseSDPTypes::SDPPtr &outMultiPass
+                            )
+      {
+        bool singlePassThrew = false;
+        bool multiPassThrew = false;
+
+        try {
+          outSinglePass = UseSDPParser::parse(blob);
+        } catch (const ortc::InvalidParameters &) {
+          singlePassThrew = true;
+        }
+        try {
+          outMultiPass = ReferenceSDPParser::parseMultiPass(blob);
+        } catch (const ortc::InvalidParameters &) {
+          multiPassThrew = true;
+        }
+
+        // both parsers must reject the same SDPs
+        TESTING_EQUAL(singlePassThrew, multiPassThrew)
+
+        return (outSinglePass) && (outMultiPass);
+      }
+
+      //-----------------------------------------------------------------------
+      static void compareParsers(
+                                 const char *name,
+                                 const char *blob
+                                 )
+      {
+        TESTING_STDOUT() << "TESTING:      sdp single pass vs multi pass parse, fixture=" << name << "\n";
+
+        UseSDPTypes::SDPPtr singlePass;
+        UseSDPTypes::SDPPtr multiPass;
+        bool parsed = parseBoth(blob, singlePass, multiPass);
+        TESTING_CHECK(parsed)
+        if (!parsed) return;
+
+        SDPComparer comparer;
+        comparer.compare(*singlePass, *multiPass);
+        TESTING_EQUAL(comparer.mismatches(), 0)
+      }
+
+      //-----------------------------------------------------------------------
+      static String createSimulcastSDP(size_t totalMediaLines)
+      {
+        String result =
+          "v=0\r\n"
+          "o=- 4611731400430051336 2 IN IP4 127.0.0.1\r\n"
+          "s=-\r\n"
+          "t=0 0\r\n"
+          "a=msid-semantic: WMS stream\r\n"
+          "a=ice-options:trickle\r\n";
+
+        String group = "a=group:BUNDLE";
+        for (size_t index = 0; index < totalMediaLines; ++index) {
+          group += " " + string(index);
+        }
+        result += group + "\r\n";
+
+        for (size_t index = 0; index < totalMediaLines; ++index) {
+          DWORD baseSSRC = static_cast<DWORD>(1000 + (index * 10));
+
+          result +=
+            "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98\r\n"
+            "c=IN IP4 0.0.0.0\r\n"
+            "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+            "a=ice-ufrag:8hhY\r\n"
+            "a=ice-pwd:asd88fgpdd777uzjYhagZg\r\n"
+            "a=fingerprint:sha-256 D1:2C:BE:AD:C4:F6:64:5C:25:16:11:9C:AF:E7:0F:73:79:36:4E:9C:1E:15:54:39:0C:06:8B:ED:96:86:00:39\r\n"
+            "a=setup:actpass\r\n";
+          result += "a=mid:" + string(index) + "\r\n";
+          result +=
+            "a=extmap:1 urn:ietf:params:rtp-hdrext:toffset\r\n"
+            "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+            "a=extmap:3 urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id\r\n"
+            "a=sendrecv\r\n"
+            "a=rtcp-mux\r\n"
+            "a=rtcp-rsize\r\n"
+            "a=rtpmap:96 VP8/90000\r\n"
+            "a=rtcp-fb:96 ccm fir\r\n"
+            "a=rtcp-fb:96 nack\r\n"
+            "a=rtcp-fb:96 nack pli\r\n"
+            "a=rtcp-fb:96 goog-remb\r\n"
+            "a=rtpmap:97 rtx/90000\r\n"
+            "a=fmtp:97 apt=96\r\n"
+            "a=rtpmap:98 H264/90000\r\n"
+            "a=fmtp:98 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n"
+            "a=rid:hi send pt=96\r\n"
+            "a=rid:mid send pt=96\r\n"
+            "a=rid:lo send pt=96\r\n"
+            "a=simulcast:send hi;mid;lo\r\n";
+          result += "a=ssrc-group:FID " + string(baseSSRC) + " " + string(baseSSRC + 1) + "\r\n";
+          result += "a=ssrc:" + string(baseSSRC) + " cname:benchmark\r\n";
+          result += "a=ssrc:" + string(baseSSRC + 1) + " cname:benchmark\r\n";
+          result += "a=candidate:1 1 udp 2122260223 192.168.1.2 5" + string(1000 + index) + " typ host generation 0\r\n";
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      static void testParse(size_t totalMediaLines)
+      {
+        String blob = createSimulcastSDP(totalMediaLines);
+
+        auto sdp = UseSDPParser::parse(blob.c_str());
+        TESTING_CHECK(sdp)
+        if (!sdp) return;
+
+        TESTING_EQUAL(sdp->mMLines.size(), totalMediaLines)
+        TESTING_EQUAL(sdp->mAGroupLines.size(), 1)
+
+        for (auto iter = sdp->mMLines.begin(); iter != sdp->mMLines.end(); ++iter) {
+          auto &mline = (*iter);
+          TESTING_CHECK(mline->mAMIDLine)
+          TESTING_CHECK(mline->mASimulcastLine)
+          TESTING_EQUAL(mline->mARIDLines.size(), 3)
+          TESTING_EQUAL(mline->mARTPMapLines.size(), 3)
+          TESTING_EQUAL(mline->mAFMTPLines.size(), 2)
+          TESTING_EQUAL(mline->mARTCPFBLines.size(), 4)
+          TESTING_EQUAL(mline->mASSRCLines.size(), 2)
+          TESTING_EQUAL(mline->mACandidateLines.size(), 1)
+          TESTING_CHECK(mline->mRTCPMux.hasValue())
+          TESTING_CHECK(mline->mMediaDirection.hasValue())
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void benchmarkParse(
+                                 size_t totalMediaLines,
+                                 ULONG iterations
+                                 )
+      {
+        String blob = createSimulcastSDP(totalMediaLines);
+
+        ULONG parsed = 0;
+
+        // before: the multi pass reference parser
+        Time start = zsLib::now();
+        for (ULONG index = 0; index < iterations; ++index) {
+          auto sdp = ReferenceSDPParser::parseMultiPass(blob.c_str());
+          if (sdp) ++parsed;
+        }
+        auto before = zsLib::toMicroseconds(zsLib::now() - start);
+
+        // after: the single pass parser
+        start = zsLib::now();
+        for (ULONG index = 0; index < iterations; ++index) {
+          auto sdp = UseSDPParser::parse(blob.c_str());
+          if (sdp) ++parsed;
+        }
+        auto after = zsLib::toMicroseconds(zsLib::now() - start);
+
+        TESTING_EQUAL(parsed, iterations * 2)
+
+        TESTING_STDOUT() << "BENCHMARK:    sdp parse, m-lines=" << totalMediaLines << ", bytes=" << blob.length() << ", iterations=" << iterations << ", before=" << (before.count() / iterations) << "us, after=" << (after.count() / iterations) << "us, speedup=" << (after.count() > 0 ? static_cast<double>(before.count()) / static_cast<double>(after.count()) : 0.0) << "x\n";
+      }
+
+      //-----------------------------------------------------------------------
+      static void benchmarkAttributeLookup(ULONG iterations)
+      {
+        const char *names[] = {
+          "candidate", "rtpmap", "fmtp", "rtcp-fb", "ssrc", "extmap", "rid", "max-message-size", "x-unknown-attribute", NULL
+        };
+
+        for (size_t index = 0; NULL != names[index]; ++index) {
+          TESTING_EQUAL(UseSDPTypes::toAttribute(names[index]), linearToAttribute(names[index]))
+        }
+
+        size_t matched = 0;
+
+        Time start = zsLib::now();
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (size_t index = 0; NULL != names[index]; ++index) {
+            if (UseSDPTypes::Attribute_Unknown != linearToAttribute(names[index])) ++matched;
+          }
+        }
+        auto linear = zsLib::toMicroseconds(zsLib::now() - start);
+
+        start = zsLib::now();
+        for (ULONG loop = 0; loop < iterations; ++loop) {
+          for (size_t index = 0; NULL != names[index]; ++index) {
+            if (UseSDPTypes::Attribute_Unknown != UseSDPTypes::toAttribute(names[index])) ++matched;
+          }
+        }
+        auto hashed = zsLib::toMicroseconds(zsLib::now() - start);
+
+        TESTING_CHECK(matched > 0)
+
+        TESTING_STDOUT() << "BENCHMARK:    sdp attribute lookup, iterations=" << iterations << ", linear=" << linear.count() << "us, hashed=" << hashed.count() << "us\n";
+      }
+    }
+  }
+}
+
+using namespace ortc::test::sdpparser;
+
+void doTestSDPParser()
+{
+  if (!ORTC_TEST_DO_SDP_PARSER_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testParse(1);
+  testParse(50);
+
+  for (size_t index = 0; NULL != gFixtures[index]; ++index) {
+    compareParsers(zsLib::string(index).c_str(), gFixtures[index]);
+  }
+  compareParsers("simulcast-1", createSimulcastSDP(1).c_str());
+  compareParsers("simulcast-50", createSimulcastSDP(50).c_str());
+
+  benchmarkParse(50, 50);
+  benchmarkParse(100, 20);
+  benchmarkParse(200, 10);
+
+  benchmarkAttributeLookup(100000);
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -707,6 +707,9 @@ void doTestSRTP()
 
   UseSettings::applyDefaults();
 
+  // aggregation is disabled by default; step 20 verifies compound packets
+  UseSettings::setUInt("ortc/srtp/rtcp-aggregation-window-in-milliseconds", 20);
+
   auto thread(zsLib::IMessageQueueThread::createBasic());
 
   FakeSecureTransportPtr fakeDTLSObject1;
@@ -1144,6 +1147,16 @@ void doTestSRTP()
               break;
             }
             case 20: {
+              // two receiver reports sent back to back are expected to be
+              // aggregated into a single compound SRTCP packet
+              size_t report_len = sizeof(DWORD)*2;
+              SecureByteBlockPtr report = UseServicesHelper::convertToBuffer(kRtcpReport, report_len);
+              SecureByteBlockPtr compound(std::make_shared<SecureByteBlock>(report_len*2));
+              memcpy(compound->BytePtr(), kRtcpReport, report_len);
+              memcpy(compound->BytePtr() + report_len, kRtcpReport, report_len);
+              if (testSRTPObject1) testSRTPObject1->expectingIncomingPacket(IICETypes::Component_RTCP, IICETypes::Component_RTCP, *compound, compound->SizeInBytes());
+              if (testSRTPObject2) testSRTPObject2->sendPacket(IICETypes::Component_RTCP, IICETypes::Component_RTCP, *report, report->SizeInBytes());
+              if (testSRTPObject2) testSRTPObject2->sendPacket(IICETypes::Component_RTCP, IICETypes::Component_RTCP, *report, report->SizeInBytes());
               break;
             }
             case 25: {
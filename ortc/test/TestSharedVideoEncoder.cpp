@@ -0,0 +1,195 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+
+
+#include <ortc/internal/ortc_RTPMediaEngine.h>
+
+#include <zsLib/ISettings.h>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::BYTE;
+using zsLib::WORD;
+using zsLib::DWORD;
+using zsLib::Milliseconds;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::RTPMediaEngine::SharedVideoEncoder, UseSharedVideoEncoder)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace sharedvideoencoder
+    {
+      typedef UseSharedVideoEncoder::Layer Layer;
+
+      //-----------------------------------------------------------------------
+      static Layer createLayer(
+                               WORD lastSequenceNumber,
+                               DWORD lastTimestamp
+                               )
+      {
+        Layer layer;
+        layer.mSSRC = 0x1000;
+        layer.mLastSequenceNumber = lastSequenceNumber;
+        layer.mLastTimestamp = lastTimestamp;
+        return layer;
+      }
+
+      //-----------------------------------------------------------------------
+      static void checkRewrite(
+                               Layer &layer,
+                               WORD sequenceNumber,
+                               DWORD timestamp,
+                               DWORD step,
+                               WORD expectedSequenceNumber,
+                               DWORD expectedTimestamp
+                               )
+      {
+        WORD rewrittenSequenceNumber {};
+        DWORD rewrittenTimestamp {};
+        UseSharedVideoEncoder::rewrite(layer, sequenceNumber, timestamp, step, rewrittenSequenceNumber, rewrittenTimestamp);
+
+        TESTING_EQUAL(rewrittenSequenceNumber, expectedSequenceNumber)
+        TESTING_EQUAL(rewrittenTimestamp, expectedTimestamp)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testFrameTimestampStep()
+      {
+        TESTING_EQUAL(UseSharedVideoEncoder::frameTimestampStep(90000, 30), 3000)
+        TESTING_EQUAL(UseSharedVideoEncoder::frameTimestampStep(90000, 15), 6000)
+        TESTING_EQUAL(UseSharedVideoEncoder::frameTimestampStep(90000, 60), 1500)
+
+        // unknown clock rate or frame rate fall back to 90kHz / 30fps
+        TESTING_EQUAL(UseSharedVideoEncoder::frameTimestampStep(0, 30), 3000)
+        TESTING_EQUAL(UseSharedVideoEncoder::frameTimestampStep(90000, 0), 3000)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testRewrite()
+      {
+        Layer layer = createLayer(100, 5000);
+
+        // the first packet continues after the layer's starting point
+        checkRewrite(layer, 40000, 123456, 3000, 101, 8000);
+        checkRewrite(layer, 40001, 123456, 3000, 102, 8000);
+        checkRewrite(layer, 40002, 126456, 3000, 103, 11000);
+
+        TESTING_EQUAL(layer.mLastSequenceNumber, 103)
+        TESTING_EQUAL(layer.mLastTimestamp, 11000)
+
+        // a late packet is rewritten but does not move the layer back
+        checkRewrite(layer, 39999, 120456, 3000, 100, 5000);
+
+        TESTING_EQUAL(layer.mLastSequenceNumber, 103)
+        TESTING_EQUAL(layer.mLastTimestamp, 11000)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testResync()
+      {
+        Layer layer = createLayer(100, 5000);
+
+        checkRewrite(layer, 40000, 123456, 6000, 101, 11000);
+        checkRewrite(layer, 40001, 129456, 6000, 102, 17000);
+
+        // a promoted producer numbers its packets differently; the layer
+        // continues a packet and a frame interval (15fps at 90kHz) later
+        layer.mResync = true;
+        checkRewrite(layer, 7, 999, 6000, 103, 23000);
+        checkRewrite(layer, 8, 6999, 6000, 104, 29000);
+      }
+
+      //-----------------------------------------------------------------------
+      static void testWrapAround()
+      {
+        Layer layer = createLayer(0xFFFE, 0xFFFFFFFF - 1000);
+
+        checkRewrite(layer, 10, 0, 3000, 0xFFFF, 1999);
+        checkRewrite(layer, 11, 3000, 3000, 0, 4999);
+
+        TESTING_EQUAL(layer.mLastSequenceNumber, 0)
+        TESTING_EQUAL(layer.mLastTimestamp, 4999)
+      }
+
+      //-----------------------------------------------------------------------
+      static void testWithoutProducer()
+      {
+        auto encoder = UseSharedVideoEncoder::create("key", -1, -1, Milliseconds(100), 90000, 30);
+        TESTING_CHECK(encoder)
+        if (!encoder) return;
+
+        BYTE packet[12] {};
+        packet[0] = 0x80;
+        packet[1] = 96;
+
+        webrtc::PacketOptions options;
+        TESTING_CHECK(!encoder->SendRtp(packet, sizeof(packet), options))
+        TESTING_CHECK(!encoder->SendRtcp(packet, sizeof(packet)))
+        TESTING_CHECK(!encoder->hasActiveConsumer())
+
+        UseSharedVideoEncoder::LayerList layers;
+        TESTING_CHECK(!encoder->getConsumerLayers(1, layers))
+
+        // nothing to notify
+        encoder->notifyConsumerStateChanged();
+
+        TESTING_CHECK(encoder->toDebug())
+      }
+    }
+  }
+}
+
+using namespace ortc::test::sharedvideoencoder;
+
+void doTestSharedVideoEncoder()
+{
+  if (!ORTC_TEST_DO_SHARED_VIDEO_ENCODER_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+
+  testFrameTimestampStep();
+  testRewrite();
+  testResync();
+  testWrapAround();
+  testWithoutProducer();
+
+  TESTING_UNINSTALL_LOGGER();
+}
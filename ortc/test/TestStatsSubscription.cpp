@@ -0,0 +1,414 @@
+/*
+ 
+ Copyright (c) 2015, Hookflash Inc.
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those
+ of the authors and should not be interpreted as representing official policies,
+ either expressed or implied, of the FreeBSD Project.
+ 
+ */
+
+
+#include <ortc/internal/ortc_StatsReport.h>
+
+#include <ortc/IStatsProvider.h>
+#include <ortc/IStatsReport.h>
+
+#include <zsLib/ISettings.h>
+#include <zsLib/IMessageQueueThread.h>
+
+#include <thread>
+
+#include "config.h"
+#include "testing.h"
+
+namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
+
+using zsLib::ULONG;
+using zsLib::DWORD;
+using zsLib::String;
+using zsLib::Milliseconds;
+using zsLib::AutoRecursiveLock;
+using zsLib::RecursiveLock;
+
+ZS_DECLARE_TYPEDEF_PTR(zsLib::ISettings, UseSettings)
+ZS_DECLARE_TYPEDEF_PTR(ortc::IStatsReportTypes, UseStatsReportTypes)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IStatsReportForInternal, UseStatsReport)
+ZS_DECLARE_TYPEDEF_PTR(ortc::internal::IStatsProviderForStatsSubscription, UseDirectStatsProvider)
+
+namespace ortc
+{
+  namespace test
+  {
+    namespace statssubscription
+    {
+      ZS_DECLARE_CLASS_PTR(FakeStatsProvider);
+      ZS_DECLARE_CLASS_PTR(DeltaCollector);
+
+      typedef IStatsProviderTypes::StatsDelta StatsDelta;
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::StatsDelta, StatsDelta);
+      ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
+      typedef std::list<StatsDeltaPtr> StatsDeltaList;
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeStatsProvider
+      #pragma mark
+
+      // Reports a single outbound RTP stream whose counters the test changes
+      // between samples; optionally also offers the direct sampling path.
+      class FakeStatsProvider : public IStatsProvider,
+                                public UseDirectStatsProvider
+      {
+      public:
+        FakeStatsProvider(
+                          zsLib::IMessageQueuePtr queue,
+                          bool direct
+                          ) :
+          mQueue(queue),
+          mDirect(direct)
+        {}
+
+        void setPacketsSent(unsigned long packetsSent)
+        {
+          AutoRecursiveLock lock(mLock);
+          mPacketsSent = packetsSent;
+        }
+
+        void setPresent(bool present)
+        {
+          AutoRecursiveLock lock(mLock);
+          mPresent = present;
+        }
+
+        ULONG getStatsCalls() const {AutoRecursiveLock lock(mLock); return mGetStatsCalls;}
+        ULONG sampleStatsCalls() const {AutoRecursiveLock lock(mLock); return mSampleStatsCalls;}
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark FakeStatsProvider => IStatsProvider
+        #pragma mark
+
+        virtual PromiseWithStatsReportPtr getStats(const StatsTypeSet &stats = StatsTypeSet()) const override
+        {
+          UseStatsReport::StatMap statMap;
+
+          {
+            AutoRecursiveLock lock(mLock);
+            ++mGetStatsCalls;
+
+            auto report = createStats();
+            if (report) statMap[report->mID] = report;
+          }
+
+          auto promise = PromiseWithStatsReport::create(mQueue);
+          promise->resolve(UseStatsReport::create(statMap));
+          return promise;
+        }
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark FakeStatsProvider => IStatsProviderForStatsSubscription
+        #pragma mark
+
+        virtual bool sampleStats(
+                                 const IStatsReportTypes::StatsTypeSet &stats,
+                                 StatsList &outStats
+                                 ) const override
+        {
+          if (!mDirect) return false;
+
+          AutoRecursiveLock lock(mLock);
+          ++mSampleStatsCalls;
+
+          auto report = createStats();
+          if (report) outStats.push_back(report);
+          return true;
+        }
+
+      protected:
+        IStatsReportTypes::StatsPtr createStats() const
+        {
+          if (!mPresent) return IStatsReportTypes::StatsPtr();
+
+          auto report = make_shared<IStatsReportTypes::OutboundRTPStreamStats>();
+          report->mID = "1234_send";
+          report->mSSRC = 1234;
+          report->mPacketsSent = mPacketsSent;
+          report->mBytesSent = mPacketsSent * 100;
+          return report;
+        }
+
+      protected:
+        mutable RecursiveLock mLock;
+        zsLib::IMessageQueuePtr mQueue;
+        bool mDirect {};
+
+        bool mPresent {true};
+        unsigned long mPacketsSent {};
+
+        mutable ULONG mGetStatsCalls {};
+        mutable ULONG mSampleStatsCalls {};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark DeltaCollector
+      #pragma mark
+
+      class DeltaCollector : public IStatsSubscriptionDelegate
+      {
+      public:
+        virtual void onStatsSubscriptionDelta(
+                                              IStatsSubscriptionPtr subscription,
+                                              StatsDeltaPtr delta
+                                              ) override
+        {
+          AutoRecursiveLock lock(mLock);
+          mDeltas.push_back(delta);
+        }
+
+        StatsDeltaPtr waitForDelta(ULONG maxWaitInMilliseconds = 5000)
+        {
+          for (ULONG waited = 0; true; waited += 10) {
+            {
+              AutoRecursiveLock lock(mLock);
+              if (mDeltas.size() > 0) {
+                auto delta = mDeltas.front();
+                mDeltas.pop_front();
+                return delta;
+              }
+            }
+            if (waited >= maxWaitInMilliseconds) break;
+            std::this_thread::sleep_for(Milliseconds(10));
+          }
+          return StatsDeltaPtr();
+        }
+
+        void clear()
+        {
+          AutoRecursiveLock lock(mLock);
+          mDeltas.clear();
+        }
+
+      protected:
+        RecursiveLock mLock;
+        StatsDeltaList mDeltas;
+      };
+
+      //-----------------------------------------------------------------------
+      static const StatsDelta::CounterInfo *findNewCounter(
+                                                           StatsDeltaPtr delta,
+                                                           const char *name
+                                                           )
+      {
+        for (auto iter = delta->mNewCounters.begin(); iter != delta->mNewCounters.end(); ++iter) {
+          if ((*iter).mCounterName == name) return &(*iter);
+        }
+        return NULL;
+      }
+
+      //-----------------------------------------------------------------------
+      static const StatsDelta::Counter *findChangedCounter(
+                                                           StatsDeltaPtr delta,
+                                                           StatsDelta::CounterKey key
+                                                           )
+      {
+        for (auto iter = delta->mChangedCounters.begin(); iter != delta->mChangedCounters.end(); ++iter) {
+          if ((*iter).mKey == key) return &(*iter);
+        }
+        return NULL;
+      }
+
+      //-----------------------------------------------------------------------
+      static void testDeltas(bool direct)
+      {
+        TESTING_STDOUT() << "TESTING:      stats subscription deltas (" << (direct ? "direct counters" : "getStats") << ")\n";
+
+        auto queue = zsLib::IMessageQueueThread::createBasic();
+        auto provider = make_shared<FakeStatsProvider>(queue, direct);
+        auto collector = make_shared<DeltaCollector>();
+
+        provider->setPacketsSent(10);
+
+        IStatsProviderTypes::SamplingIntervalMap intervals;
+        intervals[IStatsReportTypes::StatsType_OutboundRTP] = Milliseconds(50);
+
+        auto subscription = IStatsSubscription::create(collector, provider, intervals);
+        TESTING_CHECK(subscription)
+
+        // first delta describes every counter once
+        auto delta = collector->waitForDelta();
+        TESTING_CHECK(delta)
+        if (!delta) return;
+
+        auto packetsSentInfo = findNewCounter(delta, "packetsSent");
+        auto bytesSentInfo = findNewCounter(delta, "bytesSent");
+        TESTING_CHECK(packetsSentInfo)
+        TESTING_CHECK(bytesSentInfo)
+        if ((!packetsSentInfo) || (!bytesSentInfo)) return;
+
+        TESTING_EQUAL(packetsSentInfo->mStatID, String("1234_send"))
+        TESTING_CHECK(packetsSentInfo->mStatsType.hasValue())
+        TESTING_CHECK(IStatsReportTypes::StatsType_OutboundRTP == packetsSentInfo->mStatsType.value())
+        TESTING_EQUAL(delta->mNewCounters.size(), delta->mChangedCounters.size())
+        TESTING_EQUAL(delta->mRemovedCounters.size(), 0)
+
+        size_t totalCounters = delta->mNewCounters.size();
+        auto packetsSentKey = packetsSentInfo->mKey;
+        auto bytesSentKey = bytesSentInfo->mKey;
+        TESTING_CHECK(packetsSentKey != bytesSentKey)
+
+        auto firstPacketsSent = findChangedCounter(delta, packetsSentKey);
+        TESTING_CHECK(firstPacketsSent)
+        if (firstPacketsSent) {TESTING_EQUAL(firstPacketsSent->mValue, 10.0)}
+
+        DWORD sequenceNumber = delta->mSequenceNumber;
+
+        // only the changed counters are delivered afterwards (by key)
+        collector->clear();
+        provider->setPacketsSent(20);
+
+        delta = collector->waitForDelta();
+        TESTING_CHECK(delta)
+        if (!delta) return;
+
+        // unchanged samples in between do not consume sequence numbers
+        TESTING_EQUAL(delta->mSequenceNumber, sequenceNumber + 1)
+        TESTING_EQUAL(delta->mNewCounters.size(), 0)
+        TESTING_EQUAL(delta->mChangedCounters.size(), 2)
+        TESTING_EQUAL(delta->mRemovedCounters.size(), 0)
+
+        auto packetsSent = findChangedCounter(delta, packetsSentKey);
+        auto bytesSent = findChangedCounter(delta, bytesSentKey);
+        TESTING_CHECK(packetsSent)
+        TESTING_CHECK(bytesSent)
+        if (packetsSent) {TESTING_EQUAL(packetsSent->mValue, 20.0)}
+        if (bytesSent) {TESTING_EQUAL(bytesSent->mValue, 2000.0)}
+
+        // unchanged samples produce no delta at all
+        collector->clear();
+        std::this_thread::sleep_for(Milliseconds(300));
+        TESTING_CHECK(!collector->waitForDelta(0))
+
+        // a stat which disappears has every one of its keys removed
+        provider->setPresent(false);
+
+        delta = collector->waitForDelta();
+        TESTING_CHECK(delta)
+        if (!delta) return;
+
+        TESTING_EQUAL(delta->mSequenceNumber, sequenceNumber + 2)
+        TESTING_EQUAL(delta->mChangedCounters.size(), 0)
+        TESTING_EQUAL(delta->mRemovedCounters.size(), totalCounters)
+
+        bool removedPacketsSent = false;
+        for (auto iter = delta->mRemovedCounters.begin(); iter != delta->mRemovedCounters.end(); ++iter) {
+          if (packetsSentKey == (*iter)) removedPacketsSent = true;
+        }
+        TESTING_CHECK(removedPacketsSent)
+
+        subscription->cancel();
+
+        if (direct) {
+          // direct counters are sampled without ever creating a stats promise
+          TESTING_CHECK(provider->sampleStatsCalls() >= 4)
+          TESTING_EQUAL(provider->getStatsCalls(), 0)
+        } else {
+          TESTING_CHECK(provider->getStatsCalls() >= 4)
+          TESTING_EQUAL(provider->sampleStatsCalls(), 0)
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      static void testIntervals()
+      {
+        TESTING_STDOUT() << "TESTING:      stats subscription sampling intervals\n";
+
+        auto queue = zsLib::IMessageQueueThread::createBasic();
+        auto provider = make_shared<FakeStatsProvider>(queue, true);
+        auto collector = make_shared<DeltaCollector>();
+
+        provider->setPacketsSent(1);
+
+        // only sampled stats types are requested from the provider
+        IStatsProviderTypes::SamplingIntervalMap intervals;
+        intervals[IStatsReportTypes::StatsType_InboundRTP] = Milliseconds(50);
+
+        auto subscription = IStatsSubscription::create(collector, provider, intervals);
+
+        std::this_thread::sleep_for(Milliseconds(300));
+        TESTING_CHECK(!collector->waitForDelta(0))
+
+        // enabling the type at runtime starts delivering it
+        subscription->setSamplingInterval(IStatsReportTypes::StatsType_OutboundRTP, Milliseconds(50));
+
+        auto delta = collector->waitForDelta();
+        TESTING_CHECK(delta)
+        if (delta) {TESTING_CHECK(findNewCounter(delta, "packetsSent"))}
+
+        // intervals below the minimum are clamped (not rejected)
+        subscription->setSamplingInterval(IStatsReportTypes::StatsType_OutboundRTP, Milliseconds(1));
+
+        auto debugEl = IStatsSubscription::toDebug(subscription);
+        TESTING_CHECK(debugEl)
+
+        // a zero interval stops sampling the type
+        subscription->setSamplingInterval(IStatsReportTypes::StatsType_OutboundRTP, Milliseconds());
+        std::this_thread::sleep_for(Milliseconds(100));
+        collector->clear();
+
+        provider->setPacketsSent(2);
+        std::this_thread::sleep_for(Milliseconds(300));
+        TESTING_CHECK(!collector->waitForDelta(0))
+
+        subscription->cancel();
+      }
+    }
+  }
+}
+
+using namespace ortc::test::statssubscription;
+
+void doTestStatsSubscription()
+{
+  if (!ORTC_TEST_DO_STATS_SUBSCRIPTION_TEST) return;
+
+  TESTING_INSTALL_LOGGER();
+
+  UseSettings::applyDefaults();
+  UseSettings::setUInt(ORTC_SETTING_STATS_SUBSCRIPTION_MINIMUM_SAMPLING_INTERVAL_IN_MILLISECONDS, 10);
+
+  testDeltas(false);
+  testDeltas(true);
+  testIntervals();
+
+  TESTING_UNINSTALL_LOGGER();
+}
@@ -58,8 +58,46 @@
 #define ORTC_TEST_DO_RTP_CHANNEL_VIDEO_TEST               (false)
 #define ORTC_TEST_DO_RTP_SENDER_TEST                      (false)
 #define ORTC_TEST_DO_RTP_MEDIA_STREAM_TRACK_TEST          (false)
+#define ORTC_TEST_DO_STATS_SUBSCRIPTION_TEST              (false)
+#define ORTC_TEST_DO_RTP_STREAM_COUNTERS_TEST             (false)
+#define ORTC_TEST_DO_SDP_PARSER_TEST                      (false)
+#define ORTC_TEST_DO_ENUM_LOOKUP_TEST                     (false)
+#define ORTC_TEST_DO_PEER_CONNECTION_REMOTE_DIFF_TEST     (false)
+#define ORTC_TEST_DO_SHARED_VIDEO_ENCODER_TEST            (false)
+#define ORTC_TEST_DO_RTP_RELAY_TEST                       (false)
+#define ORTC_TEST_DO_RTP_CAPTURE_TEST                     (false)
+#define ORTC_TEST_DO_MESSAGE_QUEUE_MONITOR_TEST           (false)
+#define ORTC_TEST_DO_LOOPBACK_BENCHMARK                   (false)
+#define ORTC_TEST_DO_PACKET_BENCHMARK                     (false)
+#define ORTC_TEST_DO_NETWORK_IMPAIRMENT_TEST              (false)
+#define ORTC_TEST_DO_NETWORK_IMPAIRMENT_BENCHMARK         (false)
+#define ORTC_TEST_DO_SCTP_BENCHMARK                       (false)
+#define ORTC_TEST_DO_ICE_SCALE_BENCHMARK                  (false)
+#define ORTC_TEST_DO_MEDIA_CHANNEL_QUEUE_TEST             (false)
+#define ORTC_TEST_DO_ICE_GATHERER_POOL_TEST               (false)
+#define ORTC_TEST_DO_RTP_RETRANSMISSION_TEST              (false)
+#define ORTC_TEST_DO_ACTIVE_SPEAKER_DETECTOR_TEST         (false)
+#define ORTC_TEST_DO_PACKET_PIPELINE_LATENCY_TEST         (false)
 
 
+#define ORTC_TEST_BENCHMARK_OUTPUT_FILE                   ""      // JSON lines appended here when set
+#define ORTC_TEST_COUNT_ALLOCATIONS                       ((ORTC_TEST_DO_PACKET_BENCHMARK) || (ORTC_TEST_DO_ICE_SCALE_BENCHMARK))   // replaces global operator new/delete
+
+#define ORTC_TEST_LOOPBACK_BENCHMARK_DURATION_IN_SECONDS  (5)
+#define ORTC_TEST_PACKET_BENCHMARK_ITERATIONS             (100000)
+#define ORTC_TEST_NETWORK_IMPAIRMENT_SEED                 (1)
+#define ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGES             (2000)
+#define ORTC_TEST_NETWORK_IMPAIRMENT_MESSAGE_SIZE         (1000)
+#define ORTC_TEST_NETWORK_IMPAIRMENT_MAX_SECONDS          (60)    // per profile
+#define ORTC_TEST_SCTP_BENCHMARK_DURATION_IN_SECONDS      (5)     // per throughput run
+#define ORTC_TEST_SCTP_BENCHMARK_ROUND_TRIPS              (1000)
+#define ORTC_TEST_SCTP_BENCHMARK_MAX_BUFFERED_AMOUNT      (256 * 1024)
+#define ORTC_TEST_SCTP_BENCHMARK_MAX_RETRANSMITS          (0)
+#define ORTC_TEST_SCTP_BENCHMARK_MAX_PACKET_LIFETIME_IN_MILLISECONDS (100)
+#define ORTC_TEST_ICE_SCALE_CONNECT_TIMEOUT_IN_SECONDS    (120)
+#define ORTC_TEST_ICE_SCALE_HOLD_IN_MINUTES               (1)     // per scale step
+#define ORTC_TEST_ICE_SCALE_PAIRS                         {1, 10, 100, 1000, 2000}   // endpoint pairs per scale step (each pair needs at least 2 sockets, so raise the open file limit for the larger steps)
+
 #define ORTC_TEST_STUN_SERVER             "stun.vline.com"
 
 #define ORTC_TEST_REFLEXIVE_UDP_IPS       1
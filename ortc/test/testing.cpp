@@ -36,8 +36,22 @@
 #include <zsLib/helpers.h>
 #include <zsLib/Log.h>
 #include <ortc/services/ILogger.h>
+#include <ortc/services/IHelper.h>
 
+#include <zsLib/XML.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif //_WIN32
 
 namespace ortc { namespace test { ZS_IMPLEMENT_SUBSYSTEM(ortc_test) } }
 
@@ -52,6 +66,45 @@ debugostream &getDebugCout()
 
 
 typedef ortc::services::ILogger ILogger;
+typedef ortc::services::IHelper IHelper;
+
+static std::atomic<size_t> gTotalAllocations {};
+static std::atomic<size_t> gAllocatedBytes {};
+
+#if ORTC_TEST_COUNT_ALLOCATIONS
+
+// each block is prefixed with its size so delete can track live bytes
+static const size_t kAllocationHeaderSize = alignof(std::max_align_t);
+
+void *operator new(std::size_t size)
+{
+  ++gTotalAllocations;
+  void *result = malloc(kAllocationHeaderSize + size);
+  if (NULL == result) throw std::bad_alloc();
+  gAllocatedBytes += size;
+  *(static_cast<size_t *>(result)) = size;
+  return static_cast<char *>(result) + kAllocationHeaderSize;
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (NULL == ptr) return;
+  void *block = static_cast<char *>(ptr) - kAllocationHeaderSize;
+  gAllocatedBytes -= *(static_cast<size_t *>(block));
+  free(block);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+#endif //ORTC_TEST_COUNT_ALLOCATIONS
 
 void doSetup();
 void doTestRTPChannel();
@@ -68,6 +121,27 @@ void doTestICETransport();
 void doTestMediaStreamTrack(void* videoSurface);
 void doTestRTPChannelAudio();
 void doTestRTPChannelVideo(void* localSurface, void* remoteSurface);
+void doTestStatsSubscription();
+void doTestRTPStreamCounters();
+void doTestSDPParser();
+void doTestEnumLookup();
+void doTestPeerConnectionRemoteDiff();
+void doTestSharedVideoEncoder();
+void doTestRTPRelay();
+void doTestRTPCapture();
+void doTestMessageQueueMonitor();
+void doTestLoopbackBenchmark();
+void doTestRTPPacketBenchmark();
+void doTestRTCPPacketBenchmark();
+void doTestNetworkImpairment();
+void doTestNetworkImpairmentBenchmark();
+void doTestSCTPBenchmark();
+void doTestICEScaleBenchmark();
+void doTestMediaChannelQueue();
+void doTestICEGathererPool();
+void doTestRTPRetransmission();
+void doTestActiveSpeakerDetector();
+void doTestPacketPipelineLatency();
 
 namespace Testing
 {
@@ -185,6 +259,107 @@ namespace Testing
     }
   }
 
+  size_t getTotalAllocations()
+  {
+    return gTotalAllocations;
+  }
+
+  size_t getAllocatedBytes()
+  {
+    return gAllocatedBytes;
+  }
+
+  bool isCountingAllocations()
+  {
+    return ORTC_TEST_COUNT_ALLOCATIONS;
+  }
+
+#ifdef _WIN32
+  static zsLib::Microseconds toMicroseconds(
+                                            const FILETIME &kernelTime,
+                                            const FILETIME &userTime
+                                            )
+  {
+    ULARGE_INTEGER kernel {};
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+
+    ULARGE_INTEGER user {};
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+
+    return zsLib::Microseconds((kernel.QuadPart + user.QuadPart) / 10);  // 100ns units
+  }
+#endif //_WIN32
+
+  zsLib::Microseconds getProcessCPUTime()
+  {
+    // std::clock() is wall time on MSVC thus cannot be used
+#ifdef _WIN32
+    FILETIME creationTime {}, exitTime {}, kernelTime {}, userTime {};
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) return zsLib::Microseconds();
+    return toMicroseconds(kernelTime, userTime);
+#else
+    struct rusage usage {};
+    if (0 != getrusage(RUSAGE_SELF, &usage)) return zsLib::Microseconds();
+    return zsLib::Microseconds((static_cast<long long>(usage.ru_utime.tv_sec) + static_cast<long long>(usage.ru_stime.tv_sec)) * 1000000LL +
+                               static_cast<long long>(usage.ru_utime.tv_usec) + static_cast<long long>(usage.ru_stime.tv_usec));
+#endif //_WIN32
+  }
+
+  zsLib::Microseconds getThreadCPUTime()
+  {
+#ifdef _WIN32
+    FILETIME creationTime {}, exitTime {}, kernelTime {}, userTime {};
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) return zsLib::Microseconds();
+    return toMicroseconds(kernelTime, userTime);
+#else
+    struct timespec value {};
+    if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &value)) return zsLib::Microseconds();
+    return zsLib::Microseconds(static_cast<long long>(value.tv_sec) * 1000000LL + static_cast<long long>(value.tv_nsec) / 1000);
+#endif //_WIN32
+  }
+
+  void outputBenchmark(zsLib::XML::ElementPtr resultEl)
+  {
+    zsLib::String json = IHelper::toString(resultEl);
+
+    TESTING_STDOUT() << "BENCHMARK:    " << json << "\n";
+
+    zsLib::String fileName(ORTC_TEST_BENCHMARK_OUTPUT_FILE);
+    if (fileName.isEmpty()) return;
+
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::app);
+    if (!file.is_open()) return;
+    file << json << "\n";
+  }
+
+  void outputOperationBenchmark(
+                                const char *benchmark,
+                                const char *operation,
+                                size_t iterations,
+                                size_t bytesPerOperation,
+                                zsLib::Microseconds total,
+                                size_t allocations
+                                )
+  {
+    using zsLib::string;
+
+    double nanoseconds = (0 != iterations ? (static_cast<double>(total.count()) * 1000.0) / static_cast<double>(iterations) : 0.0);
+
+    zsLib::XML::ElementPtr resultEl = zsLib::XML::Element::create(benchmark);
+    resultEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("operation", operation));
+    resultEl->adoptAsLastChild(IHelper::createElementWithNumber("iterations", string(iterations)));
+    resultEl->adoptAsLastChild(IHelper::createElementWithNumber("bytes", string(bytesPerOperation)));
+    resultEl->adoptAsLastChild(IHelper::createElementWithNumber("nsPerOp", string(nanoseconds)));
+    resultEl->adoptAsLastChild(IHelper::createElementWithNumber("opsPerSecond", string(0.0 != nanoseconds ? 1000000000.0 / nanoseconds : 0.0)));
+    if (isCountingAllocations()) {
+      resultEl->adoptAsLastChild(IHelper::createElementWithNumber("allocationsPerOp", string(0 != iterations ? static_cast<double>(allocations) / static_cast<double>(iterations) : 0.0)));
+    }
+
+    outputBenchmark(resultEl);
+  }
+
   void runAllTests(void* videoSurface1, void* videoSurface2)
   {
     srand(static_cast<signed int>(time(NULL)));
@@ -208,6 +383,27 @@ namespace Testing
     TESTING_RUN_TEST_FUNC_1(doTestMediaStreamTrack, videoSurface1)
     TESTING_RUN_TEST_FUNC_0(doTestRTPChannelAudio)
     TESTING_RUN_TEST_FUNC_2(doTestRTPChannelVideo, videoSurface1, videoSurface2)
+    TESTING_RUN_TEST_FUNC_0(doTestStatsSubscription)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPStreamCounters)
+    TESTING_RUN_TEST_FUNC_0(doTestSDPParser)
+    TESTING_RUN_TEST_FUNC_0(doTestEnumLookup)
+    TESTING_RUN_TEST_FUNC_0(doTestPeerConnectionRemoteDiff)
+    TESTING_RUN_TEST_FUNC_0(doTestSharedVideoEncoder)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPRelay)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPCapture)
+    TESTING_RUN_TEST_FUNC_0(doTestMessageQueueMonitor)
+    TESTING_RUN_TEST_FUNC_0(doTestLoopbackBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPPacketBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestRTCPPacketBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestNetworkImpairment)
+    TESTING_RUN_TEST_FUNC_0(doTestNetworkImpairmentBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestSCTPBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestICEScaleBenchmark)
+    TESTING_RUN_TEST_FUNC_0(doTestMediaChannelQueue)
+    TESTING_RUN_TEST_FUNC_0(doTestICEGathererPool)
+    TESTING_RUN_TEST_FUNC_0(doTestRTPRetransmission)
+    TESTING_RUN_TEST_FUNC_0(doTestActiveSpeakerDetector)
+    TESTING_RUN_TEST_FUNC_0(doTestPacketPipelineLatency)
 
     TESTING_UNINSTALL_LOGGER()
   }
@@ -152,6 +152,30 @@ namespace Testing
   void setup();
   void output();
   void runAllTests(void* videoSurface1, void* videoSurface2);
+
+  // total operator new calls so far (always 0 unless the test build has
+  // ORTC_TEST_COUNT_ALLOCATIONS enabled)
+  size_t getTotalAllocations();
+  // bytes currently allocated through operator new (same condition)
+  size_t getAllocatedBytes();
+  bool isCountingAllocations();
+
+  // user plus kernel CPU time consumed so far by the whole process (all
+  // threads) and by the calling thread (zero if unavailable)
+  zsLib::Microseconds getProcessCPUTime();
+  zsLib::Microseconds getThreadCPUTime();
+
+  // writes one JSON object per line to stdout and, if configured, to
+  // ORTC_TEST_BENCHMARK_OUTPUT_FILE
+  void outputBenchmark(zsLib::XML::ElementPtr resultEl);
+  void outputOperationBenchmark(
+                                const char *benchmark,
+                                const char *operation,
+                                size_t iterations,
+                                size_t bytesPerOperation,
+                                zsLib::Microseconds total,
+                                size_t allocations
+                                );
 }
 
 #define TESTING_INSTALL_LOGGER()                                             \
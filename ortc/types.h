@@ -136,6 +136,7 @@ namespace ortc
     virtual PUID getID() const = 0;
   };
 
+  ZS_DECLARE_INTERACTION_PTR(IActiveSpeakerDetector);
   ZS_DECLARE_INTERACTION_PTR(ICertificate);
   ZS_DECLARE_INTERACTION_PTR(IDataChannel);
   ZS_DECLARE_INTERACTION_PTR(IDataTransport);
@@ -150,7 +151,9 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PTR(IMediaDevices);
   ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackRenderCallback);
   ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrack);
+  ZS_DECLARE_INTERACTION_PTR(IRTPCapture);
   ZS_DECLARE_INTERACTION_PTR(IRTPListener);
+  ZS_DECLARE_INTERACTION_PTR(IRTPRelay);
   ZS_DECLARE_INTERACTION_PTR(IRTPSender);
   ZS_DECLARE_INTERACTION_PTR(IRTPReceiver);
   ZS_DECLARE_INTERACTION_PTR(IRTPTransport);
@@ -160,7 +163,9 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PTR(ISRTPSDESTransport);
   ZS_DECLARE_INTERACTION_PTR(IStatsProvider);
   ZS_DECLARE_INTERACTION_PTR(IStatsReport);
+  ZS_DECLARE_INTERACTION_PTR(IStatsSubscription);
 
+  ZS_DECLARE_INTERACTION_PROXY(IActiveSpeakerDetectorDelegate);
   ZS_DECLARE_INTERACTION_PROXY(IDataChannelDelegate);
   ZS_DECLARE_INTERACTION_PROXY(IDTLSTransportDelegate);
   ZS_DECLARE_INTERACTION_PROXY(IDTMFSenderDelegate);
@@ -174,7 +179,9 @@ namespace ortc
   ZS_DECLARE_INTERACTION_PROXY(ISCTPTransportDelegate);
   ZS_DECLARE_INTERACTION_PROXY(ISCTPTransportListenerDelegate);
   ZS_DECLARE_INTERACTION_PROXY(ISRTPSDESTransportDelegate);
+  ZS_DECLARE_INTERACTION_PROXY(IStatsSubscriptionDelegate);
 
+  ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IActiveSpeakerDetectorSubscription, IActiveSpeakerDetectorDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IDataChannelSubscription, IDataChannelDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IDTLSTransportSubscription, IDTLSTransportDelegate);
   ZS_DECLARE_INTERACTION_PROXY_SUBSCRIPTION(IDTMFSenderSubscription, IDTMFSenderDelegate);
@@ -206,7 +213,9 @@ namespace ortc
   ZS_DECLARE_TYPEDEF_PTR(IICEGatherer, IIceGatherer);
   ZS_DECLARE_TYPEDEF_PTR(IICETransport, IIceTransport);
   ZS_DECLARE_TYPEDEF_PTR(IICETransportController, IIceTransportController);
+  ZS_DECLARE_TYPEDEF_PTR(IRTPCapture, IRtpCapture);
   ZS_DECLARE_TYPEDEF_PTR(IRTPListener, IRtpListener);
+  ZS_DECLARE_TYPEDEF_PTR(IRTPRelay, IRtpRelay);
   ZS_DECLARE_TYPEDEF_PTR(IRTPSender, IRtpSender);
   ZS_DECLARE_TYPEDEF_PTR(IRTPReceiver, IRtpReceiver);
   ZS_DECLARE_TYPEDEF_PTR(IRTPTransport, IRtpTransport);